@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKBENCH_BENCHMARKREPORT_HPP
+#define D3D12TESTS_FRAMEWORKBENCH_BENCHMARKREPORT_HPP
+
+#include "FrameworkBench/BenchmarkSuite.hpp"
+
+#include <filesystem>
+
+namespace FrameworkBench {
+    // Machine the results were measured on, to tell baselines apart.
+    struct BenchmarkEnvironment {
+        std::string Platform;
+        std::string SimdLevel;
+        D3D12Tests::UInt32 HardwareThreadCount = 0;
+    };
+
+    struct BenchmarkReport {
+        BenchmarkEnvironment Environment;
+        std::vector<BenchmarkResult> Results;
+    };
+
+    BenchmarkEnvironment GetBenchmarkEnvironment();
+
+    // JSON document with one object per result, times in nanoseconds.
+    std::string ExportBenchmarkReport(const BenchmarkReport& report);
+    void SaveBenchmarkReport(const BenchmarkReport& report, const std::filesystem::path& path);
+    // Reads a report written by SaveBenchmarkReport, unknown members are skipped. Throws
+    // std::runtime_error if the file cannot be read or is not such a report.
+    BenchmarkReport LoadBenchmarkReport(const std::filesystem::path& path);
+
+    struct BenchmarkComparison {
+        std::string Name;
+        // Median times per iteration, zero for the benchmarks missing from the baseline.
+        D3D12Tests::Float64 BaselineNanoseconds = 0.0;
+        D3D12Tests::Float64 Nanoseconds = 0.0;
+        bool IsRegression = false;
+    };
+
+    // A benchmark regressed when its median time exceeds the baseline one by more than the
+    // tolerance, e.g. 0.1 for 10%.
+    std::vector<BenchmarkComparison> CompareBenchmarks(std::span<const BenchmarkResult> results,
+                                                       std::span<const BenchmarkResult> baseline, D3D12Tests::Float64 tolerance);
+    std::string FormatBenchmarkComparison(std::span<const BenchmarkComparison> comparisons);
+}
+
+#endif // D3D12TESTS_FRAMEWORKBENCH_BENCHMARKREPORT_HPP
@@ -0,0 +1,110 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKBENCH_BENCHMARKSUITE_HPP
+#define D3D12TESTS_FRAMEWORKBENCH_BENCHMARKSUITE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FrameworkBench {
+    struct BenchmarkOptions {
+        // Untimed repetitions run first, to warm the caches and the page tables.
+        D3D12Tests::UInt32 WarmupRepetitions = 2;
+        D3D12Tests::UInt32 Repetitions = 20;
+        // A repetition runs the body enough times to last at least this long, so that the
+        // clock resolution and the call overhead do not show in the results.
+        std::chrono::nanoseconds MinRepetitionTime = std::chrono::milliseconds(5);
+        // Prefixes of the names of the benchmarks to run, all of them when empty.
+        std::vector<std::string> Filters;
+        // Size of the files of the load benchmarks, in bytes.
+        D3D12Tests::UInt64 LargeFileSize = 256ull * 1024 * 1024;
+    };
+
+    // A value the benchmark measures besides its time, e.g. state changes per iteration.
+    struct BenchmarkCounter {
+        std::string Name;
+        D3D12Tests::Float64 Value = 0.0;
+    };
+
+    // Time per iteration over the repetitions. Percentiles use the nearest rank.
+    struct BenchmarkResult {
+        std::string Name;
+        D3D12Tests::UInt64 IterationCount = 0;
+        D3D12Tests::UInt32 RepetitionCount = 0;
+        D3D12Tests::Float64 MinNanoseconds = 0.0;
+        D3D12Tests::Float64 MedianNanoseconds = 0.0;
+        D3D12Tests::Float64 MeanNanoseconds = 0.0;
+        D3D12Tests::Float64 P90Nanoseconds = 0.0;
+        D3D12Tests::Float64 P99Nanoseconds = 0.0;
+        D3D12Tests::Float64 MaxNanoseconds = 0.0;
+        // At the median time, zero for the benchmarks that do not process bytes.
+        D3D12Tests::Float64 BytesPerSecond = 0.0;
+        std::vector<BenchmarkCounter> Counters;
+    };
+
+    // Runs the iterations given to it, e.g. a loop calling the measured function.
+    using BenchmarkBody = std::function<void(D3D12Tests::UInt64 iterationCount)>;
+
+    class BenchmarkSuite {
+    public:
+        explicit BenchmarkSuite(BenchmarkOptions options);
+        ~BenchmarkSuite() = default;
+
+        BenchmarkSuite(const BenchmarkSuite&) = delete;
+        BenchmarkSuite(BenchmarkSuite&&) = delete;
+
+        BenchmarkSuite& operator=(const BenchmarkSuite&) = delete;
+        BenchmarkSuite& operator=(BenchmarkSuite&&) = delete;
+
+        // Whether the filters select the benchmark, or some of the benchmarks whose names
+        // start with the given group name. Expensive setups should be skipped otherwise.
+        bool IsEnabled(std::string_view name) const;
+
+        // Measures the body if the filters select it. The iteration count of a repetition is
+        // calibrated first, then the warmup and the timed repetitions run. The counters are
+        // reported with the result as given.
+        void Run(std::string name, const BenchmarkBody& body, D3D12Tests::UInt64 bytesPerIteration = 0,
+                 std::vector<BenchmarkCounter> counters = {});
+        // Adds the result of samples measured by the caller, one per repetition.
+        void Record(std::string name, std::span<const D3D12Tests::Float64> nanoseconds, D3D12Tests::UInt64 bytesPerIteration = 0);
+
+        inline const BenchmarkOptions& GetOptions() const;
+        inline std::span<const BenchmarkResult> GetResults() const;
+
+    private:
+        D3D12Tests::UInt64 CalibrateIterationCount(const BenchmarkBody& body) const;
+        void AddResult(std::string name, D3D12Tests::UInt64 iterationCount, std::vector<D3D12Tests::Float64> nanoseconds,
+                       D3D12Tests::UInt64 bytesPerIteration, std::vector<BenchmarkCounter> counters);
+
+        BenchmarkOptions m_Options;
+        std::vector<BenchmarkResult> m_Results;
+    };
+
+    // Keeps the compiler from optimizing away a value computed by a benchmark.
+    template <class T>
+    inline void DoNotOptimize(const T& value);
+    // Opaque to the optimizer, for compilers without inline assembly.
+    void UseCharPointer(const volatile char* pValue);
+
+    // Directory for the files written by the benchmarks, in the temporary directory.
+    std::filesystem::path GetScratchDirectory();
+
+    // One line per result, in a fixed-width table, with the counters after the columns.
+    std::string FormatBenchmarkResult(const BenchmarkResult& result);
+    std::string FormatBenchmarkHeader();
+}
+
+#include "FrameworkBench/BenchmarkSuite.inl"
+
+#endif // D3D12TESTS_FRAMEWORKBENCH_BENCHMARKSUITE_HPP
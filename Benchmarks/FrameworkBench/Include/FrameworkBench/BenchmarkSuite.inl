@@ -0,0 +1,30 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace FrameworkBench {
+    inline const BenchmarkOptions& BenchmarkSuite::GetOptions() const {
+        return m_Options;
+    }
+
+    inline std::span<const BenchmarkResult> BenchmarkSuite::GetResults() const {
+        return m_Results;
+    }
+
+    template <class T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        // MSVC has no inline assembly on x64, an opaque call does the same.
+        UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+        _ReadWriteBarrier();
+#endif
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKBENCH_BENCHMARKS_HPP
+#define D3D12TESTS_FRAMEWORKBENCH_BENCHMARKS_HPP
+
+#include "FrameworkBench/BenchmarkSuite.hpp"
+
+namespace FrameworkBench {
+    // Benchmark groups, named after their prefix.
+
+    // Alignment, LinearAllocator, RingAllocator, UploadRing, ConstantBufferAllocator, RangeAllocator,
+    // BindlessRegistry, FrameRing, CommandContextPool.
+    void RunAllocatorBenchmarks(BenchmarkSuite& suite);
+    // ResourceStateTracker, ShaderCache, PipelineRegistry, CommandRecorder.
+    void RunStateBenchmarks(BenchmarkSuite& suite);
+    // ProceduralTexture, SubresourceCopy, StreamCopy.
+    void RunTextureBenchmarks(BenchmarkSuite& suite);
+    // DdsFile against reading whole files like ReadDataFromFile.
+    void RunFileBenchmarks(BenchmarkSuite& suite);
+    // Vertex data preparation and upload, mesh files, OBJ import, MeshOptimizer, MeshletBuilder,
+    // VertexCompression.
+    void RunGeometryBenchmarks(BenchmarkSuite& suite);
+    // JobSystem, ParallelFor.
+    void RunJobBenchmarks(BenchmarkSuite& suite);
+    // Profiler, FrameLoop, NullDevice, RenderGraph.
+    void RunFrameBenchmarks(BenchmarkSuite& suite);
+    // Culling, DrawQueue.
+    void RunSceneBenchmarks(BenchmarkSuite& suite);
+}
+
+#endif // D3D12TESTS_FRAMEWORKBENCH_BENCHMARKS_HPP
@@ -0,0 +1,244 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/Alignment.hpp"
+#include "Framework/BindlessRegistry.hpp"
+#include "Framework/CommandContextPool.hpp"
+#include "Framework/ConstantBufferAllocator.hpp"
+#include "Framework/FrameRing.hpp"
+#include "Framework/JobSystem.hpp"
+#include "Framework/LinearAllocator.hpp"
+#include "Framework/RangeAllocator.hpp"
+#include "Framework/RingAllocator.hpp"
+#include "Framework/SimulatedGpuTimeline.hpp"
+#include "Framework/UploadRing.hpp"
+
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <random>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    void RunAllocatorBenchmarks(BenchmarkSuite& suite) {
+        suite.Run("Alignment/ConstantBufferByteSize", [](const UInt64 iterationCount) {
+            UInt64 total = 0;
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                total += CalculateConstantBufferByteSize(static_cast<UInt32>(i * 37 & 0xffff));
+            }
+            DoNotOptimize(total);
+        });
+
+        {
+            LinearAllocator allocator(1024 * 1024);
+            suite.Run("LinearAllocator/Allocate64", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    void* pMemory = allocator.Allocate(64, 16);
+                    if (pMemory == nullptr) {
+                        allocator.Reset();
+                        pMemory = allocator.Allocate(64, 16);
+                    }
+                    DoNotOptimize(pMemory);
+                }
+            });
+        }
+
+        // Frames of 64 allocations, released two frames later.
+        {
+            RingAllocator allocator(16 * 1024 * 1024);
+            UInt64 allocationIndex = 0;
+            suite.Run("RingAllocator/AllocateRelease256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i, ++allocationIndex) {
+                    const UInt64 frame = allocationIndex / 64 + 1;
+                    if (allocationIndex % 64 == 0 && frame > 2) {
+                        allocator.Release(frame - 2);
+                    }
+                    DoNotOptimize(allocator.Allocate(256, 256, frame));
+                }
+            });
+        }
+
+        if (suite.IsEnabled("UploadRing")) {
+            SimulatedGpuTimeline timeline;
+            std::vector<std::byte> memory(64 * 1024 * 1024);
+            UploadRing ring(timeline, memory.data(), 0, memory.size());
+
+            suite.Run("UploadRing/AllocateConstants256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(ring.AllocateConstants(256));
+                    if (i % 64 == 63) {
+                        timeline.Signal();
+                    }
+                }
+            });
+
+            const std::vector<std::byte> data(64 * 1024, std::byte{0x5a});
+            for (const UInt64 size : {UInt64(256), UInt64(4 * 1024), UInt64(64 * 1024)}) {
+                suite.Run("UploadRing/Upload" + std::to_string(size), [&, size](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        DoNotOptimize(ring.Upload(data.data(), size));
+                        if (i % 16 == 15) {
+                            timeline.Signal();
+                        }
+                    }
+                }, size);
+            }
+        }
+
+        // A frame of 16k per-draw constants of 64 bytes, e.g. a matrix, recorded by as many
+        // jobs as threads with a ConstantBufferContext each, against an UploadRing behind a
+        // mutex. Each allocation takes 256 bytes, so that 1 GB/s is 3.9M allocations per second.
+        if (suite.IsEnabled("ConstantBufferAllocator")) {
+            constexpr UInt32 AllocationCount = 16 * 1024;
+            const std::array<std::byte, 64> constants = {};
+
+            for (const UInt32 threadCount : {1u, 16u}) {
+                const std::string threads = "/Threads" + std::to_string(threadCount);
+                JobSystem jobSystem(threadCount);
+                const UInt32 jobAllocationCount = AllocationCount / threadCount;
+
+                // Three frames of constants in flight.
+                SimulatedGpuTimeline timeline;
+                std::vector<std::byte> memory(3 * AllocationCount * Alignment::ConstantBuffer);
+                ConstantBufferAllocator allocator(timeline, memory.data(), 0, memory.size());
+                suite.Run("ConstantBufferAllocator/Frame16k" + threads, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        JobCounter counter;
+                        for (UInt32 job = 0; job < threadCount; ++job) {
+                            jobSystem.Schedule([&]() {
+                                ConstantBufferContext context(allocator);
+                                for (UInt32 allocation = 0; allocation < jobAllocationCount; ++allocation) {
+                                    DoNotOptimize(context.Upload(constants.data(), constants.size()).GpuAddress);
+                                }
+                            }, &counter);
+                        }
+                        jobSystem.Wait(counter);
+                        timeline.Signal();
+                    }
+                }, UInt64(AllocationCount) * Alignment::ConstantBuffer, {{"allocations", static_cast<Float64>(AllocationCount)}});
+
+                UploadRing ring(timeline, memory.data(), 0, memory.size());
+                std::mutex ringMutex;
+                suite.Run("ConstantBufferAllocator/Frame16k/LockedUploadRing" + threads, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        JobCounter counter;
+                        for (UInt32 job = 0; job < threadCount; ++job) {
+                            jobSystem.Schedule([&]() {
+                                for (UInt32 allocation = 0; allocation < jobAllocationCount; ++allocation) {
+                                    std::lock_guard lock(ringMutex);
+                                    const UploadAllocation uploadAllocation = ring.AllocateConstants(constants.size());
+                                    std::memcpy(uploadAllocation.CpuAddress, constants.data(), constants.size());
+                                    DoNotOptimize(uploadAllocation.GpuAddress);
+                                }
+                            }, &counter);
+                        }
+                        jobSystem.Wait(counter);
+                        timeline.Signal();
+                    }
+                }, UInt64(AllocationCount) * Alignment::ConstantBuffer, {{"allocations", static_cast<Float64>(AllocationCount)}});
+            }
+        }
+
+        // Steady state of a heap with 1024 live ranges of 1 to 64 descriptors: each iteration
+        // frees a random range and allocates another one.
+        if (suite.IsEnabled("RangeAllocator")) {
+            constexpr UInt32 LiveRangeCount = 1024;
+
+            RangeAllocator allocator(1024 * 1024);
+            std::mt19937 random(42);
+            std::uniform_int_distribution<UInt32> sizes(1, 64);
+            std::vector<std::pair<UInt32, UInt32>> ranges(LiveRangeCount);
+            for (auto& [start, count] : ranges) {
+                count = sizes(random);
+                start = allocator.Allocate(count);
+            }
+
+            suite.Run("RangeAllocator/AllocateFree", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    auto& [start, count] = ranges[random() % LiveRangeCount];
+                    allocator.Free(start, count);
+                    count = sizes(random);
+                    start = allocator.Allocate(count);
+                    DoNotOptimize(start);
+                }
+            });
+        }
+
+        // 64k live textures. Lookups resolve handles in a random order, churn frees a random
+        // handle and registers another one, with a signal every 256 registrations like a frame
+        // streaming textures in and out, the GPU finishing each frame immediately.
+        if (suite.IsEnabled("BindlessRegistry")) {
+            constexpr UInt32 LiveHandleCount = 64 * 1024;
+            constexpr UInt32 FrameHandleCount = 256;
+
+            SimulatedGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 2 * LiveHandleCount);
+            std::vector<BindlessHandle> handles(LiveHandleCount);
+            for (BindlessHandle& handle : handles) {
+                handle = registry.Allocate();
+            }
+
+            std::mt19937 random(5);
+            std::vector<BindlessHandle> lookups(LiveHandleCount);
+            for (BindlessHandle& lookup : lookups) {
+                lookup = handles[random() % LiveHandleCount];
+            }
+
+            suite.Run("BindlessRegistry/Resolve64k", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    UInt32 indexSum = 0;
+                    for (const BindlessHandle lookup : lookups) {
+                        indexSum += registry.Resolve(lookup);
+                    }
+                    DoNotOptimize(indexSum);
+                }
+            }, UInt64(LiveHandleCount) * sizeof(BindlessHandle), {{"lookups", static_cast<Float64>(LiveHandleCount)}});
+
+            const auto churn = [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    BindlessHandle& handle = handles[random() % LiveHandleCount];
+                    registry.Free(handle);
+                    handle = registry.Allocate();
+                    if (i % FrameHandleCount == FrameHandleCount - 1) {
+                        timeline.Signal();
+                    }
+                }
+            };
+
+            // The part of the range in use once in the steady state, which recycling keeps
+            // close to the live count.
+            churn(16 * LiveHandleCount);
+            suite.Run("BindlessRegistry/Churn64k", churn, 0,
+                      {{"high_water_mark", static_cast<Float64>(registry.GetHighWaterMark())}});
+        }
+
+        // The GPU finishes each frame immediately, the ring never blocks.
+        {
+            SimulatedGpuTimeline timeline;
+            FrameRing<UInt64> ring(timeline, 3, 64 * 1024);
+            suite.Run("FrameRing/BeginEndFrame", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    UInt64& frame = ring.BeginFrame();
+                    frame += i;
+                    DoNotOptimize(ring.GetTransientAllocator().Allocate(1024));
+                    ring.EndFrame();
+                }
+            });
+        }
+
+        {
+            SimulatedGpuTimeline timeline;
+            CommandContextPool<UInt64> pool(timeline, []() { return UInt64(0); });
+            suite.Run("CommandContextPool/AcquireRelease", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    const UInt64 context = pool.Acquire();
+                    pool.Release(context, timeline.Signal());
+                }
+            });
+        }
+    }
+}
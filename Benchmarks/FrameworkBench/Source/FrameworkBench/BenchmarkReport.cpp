@@ -0,0 +1,392 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/BenchmarkReport.hpp"
+
+#include "Framework/Simd.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        void AppendJsonString(std::string& json, const std::string_view value) {
+            json += '"';
+            for (const char c : value) {
+                switch (c) {
+                    case '"':
+                        json += "\\\"";
+                        break;
+                    case '\\':
+                        json += "\\\\";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                            json += escaped;
+                        } else {
+                            json += c;
+                        }
+                        break;
+                }
+            }
+            json += '"';
+        }
+
+        void AppendJsonNumber(std::string& json, const std::string_view name, const Float64 value) {
+            char text[64];
+            std::snprintf(text, sizeof(text), "\"%.*s\": %.17g", static_cast<int>(name.size()), name.data(), value);
+            json += text;
+        }
+
+        // Reads the subset of JSON the reports are written in: objects, arrays, strings and
+        // numbers, plus the literals so that hand-edited baselines do not break it.
+        class JsonReader {
+        public:
+            explicit JsonReader(const std::string_view text) :
+                m_Text(text),
+                m_Position(0) {
+            }
+
+            void Expect(const char c) {
+                SkipWhitespace();
+                if (m_Position >= m_Text.size() || m_Text[m_Position] != c) {
+                    Fail(std::string("expected '") + c + "'");
+                }
+                ++m_Position;
+            }
+
+            // Consumes the character if it comes next.
+            bool Accept(const char c) {
+                SkipWhitespace();
+                if (m_Position < m_Text.size() && m_Text[m_Position] == c) {
+                    ++m_Position;
+                    return true;
+                }
+
+                return false;
+            }
+
+            std::string ReadString() {
+                Expect('"');
+
+                std::string value;
+                while (m_Position < m_Text.size() && m_Text[m_Position] != '"') {
+                    char c = m_Text[m_Position++];
+                    if (c == '\\') {
+                        if (m_Position >= m_Text.size()) {
+                            break;
+                        }
+
+                        c = m_Text[m_Position++];
+                        switch (c) {
+                            case 'n':
+                                c = '\n';
+                                break;
+                            case 't':
+                                c = '\t';
+                                break;
+                            case 'u': {
+                                // Only the control characters written by AppendJsonString.
+                                UInt32 code = 0;
+                                const char* pBegin = m_Text.data() + m_Position;
+                                const auto [pEnd, error] = std::from_chars(pBegin, pBegin + std::min<size_t>(4, m_Text.size() - m_Position), code, 16);
+                                if (error != std::errc() || pEnd != pBegin + 4 || code > 0x7f) {
+                                    Fail("unsupported escape sequence");
+                                }
+                                m_Position += 4;
+                                c = static_cast<char>(code);
+                                break;
+                            }
+                            default:
+                                break;
+                        }
+                    }
+                    value += c;
+                }
+
+                Expect('"');
+                return value;
+            }
+
+            Float64 ReadNumber() {
+                SkipWhitespace();
+
+                Float64 value = 0.0;
+                const char* pBegin = m_Text.data() + m_Position;
+                const auto [pEnd, error] = std::from_chars(pBegin, m_Text.data() + m_Text.size(), value);
+                if (error != std::errc()) {
+                    Fail("expected a number");
+                }
+
+                m_Position += static_cast<size_t>(pEnd - pBegin);
+                return value;
+            }
+
+            void SkipValue() {
+                SkipWhitespace();
+                if (m_Position >= m_Text.size()) {
+                    Fail("expected a value");
+                }
+
+                const char c = m_Text[m_Position];
+                if (c == '"') {
+                    ReadString();
+                } else if (c == '{') {
+                    ReadObject([this](const std::string&) { SkipValue(); });
+                } else if (c == '[') {
+                    ReadArray([this]() { SkipValue(); });
+                } else if (c == 't' || c == 'f' || c == 'n') {
+                    while (m_Position < m_Text.size() && m_Text[m_Position] >= 'a' && m_Text[m_Position] <= 'z') {
+                        ++m_Position;
+                    }
+                } else {
+                    ReadNumber();
+                }
+            }
+
+            // Calls the function on each member, which must read its value.
+            template <class TFunction>
+            void ReadObject(const TFunction& readMember) {
+                Expect('{');
+                if (Accept('}')) {
+                    return;
+                }
+
+                do {
+                    const std::string name = ReadString();
+                    Expect(':');
+                    readMember(name);
+                } while (Accept(','));
+                Expect('}');
+            }
+
+            template <class TFunction>
+            void ReadArray(const TFunction& readElement) {
+                Expect('[');
+                if (Accept(']')) {
+                    return;
+                }
+
+                do {
+                    readElement();
+                } while (Accept(','));
+                Expect(']');
+            }
+
+        private:
+            void SkipWhitespace() {
+                while (m_Position < m_Text.size() &&
+                    (m_Text[m_Position] == ' ' || m_Text[m_Position] == '\t' || m_Text[m_Position] == '\n' ||
+                        m_Text[m_Position] == '\r')) {
+                    ++m_Position;
+                }
+            }
+
+            [[noreturn]] void Fail(const std::string& message) const {
+                throw std::runtime_error("Invalid benchmark report at offset " + std::to_string(m_Position) + ": " +
+                                         message);
+            }
+
+            std::string_view m_Text;
+            size_t m_Position;
+        };
+    }
+
+    BenchmarkEnvironment GetBenchmarkEnvironment() {
+        BenchmarkEnvironment environment;
+#if defined(_WIN32)
+        environment.Platform = "windows";
+#elif defined(__linux__)
+        environment.Platform = "linux";
+#else
+        environment.Platform = "unknown";
+#endif
+#if defined(_M_X64) || defined(__x86_64__)
+        environment.Platform += "_x86_64";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+        environment.Platform += "_arm64";
+#endif
+        environment.SimdLevel = GetSimdLevelName(GetSimdLevel());
+        environment.HardwareThreadCount = std::thread::hardware_concurrency();
+
+        return environment;
+    }
+
+    std::string ExportBenchmarkReport(const BenchmarkReport& report) {
+        std::string json = "{\n  \"environment\": {\"platform\": ";
+        AppendJsonString(json, report.Environment.Platform);
+        json += ", \"simd\": ";
+        AppendJsonString(json, report.Environment.SimdLevel);
+        json += ", \"hardware_threads\": " + std::to_string(report.Environment.HardwareThreadCount) + "},\n";
+
+        json += "  \"benchmarks\": [";
+        for (size_t i = 0; i < report.Results.size(); ++i) {
+            const BenchmarkResult& result = report.Results[i];
+
+            json += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+            AppendJsonString(json, result.Name);
+            json += ", \"iterations\": " + std::to_string(result.IterationCount);
+            json += ", \"repetitions\": " + std::to_string(result.RepetitionCount) + ", ";
+            AppendJsonNumber(json, "min_ns", result.MinNanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "median_ns", result.MedianNanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "mean_ns", result.MeanNanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "p90_ns", result.P90Nanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "p99_ns", result.P99Nanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "max_ns", result.MaxNanoseconds);
+            json += ", ";
+            AppendJsonNumber(json, "bytes_per_second", result.BytesPerSecond);
+            if (!result.Counters.empty()) {
+                json += ", \"counters\": {";
+                for (size_t counter = 0; counter < result.Counters.size(); ++counter) {
+                    if (counter != 0) {
+                        json += ", ";
+                    }
+                    AppendJsonNumber(json, result.Counters[counter].Name, result.Counters[counter].Value);
+                }
+                json += "}";
+            }
+            json += "}";
+        }
+        json += "\n  ]\n}\n";
+
+        return json;
+    }
+
+    void SaveBenchmarkReport(const BenchmarkReport& report, const std::filesystem::path& path) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + path.string() + " for writing");
+        }
+
+        const std::string json = ExportBenchmarkReport(report);
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path.string());
+        }
+    }
+
+    BenchmarkReport LoadBenchmarkReport(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + path.string());
+        }
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+        const std::string text = stream.str();
+
+        BenchmarkReport report;
+        JsonReader reader(text);
+        reader.ReadObject([&](const std::string& name) {
+            if (name == "environment") {
+                reader.ReadObject([&](const std::string& member) {
+                    if (member == "platform") {
+                        report.Environment.Platform = reader.ReadString();
+                    } else if (member == "simd") {
+                        report.Environment.SimdLevel = reader.ReadString();
+                    } else if (member == "hardware_threads") {
+                        report.Environment.HardwareThreadCount = static_cast<UInt32>(reader.ReadNumber());
+                    } else {
+                        reader.SkipValue();
+                    }
+                });
+            } else if (name == "benchmarks") {
+                reader.ReadArray([&]() {
+                    BenchmarkResult& result = report.Results.emplace_back();
+                    reader.ReadObject([&](const std::string& member) {
+                        if (member == "name") {
+                            result.Name = reader.ReadString();
+                        } else if (member == "iterations") {
+                            result.IterationCount = static_cast<UInt64>(reader.ReadNumber());
+                        } else if (member == "repetitions") {
+                            result.RepetitionCount = static_cast<UInt32>(reader.ReadNumber());
+                        } else if (member == "min_ns") {
+                            result.MinNanoseconds = reader.ReadNumber();
+                        } else if (member == "median_ns") {
+                            result.MedianNanoseconds = reader.ReadNumber();
+                        } else if (member == "mean_ns") {
+                            result.MeanNanoseconds = reader.ReadNumber();
+                        } else if (member == "p90_ns") {
+                            result.P90Nanoseconds = reader.ReadNumber();
+                        } else if (member == "p99_ns") {
+                            result.P99Nanoseconds = reader.ReadNumber();
+                        } else if (member == "max_ns") {
+                            result.MaxNanoseconds = reader.ReadNumber();
+                        } else if (member == "bytes_per_second") {
+                            result.BytesPerSecond = reader.ReadNumber();
+                        } else if (member == "counters") {
+                            reader.ReadObject([&](const std::string& counter) {
+                                result.Counters.push_back({counter, reader.ReadNumber()});
+                            });
+                        } else {
+                            reader.SkipValue();
+                        }
+                    });
+                });
+            } else {
+                reader.SkipValue();
+            }
+        });
+
+        return report;
+    }
+
+    std::vector<BenchmarkComparison> CompareBenchmarks(const std::span<const BenchmarkResult> results,
+                                                       const std::span<const BenchmarkResult> baseline,
+                                                       const Float64 tolerance) {
+        std::unordered_map<std::string_view, const BenchmarkResult*> baselineResults;
+        for (const BenchmarkResult& result : baseline) {
+            baselineResults.emplace(result.Name, &result);
+        }
+
+        std::vector<BenchmarkComparison> comparisons;
+        comparisons.reserve(results.size());
+        for (const BenchmarkResult& result : results) {
+            BenchmarkComparison& comparison = comparisons.emplace_back();
+            comparison.Name = result.Name;
+            comparison.Nanoseconds = result.MedianNanoseconds;
+
+            const auto it = baselineResults.find(result.Name);
+            if (it != baselineResults.end()) {
+                comparison.BaselineNanoseconds = it->second->MedianNanoseconds;
+                comparison.IsRegression = result.MedianNanoseconds > comparison.BaselineNanoseconds * (1.0 + tolerance);
+            }
+        }
+
+        return comparisons;
+    }
+
+    std::string FormatBenchmarkComparison(const std::span<const BenchmarkComparison> comparisons) {
+        std::string text;
+        for (const BenchmarkComparison& comparison : comparisons) {
+            char line[256];
+            if (comparison.BaselineNanoseconds > 0.0) {
+                const Float64 change = (comparison.Nanoseconds / comparison.BaselineNanoseconds - 1.0) * 100.0;
+                std::snprintf(line, sizeof(line), "%-56s %14.2f ns %14.2f ns %+8.1f%%%s\n", comparison.Name.c_str(),
+                              comparison.BaselineNanoseconds, comparison.Nanoseconds, change,
+                              comparison.IsRegression ? "  REGRESSION" : "");
+            } else {
+                std::snprintf(line, sizeof(line), "%-56s %17s %14.2f ns\n", comparison.Name.c_str(), "(new)",
+                              comparison.Nanoseconds);
+            }
+            text += line;
+        }
+
+        return text;
+    }
+}
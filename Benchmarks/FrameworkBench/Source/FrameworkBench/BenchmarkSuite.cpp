@@ -0,0 +1,180 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/BenchmarkSuite.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        Float64 MeasureNanoseconds(const BenchmarkBody& body, const UInt64 iterationCount) {
+            const Clock::time_point start = Clock::now();
+            body(iterationCount);
+            return std::chrono::duration<Float64, std::nano>(Clock::now() - start).count();
+        }
+
+        Float64 GetPercentile(const std::vector<Float64>& sortedValues, const UInt64 percent) {
+            const size_t rank = (sortedValues.size() * percent + 99) / 100;
+            return sortedValues[std::max<size_t>(rank, 1) - 1];
+        }
+
+        // Readable size of a time in nanoseconds.
+        std::string FormatTime(const Float64 nanoseconds) {
+            char text[32];
+            if (nanoseconds < 1e3) {
+                std::snprintf(text, sizeof(text), "%.2f ns", nanoseconds);
+            } else if (nanoseconds < 1e6) {
+                std::snprintf(text, sizeof(text), "%.2f us", nanoseconds / 1e3);
+            } else if (nanoseconds < 1e9) {
+                std::snprintf(text, sizeof(text), "%.2f ms", nanoseconds / 1e6);
+            } else {
+                std::snprintf(text, sizeof(text), "%.2f s", nanoseconds / 1e9);
+            }
+
+            return text;
+        }
+    }
+
+    BenchmarkSuite::BenchmarkSuite(BenchmarkOptions options) :
+        m_Options(std::move(options)) {
+        m_Options.Repetitions = std::max(m_Options.Repetitions, 1u);
+    }
+
+    bool BenchmarkSuite::IsEnabled(const std::string_view name) const {
+        if (m_Options.Filters.empty()) {
+            return true;
+        }
+
+        return std::any_of(m_Options.Filters.begin(), m_Options.Filters.end(), [name](const std::string& filter) {
+            return name.starts_with(filter) || std::string_view(filter).starts_with(name);
+        });
+    }
+
+    void BenchmarkSuite::Run(std::string name, const BenchmarkBody& body, const UInt64 bytesPerIteration,
+                             std::vector<BenchmarkCounter> counters) {
+        // Only the filters selecting the benchmark itself count here, not the ones of the
+        // benchmarks further down its group.
+        const bool selected = m_Options.Filters.empty() ||
+            std::any_of(m_Options.Filters.begin(), m_Options.Filters.end(), [&name](const std::string& filter) {
+                return name.starts_with(filter);
+            });
+        if (!selected) {
+            return;
+        }
+
+        const UInt64 iterationCount = CalibrateIterationCount(body);
+        for (UInt32 i = 0; i < m_Options.WarmupRepetitions; ++i) {
+            body(iterationCount);
+        }
+
+        std::vector<Float64> nanoseconds(m_Options.Repetitions);
+        for (Float64& repetitionNanoseconds : nanoseconds) {
+            repetitionNanoseconds = MeasureNanoseconds(body, iterationCount) / static_cast<Float64>(iterationCount);
+        }
+
+        AddResult(std::move(name), iterationCount, std::move(nanoseconds), bytesPerIteration, std::move(counters));
+    }
+
+    void BenchmarkSuite::Record(std::string name, const std::span<const Float64> nanoseconds,
+                                const UInt64 bytesPerIteration) {
+        if (!nanoseconds.empty()) {
+            AddResult(std::move(name), 1, std::vector<Float64>(nanoseconds.begin(), nanoseconds.end()),
+                      bytesPerIteration, {});
+        }
+    }
+
+    UInt64 BenchmarkSuite::CalibrateIterationCount(const BenchmarkBody& body) const {
+        const Float64 minNanoseconds = std::chrono::duration<Float64, std::nano>(m_Options.MinRepetitionTime).count();
+
+        UInt64 iterationCount = 1;
+        while (true) {
+            const Float64 elapsed = MeasureNanoseconds(body, iterationCount);
+            if (elapsed >= minNanoseconds) {
+                return iterationCount;
+            }
+
+            // Aim a bit past the minimum, growing at most tenfold as the first runs are the
+            // least reliable ones.
+            const Float64 scale = elapsed > 0.0 ? minNanoseconds * 1.2 / elapsed : 10.0;
+            iterationCount = std::max(iterationCount + 1,
+                                      static_cast<UInt64>(static_cast<Float64>(iterationCount) * std::min(scale, 10.0)));
+        }
+    }
+
+    void BenchmarkSuite::AddResult(std::string name, const UInt64 iterationCount, std::vector<Float64> nanoseconds,
+                                   const UInt64 bytesPerIteration, std::vector<BenchmarkCounter> counters) {
+        std::sort(nanoseconds.begin(), nanoseconds.end());
+
+        BenchmarkResult result;
+        result.Name = std::move(name);
+        result.IterationCount = iterationCount;
+        result.RepetitionCount = static_cast<UInt32>(nanoseconds.size());
+        result.MinNanoseconds = nanoseconds.front();
+        result.MedianNanoseconds = GetPercentile(nanoseconds, 50);
+        result.P90Nanoseconds = GetPercentile(nanoseconds, 90);
+        result.P99Nanoseconds = GetPercentile(nanoseconds, 99);
+        result.MaxNanoseconds = nanoseconds.back();
+        result.Counters = std::move(counters);
+
+        for (const Float64 value : nanoseconds) {
+            result.MeanNanoseconds += value;
+        }
+        result.MeanNanoseconds /= static_cast<Float64>(nanoseconds.size());
+
+        if (bytesPerIteration != 0 && result.MedianNanoseconds > 0.0) {
+            result.BytesPerSecond = static_cast<Float64>(bytesPerIteration) * 1e9 / result.MedianNanoseconds;
+        }
+
+        // Results are printed as they come, a full run takes a while.
+        std::cout << FormatBenchmarkResult(result) << std::endl;
+        m_Results.push_back(std::move(result));
+    }
+
+    void UseCharPointer(const volatile char* /*pValue*/) {
+    }
+
+    std::filesystem::path GetScratchDirectory() {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "FrameworkBench";
+        std::filesystem::create_directories(directory);
+
+        return directory;
+    }
+
+    std::string FormatBenchmarkResult(const BenchmarkResult& result) {
+        std::string throughput;
+        if (result.BytesPerSecond > 0.0) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.2f GB/s", result.BytesPerSecond / 1e9);
+            throughput = text;
+        }
+
+        char text[256];
+        std::snprintf(text, sizeof(text), "%-56s %12s %12s %12s %12s %12s", result.Name.c_str(),
+                      FormatTime(result.MedianNanoseconds).c_str(), FormatTime(result.P90Nanoseconds).c_str(),
+                      FormatTime(result.P99Nanoseconds).c_str(), FormatTime(result.MinNanoseconds).c_str(),
+                      throughput.c_str());
+
+        std::string line = text;
+        for (const BenchmarkCounter& counter : result.Counters) {
+            std::snprintf(text, sizeof(text), "  %s %.6g", counter.Name.c_str(), counter.Value);
+            line += text;
+        }
+
+        return line;
+    }
+
+    std::string FormatBenchmarkHeader() {
+        char text[256];
+        std::snprintf(text, sizeof(text), "%-56s %12s %12s %12s %12s %12s", "Benchmark", "Median", "P90", "P99", "Min",
+                      "Throughput");
+
+        return text;
+    }
+}
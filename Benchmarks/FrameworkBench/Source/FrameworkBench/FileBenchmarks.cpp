@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/DdsFile.hpp"
+#include "Framework/SubresourceCopy.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr UInt32 SliceSize = 4096;
+        constexpr UInt64 SliceByteCount = UInt64(SliceSize) * SliceSize * 4;
+        // Magic number, legacy header and DX10 extension.
+        constexpr UInt64 DdsHeaderSize = 4 + 124 + 20;
+
+        // RGBA8 texture array of 4096x4096 slices, without mips, so that the size can grow
+        // past the limits of a single texture.
+        void WriteDdsFile(const std::filesystem::path& path, const UInt32 arraySize) {
+            std::array<UInt32, DdsHeaderSize / 4> header = {};
+            header[0] = 0x20534444;                  // "DDS "
+            header[1] = 124;                         // Header size
+            header[2] = 0x1 | 0x2 | 0x4 | 0x1000;    // Caps, height, width, pixel format
+            header[3] = SliceSize;
+            header[4] = SliceSize;
+            header[5] = SliceSize * 4;               // Pitch
+            header[7] = 1;                           // Mip count
+            header[19] = 32;                         // Pixel format size
+            header[20] = 0x4;                        // FourCC
+            header[21] = 0x30315844;                 // "DX10"
+            header[27] = 0x1000;                     // Texture
+            header[32] = DxgiFormat::R8G8B8A8Unorm;
+            header[33] = 3;                          // Texture2D
+            header[35] = arraySize;
+
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+
+            std::vector<char> slice(SliceByteCount);
+            for (UInt64 i = 0; i < slice.size(); ++i) {
+                slice[i] = static_cast<char>(i * 31 >> 4);
+            }
+            for (UInt32 i = 0; i < arraySize; ++i) {
+                file.write(slice.data(), static_cast<std::streamsize>(slice.size()));
+            }
+
+            if (!file) {
+                throw std::runtime_error("Failed to write " + path.string());
+            }
+        }
+
+        // What ReadDataFromFile does with the Win32 API: the whole file in a malloc'd block.
+        std::byte* ReadWholeFile(const std::filesystem::path& path, UInt64& size) {
+            std::FILE* pFile = std::fopen(path.string().c_str(), "rb");
+            if (pFile == nullptr) {
+                throw std::runtime_error("Failed to open " + path.string());
+            }
+
+            size = std::filesystem::file_size(path);
+            auto* pData = static_cast<std::byte*>(std::malloc(size));
+            const bool success = pData != nullptr && std::fread(pData, 1, size, pFile) == size;
+            std::fclose(pFile);
+            if (!success) {
+                std::free(pData);
+                throw std::runtime_error("Failed to read " + path.string());
+            }
+
+            return pData;
+        }
+    }
+
+    void RunFileBenchmarks(BenchmarkSuite& suite) {
+        if (!suite.IsEnabled("DdsFile") && !suite.IsEnabled("ReadDataFromFile")) {
+            return;
+        }
+
+        const UInt32 arraySize = static_cast<UInt32>(std::max<UInt64>(suite.GetOptions().LargeFileSize / SliceByteCount, 1));
+        const UInt64 fileSize = DdsHeaderSize + arraySize * SliceByteCount;
+        const std::string sizeName = std::to_string(fileSize >> 20) + "MiB";
+
+        // Reused between runs, writing gigabytes takes a while.
+        const std::filesystem::path path = GetScratchDirectory() / ("Texture" + sizeName + ".dds");
+        if (!std::filesystem::exists(path) || std::filesystem::file_size(path) != fileSize) {
+            WriteDdsFile(path, arraySize);
+        }
+
+        // Every slice goes through the same staging memory, like chunks of an upload ring.
+        TextureCopyDesc copyDesc;
+        copyDesc.Format = DxgiFormat::R8G8B8A8Unorm;
+        copyDesc.Width = SliceSize;
+        copyDesc.Height = SliceSize;
+        SubresourceFootprint footprint;
+        std::vector<std::byte> staging(ComputeCopyableFootprints(copyDesc, 0, 0, {&footprint, 1}));
+
+        // After the warmup, the file is in the page cache: this measures the CPU side of
+        // loading, not the disk.
+        suite.Run("ReadDataFromFile/Read/" + sizeName, [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                UInt64 size = 0;
+                std::byte* pData = ReadWholeFile(path, size);
+                DoNotOptimize(pData);
+                std::free(pData);
+            }
+        }, fileSize);
+
+        suite.Run("ReadDataFromFile/ReadAndCopy/" + sizeName, [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                UInt64 size = 0;
+                std::byte* pData = ReadWholeFile(path, size);
+                for (UInt32 slice = 0; slice < arraySize; ++slice) {
+                    std::memcpy(staging.data(), pData + DdsHeaderSize + slice * SliceByteCount, SliceByteCount);
+                    DoNotOptimize(staging.data());
+                }
+                std::free(pData);
+            }
+        }, fileSize);
+
+        // Only maps the file and reads the headers.
+        suite.Run("DdsFile/Open/" + sizeName, [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                const DdsFile file(path);
+                DoNotOptimize(file.GetSubresources().data());
+            }
+        });
+
+        suite.Run("DdsFile/OpenAndCopy/" + sizeName, [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                const DdsFile file(path);
+                for (const DdsSubresource& subresource : file.GetSubresources()) {
+                    CopySubresource(staging.data(), footprint,
+                                    {subresource.Data, subresource.RowPitch, subresource.SlicePitch});
+                    DoNotOptimize(staging.data());
+                }
+            }
+        }, fileSize);
+    }
+}
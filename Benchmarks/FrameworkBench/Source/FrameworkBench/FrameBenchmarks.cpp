@@ -0,0 +1,255 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/FrameLoop.hpp"
+#include "Framework/FrameRing.hpp"
+#include "Framework/NullDevice.hpp"
+#include "Framework/Profiler.hpp"
+#include "Framework/RenderGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        class EmptyApplication final : public ApplicationBase {
+        public:
+            EmptyApplication() = default;
+            ~EmptyApplication() override = default;
+
+            EmptyApplication(const EmptyApplication&) = delete;
+            EmptyApplication(EmptyApplication&&) = delete;
+
+            EmptyApplication& operator=(const EmptyApplication&) = delete;
+            EmptyApplication& operator=(EmptyApplication&&) = delete;
+
+            void OnInit() override {
+            }
+
+            void OnUpdate() override {
+            }
+
+            void OnRender() override {
+            }
+
+            void OnDestroy() override {
+            }
+        };
+
+        struct NullFrameResources {
+            std::unique_ptr<NullCommandAllocator> CommandAllocator;
+        };
+
+        // A frame of passes each reading one or two of the resources not read yet and maybe
+        // one of the last 16 written, and writing one or two new ones: 4 to 64 MiB render
+        // targets, or 1 to 8 MiB buffers, sometimes updated in place by the next passes. Some
+        // passes also read the depth buffer written first. One pass in 16 writes a debug output
+        // nothing reads, which gets culled, as do the passes only feeding it. The last pass
+        // reads what is left and writes the back buffer.
+        RenderGraph MakeBenchmarkRenderGraph(const UInt32 passCount) {
+            constexpr UInt64 MiB = 1024 * 1024;
+            constexpr UInt32 RenderTargetHeap = 0;
+            constexpr UInt32 BufferHeap = 1;
+
+            std::mt19937 random(3);
+            RenderGraph graph;
+            std::vector<UInt32> written;
+            std::vector<UInt32> unread;
+            std::vector<UInt32> buffers;
+
+            const UInt32 backBuffer = graph.Import(ResourceState::Present, ResourceState::Present);
+            const UInt32 depth = graph.CreateTransient({32 * MiB, Alignment::ResourcePlacement, RenderTargetHeap});
+            graph.AddPass();
+            graph.Write(depth, ResourceState::DepthWrite);
+
+            const auto readShaderResource = [&](const UInt32 resource) {
+                graph.Read(resource, random() % 2 ? ResourceState::PixelShaderResource
+                                                  : ResourceState::NonPixelShaderResource);
+            };
+
+            for (UInt32 pass = 1; pass + 1 < passCount; ++pass) {
+                graph.AddPass();
+
+                const UInt32 unreadCount = std::min<UInt32>(1 + random() % 2, static_cast<UInt32>(unread.size()));
+                for (UInt32 i = 0; i < unreadCount; ++i) {
+                    const std::size_t index = random() % unread.size();
+                    readShaderResource(unread[index]);
+                    unread[index] = unread.back();
+                    unread.pop_back();
+                }
+
+                if (!written.empty() && random() % 2 == 0) {
+                    readShaderResource(written[written.size() - 1 - random() % std::min<std::size_t>(written.size(), 16)]);
+                }
+
+                if (random() % 8 == 0) {
+                    graph.Read(depth, ResourceState::DepthRead);
+                }
+
+                if (!buffers.empty() && random() % 8 == 0) {
+                    const UInt32 buffer = buffers[buffers.size() - 1 - random() % std::min<std::size_t>(buffers.size(), 4)];
+                    graph.Read(buffer, ResourceState::UnorderedAccess);
+                    graph.Write(buffer, ResourceState::UnorderedAccess);
+                }
+
+                const bool debugOutput = random() % 16 == 0;
+                const UInt32 writeCount = random() % 4 == 0 ? 2 : 1;
+                for (UInt32 i = 0; i < writeCount; ++i) {
+                    UInt32 resource;
+                    if (random() % 3 != 0) {
+                        resource = graph.CreateTransient({(1 + random() % 16) * 4 * MiB, Alignment::ResourcePlacement,
+                                                          RenderTargetHeap});
+                        graph.Write(resource, ResourceState::RenderTarget);
+                    } else {
+                        resource = graph.CreateTransient({(1 + random() % 8) * MiB, Alignment::ResourcePlacement,
+                                                          BufferHeap});
+                        graph.Write(resource, ResourceState::UnorderedAccess);
+                        if (!debugOutput) {
+                            buffers.push_back(resource);
+                        }
+                    }
+
+                    if (!debugOutput) {
+                        written.push_back(resource);
+                        unread.push_back(resource);
+                    }
+                }
+            }
+
+            graph.AddPass();
+            for (const UInt32 resource : unread) {
+                graph.Read(resource, ResourceState::PixelShaderResource);
+            }
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+
+            return graph;
+        }
+    }
+
+    void RunFrameBenchmarks(BenchmarkSuite& suite) {
+        // The scopes are recorded whether the markers are compiled in or not, the per-thread
+        // ring drops the events once full, which costs the same.
+        suite.Run("Profiler/ReadProfileTimestamp", [](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                DoNotOptimize(ReadProfileTimestamp());
+            }
+        });
+
+        suite.Run("Profiler/RecordProfileEvent", [](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                RecordProfileEvent("FrameworkBench", i, i + 1);
+            }
+        });
+
+        suite.Run("Profiler/ProfileScope", [](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                const ProfileScope scope("FrameworkBench");
+            }
+        });
+
+        if (suite.IsEnabled("FrameLoop")) {
+            EmptyApplication application;
+            FrameLoop loop(application);
+            suite.Run("FrameLoop/Uncapped", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    loop.RunFrame();
+                }
+            });
+
+            // Deviation of the frame times from the period at 144 Hz, one sample per frame:
+            // the limiter sleeps, then spins until the deadline.
+            if (suite.IsEnabled("FrameLoop/FixedRate144")) {
+                FramePacingDesc pacing;
+                pacing.Mode = FramePacingMode::FixedRate;
+                pacing.TargetFrameRate = 144.0;
+                application.SetFramePacing(pacing);
+
+                const Float64 periodNanoseconds = 1e9 / pacing.TargetFrameRate;
+                const UInt32 frameCount = std::max<UInt32>(suite.GetOptions().Repetitions, 288);
+
+                // The first frames restart the schedule and teach the limiter the sleep cost.
+                for (UInt32 i = 0; i < 16; ++i) {
+                    loop.RunFrame();
+                }
+
+                std::vector<Float64> deviations(frameCount);
+                for (Float64& deviation : deviations) {
+                    loop.RunFrame();
+                    deviation = std::abs(application.GetFrameTiming().DeltaSeconds * 1e9 - periodNanoseconds);
+                }
+                suite.Record("FrameLoop/FixedRate144/Deviation", deviations);
+            }
+        }
+
+        // HelloHeadless' frame: begin the frame, record a clear, submit and present.
+        if (suite.IsEnabled("NullDevice")) {
+            constexpr UInt32 FrameCount = 2;
+
+            NullDevice device;
+            const std::unique_ptr<NullCommandQueue> queue = device.CreateCommandQueue();
+            const std::unique_ptr<NullSwapChain> swapChain = device.CreateSwapChain(FrameCount);
+            FrameRing<NullFrameResources> frameRing(queue->GetTimeline(), FrameCount);
+            for (UInt32 n = 0; n < FrameCount; ++n) {
+                frameRing.GetFrame(n).CommandAllocator = device.CreateCommandAllocator();
+            }
+            const std::unique_ptr<NullCommandList> commandList =
+                device.CreateCommandList(*frameRing.GetCurrentFrame().CommandAllocator);
+            commandList->Close();
+
+            suite.Run("NullDevice/ClearFrame", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    const NullFrameResources& frame = frameRing.BeginFrame();
+                    frame.CommandAllocator->Reset();
+                    commandList->Reset(*frame.CommandAllocator);
+                    commandList->ResourceBarrier(1);
+                    commandList->ClearRenderTargetView();
+                    commandList->ResourceBarrier(1);
+                    commandList->Close();
+
+                    NullCommandList* ppCommandLists[] = {commandList.get()};
+                    queue->ExecuteCommandLists(ppCommandLists);
+                    swapChain->Present(1);
+                    frameRing.EndFrame();
+                }
+            });
+
+            frameRing.Flush();
+        }
+
+        // Compiling a frame's graph: culling, placing the transients and deriving the
+        // barriers. The counters are the memory of the transients as committed resources and
+        // once aliased in the heaps, in MiB, and the barriers recorded for the resource uses.
+        if (suite.IsEnabled("RenderGraph")) {
+            constexpr UInt32 PassCount = 1000;
+            constexpr Float64 MiB = 1024.0 * 1024.0;
+
+            RenderGraph graph = MakeBenchmarkRenderGraph(PassCount);
+            graph.Compile();
+            const RenderGraphStatistics& statistics = graph.GetStatistics();
+
+            suite.Run("RenderGraph/Compile1000", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    graph.Compile();
+                    DoNotOptimize(graph.GetHeapSizes().data());
+                }
+            }, 0, {
+                {"culled_passes", static_cast<Float64>(statistics.CulledPassCount)},
+                {"transients", static_cast<Float64>(statistics.TransientCount)},
+                {"committed_mib", static_cast<Float64>(statistics.TransientSize) / MiB},
+                {"heap_mib", static_cast<Float64>(statistics.HeapSize) / MiB},
+                {"saved_mib", static_cast<Float64>(statistics.TransientSize - statistics.HeapSize) / MiB},
+                {"uses", static_cast<Float64>(statistics.UseCount)},
+                {"transitions", static_cast<Float64>(statistics.TransitionCount)},
+                {"uav_barriers", static_cast<Float64>(statistics.UavBarrierCount)},
+                {"aliasing_barriers", static_cast<Float64>(statistics.AliasingBarrierCount)}
+            });
+        }
+    }
+}
@@ -0,0 +1,437 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/MeshFile.hpp"
+#include "Framework/MeshOptimizer.hpp"
+#include "Framework/MeshletBuilder.hpp"
+#include "Framework/ObjImporter.hpp"
+#include "Framework/SimulatedGpuTimeline.hpp"
+#include "Framework/TextureFormat.hpp"
+#include "Framework/UploadRing.hpp"
+#include "Framework/VertexCompression.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <random>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        // Vertex layout of HelloTriangle.
+        struct Vertex {
+            Float32 Position[3];
+            Float32 Color[4];
+        };
+
+        // A grid of quads, in clip space scaled by the aspect ratio like the samples do.
+        void BuildGridVertices(std::vector<Vertex>& vertices, const UInt32 quadsPerSide, const Float32 aspectRatio) {
+            vertices.resize(UInt64(quadsPerSide) * quadsPerSide * 6);
+
+            const Float32 step = 2.0f / static_cast<Float32>(quadsPerSide);
+            Vertex* pVertex = vertices.data();
+            for (UInt32 y = 0; y < quadsPerSide; ++y) {
+                for (UInt32 x = 0; x < quadsPerSide; ++x) {
+                    const Float32 left = -1.0f + static_cast<Float32>(x) * step;
+                    const Float32 bottom = (-1.0f + static_cast<Float32>(y) * step) * aspectRatio;
+                    const Float32 right = left + step;
+                    const Float32 top = bottom + step * aspectRatio;
+                    const Float32 red = static_cast<Float32>(x) / static_cast<Float32>(quadsPerSide);
+                    const Float32 green = static_cast<Float32>(y) / static_cast<Float32>(quadsPerSide);
+
+                    const Float32 corners[6][2] = {{left, top}, {right, top}, {left, bottom},
+                                                   {left, bottom}, {right, top}, {right, bottom}};
+                    for (const auto& corner : corners) {
+                        *pVertex++ = {{corner[0], corner[1], 0.0f}, {red, green, 1.0f - red, 1.0f}};
+                    }
+                }
+            }
+        }
+
+        template<typename T>
+        MeshStream MakeStream(const MeshSemantic semantic, const UInt32 format, const std::vector<T>& values) {
+            MeshStream stream;
+            stream.Semantic = semantic;
+            stream.Format = format;
+            stream.Stride = sizeof(T);
+            stream.Data.resize(values.size() * sizeof(T));
+            std::memcpy(stream.Data.data(), values.data(), stream.Data.size());
+
+            return stream;
+        }
+
+        // Indexed grid of verticesPerSide^2 vertices with positions, normals and texture
+        // coordinates, as one submesh.
+        MeshData BuildGridMesh(const UInt32 verticesPerSide) {
+            struct Float3 {
+                Float32 X, Y, Z;
+            };
+            struct Float2 {
+                Float32 X, Y;
+            };
+
+            std::vector<Float3> positions;
+            std::vector<Float3> normals;
+            std::vector<Float2> texCoords;
+            const Float32 scale = 1.0f / static_cast<Float32>(verticesPerSide - 1);
+            for (UInt32 y = 0; y < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x < verticesPerSide; ++x) {
+                    const Float32 u = static_cast<Float32>(x) * scale;
+                    const Float32 v = static_cast<Float32>(y) * scale;
+                    positions.push_back({u * 2.0f - 1.0f, v * 2.0f - 1.0f, 0.0f});
+                    normals.push_back({0.0f, 0.0f, -1.0f});
+                    texCoords.push_back({u, v});
+                }
+            }
+
+            MeshData mesh;
+            mesh.VertexCount = verticesPerSide * verticesPerSide;
+            mesh.Streams.push_back(MakeStream(MeshSemantic::Position, DxgiFormat::R32G32B32Float, positions));
+            mesh.Streams.push_back(MakeStream(MeshSemantic::Normal, DxgiFormat::R32G32B32Float, normals));
+            mesh.Streams.push_back(MakeStream(MeshSemantic::TexCoord, DxgiFormat::R32G32Float, texCoords));
+
+            for (UInt32 y = 0; y + 1 < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x + 1 < verticesPerSide; ++x) {
+                    const UInt32 corner = y * verticesPerSide + x;
+                    for (const UInt32 index : {corner, corner + verticesPerSide, corner + 1,
+                                               corner + 1, corner + verticesPerSide, corner + verticesPerSide + 1}) {
+                        mesh.Indices.push_back(index);
+                    }
+                }
+            }
+
+            MeshSubmesh& submesh = mesh.Submeshes.emplace_back();
+            submesh.Name = "Grid";
+            submesh.Lods.push_back({0, static_cast<UInt32>(mesh.Indices.size()), 0, mesh.VertexCount, 0.0f, 0});
+            ComputeMeshBounds(mesh);
+
+            return mesh;
+        }
+
+        // Triangles in random order, the worst case for the vertex cache and fetches.
+        void ShuffleTriangles(MeshData& mesh) {
+            std::mt19937 random(42);
+            const UInt64 triangleCount = mesh.Indices.size() / 3;
+            for (UInt64 i = triangleCount - 1; i > 0; --i) {
+                const UInt64 j = std::uniform_int_distribution<UInt64>(0, i)(random);
+                std::swap_ranges(mesh.Indices.begin() + i * 3, mesh.Indices.begin() + i * 3 + 3, mesh.Indices.begin() + j * 3);
+            }
+        }
+
+        // Every triangle with its own three vertices, like an unindexed export.
+        MeshData SplitVertices(const MeshData& mesh) {
+            MeshData split = mesh;
+            split.VertexCount = static_cast<UInt32>(mesh.Indices.size());
+            for (UInt64 s = 0; s < mesh.Streams.size(); ++s) {
+                const UInt32 stride = mesh.Streams[s].Stride;
+                split.Streams[s].Data.resize(mesh.Indices.size() * stride);
+                for (UInt64 i = 0; i < mesh.Indices.size(); ++i) {
+                    std::memcpy(split.Streams[s].Data.data() + i * stride, mesh.Streams[s].Data.data() + UInt64(mesh.Indices[i]) * stride, stride);
+                }
+            }
+            for (UInt64 i = 0; i < split.Indices.size(); ++i) {
+                split.Indices[i] = static_cast<UInt32>(i);
+            }
+            split.Submeshes.front().Lods.front().VertexCount = split.VertexCount;
+
+            return split;
+        }
+
+        // The same grid as OBJ text, quads sharing their corners.
+        std::string BuildGridObj(const UInt32 verticesPerSide) {
+            std::string source;
+            char buffer[64];
+            const auto append = [&](const auto value) {
+                const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                source.append(buffer, end);
+            };
+
+            const Float32 scale = 1.0f / static_cast<Float32>(verticesPerSide - 1);
+            for (UInt32 y = 0; y < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x < verticesPerSide; ++x) {
+                    const Float32 u = static_cast<Float32>(x) * scale;
+                    const Float32 v = static_cast<Float32>(y) * scale;
+                    source += "v ";
+                    append(u * 2.0f - 1.0f);
+                    source += ' ';
+                    append(v * 2.0f - 1.0f);
+                    source += " 0\nvt ";
+                    append(u);
+                    source += ' ';
+                    append(v);
+                    source += '\n';
+                }
+            }
+
+            source += "vn 0 0 -1\n";
+            for (UInt32 y = 0; y + 1 < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x + 1 < verticesPerSide; ++x) {
+                    const UInt32 corner = y * verticesPerSide + x + 1;
+                    source += 'f';
+                    for (const UInt32 index : {corner, corner + verticesPerSide, corner + verticesPerSide + 1, corner + 1}) {
+                        source += ' ';
+                        append(index);
+                        source += '/';
+                        append(index);
+                        source += "/1";
+                    }
+                    source += '\n';
+                }
+            }
+
+            return source;
+        }
+    }
+
+    void RunGeometryBenchmarks(BenchmarkSuite& suite) {
+        if (!suite.IsEnabled("VertexData") && !suite.IsEnabled("MeshFile") && !suite.IsEnabled("ObjMesh") &&
+            !suite.IsEnabled("MeshOptimizer") && !suite.IsEnabled("MeshletBuilder") && !suite.IsEnabled("VertexCompression")) {
+            return;
+        }
+
+        SimulatedGpuTimeline timeline;
+        std::vector<std::byte> memory(128 * 1024 * 1024);
+        UploadRing ring(timeline, memory.data(), 0, memory.size());
+
+        // What HelloTriangle prepares and uploads in LoadAssets.
+        suite.Run("VertexData/Triangle/BuildAndUpload", [&](const UInt64 iterationCount) {
+            const Float32 aspectRatio = 16.0f / 9.0f;
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                const Vertex triangleVertices[] = {
+                    {{0.0f, 0.25f * aspectRatio, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
+                    {{0.25f, -0.25f * aspectRatio, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
+                    {{-0.25f, -0.25f * aspectRatio, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}}
+                };
+                DoNotOptimize(ring.Upload(triangleVertices, sizeof(triangleVertices)));
+                if (i % 64 == 63) {
+                    timeline.Signal();
+                }
+            }
+        });
+
+        // 256x256 quads, 393216 vertices.
+        constexpr UInt32 QuadsPerSide = 256;
+        std::vector<Vertex> vertices;
+        BuildGridVertices(vertices, QuadsPerSide, 16.0f / 9.0f);
+        const UInt64 byteCount = vertices.size() * sizeof(Vertex);
+
+        suite.Run("VertexData/Grid256/Build", [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                BuildGridVertices(vertices, QuadsPerSide, 16.0f / 9.0f);
+                DoNotOptimize(vertices.data());
+            }
+        }, byteCount);
+
+        std::vector<std::byte> destination(byteCount);
+        suite.Run("VertexData/Grid256/Memcpy", [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                std::memcpy(destination.data(), vertices.data(), byteCount);
+                DoNotOptimize(destination.data());
+            }
+        }, byteCount);
+
+        suite.Run("VertexData/Grid256/Upload", [&](const UInt64 iterationCount) {
+            for (UInt64 i = 0; i < iterationCount; ++i) {
+                DoNotOptimize(ring.Upload(vertices.data(), byteCount));
+                timeline.Signal();
+            }
+        }, byteCount);
+
+        // Opening a mesh file reads the header and the tables only: the time does not depend
+        // on the vertex count, and the upload is one copy of the geometry.
+        if (suite.IsEnabled("MeshFile")) {
+            for (const UInt32 verticesPerSide : {64u, 256u, 1024u}) {
+                const std::string name = "Grid" + std::to_string(verticesPerSide);
+                const std::filesystem::path path = GetScratchDirectory() / (name + ".mesh");
+                SaveMeshFile(BuildGridMesh(verticesPerSide), path);
+
+                const UInt64 geometrySize = MeshFile(path).GetGeometryData().size();
+                suite.Run("MeshFile/Open/" + name, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        const MeshFile mesh(path);
+                        DoNotOptimize(mesh.GetGeometryData().data());
+                    }
+                });
+
+                suite.Run("MeshFile/OpenAndUpload/" + name, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        const MeshFile mesh(path);
+                        const std::span<const std::byte> geometry = mesh.GetGeometryData();
+                        DoNotOptimize(ring.Upload(geometry.data(), geometry.size()));
+                        timeline.Signal();
+                    }
+                }, geometrySize);
+            }
+        }
+
+        // What the converter does offline, for comparison with loading the converted file.
+        if (suite.IsEnabled("ObjMesh")) {
+            const std::string source = BuildGridObj(256);
+            suite.Run("ObjMesh/Parse/Grid256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    const MeshData mesh = ParseObjMesh(source);
+                    DoNotOptimize(mesh.Indices.data());
+                }
+            }, source.size());
+        }
+
+        // Each iteration restores the input, a copy of the indices or of the mesh, which is
+        // small next to the optimization. The grids start shuffled: ACMR 3.0, overfetch ~25.
+        if (suite.IsEnabled("MeshOptimizer")) {
+            MeshData grid = BuildGridMesh(256);
+            ShuffleTriangles(grid);
+            const std::span<const std::byte> positions = grid.FindStream(MeshSemantic::Position)->Data;
+            const UInt64 indexBytes = grid.Indices.size() * sizeof(UInt32);
+            std::vector<UInt32> indices;
+
+            suite.Run("MeshOptimizer/AnalyzeVertexCache/Grid256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(AnalyzeVertexCache(grid.Indices, grid.VertexCount).TransformCount);
+                }
+            }, indexBytes);
+
+            for (const VertexCacheAlgorithm algorithm : {VertexCacheAlgorithm::Tipsify, VertexCacheAlgorithm::Forsyth}) {
+                MeshOptimizeOptions options;
+                options.CacheAlgorithm = algorithm;
+                const std::string name = algorithm == VertexCacheAlgorithm::Tipsify ? "Tipsify" : "Forsyth";
+                suite.Run("MeshOptimizer/VertexCache/" + name + "/Grid256", [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        indices = grid.Indices;
+                        OptimizeVertexCache(indices, grid.VertexCount, options);
+                        DoNotOptimize(indices.data());
+                    }
+                }, indexBytes);
+            }
+
+            std::vector<UInt32> cacheOptimized = grid.Indices;
+            OptimizeVertexCache(cacheOptimized, grid.VertexCount);
+            suite.Run("MeshOptimizer/Overdraw/Grid256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    indices = cacheOptimized;
+                    OptimizeOverdraw(indices, positions, 3 * sizeof(Float32));
+                    DoNotOptimize(indices.data());
+                }
+            }, indexBytes);
+
+            const MeshData split = SplitVertices(grid);
+            suite.Run("MeshOptimizer/Weld/Grid256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    MeshData mesh = split;
+                    DoNotOptimize(WeldVertices(mesh));
+                }
+            });
+
+            // 1.2 million triangles, split in two chunks with several threads.
+            MeshData largeGrid = BuildGridMesh(768);
+            ShuffleTriangles(largeGrid);
+            for (const UInt32 threadCount : {1u, 4u}) {
+                MeshOptimizeOptions options;
+                options.ThreadCount = threadCount;
+                suite.Run("MeshOptimizer/OptimizeMesh/Grid768/Threads" + std::to_string(threadCount), [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        MeshData mesh = largeGrid;
+                        DoNotOptimize(OptimizeMesh(mesh, options).CacheAfter.Acmr);
+                    }
+                }, largeGrid.Indices.size() * sizeof(UInt32));
+            }
+        }
+
+        // With the default 64 vertices and 124 primitives, the grids fill the meshlets to about
+        // 0.94 of the vertices and 0.72 of the primitives, shuffled or not.
+        if (suite.IsEnabled("MeshletBuilder")) {
+            MeshData grid = BuildGridMesh(256);
+            const UInt64 indexBytes = grid.Indices.size() * sizeof(UInt32);
+            suite.Run("MeshletBuilder/Build/Grid256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(BuildMeshlets(grid).Meshlets.data());
+                }
+            }, indexBytes);
+
+            ShuffleTriangles(grid);
+            suite.Run("MeshletBuilder/Build/Grid256Shuffled", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(BuildMeshlets(grid).Meshlets.data());
+                }
+            }, indexBytes);
+
+            // Meshes are built in parallel, one thread per range of meshes.
+            const std::vector<MeshData> meshes(16, BuildGridMesh(128));
+            for (const UInt32 threadCount : {1u, 4u}) {
+                MeshletBuildOptions options;
+                options.ThreadCount = threadCount;
+                suite.Run("MeshletBuilder/BuildMeshes/16xGrid128/Threads" + std::to_string(threadCount), [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        DoNotOptimize(BuildMeshlets(meshes, options).data());
+                    }
+                }, meshes.size() * meshes[0].Indices.size() * sizeof(UInt32));
+            }
+        }
+
+        // One million random vertices per attribute, with the bytes read from the float
+        // streams. All levels write the same bits.
+        if (suite.IsEnabled("VertexCompression")) {
+            constexpr UInt32 VertexCount = 1024 * 1024;
+            std::mt19937 generator(42);
+            std::uniform_real_distribution<Float32> distribution(-1.0f, 1.0f);
+            std::vector<Float32> source(UInt64(VertexCount) * 4);
+            for (Float32& value : source) {
+                value = distribution(generator);
+            }
+            const std::span<const std::byte> sourceBytes = std::as_bytes(std::span(source));
+            std::vector<std::byte> encoded(UInt64(VertexCount) * QuantizedPositionSize);
+
+            const Float32 boundsMin[3] = {-1.0f, -1.0f, -1.0f};
+            const Float32 boundsMax[3] = {1.0f, 1.0f, 1.0f};
+            const PositionQuantization quantization = GetPositionQuantization(boundsMin, boundsMax);
+
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                if (level > GetSimdLevel()) {
+                    continue;
+                }
+
+                VertexCompressionOptions options;
+                options.MaxSimdLevel = level;
+                options.ThreadCount = 1;
+                const std::string variant = std::string(GetSimdLevelName(level)) + "/Threads1";
+
+                suite.Run("VertexCompression/Positions/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        EncodeQuantizedPositions(encoded, sourceBytes, 3 * sizeof(Float32), VertexCount, quantization, options);
+                        DoNotOptimize(encoded.data());
+                    }
+                }, UInt64(VertexCount) * 3 * sizeof(Float32));
+
+                suite.Run("VertexCompression/Normals/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        EncodeOctahedralNormals(encoded, sourceBytes, 3 * sizeof(Float32), VertexCount, options);
+                        DoNotOptimize(encoded.data());
+                    }
+                }, UInt64(VertexCount) * 3 * sizeof(Float32));
+
+                suite.Run("VertexCompression/Tangents/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        EncodeOctahedralTangents(encoded, sourceBytes, 4 * sizeof(Float32), VertexCount, options);
+                        DoNotOptimize(encoded.data());
+                    }
+                }, UInt64(VertexCount) * 4 * sizeof(Float32));
+
+                suite.Run("VertexCompression/TexCoords/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        EncodeHalfTexCoords(encoded, sourceBytes, 2 * sizeof(Float32), VertexCount, options);
+                        DoNotOptimize(encoded.data());
+                    }
+                }, UInt64(VertexCount) * 2 * sizeof(Float32));
+
+                suite.Run("VertexCompression/Colors/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        EncodeUnormColors(encoded, sourceBytes, 4 * sizeof(Float32), VertexCount, options);
+                        DoNotOptimize(encoded.data());
+                    }
+                }, UInt64(VertexCount) * 4 * sizeof(Float32));
+            }
+        }
+    }
+}
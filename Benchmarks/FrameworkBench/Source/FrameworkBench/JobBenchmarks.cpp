@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/JobSystem.hpp"
+#include "Framework/ParallelFor.hpp"
+
+#include <array>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr UInt32 ThreadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+        constexpr UInt32 JobCount = 1024;
+
+        // About a microsecond of work that cannot be optimized away or vectorized.
+        UInt64 DoFixedWork(UInt64 state) {
+            for (UInt32 i = 0; i < 256; ++i) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+            }
+
+            return state;
+        }
+    }
+
+    void RunJobBenchmarks(BenchmarkSuite& suite) {
+        // Summed by ParallelFor, larger than the caches.
+        std::vector<UInt32> values;
+        if (suite.IsEnabled("JobSystem/ParallelFor") || suite.IsEnabled("ParallelFor")) {
+            values.resize(16 * 1024 * 1024);
+            for (UInt32 i = 0; i < values.size(); ++i) {
+                values[i] = i;
+            }
+        }
+
+        const auto sumRange = [&values](const UInt64 begin, const UInt64 end) {
+            UInt64 sum = 0;
+            for (UInt64 i = begin; i < end; ++i) {
+                sum += values[i];
+            }
+            DoNotOptimize(sum);
+        };
+
+        if (suite.IsEnabled("JobSystem")) {
+            for (const UInt32 threadCount : ThreadCounts) {
+                const std::string threads = "/Threads" + std::to_string(threadCount);
+
+                JobSystem jobSystem(threadCount);
+
+                // Scheduling and synchronization overhead alone.
+                suite.Run("JobSystem/EmptyJobs1024" + threads, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        JobCounter counter;
+                        for (UInt32 job = 0; job < JobCount; ++job) {
+                            jobSystem.Schedule([]() {}, &counter);
+                        }
+                        jobSystem.Wait(counter);
+                    }
+                });
+
+                suite.Run("JobSystem/FixedCostJobs1024" + threads, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        JobCounter counter;
+                        for (UInt32 job = 0; job < JobCount; ++job) {
+                            jobSystem.Schedule([job]() { DoNotOptimize(DoFixedWork(job)); }, &counter);
+                        }
+                        jobSystem.Wait(counter);
+                    }
+                });
+
+                // A chain of dependent jobs, the worst case for the continuations.
+                suite.Run("JobSystem/DependencyChain64" + threads, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        std::array<JobCounter, 64> counters;
+                        for (UInt32 job = 0; job < counters.size(); ++job) {
+                            JobCounter* pDependency = job == 0 ? nullptr : &counters[job - 1];
+                            jobSystem.Schedule([]() {}, &counters[job],
+                                               pDependency == nullptr ? std::span<JobCounter* const>()
+                                                                      : std::span<JobCounter* const>(&pDependency, 1));
+                        }
+                        for (JobCounter& counter : counters) {
+                            jobSystem.Wait(counter);
+                        }
+                    }
+                });
+
+                if (!values.empty()) {
+                    suite.Run("JobSystem/ParallelFor64MiB" + threads, [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            jobSystem.ParallelFor(values.size(), threadCount * 4, sumRange);
+                        }
+                    }, values.size() * sizeof(UInt32));
+                }
+            }
+        }
+
+        // The free function starts its threads on every call.
+        if (!values.empty()) {
+            for (const UInt32 threadCount : ThreadCounts) {
+                suite.Run("ParallelFor/Sum64MiB/Threads" + std::to_string(threadCount), [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        ParallelFor(values.size(), threadCount, sumRange);
+                    }
+                }, values.size() * sizeof(UInt32));
+            }
+        }
+    }
+}
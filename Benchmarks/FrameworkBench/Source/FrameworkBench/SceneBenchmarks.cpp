@@ -0,0 +1,157 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/Culling.hpp"
+#include "Framework/DrawQueue.hpp"
+
+#include <random>
+#include <thread>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        // Looking down +z from the origin, 90 degrees vertically at 16:9, from 0.1 to 1000, in
+        // the DirectXMath convention like XMMatrixPerspectiveFovLH.
+        CullingFrustum MakeBenchmarkFrustum() {
+            constexpr Float32 Near = 0.1f;
+            constexpr Float32 Far = 1000.0f;
+            constexpr Float32 AspectRatio = 16.0f / 9.0f;
+            const Float32 viewProjection[4][4] = {
+                {1.0f / AspectRatio, 0.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f, 0.0f},
+                {0.0f, 0.0f, Far / (Far - Near), 1.0f},
+                {0.0f, 0.0f, -Near * Far / (Far - Near), 0.0f}
+            };
+
+            return MakeCullingFrustum(viewProjection, {0.0f, 0.0f, 0.0f}, 500.0f);
+        }
+
+        // Packets of objects in submission order, e.g. the order of a scene traversal: 4096
+        // meshes with a material each, out of 1024 materials over 16 pipelines, with a tenth of
+        // the objects transparent. The depth field holds the depth, or the mesh for the opaque
+        // objects when instancing.
+        std::vector<DrawPacket> MakeBenchmarkPackets(const UInt32 packetCount, const bool instancing) {
+            constexpr UInt32 MaterialCount = 1024;
+            constexpr UInt32 PipelineCount = 16;
+            constexpr UInt32 GeometryCount = 4096;
+
+            std::mt19937 random(11);
+            std::uniform_real_distribution<Float32> depth(0.0f, 1000.0f);
+
+            std::vector<DrawPacket> packets(packetCount);
+            for (UInt32 i = 0; i < packetCount; ++i) {
+                const UInt32 geometry = random() % GeometryCount;
+                const UInt32 material = geometry % MaterialCount;
+                const bool transparent = random() % 10 == 0;
+                const UInt32 depthField = instancing && !transparent ? geometry
+                    : QuantizeDrawDepth(depth(random), 1000.0f, transparent);
+
+                packets[i].Key = MakeDrawKey(transparent ? 1 : 0, material % PipelineCount, material, depthField);
+                packets[i].Geometry = geometry;
+                packets[i].Instance = i;
+            }
+
+            return packets;
+        }
+
+        UInt64 GetStateChangeCount(const DrawStateChanges& changes) {
+            return changes.PipelineChanges + changes.MaterialChanges + changes.GeometryChanges;
+        }
+    }
+
+    void RunSceneBenchmarks(BenchmarkSuite& suite) {
+        if (suite.IsEnabled("DrawQueue")) {
+            // A frame of packets, pushed then sorted and merged. The counters are per frame:
+            // draws and state changes once sorted, and the state changes saved against drawing
+            // the packets in submission order.
+            constexpr UInt32 PacketCount = 1024 * 1024;
+            for (const bool instancing : {false, true}) {
+                const std::vector<DrawPacket> packets = MakeBenchmarkPackets(PacketCount, instancing);
+                const UInt64 submissionStateChanges = GetStateChangeCount(CountDrawStateChanges(std::span(packets)));
+
+                DrawQueue queue;
+                queue.Reserve(PacketCount);
+                for (const DrawPacket& packet : packets) {
+                    queue.Push(packet);
+                }
+                queue.Sort();
+                const DrawStateChanges changes = CountDrawStateChanges(queue.GetBatches());
+
+                suite.Run(std::string("DrawQueue/1M/") + (instancing ? "Instancing" : "Depth"), [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        queue.Clear();
+                        for (const DrawPacket& packet : packets) {
+                            queue.Push(packet);
+                        }
+                        queue.Sort();
+                        DoNotOptimize(queue.GetBatches().data());
+                    }
+                }, UInt64(PacketCount) * sizeof(DrawPacket), {
+                    {"draws", static_cast<Float64>(changes.DrawCount)},
+                    {"state_changes", static_cast<Float64>(GetStateChangeCount(changes))},
+                    {"saved_state_changes", static_cast<Float64>(submissionStateChanges - GetStateChangeCount(changes))}
+                });
+            }
+        }
+
+        if (!suite.IsEnabled("Culling")) {
+            return;
+        }
+
+        // Objects all around the camera up to past the distance limit, about a sixth visible.
+        constexpr UInt32 ObjectCount = 1024 * 1024;
+        std::mt19937 random(7);
+        std::uniform_real_distribution<Float32> position(-600.0f, 600.0f);
+        std::uniform_real_distribution<Float32> size(0.5f, 4.0f);
+
+        BoundingSphereSet spheres;
+        BoundingBoxSet boxes;
+        spheres.Reserve(ObjectCount);
+        boxes.Reserve(ObjectCount);
+        for (UInt32 i = 0; i < ObjectCount; ++i) {
+            const Float32 center[3] = {position(random), position(random), position(random)};
+            spheres.Add(center, size(random));
+            boxes.Add(center, {size(random), size(random), size(random)});
+        }
+
+        const CullingFrustum frustum = MakeBenchmarkFrustum();
+        std::vector<UInt32> visible(ObjectCount);
+
+        std::vector<UInt32> threadCounts = {1};
+        const UInt32 hardwareThreadCount = std::thread::hardware_concurrency();
+        if (hardwareThreadCount > 1) {
+            threadCounts.push_back(hardwareThreadCount);
+        }
+
+        // The throughput is over the bounds read: 16 bytes per sphere and 24 per box, so that
+        // 1.6 GB/s is 100M spheres per second.
+        for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+            if (level > GetSimdLevel()) {
+                continue;
+            }
+
+            for (const UInt32 threadCount : threadCounts) {
+                CullingOptions options;
+                options.MaxSimdLevel = level;
+                options.ThreadCount = threadCount;
+                const std::string variant = std::string(GetSimdLevelName(level)) + "/Threads" + std::to_string(threadCount);
+
+                suite.Run("Culling/Spheres/1M/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        DoNotOptimize(CullSpheres(spheres, frustum, visible, options));
+                    }
+                }, UInt64(ObjectCount) * 4 * sizeof(Float32));
+
+                suite.Run("Culling/Boxes/1M/" + variant, [&](const UInt64 iterationCount) {
+                    for (UInt64 i = 0; i < iterationCount; ++i) {
+                        DoNotOptimize(CullBoxes(boxes, frustum, visible, options));
+                    }
+                }, UInt64(ObjectCount) * 6 * sizeof(Float32));
+            }
+        }
+    }
+}
@@ -0,0 +1,296 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/CachedShaderCompiler.hpp"
+#include "Framework/CommandRecorder.hpp"
+#include "Framework/PipelineRegistry.hpp"
+#include "Framework/RecordingCommandList.hpp"
+#include "Framework/ResourceStateTable.hpp"
+#include "Framework/ResourceStateTracker.hpp"
+#include "Framework/ShaderCache.hpp"
+#include "Framework/StubShaderCompiler.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <tuple>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        // The pipeline of the samples: position and color, one render target.
+        GraphicsPipelineDesc MakePipelineDesc(const UInt64 vertexShader) {
+            GraphicsPipelineDesc desc;
+            desc.RootSignature = 1;
+            desc.VS = vertexShader;
+            desc.PS = 2;
+            desc.InputLayout = {{"POSITION", 0, DxgiFormat::R32G32B32Float, 0, 0, 0, 0},
+                                {"COLOR", 0, DxgiFormat::R32G32B32A32Float, 0, 12, 0, 0}};
+            desc.BlendState.RenderTargets[0].RenderTargetWriteMask = 0xf;
+            desc.SampleMask = ~0u;
+            desc.RasterizerState.FillMode = 3;
+            desc.RasterizerState.CullMode = 3;
+            desc.RasterizerState.DepthClipEnable = true;
+            desc.PrimitiveTopologyType = 3;
+            desc.NumRenderTargets = 1;
+            desc.RTVFormats[0] = DxgiFormat::R8G8B8A8Unorm;
+            desc.SampleCount = 1;
+
+            return desc;
+        }
+
+        struct BenchmarkDraw {
+            UInt32 Pipeline = 0;
+            UInt32 Material = 0;
+            UInt32 Geometry = 0;
+        };
+
+        // Objects sorted by pipeline, material then mesh, like the batches of a DrawQueue: 16
+        // pipelines, 256 materials and 1024 meshes.
+        std::vector<BenchmarkDraw> MakeBenchmarkDraws(const UInt32 drawCount) {
+            std::mt19937 random(5);
+            std::vector<BenchmarkDraw> draws(drawCount);
+            for (BenchmarkDraw& draw : draws) {
+                draw.Geometry = random() % 1024;
+                draw.Material = draw.Geometry % 256;
+                draw.Pipeline = draw.Material % 16;
+            }
+
+            std::ranges::sort(draws, [](const BenchmarkDraw& lhs, const BenchmarkDraw& rhs) {
+                return std::tie(lhs.Pipeline, lhs.Material, lhs.Geometry) < std::tie(rhs.Pipeline, rhs.Material, rhs.Geometry);
+            });
+            return draws;
+        }
+
+        // Never dereferenced, only compared.
+        template <class T>
+        T* MakeBenchmarkObject(const UInt32 index) {
+            return reinterpret_cast<T*>(static_cast<std::uintptr_t>(index + 1) * 256);
+        }
+
+        // A renderer setting all the state of each draw like the samples do for their one
+        // draw: the frame state, the pipeline, the material table, the geometry, then the
+        // object index and material index as root constants.
+        template <class TCommandList>
+        void RecordBenchmarkFrame(TCommandList& commandList, const std::span<const BenchmarkDraw> draws) {
+            ID3D12DescriptorHeap* const heaps[] = {MakeBenchmarkObject<ID3D12DescriptorHeap>(0)};
+            const Viewport viewport = {0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f};
+            const ScissorRect scissorRect = {0, 0, 1280, 720};
+
+            for (UInt32 i = 0; i < draws.size(); ++i) {
+                const BenchmarkDraw& draw = draws[i];
+                commandList.SetGraphicsRootSignature(MakeBenchmarkObject<ID3D12RootSignature>(0));
+                commandList.SetDescriptorHeaps(heaps);
+                commandList.RSSetViewports(std::span(&viewport, 1));
+                commandList.RSSetScissorRects(std::span(&scissorRect, 1));
+                commandList.IASetPrimitiveTopology(PrimitiveTopology::TriangleList);
+                commandList.SetPipelineState(MakeBenchmarkObject<ID3D12PipelineState>(draw.Pipeline));
+                commandList.SetGraphicsRootConstantBufferView(2, 0x10000);
+                commandList.SetGraphicsRootDescriptorTable(1, UInt64(draw.Material) * 32);
+
+                const VertexBufferView vertexBuffer = {UInt64(draw.Geometry) << 20, 1 << 16, 28};
+                const IndexBufferView indexBuffer = {(UInt64(draw.Geometry) << 20) + (1 << 16), 1 << 14, DxgiFormat::R16Uint};
+                commandList.IASetVertexBuffers(0, std::span(&vertexBuffer, 1));
+                commandList.IASetIndexBuffer(&indexBuffer);
+
+                const UInt32 constants[] = {i, draw.Material};
+                commandList.SetGraphicsRoot32BitConstants(0, constants, 0);
+                commandList.DrawIndexedInstanced(8192, 1, 0, 0, 0);
+            }
+        }
+    }
+
+    void RunStateBenchmarks(BenchmarkSuite& suite) {
+        // A frame using 10k resources: each one is transitioned once, to the opposite of its
+        // state in the previous frame, and the list is resolved against the table.
+        if (suite.IsEnabled("ResourceStateTracker")) {
+            constexpr UInt32 ResourceCount = 10000;
+
+            ResourceStateTable table;
+            std::vector<UInt32> resources(ResourceCount);
+            for (UInt32& resource : resources) {
+                resource = table.Register(1, ResourceState::PixelShaderResource);
+            }
+
+            ResourceStateTracker tracker(table);
+            UInt64 frame = 0;
+            suite.Run("ResourceStateTracker/Frame10k", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i, ++frame) {
+                    const ResourceState state = frame % 2 == 0 ? ResourceState::RenderTarget
+                                                               : ResourceState::PixelShaderResource;
+                    tracker.Reset();
+                    for (const UInt32 resource : resources) {
+                        tracker.Transition(resource, state);
+                    }
+                    DoNotOptimize(tracker.Close().size());
+                    DoNotOptimize(table.Resolve(tracker).size());
+                }
+            });
+        }
+
+        if (suite.IsEnabled("ShaderCache") || suite.IsEnabled("CachedShaderCompiler")) {
+            const std::filesystem::path directory = GetScratchDirectory();
+            ShaderCache cache(directory / "ShaderCache.bin");
+            cache.Clear();
+
+            constexpr UInt32 EntryCount = 1024;
+            const std::vector<std::byte> bytecode(4096, std::byte{0x42});
+            for (UInt64 key = 1; key <= EntryCount; ++key) {
+                cache.Insert(key, bytecode);
+            }
+
+            suite.Run("ShaderCache/FindHit", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(cache.Find(i % EntryCount + 1).data());
+                }
+            });
+
+            suite.Run("ShaderCache/FindMiss", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(cache.Find(EntryCount + 1 + i).data());
+                }
+            });
+
+            // Includes growing the table and the file from the initial size.
+            suite.Run("ShaderCache/Insert1024x4KiB", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    cache.Clear();
+                    for (UInt64 key = 1; key <= EntryCount; ++key) {
+                        cache.Insert(key, bytecode);
+                    }
+                }
+            }, EntryCount * bytecode.size());
+
+            // The key of a cache hit hashes the source and its includes.
+            const std::filesystem::path sourcePath = directory / "Shader.hlsl";
+            {
+                std::ofstream source(sourcePath, std::ios::binary | std::ios::trunc);
+                source << "#include \"Common.hlsli\"\n";
+                for (UInt32 i = 0; i < 64; ++i) {
+                    source << "float4 Function" << i << "(float4 value) { return value * " << i << ".0f; }\n";
+                }
+                std::ofstream(directory / "Common.hlsli", std::ios::binary | std::ios::trunc)
+                    << "cbuffer Constants : register(b0) { float4 Offset; };\n";
+            }
+
+            StubShaderCompiler compiler;
+            CachedShaderCompiler cachedCompiler(cache, compiler);
+
+            ShaderCompileDesc desc;
+            desc.SourcePath = sourcePath;
+            desc.EntryPoint = "VSMain";
+            desc.Target = "vs_5_0";
+            desc.Defines = {{"PERMUTATION", "0"}};
+
+            cache.Clear();
+            cachedCompiler.Compile(desc);
+            suite.Run("CachedShaderCompiler/Hit", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(cachedCompiler.Compile(desc).data());
+                }
+            });
+
+            // 64 permutations from an empty cache, then from the warm cache of the previous run.
+            suite.Run("CachedShaderCompiler/Permutations64Cold", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    cache.Clear();
+                    for (UInt32 permutation = 0; permutation < 64; ++permutation) {
+                        desc.Defines[0].Value = std::to_string(permutation);
+                        DoNotOptimize(cachedCompiler.Compile(desc).data());
+                    }
+                }
+            });
+
+            suite.Run("CachedShaderCompiler/Permutations64Warm", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    for (UInt32 permutation = 0; permutation < 64; ++permutation) {
+                        desc.Defines[0].Value = std::to_string(permutation);
+                        DoNotOptimize(cachedCompiler.Compile(desc).data());
+                    }
+                }
+            });
+        }
+
+        if (suite.IsEnabled("PipelineRegistry") || suite.IsEnabled("GraphicsPipelineDesc")) {
+            const GraphicsPipelineDesc desc = MakePipelineDesc(1);
+
+            suite.Run("GraphicsPipelineDesc/Hash", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(HashPipelineDesc(desc));
+                }
+            });
+
+            suite.Run("GraphicsPipelineDesc/CanonicalizeAndHash", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(HashPipelineDesc(CanonicalizePipelineDesc(desc)));
+                }
+            });
+
+            PipelineRegistry<UInt64> registry([](const GraphicsPipelineDesc& pipelineDesc) { return pipelineDesc.VS; });
+            registry.GetOrCreate(desc);
+            suite.Run("PipelineRegistry/Hit", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(registry.GetOrCreate(desc));
+                }
+            });
+
+            // Each iteration fills a new registry with 256 pipelines.
+            std::vector<GraphicsPipelineDesc> descs;
+            for (UInt64 vertexShader = 0; vertexShader < 256; ++vertexShader) {
+                descs.push_back(MakePipelineDesc(vertexShader + 1));
+            }
+            suite.Run("PipelineRegistry/Miss256", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    PipelineRegistry<UInt64> emptyRegistry([](const GraphicsPipelineDesc& pipelineDesc) {
+                        return pipelineDesc.VS;
+                    });
+                    for (const GraphicsPipelineDesc& missingDesc : descs) {
+                        DoNotOptimize(emptyRegistry.GetOrCreate(missingDesc));
+                    }
+                }
+            });
+        }
+
+        // A frame of 10k draws recorded into a RecordingCommandList, directly or through a
+        // CommandRecorder. The counters are per frame: the calls made by the renderer, those
+        // reaching the list, and the share of the calls the recorder drops or merges.
+        if (suite.IsEnabled("CommandRecorder")) {
+            constexpr UInt32 DrawCount = 10000;
+            const std::vector<BenchmarkDraw> draws = MakeBenchmarkDraws(DrawCount);
+
+            RecordingCommandList commandList;
+            CommandRecorder recorder(commandList);
+            RecordBenchmarkFrame(recorder, draws);
+            const CommandRecorderStatistics statistics = recorder.GetStatistics();
+            const Float64 recordedCalls = static_cast<Float64>(statistics.RecordedCalls);
+
+            suite.Run("CommandRecorder/Frame10k/Direct", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    commandList.Clear();
+                    RecordBenchmarkFrame(commandList, draws);
+                    DoNotOptimize(commandList.GetCommands().data());
+                }
+            }, 0, {{"calls", recordedCalls}});
+
+            suite.Run("CommandRecorder/Frame10k/Recorder", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    commandList.Clear();
+                    recorder.Reset();
+                    RecordBenchmarkFrame(recorder, draws);
+                    DoNotOptimize(commandList.GetCommands().data());
+                }
+            }, 0, {
+                {"calls", recordedCalls},
+                {"forwarded_calls", static_cast<Float64>(statistics.ForwardedCalls)},
+                {"filtered_ratio", static_cast<Float64>(statistics.FilteredCalls + statistics.CoalescedCalls) / recordedCalls}
+            });
+        }
+    }
+}
@@ -0,0 +1,217 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include "Framework/ProceduralTexture.hpp"
+#include "Framework/SubresourceCopy.hpp"
+
+#include <cstring>
+#include <thread>
+
+namespace FrameworkBench {
+    using namespace D3D12Tests;
+
+    namespace {
+        // The levels up to the one of the CPU, higher ones would be lowered to it.
+        std::vector<SimdLevel> GetSupportedSimdLevels() {
+            std::vector<SimdLevel> levels;
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                if (level <= GetSimdLevel()) {
+                    levels.push_back(level);
+                }
+            }
+
+            return levels;
+        }
+
+        // One thread, and all the hardware threads when there are more.
+        std::vector<UInt32> GetThreadCounts() {
+            std::vector<UInt32> threadCounts = {1};
+            const UInt32 hardwareThreadCount = std::thread::hardware_concurrency();
+            if (hardwareThreadCount > 1) {
+                threadCounts.push_back(hardwareThreadCount);
+            }
+
+            return threadCounts;
+        }
+
+        std::string GetVariantName(const SimdLevel level, const UInt32 threadCount) {
+            return std::string(GetSimdLevelName(level)) + "/Threads" + std::to_string(threadCount);
+        }
+
+        // The per-byte checkerboard loop HelloTexture used before ProceduralTexture, as a reference.
+        void GenerateReferenceCheckerboard(std::byte* pData, const UInt32 width, const UInt32 height) {
+            const UInt32 rowPitch = width * 4;
+            const UInt32 cellPitch = rowPitch >> 3;
+            const UInt32 cellHeight = width >> 3;
+            const UInt32 textureSize = rowPitch * height;
+
+            for (UInt32 n = 0; n < textureSize; n += 4) {
+                const UInt32 x = n % rowPitch;
+                const UInt32 y = n / rowPitch;
+                const UInt32 i = x / cellPitch;
+                const UInt32 j = y / cellHeight;
+
+                const std::byte color = i % 2 == j % 2 ? std::byte{0x00} : std::byte{0xff};
+                pData[n] = color;
+                pData[n + 1] = color;
+                pData[n + 2] = color;
+                pData[n + 3] = std::byte{0xff};
+            }
+        }
+    }
+
+    void RunTextureBenchmarks(BenchmarkSuite& suite) {
+        if (suite.IsEnabled("ProceduralTexture")) {
+            constexpr UInt32 Size = 2048;
+            constexpr UInt64 ByteCount = UInt64(Size) * Size * 4;
+
+            std::vector<std::byte> pixels(ByteCount);
+            const TextureRegion region{pixels.data(), Size, Size, Size * 4};
+
+            suite.Run("ProceduralTexture/Checkerboard/ReferenceLoop", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    GenerateReferenceCheckerboard(pixels.data(), Size, Size);
+                    DoNotOptimize(pixels.data());
+                }
+            }, ByteCount);
+
+            CheckerboardDesc checkerboard;
+            checkerboard.CellWidth = Size / 8;
+            checkerboard.CellHeight = Size / 8;
+
+            GradientDesc gradient;
+            gradient.EndX = static_cast<Float32>(Size);
+            gradient.EndY = static_cast<Float32>(Size);
+
+            NoiseDesc valueNoise;
+            valueNoise.Type = NoiseType::Value;
+            valueNoise.Octaves = 4;
+
+            NoiseDesc simplexNoise;
+            simplexNoise.Type = NoiseType::Simplex;
+            simplexNoise.Octaves = 4;
+
+            for (const SimdLevel level : GetSupportedSimdLevels()) {
+                for (const UInt32 threadCount : GetThreadCounts()) {
+                    ProceduralTextureOptions options;
+                    options.MaxSimdLevel = level;
+                    options.ThreadCount = threadCount;
+
+                    const std::string variant = GetVariantName(level, threadCount);
+                    suite.Run("ProceduralTexture/Checkerboard/" + variant, [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            GenerateCheckerboard(region, checkerboard, options);
+                            DoNotOptimize(pixels.data());
+                        }
+                    }, ByteCount);
+
+                    suite.Run("ProceduralTexture/Gradient/" + variant, [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            GenerateGradient(region, gradient, options);
+                            DoNotOptimize(pixels.data());
+                        }
+                    }, ByteCount);
+
+                    suite.Run("ProceduralTexture/ValueNoise4/" + variant, [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            GenerateNoise(region, valueNoise, options);
+                            DoNotOptimize(pixels.data());
+                        }
+                    }, ByteCount);
+
+                    suite.Run("ProceduralTexture/SimplexNoise4/" + variant, [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            GenerateNoise(region, simplexNoise, options);
+                            DoNotOptimize(pixels.data());
+                        }
+                    }, ByteCount);
+                }
+            }
+        }
+
+        if (suite.IsEnabled("SubresourceCopy") || suite.IsEnabled("StreamCopy")) {
+            // A full mip chain of a cubemap.
+            TextureCopyDesc cubemapDesc;
+            cubemapDesc.Format = DxgiFormat::BC7Unorm;
+            cubemapDesc.Width = 2048;
+            cubemapDesc.Height = 2048;
+            cubemapDesc.DepthOrArraySize = 6;
+            cubemapDesc.MipLevels = 12;
+
+            std::vector<SubresourceFootprint> footprints(GetSubresourceCount(cubemapDesc));
+            suite.Run("SubresourceCopy/ComputeFootprints/Cubemap2048Mips", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    DoNotOptimize(ComputeCopyableFootprints(cubemapDesc, 0, 0, footprints));
+                }
+            });
+
+            // Rows of 8000 bytes, padded to 8192 in the upload buffer.
+            TextureCopyDesc desc;
+            desc.Format = DxgiFormat::R8G8B8A8Unorm;
+            desc.Width = 2000;
+            desc.Height = 2000;
+
+            SubresourceFootprint footprint;
+            const UInt64 uploadSize = ComputeCopyableFootprints(desc, 0, 0, {&footprint, 1});
+            const UInt64 rowSize = footprint.RowSize;
+
+            std::vector<std::byte> source(rowSize * footprint.RowCount, std::byte{0x3c});
+            std::vector<std::byte> destination(uploadSize);
+            const SubresourceData data{source.data(), rowSize, rowSize * footprint.RowCount};
+
+            suite.Run("SubresourceCopy/2000x2000/MemcpyRows", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    for (UInt32 row = 0; row < footprint.RowCount; ++row) {
+                        std::memcpy(destination.data() + row * footprint.RowPitch, source.data() + row * rowSize, rowSize);
+                    }
+                    DoNotOptimize(destination.data());
+                }
+            }, source.size());
+
+            for (const SimdLevel level : GetSupportedSimdLevels()) {
+                for (const UInt32 threadCount : GetThreadCounts()) {
+                    SubresourceCopyOptions options;
+                    options.MaxSimdLevel = level;
+                    options.ThreadCount = threadCount;
+
+                    suite.Run("SubresourceCopy/2000x2000/" + GetVariantName(level, threadCount), [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            CopySubresource(destination.data(), footprint, data, options);
+                            DoNotOptimize(destination.data());
+                        }
+                    }, source.size());
+                }
+            }
+
+            // Larger than the caches, like the uploads of whole assets.
+            constexpr UInt64 StreamSize = 64 * 1024 * 1024;
+            std::vector<std::byte> streamSource(StreamSize, std::byte{0x7e});
+            std::vector<std::byte> streamDestination(StreamSize);
+
+            suite.Run("StreamCopy/64MiB/Memcpy", [&](const UInt64 iterationCount) {
+                for (UInt64 i = 0; i < iterationCount; ++i) {
+                    std::memcpy(streamDestination.data(), streamSource.data(), StreamSize);
+                    DoNotOptimize(streamDestination.data());
+                }
+            }, StreamSize);
+
+            for (const SimdLevel level : GetSupportedSimdLevels()) {
+                for (const UInt32 threadCount : GetThreadCounts()) {
+                    SubresourceCopyOptions options;
+                    options.MaxSimdLevel = level;
+                    options.ThreadCount = threadCount;
+
+                    suite.Run("StreamCopy/64MiB/" + GetVariantName(level, threadCount), [&](const UInt64 iterationCount) {
+                        for (UInt64 i = 0; i < iterationCount; ++i) {
+                            StreamCopy(streamDestination.data(), streamSource.data(), StreamSize, options);
+                            DoNotOptimize(streamDestination.data());
+                        }
+                    }, StreamSize);
+                }
+            }
+        }
+    }
+}
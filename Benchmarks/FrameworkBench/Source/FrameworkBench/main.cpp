@@ -0,0 +1,125 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkBench/BenchmarkReport.hpp"
+#include "FrameworkBench/Benchmarks.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+namespace {
+    constexpr const char* Usage =
+        "Usage: FrameworkBench [options]\n"
+        "  --filter <prefix>       Only run the benchmarks whose name starts with the prefix, can be repeated.\n"
+        "  --repetitions <count>   Timed repetitions per benchmark (default 20).\n"
+        "  --warmup <count>        Untimed repetitions run first (default 2).\n"
+        "  --min-time <ms>         Minimum duration of a repetition (default 5).\n"
+        "  --file-size <MiB>       Size of the files of the load benchmarks (default 256).\n"
+        "  --output <path>         Writes the results to a JSON report.\n"
+        "  --baseline <path>       Compares the results with a JSON report, fails on regressions.\n"
+        "  --tolerance <fraction>  Slowdown over the baseline median counted as a regression (default 0.1).\n";
+}
+
+int main(int argc, char* argv[]) {
+    FrameworkBench::BenchmarkOptions options;
+    std::filesystem::path outputPath;
+    std::filesystem::path baselinePath;
+    D3D12Tests::Float64 tolerance = 0.1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* argument = argv[i];
+        if (std::strcmp(argument, "--help") == 0 || std::strcmp(argument, "-h") == 0) {
+            std::cout << Usage;
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value or unknown option: " << argument << '\n' << Usage;
+            return 2;
+        }
+
+        const char* value = argv[++i];
+        if (std::strcmp(argument, "--filter") == 0) {
+            options.Filters.emplace_back(value);
+        } else if (std::strcmp(argument, "--repetitions") == 0) {
+            options.Repetitions = static_cast<D3D12Tests::UInt32>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argument, "--warmup") == 0) {
+            options.WarmupRepetitions = static_cast<D3D12Tests::UInt32>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(argument, "--min-time") == 0) {
+            options.MinRepetitionTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::duration<D3D12Tests::Float64, std::milli>(std::strtod(value, nullptr)));
+        } else if (std::strcmp(argument, "--file-size") == 0) {
+            options.LargeFileSize = std::max<D3D12Tests::UInt64>(std::strtoull(value, nullptr, 10), 1) * 1024 * 1024;
+        } else if (std::strcmp(argument, "--output") == 0) {
+            outputPath = value;
+        } else if (std::strcmp(argument, "--baseline") == 0) {
+            baselinePath = value;
+        } else if (std::strcmp(argument, "--tolerance") == 0) {
+            tolerance = std::strtod(value, nullptr);
+        } else {
+            std::cerr << "Unknown option: " << argument << '\n' << Usage;
+            return 2;
+        }
+    }
+
+    try {
+        // Read first, so that a bad path does not waste a whole run.
+        FrameworkBench::BenchmarkReport baseline;
+        if (!baselinePath.empty()) {
+            baseline = FrameworkBench::LoadBenchmarkReport(baselinePath);
+        }
+
+        FrameworkBench::BenchmarkReport report;
+        report.Environment = FrameworkBench::GetBenchmarkEnvironment();
+        std::cout << "Platform " << report.Environment.Platform << ", " << report.Environment.SimdLevel << ", "
+            << report.Environment.HardwareThreadCount << " hardware threads\n\n";
+        std::cout << FrameworkBench::FormatBenchmarkHeader() << '\n';
+
+        FrameworkBench::BenchmarkSuite suite(options);
+        FrameworkBench::RunAllocatorBenchmarks(suite);
+        FrameworkBench::RunStateBenchmarks(suite);
+        FrameworkBench::RunTextureBenchmarks(suite);
+        FrameworkBench::RunFileBenchmarks(suite);
+        FrameworkBench::RunGeometryBenchmarks(suite);
+        FrameworkBench::RunJobBenchmarks(suite);
+        FrameworkBench::RunFrameBenchmarks(suite);
+        FrameworkBench::RunSceneBenchmarks(suite);
+
+        const std::span<const FrameworkBench::BenchmarkResult> results = suite.GetResults();
+        report.Results.assign(results.begin(), results.end());
+        if (!outputPath.empty()) {
+            FrameworkBench::SaveBenchmarkReport(report, outputPath);
+        }
+
+        if (!baselinePath.empty()) {
+            if (baseline.Environment.Platform != report.Environment.Platform ||
+                baseline.Environment.HardwareThreadCount != report.Environment.HardwareThreadCount) {
+                std::cout << "\nWarning: the baseline was measured on " << baseline.Environment.Platform << " with "
+                    << baseline.Environment.HardwareThreadCount << " hardware threads.\n";
+            }
+
+            const std::vector<FrameworkBench::BenchmarkComparison> comparisons =
+                FrameworkBench::CompareBenchmarks(results, baseline.Results, tolerance);
+            std::cout << "\nComparison with " << baselinePath.string() << " (median per iteration):\n"
+                << FrameworkBench::FormatBenchmarkComparison(comparisons);
+
+            const auto regressionCount = std::count_if(comparisons.begin(), comparisons.end(),
+                                                       [](const FrameworkBench::BenchmarkComparison& comparison) {
+                                                           return comparison.IsRegression;
+                                                       });
+            if (regressionCount != 0) {
+                std::cout << regressionCount << " benchmark(s) regressed by more than " << tolerance * 100.0 << "%.\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_ALIGNMENT_HPP
+#define D3D12TESTS_ALIGNMENT_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    // D3D12 placement rules, duplicated here so that platform-neutral code does not
+    // depend on d3d12.h. The values are checked against the SDK in D3D12UploadRing.cpp.
+    namespace Alignment {
+        constexpr UInt64 Buffer = 16;               // D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT
+        constexpr UInt64 ConstantBuffer = 256;      // D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+        constexpr UInt64 TexturePlacement = 512;    // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+        constexpr UInt64 TextureRowPitch = 256;     // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+        constexpr UInt64 ResourcePlacement = 65536; // D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+    }
+
+    inline constexpr bool IsPowerOfTwo(UInt64 value);
+
+    // The alignment must be a power of two.
+    inline constexpr UInt64 AlignUp(UInt64 value, UInt64 alignment);
+
+    // Constant buffer views cover a multiple of the constant buffer alignment.
+    inline constexpr UInt32 CalculateConstantBufferByteSize(UInt32 byteSize);
+}
+
+#include "Framework/Alignment.inl"
+
+#endif // D3D12TESTS_ALIGNMENT_HPP
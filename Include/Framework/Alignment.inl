@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline constexpr bool IsPowerOfTwo(const UInt64 value) {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+
+    inline constexpr UInt64 AlignUp(const UInt64 value, const UInt64 alignment) {
+        return (value + (alignment - 1)) & ~(alignment - 1);
+    }
+
+    inline constexpr UInt32 CalculateConstantBufferByteSize(const UInt32 byteSize) {
+        return static_cast<UInt32>(AlignUp(byteSize, Alignment::ConstantBuffer));
+    }
+}
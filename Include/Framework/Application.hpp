@@ -9,14 +9,16 @@
 
 #include "Framework/pch.hpp"
 
+#include "Framework/ApplicationBase.hpp"
 #include "Framework/ApplicationHelper.hpp"
+#include "Framework/Profiler.hpp"
 #include "Framework/Win32ApplicationBase.hpp"
 
 namespace D3D12Tests {
-    class Application {
+    class Application : public ApplicationBase {
     public:
         Application(UINT width, UINT height, std::wstring name);
-        virtual ~Application() = default;
+        ~Application() override = default;
 
         Application(const Application&) = delete;
         Application(Application&&) = delete;
@@ -24,11 +26,6 @@ namespace D3D12Tests {
         Application& operator=(const Application&) = delete;
         Application& operator=(Application&&) = delete;
 
-        virtual void OnInit() = 0;
-        virtual void OnUpdate() = 0;
-        virtual void OnRender() = 0;
-        virtual void OnDestroy() = 0;
-
         inline virtual void OnKeyDown(UINT key);
         inline virtual void OnKeyUp(UINT key);
 
@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_APPLICATIONBASE_HPP
+#define D3D12TESTS_APPLICATIONBASE_HPP
+
+#include "Framework/FramePacing.hpp"
+
+#include <functional>
+
+namespace D3D12Tests {
+    // Callbacks the run loops drive, without any window or device. Application adds the
+    // Win32 and DXGI parts, headless applications derive from this directly.
+    class ApplicationBase {
+    public:
+        ApplicationBase() = default;
+        virtual ~ApplicationBase() = default;
+
+        ApplicationBase(const ApplicationBase&) = delete;
+        ApplicationBase(ApplicationBase&&) = delete;
+
+        ApplicationBase& operator=(const ApplicationBase&) = delete;
+        ApplicationBase& operator=(ApplicationBase&&) = delete;
+
+        virtual void OnInit() = 0;
+        // Called FrameTiming::UpdateCount times per frame, possibly zero.
+        virtual void OnUpdate() = 0;
+        virtual void OnRender() = 0;
+        virtual void OnDestroy() = 0;
+
+        // Taken into account from the next frame on.
+        inline void SetFramePacing(const FramePacingDesc& pacing);
+        inline const FramePacingDesc& GetFramePacing() const;
+        inline const FrameTiming& GetFrameTiming() const;
+
+    protected:
+        // Blocks until the swap chain can take a new frame, for FramePacingMode::LowLatency.
+        inline void SetFrameLatencyWaiter(std::function<void()> waiter);
+
+    private:
+        friend class FrameLoop;
+
+        FramePacingDesc m_FramePacing;
+        FrameTiming m_FrameTiming;
+        std::function<void()> m_FrameLatencyWaiter;
+    };
+}
+
+#include "Framework/ApplicationBase.inl"
+
+#endif // D3D12TESTS_APPLICATIONBASE_HPP
@@ -0,0 +1,23 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void ApplicationBase::SetFramePacing(const FramePacingDesc& pacing) {
+        m_FramePacing = pacing;
+    }
+
+    inline const FramePacingDesc& ApplicationBase::GetFramePacing() const {
+        return m_FramePacing;
+    }
+
+    inline const FrameTiming& ApplicationBase::GetFrameTiming() const {
+        return m_FrameTiming;
+    }
+
+    inline void ApplicationBase::SetFrameLatencyWaiter(std::function<void()> waiter) {
+        m_FrameLatencyWaiter = std::move(waiter);
+    }
+}
@@ -8,6 +8,7 @@
 #define D3D12TESTS_APPLICATIONHELPER_HPP
 
 #include "Framework/pch.hpp"
+#include "Framework/Alignment.hpp"
 
 #include <stdexcept>
 
@@ -37,6 +38,8 @@ namespace D3D12Tests {
 
 	inline HRESULT ReadDataFromFile(LPCWSTR filename, byte** data, UINT* size);
 
+	// Copies the whole file and only checks the legacy header, DdsFile maps the file and
+	// reads every subresource.
 	inline HRESULT ReadDataFromDDSFile(LPCWSTR filename, byte** data, UINT* offset, UINT* size);
 
 	// Assign a name to the object to help debugging.
@@ -50,9 +53,8 @@ namespace D3D12Tests {
 #define NAME_D3D12_OBJECT(x) SetName((x).Get(), L#x)
 #define NAME_D3D12_OBJECT_INDEXED(x, n)	SetNameIndexed((x)[n].Get(), L#x, n)
 
-	inline UINT CalculateConstantBufferByteSize(UINT byteSize);
-
 #ifdef D3D_COMPILE_STANDARD_FILE_INCLUDE
+	// Goes through the default shader cache, see D3D12ShaderCache.
 	inline Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
 		const std::wstring& filename,
 		const D3D_SHADER_MACRO* defines,
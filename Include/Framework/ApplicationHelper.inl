@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "Framework/D3D12ShaderCache.hpp"
+
 namespace D3D12Tests {
     inline std::string HrToString(HRESULT hr) {
         char sStr[64] = {};
@@ -149,11 +151,6 @@ namespace D3D12Tests {
     inline void SetNameIndexed(ID3D12Object* pObject, LPCWSTR name, UINT index) {}
 #endif
 
-    inline UINT CalculateConstantBufferByteSize(UINT byteSize) {
-        // Constant buffer size is required to be aligned.
-        return (byteSize + (D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) & ~(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1));
-    }
-
 #ifdef D3D_COMPILE_STANDARD_FILE_INCLUDE
     inline Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
         const std::wstring& filename,
@@ -161,24 +158,20 @@ namespace D3D12Tests {
         const std::string& entryPoint,
         const std::string& target
     ) {
-        UINT compileFlags = 0;
+        ShaderCompileDesc desc;
+        desc.SourcePath = filename;
+        desc.EntryPoint = entryPoint;
+        desc.Target = target;
 #ifdef D3D12TESTS_DEBUG
-        compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+        desc.Flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
-        HRESULT hr;
-
-        Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
-        Microsoft::WRL::ComPtr<ID3DBlob> errors;
-        hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
-            entryPoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
-
-        if (errors != nullptr) {
-            OutputDebugStringA((char*)errors->GetBufferPointer());
+        for (const D3D_SHADER_MACRO* pDefine = defines; pDefine != nullptr && pDefine->Name != nullptr; ++pDefine) {
+            desc.Defines.push_back({pDefine->Name, pDefine->Definition != nullptr ? pDefine->Definition : ""});
         }
-        ThrowIfFailed(hr);
 
-        return byteCode;
+        // Shaders are only compiled when their bytecode is not in the cache yet.
+        return D3D12ShaderCache::GetDefault().Compile(desc);
     }
 #endif
 
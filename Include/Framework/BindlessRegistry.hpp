@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_BINDLESSREGISTRY_HPP
+#define D3D12TESTS_BINDLESSREGISTRY_HPP
+
+#include "Framework/GpuTimeline.hpp"
+
+#include <vector>
+
+namespace D3D12Tests {
+    // Handles are 32 bits: the slot index in the low bits, which is the index the shaders
+    // read from the bindless range, and the generation of the slot in the high bits.
+    // Generations start at 1, so that a zero handle is never valid.
+    inline constexpr UInt32 BindlessIndexBits = 20;
+    inline constexpr UInt32 BindlessGenerationBits = 32 - BindlessIndexBits;
+    inline constexpr UInt32 MaxBindlessSlots = 1u << BindlessIndexBits;
+    inline constexpr UInt32 MaxBindlessGeneration = (1u << BindlessGenerationBits) - 1;
+
+    struct BindlessHandle {
+        UInt32 Value = 0;
+
+        bool operator==(const BindlessHandle&) const = default;
+    };
+
+    inline constexpr BindlessHandle InvalidBindlessHandle = {};
+
+    inline BindlessHandle MakeBindlessHandle(UInt32 index, UInt32 generation);
+    inline UInt32 GetBindlessIndex(BindlessHandle handle);
+    inline UInt32 GetBindlessGeneration(BindlessHandle handle);
+
+    // Slots of a bindless descriptor range. Freeing a slot makes its handles stale right
+    // away, but the slot is only handed out again once the next value signaled on the
+    // timeline has completed, as the GPU may still read its descriptor until then. Slots
+    // whose generation is exhausted are retired instead, so that a stale handle can never
+    // become valid again. Not thread-safe.
+    class BindlessRegistry {
+    public:
+        // Throws std::invalid_argument unless the capacity is in [1, MaxBindlessSlots].
+        BindlessRegistry(GpuTimeline& timeline, UInt32 capacity);
+        ~BindlessRegistry() = default;
+
+        BindlessRegistry(const BindlessRegistry&) = delete;
+        BindlessRegistry(BindlessRegistry&&) = delete;
+
+        BindlessRegistry& operator=(const BindlessRegistry&) = delete;
+        BindlessRegistry& operator=(BindlessRegistry&&) = delete;
+
+        // Waits for the GPU when every slot is in use or pending, throws std::length_error
+        // when none is pending or the oldest one was freed after the last signal.
+        BindlessHandle Allocate();
+        // Throws std::invalid_argument for an invalid or stale handle.
+        void Free(BindlessHandle handle);
+
+        inline bool IsValid(BindlessHandle handle) const;
+        // The index of the slot, throws std::invalid_argument for an invalid or stale handle.
+        inline UInt32 Resolve(BindlessHandle handle) const;
+
+        inline UInt32 GetCapacity() const;
+        inline UInt32 GetLiveCount() const;
+        inline UInt32 GetPendingCount() const;
+        inline UInt32 GetRetiredCount() const;
+        // One past the highest slot handed out so far, the part of the range in use.
+        inline UInt32 GetHighWaterMark() const;
+
+    private:
+        // The generation of each slot, with LiveBit set while it is allocated.
+        static constexpr UInt16 LiveBit = 0x8000;
+        static_assert(MaxBindlessGeneration < LiveBit);
+
+        struct PendingSlot {
+            UInt64 FenceValue;
+            UInt32 Index;
+        };
+
+        void RecycleCompleted();
+
+        GpuTimeline& m_Timeline;
+
+        std::vector<UInt16> m_Slots;
+        // Recycled slots, the last freed first so that recently used descriptors are reused.
+        std::vector<UInt32> m_FreeSlots;
+        // Fence values only grow, the slots waiting for the GPU are a FIFO.
+        std::vector<PendingSlot> m_Pending;
+        UInt32 m_PendingHead;
+        UInt32 m_PendingCount;
+        UInt64 m_KnownCompletedValue;
+        UInt64 m_QueriedSignalValue;
+
+        UInt32 m_HighWaterMark;
+        UInt32 m_LiveCount;
+        UInt32 m_RetiredCount;
+    };
+}
+
+#include "Framework/BindlessRegistry.inl"
+
+#endif // D3D12TESTS_BINDLESSREGISTRY_HPP
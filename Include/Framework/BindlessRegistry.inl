@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline BindlessHandle MakeBindlessHandle(const UInt32 index, const UInt32 generation) {
+        return {generation << BindlessIndexBits | index};
+    }
+
+    inline UInt32 GetBindlessIndex(const BindlessHandle handle) {
+        return handle.Value & (MaxBindlessSlots - 1);
+    }
+
+    inline UInt32 GetBindlessGeneration(const BindlessHandle handle) {
+        return handle.Value >> BindlessIndexBits;
+    }
+
+    inline bool BindlessRegistry::IsValid(const BindlessHandle handle) const {
+        // The zero handle has generation 0, which no slot ever has.
+        const UInt32 index = GetBindlessIndex(handle);
+        return index < m_HighWaterMark && m_Slots[index] == (GetBindlessGeneration(handle) | LiveBit);
+    }
+
+    inline UInt32 BindlessRegistry::Resolve(const BindlessHandle handle) const {
+        if (!IsValid(handle)) {
+            throw std::invalid_argument("The bindless handle is invalid or stale.");
+        }
+
+        return GetBindlessIndex(handle);
+    }
+
+    inline UInt32 BindlessRegistry::GetCapacity() const {
+        return static_cast<UInt32>(m_Slots.size());
+    }
+
+    inline UInt32 BindlessRegistry::GetLiveCount() const {
+        return m_LiveCount;
+    }
+
+    inline UInt32 BindlessRegistry::GetPendingCount() const {
+        return m_PendingCount;
+    }
+
+    inline UInt32 BindlessRegistry::GetRetiredCount() const {
+        return m_RetiredCount;
+    }
+
+    inline UInt32 BindlessRegistry::GetHighWaterMark() const {
+        return m_HighWaterMark;
+    }
+}
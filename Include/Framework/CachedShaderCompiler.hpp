@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_CACHEDSHADERCOMPILER_HPP
+#define D3D12TESTS_CACHEDSHADERCOMPILER_HPP
+
+#include "Framework/ShaderCache.hpp"
+#include "Framework/ShaderCompiler.hpp"
+
+#include <span>
+
+namespace D3D12Tests {
+    // Puts a ShaderCache in front of a compiler. Shaders are addressed by a hash of
+    // everything the bytecode depends on: the source and the files it includes, the
+    // defines, the entry point, the target, the flags and the compiler version, so a
+    // cache hit never runs the compiler.
+    class CachedShaderCompiler {
+    public:
+        CachedShaderCompiler(ShaderCache& cache, ShaderCompiler& compiler);
+        ~CachedShaderCompiler() = default;
+
+        CachedShaderCompiler(const CachedShaderCompiler&) = delete;
+        CachedShaderCompiler(CachedShaderCompiler&&) = delete;
+
+        CachedShaderCompiler& operator=(const CachedShaderCompiler&) = delete;
+        CachedShaderCompiler& operator=(CachedShaderCompiler&&) = delete;
+
+        // The bytecode points into the cache and is valid until the next compilation.
+        std::span<const std::byte> Compile(const ShaderCompileDesc& desc);
+
+        UInt64 ComputeKey(const ShaderCompileDesc& desc) const;
+
+        inline UInt64 GetHitCount() const;
+        inline UInt64 GetMissCount() const;
+
+    private:
+        // Include directives are followed regardless of the preprocessor conditions around
+        // them, which can only make the key depend on more files than needed.
+        UInt64 HashSourceFile(const std::filesystem::path& path, const std::filesystem::path& rootDirectory,
+                              std::vector<std::filesystem::path>& visitedFiles) const;
+
+        ShaderCache& m_Cache;
+        ShaderCompiler& m_Compiler;
+        UInt64 m_HitCount;
+        UInt64 m_MissCount;
+    };
+}
+
+#include "Framework/CachedShaderCompiler.inl"
+
+#endif // D3D12TESTS_CACHEDSHADERCOMPILER_HPP
@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt64 CachedShaderCompiler::GetHitCount() const {
+        return m_HitCount;
+    }
+
+    inline UInt64 CachedShaderCompiler::GetMissCount() const {
+        return m_MissCount;
+    }
+}
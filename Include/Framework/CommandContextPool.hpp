@@ -0,0 +1,67 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_COMMANDCONTEXTPOOL_HPP
+#define D3D12TESTS_COMMANDCONTEXTPOOL_HPP
+
+#include "Framework/GpuTimeline.hpp"
+
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace D3D12Tests {
+    // Thread-safe pool of recording contexts (e.g. a command allocator and its command
+    // list). Contexts are given back tagged with the fence value of the submission that
+    // used them, and are only handed out again once that value has completed on the
+    // timeline. New contexts are created with the factory when none can be recycled.
+    template <class TContext>
+    class CommandContextPool {
+    public:
+        using Factory = std::function<TContext()>;
+
+        CommandContextPool(GpuTimeline& timeline, Factory factory);
+        ~CommandContextPool() = default;
+
+        CommandContextPool(const CommandContextPool&) = delete;
+        CommandContextPool(CommandContextPool&&) = delete;
+
+        CommandContextPool& operator=(const CommandContextPool&) = delete;
+        CommandContextPool& operator=(CommandContextPool&&) = delete;
+
+        TContext Acquire();
+        void Release(TContext context, UInt64 fenceValue);
+
+        inline std::size_t GetCreatedCount() const;
+        inline std::size_t GetAvailableCount() const;
+        inline std::size_t GetPendingCount() const;
+
+    private:
+        struct PendingContext {
+            UInt64 FenceValue;
+            TContext Context;
+
+            // std::priority_queue is a max-heap, the smallest fence value must come first.
+            inline bool operator<(const PendingContext& other) const;
+        };
+
+        void RecycleCompleted();
+
+        GpuTimeline& m_Timeline;
+        Factory m_Factory;
+
+        mutable std::mutex m_Mutex;
+        std::priority_queue<PendingContext> m_Pending;
+        std::vector<TContext> m_Available;
+        UInt64 m_KnownCompletedValue;
+        std::size_t m_CreatedCount;
+    };
+}
+
+#include "Framework/CommandContextPool.inl"
+
+#endif // D3D12TESTS_COMMANDCONTEXTPOOL_HPP
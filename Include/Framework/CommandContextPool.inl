@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    template <class TContext>
+    CommandContextPool<TContext>::CommandContextPool(GpuTimeline& timeline, Factory factory) :
+        m_Timeline(timeline),
+        m_Factory(std::move(factory)),
+        m_KnownCompletedValue(0),
+        m_CreatedCount(0) {
+    }
+
+    template <class TContext>
+    TContext CommandContextPool<TContext>::Acquire() {
+        {
+            std::lock_guard lock(m_Mutex);
+            RecycleCompleted();
+
+            if (!m_Available.empty()) {
+                TContext context = std::move(m_Available.back());
+                m_Available.pop_back();
+
+                return context;
+            }
+
+            ++m_CreatedCount;
+        }
+
+        // Creating a context can be slow, don't hold the other threads back meanwhile.
+        return m_Factory();
+    }
+
+    template <class TContext>
+    void CommandContextPool<TContext>::Release(TContext context, const UInt64 fenceValue) {
+        std::lock_guard lock(m_Mutex);
+        m_Pending.push({fenceValue, std::move(context)});
+    }
+
+    template <class TContext>
+    inline std::size_t CommandContextPool<TContext>::GetCreatedCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_CreatedCount;
+    }
+
+    template <class TContext>
+    inline std::size_t CommandContextPool<TContext>::GetAvailableCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Available.size();
+    }
+
+    template <class TContext>
+    inline std::size_t CommandContextPool<TContext>::GetPendingCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Pending.size();
+    }
+
+    template <class TContext>
+    void CommandContextPool<TContext>::RecycleCompleted() {
+        if (m_Pending.empty()) {
+            return;
+        }
+
+        // Only query the timeline when the oldest pending context is not known to be done.
+        if (m_Pending.top().FenceValue > m_KnownCompletedValue) {
+            m_KnownCompletedValue = m_Timeline.GetCompletedValue();
+        }
+
+        while (!m_Pending.empty() && m_Pending.top().FenceValue <= m_KnownCompletedValue) {
+            // top() is const, the context is moved out right before being popped.
+            m_Available.push_back(std::move(const_cast<PendingContext&>(m_Pending.top()).Context));
+            m_Pending.pop();
+        }
+    }
+
+    template <class TContext>
+    inline bool CommandContextPool<TContext>::PendingContext::operator<(const PendingContext& other) const {
+        return FenceValue > other.FenceValue;
+    }
+}
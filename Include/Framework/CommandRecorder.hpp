@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_COMMANDRECORDER_HPP
+#define D3D12TESTS_COMMANDRECORDER_HPP
+
+#include "Framework/GraphicsCommandList.hpp"
+
+#include <array>
+
+namespace D3D12Tests {
+    // Once the root arguments are flushed, RecordedCalls is ForwardedCalls + FilteredCalls +
+    // CoalescedCalls.
+    struct CommandRecorderStatistics {
+        UInt64 RecordedCalls = 0;
+        UInt64 ForwardedCalls = 0;
+        // Calls setting the state already bound, dropped.
+        UInt64 FilteredCalls = 0;
+        // Root argument calls merged into other calls, or overwritten before any draw.
+        UInt64 CoalescedCalls = 0;
+    };
+
+    // Records into a command list through a shadow of the bound state. Calls setting the bound
+    // state again are dropped; vertex buffers only forward the slots that changed. Root
+    // arguments are deferred until the next draw, so that a table or a constant set many times
+    // is forwarded once and the constants of a parameter go in as few calls as possible.
+    class CommandRecorder {
+    public:
+        explicit CommandRecorder(GraphicsCommandList& commandList);
+        ~CommandRecorder() = default;
+
+        CommandRecorder(const CommandRecorder&) = delete;
+        CommandRecorder(CommandRecorder&&) = delete;
+
+        CommandRecorder& operator=(const CommandRecorder&) = delete;
+        CommandRecorder& operator=(CommandRecorder&&) = delete;
+
+        // Forgets the bound state and drops the pending root arguments, once the command list
+        // has been reset: the next call of each kind is forwarded.
+        void Reset();
+
+        void SetPipelineState(ID3D12PipelineState* pPipelineState);
+        // A new root signature drops the root arguments, the same one keeps them.
+        void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature);
+        // New heaps drop the descriptor tables.
+        void SetDescriptorHeaps(std::span<ID3D12DescriptorHeap* const> heaps);
+        void SetGraphicsRootDescriptorTable(UInt32 rootParameter, UInt64 baseDescriptor);
+        void SetGraphicsRoot32BitConstants(UInt32 rootParameter, std::span<const UInt32> values, UInt32 destOffset);
+        inline void SetGraphicsRoot32BitConstant(UInt32 rootParameter, UInt32 value, UInt32 destOffset);
+        void SetGraphicsRootConstantBufferView(UInt32 rootParameter, UInt64 bufferLocation);
+        void RSSetViewports(std::span<const Viewport> viewports);
+        void RSSetScissorRects(std::span<const ScissorRect> rects);
+        void IASetPrimitiveTopology(PrimitiveTopology topology);
+        void IASetVertexBuffers(UInt32 startSlot, std::span<const VertexBufferView> views);
+        void IASetIndexBuffer(const IndexBufferView* pView);
+        void DrawInstanced(UInt32 vertexCountPerInstance, UInt32 instanceCount, UInt32 startVertexLocation,
+                           UInt32 startInstanceLocation);
+        void DrawIndexedInstanced(UInt32 indexCountPerInstance, UInt32 instanceCount, UInt32 startIndexLocation,
+                                  Int32 baseVertexLocation, UInt32 startInstanceLocation);
+
+        // Forwards the pending root arguments, done by the draws. Needed before recording
+        // directly into the command list, e.g. a dispatch reading them.
+        void FlushRootArguments();
+
+        inline const CommandRecorderStatistics& GetStatistics() const;
+        inline void ResetStatistics();
+        inline GraphicsCommandList& GetCommandList() const;
+
+    private:
+        void DropRootArguments();
+
+        GraphicsCommandList& m_CommandList;
+        CommandRecorderStatistics m_Statistics;
+
+        // One bit per GraphicsCommand whose state is known.
+        UInt32 m_KnownState = 0;
+        ID3D12PipelineState* m_pPipelineState = nullptr;
+        ID3D12RootSignature* m_pRootSignature = nullptr;
+        std::array<ID3D12DescriptorHeap*, MaxDescriptorHeaps> m_DescriptorHeaps = {};
+        UInt32 m_DescriptorHeapCount = 0;
+        std::array<Viewport, MaxViewports> m_Viewports = {};
+        UInt32 m_ViewportCount = 0;
+        std::array<ScissorRect, MaxViewports> m_ScissorRects = {};
+        UInt32 m_ScissorRectCount = 0;
+        PrimitiveTopology m_PrimitiveTopology = PrimitiveTopology::Undefined;
+        std::array<VertexBufferView, MaxVertexBuffers> m_VertexBuffers = {};
+        UInt64 m_KnownVertexBuffers = 0;
+        IndexBufferView m_IndexBuffer;
+        bool m_HasIndexBuffer = false;
+
+        // Root arguments, bound or pending: one bit per parameter, or per constant of a
+        // parameter. The dirty ones are pending.
+        std::array<UInt64, MaxRootParameters> m_RootDescriptors = {};
+        UInt64 m_KnownTables = 0;
+        UInt64 m_KnownConstantBuffers = 0;
+        UInt64 m_DirtyTables = 0;
+        UInt64 m_DirtyConstantBuffers = 0;
+        std::array<std::array<UInt32, MaxRootConstants>, MaxRootParameters> m_RootConstants = {};
+        std::array<UInt64, MaxRootParameters> m_KnownConstants = {};
+        std::array<UInt64, MaxRootParameters> m_DirtyConstants = {};
+        UInt64 m_DirtyConstantParameters = 0;
+        UInt64 m_PendingRootCalls = 0;
+    };
+}
+
+#include "Framework/CommandRecorder.inl"
+
+#endif // D3D12TESTS_COMMANDRECORDER_HPP
@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void CommandRecorder::SetGraphicsRoot32BitConstant(const UInt32 rootParameter, const UInt32 value,
+                                                              const UInt32 destOffset) {
+        SetGraphicsRoot32BitConstants(rootParameter, std::span(&value, 1), destOffset);
+    }
+
+    inline const CommandRecorderStatistics& CommandRecorder::GetStatistics() const {
+        return m_Statistics;
+    }
+
+    inline void CommandRecorder::ResetStatistics() {
+        // The pending root arguments are counted when flushed, so they move to the new counts.
+        m_Statistics = {};
+        m_Statistics.RecordedCalls = m_PendingRootCalls;
+    }
+
+    inline GraphicsCommandList& CommandRecorder::GetCommandList() const {
+        return m_CommandList;
+    }
+}
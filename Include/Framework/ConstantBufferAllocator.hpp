@@ -0,0 +1,136 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_CONSTANTBUFFERALLOCATOR_HPP
+#define D3D12TESTS_CONSTANTBUFFERALLOCATOR_HPP
+
+#include "Framework/Alignment.hpp"
+#include "Framework/GpuTimeline.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace D3D12Tests {
+    struct ConstantAllocation {
+        std::byte* CpuAddress;
+        UInt64 GpuAddress;
+        // Rounded up by CalculateConstantBufferByteSize, for the view.
+        UInt64 Size;
+    };
+
+    // Pool of fixed-size constant buffer pages carved out of one persistently mapped buffer,
+    // shared by the recording threads, each allocating from its own page through a
+    // ConstantBufferContext. A page is retired with the next value signaled on the timeline
+    // and recycled once that value has completed, so like an UploadRing allocation, its
+    // constants stay valid until then. Acquiring and retiring pages is lock-free; only
+    // running out of free pages takes a lock, to recycle the retired pages, waiting for the
+    // oldest ones if needed.
+    class ConstantBufferAllocator {
+    public:
+        static constexpr UInt64 DefaultPageSize = 64 * 1024;
+        // The sizes of the views are 32-bit.
+        static constexpr UInt64 MaxPageSize = UInt64(1) << 31;
+        static constexpr UInt32 InvalidPage = 0xffffffff;
+
+        // The page size must be a multiple of 256 bytes up to MaxPageSize, and the GPU base
+        // address 256-byte aligned. Throws std::invalid_argument otherwise, or when the
+        // capacity holds no page.
+        ConstantBufferAllocator(GpuTimeline& timeline, std::byte* cpuBase, UInt64 gpuBase, UInt64 capacity,
+                                UInt64 pageSize = DefaultPageSize);
+        ~ConstantBufferAllocator() = default;
+
+        ConstantBufferAllocator(const ConstantBufferAllocator&) = delete;
+        ConstantBufferAllocator(ConstantBufferAllocator&&) = delete;
+
+        ConstantBufferAllocator& operator=(const ConstantBufferAllocator&) = delete;
+        ConstantBufferAllocator& operator=(ConstantBufferAllocator&&) = delete;
+
+        // Thread-safe. Throws std::length_error when every page is in use or holds constants
+        // of work not submitted yet.
+        UInt32 AcquirePage();
+        // Thread-safe. The page must not be written anymore.
+        void RetirePage(UInt32 page);
+
+        inline std::byte* GetPageCpuAddress(UInt32 page) const;
+        inline UInt64 GetPageGpuAddress(UInt32 page) const;
+        inline UInt64 GetPageSize() const;
+        inline UInt32 GetPageCount() const;
+        // Exact once the threads are done acquiring and retiring pages.
+        inline UInt32 GetFreePageCount() const;
+        inline UInt32 GetRetiredPageCount() const;
+        inline UInt64 GetWaitCount() const;
+
+    private:
+        struct Page {
+            std::atomic<UInt32> Next = 0;
+            // Guards the page once retired.
+            UInt64 FenceValue = 0;
+        };
+
+        UInt32 RecyclePages(UInt64 fenceValue);
+
+        // Lock-free stacks of pages linked through Page::Next, the top page in the low 32 bits
+        // of the head and a count of its updates in the high ones against ABA.
+        UInt32 PopPage(std::atomic<UInt64>& stack);
+        void PushPages(std::atomic<UInt64>& stack, UInt32 firstPage, UInt32 lastPage);
+        UInt32 TakePages(std::atomic<UInt64>& stack);
+
+        GpuTimeline& m_Timeline;
+        std::byte* m_CpuBase;
+        UInt64 m_GpuBase;
+        UInt64 m_PageSize;
+        UInt32 m_PageCount;
+        std::unique_ptr<Page[]> m_Pages;
+
+        alignas(64) std::atomic<UInt64> m_FreePages;
+        alignas(64) std::atomic<UInt64> m_RetiredPages;
+        std::atomic<UInt32> m_FreePageCount;
+        std::atomic<UInt32> m_RetiredPageCount;
+        std::atomic<UInt64> m_WaitCount;
+        std::mutex m_RecycleMutex;
+    };
+
+    // Bump-allocates 256-byte aligned constants in a page of a ConstantBufferAllocator, one
+    // per recording thread: it is not thread-safe, so allocating takes no atomic operation
+    // but when a page is full. The page is retired when full, on Retire and on destruction.
+    class ConstantBufferContext {
+    public:
+        explicit ConstantBufferContext(ConstantBufferAllocator& allocator);
+        ~ConstantBufferContext();
+
+        ConstantBufferContext(const ConstantBufferContext&) = delete;
+        ConstantBufferContext(ConstantBufferContext&&) = delete;
+
+        ConstantBufferContext& operator=(const ConstantBufferContext&) = delete;
+        ConstantBufferContext& operator=(ConstantBufferContext&&) = delete;
+
+        // Throws std::length_error for a size larger than a page, or when the allocator is
+        // out of pages.
+        inline ConstantAllocation Allocate(UInt64 size);
+        // Allocates and copies the given data.
+        inline ConstantAllocation Upload(const void* pData, UInt64 size);
+
+        // Retires the current page, e.g. once the command list using it is closed, so that
+        // it does not stay out of the pool while the context is idle.
+        void Retire();
+
+        inline ConstantBufferAllocator& GetAllocator() const;
+
+    private:
+        void NextPage();
+
+        ConstantBufferAllocator& m_Allocator;
+        std::byte* m_CpuAddress;
+        UInt64 m_GpuAddress;
+        UInt64 m_Offset;
+        UInt32 m_Page;
+    };
+}
+
+#include "Framework/ConstantBufferAllocator.inl"
+
+#endif // D3D12TESTS_CONSTANTBUFFERALLOCATOR_HPP
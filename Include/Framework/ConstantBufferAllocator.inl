@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline std::byte* ConstantBufferAllocator::GetPageCpuAddress(const UInt32 page) const {
+        return m_CpuBase + page * m_PageSize;
+    }
+
+    inline UInt64 ConstantBufferAllocator::GetPageGpuAddress(const UInt32 page) const {
+        return m_GpuBase + page * m_PageSize;
+    }
+
+    inline UInt64 ConstantBufferAllocator::GetPageSize() const {
+        return m_PageSize;
+    }
+
+    inline UInt32 ConstantBufferAllocator::GetPageCount() const {
+        return m_PageCount;
+    }
+
+    inline UInt32 ConstantBufferAllocator::GetFreePageCount() const {
+        return m_FreePageCount.load(std::memory_order_relaxed);
+    }
+
+    inline UInt32 ConstantBufferAllocator::GetRetiredPageCount() const {
+        return m_RetiredPageCount.load(std::memory_order_relaxed);
+    }
+
+    inline UInt64 ConstantBufferAllocator::GetWaitCount() const {
+        return m_WaitCount.load(std::memory_order_relaxed);
+    }
+
+    inline ConstantAllocation ConstantBufferContext::Allocate(const UInt64 size) {
+        if (size > m_Allocator.GetPageSize()) {
+            throw std::length_error("The constants do not fit in a page.");
+        }
+
+        const UInt64 alignedSize = CalculateConstantBufferByteSize(static_cast<UInt32>(std::max<UInt64>(size, 1)));
+        if (m_Offset + alignedSize > m_Allocator.GetPageSize()) {
+            NextPage();
+        }
+
+        const ConstantAllocation allocation = {m_CpuAddress + m_Offset, m_GpuAddress + m_Offset, alignedSize};
+        m_Offset += alignedSize;
+
+        return allocation;
+    }
+
+    inline ConstantAllocation ConstantBufferContext::Upload(const void* pData, const UInt64 size) {
+        const ConstantAllocation allocation = Allocate(size);
+        std::memcpy(allocation.CpuAddress, pData, size);
+
+        return allocation;
+    }
+
+    inline ConstantBufferAllocator& ConstantBufferContext::GetAllocator() const {
+        return m_Allocator;
+    }
+}
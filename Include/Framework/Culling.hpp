@@ -0,0 +1,129 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_CULLING_HPP
+#define D3D12TESTS_CULLING_HPP
+
+#include "Framework/Simd.hpp"
+
+#include <limits>
+#include <span>
+#include <vector>
+
+#ifdef _WIN32
+#include <DirectXMath.h>
+#endif
+
+namespace D3D12Tests {
+    struct CullingOptions {
+        // Lowered to the level supported by the CPU. The levels agree except, through rounding,
+        // on objects touching a plane or a distance limit.
+        SimdLevel MaxSimdLevel = SimdLevel::AVX2;
+        // Zero uses one thread per hardware thread. Objects are split between the threads.
+        UInt32 ThreadCount = 0;
+        UInt64 MinObjectsPerThread = 256 * 1024;
+    };
+
+    // Six planes ax + by + cz + d >= 0 on the inside, normalized: left, right, bottom, top,
+    // near and far. The objects are also culled past MaxDistance from Origin, and within
+    // MinDistance of it, like the ranges of levels of detail.
+    struct CullingFrustum {
+        Float32 Planes[6][4] = {};
+        Float32 Origin[3] = {};
+        Float32 MinDistance = 0.0f;
+        Float32 MaxDistance = std::numeric_limits<Float32>::infinity();
+    };
+
+    // The planes of a view-projection matrix in the DirectXMath convention: row vectors, so
+    // that clip = position * viewProjection, and 0 <= z <= w in clip space.
+    inline CullingFrustum MakeCullingFrustum(const Float32 (&viewProjection)[4][4], const Float32 (&origin)[3],
+                                             Float32 maxDistance = std::numeric_limits<Float32>::infinity(),
+                                             Float32 minDistance = 0.0f);
+#ifdef _WIN32
+    inline CullingFrustum MakeCullingFrustum(const DirectX::XMFLOAT4X4& viewProjection, const DirectX::XMFLOAT3& origin,
+                                             Float32 maxDistance = std::numeric_limits<Float32>::infinity(),
+                                             Float32 minDistance = 0.0f);
+#endif
+
+    // Bounding spheres in structure of arrays, one array per component, indexed by object.
+    class BoundingSphereSet {
+    public:
+        BoundingSphereSet() = default;
+        ~BoundingSphereSet() = default;
+
+        BoundingSphereSet(const BoundingSphereSet&) = default;
+        BoundingSphereSet(BoundingSphereSet&&) noexcept = default;
+
+        BoundingSphereSet& operator=(const BoundingSphereSet&) = default;
+        BoundingSphereSet& operator=(BoundingSphereSet&&) noexcept = default;
+
+        // Returns the index of the sphere.
+        inline UInt32 Add(const Float32 (&center)[3], Float32 radius);
+        inline void Set(UInt32 index, const Float32 (&center)[3], Float32 radius);
+        inline void Reserve(UInt32 count);
+        inline void Clear();
+
+        inline UInt32 GetCount() const;
+        inline const Float32* GetCenterX() const;
+        inline const Float32* GetCenterY() const;
+        inline const Float32* GetCenterZ() const;
+        inline const Float32* GetRadii() const;
+
+    private:
+        std::vector<Float32> m_CenterX;
+        std::vector<Float32> m_CenterY;
+        std::vector<Float32> m_CenterZ;
+        std::vector<Float32> m_Radii;
+    };
+
+    // Axis-aligned boxes in structure of arrays, as centers and half extents.
+    class BoundingBoxSet {
+    public:
+        BoundingBoxSet() = default;
+        ~BoundingBoxSet() = default;
+
+        BoundingBoxSet(const BoundingBoxSet&) = default;
+        BoundingBoxSet(BoundingBoxSet&&) noexcept = default;
+
+        BoundingBoxSet& operator=(const BoundingBoxSet&) = default;
+        BoundingBoxSet& operator=(BoundingBoxSet&&) noexcept = default;
+
+        // Returns the index of the box.
+        inline UInt32 Add(const Float32 (&center)[3], const Float32 (&extent)[3]);
+        inline void Set(UInt32 index, const Float32 (&center)[3], const Float32 (&extent)[3]);
+        inline void Reserve(UInt32 count);
+        inline void Clear();
+
+        inline UInt32 GetCount() const;
+        inline const Float32* GetCenterX() const;
+        inline const Float32* GetCenterY() const;
+        inline const Float32* GetCenterZ() const;
+        inline const Float32* GetExtentX() const;
+        inline const Float32* GetExtentY() const;
+        inline const Float32* GetExtentZ() const;
+
+    private:
+        std::vector<Float32> m_CenterX;
+        std::vector<Float32> m_CenterY;
+        std::vector<Float32> m_CenterZ;
+        std::vector<Float32> m_ExtentX;
+        std::vector<Float32> m_ExtentY;
+        std::vector<Float32> m_ExtentZ;
+    };
+
+    // Writes the indices of the objects intersecting the frustum within the distance limits, in
+    // increasing order, and returns their count. The test is conservative: objects outside of
+    // the frustum but crossing the planes of two of its faces near a corner are kept. Throws
+    // std::invalid_argument if visible is smaller than the set.
+    UInt32 CullSpheres(const BoundingSphereSet& spheres, const CullingFrustum& frustum, std::span<UInt32> visible,
+                       const CullingOptions& options = {});
+    UInt32 CullBoxes(const BoundingBoxSet& boxes, const CullingFrustum& frustum, std::span<UInt32> visible,
+                     const CullingOptions& options = {});
+}
+
+#include "Framework/Culling.inl"
+
+#endif // D3D12TESTS_CULLING_HPP
@@ -0,0 +1,165 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <cmath>
+
+namespace D3D12Tests {
+    inline CullingFrustum MakeCullingFrustum(const Float32 (&viewProjection)[4][4], const Float32 (&origin)[3],
+                                             const Float32 maxDistance, const Float32 minDistance) {
+        // Gribb and Hartmann: with row vectors, clip.x is the dot product of the position with
+        // the first column, and so on. Inside, -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+        CullingFrustum frustum;
+        for (UInt32 row = 0; row < 4; ++row) {
+            const Float32 (&m)[4] = viewProjection[row];
+            frustum.Planes[0][row] = m[3] + m[0];
+            frustum.Planes[1][row] = m[3] - m[0];
+            frustum.Planes[2][row] = m[3] + m[1];
+            frustum.Planes[3][row] = m[3] - m[1];
+            frustum.Planes[4][row] = m[2];
+            frustum.Planes[5][row] = m[3] - m[2];
+        }
+
+        for (Float32 (&plane)[4] : frustum.Planes) {
+            const Float32 length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (Float32& coefficient : plane) {
+                    coefficient /= length;
+                }
+            }
+        }
+
+        for (UInt32 axis = 0; axis < 3; ++axis) {
+            frustum.Origin[axis] = origin[axis];
+        }
+        frustum.MinDistance = minDistance;
+        frustum.MaxDistance = maxDistance;
+
+        return frustum;
+    }
+
+#ifdef _WIN32
+    inline CullingFrustum MakeCullingFrustum(const DirectX::XMFLOAT4X4& viewProjection, const DirectX::XMFLOAT3& origin,
+                                             const Float32 maxDistance, const Float32 minDistance) {
+        return MakeCullingFrustum(viewProjection.m, {origin.x, origin.y, origin.z}, maxDistance, minDistance);
+    }
+#endif
+
+    inline UInt32 BoundingSphereSet::Add(const Float32 (&center)[3], const Float32 radius) {
+        m_CenterX.push_back(center[0]);
+        m_CenterY.push_back(center[1]);
+        m_CenterZ.push_back(center[2]);
+        m_Radii.push_back(radius);
+
+        return static_cast<UInt32>(m_Radii.size() - 1);
+    }
+
+    inline void BoundingSphereSet::Set(const UInt32 index, const Float32 (&center)[3], const Float32 radius) {
+        m_CenterX[index] = center[0];
+        m_CenterY[index] = center[1];
+        m_CenterZ[index] = center[2];
+        m_Radii[index] = radius;
+    }
+
+    inline void BoundingSphereSet::Reserve(const UInt32 count) {
+        m_CenterX.reserve(count);
+        m_CenterY.reserve(count);
+        m_CenterZ.reserve(count);
+        m_Radii.reserve(count);
+    }
+
+    inline void BoundingSphereSet::Clear() {
+        m_CenterX.clear();
+        m_CenterY.clear();
+        m_CenterZ.clear();
+        m_Radii.clear();
+    }
+
+    inline UInt32 BoundingSphereSet::GetCount() const {
+        return static_cast<UInt32>(m_Radii.size());
+    }
+
+    inline const Float32* BoundingSphereSet::GetCenterX() const {
+        return m_CenterX.data();
+    }
+
+    inline const Float32* BoundingSphereSet::GetCenterY() const {
+        return m_CenterY.data();
+    }
+
+    inline const Float32* BoundingSphereSet::GetCenterZ() const {
+        return m_CenterZ.data();
+    }
+
+    inline const Float32* BoundingSphereSet::GetRadii() const {
+        return m_Radii.data();
+    }
+
+    inline UInt32 BoundingBoxSet::Add(const Float32 (&center)[3], const Float32 (&extent)[3]) {
+        m_CenterX.push_back(center[0]);
+        m_CenterY.push_back(center[1]);
+        m_CenterZ.push_back(center[2]);
+        m_ExtentX.push_back(extent[0]);
+        m_ExtentY.push_back(extent[1]);
+        m_ExtentZ.push_back(extent[2]);
+
+        return static_cast<UInt32>(m_CenterX.size() - 1);
+    }
+
+    inline void BoundingBoxSet::Set(const UInt32 index, const Float32 (&center)[3], const Float32 (&extent)[3]) {
+        m_CenterX[index] = center[0];
+        m_CenterY[index] = center[1];
+        m_CenterZ[index] = center[2];
+        m_ExtentX[index] = extent[0];
+        m_ExtentY[index] = extent[1];
+        m_ExtentZ[index] = extent[2];
+    }
+
+    inline void BoundingBoxSet::Reserve(const UInt32 count) {
+        m_CenterX.reserve(count);
+        m_CenterY.reserve(count);
+        m_CenterZ.reserve(count);
+        m_ExtentX.reserve(count);
+        m_ExtentY.reserve(count);
+        m_ExtentZ.reserve(count);
+    }
+
+    inline void BoundingBoxSet::Clear() {
+        m_CenterX.clear();
+        m_CenterY.clear();
+        m_CenterZ.clear();
+        m_ExtentX.clear();
+        m_ExtentY.clear();
+        m_ExtentZ.clear();
+    }
+
+    inline UInt32 BoundingBoxSet::GetCount() const {
+        return static_cast<UInt32>(m_CenterX.size());
+    }
+
+    inline const Float32* BoundingBoxSet::GetCenterX() const {
+        return m_CenterX.data();
+    }
+
+    inline const Float32* BoundingBoxSet::GetCenterY() const {
+        return m_CenterY.data();
+    }
+
+    inline const Float32* BoundingBoxSet::GetCenterZ() const {
+        return m_CenterZ.data();
+    }
+
+    inline const Float32* BoundingBoxSet::GetExtentX() const {
+        return m_ExtentX.data();
+    }
+
+    inline const Float32* BoundingBoxSet::GetExtentY() const {
+        return m_ExtentY.data();
+    }
+
+    inline const Float32* BoundingBoxSet::GetExtentZ() const {
+        return m_ExtentZ.data();
+    }
+}
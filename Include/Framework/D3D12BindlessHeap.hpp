@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12BINDLESSHEAP_HPP
+#define D3D12TESTS_D3D12BINDLESSHEAP_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/BindlessRegistry.hpp"
+
+namespace D3D12Tests {
+    // Shader-visible CBV/SRV/UAV heap bound once as a single table, whose slots are handed
+    // out by a BindlessRegistry. Shaders index the table with the index of the handle, given
+    // e.g. as a root constant, instead of binding a table per draw.
+    class D3D12BindlessHeap {
+    public:
+        // The table holds an unbounded SRV range and an unbounded UAV range over the whole
+        // heap, in their own register spaces, e.g. Texture2D g_Textures[] : register(t0, space1).
+        static constexpr UInt32 SrvRegisterSpace = 1;
+        static constexpr UInt32 UavRegisterSpace = 2;
+        static constexpr UInt32 DescriptorRangeCount = 2;
+
+        // The capacity is at most MaxBindlessSlots; below resource binding tier 3, shader-visible
+        // heaps are limited to 1000000 descriptors.
+        D3D12BindlessHeap(ID3D12Device* pDevice, GpuTimeline& timeline, UInt32 capacity);
+        ~D3D12BindlessHeap() = default;
+
+        D3D12BindlessHeap(const D3D12BindlessHeap&) = delete;
+        D3D12BindlessHeap(D3D12BindlessHeap&&) = delete;
+
+        D3D12BindlessHeap& operator=(const D3D12BindlessHeap&) = delete;
+        D3D12BindlessHeap& operator=(D3D12BindlessHeap&&) = delete;
+
+        // Copies a staged descriptor (e.g. from a D3D12DescriptorHeap) to a new slot.
+        BindlessHandle Register(D3D12_CPU_DESCRIPTOR_HANDLE source);
+        // The slot is reused once the GPU is done with the frames submitted so far.
+        void Free(BindlessHandle handle);
+
+        // The ranges of the root signature table, set at GetGpuStart().
+        static void InitDescriptorRanges(CD3DX12_DESCRIPTOR_RANGE1 (&ranges)[DescriptorRangeCount]);
+
+        inline UInt32 Resolve(BindlessHandle handle) const;
+        inline D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(BindlessHandle handle) const;
+        inline D3D12_GPU_DESCRIPTOR_HANDLE GetGpuStart() const;
+
+        inline ID3D12DescriptorHeap* GetHeap() const;
+        inline const BindlessRegistry& GetRegistry() const;
+
+    private:
+        ComPtr<ID3D12Device> m_Device;
+        ComPtr<ID3D12DescriptorHeap> m_Heap;
+        BindlessRegistry m_Registry;
+        D3D12_CPU_DESCRIPTOR_HANDLE m_CpuStart;
+        D3D12_GPU_DESCRIPTOR_HANDLE m_GpuStart;
+        UInt32 m_DescriptorSize;
+    };
+}
+
+#include "Framework/D3D12BindlessHeap.inl"
+
+#endif // D3D12TESTS_D3D12BINDLESSHEAP_HPP
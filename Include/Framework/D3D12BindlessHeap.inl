@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt32 D3D12BindlessHeap::Resolve(const BindlessHandle handle) const {
+        return m_Registry.Resolve(handle);
+    }
+
+    inline D3D12_CPU_DESCRIPTOR_HANDLE D3D12BindlessHeap::GetCpuHandle(const BindlessHandle handle) const {
+        return CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CpuStart, static_cast<INT>(m_Registry.Resolve(handle)), m_DescriptorSize);
+    }
+
+    inline D3D12_GPU_DESCRIPTOR_HANDLE D3D12BindlessHeap::GetGpuStart() const {
+        return m_GpuStart;
+    }
+
+    inline ID3D12DescriptorHeap* D3D12BindlessHeap::GetHeap() const {
+        return m_Heap.Get();
+    }
+
+    inline const BindlessRegistry& D3D12BindlessHeap::GetRegistry() const {
+        return m_Registry;
+    }
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12COMMANDCONTEXTPOOL_HPP
+#define D3D12TESTS_D3D12COMMANDCONTEXTPOOL_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/CommandContextPool.hpp"
+
+namespace D3D12Tests {
+    struct D3D12CommandContext {
+        ComPtr<ID3D12CommandAllocator> CommandAllocator;
+        ComPtr<ID3D12GraphicsCommandList> CommandList;
+    };
+
+    // CommandContextPool of allocator and command list pairs. Acquired contexts are
+    // reset and ready for recording; they can be acquired from any thread.
+    class D3D12CommandContextPool {
+    public:
+        D3D12CommandContextPool(ID3D12Device* pDevice, GpuTimeline& timeline, D3D12_COMMAND_LIST_TYPE type);
+        ~D3D12CommandContextPool() = default;
+
+        D3D12CommandContextPool(const D3D12CommandContextPool&) = delete;
+        D3D12CommandContextPool(D3D12CommandContextPool&&) = delete;
+
+        D3D12CommandContextPool& operator=(const D3D12CommandContextPool&) = delete;
+        D3D12CommandContextPool& operator=(D3D12CommandContextPool&&) = delete;
+
+        D3D12CommandContext Acquire(ID3D12PipelineState* pInitialState = nullptr);
+        // The fence value must be signaled after the submission of the context's command list.
+        inline void Release(D3D12CommandContext context, UInt64 fenceValue);
+
+        inline std::size_t GetCreatedCount() const;
+
+    private:
+        D3D12CommandContext CreateContext() const;
+
+        ComPtr<ID3D12Device> m_Device;
+        D3D12_COMMAND_LIST_TYPE m_Type;
+        CommandContextPool<D3D12CommandContext> m_Pool;
+    };
+}
+
+#include "Framework/D3D12CommandContextPool.inl"
+
+#endif // D3D12TESTS_D3D12COMMANDCONTEXTPOOL_HPP
@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void D3D12CommandContextPool::Release(D3D12CommandContext context, const UInt64 fenceValue) {
+        m_Pool.Release(std::move(context), fenceValue);
+    }
+
+    inline std::size_t D3D12CommandContextPool::GetCreatedCount() const {
+        return m_Pool.GetCreatedCount();
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12CONSTANTBUFFERALLOCATOR_HPP
+#define D3D12TESTS_D3D12CONSTANTBUFFERALLOCATOR_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/ConstantBufferAllocator.hpp"
+
+namespace D3D12Tests {
+    // ConstantBufferAllocator over a committed UPLOAD heap buffer that stays mapped for its
+    // whole lifetime, for the ConstantBufferContexts of the recording threads. The GPU
+    // addresses they return go to SetGraphicsRootConstantBufferView, or with their size to a
+    // CBV.
+    class D3D12ConstantBufferAllocator {
+    public:
+        D3D12ConstantBufferAllocator(ID3D12Device* pDevice, GpuTimeline& timeline, UInt64 capacity,
+                                     UInt64 pageSize = ConstantBufferAllocator::DefaultPageSize);
+        ~D3D12ConstantBufferAllocator();
+
+        D3D12ConstantBufferAllocator(const D3D12ConstantBufferAllocator&) = delete;
+        D3D12ConstantBufferAllocator(D3D12ConstantBufferAllocator&&) = delete;
+
+        D3D12ConstantBufferAllocator& operator=(const D3D12ConstantBufferAllocator&) = delete;
+        D3D12ConstantBufferAllocator& operator=(D3D12ConstantBufferAllocator&&) = delete;
+
+        inline ID3D12Resource* GetResource() const;
+        inline ConstantBufferAllocator& GetAllocator();
+
+    private:
+        static ComPtr<ID3D12Resource> CreateBuffer(ID3D12Device* pDevice, UInt64 capacity);
+        static std::byte* MapBuffer(ID3D12Resource* pBuffer);
+
+        ComPtr<ID3D12Resource> m_Buffer;
+        ConstantBufferAllocator m_Allocator;
+    };
+}
+
+#include "Framework/D3D12ConstantBufferAllocator.inl"
+
+#endif // D3D12TESTS_D3D12CONSTANTBUFFERALLOCATOR_HPP
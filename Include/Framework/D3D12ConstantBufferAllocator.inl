@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline ID3D12Resource* D3D12ConstantBufferAllocator::GetResource() const {
+        return m_Buffer.Get();
+    }
+
+    inline ConstantBufferAllocator& D3D12ConstantBufferAllocator::GetAllocator() {
+        return m_Allocator;
+    }
+}
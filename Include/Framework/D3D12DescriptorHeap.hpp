@@ -0,0 +1,57 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12DESCRIPTORHEAP_HPP
+#define D3D12TESTS_D3D12DESCRIPTORHEAP_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/RangeAllocator.hpp"
+
+namespace D3D12Tests {
+    struct D3D12DescriptorRange {
+        D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle;
+        UInt32 Index;
+        UInt32 Count;
+    };
+
+    // CPU-only (non shader-visible) descriptor heap used to create and keep views.
+    // Descriptors are copied to a D3D12DescriptorRing when they need to be bound.
+    class D3D12DescriptorHeap {
+    public:
+        D3D12DescriptorHeap(ID3D12Device* pDevice, D3D12_DESCRIPTOR_HEAP_TYPE type, UInt32 capacity);
+        ~D3D12DescriptorHeap() = default;
+
+        D3D12DescriptorHeap(const D3D12DescriptorHeap&) = delete;
+        D3D12DescriptorHeap(D3D12DescriptorHeap&&) = delete;
+
+        D3D12DescriptorHeap& operator=(const D3D12DescriptorHeap&) = delete;
+        D3D12DescriptorHeap& operator=(D3D12DescriptorHeap&&) = delete;
+
+        // Throws std::length_error when the heap has no free range large enough.
+        D3D12DescriptorRange Allocate(UInt32 count = 1);
+        void Free(const D3D12DescriptorRange& range);
+
+        inline D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(const D3D12DescriptorRange& range, UInt32 offset = 0) const;
+
+        inline ID3D12DescriptorHeap* GetHeap() const;
+        inline D3D12_DESCRIPTOR_HEAP_TYPE GetType() const;
+        inline UInt32 GetDescriptorSize() const;
+        inline UInt32 GetFreeCount() const;
+
+    private:
+        ComPtr<ID3D12DescriptorHeap> m_Heap;
+        RangeAllocator m_Allocator;
+        D3D12_CPU_DESCRIPTOR_HANDLE m_CpuStart;
+        D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+        UInt32 m_DescriptorSize;
+    };
+}
+
+#include "Framework/D3D12DescriptorHeap.inl"
+
+#endif // D3D12TESTS_D3D12DESCRIPTORHEAP_HPP
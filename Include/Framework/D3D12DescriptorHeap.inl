@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline D3D12_CPU_DESCRIPTOR_HANDLE D3D12DescriptorHeap::GetCpuHandle(const D3D12DescriptorRange& range,
+                                                                         const UInt32 offset) const {
+        return CD3DX12_CPU_DESCRIPTOR_HANDLE(range.CpuHandle, static_cast<INT>(offset), m_DescriptorSize);
+    }
+
+    inline ID3D12DescriptorHeap* D3D12DescriptorHeap::GetHeap() const {
+        return m_Heap.Get();
+    }
+
+    inline D3D12_DESCRIPTOR_HEAP_TYPE D3D12DescriptorHeap::GetType() const {
+        return m_Type;
+    }
+
+    inline UInt32 D3D12DescriptorHeap::GetDescriptorSize() const {
+        return m_DescriptorSize;
+    }
+
+    inline UInt32 D3D12DescriptorHeap::GetFreeCount() const {
+        return m_Allocator.GetFreeCount();
+    }
+}
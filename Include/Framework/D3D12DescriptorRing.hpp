@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12DESCRIPTORRING_HPP
+#define D3D12TESTS_D3D12DESCRIPTORRING_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/D3D12DescriptorHeap.hpp"
+#include "Framework/TimelineRingAllocator.hpp"
+
+namespace D3D12Tests {
+    struct D3D12DescriptorTable {
+        D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle;
+        D3D12_GPU_DESCRIPTOR_HANDLE GpuHandle;
+        UInt32 Count;
+    };
+
+    // Shader-visible descriptor heap filled linearly with the tables bound each frame.
+    // Tables follow the TimelineRingAllocator rules: they are recycled once the next
+    // value signaled on the timeline has completed.
+    class D3D12DescriptorRing {
+    public:
+        D3D12DescriptorRing(ID3D12Device* pDevice, GpuTimeline& timeline, D3D12_DESCRIPTOR_HEAP_TYPE type,
+                            UInt32 capacity);
+        ~D3D12DescriptorRing() = default;
+
+        D3D12DescriptorRing(const D3D12DescriptorRing&) = delete;
+        D3D12DescriptorRing(D3D12DescriptorRing&&) = delete;
+
+        D3D12DescriptorRing& operator=(const D3D12DescriptorRing&) = delete;
+        D3D12DescriptorRing& operator=(D3D12DescriptorRing&&) = delete;
+
+        D3D12DescriptorTable Allocate(UInt32 count);
+
+        // Copies staged descriptors into a new table, either a contiguous range or one
+        // descriptor per source handle.
+        D3D12DescriptorTable CopyTable(const D3D12DescriptorRange& source);
+        D3D12DescriptorTable CopyTable(const D3D12_CPU_DESCRIPTOR_HANDLE* pSources, UInt32 count);
+
+        inline ID3D12DescriptorHeap* GetHeap() const;
+        inline UInt32 GetDescriptorSize() const;
+        inline UInt64 GetWaitCount() const;
+
+    private:
+        ComPtr<ID3D12Device> m_Device;
+        ComPtr<ID3D12DescriptorHeap> m_Heap;
+        TimelineRingAllocator m_Allocator;
+        D3D12_CPU_DESCRIPTOR_HANDLE m_CpuStart;
+        D3D12_GPU_DESCRIPTOR_HANDLE m_GpuStart;
+        D3D12_DESCRIPTOR_HEAP_TYPE m_Type;
+        UInt32 m_DescriptorSize;
+    };
+}
+
+#include "Framework/D3D12DescriptorRing.inl"
+
+#endif // D3D12TESTS_D3D12DESCRIPTORRING_HPP
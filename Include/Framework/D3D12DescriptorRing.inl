@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline ID3D12DescriptorHeap* D3D12DescriptorRing::GetHeap() const {
+        return m_Heap.Get();
+    }
+
+    inline UInt32 D3D12DescriptorRing::GetDescriptorSize() const {
+        return m_DescriptorSize;
+    }
+
+    inline UInt64 D3D12DescriptorRing::GetWaitCount() const {
+        return m_Allocator.GetWaitCount();
+    }
+}
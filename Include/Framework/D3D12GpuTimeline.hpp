@@ -0,0 +1,49 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12GPUTIMELINE_HPP
+#define D3D12TESTS_D3D12GPUTIMELINE_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/GpuTimeline.hpp"
+
+#include <mutex>
+
+namespace D3D12Tests {
+    // GpuTimeline backed by an ID3D12Fence signaled on a command queue.
+    class D3D12GpuTimeline final : public GpuTimeline {
+    public:
+        D3D12GpuTimeline(ID3D12Device* pDevice, ID3D12CommandQueue* pCommandQueue);
+        ~D3D12GpuTimeline() override;
+
+        D3D12GpuTimeline(const D3D12GpuTimeline&) = delete;
+        D3D12GpuTimeline(D3D12GpuTimeline&&) = delete;
+
+        D3D12GpuTimeline& operator=(const D3D12GpuTimeline&) = delete;
+        D3D12GpuTimeline& operator=(D3D12GpuTimeline&&) = delete;
+
+        UInt64 Signal() override;
+        UInt64 GetCompletedValue() override;
+        void WaitForValue(UInt64 value) override;
+
+        inline ID3D12Fence* GetFence() const;
+        inline ID3D12CommandQueue* GetCommandQueue() const;
+
+    private:
+        ComPtr<ID3D12CommandQueue> m_CommandQueue;
+        ComPtr<ID3D12Fence> m_Fence;
+        HANDLE m_FenceEvent;
+
+        // The fence event is shared, so only one thread may wait on it at a time.
+        std::mutex m_WaitMutex;
+    };
+}
+
+#include "Framework/D3D12GpuTimeline.inl"
+
+#endif // D3D12TESTS_D3D12GPUTIMELINE_HPP
@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline ID3D12Fence* D3D12GpuTimeline::GetFence() const {
+        return m_Fence.Get();
+    }
+
+    inline ID3D12CommandQueue* D3D12GpuTimeline::GetCommandQueue() const {
+        return m_CommandQueue.Get();
+    }
+}
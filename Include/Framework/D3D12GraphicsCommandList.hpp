@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12GRAPHICSCOMMANDLIST_HPP
+#define D3D12TESTS_D3D12GRAPHICSCOMMANDLIST_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/GraphicsCommandList.hpp"
+
+namespace D3D12Tests {
+    // GraphicsCommandList recording into an ID3D12GraphicsCommandList, e.g. the list of a
+    // command context, retargeted each frame. The list is not owned.
+    class D3D12GraphicsCommandList final : public GraphicsCommandList {
+    public:
+        explicit D3D12GraphicsCommandList(ID3D12GraphicsCommandList* pCommandList = nullptr);
+        ~D3D12GraphicsCommandList() override = default;
+
+        D3D12GraphicsCommandList(const D3D12GraphicsCommandList&) = delete;
+        D3D12GraphicsCommandList(D3D12GraphicsCommandList&&) = delete;
+
+        D3D12GraphicsCommandList& operator=(const D3D12GraphicsCommandList&) = delete;
+        D3D12GraphicsCommandList& operator=(D3D12GraphicsCommandList&&) = delete;
+
+        void SetPipelineState(ID3D12PipelineState* pPipelineState) override;
+        void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) override;
+        void SetDescriptorHeaps(std::span<ID3D12DescriptorHeap* const> heaps) override;
+        void SetGraphicsRootDescriptorTable(UInt32 rootParameter, UInt64 baseDescriptor) override;
+        void SetGraphicsRoot32BitConstants(UInt32 rootParameter, std::span<const UInt32> values, UInt32 destOffset) override;
+        void SetGraphicsRootConstantBufferView(UInt32 rootParameter, UInt64 bufferLocation) override;
+        void RSSetViewports(std::span<const Viewport> viewports) override;
+        void RSSetScissorRects(std::span<const ScissorRect> rects) override;
+        void IASetPrimitiveTopology(PrimitiveTopology topology) override;
+        void IASetVertexBuffers(UInt32 startSlot, std::span<const VertexBufferView> views) override;
+        void IASetIndexBuffer(const IndexBufferView* pView) override;
+        void DrawInstanced(UInt32 vertexCountPerInstance, UInt32 instanceCount, UInt32 startVertexLocation,
+                           UInt32 startInstanceLocation) override;
+        void DrawIndexedInstanced(UInt32 indexCountPerInstance, UInt32 instanceCount, UInt32 startIndexLocation,
+                                  Int32 baseVertexLocation, UInt32 startInstanceLocation) override;
+
+        // A CommandRecorder over this list must be reset along with the new list.
+        inline void SetCommandList(ID3D12GraphicsCommandList* pCommandList);
+        inline ID3D12GraphicsCommandList* GetCommandList() const;
+
+    private:
+        ID3D12GraphicsCommandList* m_pCommandList;
+    };
+}
+
+#include "Framework/D3D12GraphicsCommandList.inl"
+
+#endif // D3D12TESTS_D3D12GRAPHICSCOMMANDLIST_HPP
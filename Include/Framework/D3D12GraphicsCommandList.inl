@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void D3D12GraphicsCommandList::SetCommandList(ID3D12GraphicsCommandList* pCommandList) {
+        m_pCommandList = pCommandList;
+    }
+
+    inline ID3D12GraphicsCommandList* D3D12GraphicsCommandList::GetCommandList() const {
+        return m_pCommandList;
+    }
+}
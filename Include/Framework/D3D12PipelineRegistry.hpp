@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12PIPELINEREGISTRY_HPP
+#define D3D12TESTS_D3D12PIPELINEREGISTRY_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/PipelineRegistry.hpp"
+
+namespace D3D12Tests {
+    // PipelineRegistry of D3D12 graphics pipeline states. Root signatures cannot be read
+    // back from the device, they have to be registered with their serialized blob before
+    // being used; shaders are registered on first use, and kept so that the pipelines of the
+    // manifest can be created again without the original descriptions.
+    // Stream output and cached blobs are not supported.
+    class D3D12PipelineRegistry {
+    public:
+        explicit D3D12PipelineRegistry(ID3D12Device* pDevice);
+        ~D3D12PipelineRegistry() = default;
+
+        D3D12PipelineRegistry(const D3D12PipelineRegistry&) = delete;
+        D3D12PipelineRegistry(D3D12PipelineRegistry&&) = delete;
+
+        D3D12PipelineRegistry& operator=(const D3D12PipelineRegistry&) = delete;
+        D3D12PipelineRegistry& operator=(D3D12PipelineRegistry&&) = delete;
+
+        // Returns the hash identifying the root signature in the pipeline descriptions.
+        UInt64 RegisterRootSignature(ID3D12RootSignature* pRootSignature, const void* pSerialized, std::size_t size);
+        // Returns the hash identifying the bytecode, zero for an empty one.
+        UInt64 RegisterShader(const D3D12_SHADER_BYTECODE& bytecode);
+
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+        // Creates the manifest's pipelines whose root signature and shaders are registered.
+        std::size_t Prewarm();
+
+        inline bool LoadManifest(const std::filesystem::path& path);
+        inline void SaveManifest(const std::filesystem::path& path) const;
+
+        inline const PipelineRegistry<Microsoft::WRL::ComPtr<ID3D12PipelineState>>& GetRegistry() const;
+
+    private:
+        GraphicsPipelineDesc ToPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> CreatePipeline(const GraphicsPipelineDesc& desc);
+        bool IsCreatable(const GraphicsPipelineDesc& desc) const;
+        D3D12_SHADER_BYTECODE GetShader(UInt64 hash) const;
+
+        Microsoft::WRL::ComPtr<ID3D12Device> m_Device;
+
+        // Registrations happen while other threads may be creating pipelines.
+        mutable std::mutex m_Mutex;
+        std::unordered_map<UInt64, Microsoft::WRL::ComPtr<ID3D12RootSignature>> m_RootSignatures;
+        std::unordered_map<ID3D12RootSignature*, UInt64> m_RootSignatureHashes;
+        std::unordered_map<UInt64, std::vector<std::byte>> m_Shaders;
+
+        PipelineRegistry<Microsoft::WRL::ComPtr<ID3D12PipelineState>> m_Registry;
+    };
+}
+
+#include "Framework/D3D12PipelineRegistry.inl"
+
+#endif // D3D12TESTS_D3D12PIPELINEREGISTRY_HPP
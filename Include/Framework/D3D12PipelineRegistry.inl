@@ -0,0 +1,20 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline bool D3D12PipelineRegistry::LoadManifest(const std::filesystem::path& path) {
+        return m_Registry.LoadManifest(path);
+    }
+
+    inline void D3D12PipelineRegistry::SaveManifest(const std::filesystem::path& path) const {
+        m_Registry.SaveManifest(path);
+    }
+
+    inline const PipelineRegistry<Microsoft::WRL::ComPtr<ID3D12PipelineState>>&
+    D3D12PipelineRegistry::GetRegistry() const {
+        return m_Registry;
+    }
+}
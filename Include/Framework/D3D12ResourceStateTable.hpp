@@ -0,0 +1,57 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12RESOURCESTATETABLE_HPP
+#define D3D12TESTS_D3D12RESOURCESTATETABLE_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/ResourceStateTable.hpp"
+
+namespace D3D12Tests {
+    class D3D12ResourceStateTracker;
+
+    // ResourceStateTable of D3D12 resources. The table does not hold references, resources
+    // must be unregistered before they are released.
+    class D3D12ResourceStateTable {
+    public:
+        D3D12ResourceStateTable() = default;
+        ~D3D12ResourceStateTable() = default;
+
+        D3D12ResourceStateTable(const D3D12ResourceStateTable&) = delete;
+        D3D12ResourceStateTable(D3D12ResourceStateTable&&) = delete;
+
+        D3D12ResourceStateTable& operator=(const D3D12ResourceStateTable&) = delete;
+        D3D12ResourceStateTable& operator=(D3D12ResourceStateTable&&) = delete;
+
+        UInt32 Register(ID3D12Resource* pResource, D3D12_RESOURCE_STATES initialState);
+        void Unregister(UInt32 resource);
+
+        // Returns the barriers to record in a command list executed right before the one of
+        // the tracker. They are valid until the next call.
+        inline std::span<const ResourceBarrier> Resolve(const D3D12ResourceStateTracker& tracker);
+        // Records the barriers of the table's resources in a single call.
+        void RecordBarriers(ID3D12GraphicsCommandList* pCommandList, std::span<const ResourceBarrier> barriers);
+
+        void TranslateBarriers(std::span<const ResourceBarrier> barriers,
+                               std::vector<D3D12_RESOURCE_BARRIER>& d3d12Barriers) const;
+
+        inline ID3D12Resource* GetResource(UInt32 resource) const;
+        inline const ResourceStateTable& GetTable() const;
+
+    private:
+        static UInt32 GetSubresourceCount(ID3D12Resource* pResource);
+
+        ResourceStateTable m_Table;
+        std::vector<ID3D12Resource*> m_Resources;
+        std::vector<D3D12_RESOURCE_BARRIER> m_Barriers;
+    };
+}
+
+#include "Framework/D3D12ResourceStateTable.inl"
+
+#endif // D3D12TESTS_D3D12RESOURCESTATETABLE_HPP
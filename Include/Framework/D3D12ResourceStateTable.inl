@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include "Framework/D3D12ResourceStateTracker.hpp"
+
+namespace D3D12Tests {
+    inline std::span<const ResourceBarrier> D3D12ResourceStateTable::Resolve(const D3D12ResourceStateTracker& tracker) {
+        return m_Table.Resolve(tracker.GetTracker());
+    }
+
+    inline ID3D12Resource* D3D12ResourceStateTable::GetResource(const UInt32 resource) const {
+        return m_Table.IsRegistered(resource) ? m_Resources[resource] : nullptr;
+    }
+
+    inline const ResourceStateTable& D3D12ResourceStateTable::GetTable() const {
+        return m_Table;
+    }
+}
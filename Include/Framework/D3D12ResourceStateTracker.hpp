@@ -0,0 +1,57 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12RESOURCESTATETRACKER_HPP
+#define D3D12TESTS_D3D12RESOURCESTATETRACKER_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ResourceStateTracker.hpp"
+
+namespace D3D12Tests {
+    class D3D12ResourceStateTable;
+
+    // ResourceStateTracker recording its barriers in a D3D12 command list, with a single
+    // ResourceBarrier() call per flush. Each command list being recorded needs its own
+    // tracker, reset along with the list.
+    class D3D12ResourceStateTracker {
+    public:
+        explicit D3D12ResourceStateTracker(D3D12ResourceStateTable& table, bool enableSplitBarriers = false);
+        ~D3D12ResourceStateTracker() = default;
+
+        D3D12ResourceStateTracker(const D3D12ResourceStateTracker&) = delete;
+        D3D12ResourceStateTracker(D3D12ResourceStateTracker&&) = delete;
+
+        D3D12ResourceStateTracker& operator=(const D3D12ResourceStateTracker&) = delete;
+        D3D12ResourceStateTracker& operator=(D3D12ResourceStateTracker&&) = delete;
+
+        inline void Transition(UInt32 resource, D3D12_RESOURCE_STATES state,
+                               UInt32 subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+        inline void BeginTransition(UInt32 resource, D3D12_RESOURCE_STATES state,
+                                    UInt32 subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+        inline void UavBarrier(UInt32 resource);
+
+        // Records the barriers batched since the last flush, to be done before the commands
+        // depending on them.
+        void FlushBarriers(ID3D12GraphicsCommandList* pCommandList);
+        // Must be called before closing the command list.
+        void Close(ID3D12GraphicsCommandList* pCommandList);
+        inline void Reset();
+
+        inline const ResourceStateTracker& GetTracker() const;
+
+    private:
+        void RecordBarriers(ID3D12GraphicsCommandList* pCommandList, std::span<const ResourceBarrier> barriers);
+
+        D3D12ResourceStateTable& m_Table;
+        ResourceStateTracker m_Tracker;
+        std::vector<D3D12_RESOURCE_BARRIER> m_Barriers;
+    };
+}
+
+#include "Framework/D3D12ResourceStateTracker.inl"
+
+#endif // D3D12TESTS_D3D12RESOURCESTATETRACKER_HPP
@@ -0,0 +1,29 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void D3D12ResourceStateTracker::Transition(const UInt32 resource, const D3D12_RESOURCE_STATES state,
+                                                      const UInt32 subresource) {
+        m_Tracker.Transition(resource, static_cast<ResourceState>(state), subresource);
+    }
+
+    inline void D3D12ResourceStateTracker::BeginTransition(const UInt32 resource, const D3D12_RESOURCE_STATES state,
+                                                           const UInt32 subresource) {
+        m_Tracker.BeginTransition(resource, static_cast<ResourceState>(state), subresource);
+    }
+
+    inline void D3D12ResourceStateTracker::UavBarrier(const UInt32 resource) {
+        m_Tracker.UavBarrier(resource);
+    }
+
+    inline void D3D12ResourceStateTracker::Reset() {
+        m_Tracker.Reset();
+    }
+
+    inline const ResourceStateTracker& D3D12ResourceStateTracker::GetTracker() const {
+        return m_Tracker;
+    }
+}
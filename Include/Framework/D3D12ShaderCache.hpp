@@ -0,0 +1,45 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12SHADERCACHE_HPP
+#define D3D12TESTS_D3D12SHADERCACHE_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/CachedShaderCompiler.hpp"
+#include "Framework/D3D12ShaderCompiler.hpp"
+
+namespace D3D12Tests {
+    // Shader cache file in front of the D3D compiler, returning the bytecode in blobs.
+    // Like the cache itself, it is not thread-safe.
+    class D3D12ShaderCache {
+    public:
+        explicit D3D12ShaderCache(const std::filesystem::path& path);
+        ~D3D12ShaderCache() = default;
+
+        D3D12ShaderCache(const D3D12ShaderCache&) = delete;
+        D3D12ShaderCache(D3D12ShaderCache&&) = delete;
+
+        D3D12ShaderCache& operator=(const D3D12ShaderCache&) = delete;
+        D3D12ShaderCache& operator=(D3D12ShaderCache&&) = delete;
+
+        Microsoft::WRL::ComPtr<ID3DBlob> Compile(const ShaderCompileDesc& desc);
+
+        inline const CachedShaderCompiler& GetCompiler() const;
+
+        // Cache stored next to the executable, used by CompileShader().
+        static D3D12ShaderCache& GetDefault();
+
+    private:
+        ShaderCache m_Cache;
+        D3D12ShaderCompiler m_Compiler;
+        CachedShaderCompiler m_CachedCompiler;
+    };
+}
+
+#include "Framework/D3D12ShaderCache.inl"
+
+#endif // D3D12TESTS_D3D12SHADERCACHE_HPP
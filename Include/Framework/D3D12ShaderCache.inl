@@ -0,0 +1,11 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline const CachedShaderCompiler& D3D12ShaderCache::GetCompiler() const {
+        return m_CachedCompiler;
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12SHADERCOMPILER_HPP
+#define D3D12TESTS_D3D12SHADERCOMPILER_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ShaderCompiler.hpp"
+
+namespace D3D12Tests {
+    // ShaderCompiler using D3DCompileFromFile() and the standard include handler.
+    class D3D12ShaderCompiler final : public ShaderCompiler {
+    public:
+        D3D12ShaderCompiler() = default;
+        ~D3D12ShaderCompiler() override = default;
+
+        D3D12ShaderCompiler(const D3D12ShaderCompiler&) = delete;
+        D3D12ShaderCompiler(D3D12ShaderCompiler&&) = delete;
+
+        D3D12ShaderCompiler& operator=(const D3D12ShaderCompiler&) = delete;
+        D3D12ShaderCompiler& operator=(D3D12ShaderCompiler&&) = delete;
+
+        std::vector<std::byte> Compile(const ShaderCompileDesc& desc) override;
+        UInt64 GetVersionHash() const override;
+    };
+}
+
+#endif // D3D12TESTS_D3D12SHADERCOMPILER_HPP
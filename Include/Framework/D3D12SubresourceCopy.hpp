@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12SUBRESOURCECOPY_HPP
+#define D3D12TESTS_D3D12SUBRESOURCECOPY_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/SubresourceCopy.hpp"
+
+namespace D3D12Tests {
+    // Conversions between the D3D12 structures and their portable counterparts, so that
+    // footprints can be computed without a device. Buffers are not textures and throw
+    // std::invalid_argument.
+    inline TextureCopyDesc ToTextureCopyDesc(const D3D12_RESOURCE_DESC& desc);
+    inline D3D12_PLACED_SUBRESOURCE_FOOTPRINT ToD3D12Footprint(const SubresourceFootprint& footprint);
+}
+
+#include "Framework/D3D12SubresourceCopy.inl"
+
+#endif // D3D12TESTS_D3D12SUBRESOURCECOPY_HPP
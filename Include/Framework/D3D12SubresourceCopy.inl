@@ -0,0 +1,47 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline TextureCopyDesc ToTextureCopyDesc(const D3D12_RESOURCE_DESC& desc) {
+        TextureCopyDesc copyDesc;
+        copyDesc.Format = static_cast<UInt32>(desc.Format);
+        copyDesc.Width = desc.Width;
+        copyDesc.Height = desc.Height;
+        copyDesc.DepthOrArraySize = desc.DepthOrArraySize;
+        // Zero asks D3D12 for the full mip chain, which copies have to be explicit about.
+        copyDesc.MipLevels = desc.MipLevels;
+
+        switch (desc.Dimension) {
+            case D3D12_RESOURCE_DIMENSION_TEXTURE1D:
+                copyDesc.Dimension = TextureDimension::Texture1D;
+                break;
+            case D3D12_RESOURCE_DIMENSION_TEXTURE2D:
+                copyDesc.Dimension = TextureDimension::Texture2D;
+                break;
+            case D3D12_RESOURCE_DIMENSION_TEXTURE3D:
+                copyDesc.Dimension = TextureDimension::Texture3D;
+                break;
+            default:
+                throw std::invalid_argument("The resource is not a texture.");
+        }
+
+        return copyDesc;
+    }
+
+    inline D3D12_PLACED_SUBRESOURCE_FOOTPRINT ToD3D12Footprint(const SubresourceFootprint& footprint) {
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT d3d12Footprint;
+        d3d12Footprint.Offset = footprint.Offset;
+        d3d12Footprint.Footprint.Format = static_cast<DXGI_FORMAT>(footprint.Format);
+        d3d12Footprint.Footprint.Width = footprint.Width;
+        d3d12Footprint.Footprint.Height = footprint.Height;
+        d3d12Footprint.Footprint.Depth = footprint.Depth;
+        d3d12Footprint.Footprint.RowPitch = footprint.RowPitch;
+
+        return d3d12Footprint;
+    }
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_D3D12UPLOADRING_HPP
+#define D3D12TESTS_D3D12UPLOADRING_HPP
+
+#include "Framework/pch.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/UploadRing.hpp"
+
+namespace D3D12Tests {
+    // UploadRing over a committed UPLOAD heap buffer that stays mapped for its whole lifetime.
+    class D3D12UploadRing {
+    public:
+        D3D12UploadRing(ID3D12Device* pDevice, GpuTimeline& timeline, UInt64 capacity);
+        ~D3D12UploadRing();
+
+        D3D12UploadRing(const D3D12UploadRing&) = delete;
+        D3D12UploadRing(D3D12UploadRing&&) = delete;
+
+        D3D12UploadRing& operator=(const D3D12UploadRing&) = delete;
+        D3D12UploadRing& operator=(D3D12UploadRing&&) = delete;
+
+        inline UploadAllocation Allocate(UInt64 size, UInt64 alignment = Alignment::Buffer);
+        inline UploadAllocation AllocateConstants(UInt64 size);
+        inline UploadAllocation AllocateTexture(UInt64 size);
+        inline UploadAllocation Upload(const void* pData, UInt64 size, UInt64 alignment = Alignment::Buffer);
+
+        inline ID3D12Resource* GetResource() const;
+        inline UploadRing& GetRing();
+
+    private:
+        static ComPtr<ID3D12Resource> CreateBuffer(ID3D12Device* pDevice, UInt64 capacity);
+        static std::byte* MapBuffer(ID3D12Resource* pBuffer);
+
+        ComPtr<ID3D12Resource> m_Buffer;
+        UploadRing m_Ring;
+    };
+}
+
+#include "Framework/D3D12UploadRing.inl"
+
+#endif // D3D12TESTS_D3D12UPLOADRING_HPP
@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UploadAllocation D3D12UploadRing::Allocate(const UInt64 size, const UInt64 alignment) {
+        return m_Ring.Allocate(size, alignment);
+    }
+
+    inline UploadAllocation D3D12UploadRing::AllocateConstants(const UInt64 size) {
+        return m_Ring.AllocateConstants(size);
+    }
+
+    inline UploadAllocation D3D12UploadRing::AllocateTexture(const UInt64 size) {
+        return m_Ring.AllocateTexture(size);
+    }
+
+    inline UploadAllocation D3D12UploadRing::Upload(const void* pData, const UInt64 size, const UInt64 alignment) {
+        return m_Ring.Upload(pData, size, alignment);
+    }
+
+    inline ID3D12Resource* D3D12UploadRing::GetResource() const {
+        return m_Buffer.Get();
+    }
+
+    inline UploadRing& D3D12UploadRing::GetRing() {
+        return m_Ring;
+    }
+}
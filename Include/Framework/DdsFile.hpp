@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_DDSFILE_HPP
+#define D3D12TESTS_DDSFILE_HPP
+
+#include "Framework/MappedFile.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <span>
+#include <vector>
+
+namespace D3D12Tests {
+    // Pixels of a mip level of an array slice (or of the whole volume of a 3D texture),
+    // pointing into the file mapping.
+    struct DdsSubresource {
+        const std::byte* Data;
+        UInt32 Width;
+        UInt32 Height;
+        UInt32 Depth;
+        UInt64 RowPitch;
+        // Number of rows of blocks in a depth slice.
+        UInt32 RowCount;
+        UInt64 SlicePitch;
+    };
+
+    // DDS texture memory-mapped in its entirety. Both the legacy headers and the DX10
+    // extension are read, with mip chains, arrays, cubemaps and volumes; the pixels are
+    // never copied. Throws std::runtime_error for files that are malformed, truncated or
+    // in a format without a single-plane layout.
+    class DdsFile {
+    public:
+        explicit DdsFile(const std::filesystem::path& path);
+        ~DdsFile() = default;
+
+        DdsFile(const DdsFile&) = delete;
+        DdsFile(DdsFile&&) noexcept = default;
+
+        DdsFile& operator=(const DdsFile&) = delete;
+        DdsFile& operator=(DdsFile&&) noexcept = default;
+
+        // Subresources in the D3D12 order: the mips of the first array slice, then the
+        // ones of the next slice... Cubemap faces are array slices, in +X, -X, +Y, -Y, +Z, -Z
+        // order.
+        inline std::span<const DdsSubresource> GetSubresources() const;
+        inline const DdsSubresource& GetSubresource(UInt32 mipLevel, UInt32 arraySlice) const;
+
+        inline UInt32 GetFormat() const;
+        inline TextureDimension GetDimension() const;
+        inline UInt32 GetWidth() const;
+        inline UInt32 GetHeight() const;
+        inline UInt32 GetDepth() const;
+        // Counts each face of a cubemap.
+        inline UInt32 GetArraySize() const;
+        inline UInt32 GetMipCount() const;
+        inline bool IsCubemap() const;
+        inline UInt64 GetFileSize() const;
+
+    private:
+        void ReadHeader();
+        void BuildSubresources(UInt64 dataOffset);
+
+        MappedFile m_File;
+        std::vector<DdsSubresource> m_Subresources;
+        UInt32 m_Format;
+        TextureDimension m_Dimension;
+        UInt32 m_Width;
+        UInt32 m_Height;
+        UInt32 m_Depth;
+        UInt32 m_ArraySize;
+        UInt32 m_MipCount;
+        bool m_IsCubemap;
+    };
+}
+
+#include "Framework/DdsFile.inl"
+
+#endif // D3D12TESTS_DDSFILE_HPP
@@ -0,0 +1,57 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline std::span<const DdsSubresource> DdsFile::GetSubresources() const {
+        return m_Subresources;
+    }
+
+    inline const DdsSubresource& DdsFile::GetSubresource(const UInt32 mipLevel, const UInt32 arraySlice) const {
+        if (mipLevel >= m_MipCount || arraySlice >= m_ArraySize) {
+            throw std::out_of_range("The subresource is not in the texture.");
+        }
+
+        return m_Subresources[static_cast<std::size_t>(arraySlice) * m_MipCount + mipLevel];
+    }
+
+    inline UInt32 DdsFile::GetFormat() const {
+        return m_Format;
+    }
+
+    inline TextureDimension DdsFile::GetDimension() const {
+        return m_Dimension;
+    }
+
+    inline UInt32 DdsFile::GetWidth() const {
+        return m_Width;
+    }
+
+    inline UInt32 DdsFile::GetHeight() const {
+        return m_Height;
+    }
+
+    inline UInt32 DdsFile::GetDepth() const {
+        return m_Depth;
+    }
+
+    inline UInt32 DdsFile::GetArraySize() const {
+        return m_ArraySize;
+    }
+
+    inline UInt32 DdsFile::GetMipCount() const {
+        return m_MipCount;
+    }
+
+    inline bool DdsFile::IsCubemap() const {
+        return m_IsCubemap;
+    }
+
+    inline UInt64 DdsFile::GetFileSize() const {
+        return m_File.GetSize();
+    }
+}
@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_DRAWQUEUE_HPP
+#define D3D12TESTS_DRAWQUEUE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <span>
+#include <vector>
+
+namespace D3D12Tests {
+    // Fields of the 64-bit sort keys, from the most significant bits: the layer (e.g. opaque,
+    // then transparent, then overlay), the pipeline, the material and the depth. Sorted keys
+    // group the draws by pipeline, then by material, within each layer.
+    inline constexpr UInt32 DrawKeyLayerBits = 8;
+    inline constexpr UInt32 DrawKeyPipelineBits = 12;
+    inline constexpr UInt32 DrawKeyMaterialBits = 20;
+    inline constexpr UInt32 DrawKeyDepthBits = 24;
+
+    inline constexpr UInt32 DrawKeyDepthShift = 0;
+    inline constexpr UInt32 DrawKeyMaterialShift = DrawKeyDepthShift + DrawKeyDepthBits;
+    inline constexpr UInt32 DrawKeyPipelineShift = DrawKeyMaterialShift + DrawKeyMaterialBits;
+    inline constexpr UInt32 DrawKeyLayerShift = DrawKeyPipelineShift + DrawKeyPipelineBits;
+    static_assert(DrawKeyLayerShift + DrawKeyLayerBits == 64);
+
+    // Throws std::invalid_argument for fields larger than their bits.
+    inline UInt64 MakeDrawKey(UInt32 layer, UInt32 pipeline, UInt32 material, UInt32 depth);
+    inline UInt32 GetDrawKeyLayer(UInt64 key);
+    inline UInt32 GetDrawKeyPipeline(UInt64 key);
+    inline UInt32 GetDrawKeyMaterial(UInt64 key);
+    inline UInt32 GetDrawKeyDepth(UInt64 key);
+
+    // The depth field of a view depth in [0, maxDepth], clamped, front to back or back to front
+    // like transparent layers. The depth interleaves the meshes of a material: layers drawing
+    // many instances of few meshes can put the mesh in the depth field instead, so that its
+    // instances end up next to each other and merge.
+    inline UInt32 QuantizeDrawDepth(Float32 depth, Float32 maxDepth, bool backToFront = false);
+
+    // 16 bytes per draw. Geometry identifies the vertex and index buffers and the draw
+    // arguments, Instance the data of the object (e.g. its index in a structured buffer).
+    struct DrawPacket {
+        UInt64 Key = 0;
+        UInt32 Geometry = 0;
+        UInt32 Instance = 0;
+    };
+
+    // Packets next to each other after sorting, with the same geometry and the same key but
+    // for the depth, drawn as one instanced draw. Their instances are
+    // [FirstInstance, FirstInstance + InstanceCount) in DrawQueue::GetInstances, for the
+    // StartInstanceLocation and InstanceCount of the draw.
+    struct DrawBatch {
+        UInt64 Key = 0;
+        UInt32 Geometry = 0;
+        UInt32 FirstInstance = 0;
+        UInt32 InstanceCount = 0;
+    };
+
+    // State set by the draws in order: a pipeline change also rebinds the material.
+    struct DrawStateChanges {
+        UInt64 DrawCount = 0;
+        UInt64 PipelineChanges = 0;
+        UInt64 MaterialChanges = 0;
+        UInt64 GeometryChanges = 0;
+    };
+
+    // The changes of drawing the packets one by one in the given order.
+    DrawStateChanges CountDrawStateChanges(std::span<const DrawPacket> packets);
+    DrawStateChanges CountDrawStateChanges(std::span<const DrawBatch> batches);
+
+    // Packets pushed during a frame, sorted by key and merged into batches once all are in.
+    class DrawQueue {
+    public:
+        DrawQueue() = default;
+        ~DrawQueue() = default;
+
+        DrawQueue(const DrawQueue&) = delete;
+        DrawQueue(DrawQueue&&) noexcept = default;
+
+        DrawQueue& operator=(const DrawQueue&) = delete;
+        DrawQueue& operator=(DrawQueue&&) noexcept = default;
+
+        inline void Push(const DrawPacket& packet);
+        inline void Push(UInt64 key, UInt32 geometry, UInt32 instance);
+        inline void Reserve(UInt32 packetCount);
+
+        // Sorts the packets with a stable LSD radix sort, 8 bits per pass, skipping the bytes
+        // equal in every key, then builds the batches.
+        void Sort();
+        // Empties the queue for the next frame, keeping the memory.
+        inline void Clear();
+
+        // Sorted once Sort has been called.
+        inline std::span<const DrawPacket> GetPackets() const;
+        inline std::span<const DrawBatch> GetBatches() const;
+        // The instances of the packets, in the order of the batches.
+        inline std::span<const UInt32> GetInstances() const;
+        inline UInt32 GetPacketCount() const;
+
+    private:
+        std::vector<DrawPacket> m_Packets;
+        std::vector<DrawPacket> m_SortedPackets;
+        std::vector<DrawBatch> m_Batches;
+        std::vector<UInt32> m_Instances;
+    };
+}
+
+#include "Framework/DrawQueue.inl"
+
+#endif // D3D12TESTS_DRAWQUEUE_HPP
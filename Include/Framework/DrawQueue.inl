@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline UInt64 MakeDrawKey(const UInt32 layer, const UInt32 pipeline, const UInt32 material, const UInt32 depth) {
+        if (layer >> DrawKeyLayerBits != 0 || pipeline >> DrawKeyPipelineBits != 0 ||
+            material >> DrawKeyMaterialBits != 0 || depth >> DrawKeyDepthBits != 0) {
+            throw std::invalid_argument("A draw key field is too large for its bits.");
+        }
+
+        return UInt64(layer) << DrawKeyLayerShift | UInt64(pipeline) << DrawKeyPipelineShift |
+            UInt64(material) << DrawKeyMaterialShift | UInt64(depth) << DrawKeyDepthShift;
+    }
+
+    inline UInt32 GetDrawKeyLayer(const UInt64 key) {
+        return static_cast<UInt32>(key >> DrawKeyLayerShift & ((UInt64(1) << DrawKeyLayerBits) - 1));
+    }
+
+    inline UInt32 GetDrawKeyPipeline(const UInt64 key) {
+        return static_cast<UInt32>(key >> DrawKeyPipelineShift & ((UInt64(1) << DrawKeyPipelineBits) - 1));
+    }
+
+    inline UInt32 GetDrawKeyMaterial(const UInt64 key) {
+        return static_cast<UInt32>(key >> DrawKeyMaterialShift & ((UInt64(1) << DrawKeyMaterialBits) - 1));
+    }
+
+    inline UInt32 GetDrawKeyDepth(const UInt64 key) {
+        return static_cast<UInt32>(key >> DrawKeyDepthShift & ((UInt64(1) << DrawKeyDepthBits) - 1));
+    }
+
+    inline UInt32 QuantizeDrawDepth(const Float32 depth, const Float32 maxDepth, const bool backToFront) {
+        constexpr UInt32 MaxValue = (1u << DrawKeyDepthBits) - 1;
+
+        // Written so that NaN ends up at zero.
+        const Float32 normalized = maxDepth > 0.0f ? depth / maxDepth : 0.0f;
+        const UInt32 value = normalized >= 1.0f ? MaxValue
+            : normalized > 0.0f ? static_cast<UInt32>(normalized * static_cast<Float32>(MaxValue)) : 0;
+
+        return backToFront ? MaxValue - value : value;
+    }
+
+    inline void DrawQueue::Push(const DrawPacket& packet) {
+        m_Packets.push_back(packet);
+    }
+
+    inline void DrawQueue::Push(const UInt64 key, const UInt32 geometry, const UInt32 instance) {
+        m_Packets.push_back({key, geometry, instance});
+    }
+
+    inline void DrawQueue::Reserve(const UInt32 packetCount) {
+        m_Packets.reserve(packetCount);
+        m_SortedPackets.reserve(packetCount);
+        m_Instances.reserve(packetCount);
+    }
+
+    inline void DrawQueue::Clear() {
+        m_Packets.clear();
+        m_Batches.clear();
+        m_Instances.clear();
+    }
+
+    inline std::span<const DrawPacket> DrawQueue::GetPackets() const {
+        return m_Packets;
+    }
+
+    inline std::span<const DrawBatch> DrawQueue::GetBatches() const {
+        return m_Batches;
+    }
+
+    inline std::span<const UInt32> DrawQueue::GetInstances() const {
+        return m_Instances;
+    }
+
+    inline UInt32 DrawQueue::GetPacketCount() const {
+        return static_cast<UInt32>(m_Packets.size());
+    }
+}
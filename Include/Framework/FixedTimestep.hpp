@@ -0,0 +1,42 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FIXEDTIMESTEP_HPP
+#define D3D12TESTS_FIXEDTIMESTEP_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    // Accumulates the frame times and turns them into a whole number of updates of a fixed
+    // step. What is left is the interpolation factor between the last two updates.
+    class FixedTimestep {
+    public:
+        // Past maxUpdatesPerFrame, the late time is dropped instead of being caught up on,
+        // so that a slow update cannot make every following frame slower.
+        explicit FixedTimestep(Float64 stepSeconds = 1.0 / 60.0, UInt32 maxUpdatesPerFrame = 8);
+
+        // Returns the number of updates to run for this frame.
+        UInt32 Advance(Float64 deltaSeconds);
+        inline void Reset();
+
+        inline Float64 GetStepSeconds() const;
+        // In [0, 1), how far the current time is between the last update and the next one.
+        inline Float64 GetAlpha() const;
+        inline UInt64 GetUpdateCount() const;
+        inline UInt64 GetDroppedUpdateCount() const;
+
+    private:
+        Float64 m_StepSeconds;
+        UInt32 m_MaxUpdatesPerFrame;
+        Float64 m_Accumulator;
+        UInt64 m_UpdateCount;
+        UInt64 m_DroppedUpdateCount;
+    };
+}
+
+#include "Framework/FixedTimestep.inl"
+
+#endif // D3D12TESTS_FIXEDTIMESTEP_HPP
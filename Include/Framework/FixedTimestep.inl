@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void FixedTimestep::Reset() {
+        m_Accumulator = 0.0;
+    }
+
+    inline Float64 FixedTimestep::GetStepSeconds() const {
+        return m_StepSeconds;
+    }
+
+    inline Float64 FixedTimestep::GetAlpha() const {
+        return m_Accumulator / m_StepSeconds;
+    }
+
+    inline UInt64 FixedTimestep::GetUpdateCount() const {
+        return m_UpdateCount;
+    }
+
+    inline UInt64 FixedTimestep::GetDroppedUpdateCount() const {
+        return m_DroppedUpdateCount;
+    }
+}
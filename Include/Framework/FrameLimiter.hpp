@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMELIMITER_HPP
+#define D3D12TESTS_FRAMELIMITER_HPP
+
+#include "Framework/Types.hpp"
+
+#include <chrono>
+
+namespace D3D12Tests {
+    // Time source and sleeps of a FrameLimiter. The system one uses the steady clock and
+    // the thread's sleeps, tests replace it to drive the limiter deterministically.
+    class FrameLimiterClock {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        FrameLimiterClock() = default;
+        virtual ~FrameLimiterClock() = default;
+
+        FrameLimiterClock(const FrameLimiterClock&) = delete;
+        FrameLimiterClock(FrameLimiterClock&&) = delete;
+
+        FrameLimiterClock& operator=(const FrameLimiterClock&) = delete;
+        FrameLimiterClock& operator=(FrameLimiterClock&&) = delete;
+
+        virtual Clock::time_point Now() = 0;
+        virtual void Sleep(Clock::duration duration) = 0;
+        // Called between the clock reads of the spin.
+        virtual void Pause() = 0;
+
+        static FrameLimiterClock& GetSystemClock();
+    };
+
+    // Waits until a deadline precisely without burning a core: sleeps in short slices while
+    // the remaining time is larger than what a slice may take, then spins for the rest.
+    // The cost of a slice is learned from the previous ones (mean plus three standard
+    // deviations), so the spin stays short on systems with precise timers.
+    class FrameLimiter {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit FrameLimiter(Clock::duration sleepSlice = std::chrono::milliseconds(1));
+        // The clock must outlive the limiter.
+        explicit FrameLimiter(FrameLimiterClock& clock, Clock::duration sleepSlice = std::chrono::milliseconds(1));
+        ~FrameLimiter() = default;
+
+        FrameLimiter(const FrameLimiter&) = delete;
+        FrameLimiter(FrameLimiter&&) = delete;
+
+        FrameLimiter& operator=(const FrameLimiter&) = delete;
+        FrameLimiter& operator=(FrameLimiter&&) = delete;
+
+        void WaitUntil(Clock::time_point deadline);
+
+        // Current estimate of the time a sleep slice takes.
+        inline Clock::duration GetSleepEstimate() const;
+        inline Clock::duration GetTotalSpinTime() const;
+
+    private:
+        void AddSleepSample(Float64 seconds);
+
+        FrameLimiterClock& m_Clock;
+        Clock::duration m_SleepSlice;
+
+        // Welford's running mean and variance of the slice durations, in seconds.
+        UInt64 m_SampleCount;
+        Float64 m_Mean;
+        Float64 m_SquaredDeviationSum;
+        Float64 m_Estimate;
+
+        Clock::duration m_TotalSpinTime;
+    };
+}
+
+#include "Framework/FrameLimiter.inl"
+
+#endif // D3D12TESTS_FRAMELIMITER_HPP
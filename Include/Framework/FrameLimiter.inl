@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline FrameLimiter::Clock::duration FrameLimiter::GetSleepEstimate() const {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<Float64>(m_Estimate));
+    }
+
+    inline FrameLimiter::Clock::duration FrameLimiter::GetTotalSpinTime() const {
+        return m_TotalSpinTime;
+    }
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMELOOP_HPP
+#define D3D12TESTS_FRAMELOOP_HPP
+
+#include "Framework/ApplicationBase.hpp"
+#include "Framework/FixedTimestep.hpp"
+#include "Framework/FrameLimiter.hpp"
+
+namespace D3D12Tests {
+    // Platform-neutral part of the run loops: paces the frames of an application as its
+    // FramePacingDesc asks, and runs its updates and rendering.
+    class FrameLoop {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit FrameLoop(ApplicationBase& application);
+        ~FrameLoop() = default;
+
+        FrameLoop(const FrameLoop&) = delete;
+        FrameLoop(FrameLoop&&) = delete;
+
+        FrameLoop& operator=(const FrameLoop&) = delete;
+        FrameLoop& operator=(FrameLoop&&) = delete;
+
+        // Waits for the start of the next frame, then runs it.
+        void RunFrame();
+
+        // Start of the last frame run, after the pacing wait.
+        inline Clock::time_point GetFrameStartTime() const;
+        inline const FrameLimiter& GetLimiter() const;
+
+    private:
+        void WaitForNextFrame(const FramePacingDesc& pacing);
+
+        ApplicationBase& m_Application;
+        FrameLimiter m_Limiter;
+        FramePacingDesc m_Pacing;
+        FixedTimestep m_Timestep;
+
+        Clock::time_point m_StartTime;
+        Clock::time_point m_FrameStartTime;
+        Clock::time_point m_NextDeadline;
+    };
+}
+
+#include "Framework/FrameLoop.inl"
+
+#endif // D3D12TESTS_FRAMELOOP_HPP
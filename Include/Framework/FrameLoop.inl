@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline FrameLoop::Clock::time_point FrameLoop::GetFrameStartTime() const {
+        return m_FrameStartTime;
+    }
+
+    inline const FrameLimiter& FrameLoop::GetLimiter() const {
+        return m_Limiter;
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEPACING_HPP
+#define D3D12TESTS_FRAMEPACING_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    enum class FramePacingMode : UInt8 {
+        // Frames start as soon as the previous one is done, Present may still block on vsync.
+        Uncapped,
+        // Frames start at a fixed rate, waited for with a FrameLimiter.
+        FixedRate,
+        // Frames start when the swap chain can take a new one (frame latency waitable object),
+        // so that input is sampled as late as possible. Uncapped without a latency waiter.
+        LowLatency
+    };
+
+    struct FramePacingDesc {
+        FramePacingMode Mode = FramePacingMode::Uncapped;
+        Float64 TargetFrameRate = 60.0;
+        // Zero runs one update per frame with the frame time, otherwise updates run with
+        // this step, as many per frame as the elapsed time requires.
+        Float64 UpdateStepSeconds = 0.0;
+        UInt32 MaxUpdatesPerFrame = 8;
+
+        bool operator==(const FramePacingDesc&) const = default;
+    };
+
+    // Timing of the frame being run, for OnUpdate and OnRender.
+    struct FrameTiming {
+        UInt64 FrameNumber = 0;
+        // CPU time since the start of the previous frame, zero for the first one.
+        Float64 DeltaSeconds = 0.0;
+        Float64 TotalSeconds = 0.0;
+        // Number of OnUpdate calls this frame, and the time each one covers.
+        UInt32 UpdateCount = 0;
+        Float64 UpdateStepSeconds = 0.0;
+        // With a fixed step, how far the frame is between the last update and the next one.
+        Float64 InterpolationAlpha = 0.0;
+    };
+}
+
+#endif // D3D12TESTS_FRAMEPACING_HPP
@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMERING_HPP
+#define D3D12TESTS_FRAMERING_HPP
+
+#include "Framework/GpuTimeline.hpp"
+#include "Framework/LinearAllocator.hpp"
+
+#include <vector>
+
+namespace D3D12Tests {
+    // Ring of N per-frame contexts allowing the CPU to record up to N frames ahead of
+    // the GPU. Each context holds the user resources of type TFrame (e.g. a command
+    // allocator), some transient CPU memory, and the fence value of the last frame that
+    // used it. BeginFrame() only blocks when the CPU laps the GPU, that is when the
+    // context it is about to reuse is still referenced by an unfinished frame.
+    template <class TFrame>
+    class FrameRing {
+    public:
+        FrameRing(GpuTimeline& timeline, UInt32 frameCount, std::size_t transientMemorySize = 0);
+        ~FrameRing() = default;
+
+        FrameRing(const FrameRing&) = delete;
+        FrameRing(FrameRing&&) = delete;
+
+        FrameRing& operator=(const FrameRing&) = delete;
+        FrameRing& operator=(FrameRing&&) = delete;
+
+        // Waits for the current context to be released by the GPU and returns it.
+        TFrame& BeginFrame();
+        // Signals the timeline for the work submitted this frame and moves to the next context.
+        UInt64 EndFrame();
+        // Waits for every frame in flight to complete.
+        void Flush();
+
+        inline TFrame& GetCurrentFrame();
+        inline TFrame& GetFrame(UInt32 index);
+        inline LinearAllocator& GetTransientAllocator();
+
+        inline UInt32 GetFrameIndex() const;
+        inline UInt32 GetFrameCount() const;
+        inline UInt64 GetFrameNumber() const;
+        inline UInt64 GetWaitCount() const;
+
+    private:
+        struct FrameContext {
+            TFrame Resources;
+            LinearAllocator TransientMemory;
+            UInt64 FenceValue = 0;
+        };
+
+        GpuTimeline& m_Timeline;
+        std::vector<FrameContext> m_Frames;
+        UInt32 m_FrameIndex;
+        UInt64 m_FrameNumber;
+        UInt64 m_WaitCount;
+    };
+}
+
+#include "Framework/FrameRing.inl"
+
+#endif // D3D12TESTS_FRAMERING_HPP
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    template <class TFrame>
+    FrameRing<TFrame>::FrameRing(GpuTimeline& timeline, const UInt32 frameCount, const std::size_t transientMemorySize) :
+        m_Timeline(timeline),
+        m_FrameIndex(0),
+        m_FrameNumber(0),
+        m_WaitCount(0) {
+        if (frameCount == 0) {
+            throw std::invalid_argument("A frame ring needs at least one frame.");
+        }
+
+        m_Frames.resize(frameCount);
+        for (FrameContext& frame : m_Frames) {
+            frame.TransientMemory = LinearAllocator(transientMemorySize);
+        }
+    }
+
+    template <class TFrame>
+    TFrame& FrameRing<TFrame>::BeginFrame() {
+        FrameContext& frame = m_Frames[m_FrameIndex];
+
+        // The context was last used frameCount frames ago; only block if the GPU
+        // has not caught up with it yet.
+        if (!m_Timeline.IsComplete(frame.FenceValue)) {
+            ++m_WaitCount;
+            m_Timeline.WaitForValue(frame.FenceValue);
+        }
+
+        frame.TransientMemory.Reset();
+        return frame.Resources;
+    }
+
+    template <class TFrame>
+    UInt64 FrameRing<TFrame>::EndFrame() {
+        const UInt64 fenceValue = m_Timeline.Signal();
+        m_Frames[m_FrameIndex].FenceValue = fenceValue;
+
+        m_FrameIndex = (m_FrameIndex + 1) % static_cast<UInt32>(m_Frames.size());
+        ++m_FrameNumber;
+
+        return fenceValue;
+    }
+
+    template <class TFrame>
+    void FrameRing<TFrame>::Flush() {
+        m_Timeline.Flush();
+    }
+
+    template <class TFrame>
+    inline TFrame& FrameRing<TFrame>::GetCurrentFrame() {
+        return m_Frames[m_FrameIndex].Resources;
+    }
+
+    template <class TFrame>
+    inline TFrame& FrameRing<TFrame>::GetFrame(const UInt32 index) {
+        return m_Frames[index].Resources;
+    }
+
+    template <class TFrame>
+    inline LinearAllocator& FrameRing<TFrame>::GetTransientAllocator() {
+        return m_Frames[m_FrameIndex].TransientMemory;
+    }
+
+    template <class TFrame>
+    inline UInt32 FrameRing<TFrame>::GetFrameIndex() const {
+        return m_FrameIndex;
+    }
+
+    template <class TFrame>
+    inline UInt32 FrameRing<TFrame>::GetFrameCount() const {
+        return static_cast<UInt32>(m_Frames.size());
+    }
+
+    template <class TFrame>
+    inline UInt64 FrameRing<TFrame>::GetFrameNumber() const {
+        return m_FrameNumber;
+    }
+
+    template <class TFrame>
+    inline UInt64 FrameRing<TFrame>::GetWaitCount() const {
+        return m_WaitCount;
+    }
+}
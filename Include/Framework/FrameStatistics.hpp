@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMESTATISTICS_HPP
+#define D3D12TESTS_FRAMESTATISTICS_HPP
+
+#include "Framework/Types.hpp"
+
+#include <span>
+#include <string>
+
+namespace D3D12Tests {
+    // CPU frame times of a run, in milliseconds. Percentiles use the nearest rank.
+    struct FrameStatistics {
+        UInt64 FrameCount = 0;
+        Float64 TotalMilliseconds = 0.0;
+        Float64 MinMilliseconds = 0.0;
+        Float64 AverageMilliseconds = 0.0;
+        Float64 MedianMilliseconds = 0.0;
+        Float64 P99Milliseconds = 0.0;
+        Float64 MaxMilliseconds = 0.0;
+    };
+
+    FrameStatistics ComputeFrameStatistics(std::span<const Float64> frameMilliseconds);
+    // One line, e.g. for a log or the window title.
+    std::string FormatFrameStatistics(const FrameStatistics& statistics);
+}
+
+#endif // D3D12TESTS_FRAMESTATISTICS_HPP
@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_GPUTIMELINE_HPP
+#define D3D12TESTS_GPUTIMELINE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <atomic>
+
+namespace D3D12Tests {
+    // A monotonically increasing fence timeline shared by the CPU and a GPU queue.
+    // Values are signaled in order on the queue and complete in the same order, which
+    // is all the scheduling code (frame ring, pools, upload ring...) needs to know.
+    class GpuTimeline {
+    public:
+        GpuTimeline() = default;
+        virtual ~GpuTimeline() = default;
+
+        GpuTimeline(const GpuTimeline&) = delete;
+        GpuTimeline(GpuTimeline&&) = delete;
+
+        GpuTimeline& operator=(const GpuTimeline&) = delete;
+        GpuTimeline& operator=(GpuTimeline&&) = delete;
+
+        // Enqueues a signal of the next value on the queue and returns that value.
+        virtual UInt64 Signal() = 0;
+        virtual UInt64 GetCompletedValue() = 0;
+        // Blocks the calling thread until the given value has completed.
+        virtual void WaitForValue(UInt64 value) = 0;
+
+        inline UInt64 GetLastSignaledValue() const;
+        inline bool IsComplete(UInt64 value);
+
+        // Waits until all the work submitted so far has completed.
+        inline void Flush();
+
+    protected:
+        std::atomic<UInt64> m_LastSignaledValue = 0;
+    };
+}
+
+#include "Framework/GpuTimeline.inl"
+
+#endif // D3D12TESTS_GPUTIMELINE_HPP
@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt64 GpuTimeline::GetLastSignaledValue() const {
+        return m_LastSignaledValue.load(std::memory_order_acquire);
+    }
+
+    inline bool GpuTimeline::IsComplete(const UInt64 value) {
+        return value <= GetCompletedValue();
+    }
+
+    inline void GpuTimeline::Flush() {
+        WaitForValue(Signal());
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_GRAPHICSCOMMANDLIST_HPP
+#define D3D12TESTS_GRAPHICSCOMMANDLIST_HPP
+
+#include "Framework/Types.hpp"
+
+#include <span>
+
+// Only passed around by pointer, so that the portable code does not need the D3D12 headers.
+struct ID3D12DescriptorHeap;
+struct ID3D12PipelineState;
+struct ID3D12RootSignature;
+
+namespace D3D12Tests {
+    // Mirror D3D12_VIEWPORT, D3D12_RECT, D3D12_VERTEX_BUFFER_VIEW, D3D12_INDEX_BUFFER_VIEW and
+    // D3D_PRIMITIVE_TOPOLOGY. The layouts are checked against the SDK in the D3D12 glue.
+    struct Viewport {
+        Float32 TopLeftX = 0.0f;
+        Float32 TopLeftY = 0.0f;
+        Float32 Width = 0.0f;
+        Float32 Height = 0.0f;
+        Float32 MinDepth = 0.0f;
+        Float32 MaxDepth = 1.0f;
+    };
+
+    struct ScissorRect {
+        Int32 Left = 0;
+        Int32 Top = 0;
+        Int32 Right = 0;
+        Int32 Bottom = 0;
+    };
+
+    struct VertexBufferView {
+        UInt64 BufferLocation = 0;
+        UInt32 SizeInBytes = 0;
+        UInt32 StrideInBytes = 0;
+    };
+
+    struct IndexBufferView {
+        UInt64 BufferLocation = 0;
+        UInt32 SizeInBytes = 0;
+        // A DxgiFormat value, R16Uint or R32Uint.
+        UInt32 Format = 0;
+    };
+
+    enum class PrimitiveTopology : UInt32 {
+        Undefined = 0,
+        PointList = 1,
+        LineList = 2,
+        LineStrip = 3,
+        TriangleList = 4,
+        TriangleStrip = 5
+    };
+
+    // Mirror the D3D12 limits, the heaps being one CBV/SRV/UAV heap and one sampler heap.
+    inline constexpr UInt32 MaxDescriptorHeaps = 2;
+    inline constexpr UInt32 MaxViewports = 16;
+    inline constexpr UInt32 MaxVertexBuffers = 32;
+    inline constexpr UInt32 MaxRootParameters = 64;
+    inline constexpr UInt32 MaxRootConstants = 64;
+
+    enum class GraphicsCommand : UInt8 {
+        SetPipelineState,
+        SetGraphicsRootSignature,
+        SetDescriptorHeaps,
+        SetGraphicsRootDescriptorTable,
+        SetGraphicsRoot32BitConstants,
+        SetGraphicsRootConstantBufferView,
+        SetViewports,
+        SetScissorRects,
+        SetPrimitiveTopology,
+        SetVertexBuffers,
+        SetIndexBuffer,
+        DrawInstanced,
+        DrawIndexedInstanced,
+
+        Count
+    };
+
+    const char* GetGraphicsCommandName(GraphicsCommand command);
+
+    // The state setting and draw calls of ID3D12GraphicsCommandList, as used by the
+    // CommandRecorder. D3D12GraphicsCommandList records them in a D3D12 list,
+    // RecordingCommandList only keeps track of them, on any platform.
+    class GraphicsCommandList {
+    public:
+        GraphicsCommandList() = default;
+        virtual ~GraphicsCommandList() = default;
+
+        GraphicsCommandList(const GraphicsCommandList&) = delete;
+        GraphicsCommandList(GraphicsCommandList&&) = delete;
+
+        GraphicsCommandList& operator=(const GraphicsCommandList&) = delete;
+        GraphicsCommandList& operator=(GraphicsCommandList&&) = delete;
+
+        virtual void SetPipelineState(ID3D12PipelineState* pPipelineState) = 0;
+        virtual void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) = 0;
+        virtual void SetDescriptorHeaps(std::span<ID3D12DescriptorHeap* const> heaps) = 0;
+        // The descriptor is a D3D12_GPU_DESCRIPTOR_HANDLE, the buffer location a GPU virtual address.
+        virtual void SetGraphicsRootDescriptorTable(UInt32 rootParameter, UInt64 baseDescriptor) = 0;
+        virtual void SetGraphicsRoot32BitConstants(UInt32 rootParameter, std::span<const UInt32> values, UInt32 destOffset) = 0;
+        virtual void SetGraphicsRootConstantBufferView(UInt32 rootParameter, UInt64 bufferLocation) = 0;
+        virtual void RSSetViewports(std::span<const Viewport> viewports) = 0;
+        virtual void RSSetScissorRects(std::span<const ScissorRect> rects) = 0;
+        virtual void IASetPrimitiveTopology(PrimitiveTopology topology) = 0;
+        virtual void IASetVertexBuffers(UInt32 startSlot, std::span<const VertexBufferView> views) = 0;
+        virtual void IASetIndexBuffer(const IndexBufferView* pView) = 0;
+        virtual void DrawInstanced(UInt32 vertexCountPerInstance, UInt32 instanceCount, UInt32 startVertexLocation,
+                                   UInt32 startInstanceLocation) = 0;
+        virtual void DrawIndexedInstanced(UInt32 indexCountPerInstance, UInt32 instanceCount, UInt32 startIndexLocation,
+                                          Int32 baseVertexLocation, UInt32 startInstanceLocation) = 0;
+    };
+}
+
+#endif // D3D12TESTS_GRAPHICSCOMMANDLIST_HPP
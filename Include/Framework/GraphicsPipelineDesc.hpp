@@ -0,0 +1,144 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_GRAPHICSPIPELINEDESC_HPP
+#define D3D12TESTS_GRAPHICSPIPELINEDESC_HPP
+
+#include "Framework/Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    // Device-independent mirror of D3D12_GRAPHICS_PIPELINE_STATE_DESC. Enumerations keep
+    // their D3D12 values; shaders and the root signature are identified by a hash of their
+    // bytecode and serialized blob, so that descriptions can be compared, hashed and stored
+    // across runs without a device.
+    inline constexpr UInt32 MaxRenderTargets = 8;
+
+    struct PipelineInputElement {
+        std::string SemanticName;
+        UInt32 SemanticIndex = 0;
+        UInt32 Format = 0;
+        UInt32 InputSlot = 0;
+        UInt32 AlignedByteOffset = 0;
+        UInt32 InputSlotClass = 0;
+        UInt32 InstanceDataStepRate = 0;
+
+        bool operator==(const PipelineInputElement&) const = default;
+    };
+
+    struct PipelineRenderTargetBlend {
+        bool BlendEnable = false;
+        bool LogicOpEnable = false;
+        UInt32 SrcBlend = 0;
+        UInt32 DestBlend = 0;
+        UInt32 BlendOp = 0;
+        UInt32 SrcBlendAlpha = 0;
+        UInt32 DestBlendAlpha = 0;
+        UInt32 BlendOpAlpha = 0;
+        UInt32 LogicOp = 0;
+        UInt8 RenderTargetWriteMask = 0;
+
+        bool operator==(const PipelineRenderTargetBlend&) const = default;
+    };
+
+    struct PipelineBlendState {
+        bool AlphaToCoverageEnable = false;
+        bool IndependentBlendEnable = false;
+        std::array<PipelineRenderTargetBlend, MaxRenderTargets> RenderTargets = {};
+
+        bool operator==(const PipelineBlendState&) const = default;
+    };
+
+    struct PipelineRasterizerState {
+        UInt32 FillMode = 0;
+        UInt32 CullMode = 0;
+        bool FrontCounterClockwise = false;
+        Int32 DepthBias = 0;
+        Float32 DepthBiasClamp = 0.0f;
+        Float32 SlopeScaledDepthBias = 0.0f;
+        bool DepthClipEnable = false;
+        bool MultisampleEnable = false;
+        bool AntialiasedLineEnable = false;
+        UInt32 ForcedSampleCount = 0;
+        UInt32 ConservativeRaster = 0;
+
+        bool operator==(const PipelineRasterizerState&) const = default;
+    };
+
+    struct PipelineStencilOp {
+        UInt32 StencilFailOp = 0;
+        UInt32 StencilDepthFailOp = 0;
+        UInt32 StencilPassOp = 0;
+        UInt32 StencilFunc = 0;
+
+        bool operator==(const PipelineStencilOp&) const = default;
+    };
+
+    struct PipelineDepthStencilState {
+        bool DepthEnable = false;
+        UInt32 DepthWriteMask = 0;
+        UInt32 DepthFunc = 0;
+        bool StencilEnable = false;
+        UInt8 StencilReadMask = 0;
+        UInt8 StencilWriteMask = 0;
+        PipelineStencilOp FrontFace;
+        PipelineStencilOp BackFace;
+
+        bool operator==(const PipelineDepthStencilState&) const = default;
+    };
+
+    struct GraphicsPipelineDesc {
+        // Zero when the stage is not used.
+        UInt64 RootSignature = 0;
+        UInt64 VS = 0;
+        UInt64 PS = 0;
+        UInt64 DS = 0;
+        UInt64 HS = 0;
+        UInt64 GS = 0;
+        std::vector<PipelineInputElement> InputLayout;
+        PipelineBlendState BlendState;
+        UInt32 SampleMask = 0;
+        PipelineRasterizerState RasterizerState;
+        PipelineDepthStencilState DepthStencilState;
+        UInt32 IBStripCutValue = 0;
+        UInt32 PrimitiveTopologyType = 0;
+        UInt32 NumRenderTargets = 0;
+        std::array<UInt32, MaxRenderTargets> RTVFormats = {};
+        UInt32 DSVFormat = 0;
+        UInt32 SampleCount = 0;
+        UInt32 SampleQuality = 0;
+        UInt32 NodeMask = 0;
+        UInt32 Flags = 0;
+
+        bool operator==(const GraphicsPipelineDesc&) const = default;
+    };
+
+    // Hash identifying shader bytecode or a serialized root signature, zero for empty blobs.
+    inline UInt64 HashBlob(const void* pData, std::size_t size);
+
+    // Clears the states the pipeline ignores (blend factors of render targets without
+    // blending, stencil operations without stencil test, unused render target formats...)
+    // and normalizes the ones with several spellings (semantic name case, signed zeros), so
+    // that equivalent descriptions compare and hash equal.
+    GraphicsPipelineDesc CanonicalizePipelineDesc(const GraphicsPipelineDesc& desc);
+    // Hash of the canonical description, stable across runs and platforms.
+    UInt64 HashPipelineDesc(const GraphicsPipelineDesc& desc);
+
+    // Appends the description in a platform-independent binary form.
+    void SerializePipelineDesc(const GraphicsPipelineDesc& desc, std::vector<std::byte>& data);
+    // Reads a description written by SerializePipelineDesc() and advances the data past it.
+    // Returns false if the data is truncated.
+    bool DeserializePipelineDesc(std::span<const std::byte>& data, GraphicsPipelineDesc& desc);
+}
+
+#include "Framework/GraphicsPipelineDesc.inl"
+
+#endif // D3D12TESTS_GRAPHICSPIPELINEDESC_HPP
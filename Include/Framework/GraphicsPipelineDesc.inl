@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include "Framework/Hash.hpp"
+
+namespace D3D12Tests {
+    inline UInt64 HashBlob(const void* pData, const std::size_t size) {
+        if (pData == nullptr || size == 0) {
+            return 0;
+        }
+
+        // Zero is reserved for "no blob".
+        const UInt64 hash = Hash64(pData, size);
+        return hash != 0 ? hash : 1;
+    }
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_HASH_HPP
+#define D3D12TESTS_HASH_HPP
+
+#include "Framework/Types.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace D3D12Tests {
+    // 64-bit non-cryptographic hash of a block of memory (XXH64), stable across runs and
+    // platforms so that it can be used to address content stored on disk.
+    inline UInt64 Hash64(const void* pData, std::size_t size, UInt64 seed = 0);
+    inline UInt64 Hash64(std::string_view string, UInt64 seed = 0);
+
+    // Mixes a value into a hash, for keys made of several parts.
+    inline constexpr UInt64 HashCombine(UInt64 hash, UInt64 value);
+}
+
+#include "Framework/Hash.inl"
+
+#endif // D3D12TESTS_HASH_HPP
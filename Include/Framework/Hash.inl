@@ -0,0 +1,110 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <bit>
+#include <cstring>
+
+namespace D3D12Tests {
+    namespace HashDetail {
+        inline constexpr UInt64 Prime1 = 0x9e3779b185ebca87ull;
+        inline constexpr UInt64 Prime2 = 0xc2b2ae3d27d4eb4full;
+        inline constexpr UInt64 Prime3 = 0x165667b19e3779f9ull;
+        inline constexpr UInt64 Prime4 = 0x85ebca77c2b2ae63ull;
+        inline constexpr UInt64 Prime5 = 0x27d4eb2f165667c5ull;
+
+        // The hash is defined on little endian loads, which every supported platform does
+        // natively. memcpy keeps them legal for unaligned data.
+        static_assert(std::endian::native == std::endian::little);
+
+        inline UInt64 Read64(const std::byte* pData) {
+            UInt64 value;
+            std::memcpy(&value, pData, sizeof(value));
+            return value;
+        }
+
+        inline UInt32 Read32(const std::byte* pData) {
+            UInt32 value;
+            std::memcpy(&value, pData, sizeof(value));
+            return value;
+        }
+
+        inline constexpr UInt64 Round(const UInt64 accumulator, const UInt64 input) {
+            return std::rotl(accumulator + input * Prime2, 31) * Prime1;
+        }
+
+        inline constexpr UInt64 MergeRound(const UInt64 accumulator, const UInt64 value) {
+            return (accumulator ^ Round(0, value)) * Prime1 + Prime4;
+        }
+
+        inline constexpr UInt64 Avalanche(UInt64 hash) {
+            hash ^= hash >> 33;
+            hash *= Prime2;
+            hash ^= hash >> 29;
+            hash *= Prime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+    }
+
+    inline UInt64 Hash64(const void* pData, const std::size_t size, const UInt64 seed) {
+        using namespace HashDetail;
+
+        const auto* p = static_cast<const std::byte*>(pData);
+        const std::byte* const pEnd = p + size;
+        UInt64 hash;
+
+        if (size >= 32) {
+            // Four independent lanes over 32-byte stripes.
+            UInt64 v1 = seed + Prime1 + Prime2;
+            UInt64 v2 = seed + Prime2;
+            UInt64 v3 = seed;
+            UInt64 v4 = seed - Prime1;
+
+            const std::byte* const pLimit = pEnd - 32;
+            do {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            } while (p <= pLimit);
+
+            hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        } else {
+            hash = seed + Prime5;
+        }
+
+        hash += static_cast<UInt64>(size);
+
+        for (; p + 8 <= pEnd; p += 8) {
+            hash ^= Round(0, Read64(p));
+            hash = std::rotl(hash, 27) * Prime1 + Prime4;
+        }
+        if (p + 4 <= pEnd) {
+            hash ^= static_cast<UInt64>(Read32(p)) * Prime1;
+            hash = std::rotl(hash, 23) * Prime2 + Prime3;
+            p += 4;
+        }
+        for (; p < pEnd; ++p) {
+            hash ^= static_cast<UInt64>(*p) * Prime5;
+            hash = std::rotl(hash, 11) * Prime1;
+        }
+
+        return Avalanche(hash);
+    }
+
+    inline UInt64 Hash64(const std::string_view string, const UInt64 seed) {
+        return Hash64(string.data(), string.size(), seed);
+    }
+
+    inline constexpr UInt64 HashCombine(const UInt64 hash, const UInt64 value) {
+        return HashDetail::Avalanche(hash ^ (value + HashDetail::Prime1 + (hash << 6) + (hash >> 2)));
+    }
+}
@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_HEADLESSAPPLICATIONBASE_HPP
+#define D3D12TESTS_HEADLESSAPPLICATIONBASE_HPP
+
+#include "Framework/ApplicationBase.hpp"
+#include "Framework/FrameStatistics.hpp"
+
+namespace D3D12Tests {
+    // Run loop without a window, for any platform, pacing the frames like the windowed one.
+    class HeadlessApplicationBase {
+    public:
+        // Initializes the application, renders the given number of frames and destroys it.
+        // The statistics cover the time from the start of a frame to the start of the next,
+        // so there is one less than there are frames.
+        static FrameStatistics Run(ApplicationBase* pApplication, UInt64 frameCount);
+    };
+}
+
+#endif // D3D12TESTS_HEADLESSAPPLICATIONBASE_HPP
@@ -0,0 +1,124 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_JOBSYSTEM_HPP
+#define D3D12TESTS_JOBSYSTEM_HPP
+
+#include "Framework/WorkStealingDeque.hpp"
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace D3D12Tests {
+    class JobSystem;
+
+    // Number of scheduled jobs that have not finished yet. Jobs can wait for counters to
+    // reach zero before starting, and threads can wait for them with JobSystem::Wait.
+    // A counter must outlive the jobs using it, and can be reused once waited for.
+    class JobCounter {
+    public:
+        JobCounter();
+        ~JobCounter() = default;
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter(JobCounter&&) = delete;
+
+        JobCounter& operator=(const JobCounter&) = delete;
+        JobCounter& operator=(JobCounter&&) = delete;
+
+        inline bool IsDone() const;
+        inline UInt32 GetValue() const;
+
+    private:
+        friend class JobSystem;
+
+        struct Job;
+
+        std::atomic<UInt32> m_Value;
+
+        // Guards the jobs waiting for this counter, and the completion of the last job.
+        std::mutex m_Mutex;
+        std::vector<Job*> m_Continuations;
+        // First exception thrown by the jobs, rethrown by JobSystem::Wait.
+        std::exception_ptr m_Exception;
+    };
+
+    // Work-stealing scheduler. Each worker thread owns a deque it pushes its jobs to and pops
+    // them from, and steals from the others when it runs out. The thread that created the
+    // system owns a deque too and runs jobs while waiting; jobs scheduled from other threads
+    // go through a shared queue.
+    class JobSystem {
+    public:
+        // The thread count includes the creating thread, zero uses one per hardware thread.
+        // Jobs scheduled on a full deque run immediately on the scheduling thread.
+        explicit JobSystem(UInt32 threadCount = 0, UInt64 queueCapacity = 4096);
+        // Jobs that have not started are dropped, wait for them first.
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        // Runs the function once all the dependencies reached zero. The signal counter is
+        // incremented now and decremented once the function returns. An exception thrown
+        // by the function is stored in the signal, or terminates without one.
+        void Schedule(std::function<void()> function, JobCounter* pSignal = nullptr,
+                      std::span<JobCounter* const> dependencies = {});
+
+        // Runs jobs until the counter reaches zero, then rethrows the first exception of
+        // its jobs, if any.
+        void Wait(JobCounter& counter);
+
+        // Same contract as the free ParallelFor, with the ranges running as jobs. One range
+        // per command list lets each job record its own list.
+        void ParallelFor(UInt64 size, UInt32 rangeCount, const std::function<void(UInt64, UInt64)>& function);
+
+        // Including the creating thread.
+        inline UInt32 GetThreadCount() const;
+        // Index of the calling thread in [0, GetThreadCount()), or GetThreadCount() for the
+        // threads that are not part of the system. Per-thread data can be indexed with it.
+        UInt32 GetThreadIndex() const;
+
+        inline UInt64 GetExecutedCount() const;
+        inline UInt64 GetStolenCount() const;
+
+    private:
+        using Job = JobCounter::Job;
+
+        void Submit(Job* pJob);
+        void Run(Job* pJob);
+        void Finish(JobCounter& counter, std::exception_ptr exception);
+        bool TryRunJob(UInt32 threadIndex);
+        Job* FindJob(UInt32 threadIndex);
+        void WorkerMain(UInt32 threadIndex);
+
+        std::vector<std::unique_ptr<WorkStealingDeque<Job>>> m_Deques;
+        std::vector<std::jthread> m_Workers;
+
+        std::mutex m_SharedMutex;
+        std::deque<Job*> m_SharedJobs;
+        std::atomic<UInt64> m_SharedJobCount;
+
+        // Bumped on every submission, idle workers sleep until it changes.
+        std::atomic<UInt32> m_WorkEpoch;
+        std::atomic<UInt32> m_SleepingCount;
+        std::atomic<bool> m_Stopping;
+
+        std::atomic<UInt64> m_ExecutedCount;
+        std::atomic<UInt64> m_StolenCount;
+    };
+}
+
+#include "Framework/JobSystem.inl"
+
+#endif // D3D12TESTS_JOBSYSTEM_HPP
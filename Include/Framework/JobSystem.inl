@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline bool JobCounter::IsDone() const {
+        return m_Value.load(std::memory_order_acquire) == 0;
+    }
+
+    inline UInt32 JobCounter::GetValue() const {
+        return m_Value.load(std::memory_order_acquire);
+    }
+
+    inline UInt32 JobSystem::GetThreadCount() const {
+        return static_cast<UInt32>(m_Deques.size());
+    }
+
+    inline UInt64 JobSystem::GetExecutedCount() const {
+        return m_ExecutedCount.load(std::memory_order_relaxed);
+    }
+
+    inline UInt64 JobSystem::GetStolenCount() const {
+        return m_StolenCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_LINEARALLOCATOR_HPP
+#define D3D12TESTS_LINEARALLOCATOR_HPP
+
+#include "Framework/Types.hpp"
+
+#include <memory>
+
+namespace D3D12Tests {
+    // Bump allocator over a fixed block of CPU memory. Individual allocations are never
+    // freed, the whole block is recycled at once with Reset().
+    class LinearAllocator {
+    public:
+        explicit LinearAllocator(std::size_t capacity = 0);
+        ~LinearAllocator() = default;
+
+        LinearAllocator(const LinearAllocator&) = delete;
+        LinearAllocator(LinearAllocator&&) noexcept = default;
+
+        LinearAllocator& operator=(const LinearAllocator&) = delete;
+        LinearAllocator& operator=(LinearAllocator&&) noexcept = default;
+
+        // Returns nullptr when the remaining capacity cannot hold the allocation.
+        // The alignment must be a power of two.
+        void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        template <class T>
+        T* AllocateArray(std::size_t count);
+
+        inline void Reset();
+
+        inline std::size_t GetCapacity() const;
+        inline std::size_t GetUsedSize() const;
+
+    private:
+        std::unique_ptr<std::byte[]> m_Memory;
+        std::size_t m_Capacity;
+        std::size_t m_Offset;
+    };
+}
+
+#include "Framework/LinearAllocator.inl"
+
+#endif // D3D12TESTS_LINEARALLOCATOR_HPP
@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    template <class T>
+    T* LinearAllocator::AllocateArray(const std::size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    inline void LinearAllocator::Reset() {
+        m_Offset = 0;
+    }
+
+    inline std::size_t LinearAllocator::GetCapacity() const {
+        return m_Capacity;
+    }
+
+    inline std::size_t LinearAllocator::GetUsedSize() const {
+        return m_Offset;
+    }
+}
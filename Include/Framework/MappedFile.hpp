@@ -0,0 +1,69 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MAPPEDFILE_HPP
+#define D3D12TESTS_MAPPEDFILE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+namespace D3D12Tests {
+    enum class MappedFileMode {
+        Read,
+        // Creates the file if it does not exist.
+        ReadWrite
+    };
+
+    // File mapped in memory in its entirety, with file mappings on Windows and mmap()
+    // elsewhere. Empty files are opened but not mapped, their data pointer is null.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const std::filesystem::path& path, MappedFileMode mode);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        void Open(const std::filesystem::path& path, MappedFileMode mode);
+        void Close();
+
+        // Changes the size of a file opened for writing and maps it again, which moves the data.
+        // On failure the file keeps its size and its mapping.
+        void Resize(UInt64 size);
+        // Writes the modified pages back to the file.
+        void Flush();
+
+        inline std::byte* GetData();
+        inline const std::byte* GetData() const;
+        inline UInt64 GetSize() const;
+        inline MappedFileMode GetMode() const;
+        inline bool IsOpen() const;
+
+    private:
+        void Map();
+        void Unmap();
+
+        std::byte* m_Data = nullptr;
+        UInt64 m_Size = 0;
+        MappedFileMode m_Mode = MappedFileMode::Read;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#else
+        int m_File = -1;
+#endif
+    };
+}
+
+#include "Framework/MappedFile.inl"
+
+#endif // D3D12TESTS_MAPPEDFILE_HPP
@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline std::byte* MappedFile::GetData() {
+        return m_Data;
+    }
+
+    inline const std::byte* MappedFile::GetData() const {
+        return m_Data;
+    }
+
+    inline UInt64 MappedFile::GetSize() const {
+        return m_Size;
+    }
+
+    inline MappedFileMode MappedFile::GetMode() const {
+        return m_Mode;
+    }
+
+    inline bool MappedFile::IsOpen() const {
+#ifdef _WIN32
+        return m_File != nullptr;
+#else
+        return m_File != -1;
+#endif
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MESHDATA_HPP
+#define D3D12TESTS_MESHDATA_HPP
+
+#include "Framework/MeshFormat.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    // Vertices of one attribute, Stride bytes apart.
+    struct MeshStream {
+        MeshSemantic Semantic = MeshSemantic::Position;
+        UInt32 SemanticIndex = 0;
+        UInt32 Format = 0;
+        UInt32 Stride = 0;
+        std::vector<std::byte> Data;
+    };
+
+    struct MeshSubmesh {
+        std::string Name;
+        UInt32 MaterialIndex = 0;
+        // Index ranges from the most detailed level to the coarsest.
+        std::vector<MeshLodDesc> Lods;
+        Float32 BoundsMin[3] = {};
+        Float32 BoundsMax[3] = {};
+    };
+
+    // Mesh being built or converted, written to a .mesh file with SaveMeshFile.
+    struct MeshData {
+        UInt32 VertexCount = 0;
+        std::vector<MeshStream> Streams;
+        std::vector<UInt32> Indices;
+        std::vector<MeshSubmesh> Submeshes;
+        Float32 BoundsMin[3] = {};
+        Float32 BoundsMax[3] = {};
+
+        // Returns nullptr if the mesh has no such stream.
+        inline MeshStream* FindStream(MeshSemantic semantic, UInt32 semanticIndex = 0);
+        inline const MeshStream* FindStream(MeshSemantic semantic, UInt32 semanticIndex = 0) const;
+    };
+
+    // HLSL semantic name of the attribute, e.g. TEXCOORD.
+    const char* GetMeshSemanticName(MeshSemantic semantic);
+
+    // Computes the bounds of the mesh and of its submeshes from the vertices referenced by
+    // their most detailed level. The positions must be in DxgiFormat::R32G32B32Float, and the
+    // mesh must pass ValidateMeshData.
+    void ComputeMeshBounds(MeshData& mesh);
+
+    // Checks that the streams and the index ranges are consistent, throws std::invalid_argument
+    // otherwise. Also checks every index, which the loader does not.
+    void ValidateMeshData(const MeshData& mesh);
+
+    // Writes the mesh in the .mesh format, with 16-bit indices when they all fit. Writes to a
+    // temporary file renamed over the destination. Throws std::invalid_argument for meshes
+    // that do not pass ValidateMeshData and std::runtime_error if the file cannot be written.
+    void SaveMeshFile(const MeshData& mesh, const std::filesystem::path& path);
+}
+
+#include "Framework/MeshData.inl"
+
+#endif // D3D12TESTS_MESHDATA_HPP
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline MeshStream* MeshData::FindStream(const MeshSemantic semantic, const UInt32 semanticIndex) {
+        for (MeshStream& stream : Streams) {
+            if (stream.Semantic == semantic && stream.SemanticIndex == semanticIndex) {
+                return &stream;
+            }
+        }
+
+        return nullptr;
+    }
+
+    inline const MeshStream* MeshData::FindStream(const MeshSemantic semantic, const UInt32 semanticIndex) const {
+        for (const MeshStream& stream : Streams) {
+            if (stream.Semantic == semantic && stream.SemanticIndex == semanticIndex) {
+                return &stream;
+            }
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,68 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MESHFILE_HPP
+#define D3D12TESTS_MESHFILE_HPP
+
+#include "Framework/MappedFile.hpp"
+#include "Framework/MeshFormat.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace D3D12Tests {
+    // .mesh file memory-mapped in its entirety (see MeshFormat.hpp). Only the header and the
+    // tables are read and checked, the vertices and indices are never touched by the CPU:
+    // GetGeometryData() is uploaded as it is. Throws std::runtime_error for files that are
+    // malformed or truncated; the indices themselves are not checked.
+    class MeshFile {
+    public:
+        explicit MeshFile(const std::filesystem::path& path);
+        ~MeshFile() = default;
+
+        MeshFile(const MeshFile&) = delete;
+        MeshFile(MeshFile&&) noexcept = default;
+
+        MeshFile& operator=(const MeshFile&) = delete;
+        MeshFile& operator=(MeshFile&&) noexcept = default;
+
+        // Streams and indices, in the layout of a buffer holding them all.
+        inline std::span<const std::byte> GetGeometryData() const;
+        inline std::span<const std::byte> GetStreamData(const MeshStreamDesc& stream) const;
+        inline std::span<const std::byte> GetIndexData() const;
+
+        inline std::span<const MeshStreamDesc> GetStreams() const;
+        // Returns nullptr if the mesh has no such stream.
+        const MeshStreamDesc* FindStream(MeshSemantic semantic, UInt32 semanticIndex = 0) const;
+
+        inline std::span<const MeshSubmeshDesc> GetSubmeshes() const;
+        inline std::span<const MeshLodDesc> GetLods(const MeshSubmeshDesc& submesh) const;
+        inline std::string_view GetName(const MeshSubmeshDesc& submesh) const;
+
+        inline const MeshFileHeader& GetHeader() const;
+        inline UInt32 GetVertexCount() const;
+        inline UInt32 GetIndexCount() const;
+        inline UInt32 GetIndexFormat() const;
+        inline UInt32 GetIndexStride() const;
+        inline UInt64 GetFileSize() const;
+
+    private:
+        void ReadHeader();
+        void ReadTables();
+
+        MappedFile m_File;
+        MeshFileHeader m_Header;
+        std::vector<MeshStreamDesc> m_Streams;
+        std::vector<MeshSubmeshDesc> m_Submeshes;
+        std::vector<MeshLodDesc> m_Lods;
+    };
+}
+
+#include "Framework/MeshFile.inl"
+
+#endif // D3D12TESTS_MESHFILE_HPP
@@ -0,0 +1,61 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <algorithm>
+
+namespace D3D12Tests {
+    inline std::span<const std::byte> MeshFile::GetGeometryData() const {
+        return {m_File.GetData() + m_Header.GeometryOffset, m_Header.GeometrySize};
+    }
+
+    inline std::span<const std::byte> MeshFile::GetStreamData(const MeshStreamDesc& stream) const {
+        return GetGeometryData().subspan(stream.Offset, stream.Size);
+    }
+
+    inline std::span<const std::byte> MeshFile::GetIndexData() const {
+        return GetGeometryData().subspan(m_Header.IndexOffset, UInt64(m_Header.IndexCount) * GetIndexStride());
+    }
+
+    inline std::span<const MeshStreamDesc> MeshFile::GetStreams() const {
+        return m_Streams;
+    }
+
+    inline std::span<const MeshSubmeshDesc> MeshFile::GetSubmeshes() const {
+        return m_Submeshes;
+    }
+
+    inline std::span<const MeshLodDesc> MeshFile::GetLods(const MeshSubmeshDesc& submesh) const {
+        return std::span<const MeshLodDesc>(m_Lods).subspan(submesh.FirstLod, submesh.LodCount);
+    }
+
+    inline std::string_view MeshFile::GetName(const MeshSubmeshDesc& submesh) const {
+        return {submesh.Name, static_cast<std::size_t>(std::find(submesh.Name, submesh.Name + MeshNameSize, '\0') - submesh.Name)};
+    }
+
+    inline const MeshFileHeader& MeshFile::GetHeader() const {
+        return m_Header;
+    }
+
+    inline UInt32 MeshFile::GetVertexCount() const {
+        return m_Header.VertexCount;
+    }
+
+    inline UInt32 MeshFile::GetIndexCount() const {
+        return m_Header.IndexCount;
+    }
+
+    inline UInt32 MeshFile::GetIndexFormat() const {
+        return m_Header.IndexFormat;
+    }
+
+    inline UInt32 MeshFile::GetIndexStride() const {
+        return m_Header.IndexFormat == DxgiFormat::R16Uint ? 2 : 4;
+    }
+
+    inline UInt64 MeshFile::GetFileSize() const {
+        return m_File.GetSize();
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MESHFORMAT_HPP
+#define D3D12TESTS_MESHFORMAT_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    // Layout of a .mesh file, in little-endian order:
+    //   MeshFileHeader
+    //   MeshStreamDesc[StreamCount]
+    //   MeshSubmeshDesc[SubmeshCount]
+    //   MeshLodDesc[LodCount]
+    //   Geometry: the vertices of each stream, then the indices.
+    // The geometry is stored the way the GPU reads it, one non-interleaved vertex buffer per
+    // stream. A loader copies the whole block to a buffer in one go and points the vertex and
+    // index buffer views at the offsets given by the tables.
+    inline constexpr UInt32 MeshFileMagic = 0x48534D44; // "DMSH"
+    inline constexpr UInt32 MeshFileVersion = 1;
+    // Alignment of the geometry block and of each stream in it, from the start of the file.
+    inline constexpr UInt64 MeshDataAlignment = 64;
+    inline constexpr UInt32 MeshNameSize = 32;
+
+    enum class MeshSemantic : UInt32 {
+        Position,
+        Normal,
+        Tangent,
+        TexCoord,
+        Color
+    };
+
+    struct MeshFileHeader {
+        UInt32 Magic;
+        UInt32 Version;
+        UInt32 StreamCount;
+        UInt32 SubmeshCount;
+        UInt32 LodCount;
+        UInt32 VertexCount;
+        UInt32 IndexCount;
+        // DxgiFormat::R16Uint or DxgiFormat::R32Uint.
+        UInt32 IndexFormat;
+        // From the start of the file; the offsets of the streams and of the indices are from
+        // the start of the geometry. The indices start at a multiple of their size.
+        UInt64 GeometryOffset;
+        UInt64 GeometrySize;
+        UInt64 IndexOffset;
+        Float32 BoundsMin[3];
+        Float32 BoundsMax[3];
+        UInt32 Reserved[12];
+    };
+
+    struct MeshStreamDesc {
+        MeshSemantic Semantic;
+        UInt32 SemanticIndex;
+        // DXGI_FORMAT of the attribute, and the distance between two vertices.
+        UInt32 Format;
+        UInt32 Stride;
+        UInt64 Offset;
+        UInt64 Size;
+    };
+
+    // Part of the mesh drawn with one material, with its levels of detail from the most
+    // detailed to the coarsest.
+    struct MeshSubmeshDesc {
+        // Null-terminated, truncated to fit.
+        char Name[MeshNameSize];
+        UInt32 MaterialIndex;
+        UInt32 FirstLod;
+        UInt32 LodCount;
+        UInt32 Reserved;
+        Float32 BoundsMin[3];
+        Float32 BoundsMax[3];
+    };
+
+    // One DrawIndexedInstanced: the indices are relative to BaseVertex and lower than
+    // VertexCount.
+    struct MeshLodDesc {
+        UInt32 FirstIndex;
+        UInt32 IndexCount;
+        UInt32 BaseVertex;
+        UInt32 VertexCount;
+        // Geometric error of the level against the most detailed one, in mesh units.
+        Float32 Error;
+        UInt32 Reserved;
+    };
+
+    static_assert(sizeof(MeshFileHeader) == 128);
+    static_assert(sizeof(MeshStreamDesc) == 32);
+    static_assert(sizeof(MeshSubmeshDesc) == 72);
+    static_assert(sizeof(MeshLodDesc) == 24);
+}
+
+#endif // D3D12TESTS_MESHFORMAT_HPP
@@ -0,0 +1,105 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MESHOPTIMIZER_HPP
+#define D3D12TESTS_MESHOPTIMIZER_HPP
+
+#include "Framework/MeshData.hpp"
+
+#include <span>
+
+namespace D3D12Tests {
+    enum class VertexCacheAlgorithm : UInt8 {
+        // Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw":
+        // linear time, tuned for the FIFO cache size of the options.
+        Tipsify,
+        // Forsyth, "Linear-Speed Vertex Cache Optimisation": scores the vertices of a simulated
+        // 32-entry LRU cache, slower but less dependent on the cache size.
+        Forsyth
+    };
+
+    struct MeshOptimizeOptions {
+        VertexCacheAlgorithm CacheAlgorithm = VertexCacheAlgorithm::Tipsify;
+        // Entries of the FIFO post-transform cache the orders are tuned for and simulated with.
+        UInt32 CacheSize = 16;
+        // Sorts clusters of triangles front to back, from the outside of the mesh in, letting
+        // the ACMR of each cluster grow up to this factor over the cache-optimized one.
+        bool OptimizeOverdraw = true;
+        Float32 OverdrawThreshold = 1.05f;
+        // Merges the vertices closer than the distance in position and equal in the other
+        // streams. A distance of zero only merges identical vertices.
+        bool WeldVertices = true;
+        Float32 WeldDistance = 0.0f;
+        // Zero uses one thread per hardware thread. The triangles of large index ranges are
+        // split in chunks optimized independently: with the default, only ranges of a million
+        // triangles or more use several threads.
+        UInt32 ThreadCount = 0;
+        UInt64 MinTrianglesPerThread = 512 * 1024;
+    };
+
+    // Post-transform cache behavior of an index buffer, simulated with a FIFO cache.
+    struct VertexCacheStatistics {
+        UInt64 TriangleCount = 0;
+        // Distinct vertices referenced by the triangles.
+        UInt64 VertexCount = 0;
+        // Cache misses, each vertex shader invocation.
+        UInt64 TransformCount = 0;
+        // Average cache miss ratio, vertex shader invocations per triangle: 3 at worst, close
+        // to 0.5 for large regular meshes.
+        Float64 Acmr = 0.0;
+        // Average transform to vertex ratio, vertex shader invocations per distinct vertex: 1 at
+        // best, which is independent of the topology.
+        Float64 Atvr = 0.0;
+    };
+
+    // Vertex fetch behavior of an index buffer over one stream, simulated with a small cache
+    // of 64-byte lines.
+    struct VertexFetchStatistics {
+        UInt64 BytesFetched = 0;
+        // Bytes fetched over the bytes of the distinct vertices referenced, 1 at best.
+        Float64 Overfetch = 0.0;
+    };
+
+    struct MeshOptimizeReport {
+        UInt32 VertexCountBefore = 0;
+        UInt32 VertexCountAfter = 0;
+        // Over all the levels of detail, each simulated from an empty cache, and over the
+        // position stream for the fetches.
+        VertexCacheStatistics CacheBefore;
+        VertexCacheStatistics CacheAfter;
+        VertexFetchStatistics FetchBefore;
+        VertexFetchStatistics FetchAfter;
+    };
+
+    // Index buffers of triangle lists, with indices lower than vertexCount.
+    VertexCacheStatistics AnalyzeVertexCache(std::span<const UInt32> indices, UInt32 vertexCount, UInt32 cacheSize = 16);
+    VertexFetchStatistics AnalyzeVertexFetch(std::span<const UInt32> indices, UInt32 vertexCount, UInt32 vertexStride);
+
+    // Reorders the triangles for the post-transform cache, in place.
+    void OptimizeVertexCache(std::span<UInt32> indices, UInt32 vertexCount, const MeshOptimizeOptions& options = {});
+
+    // Reorders the clusters of triangles of a cache-optimized index buffer to reduce overdraw,
+    // in place. The positions are R32G32B32_FLOAT, positionStride bytes apart.
+    void OptimizeOverdraw(std::span<UInt32> indices, std::span<const std::byte> positions, UInt32 positionStride,
+                          const MeshOptimizeOptions& options = {});
+
+    // Reorders the vertices of the mesh in the order the levels of detail first use them,
+    // dropping the unused ones, and rebases each level on the lowest vertex it uses.
+    void OptimizeVertexFetch(MeshData& mesh);
+
+    // Merges duplicate vertices through a hash grid of cells of the weld distance, then drops
+    // the unused vertices. Needs R32G32B32_FLOAT positions. Returns the number of vertices
+    // removed.
+    UInt32 WeldVertices(MeshData& mesh, Float32 distance = 0.0f);
+
+    // Welds, then optimizes each level of detail for the vertex cache and overdraw, then the
+    // vertex order for fetches. The levels must not share indices. Throws
+    // std::invalid_argument for meshes that do not pass ValidateMeshData or lack
+    // R32G32B32_FLOAT positions.
+    MeshOptimizeReport OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options = {});
+}
+
+#endif // D3D12TESTS_MESHOPTIMIZER_HPP
@@ -0,0 +1,107 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_MESHLETBUILDER_HPP
+#define D3D12TESTS_MESHLETBUILDER_HPP
+
+#include "Framework/MeshData.hpp"
+
+#include <span>
+#include <vector>
+
+namespace D3D12Tests {
+    // D3D12 limits of the output of a mesh shader group.
+    inline constexpr UInt32 MaxMeshletVertices = 256;
+    inline constexpr UInt32 MaxMeshletPrimitives = 256;
+
+    struct MeshletBuildOptions {
+        // 64 vertices and 124 primitives fill the groups of most mesh shader implementations.
+        UInt32 MaxVertices = 64;
+        UInt32 MaxPrimitives = 124;
+        // Zero uses one thread per hardware thread. Each thread builds whole meshes.
+        UInt32 ThreadCount = 0;
+    };
+
+    // Ranges of MeshletData::VertexIndices and MeshletData::PrimitiveIndices.
+    struct Meshlet {
+        UInt32 VertexOffset = 0;
+        UInt32 VertexCount = 0;
+        UInt32 PrimitiveOffset = 0;
+        UInt32 PrimitiveCount = 0;
+    };
+
+    // A sphere around the vertices of the meshlet and a cone around the normals of its
+    // triangles. The meshlet faces away from any camera in the cone of apex ConeApex, axis
+    // -ConeAxis and half angle acos(ConeCutoff), see IsMeshletBackfacing. A cutoff of 1 never
+    // culls, for normals spread over about a half sphere or more.
+    struct MeshletBounds {
+        Float32 Center[3] = {};
+        Float32 Radius = 0.0f;
+        Float32 ConeApex[3] = {};
+        Float32 ConeAxis[3] = {0.0f, 0.0f, 1.0f};
+        Float32 ConeCutoff = 1.0f;
+    };
+
+    // Meshlets of one level of detail of a submesh.
+    struct MeshletRange {
+        UInt32 Submesh = 0;
+        UInt32 Lod = 0;
+        UInt32 MeshletOffset = 0;
+        UInt32 MeshletCount = 0;
+    };
+
+    // Arrays ready for upload as structured buffers.
+    struct MeshletData {
+        std::vector<Meshlet> Meshlets;
+        // One per meshlet.
+        std::vector<MeshletBounds> Bounds;
+        // Vertices of the meshlets, as indices of the vertex buffer.
+        std::vector<UInt32> VertexIndices;
+        // One per triangle, see PackMeshletTriangle.
+        std::vector<UInt32> PrimitiveIndices;
+        // Only filled for meshes, in the order of their submeshes and levels.
+        std::vector<MeshletRange> Ranges;
+    };
+
+    struct MeshletStatistics {
+        UInt64 MeshletCount = 0;
+        UInt64 TriangleCount = 0;
+        // Average vertices and primitives per meshlet over the maximums, 1 at best.
+        Float64 VertexFill = 0.0;
+        Float64 PrimitiveFill = 0.0;
+        // Meshlet vertices per triangle, the vertex shading cost like the ACMR of an index
+        // buffer: shared vertices are shaded once per meshlet using them.
+        Float64 VerticesPerTriangle = 0.0;
+    };
+
+    // Three indices into the vertices of the meshlet, 10 bits each like the D3D12 samples.
+    inline UInt32 PackMeshletTriangle(UInt32 a, UInt32 b, UInt32 c);
+    inline void UnpackMeshletTriangle(UInt32 packed, UInt32 (&vertices)[3]);
+
+    // The normal cone test: whether all the triangles face away from the camera.
+    inline bool IsMeshletBackfacing(const MeshletBounds& bounds, const Float32 (&cameraPosition)[3]);
+
+    // Splits a triangle list in meshlets of neighboring triangles. Each meshlet starts next to
+    // the previous one and grows by the triangles adding the fewest vertices or finishing
+    // one, then by the closest to its center. The positions are
+    // R32G32B32_FLOAT, positionStride bytes apart. Throws std::invalid_argument for limits out
+    // of [3, 256] vertices or [1, 256] primitives, or indices out of the vertices.
+    MeshletData BuildMeshlets(std::span<const UInt32> indices, std::span<const std::byte> positions, UInt32 positionStride,
+                              UInt32 vertexCount, const MeshletBuildOptions& options = {});
+
+    // Meshlets of every level of every submesh, with the base vertices added to the vertex
+    // indices. Throws std::invalid_argument for meshes that do not pass ValidateMeshData or
+    // lack R32G32B32_FLOAT positions.
+    MeshletData BuildMeshlets(const MeshData& mesh, const MeshletBuildOptions& options = {});
+    // The meshes are built in parallel.
+    std::vector<MeshletData> BuildMeshlets(std::span<const MeshData> meshes, const MeshletBuildOptions& options = {});
+
+    MeshletStatistics AnalyzeMeshlets(const MeshletData& meshlets, const MeshletBuildOptions& options = {});
+}
+
+#include "Framework/MeshletBuilder.inl"
+
+#endif // D3D12TESTS_MESHLETBUILDER_HPP
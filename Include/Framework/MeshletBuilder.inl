@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <cmath>
+
+namespace D3D12Tests {
+    inline UInt32 PackMeshletTriangle(const UInt32 a, const UInt32 b, const UInt32 c) {
+        return (a & 0x3FF) | (b & 0x3FF) << 10 | (c & 0x3FF) << 20;
+    }
+
+    inline void UnpackMeshletTriangle(const UInt32 packed, UInt32 (&vertices)[3]) {
+        vertices[0] = packed & 0x3FF;
+        vertices[1] = (packed >> 10) & 0x3FF;
+        vertices[2] = (packed >> 20) & 0x3FF;
+    }
+
+    inline bool IsMeshletBackfacing(const MeshletBounds& bounds, const Float32 (&cameraPosition)[3]) {
+        const Float32 x = bounds.ConeApex[0] - cameraPosition[0];
+        const Float32 y = bounds.ConeApex[1] - cameraPosition[1];
+        const Float32 z = bounds.ConeApex[2] - cameraPosition[2];
+        const Float32 projection = x * bounds.ConeAxis[0] + y * bounds.ConeAxis[1] + z * bounds.ConeAxis[2];
+
+        return bounds.ConeCutoff < 1.0f && projection >= bounds.ConeCutoff * std::sqrt(x * x + y * y + z * z);
+    }
+}
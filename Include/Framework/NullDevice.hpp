@@ -0,0 +1,224 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_NULLDEVICE_HPP
+#define D3D12TESTS_NULLDEVICE_HPP
+
+#include "Framework/SimulatedGpuTimeline.hpp"
+
+#include <array>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    // Device backend that executes nothing: it mirrors the D3D12 objects the samples use,
+    // counts the API calls, enforces the rules the debug layer would (closed lists,
+    // allocators still in use by the GPU...) by throwing std::logic_error, and completes
+    // fences after a simulated GPU time. Runs on any platform, for tests and benchmarks.
+    enum class NullApiCall : UInt8 {
+        CreateCommandQueue,
+        CreateCommandAllocator,
+        CreateCommandList,
+        CreateSwapChain,
+        ResetCommandAllocator,
+        ResetCommandList,
+        CloseCommandList,
+        ResourceBarrier,
+        ClearRenderTargetView,
+        SetPipelineState,
+        SetGraphicsRootSignature,
+        SetViewports,
+        SetScissorRects,
+        SetVertexBuffers,
+        DrawInstanced,
+        CopyBufferRegion,
+        ExecuteCommandLists,
+        Signal,
+        WaitForFence,
+        Present,
+
+        Count
+    };
+
+    const char* GetNullApiCallName(NullApiCall call);
+
+    class NullDevice;
+
+    // Fence of a null queue, on a SimulatedGpuTimeline.
+    class NullGpuTimeline final : public GpuTimeline {
+    public:
+        NullGpuTimeline(NullDevice& device, SimulatedGpuTimeline::Clock::duration submissionDuration);
+        ~NullGpuTimeline() override = default;
+
+        NullGpuTimeline(const NullGpuTimeline&) = delete;
+        NullGpuTimeline(NullGpuTimeline&&) = delete;
+
+        NullGpuTimeline& operator=(const NullGpuTimeline&) = delete;
+        NullGpuTimeline& operator=(NullGpuTimeline&&) = delete;
+
+        UInt64 Signal() override;
+        UInt64 GetCompletedValue() override;
+        void WaitForValue(UInt64 value) override;
+
+        inline SimulatedGpuTimeline& GetSimulatedTimeline();
+
+    private:
+        NullDevice& m_Device;
+        SimulatedGpuTimeline m_Timeline;
+    };
+
+    class NullCommandAllocator {
+    public:
+        explicit NullCommandAllocator(NullDevice& device);
+        ~NullCommandAllocator() = default;
+
+        NullCommandAllocator(const NullCommandAllocator&) = delete;
+        NullCommandAllocator(NullCommandAllocator&&) = delete;
+
+        NullCommandAllocator& operator=(const NullCommandAllocator&) = delete;
+        NullCommandAllocator& operator=(NullCommandAllocator&&) = delete;
+
+        // Throws while a list records into it, or while its last submission is executing.
+        // The lists recorded into it before cannot be executed anymore.
+        void Reset();
+
+    private:
+        friend class NullCommandList;
+        friend class NullCommandQueue;
+
+        NullDevice& m_Device;
+        bool m_IsRecording;
+        // Set by the queue: the allocator is in use until the next signal completes.
+        GpuTimeline* m_pTimeline;
+        UInt64 m_FenceValue;
+        UInt64 m_ResetCount;
+    };
+
+    class NullCommandList {
+    public:
+        // Created in the recording state, like ID3D12GraphicsCommandList.
+        NullCommandList(NullDevice& device, NullCommandAllocator& allocator);
+        ~NullCommandList() = default;
+
+        NullCommandList(const NullCommandList&) = delete;
+        NullCommandList(NullCommandList&&) = delete;
+
+        NullCommandList& operator=(const NullCommandList&) = delete;
+        NullCommandList& operator=(NullCommandList&&) = delete;
+
+        void Reset(NullCommandAllocator& allocator);
+        void Close();
+
+        // Recording throws once the list is closed.
+        void ResourceBarrier(UInt32 barrierCount);
+        void ClearRenderTargetView();
+        void SetPipelineState();
+        void SetGraphicsRootSignature();
+        void SetViewports(UInt32 viewportCount);
+        void SetScissorRects(UInt32 rectCount);
+        void SetVertexBuffers(UInt32 viewCount);
+        void DrawInstanced(UInt32 vertexCount, UInt32 instanceCount);
+        void CopyBufferRegion(UInt64 size);
+
+        inline bool IsClosed() const;
+        // Commands recorded since the last reset.
+        inline std::span<const NullApiCall> GetCommands() const;
+
+    private:
+        friend class NullCommandQueue;
+
+        void Record(NullApiCall call);
+
+        NullDevice& m_Device;
+        NullCommandAllocator* m_pAllocator;
+        // Reset count of the allocator when the list was reset onto it.
+        UInt64 m_AllocatorResetCount;
+        std::vector<NullApiCall> m_Commands;
+        bool m_IsClosed;
+    };
+
+    class NullCommandQueue {
+    public:
+        // Each signal completes after the previous one, plus the submission duration.
+        NullCommandQueue(NullDevice& device, SimulatedGpuTimeline::Clock::duration submissionDuration);
+        ~NullCommandQueue() = default;
+
+        NullCommandQueue(const NullCommandQueue&) = delete;
+        NullCommandQueue(NullCommandQueue&&) = delete;
+
+        NullCommandQueue& operator=(const NullCommandQueue&) = delete;
+        NullCommandQueue& operator=(NullCommandQueue&&) = delete;
+
+        // Throws if a list is still open, or if its allocator was reset since it was recorded.
+        void ExecuteCommandLists(std::span<NullCommandList* const> commandLists);
+
+        inline NullGpuTimeline& GetTimeline();
+        inline UInt64 GetExecutedCommandCount() const;
+
+    private:
+        NullDevice& m_Device;
+        NullGpuTimeline m_Timeline;
+        UInt64 m_ExecutedCommandCount;
+    };
+
+    // Presents immediately, without any vertical synchronization.
+    class NullSwapChain {
+    public:
+        NullSwapChain(NullDevice& device, UInt32 bufferCount);
+        ~NullSwapChain() = default;
+
+        NullSwapChain(const NullSwapChain&) = delete;
+        NullSwapChain(NullSwapChain&&) = delete;
+
+        NullSwapChain& operator=(const NullSwapChain&) = delete;
+        NullSwapChain& operator=(NullSwapChain&&) = delete;
+
+        void Present(UInt32 syncInterval);
+
+        inline UInt32 GetBufferCount() const;
+        inline UInt32 GetCurrentBackBufferIndex() const;
+
+    private:
+        NullDevice& m_Device;
+        UInt32 m_BufferCount;
+        UInt32 m_BackBufferIndex;
+    };
+
+    class NullDevice {
+    public:
+        NullDevice();
+        ~NullDevice() = default;
+
+        NullDevice(const NullDevice&) = delete;
+        NullDevice(NullDevice&&) = delete;
+
+        NullDevice& operator=(const NullDevice&) = delete;
+        NullDevice& operator=(NullDevice&&) = delete;
+
+        std::unique_ptr<NullCommandQueue> CreateCommandQueue(
+            SimulatedGpuTimeline::Clock::duration submissionDuration = SimulatedGpuTimeline::Clock::duration::zero());
+        std::unique_ptr<NullCommandAllocator> CreateCommandAllocator();
+        std::unique_ptr<NullCommandList> CreateCommandList(NullCommandAllocator& allocator);
+        std::unique_ptr<NullSwapChain> CreateSwapChain(UInt32 bufferCount);
+
+        // Thread-safe.
+        inline void RecordCall(NullApiCall call);
+        inline UInt64 GetCallCount(NullApiCall call) const;
+        UInt64 GetTotalCallCount() const;
+        void ResetCallCounts();
+        // One "Name: count" line per call made at least once.
+        std::string FormatCallCounts() const;
+
+    private:
+        std::array<std::atomic<UInt64>, static_cast<size_t>(NullApiCall::Count)> m_CallCounts;
+    };
+}
+
+#include "Framework/NullDevice.inl"
+
+#endif // D3D12TESTS_NULLDEVICE_HPP
@@ -0,0 +1,43 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline SimulatedGpuTimeline& NullGpuTimeline::GetSimulatedTimeline() {
+        return m_Timeline;
+    }
+
+    inline bool NullCommandList::IsClosed() const {
+        return m_IsClosed;
+    }
+
+    inline std::span<const NullApiCall> NullCommandList::GetCommands() const {
+        return m_Commands;
+    }
+
+    inline NullGpuTimeline& NullCommandQueue::GetTimeline() {
+        return m_Timeline;
+    }
+
+    inline UInt64 NullCommandQueue::GetExecutedCommandCount() const {
+        return m_ExecutedCommandCount;
+    }
+
+    inline UInt32 NullSwapChain::GetBufferCount() const {
+        return m_BufferCount;
+    }
+
+    inline UInt32 NullSwapChain::GetCurrentBackBufferIndex() const {
+        return m_BackBufferIndex;
+    }
+
+    inline void NullDevice::RecordCall(const NullApiCall call) {
+        m_CallCounts[static_cast<size_t>(call)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline UInt64 NullDevice::GetCallCount(const NullApiCall call) const {
+        return m_CallCounts[static_cast<size_t>(call)].load(std::memory_order_relaxed);
+    }
+}
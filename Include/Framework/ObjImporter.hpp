@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_OBJIMPORTER_HPP
+#define D3D12TESTS_OBJIMPORTER_HPP
+
+#include "Framework/MeshData.hpp"
+
+#include <string_view>
+
+namespace D3D12Tests {
+    struct ObjImportOptions {
+        // OBJ texture coordinates start at the bottom of the image, D3D ones at the top.
+        bool FlipTexCoordV = true;
+        // Reverses the vertex order of the faces, for files written with the other winding.
+        bool ReverseWinding = false;
+    };
+
+    // Converts Wavefront OBJ geometry to a mesh: R32G32B32_FLOAT positions, and normals,
+    // R32G32_FLOAT texture coordinates and R32G32B32A32_FLOAT colors when the file has them
+    // ("v x y z r g b" for colors). Faces are triangulated as fans and the vertices sharing
+    // all their attributes are merged. A submesh starts at each "o", "g" or "usemtl"; materials
+    // are numbered in the order of their first "usemtl", faces before any use material 0.
+    // Each submesh has a single level of detail. Throws std::runtime_error for malformed files.
+    MeshData ImportObjMesh(const std::filesystem::path& path, const ObjImportOptions& options = {});
+    MeshData ParseObjMesh(std::string_view source, const ObjImportOptions& options = {});
+}
+
+#endif // D3D12TESTS_OBJIMPORTER_HPP
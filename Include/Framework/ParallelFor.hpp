@@ -0,0 +1,24 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_PARALLELFOR_HPP
+#define D3D12TESTS_PARALLELFOR_HPP
+
+#include "Framework/Types.hpp"
+
+#include <functional>
+
+namespace D3D12Tests {
+    // Number of ranges to split work of the given size in: one per thread, at most
+    // threadCount (zero for one per hardware thread), with at least minSizePerRange each.
+    UInt32 GetParallelRangeCount(UInt64 size, UInt32 threadCount, UInt64 minSizePerRange);
+
+    // Calls the function with rangeCount contiguous ranges [begin, end) covering [0, size),
+    // concurrently. The calling thread takes the first range and returns once all are done.
+    void ParallelFor(UInt64 size, UInt32 rangeCount, const std::function<void(UInt64, UInt64)>& function);
+}
+
+#endif // D3D12TESTS_PARALLELFOR_HPP
@@ -0,0 +1,68 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_PIPELINEMANIFEST_HPP
+#define D3D12TESTS_PIPELINEMANIFEST_HPP
+
+#include "Framework/GraphicsPipelineDesc.hpp"
+
+#include <filesystem>
+#include <unordered_map>
+
+namespace D3D12Tests {
+    // List of the canonical pipeline descriptions seen by an application, saved between runs
+    // so that the pipelines can be created up front instead of on first use.
+    // The manifest is not thread-safe.
+    class PipelineManifest {
+    public:
+        PipelineManifest() = default;
+        ~PipelineManifest() = default;
+
+        PipelineManifest(const PipelineManifest&) = default;
+        PipelineManifest(PipelineManifest&&) noexcept = default;
+
+        PipelineManifest& operator=(const PipelineManifest&) = default;
+        PipelineManifest& operator=(PipelineManifest&&) noexcept = default;
+
+        // Adds a canonical description with its hash, returns false if it is already listed.
+        bool Add(const GraphicsPipelineDesc& desc, UInt64 hash);
+        inline bool Contains(const GraphicsPipelineDesc& desc, UInt64 hash) const;
+        void Clear();
+
+        // Replaces the content with the file's. A missing file, or one that does not pass
+        // validation, leaves the manifest empty; returns whether the file was read.
+        bool Load(const std::filesystem::path& path);
+        // Writes to a temporary file renamed over the destination, so that an interrupted
+        // save keeps the previous manifest.
+        void Save(const std::filesystem::path& path) const;
+
+        inline const std::vector<GraphicsPipelineDesc>& GetDescs() const;
+        inline UInt64 GetHash(size_t index) const;
+        inline size_t GetCount() const;
+
+    private:
+        static constexpr UInt32 Magic = 0x4D505444; // "DTPM"
+        static constexpr UInt32 Version = 1;
+
+        struct Header {
+            UInt32 Magic;
+            UInt32 Version;
+            UInt32 EntryCount;
+            UInt32 Reserved;
+        };
+
+        // Each entry follows as its hash, the size of its serialized description and the
+        // description itself. The hash is checked again on load.
+        std::vector<GraphicsPipelineDesc> m_Descs;
+        std::vector<UInt64> m_Hashes;
+        // Hash to the indices of the descriptions with it.
+        std::unordered_multimap<UInt64, size_t> m_Indices;
+    };
+}
+
+#include "Framework/PipelineManifest.inl"
+
+#endif // D3D12TESTS_PIPELINEMANIFEST_HPP
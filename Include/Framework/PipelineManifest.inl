@@ -0,0 +1,30 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline bool PipelineManifest::Contains(const GraphicsPipelineDesc& desc, const UInt64 hash) const {
+        const auto [begin, end] = m_Indices.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            if (m_Descs[it->second] == desc) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    inline const std::vector<GraphicsPipelineDesc>& PipelineManifest::GetDescs() const {
+        return m_Descs;
+    }
+
+    inline UInt64 PipelineManifest::GetHash(const size_t index) const {
+        return m_Hashes[index];
+    }
+
+    inline size_t PipelineManifest::GetCount() const {
+        return m_Descs.size();
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_PIPELINEREGISTRY_HPP
+#define D3D12TESTS_PIPELINEREGISTRY_HPP
+
+#include "Framework/PipelineManifest.hpp"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace D3D12Tests {
+    // Thread-safe cache of pipelines keyed by their canonical description, so that
+    // equivalent descriptions share a single pipeline. The factory is called with the
+    // canonical description, outside of the lock; concurrent requests for a pipeline being
+    // created wait for it instead of creating it again. Every created description is added to
+    // the manifest, which can be saved and used to prewarm the next run.
+    template <class TPipeline>
+    class PipelineRegistry {
+    public:
+        using Factory = std::function<TPipeline(const GraphicsPipelineDesc&)>;
+
+        explicit PipelineRegistry(Factory factory);
+        ~PipelineRegistry() = default;
+
+        PipelineRegistry(const PipelineRegistry&) = delete;
+        PipelineRegistry(PipelineRegistry&&) = delete;
+
+        PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+        PipelineRegistry& operator=(PipelineRegistry&&) = delete;
+
+        // Rethrows the factory's exceptions, a failed creation is attempted again on the
+        // next request.
+        TPipeline GetOrCreate(const GraphicsPipelineDesc& desc);
+        // Creates the manifest's pipelines accepted by the filter (e.g. those whose shaders
+        // are available) and returns how many were created.
+        std::size_t Prewarm(const std::function<bool(const GraphicsPipelineDesc&)>& filter = {});
+
+        // Merges a saved manifest into the current one, returns whether the file was read.
+        bool LoadManifest(const std::filesystem::path& path);
+        void SaveManifest(const std::filesystem::path& path) const;
+
+        inline std::size_t GetPipelineCount() const;
+        inline std::size_t GetHitCount() const;
+        inline std::size_t GetManifestCount() const;
+
+    private:
+        struct Entry {
+            GraphicsPipelineDesc Desc;
+            std::shared_future<TPipeline> Pipeline;
+        };
+
+        Factory m_Factory;
+
+        mutable std::mutex m_Mutex;
+        // Descriptions with the same hash are told apart by comparing them.
+        std::unordered_map<UInt64, std::vector<Entry>> m_Entries;
+        PipelineManifest m_Manifest;
+        std::size_t m_PipelineCount;
+        std::size_t m_HitCount;
+    };
+}
+
+#include "Framework/PipelineRegistry.inl"
+
+#endif // D3D12TESTS_PIPELINEREGISTRY_HPP
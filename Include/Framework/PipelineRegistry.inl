@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    template <class TPipeline>
+    PipelineRegistry<TPipeline>::PipelineRegistry(Factory factory) :
+        m_Factory(std::move(factory)),
+        m_PipelineCount(0),
+        m_HitCount(0) {
+    }
+
+    template <class TPipeline>
+    TPipeline PipelineRegistry<TPipeline>::GetOrCreate(const GraphicsPipelineDesc& desc) {
+        const GraphicsPipelineDesc canonical = CanonicalizePipelineDesc(desc);
+        const UInt64 hash = HashPipelineDesc(canonical);
+
+        std::promise<TPipeline> promise;
+        {
+            std::unique_lock lock(m_Mutex);
+            std::vector<Entry>& entries = m_Entries[hash];
+            for (const Entry& entry : entries) {
+                if (entry.Desc == canonical) {
+                    ++m_HitCount;
+                    const std::shared_future<TPipeline> pipeline = entry.Pipeline;
+
+                    // May wait for another thread to finish creating it.
+                    lock.unlock();
+                    return pipeline.get();
+                }
+            }
+
+            entries.push_back({canonical, promise.get_future().share()});
+        }
+
+        try {
+            TPipeline pipeline = m_Factory(canonical);
+            promise.set_value(pipeline);
+
+            std::lock_guard lock(m_Mutex);
+            m_Manifest.Add(canonical, hash);
+            ++m_PipelineCount;
+
+            return pipeline;
+        } catch (...) {
+            // The waiting threads get the exception, the following requests try again.
+            promise.set_exception(std::current_exception());
+
+            std::lock_guard lock(m_Mutex);
+            std::erase_if(m_Entries[hash], [&canonical](const Entry& entry) {
+                return entry.Desc == canonical;
+            });
+            throw;
+        }
+    }
+
+    template <class TPipeline>
+    std::size_t PipelineRegistry<TPipeline>::Prewarm(const std::function<bool(const GraphicsPipelineDesc&)>& filter) {
+        std::vector<GraphicsPipelineDesc> descs;
+        {
+            std::lock_guard lock(m_Mutex);
+            descs = m_Manifest.GetDescs();
+        }
+
+        const std::size_t previousCount = GetPipelineCount();
+        for (const GraphicsPipelineDesc& desc : descs) {
+            if (!filter || filter(desc)) {
+                GetOrCreate(desc);
+            }
+        }
+
+        return GetPipelineCount() - previousCount;
+    }
+
+    template <class TPipeline>
+    bool PipelineRegistry<TPipeline>::LoadManifest(const std::filesystem::path& path) {
+        PipelineManifest manifest;
+        const bool loaded = manifest.Load(path);
+
+        std::lock_guard lock(m_Mutex);
+        for (std::size_t i = 0; i < manifest.GetCount(); ++i) {
+            m_Manifest.Add(manifest.GetDescs()[i], manifest.GetHash(i));
+        }
+
+        return loaded;
+    }
+
+    template <class TPipeline>
+    void PipelineRegistry<TPipeline>::SaveManifest(const std::filesystem::path& path) const {
+        std::lock_guard lock(m_Mutex);
+        m_Manifest.Save(path);
+    }
+
+    template <class TPipeline>
+    inline std::size_t PipelineRegistry<TPipeline>::GetPipelineCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_PipelineCount;
+    }
+
+    template <class TPipeline>
+    inline std::size_t PipelineRegistry<TPipeline>::GetHitCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_HitCount;
+    }
+
+    template <class TPipeline>
+    inline std::size_t PipelineRegistry<TPipeline>::GetManifestCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Manifest.GetCount();
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_PROCEDURALTEXTURE_HPP
+#define D3D12TESTS_PROCEDURALTEXTURE_HPP
+
+#include "Framework/Simd.hpp"
+
+namespace D3D12Tests {
+    // RGBA8 pixels in caller-provided memory, e.g. the placed footprint of a texture in an
+    // upload buffer. Colors are packed with red in the low byte, which is the memory layout
+    // of DXGI_FORMAT_R8G8B8A8_UNORM.
+    struct TextureRegion {
+        std::byte* Data = nullptr;
+        UInt32 Width = 0;
+        UInt32 Height = 0;
+        // Distance in bytes between the start of two rows, at least Width * 4.
+        UInt64 RowPitch = 0;
+    };
+
+    struct ProceduralTextureOptions {
+        // Lowered to the level supported by the CPU.
+        SimdLevel MaxSimdLevel = SimdLevel::AVX2;
+        // Zero uses one thread per hardware thread. Rows are split between the threads.
+        UInt32 ThreadCount = 0;
+        // Smaller textures are not worth starting threads for.
+        UInt64 MinPixelsPerThread = 128 * 1024;
+    };
+
+    struct CheckerboardDesc {
+        UInt32 CellWidth = 32;
+        UInt32 CellHeight = 32;
+        // Color of the cell in the top-left corner, then of its neighbours.
+        UInt32 Color0 = 0xff000000;
+        UInt32 Color1 = 0xffffffff;
+    };
+
+    // Linear gradient between two points in pixels, clamped on both sides.
+    struct GradientDesc {
+        Float32 StartX = 0.0f;
+        Float32 StartY = 0.0f;
+        Float32 EndX = 0.0f;
+        Float32 EndY = 0.0f;
+        UInt32 StartColor = 0xff000000;
+        UInt32 EndColor = 0xffffffff;
+    };
+
+    enum class NoiseType : UInt8 {
+        // Interpolated random values on an integer lattice.
+        Value,
+        // Simplex gradient noise, without the axis-aligned artifacts of value noise.
+        Simplex
+    };
+
+    // Fractal Brownian motion: octaves of noise with increasing frequencies and decreasing
+    // amplitudes, mapped from [-1, 1] to the two colors.
+    struct NoiseDesc {
+        NoiseType Type = NoiseType::Simplex;
+        // Lattice cells per pixel of the first octave.
+        Float32 Frequency = 1.0f / 32.0f;
+        UInt32 Octaves = 1;
+        Float32 Lacunarity = 2.0f;
+        Float32 Gain = 0.5f;
+        UInt32 Seed = 0;
+        UInt32 LowColor = 0xff000000;
+        UInt32 HighColor = 0xffffffff;
+    };
+
+    // Each function overwrites the whole region. They throw std::invalid_argument for an
+    // invalid region or description.
+    void GenerateCheckerboard(const TextureRegion& region, const CheckerboardDesc& desc,
+                              const ProceduralTextureOptions& options = {});
+    void GenerateGradient(const TextureRegion& region, const GradientDesc& desc,
+                          const ProceduralTextureOptions& options = {});
+    void GenerateNoise(const TextureRegion& region, const NoiseDesc& desc,
+                       const ProceduralTextureOptions& options = {});
+}
+
+#endif // D3D12TESTS_PROCEDURALTEXTURE_HPP
@@ -0,0 +1,35 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifdef D3D12TESTS_ARCH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#include <chrono>
+#endif
+
+namespace D3D12Tests {
+    inline UInt64 ReadProfileTimestamp() {
+#ifdef D3D12TESTS_ARCH_X86
+        return __rdtsc();
+#else
+        return static_cast<UInt64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    inline ProfileScope::ProfileScope(const char* name) :
+        m_Name(name),
+        m_BeginTimestamp(ReadProfileTimestamp()) {
+    }
+
+    inline ProfileScope::~ProfileScope() {
+        RecordProfileEvent(m_Name, m_BeginTimestamp, ReadProfileTimestamp());
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RANGEALLOCATOR_HPP
+#define D3D12TESTS_RANGEALLOCATOR_HPP
+
+#include "Framework/Types.hpp"
+
+#include <array>
+#include <vector>
+
+namespace D3D12Tests {
+    // Allocates contiguous ranges of indices in [0, capacity), e.g. descriptors in a heap.
+    // Free ranges are kept in segregated free lists, one per power of two, and are merged
+    // with their neighbours when freed, so both operations run in constant time.
+    class RangeAllocator {
+    public:
+        static constexpr UInt32 InvalidIndex = ~0u;
+
+        explicit RangeAllocator(UInt32 capacity);
+        ~RangeAllocator() = default;
+
+        RangeAllocator(const RangeAllocator&) = delete;
+        RangeAllocator(RangeAllocator&&) noexcept = default;
+
+        RangeAllocator& operator=(const RangeAllocator&) = delete;
+        RangeAllocator& operator=(RangeAllocator&&) noexcept = default;
+
+        // Returns the first index of the range, or InvalidIndex when no free range is large enough.
+        UInt32 Allocate(UInt32 count);
+        // The count must be the one given to Allocate(). Throws std::out_of_range for a range
+        // outside of the allocator, and std::invalid_argument for one that is not allocated
+        // as given (freed twice, a part of an allocation...).
+        void Free(UInt32 start, UInt32 count);
+
+        void Reset();
+
+        inline UInt32 GetCapacity() const;
+        inline UInt32 GetFreeCount() const;
+
+    private:
+        static constexpr UInt32 BinCount = 32;
+
+        inline static UInt32 GetBin(UInt32 count);
+
+        void InsertFreeRange(UInt32 start, UInt32 count);
+        void RemoveFreeRange(UInt32 start, UInt32 count);
+
+        // Free ranges are stored in intrusive doubly linked lists indexed by their first
+        // index; the size/start lookups by boundary make merging with neighbours O(1).
+        std::vector<UInt32> m_RangeSizeAtStart;
+        std::vector<UInt32> m_RangeStartAtEnd;
+        std::vector<UInt32> m_Next;
+        std::vector<UInt32> m_Previous;
+        // Size of the allocated range starting at each index, zero elsewhere.
+        std::vector<UInt32> m_AllocatedSizeAtStart;
+
+        std::array<UInt32, BinCount> m_BinHeads;
+        UInt32 m_NonEmptyBins;
+
+        UInt32 m_Capacity;
+        UInt32 m_FreeCount;
+    };
+}
+
+#include "Framework/RangeAllocator.inl"
+
+#endif // D3D12TESTS_RANGEALLOCATOR_HPP
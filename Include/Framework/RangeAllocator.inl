@@ -0,0 +1,22 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <bit>
+
+namespace D3D12Tests {
+    inline UInt32 RangeAllocator::GetCapacity() const {
+        return m_Capacity;
+    }
+
+    inline UInt32 RangeAllocator::GetFreeCount() const {
+        return m_FreeCount;
+    }
+
+    inline UInt32 RangeAllocator::GetBin(const UInt32 count) {
+        // A range of [2^n, 2^(n+1)) elements lives in bin n.
+        return static_cast<UInt32>(std::bit_width(count)) - 1;
+    }
+}
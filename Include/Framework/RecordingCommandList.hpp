@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RECORDINGCOMMANDLIST_HPP
+#define D3D12TESTS_RECORDINGCOMMANDLIST_HPP
+
+#include "Framework/GraphicsCommandList.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    // GraphicsCommandList executing nothing: it keeps the commands it receives and counts
+    // them, e.g. to measure what a CommandRecorder filters, on any platform.
+    class RecordingCommandList final : public GraphicsCommandList {
+    public:
+        RecordingCommandList() = default;
+        ~RecordingCommandList() override = default;
+
+        RecordingCommandList(const RecordingCommandList&) = delete;
+        RecordingCommandList(RecordingCommandList&&) = delete;
+
+        RecordingCommandList& operator=(const RecordingCommandList&) = delete;
+        RecordingCommandList& operator=(RecordingCommandList&&) = delete;
+
+        void SetPipelineState(ID3D12PipelineState* pPipelineState) override;
+        void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) override;
+        void SetDescriptorHeaps(std::span<ID3D12DescriptorHeap* const> heaps) override;
+        void SetGraphicsRootDescriptorTable(UInt32 rootParameter, UInt64 baseDescriptor) override;
+        void SetGraphicsRoot32BitConstants(UInt32 rootParameter, std::span<const UInt32> values, UInt32 destOffset) override;
+        void SetGraphicsRootConstantBufferView(UInt32 rootParameter, UInt64 bufferLocation) override;
+        void RSSetViewports(std::span<const Viewport> viewports) override;
+        void RSSetScissorRects(std::span<const ScissorRect> rects) override;
+        void IASetPrimitiveTopology(PrimitiveTopology topology) override;
+        void IASetVertexBuffers(UInt32 startSlot, std::span<const VertexBufferView> views) override;
+        void IASetIndexBuffer(const IndexBufferView* pView) override;
+        void DrawInstanced(UInt32 vertexCountPerInstance, UInt32 instanceCount, UInt32 startVertexLocation,
+                           UInt32 startInstanceLocation) override;
+        void DrawIndexedInstanced(UInt32 indexCountPerInstance, UInt32 instanceCount, UInt32 startIndexLocation,
+                                  Int32 baseVertexLocation, UInt32 startInstanceLocation) override;
+
+        // Forgets the commands and the counts, keeping the memory.
+        inline void Clear();
+
+        // Commands received since the last clear.
+        inline std::span<const GraphicsCommand> GetCommands() const;
+        inline UInt64 GetCallCount(GraphicsCommand command) const;
+        inline UInt64 GetTotalCallCount() const;
+        // One "Name: count" line per command received at least once.
+        std::string FormatCallCounts() const;
+
+    private:
+        inline void Record(GraphicsCommand command);
+
+        std::vector<GraphicsCommand> m_Commands;
+        std::array<UInt64, static_cast<size_t>(GraphicsCommand::Count)> m_CallCounts = {};
+    };
+}
+
+#include "Framework/RecordingCommandList.inl"
+
+#endif // D3D12TESTS_RECORDINGCOMMANDLIST_HPP
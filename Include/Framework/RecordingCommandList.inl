@@ -0,0 +1,29 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void RecordingCommandList::Clear() {
+        m_Commands.clear();
+        m_CallCounts.fill(0);
+    }
+
+    inline std::span<const GraphicsCommand> RecordingCommandList::GetCommands() const {
+        return m_Commands;
+    }
+
+    inline UInt64 RecordingCommandList::GetCallCount(const GraphicsCommand command) const {
+        return m_CallCounts[static_cast<size_t>(command)];
+    }
+
+    inline UInt64 RecordingCommandList::GetTotalCallCount() const {
+        return m_Commands.size();
+    }
+
+    inline void RecordingCommandList::Record(const GraphicsCommand command) {
+        m_Commands.push_back(command);
+        ++m_CallCounts[static_cast<size_t>(command)];
+    }
+}
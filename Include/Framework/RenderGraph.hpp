@@ -0,0 +1,193 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RENDERGRAPH_HPP
+#define D3D12TESTS_RENDERGRAPH_HPP
+
+#include "Framework/Alignment.hpp"
+#include "Framework/ResourceState.hpp"
+
+#include <span>
+#include <vector>
+
+namespace D3D12Tests {
+    // A resource created for the frame by the graph, placed in one of its heaps. The size
+    // and alignment are the ones of ID3D12Device::GetResourceAllocationInfo. Resources are
+    // only aliased with the ones of the same heap: below resource heap tier 2, buffers,
+    // render target and depth-stencil textures, and other textures need their own heaps.
+    struct TransientResourceDesc {
+        UInt64 Size = 0;
+        UInt64 Alignment = Alignment::ResourcePlacement;
+        UInt32 Heap = 0;
+    };
+
+    // Where a transient resource lives in the compiled graph, between two passes of the
+    // compiled order.
+    struct TransientPlacement {
+        UInt32 Heap = 0;
+        UInt64 Offset = 0;
+        UInt64 Size = 0;
+        UInt32 FirstPass = ~0u;
+        UInt32 LastPass = ~0u;
+        // The state the resource is created in, the one it ends each frame in.
+        ResourceState InitialState = ResourceState::Common;
+        // The resource shares memory with others, its first pass must clear or discard it.
+        bool Aliased = false;
+    };
+
+    struct RenderGraphStatistics {
+        UInt32 PassCount = 0;
+        UInt32 CulledPassCount = 0;
+        // The transients used by the passes kept, with their total size, the memory they
+        // would take as committed resources, and the size of the heaps they are placed in.
+        UInt32 TransientCount = 0;
+        UInt64 TransientSize = 0;
+        UInt64 HeapSize = 0;
+        // The resources used by each pass kept, and the barriers recorded for them.
+        UInt32 UseCount = 0;
+        UInt32 TransitionCount = 0;
+        UInt32 UavBarrierCount = 0;
+        UInt32 AliasingBarrierCount = 0;
+    };
+
+    // The passes of a frame, added in execution order with the resources they read and
+    // write. Compiling the graph:
+    // - culls the passes whose writes are never read, unless they write an imported resource
+    //   or have side effects;
+    // - places the transient resources in heaps, resources whose lifetimes do not overlap
+    //   sharing memory;
+    // - derives the barriers to record before each pass: consecutive reads share a single
+    //   transition to the combination of their states, and a transient starts each frame in
+    //   the state the previous one left it in.
+    // Barriers refer to the graph's resources, whose indices the caller maps to its own
+    // (e.g. those of a ResourceStateTable).
+    class RenderGraph {
+    public:
+        static constexpr UInt32 InvalidIndex = ~0u;
+
+        RenderGraph() = default;
+        ~RenderGraph() = default;
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph(RenderGraph&&) noexcept = default;
+
+        RenderGraph& operator=(const RenderGraph&) = delete;
+        RenderGraph& operator=(RenderGraph&&) noexcept = default;
+
+        // Throws std::invalid_argument for an empty resource or an alignment that is not a
+        // power of two.
+        UInt32 CreateTransient(const TransientResourceDesc& desc);
+        // A resource living outside of the graph (e.g. a back buffer), in the initial state when
+        // the frame starts and left in the final state.
+        UInt32 Import(ResourceState initialState, ResourceState finalState);
+
+        UInt32 AddPass(bool hasSideEffects = false);
+        // The accesses of the last pass added. A pass reading and writing a resource (e.g. a
+        // UAV or a depth buffer) uses it in the write state, otherwise reads must use read-only
+        // states. Throws std::invalid_argument for an unknown resource or a write in a
+        // read-only state, and std::logic_error when no pass was added.
+        void Read(UInt32 resource, ResourceState state);
+        void Write(UInt32 resource, ResourceState state);
+
+        // Throws std::invalid_argument when a transient is read before being written, or a
+        // pass writes a resource in two states or only reads it in a state that is not read-only.
+        void Compile();
+        // Empties the graph for the next frame, keeping the memory.
+        void Clear();
+
+        // Valid once compiled. The passes kept, in order, and the barriers to record before
+        // each of them and after the last one.
+        inline std::span<const UInt32> GetPassOrder() const;
+        inline std::span<const ResourceBarrier> GetBarriers(UInt32 compiledPass) const;
+        inline std::span<const ResourceBarrier> GetFinalBarriers() const;
+        // The transients unused by the passes kept have no first pass.
+        inline const TransientPlacement& GetPlacement(UInt32 resource) const;
+        inline std::span<const UInt64> GetHeapSizes() const;
+        inline const RenderGraphStatistics& GetStatistics() const;
+
+        inline UInt32 GetPassCount() const;
+        inline UInt32 GetResourceCount() const;
+
+    private:
+        struct Resource {
+            TransientResourceDesc Desc;
+            ResourceState InitialState;
+            ResourceState FinalState;
+            bool Imported;
+        };
+
+        struct Pass {
+            UInt32 FirstAccess;
+            UInt32 AccessCount;
+            bool HasSideEffects;
+        };
+
+        struct Access {
+            UInt32 Resource;
+            ResourceState State;
+            bool Write;
+        };
+
+        // The accesses of a pass to a resource, merged.
+        struct Use {
+            UInt32 Pass;
+            UInt32 Resource;
+            ResourceState State;
+            bool Read;
+            bool Write;
+            // The pass writing what is read.
+            UInt32 Producer;
+        };
+
+        struct Interval {
+            UInt64 Begin;
+            UInt64 End;
+        };
+
+        struct PassBarrier {
+            UInt32 Pass;
+            ResourceBarrier Barrier;
+        };
+
+        inline Pass& GetLastPass();
+
+        void BuildUses();
+        void CullPasses();
+        void PlaceTransients();
+        void BuildBarriers();
+        void AddBarriers(UInt32 resource, std::span<const UInt32> uses);
+
+        std::vector<Resource> m_Resources;
+        std::vector<Pass> m_Passes;
+        std::vector<Access> m_Accesses;
+
+        // Compilation state, kept to reuse the memory.
+        std::vector<Use> m_Uses;
+        std::vector<UInt32> m_PassFirstUse;
+        std::vector<UInt32> m_ResourceScratch;
+        std::vector<UInt32> m_CompiledPasses;
+        std::vector<UInt32> m_ResourceFirstUse;
+        std::vector<UInt32> m_ResourceUses;
+        std::vector<UInt32> m_LiveOffsets;
+        std::vector<UInt32> m_LiveResources;
+        std::vector<UInt32> m_PlacementOrder;
+        std::vector<UInt32> m_PlacementRanks;
+        std::vector<Interval> m_Intervals;
+        std::vector<PassBarrier> m_PassBarriers;
+
+        std::vector<UInt32> m_PassOrder;
+        std::vector<ResourceBarrier> m_Barriers;
+        std::vector<UInt32> m_BarrierOffsets;
+        std::vector<ResourceBarrier> m_FinalBarriers;
+        std::vector<TransientPlacement> m_Placements;
+        std::vector<UInt64> m_HeapSizes;
+        RenderGraphStatistics m_Statistics;
+    };
+}
+
+#include "Framework/RenderGraph.inl"
+
+#endif // D3D12TESTS_RENDERGRAPH_HPP
@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline std::span<const UInt32> RenderGraph::GetPassOrder() const {
+        return m_PassOrder;
+    }
+
+    inline std::span<const ResourceBarrier> RenderGraph::GetBarriers(const UInt32 compiledPass) const {
+        return std::span(m_Barriers).subspan(m_BarrierOffsets[compiledPass],
+                                             m_BarrierOffsets[compiledPass + 1] - m_BarrierOffsets[compiledPass]);
+    }
+
+    inline std::span<const ResourceBarrier> RenderGraph::GetFinalBarriers() const {
+        return m_FinalBarriers;
+    }
+
+    inline const TransientPlacement& RenderGraph::GetPlacement(const UInt32 resource) const {
+        return m_Placements[resource];
+    }
+
+    inline std::span<const UInt64> RenderGraph::GetHeapSizes() const {
+        return m_HeapSizes;
+    }
+
+    inline const RenderGraphStatistics& RenderGraph::GetStatistics() const {
+        return m_Statistics;
+    }
+
+    inline UInt32 RenderGraph::GetPassCount() const {
+        return static_cast<UInt32>(m_Passes.size());
+    }
+
+    inline UInt32 RenderGraph::GetResourceCount() const {
+        return static_cast<UInt32>(m_Resources.size());
+    }
+
+    inline RenderGraph::Pass& RenderGraph::GetLastPass() {
+        if (m_Passes.empty()) {
+            throw std::logic_error("Resources are accessed by the last pass added, there is none.");
+        }
+
+        return m_Passes.back();
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RESOURCESTATE_HPP
+#define D3D12TESTS_RESOURCESTATE_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    // Mirrors D3D12_RESOURCE_STATES so that the state tracking can be used (and tested)
+    // without the D3D12 headers. The values are checked against the SDK in the D3D12 glue.
+    enum class ResourceState : UInt32 {
+        Common = 0,
+        VertexAndConstantBuffer = 0x1,
+        IndexBuffer = 0x2,
+        RenderTarget = 0x4,
+        UnorderedAccess = 0x8,
+        DepthWrite = 0x10,
+        DepthRead = 0x20,
+        NonPixelShaderResource = 0x40,
+        PixelShaderResource = 0x80,
+        StreamOut = 0x100,
+        IndirectArgument = 0x200,
+        CopyDest = 0x400,
+        CopySource = 0x800,
+        ResolveDest = 0x1000,
+        ResolveSource = 0x2000,
+        GenericRead = 0xac3,
+        Present = 0,
+
+        // Internal value of a subresource whose state is not known yet.
+        Unknown = ~0u
+    };
+
+    inline constexpr ResourceState operator|(ResourceState lhs, ResourceState rhs);
+    inline constexpr ResourceState operator&(ResourceState lhs, ResourceState rhs);
+    inline constexpr ResourceState& operator|=(ResourceState& lhs, ResourceState rhs);
+
+    // Read-only states can be combined, a subresource in a combination of them can be
+    // used in any of the states without a barrier.
+    inline constexpr bool IsReadOnlyState(ResourceState state);
+    // Whether a subresource in the state before can be used in the state after without a barrier.
+    inline constexpr bool IsStateCompatible(ResourceState before, ResourceState after);
+
+    // Mirrors D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES.
+    inline constexpr UInt32 AllSubresources = ~0u;
+
+    enum class ResourceBarrierType : UInt8 {
+        Transition,
+        UnorderedAccess,
+        // The resource starts using memory it shares with other placed resources.
+        Aliasing
+    };
+
+    // Mirrors D3D12_RESOURCE_BARRIER_FLAGS.
+    enum class ResourceBarrierFlags : UInt8 {
+        None = 0,
+        BeginOnly = 0x1,
+        EndOnly = 0x2
+    };
+
+    // Barrier on a resource registered in a ResourceStateTable. UAV and aliasing barriers only
+    // use the resource, the resource before an aliasing barrier being any of the aliased ones.
+    struct ResourceBarrier {
+        UInt32 Resource;
+        UInt32 Subresource;
+        ResourceState StateBefore;
+        ResourceState StateAfter;
+        ResourceBarrierType Type;
+        ResourceBarrierFlags Flags;
+    };
+}
+
+#include "Framework/ResourceState.inl"
+
+#endif // D3D12TESTS_RESOURCESTATE_HPP
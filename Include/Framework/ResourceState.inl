@@ -0,0 +1,37 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline constexpr ResourceState operator|(const ResourceState lhs, const ResourceState rhs) {
+        return static_cast<ResourceState>(static_cast<UInt32>(lhs) | static_cast<UInt32>(rhs));
+    }
+
+    inline constexpr ResourceState operator&(const ResourceState lhs, const ResourceState rhs) {
+        return static_cast<ResourceState>(static_cast<UInt32>(lhs) & static_cast<UInt32>(rhs));
+    }
+
+    inline constexpr ResourceState& operator|=(ResourceState& lhs, const ResourceState rhs) {
+        lhs = lhs | rhs;
+        return lhs;
+    }
+
+    inline constexpr bool IsReadOnlyState(const ResourceState state) {
+        constexpr ResourceState writeStates = ResourceState::RenderTarget | ResourceState::UnorderedAccess |
+            ResourceState::DepthWrite | ResourceState::StreamOut | ResourceState::CopyDest |
+            ResourceState::ResolveDest;
+
+        return state != ResourceState::Common && state != ResourceState::Unknown &&
+            (state & writeStates) == ResourceState::Common;
+    }
+
+    inline constexpr bool IsStateCompatible(const ResourceState before, const ResourceState after) {
+        if (before == after) {
+            return true;
+        }
+
+        return IsReadOnlyState(before) && IsReadOnlyState(after) && (before & after) == after;
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RESOURCESTATETABLE_HPP
+#define D3D12TESTS_RESOURCESTATETABLE_HPP
+
+#include "Framework/ResourceState.hpp"
+
+#include <span>
+#include <vector>
+
+namespace D3D12Tests {
+    class ResourceStateTracker;
+
+    // States of the registered resources as seen by the queue, that is after every command
+    // list resolved so far. Command lists are recorded with a ResourceStateTracker, which
+    // only knows the states the list expects its resources in; Resolve() produces the
+    // barriers that bring the resources to these states and must be called in submission
+    // order. Registration must not happen while lists referencing the table are recorded.
+    class ResourceStateTable {
+    public:
+        static constexpr UInt32 InvalidResource = ~0u;
+
+        ResourceStateTable() = default;
+        ~ResourceStateTable() = default;
+
+        ResourceStateTable(const ResourceStateTable&) = delete;
+        ResourceStateTable(ResourceStateTable&&) = delete;
+
+        ResourceStateTable& operator=(const ResourceStateTable&) = delete;
+        ResourceStateTable& operator=(ResourceStateTable&&) = delete;
+
+        // Returns the identifier of the resource, recycled once it is unregistered.
+        UInt32 Register(UInt32 subresourceCount, ResourceState initialState);
+        void Unregister(UInt32 resource);
+
+        // Returns the barriers to execute right before the command list of a closed tracker, and
+        // updates the states with the ones the list leaves its resources in. The barriers are
+        // valid until the next call.
+        std::span<const ResourceBarrier> Resolve(const ResourceStateTracker& tracker);
+
+        // Drops the transitions that do not change the state, and merges the transitions
+        // of every subresource of a resource recorded next to each other into a single one.
+        void MergeBarriers(std::vector<ResourceBarrier>& barriers) const;
+
+        inline bool IsRegistered(UInt32 resource) const;
+        inline UInt32 GetSubresourceCount(UInt32 resource) const;
+        inline ResourceState GetState(UInt32 resource, UInt32 subresource) const;
+        inline UInt32 GetResourceCount() const;
+
+    private:
+        struct Entry {
+            // While all the subresources are in the same state, it is stored here and the
+            // per-subresource states are left empty.
+            ResourceState State = ResourceState::Unknown;
+            std::vector<ResourceState> SubresourceStates;
+            UInt32 SubresourceCount = 0;
+        };
+
+        inline const Entry& GetEntry(UInt32 resource) const;
+        static void SetState(Entry& entry, UInt32 subresource, ResourceState state);
+
+        std::vector<Entry> m_Resources;
+        std::vector<UInt32> m_FreeResources;
+        std::vector<ResourceBarrier> m_ResolvedBarriers;
+    };
+}
+
+#include "Framework/ResourceStateTable.inl"
+
+#endif // D3D12TESTS_RESOURCESTATETABLE_HPP
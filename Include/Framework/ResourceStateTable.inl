@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline bool ResourceStateTable::IsRegistered(const UInt32 resource) const {
+        return resource < m_Resources.size() && m_Resources[resource].SubresourceCount != 0;
+    }
+
+    inline UInt32 ResourceStateTable::GetSubresourceCount(const UInt32 resource) const {
+        return GetEntry(resource).SubresourceCount;
+    }
+
+    inline ResourceState ResourceStateTable::GetState(const UInt32 resource, const UInt32 subresource) const {
+        const Entry& entry = GetEntry(resource);
+        if (subresource >= entry.SubresourceCount) {
+            throw std::out_of_range("Subresource index out of range.");
+        }
+
+        return entry.SubresourceStates.empty() ? entry.State : entry.SubresourceStates[subresource];
+    }
+
+    inline UInt32 ResourceStateTable::GetResourceCount() const {
+        return static_cast<UInt32>(m_Resources.size() - m_FreeResources.size());
+    }
+
+    inline const ResourceStateTable::Entry& ResourceStateTable::GetEntry(const UInt32 resource) const {
+        if (!IsRegistered(resource)) {
+            throw std::out_of_range("The resource is not registered in the state table.");
+        }
+
+        return m_Resources[resource];
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RESOURCESTATETRACKER_HPP
+#define D3D12TESTS_RESOURCESTATETRACKER_HPP
+
+#include "Framework/ResourceStateTable.hpp"
+
+namespace D3D12Tests {
+    // Tracks the subresource states of the resources used by one command list. The first
+    // state requested for a subresource becomes a pending state, resolved against the
+    // ResourceStateTable at submission; the following requests are batched until Flush(),
+    // which returns the barriers to record at this point of the list in one call.
+    // Redundant transitions are dropped, and consecutive transitions of a subresource
+    // within a batch are merged. With split barriers enabled, BeginTransition() starts a
+    // transition early, ended by the next request on the subresource or by Close().
+    class ResourceStateTracker {
+    public:
+        explicit ResourceStateTracker(const ResourceStateTable& table, bool enableSplitBarriers = false);
+        ~ResourceStateTracker() = default;
+
+        ResourceStateTracker(const ResourceStateTracker&) = delete;
+        ResourceStateTracker(ResourceStateTracker&&) noexcept = default;
+
+        ResourceStateTracker& operator=(const ResourceStateTracker&) = delete;
+        ResourceStateTracker& operator=(ResourceStateTracker&&) = delete;
+
+        void Transition(UInt32 resource, ResourceState state, UInt32 subresource = AllSubresources);
+        void BeginTransition(UInt32 resource, ResourceState state, UInt32 subresource = AllSubresources);
+        void UavBarrier(UInt32 resource);
+
+        // Returns the barriers batched since the last flush. They are valid until the next call.
+        std::span<const ResourceBarrier> Flush();
+        // Ends the split transitions still in flight and flushes. The tracker is then ready
+        // to be resolved, and can only be reused after a reset.
+        std::span<const ResourceBarrier> Close();
+        void Reset();
+
+        inline bool IsClosed() const;
+        inline bool AreSplitBarriersEnabled() const;
+        inline UInt32 GetTrackedResourceCount() const;
+
+    private:
+        friend class ResourceStateTable;
+
+        static constexpr UInt32 InvalidIndex = ~0u;
+        // Marks the owners of the batched UAV barriers, which belong to a resource and not
+        // to one of its subresources.
+        static constexpr UInt32 UavBarrierOwner = 0x80000000u;
+
+        struct TrackedResource {
+            UInt32 Resource;
+            UInt32 FirstSubresource;
+            UInt32 SubresourceCount;
+            UInt32 UavBarrierIndex;
+        };
+
+        struct SubresourceState {
+            // State the list expects the subresource in when it starts executing.
+            ResourceState Pending = ResourceState::Unknown;
+            ResourceState Current = ResourceState::Unknown;
+            // State before the split transition in flight, if any.
+            ResourceState SplitBefore = ResourceState::Unknown;
+            // Barrier of the subresource in the current batch, if any.
+            UInt32 BarrierIndex = InvalidIndex;
+        };
+
+        TrackedResource& Track(UInt32 resource);
+        void TransitionSubresource(const TrackedResource& tracked, UInt32 subresource, ResourceState state);
+        void BeginSubresourceTransition(const TrackedResource& tracked, UInt32 subresource, ResourceState state);
+        void EndSplitTransition(const TrackedResource& tracked, UInt32 subresource);
+        void AddBarrier(const ResourceBarrier& barrier, UInt32 owner);
+
+        const ResourceStateTable& m_Table;
+        std::vector<TrackedResource> m_TrackedResources;
+        std::vector<SubresourceState> m_SubresourceStates;
+        // Sparse set: the slot of a resource is valid if the tracked resource it points to matches.
+        std::vector<UInt32> m_ResourceSlots;
+        std::vector<ResourceBarrier> m_Batch;
+        std::vector<UInt32> m_BatchOwners;
+        std::vector<ResourceBarrier> m_FlushedBarriers;
+        bool m_SplitBarriersEnabled;
+        bool m_Closed;
+    };
+}
+
+#include "Framework/ResourceStateTracker.inl"
+
+#endif // D3D12TESTS_RESOURCESTATETRACKER_HPP
@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline bool ResourceStateTracker::IsClosed() const {
+        return m_Closed;
+    }
+
+    inline bool ResourceStateTracker::AreSplitBarriersEnabled() const {
+        return m_SplitBarriersEnabled;
+    }
+
+    inline UInt32 ResourceStateTracker::GetTrackedResourceCount() const {
+        return static_cast<UInt32>(m_TrackedResources.size());
+    }
+}
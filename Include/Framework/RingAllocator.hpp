@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_RINGALLOCATOR_HPP
+#define D3D12TESTS_RINGALLOCATOR_HPP
+
+#include "Framework/Types.hpp"
+
+#include <deque>
+
+namespace D3D12Tests {
+    // Bookkeeping for a linear allocator over a circular range [0, capacity).
+    // Allocations are tagged with the fence value guarding their last GPU use, and the
+    // space is given back in allocation order once that fence value has completed.
+    // It only deals with offsets, so it can manage any kind of memory (upload buffers,
+    // descriptor heaps...).
+    class RingAllocator {
+    public:
+        static constexpr UInt64 InvalidOffset = ~0ull;
+
+        explicit RingAllocator(UInt64 capacity);
+        ~RingAllocator() = default;
+
+        RingAllocator(const RingAllocator&) = delete;
+        RingAllocator(RingAllocator&&) noexcept = default;
+
+        RingAllocator& operator=(const RingAllocator&) = delete;
+        RingAllocator& operator=(RingAllocator&&) noexcept = default;
+
+        // Returns InvalidOffset when there is not enough contiguous free space.
+        // The alignment must be a power of two.
+        UInt64 Allocate(UInt64 size, UInt64 alignment, UInt64 fenceValue);
+
+        // Gives back the space of every allocation guarded by a completed fence value.
+        void Release(UInt64 completedFenceValue);
+
+        inline bool IsEmpty() const;
+        // Fence value guarding the oldest allocation still alive.
+        inline UInt64 GetOldestFenceValue() const;
+
+        inline UInt64 GetCapacity() const;
+        inline UInt64 GetUsedSize() const;
+
+    private:
+        // Allocations guarded by the same fence value are merged in a single region.
+        struct Region {
+            UInt64 FenceValue;
+            UInt64 End;
+        };
+
+        std::deque<Region> m_Regions;
+        UInt64 m_Capacity;
+
+        // Monotonic positions, the actual offsets are these modulo the capacity.
+        UInt64 m_Head;
+        UInt64 m_Tail;
+    };
+}
+
+#include "Framework/RingAllocator.inl"
+
+#endif // D3D12TESTS_RINGALLOCATOR_HPP
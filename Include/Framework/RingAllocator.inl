@@ -0,0 +1,23 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline bool RingAllocator::IsEmpty() const {
+        return m_Regions.empty();
+    }
+
+    inline UInt64 RingAllocator::GetOldestFenceValue() const {
+        return m_Regions.empty() ? 0 : m_Regions.front().FenceValue;
+    }
+
+    inline UInt64 RingAllocator::GetCapacity() const {
+        return m_Capacity;
+    }
+
+    inline UInt64 RingAllocator::GetUsedSize() const {
+        return m_Head - m_Tail;
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_SHADERCACHE_HPP
+#define D3D12TESTS_SHADERCACHE_HPP
+
+#include "Framework/MappedFile.hpp"
+
+#include <span>
+
+namespace D3D12Tests {
+    // Shader bytecode blobs stored in a memory-mapped file and addressed by a 64-bit key.
+    // The file starts with an open addressing hash table of the keys, followed by the
+    // blobs, so that a lookup is a probe in the mapping with no parsing at startup.
+    // Files with another layout version, or that do not pass validation, are discarded.
+    // The cache is not thread-safe.
+    class ShaderCache {
+    public:
+        explicit ShaderCache(const std::filesystem::path& path, UInt32 initialBucketCount = 256);
+        ~ShaderCache() = default;
+
+        ShaderCache(const ShaderCache&) = delete;
+        ShaderCache(ShaderCache&&) noexcept = default;
+
+        ShaderCache& operator=(const ShaderCache&) = delete;
+        ShaderCache& operator=(ShaderCache&&) noexcept = default;
+
+        // Returns an empty span when the key is not in the cache. The bytecode points into the
+        // mapping and is valid until the next insertion.
+        std::span<const std::byte> Find(UInt64 key) const;
+        // Stores the bytecode of a key, replacing the previous one if any.
+        std::span<const std::byte> Insert(UInt64 key, std::span<const std::byte> bytecode);
+        void Clear();
+
+        inline UInt32 GetEntryCount() const;
+        inline UInt32 GetBucketCount() const;
+        inline UInt64 GetDataSize() const;
+        inline UInt64 GetFileSize() const;
+
+    private:
+        static constexpr UInt32 Magic = 0x48535444; // "DTSH"
+        static constexpr UInt32 Version = 1;
+        static constexpr UInt64 BlobAlignment = 16;
+        // Key of the empty buckets, the keys that collide with it are remapped.
+        static constexpr UInt64 EmptyKey = 0;
+
+        struct Header {
+            UInt32 Magic;
+            UInt32 Version;
+            UInt32 BucketCount;
+            UInt32 EntryCount;
+            // Used size of the data region, which follows the buckets.
+            UInt64 DataSize;
+            UInt64 DataCapacity;
+        };
+
+        struct Bucket {
+            UInt64 Key;
+            // Offset from the start of the data region.
+            UInt64 Offset;
+            UInt64 Size;
+        };
+
+        static_assert(sizeof(Header) % BlobAlignment == 0);
+        static_assert(sizeof(Bucket) * 2 % BlobAlignment == 0);
+
+        inline static UInt64 GetStoredKey(UInt64 key);
+        inline static UInt64 GetDataOffset(UInt32 bucketCount);
+
+        inline Header& GetHeader() const;
+        inline Bucket* GetBuckets() const;
+        inline std::byte* GetDataRegion() const;
+
+        bool IsValid() const;
+        void Initialize(UInt32 bucketCount, UInt64 dataCapacity);
+        // Returns the bucket holding the key, or the empty bucket where it would be inserted.
+        Bucket& Probe(UInt64 storedKey) const;
+        void Rehash(UInt32 bucketCount);
+        void ReserveData(UInt64 size);
+
+        MappedFile m_File;
+        UInt32 m_InitialBucketCount;
+    };
+}
+
+#include "Framework/ShaderCache.inl"
+
+#endif // D3D12TESTS_SHADERCACHE_HPP
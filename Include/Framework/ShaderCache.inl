@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt32 ShaderCache::GetEntryCount() const {
+        return GetHeader().EntryCount;
+    }
+
+    inline UInt32 ShaderCache::GetBucketCount() const {
+        return GetHeader().BucketCount;
+    }
+
+    inline UInt64 ShaderCache::GetDataSize() const {
+        return GetHeader().DataSize;
+    }
+
+    inline UInt64 ShaderCache::GetFileSize() const {
+        return m_File.GetSize();
+    }
+
+    inline UInt64 ShaderCache::GetStoredKey(const UInt64 key) {
+        return key == EmptyKey ? ~EmptyKey : key;
+    }
+
+    inline UInt64 ShaderCache::GetDataOffset(const UInt32 bucketCount) {
+        return sizeof(Header) + static_cast<UInt64>(bucketCount) * sizeof(Bucket);
+    }
+
+    inline ShaderCache::Header& ShaderCache::GetHeader() const {
+        // The mapping is owned by the cache, const only applies to the cache's interface.
+        return *reinterpret_cast<Header*>(const_cast<std::byte*>(m_File.GetData()));
+    }
+
+    inline ShaderCache::Bucket* ShaderCache::GetBuckets() const {
+        return reinterpret_cast<Bucket*>(const_cast<std::byte*>(m_File.GetData()) + sizeof(Header));
+    }
+
+    inline std::byte* ShaderCache::GetDataRegion() const {
+        return const_cast<std::byte*>(m_File.GetData()) + GetDataOffset(GetHeader().BucketCount);
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_SHADERCOMPILER_HPP
+#define D3D12TESTS_SHADERCOMPILER_HPP
+
+#include "Framework/Types.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    struct ShaderDefine {
+        std::string Name;
+        std::string Value;
+    };
+
+    struct ShaderCompileDesc {
+        std::filesystem::path SourcePath;
+        std::vector<ShaderDefine> Defines;
+        std::string EntryPoint;
+        std::string Target;
+        UInt32 Flags = 0;
+    };
+
+    // Compiles a shader source file to bytecode. Implementations throw when the
+    // compilation fails.
+    class ShaderCompiler {
+    public:
+        ShaderCompiler() = default;
+        virtual ~ShaderCompiler() = default;
+
+        ShaderCompiler(const ShaderCompiler&) = delete;
+        ShaderCompiler(ShaderCompiler&&) = delete;
+
+        ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+        ShaderCompiler& operator=(ShaderCompiler&&) = delete;
+
+        virtual std::vector<std::byte> Compile(const ShaderCompileDesc& desc) = 0;
+        // Identifies the compiler and its version, bytecode from another compiler is not reused.
+        virtual UInt64 GetVersionHash() const = 0;
+    };
+}
+
+#endif // D3D12TESTS_SHADERCOMPILER_HPP
@@ -0,0 +1,30 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_SIMD_HPP
+#define D3D12TESTS_SIMD_HPP
+
+#include "Framework/Types.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define D3D12TESTS_ARCH_X86
+#endif
+
+namespace D3D12Tests {
+    // Instruction sets of the vectorized code paths, in increasing order.
+    enum class SimdLevel : UInt8 {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // Highest level supported by the CPU (and the OS, for the AVX registers). Detected once.
+    SimdLevel GetSimdLevel();
+
+    const char* GetSimdLevelName(SimdLevel level);
+}
+
+#endif // D3D12TESTS_SIMD_HPP
@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_SIMULATEDGPUTIMELINE_HPP
+#define D3D12TESTS_SIMULATEDGPUTIMELINE_HPP
+
+#include "Framework/GpuTimeline.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+namespace D3D12Tests {
+    // CPU-only timeline emulating a GPU queue that executes its submissions serially,
+    // each one taking a fixed amount of work time. Used to drive the scheduling code
+    // headlessly (no device, any platform).
+    class SimulatedGpuTimeline final : public GpuTimeline {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit SimulatedGpuTimeline(Clock::duration workDuration = Clock::duration::zero());
+        ~SimulatedGpuTimeline() override = default;
+
+        SimulatedGpuTimeline(const SimulatedGpuTimeline&) = delete;
+        SimulatedGpuTimeline(SimulatedGpuTimeline&&) = delete;
+
+        SimulatedGpuTimeline& operator=(const SimulatedGpuTimeline&) = delete;
+        SimulatedGpuTimeline& operator=(SimulatedGpuTimeline&&) = delete;
+
+        UInt64 Signal() override;
+        UInt64 GetCompletedValue() override;
+        void WaitForValue(UInt64 value) override;
+
+        // Forces every signaled value up to (and including) the given one to complete now.
+        void CompleteUpTo(UInt64 value);
+
+        inline void SetWorkDuration(Clock::duration workDuration);
+
+        inline UInt64 GetWaitCount() const;
+        inline Clock::duration GetTotalWaitTime() const;
+
+    private:
+        struct PendingSignal {
+            UInt64 Value;
+            Clock::time_point CompletionTime;
+        };
+
+        void RetireCompleted(Clock::time_point now);
+
+        mutable std::mutex m_Mutex;
+        std::deque<PendingSignal> m_Pending;
+        Clock::duration m_WorkDuration;
+        Clock::time_point m_LastCompletionTime;
+        UInt64 m_CompletedValue;
+
+        UInt64 m_WaitCount;
+        Clock::duration m_TotalWaitTime;
+    };
+}
+
+#include "Framework/SimulatedGpuTimeline.inl"
+
+#endif // D3D12TESTS_SIMULATEDGPUTIMELINE_HPP
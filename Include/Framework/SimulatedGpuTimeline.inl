@@ -0,0 +1,22 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline void SimulatedGpuTimeline::SetWorkDuration(const Clock::duration workDuration) {
+        std::lock_guard lock(m_Mutex);
+        m_WorkDuration = workDuration;
+    }
+
+    inline UInt64 SimulatedGpuTimeline::GetWaitCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_WaitCount;
+    }
+
+    inline SimulatedGpuTimeline::Clock::duration SimulatedGpuTimeline::GetTotalWaitTime() const {
+        std::lock_guard lock(m_Mutex);
+        return m_TotalWaitTime;
+    }
+}
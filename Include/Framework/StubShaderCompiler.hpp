@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_STUBSHADERCOMPILER_HPP
+#define D3D12TESTS_STUBSHADERCOMPILER_HPP
+
+#include "Framework/ShaderCompiler.hpp"
+
+#include <chrono>
+
+namespace D3D12Tests {
+    // Stand-in for a real compiler, to run the shader cache on any platform. It reads the
+    // source, spends a configurable amount of time "compiling", and returns deterministic
+    // bytes derived from its inputs.
+    class StubShaderCompiler final : public ShaderCompiler {
+    public:
+        explicit StubShaderCompiler(std::chrono::nanoseconds compileTime = std::chrono::nanoseconds::zero(),
+                                    std::size_t bytecodeSize = 4096);
+        ~StubShaderCompiler() override = default;
+
+        StubShaderCompiler(const StubShaderCompiler&) = delete;
+        StubShaderCompiler(StubShaderCompiler&&) = delete;
+
+        StubShaderCompiler& operator=(const StubShaderCompiler&) = delete;
+        StubShaderCompiler& operator=(StubShaderCompiler&&) = delete;
+
+        std::vector<std::byte> Compile(const ShaderCompileDesc& desc) override;
+        UInt64 GetVersionHash() const override;
+
+        inline UInt64 GetCompileCount() const;
+
+    private:
+        std::chrono::nanoseconds m_CompileTime;
+        std::size_t m_BytecodeSize;
+        UInt64 m_CompileCount;
+    };
+}
+
+#include "Framework/StubShaderCompiler.inl"
+
+#endif // D3D12TESTS_STUBSHADERCOMPILER_HPP
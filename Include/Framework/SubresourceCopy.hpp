@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_SUBRESOURCECOPY_HPP
+#define D3D12TESTS_SUBRESOURCECOPY_HPP
+
+#include "Framework/Simd.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <span>
+
+namespace D3D12Tests {
+    // Portable subset of D3D12_RESOURCE_DESC for textures.
+    struct TextureCopyDesc {
+        UInt32 Format = DxgiFormat::Unknown;
+        TextureDimension Dimension = TextureDimension::Texture2D;
+        UInt64 Width = 0;
+        UInt32 Height = 1;
+        // Depth of a 3D texture, array size otherwise.
+        UInt32 DepthOrArraySize = 1;
+        UInt32 MipLevels = 1;
+    };
+
+    // Placed footprint of a subresource in a buffer, as returned by
+    // ID3D12Device::GetCopyableFootprints.
+    struct SubresourceFootprint {
+        UInt64 Offset = 0;
+        UInt32 Format = DxgiFormat::Unknown;
+        // Rounded up to the block size of the format.
+        UInt32 Width = 0;
+        UInt32 Height = 0;
+        UInt32 Depth = 0;
+        // Multiple of Alignment::TextureRowPitch.
+        UInt32 RowPitch = 0;
+        // Number of rows of blocks in a slice.
+        UInt32 RowCount = 0;
+        // Bytes of data in a row, without the padding.
+        UInt64 RowSize = 0;
+    };
+
+    // Fills one footprint per subresource, subresource i being mip i % MipLevels of slice
+    // i / MipLevels, placed from baseOffset, which must be a multiple of
+    // Alignment::TexturePlacement. Returns the total size, without padding after the last row.
+    // Throws std::invalid_argument for the formats without a single-plane layout and for
+    // subresources out of the range of the texture.
+    UInt64 ComputeCopyableFootprints(const TextureCopyDesc& desc, UInt32 firstSubresource, UInt64 baseOffset,
+                                     std::span<SubresourceFootprint> footprints);
+    inline UInt32 GetSubresourceCount(const TextureCopyDesc& desc);
+
+    // Tightly or loosely packed source data, e.g. a DdsSubresource.
+    struct SubresourceData {
+        const std::byte* Data = nullptr;
+        UInt64 RowPitch = 0;
+        UInt64 SlicePitch = 0;
+    };
+
+    struct SubresourceCopyOptions {
+        // Lowered to the level supported by the CPU. Above Scalar, the destination is written
+        // with non-temporal stores, which bypass the cache: best for write-combined upload
+        // memory that the CPU never reads back.
+        SimdLevel MaxSimdLevel = SimdLevel::AVX2;
+        // Zero uses one thread per hardware thread. Rows are split between the threads.
+        UInt32 ThreadCount = 0;
+        // Smaller copies are not worth starting threads for.
+        UInt64 MinBytesPerThread = 4 * 1024 * 1024;
+    };
+
+    // Copies a subresource to its footprint, pDestination being the mapped buffer the
+    // footprint offset is relative to.
+    void CopySubresource(std::byte* pDestination, const SubresourceFootprint& footprint, const SubresourceData& source,
+                         const SubresourceCopyOptions& options = {});
+
+    // Copies contiguous bytes like std::memcpy, with the options of CopySubresource.
+    void StreamCopy(void* pDestination, const void* pSource, UInt64 size, const SubresourceCopyOptions& options = {});
+}
+
+#include "Framework/SubresourceCopy.inl"
+
+#endif // D3D12TESTS_SUBRESOURCECOPY_HPP
@@ -0,0 +1,12 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt32 GetSubresourceCount(const TextureCopyDesc& desc) {
+        const UInt32 arraySize = desc.Dimension == TextureDimension::Texture3D ? 1 : desc.DepthOrArraySize;
+        return desc.MipLevels * arraySize;
+    }
+}
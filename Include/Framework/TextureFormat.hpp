@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_TEXTUREFORMAT_HPP
+#define D3D12TESTS_TEXTUREFORMAT_HPP
+
+#include "Framework/Types.hpp"
+
+namespace D3D12Tests {
+    // DXGI_FORMAT values used by the portable code, which cannot include the DXGI headers.
+    namespace DxgiFormat {
+        inline constexpr UInt32 Unknown = 0;
+        inline constexpr UInt32 R32G32B32A32Float = 2;
+        inline constexpr UInt32 R32G32B32Float = 6;
+        inline constexpr UInt32 R16G16B16A16Float = 10;
+        inline constexpr UInt32 R16G16B16A16Unorm = 11;
+        inline constexpr UInt32 R16G16B16A16Snorm = 13;
+        inline constexpr UInt32 R32G32Float = 16;
+        inline constexpr UInt32 R10G10B10A2Unorm = 24;
+        inline constexpr UInt32 R8G8B8A8Unorm = 28;
+        inline constexpr UInt32 R8G8B8A8Snorm = 31;
+        inline constexpr UInt32 R16G16Float = 34;
+        inline constexpr UInt32 R16G16Unorm = 35;
+        inline constexpr UInt32 R16G16Snorm = 37;
+        inline constexpr UInt32 R32Float = 41;
+        inline constexpr UInt32 R32Uint = 42;
+        inline constexpr UInt32 R8G8Unorm = 49;
+        inline constexpr UInt32 R8G8Snorm = 51;
+        inline constexpr UInt32 R16Float = 54;
+        inline constexpr UInt32 R16Unorm = 56;
+        inline constexpr UInt32 R16Uint = 57;
+        inline constexpr UInt32 R8Unorm = 61;
+        inline constexpr UInt32 A8Unorm = 65;
+        inline constexpr UInt32 R8G8B8G8Unorm = 68;
+        inline constexpr UInt32 G8R8G8B8Unorm = 69;
+        inline constexpr UInt32 BC1Unorm = 71;
+        inline constexpr UInt32 BC2Unorm = 74;
+        inline constexpr UInt32 BC3Unorm = 77;
+        inline constexpr UInt32 BC4Unorm = 80;
+        inline constexpr UInt32 BC4Snorm = 81;
+        inline constexpr UInt32 BC5Unorm = 83;
+        inline constexpr UInt32 BC5Snorm = 84;
+        inline constexpr UInt32 B5G6R5Unorm = 85;
+        inline constexpr UInt32 B5G5R5A1Unorm = 86;
+        inline constexpr UInt32 B8G8R8A8Unorm = 87;
+        inline constexpr UInt32 B8G8R8X8Unorm = 88;
+        inline constexpr UInt32 BC7Unorm = 98;
+        inline constexpr UInt32 YUY2 = 107;
+        inline constexpr UInt32 B4G4R4A4Unorm = 115;
+    }
+
+    enum class TextureDimension : UInt8 {
+        Texture1D,
+        Texture2D,
+        Texture3D
+    };
+
+    // Memory layout of a format, in blocks: 4x4 for the block-compressed formats, 2x1 for the
+    // packed YUV-like formats, 8x1 for R1_UNORM and 1x1 for the rest.
+    struct TextureFormatInfo {
+        UInt32 BlockWidth;
+        UInt32 BlockHeight;
+        // Zero for the formats without a single-plane layout (planar video formats, unknown).
+        UInt32 BlockSize;
+    };
+
+    // Layout of a subresource slice, without any alignment.
+    struct TextureLayout {
+        UInt64 RowPitch;
+        // Number of rows of blocks.
+        UInt32 RowCount;
+        UInt64 SlicePitch;
+    };
+
+    TextureFormatInfo GetTextureFormatInfo(UInt32 dxgiFormat);
+
+    // Throws std::invalid_argument for the formats without a layout.
+    inline TextureLayout ComputeTextureLayout(UInt32 dxgiFormat, UInt32 width, UInt32 height);
+}
+
+#include "Framework/TextureFormat.inl"
+
+#endif // D3D12TESTS_TEXTUREFORMAT_HPP
@@ -0,0 +1,23 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    inline TextureLayout ComputeTextureLayout(const UInt32 dxgiFormat, const UInt32 width, const UInt32 height) {
+        const TextureFormatInfo info = GetTextureFormatInfo(dxgiFormat);
+        if (info.BlockSize == 0) {
+            throw std::invalid_argument("The texture format has no single-plane layout.");
+        }
+
+        const UInt64 blocksPerRow = std::max<UInt64>((static_cast<UInt64>(width) + info.BlockWidth - 1) / info.BlockWidth, 1);
+        const UInt32 rowCount = std::max<UInt32>((height + info.BlockHeight - 1) / info.BlockHeight, 1);
+        const UInt64 rowPitch = blocksPerRow * info.BlockSize;
+
+        return {rowPitch, rowCount, rowPitch * rowCount};
+    }
+}
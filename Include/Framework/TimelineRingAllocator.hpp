@@ -0,0 +1,45 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_TIMELINERINGALLOCATOR_HPP
+#define D3D12TESTS_TIMELINERINGALLOCATOR_HPP
+
+#include "Framework/GpuTimeline.hpp"
+#include "Framework/RingAllocator.hpp"
+
+namespace D3D12Tests {
+    // RingAllocator whose allocations are guarded by the next value signaled on a
+    // timeline: they stay valid until the work submitted before that signal is done.
+    // When the ring is full, the oldest allocations are waited for and recycled.
+    // It is not thread-safe.
+    class TimelineRingAllocator {
+    public:
+        TimelineRingAllocator(GpuTimeline& timeline, UInt64 capacity);
+        ~TimelineRingAllocator() = default;
+
+        TimelineRingAllocator(const TimelineRingAllocator&) = delete;
+        TimelineRingAllocator(TimelineRingAllocator&&) = delete;
+
+        TimelineRingAllocator& operator=(const TimelineRingAllocator&) = delete;
+        TimelineRingAllocator& operator=(TimelineRingAllocator&&) = delete;
+
+        // Throws std::length_error if the allocation cannot fit, even once the GPU is idle.
+        UInt64 Allocate(UInt64 size, UInt64 alignment);
+
+        inline UInt64 GetCapacity() const;
+        inline UInt64 GetUsedSize() const;
+        inline UInt64 GetWaitCount() const;
+
+    private:
+        GpuTimeline& m_Timeline;
+        RingAllocator m_Allocator;
+        UInt64 m_WaitCount;
+    };
+}
+
+#include "Framework/TimelineRingAllocator.inl"
+
+#endif // D3D12TESTS_TIMELINERINGALLOCATOR_HPP
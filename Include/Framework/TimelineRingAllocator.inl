@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UInt64 TimelineRingAllocator::GetCapacity() const {
+        return m_Allocator.GetCapacity();
+    }
+
+    inline UInt64 TimelineRingAllocator::GetUsedSize() const {
+        return m_Allocator.GetUsedSize();
+    }
+
+    inline UInt64 TimelineRingAllocator::GetWaitCount() const {
+        return m_WaitCount;
+    }
+}
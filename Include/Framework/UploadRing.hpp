@@ -0,0 +1,58 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_UPLOADRING_HPP
+#define D3D12TESTS_UPLOADRING_HPP
+
+#include "Framework/Alignment.hpp"
+#include "Framework/TimelineRingAllocator.hpp"
+
+namespace D3D12Tests {
+    struct UploadAllocation {
+        std::byte* CpuAddress;
+        UInt64 GpuAddress;
+        // Offset from the start of the ring's buffer, for copy commands.
+        UInt64 Offset;
+        UInt64 Size;
+    };
+
+    // Sub-allocates staging memory linearly from one persistently mapped buffer.
+    // An allocation stays valid until the next value signaled on the timeline has
+    // completed, so the GPU work reading it must be submitted before that signal.
+    // See TimelineRingAllocator for the recycling policy.
+    class UploadRing {
+    public:
+        UploadRing(GpuTimeline& timeline, std::byte* cpuBase, UInt64 gpuBase, UInt64 capacity);
+        ~UploadRing() = default;
+
+        UploadRing(const UploadRing&) = delete;
+        UploadRing(UploadRing&&) = delete;
+
+        UploadRing& operator=(const UploadRing&) = delete;
+        UploadRing& operator=(UploadRing&&) = delete;
+
+        // Throws std::length_error if the allocation cannot fit, even once the GPU is idle.
+        UploadAllocation Allocate(UInt64 size, UInt64 alignment = Alignment::Buffer);
+        inline UploadAllocation AllocateConstants(UInt64 size);
+        inline UploadAllocation AllocateTexture(UInt64 size);
+
+        // Allocates and copies the given data.
+        UploadAllocation Upload(const void* pData, UInt64 size, UInt64 alignment = Alignment::Buffer);
+
+        inline UInt64 GetCapacity() const;
+        inline UInt64 GetUsedSize() const;
+        inline UInt64 GetWaitCount() const;
+
+    private:
+        TimelineRingAllocator m_Allocator;
+        std::byte* m_CpuBase;
+        UInt64 m_GpuBase;
+    };
+}
+
+#include "Framework/UploadRing.inl"
+
+#endif // D3D12TESTS_UPLOADRING_HPP
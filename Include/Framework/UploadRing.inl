@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace D3D12Tests {
+    inline UploadAllocation UploadRing::AllocateConstants(const UInt64 size) {
+        // Constant buffer views must also cover a multiple of 256 bytes.
+        return Allocate(AlignUp(size, Alignment::ConstantBuffer), Alignment::ConstantBuffer);
+    }
+
+    inline UploadAllocation UploadRing::AllocateTexture(const UInt64 size) {
+        return Allocate(size, Alignment::TexturePlacement);
+    }
+
+    inline UInt64 UploadRing::GetCapacity() const {
+        return m_Allocator.GetCapacity();
+    }
+
+    inline UInt64 UploadRing::GetUsedSize() const {
+        return m_Allocator.GetUsedSize();
+    }
+
+    inline UInt64 UploadRing::GetWaitCount() const {
+        return m_Allocator.GetWaitCount();
+    }
+}
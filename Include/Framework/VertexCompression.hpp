@@ -0,0 +1,98 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_VERTEXCOMPRESSION_HPP
+#define D3D12TESTS_VERTEXCOMPRESSION_HPP
+
+#include "Framework/GraphicsPipelineDesc.hpp"
+#include "Framework/MeshData.hpp"
+#include "Framework/Simd.hpp"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace D3D12Tests {
+    // Compact vertex formats, decoded by the input assembler and a few shader instructions:
+    //  - positions: R32G32B32_FLOAT to R16G16B16A16_UNORM in a box, 8 bytes;
+    //  - normals: R32G32B32_FLOAT to octahedral R16G16_SNORM, 4 bytes;
+    //  - tangents: R32G32B32A32_FLOAT with the handedness in w to octahedral R8G8B8A8_SNORM,
+    //    x and y the direction and w the handedness, 4 bytes;
+    //  - texture coordinates: R32G32_FLOAT to R16G16_FLOAT, 4 bytes;
+    //  - colors: R32G32B32A32_FLOAT to R8G8B8A8_UNORM, 4 bytes.
+    inline constexpr UInt32 QuantizedPositionSize = 8;
+    inline constexpr UInt32 OctahedralNormalSize = 4;
+    inline constexpr UInt32 OctahedralTangentSize = 4;
+    inline constexpr UInt32 HalfTexCoordSize = 4;
+    inline constexpr UInt32 UnormColorSize = 4;
+    // Largest source stride, the D3D12 limit of a vertex.
+    inline constexpr UInt32 MaxSourceStride = 2048;
+
+    struct VertexCompressionOptions {
+        // Lowered to the level supported by the CPU. All levels give the same bits.
+        SimdLevel MaxSimdLevel = SimdLevel::AVX2;
+        // Zero uses one thread per hardware thread. Vertices are split between the threads.
+        UInt32 ThreadCount = 0;
+        UInt64 MinVerticesPerThread = 256 * 1024;
+    };
+
+    // Box of the quantized positions: position = Offset + encoded * Extent, with the encoded
+    // values in [0, 1]. Rounding to the nearest step keeps the error within Extent / 131070
+    // per axis, give or take the float rounding. Positions out of the box are clamped to it.
+    struct PositionQuantization {
+        Float32 Offset[3] = {};
+        Float32 Extent[3] = {};
+    };
+
+    // The box of a mesh written by CompressMeshVertices is its bounds, so that the loader can
+    // get it back from the header of the mesh file.
+    inline PositionQuantization GetPositionQuantization(const Float32 (&boundsMin)[3], const Float32 (&boundsMax)[3]);
+
+    // Each encoder reads vertexCount float vertices sourceStride bytes apart and writes them
+    // tightly packed. They throw std::invalid_argument if either span is too small or if the
+    // stride is out of [source vertex size, MaxSourceStride].
+    void EncodeQuantizedPositions(std::span<std::byte> destination, std::span<const std::byte> source, UInt32 sourceStride,
+                                  UInt32 vertexCount, const PositionQuantization& quantization,
+                                  const VertexCompressionOptions& options = {});
+    // The normals do not need to be normalized; zero vectors are encoded as +Z.
+    void EncodeOctahedralNormals(std::span<std::byte> destination, std::span<const std::byte> source, UInt32 sourceStride,
+                                 UInt32 vertexCount, const VertexCompressionOptions& options = {});
+    void EncodeOctahedralTangents(std::span<std::byte> destination, std::span<const std::byte> source, UInt32 sourceStride,
+                                  UInt32 vertexCount, const VertexCompressionOptions& options = {});
+    // Rounded to the nearest half, overflowing to infinity past 65504.
+    void EncodeHalfTexCoords(std::span<std::byte> destination, std::span<const std::byte> source, UInt32 sourceStride,
+                             UInt32 vertexCount, const VertexCompressionOptions& options = {});
+    void EncodeUnormColors(std::span<std::byte> destination, std::span<const std::byte> source, UInt32 sourceStride,
+                           UInt32 vertexCount, const VertexCompressionOptions& options = {});
+
+    // Decoding of one vertex, as the input assembler and the generated HLSL do it.
+    inline void DecodeQuantizedPosition(const std::byte* pEncoded, const PositionQuantization& quantization, Float32 (&position)[3]);
+    inline void DecodeOctahedralNormal(const std::byte* pEncoded, Float32 (&normal)[3]);
+    inline void DecodeOctahedralTangent(const std::byte* pEncoded, Float32 (&tangent)[4]);
+    inline void DecodeHalfTexCoord(const std::byte* pEncoded, Float32 (&texCoord)[2]);
+    inline void DecodeUnormColor(const std::byte* pEncoded, Float32 (&color)[4]);
+    inline Float32 HalfToFloat(UInt16 half);
+
+    // Re-encodes the float streams of the mesh in the compact formats, leaving the others as
+    // they are, and sets the mesh bounds to the box of the positions. The positions must be
+    // R32G32B32_FLOAT; ComputeMeshBounds cannot be used on the compressed mesh. Throws
+    // std::invalid_argument for meshes that do not pass ValidateMeshData.
+    PositionQuantization CompressMeshVertices(MeshData& mesh, const VertexCompressionOptions& options = {});
+
+    // One element per stream, each in its own input slot like the streams of a mesh file.
+    std::vector<PipelineInputElement> GetMeshInputLayout(std::span<const MeshStreamDesc> streams);
+    std::vector<PipelineInputElement> GetMeshInputLayout(const MeshData& mesh);
+
+    // HLSL declaring MeshVertexInput, matching the input layout of the streams, MeshVertex, with
+    // the decoded attributes, and DecodeMeshVertex(input, positionOffset, positionExtent).
+    // Throws std::invalid_argument for streams in a format the decoder does not know.
+    std::string GenerateVertexDecodeHlsl(std::span<const MeshStreamDesc> streams);
+    std::string GenerateVertexDecodeHlsl(const MeshData& mesh);
+}
+
+#include "Framework/VertexCompression.inl"
+
+#endif // D3D12TESTS_VERTEXCOMPRESSION_HPP
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace D3D12Tests {
+    inline PositionQuantization GetPositionQuantization(const Float32 (&boundsMin)[3], const Float32 (&boundsMax)[3]) {
+        PositionQuantization quantization;
+        for (UInt32 axis = 0; axis < 3; ++axis) {
+            quantization.Offset[axis] = boundsMin[axis];
+            quantization.Extent[axis] = std::max(boundsMax[axis] - boundsMin[axis], 0.0f);
+        }
+
+        return quantization;
+    }
+
+    inline void DecodeQuantizedPosition(const std::byte* pEncoded, const PositionQuantization& quantization, Float32 (&position)[3]) {
+        UInt16 encoded[4];
+        std::memcpy(encoded, pEncoded, sizeof(encoded));
+        for (UInt32 axis = 0; axis < 3; ++axis) {
+            position[axis] = quantization.Offset[axis] + static_cast<Float32>(encoded[axis]) / 65535.0f * quantization.Extent[axis];
+        }
+    }
+
+    namespace VertexCompressionDetail {
+        // SNORM to float: the most negative value is -1 too.
+        inline Float32 DecodeSnorm(const Int32 value, const Float32 maxValue) {
+            return std::max(static_cast<Float32>(value) / maxValue, -1.0f);
+        }
+
+        inline void DecodeOctahedral(const Float32 x, const Float32 y, Float32 (&direction)[3]) {
+            Float32 z = 1.0f - std::abs(x) - std::abs(y);
+            Float32 unfoldedX = x;
+            Float32 unfoldedY = y;
+            if (z < 0.0f) {
+                unfoldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                unfoldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            }
+
+            const Float32 length = std::sqrt(unfoldedX * unfoldedX + unfoldedY * unfoldedY + z * z);
+            direction[0] = unfoldedX / length;
+            direction[1] = unfoldedY / length;
+            direction[2] = z / length;
+        }
+    }
+
+    inline void DecodeOctahedralNormal(const std::byte* pEncoded, Float32 (&normal)[3]) {
+        Int16 encoded[2];
+        std::memcpy(encoded, pEncoded, sizeof(encoded));
+        VertexCompressionDetail::DecodeOctahedral(VertexCompressionDetail::DecodeSnorm(encoded[0], 32767.0f),
+                                                  VertexCompressionDetail::DecodeSnorm(encoded[1], 32767.0f), normal);
+    }
+
+    inline void DecodeOctahedralTangent(const std::byte* pEncoded, Float32 (&tangent)[4]) {
+        Int8 encoded[4];
+        std::memcpy(encoded, pEncoded, sizeof(encoded));
+
+        Float32 direction[3];
+        VertexCompressionDetail::DecodeOctahedral(VertexCompressionDetail::DecodeSnorm(encoded[0], 127.0f),
+                                                  VertexCompressionDetail::DecodeSnorm(encoded[1], 127.0f), direction);
+        std::copy_n(direction, 3, tangent);
+        tangent[3] = VertexCompressionDetail::DecodeSnorm(encoded[3], 127.0f);
+    }
+
+    inline Float32 HalfToFloat(const UInt16 half) {
+        const UInt32 sign = UInt32(half & 0x8000) << 16;
+        const UInt32 exponent = (half >> 10) & 0x1F;
+        const UInt32 mantissa = half & 0x3FF;
+        if (exponent == 0x1F) {
+            return std::bit_cast<Float32>(sign | 0x7F800000 | mantissa << 13);
+        }
+        if (exponent == 0) {
+            // Subnormal: the mantissa counts steps of 2^-24.
+            const Float32 magnitude = static_cast<Float32>(mantissa) * 5.9604644775390625e-8f;
+            return sign != 0 ? -magnitude : magnitude;
+        }
+
+        return std::bit_cast<Float32>(sign | (exponent + 112) << 23 | mantissa << 13);
+    }
+
+    inline void DecodeHalfTexCoord(const std::byte* pEncoded, Float32 (&texCoord)[2]) {
+        UInt16 encoded[2];
+        std::memcpy(encoded, pEncoded, sizeof(encoded));
+        texCoord[0] = HalfToFloat(encoded[0]);
+        texCoord[1] = HalfToFloat(encoded[1]);
+    }
+
+    inline void DecodeUnormColor(const std::byte* pEncoded, Float32 (&color)[4]) {
+        UInt8 encoded[4];
+        std::memcpy(encoded, pEncoded, sizeof(encoded));
+        for (UInt32 channel = 0; channel < 4; ++channel) {
+            color[channel] = static_cast<Float32>(encoded[channel]) / 255.0f;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_WORKSTEALINGDEQUE_HPP
+#define D3D12TESTS_WORKSTEALINGDEQUE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace D3D12Tests {
+    // Lock-free Chase-Lev deque of pointers with a fixed capacity. The owner thread pushes
+    // and pops at the bottom, any thread can steal from the top. See "Correct and Efficient
+    // Work-Stealing for Weak Memory Models" (Lê et al.) for the memory orderings.
+    template <class T>
+    class WorkStealingDeque {
+    public:
+        // The capacity is rounded up to a power of two.
+        explicit WorkStealingDeque(UInt64 capacity);
+        ~WorkStealingDeque() = default;
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque(WorkStealingDeque&&) = delete;
+
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+        // Owner thread only. Returns false when the deque is full.
+        bool Push(T* pItem);
+        // Owner thread only, most recently pushed item first. Returns nullptr when empty.
+        T* Pop();
+        // Any thread, oldest item first. Returns nullptr when empty or when losing a race.
+        T* Steal();
+
+        inline UInt64 GetCapacity() const;
+        // Approximate when other threads are using the deque.
+        inline UInt64 GetSize() const;
+
+    private:
+        // Indices never wrap, the slots are indexed modulo the capacity.
+        alignas(64) std::atomic<Int64> m_Top;
+        alignas(64) std::atomic<Int64> m_Bottom;
+        std::unique_ptr<std::atomic<T*>[]> m_Items;
+        UInt64 m_Mask;
+    };
+}
+
+#include "Framework/WorkStealingDeque.inl"
+
+#endif // D3D12TESTS_WORKSTEALINGDEQUE_HPP
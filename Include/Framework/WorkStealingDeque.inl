@@ -0,0 +1,90 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+
+namespace D3D12Tests {
+    template <class T>
+    WorkStealingDeque<T>::WorkStealingDeque(const UInt64 capacity) :
+        m_Top(0),
+        m_Bottom(0),
+        m_Items(std::make_unique<std::atomic<T*>[]>(std::bit_ceil(std::max<UInt64>(capacity, 1)))),
+        m_Mask(std::bit_ceil(std::max<UInt64>(capacity, 1)) - 1) {
+    }
+
+    template <class T>
+    bool WorkStealingDeque<T>::Push(T* pItem) {
+        const Int64 bottom = m_Bottom.load(std::memory_order_relaxed);
+        const Int64 top = m_Top.load(std::memory_order_acquire);
+        if (static_cast<UInt64>(bottom - top) > m_Mask) {
+            return false;
+        }
+
+        // A release store rather than the paper's release fence: same ordering on the stores
+        // that matter, and ThreadSanitizer, which does not model fences, can follow it.
+        m_Items[static_cast<UInt64>(bottom) & m_Mask].store(pItem, std::memory_order_relaxed);
+        m_Bottom.store(bottom + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    template <class T>
+    T* WorkStealingDeque<T>::Pop() {
+        const Int64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+        m_Bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Int64 top = m_Top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Empty, restore the bottom.
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* pItem = m_Items[static_cast<UInt64>(bottom) & m_Mask].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last item, race the thieves for it.
+            if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                pItem = nullptr;
+            }
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return pItem;
+    }
+
+    template <class T>
+    T* WorkStealingDeque<T>::Steal() {
+        Int64 top = m_Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Int64 bottom = m_Bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        T* pItem = m_Items[static_cast<UInt64>(top) & m_Mask].load(std::memory_order_relaxed);
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        return pItem;
+    }
+
+    template <class T>
+    inline UInt64 WorkStealingDeque<T>::GetCapacity() const {
+        return m_Mask + 1;
+    }
+
+    template <class T>
+    inline UInt64 WorkStealingDeque<T>::GetSize() const {
+        const Int64 bottom = m_Bottom.load(std::memory_order_relaxed);
+        const Int64 top = m_Top.load(std::memory_order_relaxed);
+
+        return bottom > top ? static_cast<UInt64>(bottom - top) : 0;
+    }
+}
@@ -27,6 +27,20 @@ namespace D3D12Tests {
                 _wcsnicmp(argv[i], L"/warp", wcslen(argv[i])) == 0) {
                 m_UseWarpDevice = true;
                 m_Title = m_Title + L" (WARP)";
+            } else if (_wcsicmp(argv[i], L"-uncapped") == 0 || _wcsicmp(argv[i], L"/uncapped") == 0) {
+                FramePacingDesc pacing = GetFramePacing();
+                pacing.Mode = FramePacingMode::Uncapped;
+                SetFramePacing(pacing);
+            } else if (_wcsicmp(argv[i], L"-lowlatency") == 0 || _wcsicmp(argv[i], L"/lowlatency") == 0) {
+                FramePacingDesc pacing = GetFramePacing();
+                pacing.Mode = FramePacingMode::LowLatency;
+                SetFramePacing(pacing);
+            } else if ((_wcsicmp(argv[i], L"-fps") == 0 || _wcsicmp(argv[i], L"/fps") == 0) && i + 1 < argc) {
+                // Fixed frame rate, e.g. "-fps 144".
+                FramePacingDesc pacing = GetFramePacing();
+                pacing.Mode = FramePacingMode::FixedRate;
+                pacing.TargetFrameRate = _wtof(argv[++i]);
+                SetFramePacing(pacing);
             }
         }
     }
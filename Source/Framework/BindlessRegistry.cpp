@@ -0,0 +1,116 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/BindlessRegistry.hpp"
+
+namespace D3D12Tests {
+    BindlessRegistry::BindlessRegistry(GpuTimeline& timeline, const UInt32 capacity) :
+        m_Timeline(timeline),
+        m_PendingHead(0),
+        m_PendingCount(0),
+        m_KnownCompletedValue(0),
+        m_QueriedSignalValue(0),
+        m_HighWaterMark(0),
+        m_LiveCount(0),
+        m_RetiredCount(0) {
+        if (capacity == 0 || capacity > MaxBindlessSlots) {
+            throw std::invalid_argument("The bindless registry capacity must be in [1, MaxBindlessSlots].");
+        }
+
+        // A slot is pending at most once, the FIFO never holds more than the capacity.
+        m_Slots.resize(capacity, 1);
+        m_FreeSlots.reserve(capacity);
+        m_Pending.resize(capacity);
+    }
+
+    BindlessHandle BindlessRegistry::Allocate() {
+        RecycleCompleted();
+
+        UInt32 index;
+        if (!m_FreeSlots.empty()) {
+            index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        } else if (m_HighWaterMark < GetCapacity()) {
+            index = m_HighWaterMark++;
+        } else {
+            if (m_PendingCount == 0) {
+                throw std::length_error("Every bindless slot is in use.");
+            }
+
+            // The oldest pending slot waits for a value that must have been signaled, or
+            // waiting on it would never return.
+            const UInt64 fenceValue = m_Pending[m_PendingHead].FenceValue;
+            if (fenceValue > m_Timeline.GetLastSignaledValue()) {
+                throw std::length_error("Every bindless slot is in use or freed since the last signal.");
+            }
+
+            m_Timeline.WaitForValue(fenceValue);
+            m_KnownCompletedValue = m_Timeline.GetCompletedValue();
+            RecycleCompleted();
+
+            index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+
+        m_Slots[index] |= LiveBit;
+        ++m_LiveCount;
+
+        return MakeBindlessHandle(index, m_Slots[index] & ~LiveBit);
+    }
+
+    void BindlessRegistry::Free(const BindlessHandle handle) {
+        if (!IsValid(handle)) {
+            throw std::invalid_argument("The bindless handle is invalid or stale.");
+        }
+
+        // The generation changes right away, the handles of the slot are stale from now on.
+        const UInt32 index = GetBindlessIndex(handle);
+        const UInt32 generation = GetBindlessGeneration(handle);
+        --m_LiveCount;
+
+        if (generation == MaxBindlessGeneration) {
+            m_Slots[index] = static_cast<UInt16>(generation);
+            ++m_RetiredCount;
+            return;
+        }
+
+        m_Slots[index] = static_cast<UInt16>(generation + 1);
+
+        // The GPU may read the descriptor until the next value signaled has completed.
+        UInt32 tail = m_PendingHead + m_PendingCount;
+        if (tail >= GetCapacity()) {
+            tail -= GetCapacity();
+        }
+        m_Pending[tail] = {m_Timeline.GetLastSignaledValue() + 1, index};
+        ++m_PendingCount;
+    }
+
+    void BindlessRegistry::RecycleCompleted() {
+        if (m_PendingCount == 0) {
+            return;
+        }
+
+        // Recycling keeps the part of the range in use small, but the completed value is only
+        // queried once per signal; slots completing later wait for the next signal, or for the
+        // range to be full.
+        const UInt64 fenceValue = m_Pending[m_PendingHead].FenceValue;
+        if (fenceValue > m_KnownCompletedValue) {
+            const UInt64 lastSignaledValue = m_Timeline.GetLastSignaledValue();
+            if (fenceValue > lastSignaledValue || m_QueriedSignalValue == lastSignaledValue) {
+                return;
+            }
+
+            m_QueriedSignalValue = lastSignaledValue;
+            m_KnownCompletedValue = m_Timeline.GetCompletedValue();
+        }
+
+        while (m_PendingCount != 0 && m_Pending[m_PendingHead].FenceValue <= m_KnownCompletedValue) {
+            m_FreeSlots.push_back(m_Pending[m_PendingHead].Index);
+            if (++m_PendingHead == GetCapacity()) {
+                m_PendingHead = 0;
+            }
+            --m_PendingCount;
+        }
+    }
+}
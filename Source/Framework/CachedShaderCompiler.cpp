@@ -0,0 +1,138 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/CachedShaderCompiler.hpp"
+
+#include "Framework/Hash.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace D3D12Tests {
+    namespace {
+        // Returns the name of an include directive, and whether it uses quotes rather than
+        // angle brackets, or an empty name if the line is not an include directive.
+        std::pair<std::string_view, bool> ParseInclude(std::string_view line) {
+            const auto skipSpaces = [&line] {
+                while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
+                    line.remove_prefix(1);
+                }
+            };
+
+            skipSpaces();
+            if (!line.starts_with('#')) {
+                return {};
+            }
+            line.remove_prefix(1);
+
+            skipSpaces();
+            if (!line.starts_with("include")) {
+                return {};
+            }
+            line.remove_prefix(7);
+
+            skipSpaces();
+            if (line.empty() || (line.front() != '"' && line.front() != '<')) {
+                return {};
+            }
+
+            const bool quoted = line.front() == '"';
+            const std::size_t end = line.find(quoted ? '"' : '>', 1);
+            if (end == std::string_view::npos) {
+                return {};
+            }
+
+            return {line.substr(1, end - 1), quoted};
+        }
+    }
+
+    CachedShaderCompiler::CachedShaderCompiler(ShaderCache& cache, ShaderCompiler& compiler) :
+        m_Cache(cache),
+        m_Compiler(compiler),
+        m_HitCount(0),
+        m_MissCount(0) {
+    }
+
+    std::span<const std::byte> CachedShaderCompiler::Compile(const ShaderCompileDesc& desc) {
+        const UInt64 key = ComputeKey(desc);
+
+        if (const std::span<const std::byte> bytecode = m_Cache.Find(key); !bytecode.empty()) {
+            ++m_HitCount;
+            return bytecode;
+        }
+
+        ++m_MissCount;
+        const std::vector<std::byte> bytecode = m_Compiler.Compile(desc);
+        return m_Cache.Insert(key, bytecode);
+    }
+
+    UInt64 CachedShaderCompiler::ComputeKey(const ShaderCompileDesc& desc) const {
+        std::vector<std::filesystem::path> visitedFiles;
+        UInt64 key = HashSourceFile(desc.SourcePath, desc.SourcePath.parent_path(), visitedFiles);
+
+        key = HashCombine(key, m_Compiler.GetVersionHash());
+        key = HashCombine(key, Hash64(desc.EntryPoint));
+        key = HashCombine(key, Hash64(desc.Target));
+        key = HashCombine(key, desc.Flags);
+        key = HashCombine(key, desc.Defines.size());
+        for (const ShaderDefine& define : desc.Defines) {
+            key = HashCombine(key, Hash64(define.Name));
+            key = HashCombine(key, Hash64(define.Value));
+        }
+
+        return key;
+    }
+
+    UInt64 CachedShaderCompiler::HashSourceFile(const std::filesystem::path& path,
+                                                const std::filesystem::path& rootDirectory,
+                                                std::vector<std::filesystem::path>& visitedFiles) const {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + path.string() + ".");
+        }
+        const std::string source{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        visitedFiles.push_back(std::filesystem::weakly_canonical(path));
+        UInt64 hash = Hash64(source);
+
+        for (std::size_t start = 0; start < source.size();) {
+            std::size_t end = source.find('\n', start);
+            if (end == std::string::npos) {
+                end = source.size();
+            }
+
+            const auto [name, quoted] = ParseInclude(std::string_view(source).substr(start, end - start));
+            start = end + 1;
+            if (name.empty()) {
+                continue;
+            }
+
+            // Same lookup as the standard include handler: quoted names are looked up next to
+            // the including file first, then next to the root source.
+            std::filesystem::path includePath = path.parent_path() / name;
+            if (!quoted || !std::filesystem::exists(includePath)) {
+                includePath = rootDirectory / name;
+            }
+
+            // Includes the compiler resolves by itself only contribute their name.
+            hash = HashCombine(hash, Hash64(name));
+            if (!std::filesystem::exists(includePath)) {
+                continue;
+            }
+
+            // Files included several times only need to be hashed once.
+            if (std::ranges::find(visitedFiles, std::filesystem::weakly_canonical(includePath)) !=
+                visitedFiles.end()) {
+                continue;
+            }
+
+            hash = HashCombine(hash, HashSourceFile(includePath, rootDirectory, visitedFiles));
+        }
+
+        return hash;
+    }
+}
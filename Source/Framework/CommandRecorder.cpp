@@ -0,0 +1,350 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/CommandRecorder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 GetStateBit(const GraphicsCommand command) {
+            return 1u << static_cast<UInt32>(command);
+        }
+
+        static_assert(static_cast<UInt32>(GraphicsCommand::Count) <= 32);
+
+        // Bits [first, end) of a 64-bit mask.
+        constexpr UInt64 GetBitRange(const UInt32 first, const UInt32 end) {
+            const UInt64 below = end == 64 ? ~UInt64(0) : (UInt64(1) << end) - 1;
+            return below & ~((UInt64(1) << first) - 1);
+        }
+
+        // Compared bitwise, so that -0 and NaN are never taken for the bound values. The
+        // fixed size compares are inlined, unlike a memcmp of the whole span.
+        template <class T>
+        bool IsSameState(const std::span<const T> values, const T* pBound) {
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (std::memcmp(&values[i], &pBound[i], sizeof(T)) != 0) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void CheckRootParameter(const UInt32 rootParameter) {
+            if (rootParameter >= MaxRootParameters) {
+                throw std::invalid_argument("Root parameter index out of range.");
+            }
+        }
+    }
+
+    CommandRecorder::CommandRecorder(GraphicsCommandList& commandList)
+        : m_CommandList(commandList) {
+    }
+
+    void CommandRecorder::Reset() {
+        DropRootArguments();
+        m_KnownState = 0;
+        m_KnownVertexBuffers = 0;
+    }
+
+    void CommandRecorder::SetPipelineState(ID3D12PipelineState* pPipelineState) {
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetPipelineState);
+        if ((m_KnownState & StateBit) != 0 && m_pPipelineState == pPipelineState) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownState |= StateBit;
+        m_pPipelineState = pPipelineState;
+        m_CommandList.SetPipelineState(pPipelineState);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) {
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetGraphicsRootSignature);
+        if ((m_KnownState & StateBit) != 0 && m_pRootSignature == pRootSignature) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        // The arguments pending for the previous signature would be reset before any draw.
+        DropRootArguments();
+        m_KnownState |= StateBit;
+        m_pRootSignature = pRootSignature;
+        m_CommandList.SetGraphicsRootSignature(pRootSignature);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::SetDescriptorHeaps(const std::span<ID3D12DescriptorHeap* const> heaps) {
+        if (heaps.size() > MaxDescriptorHeaps) {
+            throw std::invalid_argument("At most one CBV/SRV/UAV heap and one sampler heap can be bound.");
+        }
+
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetDescriptorHeaps);
+        if ((m_KnownState & StateBit) != 0 && m_DescriptorHeapCount == heaps.size() &&
+            std::equal(heaps.begin(), heaps.end(), m_DescriptorHeaps.begin())) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        // The pending tables point into the previous heaps, keep their order against the change.
+        FlushRootArguments();
+        m_KnownTables = 0;
+        m_KnownState |= StateBit;
+        m_DescriptorHeapCount = static_cast<UInt32>(heaps.size());
+        std::ranges::copy(heaps, m_DescriptorHeaps.begin());
+        m_CommandList.SetDescriptorHeaps(heaps);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::SetGraphicsRootDescriptorTable(const UInt32 rootParameter, const UInt64 baseDescriptor) {
+        CheckRootParameter(rootParameter);
+
+        ++m_Statistics.RecordedCalls;
+        const UInt64 parameterBit = UInt64(1) << rootParameter;
+        if ((m_KnownTables & parameterBit) != 0 && m_RootDescriptors[rootParameter] == baseDescriptor) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_RootDescriptors[rootParameter] = baseDescriptor;
+        m_KnownTables |= parameterBit;
+        m_DirtyTables |= parameterBit;
+        ++m_PendingRootCalls;
+    }
+
+    void CommandRecorder::SetGraphicsRoot32BitConstants(const UInt32 rootParameter, const std::span<const UInt32> values,
+                                                        const UInt32 destOffset) {
+        CheckRootParameter(rootParameter);
+        if (destOffset > MaxRootConstants || values.size() > MaxRootConstants - destOffset) {
+            throw std::invalid_argument("Root constants out of range.");
+        }
+
+        ++m_Statistics.RecordedCalls;
+        std::array<UInt32, MaxRootConstants>& constants = m_RootConstants[rootParameter];
+        const UInt64 known = m_KnownConstants[rootParameter];
+        UInt64 changed = 0;
+        for (UInt32 i = 0; i < values.size(); ++i) {
+            const UInt32 offset = destOffset + i;
+            if ((known >> offset & 1) == 0 || constants[offset] != values[i]) {
+                constants[offset] = values[i];
+                changed |= UInt64(1) << offset;
+            }
+        }
+
+        if (changed == 0) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownConstants[rootParameter] = known | changed;
+        m_DirtyConstants[rootParameter] |= changed;
+        m_DirtyConstantParameters |= UInt64(1) << rootParameter;
+        ++m_PendingRootCalls;
+    }
+
+    void CommandRecorder::SetGraphicsRootConstantBufferView(const UInt32 rootParameter, const UInt64 bufferLocation) {
+        CheckRootParameter(rootParameter);
+
+        ++m_Statistics.RecordedCalls;
+        const UInt64 parameterBit = UInt64(1) << rootParameter;
+        if ((m_KnownConstantBuffers & parameterBit) != 0 && m_RootDescriptors[rootParameter] == bufferLocation) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_RootDescriptors[rootParameter] = bufferLocation;
+        m_KnownConstantBuffers |= parameterBit;
+        m_DirtyConstantBuffers |= parameterBit;
+        ++m_PendingRootCalls;
+    }
+
+    void CommandRecorder::RSSetViewports(const std::span<const Viewport> viewports) {
+        if (viewports.size() > MaxViewports) {
+            throw std::invalid_argument("Too many viewports.");
+        }
+
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetViewports);
+        if ((m_KnownState & StateBit) != 0 && m_ViewportCount == viewports.size() &&
+            IsSameState(viewports, m_Viewports.data())) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownState |= StateBit;
+        m_ViewportCount = static_cast<UInt32>(viewports.size());
+        std::ranges::copy(viewports, m_Viewports.begin());
+        m_CommandList.RSSetViewports(viewports);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::RSSetScissorRects(const std::span<const ScissorRect> rects) {
+        if (rects.size() > MaxViewports) {
+            throw std::invalid_argument("Too many scissor rectangles.");
+        }
+
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetScissorRects);
+        if ((m_KnownState & StateBit) != 0 && m_ScissorRectCount == rects.size() &&
+            IsSameState(rects, m_ScissorRects.data())) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownState |= StateBit;
+        m_ScissorRectCount = static_cast<UInt32>(rects.size());
+        std::ranges::copy(rects, m_ScissorRects.begin());
+        m_CommandList.RSSetScissorRects(rects);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::IASetPrimitiveTopology(const PrimitiveTopology topology) {
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetPrimitiveTopology);
+        if ((m_KnownState & StateBit) != 0 && m_PrimitiveTopology == topology) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownState |= StateBit;
+        m_PrimitiveTopology = topology;
+        m_CommandList.IASetPrimitiveTopology(topology);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::IASetVertexBuffers(const UInt32 startSlot, const std::span<const VertexBufferView> views) {
+        if (startSlot > MaxVertexBuffers || views.size() > MaxVertexBuffers - startSlot) {
+            throw std::invalid_argument("Vertex buffer slots out of range.");
+        }
+
+        ++m_Statistics.RecordedCalls;
+        // Only the slots from the first to the last changed one are forwarded.
+        UInt32 first = MaxVertexBuffers;
+        UInt32 last = 0;
+        for (UInt32 i = 0; i < views.size(); ++i) {
+            const UInt32 slot = startSlot + i;
+            if ((m_KnownVertexBuffers >> slot & 1) == 0 ||
+                !IsSameState(views.subspan(i, 1), &m_VertexBuffers[slot])) {
+                m_VertexBuffers[slot] = views[i];
+                first = std::min(first, i);
+                last = i;
+            }
+        }
+
+        if (first == MaxVertexBuffers) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownVertexBuffers |= GetBitRange(startSlot + first, startSlot + last + 1);
+        m_CommandList.IASetVertexBuffers(startSlot + first, views.subspan(first, last - first + 1));
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::IASetIndexBuffer(const IndexBufferView* pView) {
+        ++m_Statistics.RecordedCalls;
+        constexpr UInt32 StateBit = GetStateBit(GraphicsCommand::SetIndexBuffer);
+        if ((m_KnownState & StateBit) != 0 && m_HasIndexBuffer == (pView != nullptr) &&
+            (pView == nullptr || IsSameState(std::span(pView, 1), &m_IndexBuffer))) {
+            ++m_Statistics.FilteredCalls;
+            return;
+        }
+
+        m_KnownState |= StateBit;
+        m_HasIndexBuffer = pView != nullptr;
+        if (pView != nullptr) {
+            m_IndexBuffer = *pView;
+        }
+        m_CommandList.IASetIndexBuffer(pView);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::DrawInstanced(const UInt32 vertexCountPerInstance, const UInt32 instanceCount,
+                                        const UInt32 startVertexLocation, const UInt32 startInstanceLocation) {
+        FlushRootArguments();
+        ++m_Statistics.RecordedCalls;
+        m_CommandList.DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::DrawIndexedInstanced(const UInt32 indexCountPerInstance, const UInt32 instanceCount,
+                                               const UInt32 startIndexLocation, const Int32 baseVertexLocation,
+                                               const UInt32 startInstanceLocation) {
+        FlushRootArguments();
+        ++m_Statistics.RecordedCalls;
+        m_CommandList.DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation,
+                                           startInstanceLocation);
+        ++m_Statistics.ForwardedCalls;
+    }
+
+    void CommandRecorder::FlushRootArguments() {
+        if (m_PendingRootCalls == 0) {
+            return;
+        }
+
+        UInt64 forwardedCalls = 0;
+        for (UInt64 parameters = m_DirtyTables; parameters != 0; parameters &= parameters - 1) {
+            const UInt32 parameter = static_cast<UInt32>(std::countr_zero(parameters));
+            m_CommandList.SetGraphicsRootDescriptorTable(parameter, m_RootDescriptors[parameter]);
+            ++forwardedCalls;
+        }
+
+        for (UInt64 parameters = m_DirtyConstantBuffers; parameters != 0; parameters &= parameters - 1) {
+            const UInt32 parameter = static_cast<UInt32>(std::countr_zero(parameters));
+            m_CommandList.SetGraphicsRootConstantBufferView(parameter, m_RootDescriptors[parameter]);
+            ++forwardedCalls;
+        }
+
+        // One call per run of known constants holding dirty ones, from the first to the last
+        // dirty constant of the run: the known ones in between are set to their bound value.
+        for (UInt64 parameters = m_DirtyConstantParameters; parameters != 0; parameters &= parameters - 1) {
+            const UInt32 parameter = static_cast<UInt32>(std::countr_zero(parameters));
+            const UInt64 known = m_KnownConstants[parameter];
+            UInt64 dirty = m_DirtyConstants[parameter];
+            while (dirty != 0) {
+                const UInt32 first = static_cast<UInt32>(std::countr_zero(dirty));
+                const UInt32 runEnd = first + static_cast<UInt32>(std::countr_one(known >> first));
+                const UInt64 runDirty = dirty & GetBitRange(first, runEnd);
+                const UInt32 last = 63 - static_cast<UInt32>(std::countl_zero(runDirty));
+
+                const std::span<const UInt32> values(&m_RootConstants[parameter][first], last - first + 1);
+                m_CommandList.SetGraphicsRoot32BitConstants(parameter, values, first);
+                ++forwardedCalls;
+                dirty &= ~runDirty;
+            }
+            m_DirtyConstants[parameter] = 0;
+        }
+
+        m_Statistics.ForwardedCalls += forwardedCalls;
+        m_Statistics.CoalescedCalls += m_PendingRootCalls - forwardedCalls;
+        m_DirtyTables = 0;
+        m_DirtyConstantBuffers = 0;
+        m_DirtyConstantParameters = 0;
+        m_PendingRootCalls = 0;
+    }
+
+    void CommandRecorder::DropRootArguments() {
+        m_Statistics.CoalescedCalls += m_PendingRootCalls;
+        m_PendingRootCalls = 0;
+
+        m_KnownTables = 0;
+        m_KnownConstantBuffers = 0;
+        m_DirtyTables = 0;
+        m_DirtyConstantBuffers = 0;
+        for (UInt64 parameters = m_DirtyConstantParameters; parameters != 0; parameters &= parameters - 1) {
+            m_DirtyConstants[static_cast<UInt32>(std::countr_zero(parameters))] = 0;
+        }
+        m_DirtyConstantParameters = 0;
+        m_KnownConstants.fill(0);
+    }
+}
@@ -0,0 +1,212 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ConstantBufferAllocator.hpp"
+
+#include <limits>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 InvalidPage = ConstantBufferAllocator::InvalidPage;
+
+        constexpr UInt32 GetStackTop(const UInt64 head) {
+            return static_cast<UInt32>(head);
+        }
+
+        constexpr UInt64 MakeStackHead(const UInt64 previousHead, const UInt32 top) {
+            return ((previousHead >> 32) + 1) << 32 | top;
+        }
+    }
+
+    ConstantBufferAllocator::ConstantBufferAllocator(GpuTimeline& timeline, std::byte* cpuBase, const UInt64 gpuBase,
+                                                     const UInt64 capacity, const UInt64 pageSize) :
+        m_Timeline(timeline),
+        m_CpuBase(cpuBase),
+        m_GpuBase(gpuBase),
+        m_PageSize(pageSize),
+        m_PageCount(0),
+        m_FreePages(InvalidPage),
+        m_RetiredPages(InvalidPage),
+        m_FreePageCount(0),
+        m_RetiredPageCount(0),
+        m_WaitCount(0) {
+        if (pageSize == 0 || pageSize % Alignment::ConstantBuffer != 0 || pageSize > MaxPageSize ||
+            gpuBase % Alignment::ConstantBuffer != 0) {
+            throw std::invalid_argument("Constant buffer pages must be 256-byte aligned and at most 2 GiB.");
+        }
+
+        const UInt64 pageCount = capacity / pageSize;
+        if (pageCount == 0 || pageCount >= InvalidPage) {
+            throw std::invalid_argument("The capacity must hold at least one page.");
+        }
+
+        m_PageCount = static_cast<UInt32>(pageCount);
+        m_Pages = std::make_unique<Page[]>(m_PageCount);
+        for (UInt32 page = 0; page < m_PageCount; ++page) {
+            m_Pages[page].Next.store(page + 1 < m_PageCount ? page + 1 : InvalidPage, std::memory_order_relaxed);
+        }
+        m_FreePages.store(0, std::memory_order_relaxed);
+        m_FreePageCount.store(m_PageCount, std::memory_order_relaxed);
+    }
+
+    UInt32 ConstantBufferAllocator::AcquirePage() {
+        UInt32 page = PopPage(m_FreePages);
+        if (page == InvalidPage) {
+            std::lock_guard lock(m_RecycleMutex);
+            // Another thread may have recycled pages while this one was waiting for the lock.
+            page = PopPage(m_FreePages);
+            if (page == InvalidPage) {
+                page = RecyclePages(m_Timeline.GetLastSignaledValue() + 1);
+            }
+        }
+
+        m_FreePageCount.fetch_sub(1, std::memory_order_relaxed);
+        return page;
+    }
+
+    void ConstantBufferAllocator::RetirePage(const UInt32 page) {
+        // Whatever was written in the page is consumed by work submitted before the next signal.
+        m_Pages[page].FenceValue = m_Timeline.GetLastSignaledValue() + 1;
+        PushPages(m_RetiredPages, page, page);
+        m_RetiredPageCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    UInt32 ConstantBufferAllocator::RecyclePages(const UInt64 fenceValue) {
+        const UInt32 retiredPages = TakePages(m_RetiredPages);
+
+        // Only query the fence when out of pages, it is not free on real hardware.
+        UInt64 completedValue = m_Timeline.GetCompletedValue();
+        UInt64 oldestFenceValue = std::numeric_limits<UInt64>::max();
+        UInt32 lastRetiredPage = InvalidPage;
+        for (UInt32 page = retiredPages; page != InvalidPage; page = m_Pages[page].Next.load(std::memory_order_relaxed)) {
+            oldestFenceValue = std::min(oldestFenceValue, m_Pages[page].FenceValue);
+            lastRetiredPage = page;
+        }
+
+        if (oldestFenceValue > completedValue) {
+            // Pages retired since the last signal cannot be waited for: the work using them
+            // has not been submitted yet.
+            if (oldestFenceValue >= fenceValue) {
+                if (retiredPages != InvalidPage) {
+                    PushPages(m_RetiredPages, retiredPages, lastRetiredPage);
+                }
+
+                throw std::length_error("The page pool is too small for the constants of the work in flight.");
+            }
+
+            m_WaitCount.fetch_add(1, std::memory_order_relaxed);
+            m_Timeline.WaitForValue(oldestFenceValue);
+            completedValue = std::max(completedValue, oldestFenceValue);
+        }
+
+        // Keep the first completed page, free the other completed ones and retire the rest
+        // again.
+        UInt32 acquiredPage = InvalidPage;
+        UInt32 firstFreePage = InvalidPage;
+        UInt32 lastFreePage = InvalidPage;
+        UInt32 firstRetiredPage = InvalidPage;
+        lastRetiredPage = InvalidPage;
+        UInt32 recycledCount = 0;
+        for (UInt32 page = retiredPages; page != InvalidPage;) {
+            const UInt32 next = m_Pages[page].Next.load(std::memory_order_relaxed);
+            if (m_Pages[page].FenceValue > completedValue) {
+                m_Pages[page].Next.store(firstRetiredPage, std::memory_order_relaxed);
+                lastRetiredPage = firstRetiredPage == InvalidPage ? page : lastRetiredPage;
+                firstRetiredPage = page;
+            }
+            else {
+                if (acquiredPage == InvalidPage) {
+                    acquiredPage = page;
+                }
+                else {
+                    m_Pages[page].Next.store(firstFreePage, std::memory_order_relaxed);
+                    lastFreePage = firstFreePage == InvalidPage ? page : lastFreePage;
+                    firstFreePage = page;
+                }
+                ++recycledCount;
+            }
+            page = next;
+        }
+
+        if (firstRetiredPage != InvalidPage) {
+            PushPages(m_RetiredPages, firstRetiredPage, lastRetiredPage);
+        }
+        if (firstFreePage != InvalidPage) {
+            PushPages(m_FreePages, firstFreePage, lastFreePage);
+        }
+
+        // The acquired page is counted as free until AcquirePage takes it.
+        m_RetiredPageCount.fetch_sub(recycledCount, std::memory_order_relaxed);
+        m_FreePageCount.fetch_add(recycledCount, std::memory_order_relaxed);
+
+        return acquiredPage;
+    }
+
+    UInt32 ConstantBufferAllocator::PopPage(std::atomic<UInt64>& stack) {
+        UInt64 head = stack.load(std::memory_order_acquire);
+        for (;;) {
+            const UInt32 top = GetStackTop(head);
+            if (top == InvalidPage) {
+                return InvalidPage;
+            }
+
+            // The next page is stale if the top was popped meanwhile, the count then fails
+            // the exchange.
+            const UInt32 next = m_Pages[top].Next.load(std::memory_order_relaxed);
+            if (stack.compare_exchange_weak(head, MakeStackHead(head, next), std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                return top;
+            }
+        }
+    }
+
+    void ConstantBufferAllocator::PushPages(std::atomic<UInt64>& stack, const UInt32 firstPage, const UInt32 lastPage) {
+        UInt64 head = stack.load(std::memory_order_relaxed);
+        for (;;) {
+            m_Pages[lastPage].Next.store(GetStackTop(head), std::memory_order_relaxed);
+            if (stack.compare_exchange_weak(head, MakeStackHead(head, firstPage), std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    UInt32 ConstantBufferAllocator::TakePages(std::atomic<UInt64>& stack) {
+        UInt64 head = stack.load(std::memory_order_acquire);
+        while (!stack.compare_exchange_weak(head, MakeStackHead(head, InvalidPage), std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+        }
+
+        return GetStackTop(head);
+    }
+
+    ConstantBufferContext::ConstantBufferContext(ConstantBufferAllocator& allocator) :
+        m_Allocator(allocator),
+        m_CpuAddress(nullptr),
+        m_GpuAddress(0),
+        // Full, so that the first allocation acquires a page.
+        m_Offset(allocator.GetPageSize()),
+        m_Page(ConstantBufferAllocator::InvalidPage) {
+    }
+
+    ConstantBufferContext::~ConstantBufferContext() {
+        Retire();
+    }
+
+    void ConstantBufferContext::Retire() {
+        if (m_Page != ConstantBufferAllocator::InvalidPage) {
+            m_Allocator.RetirePage(m_Page);
+            m_Page = ConstantBufferAllocator::InvalidPage;
+            m_Offset = m_Allocator.GetPageSize();
+        }
+    }
+
+    void ConstantBufferContext::NextPage() {
+        Retire();
+        m_Page = m_Allocator.AcquirePage();
+        m_CpuAddress = m_Allocator.GetPageCpuAddress(m_Page);
+        m_GpuAddress = m_Allocator.GetPageGpuAddress(m_Page);
+        m_Offset = 0;
+    }
+}
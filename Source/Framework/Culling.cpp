@@ -0,0 +1,154 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/Culling.hpp"
+
+#include "Framework/ParallelFor.hpp"
+
+#include "CullingKernels.inl"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef D3D12TESTS_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        using namespace CullingDetail;
+
+#ifdef D3D12TESTS_ARCH_X86
+        struct Sse2Ops {
+            static constexpr UInt32 Width = 4;
+
+            using Float = __m128;
+            using Mask = __m128;
+
+            static Float Set(const Float32 value) { return _mm_set1_ps(value); }
+            static Float Load(const Float32* pValues) { return _mm_loadu_ps(pValues); }
+
+            static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm_max_ps(a, b); }
+            static Float Abs(const Float value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+
+            static Mask GreaterEqual(const Float a, const Float b) { return _mm_cmpge_ps(a, b); }
+            static Mask LessEqual(const Float a, const Float b) { return _mm_cmple_ps(a, b); }
+            static Mask And(const Mask a, const Mask b) { return _mm_and_ps(a, b); }
+            static UInt32 MoveMask(const Mask mask) { return static_cast<UInt32>(_mm_movemask_ps(mask)); }
+
+            // SSE2 has no shuffle by variable, the visible lanes are written one by one.
+            static UInt32 StoreIndices(UInt32* pVisible, const UInt32 firstIndex, UInt32 bits) {
+                UInt32 count = 0;
+                while (bits != 0) {
+                    pVisible[count++] = firstIndex + static_cast<UInt32>(std::countr_zero(bits));
+                    bits &= bits - 1;
+                }
+
+                return count;
+            }
+        };
+#endif
+
+        struct CullFunctions {
+            CullFunction Scalar;
+            CullFunction Sse2;
+            CullFunction Avx2;
+        };
+
+        UInt32 Cull(const CullDesc& desc, const UInt32 objectCount, const std::span<UInt32> visible,
+                    const CullingOptions& options, const CullFunctions& functions) {
+            if (visible.size() < objectCount) {
+                throw std::invalid_argument("The visible indices are fewer than the objects.");
+            }
+            if (objectCount == 0) {
+                return 0;
+            }
+
+            CullFunction function = functions.Scalar;
+            switch (std::min(options.MaxSimdLevel, GetSimdLevel())) {
+                case SimdLevel::Scalar:
+                    break;
+                case SimdLevel::SSE2:
+                    function = functions.Sse2;
+                    break;
+                case SimdLevel::AVX2:
+                    function = functions.Avx2;
+                    break;
+            }
+
+            const UInt32 rangeCount = GetParallelRangeCount(objectCount, options.ThreadCount, options.MinObjectsPerThread);
+            if (rangeCount <= 1) {
+                return function(desc, 0, objectCount, visible.data());
+            }
+
+            // Each range writes its indices at its own start, whole vectors apart, and the
+            // slices are then moved next to each other in order.
+            const UInt64 rangeSize = ((objectCount + rangeCount - 1) / rangeCount + 7) & ~UInt64(7);
+            std::vector<UInt32> rangeVisibleCounts(rangeCount, 0);
+            ParallelFor(rangeCount, rangeCount, [&](const UInt64 firstRange, const UInt64 lastRange) {
+                for (UInt64 range = firstRange; range < lastRange; ++range) {
+                    const UInt64 begin = std::min<UInt64>(range * rangeSize, objectCount);
+                    const UInt64 end = std::min<UInt64>(begin + rangeSize, objectCount);
+                    rangeVisibleCounts[range] = function(desc, begin, end, visible.data() + begin);
+                }
+            });
+
+            UInt32 visibleCount = rangeVisibleCounts[0];
+            for (UInt32 range = 1; range < rangeCount; ++range) {
+                const UInt32* pRangeVisible = visible.data() + std::min<UInt64>(range * rangeSize, objectCount);
+                std::copy_n(pRangeVisible, rangeVisibleCounts[range], visible.data() + visibleCount);
+                visibleCount += rangeVisibleCounts[range];
+            }
+
+            return visibleCount;
+        }
+    }
+
+    UInt32 CullSpheres(const BoundingSphereSet& spheres, const CullingFrustum& frustum, const std::span<UInt32> visible,
+                       const CullingOptions& options) {
+        CullFunctions functions;
+        functions.Scalar = CullObjects<ScalarOps, SphereKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = CullObjects<Sse2Ops, SphereKernel>;
+        functions.Avx2 = CullSpheresAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        CullDesc desc;
+        desc.CenterX = spheres.GetCenterX();
+        desc.CenterY = spheres.GetCenterY();
+        desc.CenterZ = spheres.GetCenterZ();
+        desc.ExtentX = spheres.GetRadii();
+        desc.Frustum = frustum;
+
+        return Cull(desc, spheres.GetCount(), visible, options, functions);
+    }
+
+    UInt32 CullBoxes(const BoundingBoxSet& boxes, const CullingFrustum& frustum, const std::span<UInt32> visible,
+                     const CullingOptions& options) {
+        CullFunctions functions;
+        functions.Scalar = CullObjects<ScalarOps, BoxKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = CullObjects<Sse2Ops, BoxKernel>;
+        functions.Avx2 = CullBoxesAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        CullDesc desc;
+        desc.CenterX = boxes.GetCenterX();
+        desc.CenterY = boxes.GetCenterY();
+        desc.CenterZ = boxes.GetCenterZ();
+        desc.ExtentX = boxes.GetExtentX();
+        desc.ExtentY = boxes.GetExtentY();
+        desc.ExtentZ = boxes.GetExtentZ();
+        desc.Frustum = frustum;
+
+        return Cull(desc, boxes.GetCount(), visible, options, functions);
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/Culling.hpp"
+
+#ifdef D3D12TESTS_ARCH_X86
+
+// The standard headers are included before the AVX2 region, so that their inline functions
+// are not compiled for it and then picked by the linker for the other files.
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include <immintrin.h>
+
+// Only the kernels of this file are compiled for AVX2; they are only called once the CPU
+// support has been checked. MSVC does not need a flag to use the intrinsics.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "CullingKernels.inl"
+
+namespace D3D12Tests::CullingDetail {
+    namespace {
+        // For each mask of 8 lanes, the visible lanes in order, then zeros.
+        constexpr std::array<UInt64, 256> MakeCompactLanes() {
+            std::array<UInt64, 256> table{};
+            for (UInt32 bits = 0; bits < 256; ++bits) {
+                UInt32 count = 0;
+                for (UInt32 lane = 0; lane < 8; ++lane) {
+                    if ((bits & 1u << lane) != 0) {
+                        table[bits] |= UInt64(lane) << count++ * 8;
+                    }
+                }
+            }
+
+            return table;
+        }
+
+        constexpr std::array<UInt64, 256> CompactLanes = MakeCompactLanes();
+
+        struct Avx2Ops {
+            static constexpr UInt32 Width = 8;
+
+            using Float = __m256;
+            using Mask = __m256;
+
+            static Float Set(const Float32 value) { return _mm256_set1_ps(value); }
+            static Float Load(const Float32* pValues) { return _mm256_loadu_ps(pValues); }
+
+            static Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm256_max_ps(a, b); }
+            static Float Abs(const Float value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value); }
+
+            static Mask GreaterEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            static Mask LessEqual(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+            static Mask And(const Mask a, const Mask b) { return _mm256_and_ps(a, b); }
+            static UInt32 MoveMask(const Mask mask) { return static_cast<UInt32>(_mm256_movemask_ps(mask)); }
+
+            // Writes all 8 lanes, the visible indices first, without a branch per object.
+            static UInt32 StoreIndices(UInt32* pVisible, const UInt32 firstIndex, const UInt32 bits) {
+                const __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&CompactLanes[bits])));
+                const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(firstIndex)), lanes);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pVisible), indices);
+
+                return static_cast<UInt32>(std::popcount(bits));
+            }
+        };
+    }
+
+    UInt32 CullSpheresAvx2(const CullDesc& desc, const UInt64 begin, const UInt64 end, UInt32* pVisible) {
+        return CullObjects<Avx2Ops, SphereKernel>(desc, begin, end, pVisible);
+    }
+
+    UInt32 CullBoxesAvx2(const CullDesc& desc, const UInt64 begin, const UInt64 end, UInt32* pVisible) {
+        return CullObjects<Avx2Ops, BoxKernel>(desc, begin, end, pVisible);
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+// Culling tests written once against a set of vector operations like the procedural texture
+// kernels (ScalarOps here, Sse2Ops and Avx2Ops in the files including it). Each vector tests
+// Width objects, then writes the indices of the visible ones next to each other.
+
+#include "Framework/Culling.hpp"
+
+#include <bit>
+#include <cmath>
+
+namespace D3D12Tests::CullingDetail {
+    struct CullDesc {
+        const Float32* CenterX = nullptr;
+        const Float32* CenterY = nullptr;
+        const Float32* CenterZ = nullptr;
+        // Radii for the spheres, half extents for the boxes.
+        const Float32* ExtentX = nullptr;
+        const Float32* ExtentY = nullptr;
+        const Float32* ExtentZ = nullptr;
+        CullingFrustum Frustum;
+    };
+
+    // Culls the objects of [begin, end), writing the visible ones from pVisible on. Returns
+    // their count.
+    using CullFunction = UInt32(*)(const CullDesc&, UInt64, UInt64, UInt32*);
+
+#ifdef D3D12TESTS_ARCH_X86
+    // Defined in CullingAvx2.cpp.
+    UInt32 CullSpheresAvx2(const CullDesc& desc, UInt64 begin, UInt64 end, UInt32* pVisible);
+    UInt32 CullBoxesAvx2(const CullDesc& desc, UInt64 begin, UInt64 end, UInt32* pVisible);
+#endif
+
+    namespace {
+        struct ScalarOps {
+            static constexpr UInt32 Width = 1;
+
+            using Float = Float32;
+            using Mask = bool;
+
+            static Float Set(const Float32 value) { return value; }
+            static Float Load(const Float32* pValues) { return *pValues; }
+
+            static Float Add(const Float a, const Float b) { return a + b; }
+            static Float Sub(const Float a, const Float b) { return a - b; }
+            static Float Mul(const Float a, const Float b) { return a * b; }
+            static Float Max(const Float a, const Float b) { return a > b ? a : b; }
+            static Float Abs(const Float value) { return std::abs(value); }
+
+            static Mask GreaterEqual(const Float a, const Float b) { return a >= b; }
+            static Mask LessEqual(const Float a, const Float b) { return a <= b; }
+            static Mask And(const Mask a, const Mask b) { return a && b; }
+            static UInt32 MoveMask(const Mask mask) { return mask ? 1 : 0; }
+
+            // Writes the index unconditionally and counts it if visible, without a branch.
+            static UInt32 StoreIndices(UInt32* pVisible, const UInt32 firstIndex, const UInt32 bits) {
+                *pVisible = firstIndex;
+                return bits;
+            }
+        };
+
+        // The frustum in vectors, loaded once per range.
+        template <class TOps>
+        struct FrustumConstants {
+            using Float = typename TOps::Float;
+
+            explicit FrustumConstants(const CullingFrustum& frustum) {
+                for (UInt32 plane = 0; plane < 6; ++plane) {
+                    for (UInt32 coefficient = 0; coefficient < 4; ++coefficient) {
+                        Planes[plane][coefficient] = TOps::Set(frustum.Planes[plane][coefficient]);
+                    }
+                    for (UInt32 axis = 0; axis < 3; ++axis) {
+                        AbsPlanes[plane][axis] = TOps::Set(std::abs(frustum.Planes[plane][axis]));
+                    }
+                }
+                for (UInt32 axis = 0; axis < 3; ++axis) {
+                    Origin[axis] = TOps::Set(frustum.Origin[axis]);
+                }
+                MinDistance = TOps::Set(frustum.MinDistance);
+                MaxDistance = TOps::Set(frustum.MaxDistance);
+                MinDistanceSquared = TOps::Set(frustum.MinDistance * frustum.MinDistance);
+                MaxDistanceSquared = TOps::Set(frustum.MaxDistance * frustum.MaxDistance);
+                Zero = TOps::Set(0.0f);
+            }
+
+            Float Planes[6][4];
+            Float AbsPlanes[6][3];
+            Float Origin[3];
+            Float MinDistance;
+            Float MaxDistance;
+            Float MinDistanceSquared;
+            Float MaxDistanceSquared;
+            Float Zero;
+        };
+
+        template <class TOps>
+        typename TOps::Float DistanceToPlane(const FrustumConstants<TOps>& constants, const UInt32 plane,
+                                             const typename TOps::Float x, const typename TOps::Float y,
+                                             const typename TOps::Float z) {
+            const auto& coefficients = constants.Planes[plane];
+            return TOps::Add(TOps::Add(TOps::Mul(x, coefficients[0]), TOps::Mul(y, coefficients[1])),
+                             TOps::Add(TOps::Mul(z, coefficients[2]), coefficients[3]));
+        }
+
+        struct SphereKernel {
+            // A sphere is out when its center is farther than its radius behind a plane, or
+            // when it is entirely out of the distance range.
+            template <class TOps>
+            static typename TOps::Mask Test(const CullDesc& desc, const FrustumConstants<TOps>& constants, const UInt64 index) {
+                using Float = typename TOps::Float;
+
+                const Float x = TOps::Load(desc.CenterX + index);
+                const Float y = TOps::Load(desc.CenterY + index);
+                const Float z = TOps::Load(desc.CenterZ + index);
+                const Float radius = TOps::Load(desc.ExtentX + index);
+
+                typename TOps::Mask visible = TOps::GreaterEqual(TOps::Add(DistanceToPlane(constants, 0, x, y, z), radius),
+                                                                 constants.Zero);
+                for (UInt32 plane = 1; plane < 6; ++plane) {
+                    visible = TOps::And(visible, TOps::GreaterEqual(TOps::Add(DistanceToPlane(constants, plane, x, y, z), radius),
+                                                                    constants.Zero));
+                }
+
+                const Float dx = TOps::Sub(x, constants.Origin[0]);
+                const Float dy = TOps::Sub(y, constants.Origin[1]);
+                const Float dz = TOps::Sub(z, constants.Origin[2]);
+                const Float distanceSquared = TOps::Add(TOps::Add(TOps::Mul(dx, dx), TOps::Mul(dy, dy)), TOps::Mul(dz, dz));
+                const Float farLimit = TOps::Add(constants.MaxDistance, radius);
+                const Float nearLimit = TOps::Max(TOps::Sub(constants.MinDistance, radius), constants.Zero);
+                visible = TOps::And(visible, TOps::LessEqual(distanceSquared, TOps::Mul(farLimit, farLimit)));
+                return TOps::And(visible, TOps::GreaterEqual(distanceSquared, TOps::Mul(nearLimit, nearLimit)));
+            }
+        };
+
+        struct BoxKernel {
+            // A box is out when its corner the most along the normal of a plane is behind it, or
+            // when its closest point is past the maximum distance, or its farthest point within
+            // the minimum one.
+            template <class TOps>
+            static typename TOps::Mask Test(const CullDesc& desc, const FrustumConstants<TOps>& constants, const UInt64 index) {
+                using Float = typename TOps::Float;
+
+                const Float x = TOps::Load(desc.CenterX + index);
+                const Float y = TOps::Load(desc.CenterY + index);
+                const Float z = TOps::Load(desc.CenterZ + index);
+                const Float extentX = TOps::Load(desc.ExtentX + index);
+                const Float extentY = TOps::Load(desc.ExtentY + index);
+                const Float extentZ = TOps::Load(desc.ExtentZ + index);
+
+                typename TOps::Mask visible{};
+                for (UInt32 plane = 0; plane < 6; ++plane) {
+                    const auto& absPlane = constants.AbsPlanes[plane];
+                    const Float reach = TOps::Add(TOps::Add(TOps::Mul(extentX, absPlane[0]), TOps::Mul(extentY, absPlane[1])),
+                                                  TOps::Mul(extentZ, absPlane[2]));
+                    const typename TOps::Mask inside = TOps::GreaterEqual(TOps::Add(DistanceToPlane(constants, plane, x, y, z), reach),
+                                                                          constants.Zero);
+                    visible = plane == 0 ? inside : TOps::And(visible, inside);
+                }
+
+                const Float dx = TOps::Abs(TOps::Sub(x, constants.Origin[0]));
+                const Float dy = TOps::Abs(TOps::Sub(y, constants.Origin[1]));
+                const Float dz = TOps::Abs(TOps::Sub(z, constants.Origin[2]));
+                const Float nearX = TOps::Max(TOps::Sub(dx, extentX), constants.Zero);
+                const Float nearY = TOps::Max(TOps::Sub(dy, extentY), constants.Zero);
+                const Float nearZ = TOps::Max(TOps::Sub(dz, extentZ), constants.Zero);
+                const Float farX = TOps::Add(dx, extentX);
+                const Float farY = TOps::Add(dy, extentY);
+                const Float farZ = TOps::Add(dz, extentZ);
+                const Float nearSquared = TOps::Add(TOps::Add(TOps::Mul(nearX, nearX), TOps::Mul(nearY, nearY)), TOps::Mul(nearZ, nearZ));
+                const Float farSquared = TOps::Add(TOps::Add(TOps::Mul(farX, farX), TOps::Mul(farY, farY)), TOps::Mul(farZ, farZ));
+                visible = TOps::And(visible, TOps::LessEqual(nearSquared, constants.MaxDistanceSquared));
+                return TOps::And(visible, TOps::GreaterEqual(farSquared, constants.MinDistanceSquared));
+            }
+        };
+
+        // Whole vectors of objects, then the remaining ones one at a time. The indices of a
+        // vector are written at the current count, which stays at most the number of objects
+        // tested, so that the writes stay within [pVisible, pVisible + end - begin).
+        template <class TOps, class TKernel>
+        UInt32 CullObjects(const CullDesc& desc, const UInt64 begin, const UInt64 end, UInt32* pVisible) {
+            UInt32 count = 0;
+            UInt64 index = begin;
+            if constexpr (TOps::Width > 1) {
+                const FrustumConstants<TOps> constants(desc.Frustum);
+                for (; index + TOps::Width <= end; index += TOps::Width) {
+                    const UInt32 bits = TOps::MoveMask(TKernel::template Test<TOps>(desc, constants, index));
+                    count += TOps::StoreIndices(pVisible + count, static_cast<UInt32>(index), bits);
+                }
+            }
+
+            const FrustumConstants<ScalarOps> constants(desc.Frustum);
+            for (; index < end; ++index) {
+                const UInt32 bits = ScalarOps::MoveMask(TKernel::template Test<ScalarOps>(desc, constants, index));
+                count += ScalarOps::StoreIndices(pVisible + count, static_cast<UInt32>(index), bits);
+            }
+
+            return count;
+        }
+    }
+}
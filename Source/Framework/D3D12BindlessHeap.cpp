@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12BindlessHeap.hpp"
+
+namespace D3D12Tests {
+    D3D12BindlessHeap::D3D12BindlessHeap(ID3D12Device* pDevice, GpuTimeline& timeline, const UInt32 capacity) :
+        m_Device(pDevice),
+        m_Registry(timeline, capacity),
+        m_DescriptorSize(pDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)) {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.NumDescriptors = capacity;
+        heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        ThrowIfFailed(pDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_Heap)));
+        NAME_D3D12_OBJECT(m_Heap);
+
+        m_CpuStart = m_Heap->GetCPUDescriptorHandleForHeapStart();
+        m_GpuStart = m_Heap->GetGPUDescriptorHandleForHeapStart();
+    }
+
+    BindlessHandle D3D12BindlessHeap::Register(const D3D12_CPU_DESCRIPTOR_HANDLE source) {
+        const BindlessHandle handle = m_Registry.Allocate();
+        m_Device->CopyDescriptorsSimple(1, GetCpuHandle(handle), source, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+        return handle;
+    }
+
+    void D3D12BindlessHeap::Free(const BindlessHandle handle) {
+        m_Registry.Free(handle);
+    }
+
+    void D3D12BindlessHeap::InitDescriptorRanges(CD3DX12_DESCRIPTOR_RANGE1 (&ranges)[DescriptorRangeCount]) {
+        // Slots are written while the table is bound by frames in flight, the descriptors are
+        // volatile. Both ranges start at the table start, as they alias the same slots.
+        ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, SrvRegisterSpace,
+                       D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE |
+                       D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE, 0);
+        ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, UavRegisterSpace,
+                       D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE,
+                       0);
+    }
+}
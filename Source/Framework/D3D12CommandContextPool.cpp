@@ -0,0 +1,37 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12CommandContextPool.hpp"
+
+namespace D3D12Tests {
+    D3D12CommandContextPool::D3D12CommandContextPool(ID3D12Device* pDevice, GpuTimeline& timeline,
+                                                     const D3D12_COMMAND_LIST_TYPE type) :
+        m_Device(pDevice),
+        m_Type(type),
+        m_Pool(timeline, [this] { return CreateContext(); }) {
+    }
+
+    D3D12CommandContext D3D12CommandContextPool::Acquire(ID3D12PipelineState* pInitialState) {
+        D3D12CommandContext context = m_Pool.Acquire();
+
+        // The pool guarantees that the GPU is done with the allocator, so both the
+        // allocator and the command list can be reset.
+        ThrowIfFailed(context.CommandAllocator->Reset());
+        ThrowIfFailed(context.CommandList->Reset(context.CommandAllocator.Get(), pInitialState));
+
+        return context;
+    }
+
+    D3D12CommandContext D3D12CommandContextPool::CreateContext() const {
+        D3D12CommandContext context;
+        ThrowIfFailed(m_Device->CreateCommandAllocator(m_Type, IID_PPV_ARGS(&context.CommandAllocator)));
+        ThrowIfFailed(m_Device->CreateCommandList(0, m_Type, context.CommandAllocator.Get(), nullptr,
+                                                  IID_PPV_ARGS(&context.CommandList)));
+
+        // Keep every context in the same (closed) state whether it is new or recycled.
+        ThrowIfFailed(context.CommandList->Close());
+
+        return context;
+    }
+}
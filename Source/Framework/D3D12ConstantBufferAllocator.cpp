@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12ConstantBufferAllocator.hpp"
+
+namespace D3D12Tests {
+    D3D12ConstantBufferAllocator::D3D12ConstantBufferAllocator(ID3D12Device* pDevice, GpuTimeline& timeline,
+                                                               const UInt64 capacity, const UInt64 pageSize) :
+        m_Buffer(CreateBuffer(pDevice, capacity)),
+        m_Allocator(timeline, MapBuffer(m_Buffer.Get()), m_Buffer->GetGPUVirtualAddress(), capacity, pageSize) {
+    }
+
+    D3D12ConstantBufferAllocator::~D3D12ConstantBufferAllocator() {
+        m_Buffer->Unmap(0, nullptr);
+    }
+
+    ComPtr<ID3D12Resource> D3D12ConstantBufferAllocator::CreateBuffer(ID3D12Device* pDevice, const UInt64 capacity) {
+        ComPtr<ID3D12Resource> buffer;
+
+        auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+        auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(capacity);
+        ThrowIfFailed(pDevice->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&buffer)));
+        SetName(buffer.Get(), L"D3D12ConstantBufferAllocator");
+
+        return buffer;
+    }
+
+    std::byte* D3D12ConstantBufferAllocator::MapBuffer(ID3D12Resource* pBuffer) {
+        // The pages are written while the GPU reads the ones of the previous frames, the
+        // buffer is only unmapped on destruction.
+        void* pData;
+        CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resources on the CPU.
+        ThrowIfFailed(pBuffer->Map(0, &readRange, &pData));
+
+        return static_cast<std::byte*>(pData);
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12DescriptorHeap.hpp"
+
+namespace D3D12Tests {
+    D3D12DescriptorHeap::D3D12DescriptorHeap(ID3D12Device* pDevice, const D3D12_DESCRIPTOR_HEAP_TYPE type,
+                                             const UInt32 capacity) :
+        m_Allocator(capacity),
+        m_Type(type),
+        m_DescriptorSize(pDevice->GetDescriptorHandleIncrementSize(type)) {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.NumDescriptors = capacity;
+        heapDesc.Type = type;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+        ThrowIfFailed(pDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_Heap)));
+        NAME_D3D12_OBJECT(m_Heap);
+
+        m_CpuStart = m_Heap->GetCPUDescriptorHandleForHeapStart();
+    }
+
+    D3D12DescriptorRange D3D12DescriptorHeap::Allocate(const UInt32 count) {
+        const UInt32 index = m_Allocator.Allocate(count);
+        if (index == RangeAllocator::InvalidIndex) {
+            throw std::length_error("The descriptor heap has no free range large enough.");
+        }
+
+        return {CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CpuStart, static_cast<INT>(index), m_DescriptorSize), index, count};
+    }
+
+    void D3D12DescriptorHeap::Free(const D3D12DescriptorRange& range) {
+        m_Allocator.Free(range.Index, range.Count);
+    }
+}
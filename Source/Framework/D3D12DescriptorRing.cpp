@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12DescriptorRing.hpp"
+
+#include <vector>
+
+namespace D3D12Tests {
+    D3D12DescriptorRing::D3D12DescriptorRing(ID3D12Device* pDevice, GpuTimeline& timeline,
+                                             const D3D12_DESCRIPTOR_HEAP_TYPE type, const UInt32 capacity) :
+        m_Device(pDevice),
+        m_Allocator(timeline, capacity),
+        m_Type(type),
+        m_DescriptorSize(pDevice->GetDescriptorHandleIncrementSize(type)) {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.NumDescriptors = capacity;
+        heapDesc.Type = type;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        ThrowIfFailed(pDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_Heap)));
+        NAME_D3D12_OBJECT(m_Heap);
+
+        m_CpuStart = m_Heap->GetCPUDescriptorHandleForHeapStart();
+        m_GpuStart = m_Heap->GetGPUDescriptorHandleForHeapStart();
+    }
+
+    D3D12DescriptorTable D3D12DescriptorRing::Allocate(const UInt32 count) {
+        const auto index = static_cast<INT>(m_Allocator.Allocate(count, 1));
+
+        return {
+            CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CpuStart, index, m_DescriptorSize),
+            CD3DX12_GPU_DESCRIPTOR_HANDLE(m_GpuStart, index, m_DescriptorSize),
+            count
+        };
+    }
+
+    D3D12DescriptorTable D3D12DescriptorRing::CopyTable(const D3D12DescriptorRange& source) {
+        const D3D12DescriptorTable table = Allocate(source.Count);
+        m_Device->CopyDescriptorsSimple(source.Count, table.CpuHandle, source.CpuHandle, m_Type);
+
+        return table;
+    }
+
+    D3D12DescriptorTable D3D12DescriptorRing::CopyTable(const D3D12_CPU_DESCRIPTOR_HANDLE* pSources,
+                                                        const UInt32 count) {
+        const D3D12DescriptorTable table = Allocate(count);
+
+        // One destination range, count source ranges of a single descriptor each.
+        const std::vector<UINT> sourceSizes(count, 1);
+        m_Device->CopyDescriptors(1, &table.CpuHandle, &count, count, pSources, sourceSizes.data(), m_Type);
+
+        return table;
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12GpuTimeline.hpp"
+
+#include "Framework/Profiler.hpp"
+
+namespace D3D12Tests {
+    D3D12GpuTimeline::D3D12GpuTimeline(ID3D12Device* pDevice, ID3D12CommandQueue* pCommandQueue) :
+        m_CommandQueue(pCommandQueue),
+        m_FenceEvent(nullptr) {
+        ThrowIfFailed(pDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
+        NAME_D3D12_OBJECT(m_Fence);
+
+        // Create an event handler to use for frame synchronization.
+        m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (m_FenceEvent == nullptr) {
+            ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+        }
+    }
+
+    D3D12GpuTimeline::~D3D12GpuTimeline() {
+        CloseHandle(m_FenceEvent);
+    }
+
+    UInt64 D3D12GpuTimeline::Signal() {
+        const UInt64 value = m_LastSignaledValue.load(std::memory_order_relaxed) + 1;
+        ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), value));
+        m_LastSignaledValue.store(value, std::memory_order_release);
+
+        return value;
+    }
+
+    UInt64 D3D12GpuTimeline::GetCompletedValue() {
+        return m_Fence->GetCompletedValue();
+    }
+
+    void D3D12GpuTimeline::WaitForValue(const UInt64 value) {
+        if (m_Fence->GetCompletedValue() >= value) {
+            return;
+        }
+
+        D3D12TESTS_PROFILE_SCOPE("D3D12GpuTimeline::WaitForValue");
+        std::lock_guard lock(m_WaitMutex);
+        ThrowIfFailed(m_Fence->SetEventOnCompletion(value, m_FenceEvent));
+        WaitForSingleObject(m_FenceEvent, INFINITE);
+    }
+}
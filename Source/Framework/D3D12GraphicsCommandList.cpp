@@ -0,0 +1,100 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12GraphicsCommandList.hpp"
+
+#include <cstddef>
+
+namespace D3D12Tests {
+    static_assert(sizeof(Viewport) == sizeof(D3D12_VIEWPORT));
+    static_assert(offsetof(Viewport, TopLeftX) == offsetof(D3D12_VIEWPORT, TopLeftX));
+    static_assert(offsetof(Viewport, TopLeftY) == offsetof(D3D12_VIEWPORT, TopLeftY));
+    static_assert(offsetof(Viewport, Width) == offsetof(D3D12_VIEWPORT, Width));
+    static_assert(offsetof(Viewport, Height) == offsetof(D3D12_VIEWPORT, Height));
+    static_assert(offsetof(Viewport, MinDepth) == offsetof(D3D12_VIEWPORT, MinDepth));
+    static_assert(offsetof(Viewport, MaxDepth) == offsetof(D3D12_VIEWPORT, MaxDepth));
+    static_assert(sizeof(ScissorRect) == sizeof(D3D12_RECT));
+    static_assert(offsetof(ScissorRect, Left) == offsetof(D3D12_RECT, left));
+    static_assert(offsetof(ScissorRect, Top) == offsetof(D3D12_RECT, top));
+    static_assert(offsetof(ScissorRect, Right) == offsetof(D3D12_RECT, right));
+    static_assert(offsetof(ScissorRect, Bottom) == offsetof(D3D12_RECT, bottom));
+    static_assert(sizeof(VertexBufferView) == sizeof(D3D12_VERTEX_BUFFER_VIEW));
+    static_assert(offsetof(VertexBufferView, BufferLocation) == offsetof(D3D12_VERTEX_BUFFER_VIEW, BufferLocation));
+    static_assert(offsetof(VertexBufferView, SizeInBytes) == offsetof(D3D12_VERTEX_BUFFER_VIEW, SizeInBytes));
+    static_assert(offsetof(VertexBufferView, StrideInBytes) == offsetof(D3D12_VERTEX_BUFFER_VIEW, StrideInBytes));
+    static_assert(sizeof(IndexBufferView) == sizeof(D3D12_INDEX_BUFFER_VIEW));
+    static_assert(offsetof(IndexBufferView, BufferLocation) == offsetof(D3D12_INDEX_BUFFER_VIEW, BufferLocation));
+    static_assert(offsetof(IndexBufferView, SizeInBytes) == offsetof(D3D12_INDEX_BUFFER_VIEW, SizeInBytes));
+    static_assert(offsetof(IndexBufferView, Format) == offsetof(D3D12_INDEX_BUFFER_VIEW, Format));
+    static_assert(static_cast<UInt32>(PrimitiveTopology::PointList) == D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
+    static_assert(static_cast<UInt32>(PrimitiveTopology::LineList) == D3D_PRIMITIVE_TOPOLOGY_LINELIST);
+    static_assert(static_cast<UInt32>(PrimitiveTopology::LineStrip) == D3D_PRIMITIVE_TOPOLOGY_LINESTRIP);
+    static_assert(static_cast<UInt32>(PrimitiveTopology::TriangleList) == D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    static_assert(static_cast<UInt32>(PrimitiveTopology::TriangleStrip) == D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    static_assert(MaxViewports == D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+    static_assert(MaxVertexBuffers == D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+    D3D12GraphicsCommandList::D3D12GraphicsCommandList(ID3D12GraphicsCommandList* pCommandList)
+        : m_pCommandList(pCommandList) {
+    }
+
+    void D3D12GraphicsCommandList::SetPipelineState(ID3D12PipelineState* pPipelineState) {
+        m_pCommandList->SetPipelineState(pPipelineState);
+    }
+
+    void D3D12GraphicsCommandList::SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) {
+        m_pCommandList->SetGraphicsRootSignature(pRootSignature);
+    }
+
+    void D3D12GraphicsCommandList::SetDescriptorHeaps(const std::span<ID3D12DescriptorHeap* const> heaps) {
+        m_pCommandList->SetDescriptorHeaps(static_cast<UINT>(heaps.size()), heaps.data());
+    }
+
+    void D3D12GraphicsCommandList::SetGraphicsRootDescriptorTable(const UInt32 rootParameter, const UInt64 baseDescriptor) {
+        m_pCommandList->SetGraphicsRootDescriptorTable(rootParameter, D3D12_GPU_DESCRIPTOR_HANDLE{baseDescriptor});
+    }
+
+    void D3D12GraphicsCommandList::SetGraphicsRoot32BitConstants(const UInt32 rootParameter, const std::span<const UInt32> values,
+                                                                 const UInt32 destOffset) {
+        m_pCommandList->SetGraphicsRoot32BitConstants(rootParameter, static_cast<UINT>(values.size()), values.data(), destOffset);
+    }
+
+    void D3D12GraphicsCommandList::SetGraphicsRootConstantBufferView(const UInt32 rootParameter, const UInt64 bufferLocation) {
+        m_pCommandList->SetGraphicsRootConstantBufferView(rootParameter, bufferLocation);
+    }
+
+    void D3D12GraphicsCommandList::RSSetViewports(const std::span<const Viewport> viewports) {
+        m_pCommandList->RSSetViewports(static_cast<UINT>(viewports.size()),
+                                       reinterpret_cast<const D3D12_VIEWPORT*>(viewports.data()));
+    }
+
+    void D3D12GraphicsCommandList::RSSetScissorRects(const std::span<const ScissorRect> rects) {
+        m_pCommandList->RSSetScissorRects(static_cast<UINT>(rects.size()), reinterpret_cast<const D3D12_RECT*>(rects.data()));
+    }
+
+    void D3D12GraphicsCommandList::IASetPrimitiveTopology(const PrimitiveTopology topology) {
+        m_pCommandList->IASetPrimitiveTopology(static_cast<D3D12_PRIMITIVE_TOPOLOGY>(topology));
+    }
+
+    void D3D12GraphicsCommandList::IASetVertexBuffers(const UInt32 startSlot, const std::span<const VertexBufferView> views) {
+        m_pCommandList->IASetVertexBuffers(startSlot, static_cast<UINT>(views.size()),
+                                           reinterpret_cast<const D3D12_VERTEX_BUFFER_VIEW*>(views.data()));
+    }
+
+    void D3D12GraphicsCommandList::IASetIndexBuffer(const IndexBufferView* pView) {
+        m_pCommandList->IASetIndexBuffer(reinterpret_cast<const D3D12_INDEX_BUFFER_VIEW*>(pView));
+    }
+
+    void D3D12GraphicsCommandList::DrawInstanced(const UInt32 vertexCountPerInstance, const UInt32 instanceCount,
+                                                 const UInt32 startVertexLocation, const UInt32 startInstanceLocation) {
+        m_pCommandList->DrawInstanced(vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation);
+    }
+
+    void D3D12GraphicsCommandList::DrawIndexedInstanced(const UInt32 indexCountPerInstance, const UInt32 instanceCount,
+                                                        const UInt32 startIndexLocation, const Int32 baseVertexLocation,
+                                                        const UInt32 startInstanceLocation) {
+        m_pCommandList->DrawIndexedInstanced(indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation,
+                                             startInstanceLocation);
+    }
+}
@@ -0,0 +1,257 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12PipelineRegistry.hpp"
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    D3D12PipelineRegistry::D3D12PipelineRegistry(ID3D12Device* pDevice) :
+        m_Device(pDevice),
+        m_Registry([this](const GraphicsPipelineDesc& desc) {
+            return CreatePipeline(desc);
+        }) {
+    }
+
+    UInt64 D3D12PipelineRegistry::RegisterRootSignature(ID3D12RootSignature* pRootSignature, const void* pSerialized,
+                                                        const std::size_t size) {
+        const UInt64 hash = HashBlob(pSerialized, size);
+        if (pRootSignature == nullptr || hash == 0) {
+            throw std::invalid_argument("A root signature must be registered with its serialized blob.");
+        }
+
+        std::lock_guard lock(m_Mutex);
+        m_RootSignatures.try_emplace(hash, pRootSignature);
+        m_RootSignatureHashes[pRootSignature] = hash;
+
+        return hash;
+    }
+
+    UInt64 D3D12PipelineRegistry::RegisterShader(const D3D12_SHADER_BYTECODE& bytecode) {
+        const UInt64 hash = HashBlob(bytecode.pShaderBytecode, bytecode.BytecodeLength);
+        if (hash == 0) {
+            return 0;
+        }
+
+        std::lock_guard lock(m_Mutex);
+        if (!m_Shaders.contains(hash)) {
+            const auto* pBytecode = static_cast<const std::byte*>(bytecode.pShaderBytecode);
+            m_Shaders.emplace(hash, std::vector(pBytecode, pBytecode + bytecode.BytecodeLength));
+        }
+
+        return hash;
+    }
+
+    ComPtr<ID3D12PipelineState> D3D12PipelineRegistry::GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) {
+        return m_Registry.GetOrCreate(ToPipelineDesc(desc));
+    }
+
+    std::size_t D3D12PipelineRegistry::Prewarm() {
+        return m_Registry.Prewarm([this](const GraphicsPipelineDesc& desc) {
+            return IsCreatable(desc);
+        });
+    }
+
+    GraphicsPipelineDesc D3D12PipelineRegistry::ToPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) {
+        if (desc.StreamOutput.NumEntries != 0 || desc.CachedPSO.CachedBlobSizeInBytes != 0) {
+            throw std::invalid_argument("Pipelines with stream output or a cached blob cannot be registered.");
+        }
+
+        GraphicsPipelineDesc pipelineDesc;
+        {
+            std::lock_guard lock(m_Mutex);
+            const auto it = m_RootSignatureHashes.find(desc.pRootSignature);
+            if (it == m_RootSignatureHashes.end()) {
+                throw std::invalid_argument("The root signature of the pipeline is not registered.");
+            }
+
+            pipelineDesc.RootSignature = it->second;
+        }
+
+        pipelineDesc.VS = RegisterShader(desc.VS);
+        pipelineDesc.PS = RegisterShader(desc.PS);
+        pipelineDesc.DS = RegisterShader(desc.DS);
+        pipelineDesc.HS = RegisterShader(desc.HS);
+        pipelineDesc.GS = RegisterShader(desc.GS);
+
+        pipelineDesc.InputLayout.reserve(desc.InputLayout.NumElements);
+        for (UINT i = 0; i < desc.InputLayout.NumElements; ++i) {
+            const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+            pipelineDesc.InputLayout.push_back({
+                element.SemanticName, element.SemanticIndex, static_cast<UInt32>(element.Format), element.InputSlot,
+                element.AlignedByteOffset, static_cast<UInt32>(element.InputSlotClass), element.InstanceDataStepRate
+            });
+        }
+
+        pipelineDesc.BlendState.AlphaToCoverageEnable = desc.BlendState.AlphaToCoverageEnable != FALSE;
+        pipelineDesc.BlendState.IndependentBlendEnable = desc.BlendState.IndependentBlendEnable != FALSE;
+        for (UInt32 i = 0; i < MaxRenderTargets; ++i) {
+            const D3D12_RENDER_TARGET_BLEND_DESC& renderTarget = desc.BlendState.RenderTarget[i];
+            pipelineDesc.BlendState.RenderTargets[i] = {
+                renderTarget.BlendEnable != FALSE, renderTarget.LogicOpEnable != FALSE,
+                static_cast<UInt32>(renderTarget.SrcBlend), static_cast<UInt32>(renderTarget.DestBlend),
+                static_cast<UInt32>(renderTarget.BlendOp), static_cast<UInt32>(renderTarget.SrcBlendAlpha),
+                static_cast<UInt32>(renderTarget.DestBlendAlpha), static_cast<UInt32>(renderTarget.BlendOpAlpha),
+                static_cast<UInt32>(renderTarget.LogicOp), renderTarget.RenderTargetWriteMask
+            };
+        }
+
+        pipelineDesc.SampleMask = desc.SampleMask;
+
+        const D3D12_RASTERIZER_DESC& rasterizer = desc.RasterizerState;
+        pipelineDesc.RasterizerState = {
+            static_cast<UInt32>(rasterizer.FillMode), static_cast<UInt32>(rasterizer.CullMode),
+            rasterizer.FrontCounterClockwise != FALSE, rasterizer.DepthBias, rasterizer.DepthBiasClamp,
+            rasterizer.SlopeScaledDepthBias, rasterizer.DepthClipEnable != FALSE, rasterizer.MultisampleEnable != FALSE,
+            rasterizer.AntialiasedLineEnable != FALSE, rasterizer.ForcedSampleCount,
+            static_cast<UInt32>(rasterizer.ConservativeRaster)
+        };
+
+        const auto toStencilOp = [](const D3D12_DEPTH_STENCILOP_DESC& op) {
+            return PipelineStencilOp{
+                static_cast<UInt32>(op.StencilFailOp), static_cast<UInt32>(op.StencilDepthFailOp),
+                static_cast<UInt32>(op.StencilPassOp), static_cast<UInt32>(op.StencilFunc)
+            };
+        };
+
+        const D3D12_DEPTH_STENCIL_DESC& depthStencil = desc.DepthStencilState;
+        pipelineDesc.DepthStencilState = {
+            depthStencil.DepthEnable != FALSE, static_cast<UInt32>(depthStencil.DepthWriteMask),
+            static_cast<UInt32>(depthStencil.DepthFunc), depthStencil.StencilEnable != FALSE,
+            depthStencil.StencilReadMask, depthStencil.StencilWriteMask,
+            toStencilOp(depthStencil.FrontFace), toStencilOp(depthStencil.BackFace)
+        };
+
+        pipelineDesc.IBStripCutValue = static_cast<UInt32>(desc.IBStripCutValue);
+        pipelineDesc.PrimitiveTopologyType = static_cast<UInt32>(desc.PrimitiveTopologyType);
+        pipelineDesc.NumRenderTargets = desc.NumRenderTargets;
+        for (UInt32 i = 0; i < MaxRenderTargets; ++i) {
+            pipelineDesc.RTVFormats[i] = static_cast<UInt32>(desc.RTVFormats[i]);
+        }
+        pipelineDesc.DSVFormat = static_cast<UInt32>(desc.DSVFormat);
+        pipelineDesc.SampleCount = desc.SampleDesc.Count;
+        pipelineDesc.SampleQuality = desc.SampleDesc.Quality;
+        pipelineDesc.NodeMask = desc.NodeMask;
+        pipelineDesc.Flags = static_cast<UInt32>(desc.Flags);
+
+        return pipelineDesc;
+    }
+
+    ComPtr<ID3D12PipelineState> D3D12PipelineRegistry::CreatePipeline(const GraphicsPipelineDesc& desc) {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC d3d12Desc = {};
+        {
+            std::lock_guard lock(m_Mutex);
+            const auto it = m_RootSignatures.find(desc.RootSignature);
+            if (it == m_RootSignatures.end()) {
+                throw std::invalid_argument("The root signature of the pipeline is not registered.");
+            }
+
+            d3d12Desc.pRootSignature = it->second.Get();
+        }
+
+        // The bytecode is never removed, the pointers stay valid without the lock.
+        d3d12Desc.VS = GetShader(desc.VS);
+        d3d12Desc.PS = GetShader(desc.PS);
+        d3d12Desc.DS = GetShader(desc.DS);
+        d3d12Desc.HS = GetShader(desc.HS);
+        d3d12Desc.GS = GetShader(desc.GS);
+
+        // The semantic names point into the description, which outlives the call.
+        std::vector<D3D12_INPUT_ELEMENT_DESC> inputElements;
+        inputElements.reserve(desc.InputLayout.size());
+        for (const PipelineInputElement& element : desc.InputLayout) {
+            inputElements.push_back({
+                element.SemanticName.c_str(), element.SemanticIndex, static_cast<DXGI_FORMAT>(element.Format),
+                element.InputSlot, element.AlignedByteOffset,
+                static_cast<D3D12_INPUT_CLASSIFICATION>(element.InputSlotClass), element.InstanceDataStepRate
+            });
+        }
+        d3d12Desc.InputLayout = {inputElements.data(), static_cast<UINT>(inputElements.size())};
+
+        d3d12Desc.BlendState.AlphaToCoverageEnable = desc.BlendState.AlphaToCoverageEnable;
+        d3d12Desc.BlendState.IndependentBlendEnable = desc.BlendState.IndependentBlendEnable;
+        for (UInt32 i = 0; i < MaxRenderTargets; ++i) {
+            const PipelineRenderTargetBlend& renderTarget = desc.BlendState.RenderTargets[i];
+            d3d12Desc.BlendState.RenderTarget[i] = {
+                renderTarget.BlendEnable, renderTarget.LogicOpEnable,
+                static_cast<D3D12_BLEND>(renderTarget.SrcBlend), static_cast<D3D12_BLEND>(renderTarget.DestBlend),
+                static_cast<D3D12_BLEND_OP>(renderTarget.BlendOp), static_cast<D3D12_BLEND>(renderTarget.SrcBlendAlpha),
+                static_cast<D3D12_BLEND>(renderTarget.DestBlendAlpha),
+                static_cast<D3D12_BLEND_OP>(renderTarget.BlendOpAlpha), static_cast<D3D12_LOGIC_OP>(renderTarget.LogicOp),
+                renderTarget.RenderTargetWriteMask
+            };
+        }
+
+        d3d12Desc.SampleMask = desc.SampleMask;
+
+        const PipelineRasterizerState& rasterizer = desc.RasterizerState;
+        d3d12Desc.RasterizerState = {
+            static_cast<D3D12_FILL_MODE>(rasterizer.FillMode), static_cast<D3D12_CULL_MODE>(rasterizer.CullMode),
+            rasterizer.FrontCounterClockwise, rasterizer.DepthBias, rasterizer.DepthBiasClamp,
+            rasterizer.SlopeScaledDepthBias, rasterizer.DepthClipEnable, rasterizer.MultisampleEnable,
+            rasterizer.AntialiasedLineEnable, rasterizer.ForcedSampleCount,
+            static_cast<D3D12_CONSERVATIVE_RASTERIZATION_MODE>(rasterizer.ConservativeRaster)
+        };
+
+        const auto toStencilOp = [](const PipelineStencilOp& op) {
+            return D3D12_DEPTH_STENCILOP_DESC{
+                static_cast<D3D12_STENCIL_OP>(op.StencilFailOp), static_cast<D3D12_STENCIL_OP>(op.StencilDepthFailOp),
+                static_cast<D3D12_STENCIL_OP>(op.StencilPassOp), static_cast<D3D12_COMPARISON_FUNC>(op.StencilFunc)
+            };
+        };
+
+        const PipelineDepthStencilState& depthStencil = desc.DepthStencilState;
+        d3d12Desc.DepthStencilState = {
+            depthStencil.DepthEnable, static_cast<D3D12_DEPTH_WRITE_MASK>(depthStencil.DepthWriteMask),
+            static_cast<D3D12_COMPARISON_FUNC>(depthStencil.DepthFunc), depthStencil.StencilEnable,
+            depthStencil.StencilReadMask, depthStencil.StencilWriteMask,
+            toStencilOp(depthStencil.FrontFace), toStencilOp(depthStencil.BackFace)
+        };
+
+        d3d12Desc.IBStripCutValue = static_cast<D3D12_INDEX_BUFFER_STRIP_CUT_VALUE>(desc.IBStripCutValue);
+        d3d12Desc.PrimitiveTopologyType = static_cast<D3D12_PRIMITIVE_TOPOLOGY_TYPE>(desc.PrimitiveTopologyType);
+        d3d12Desc.NumRenderTargets = desc.NumRenderTargets;
+        for (UInt32 i = 0; i < MaxRenderTargets; ++i) {
+            d3d12Desc.RTVFormats[i] = static_cast<DXGI_FORMAT>(desc.RTVFormats[i]);
+        }
+        d3d12Desc.DSVFormat = static_cast<DXGI_FORMAT>(desc.DSVFormat);
+        d3d12Desc.SampleDesc = {desc.SampleCount, desc.SampleQuality};
+        d3d12Desc.NodeMask = desc.NodeMask;
+        d3d12Desc.Flags = static_cast<D3D12_PIPELINE_STATE_FLAGS>(desc.Flags);
+
+        ComPtr<ID3D12PipelineState> pipelineState;
+        ThrowIfFailed(m_Device->CreateGraphicsPipelineState(&d3d12Desc, IID_PPV_ARGS(&pipelineState)));
+
+        return pipelineState;
+    }
+
+    bool D3D12PipelineRegistry::IsCreatable(const GraphicsPipelineDesc& desc) const {
+        std::lock_guard lock(m_Mutex);
+        if (!m_RootSignatures.contains(desc.RootSignature)) {
+            return false;
+        }
+
+        for (const UInt64 shader : {desc.VS, desc.PS, desc.DS, desc.HS, desc.GS}) {
+            if (shader != 0 && !m_Shaders.contains(shader)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    D3D12_SHADER_BYTECODE D3D12PipelineRegistry::GetShader(const UInt64 hash) const {
+        if (hash == 0) {
+            return {};
+        }
+
+        std::lock_guard lock(m_Mutex);
+        const auto it = m_Shaders.find(hash);
+        if (it == m_Shaders.end()) {
+            throw std::invalid_argument("A shader of the pipeline is not registered.");
+        }
+
+        return {it->second.data(), it->second.size()};
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12ResourceStateTable.hpp"
+
+namespace D3D12Tests {
+    static_assert(static_cast<UInt32>(ResourceState::VertexAndConstantBuffer) ==
+        D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    static_assert(static_cast<UInt32>(ResourceState::IndexBuffer) == D3D12_RESOURCE_STATE_INDEX_BUFFER);
+    static_assert(static_cast<UInt32>(ResourceState::RenderTarget) == D3D12_RESOURCE_STATE_RENDER_TARGET);
+    static_assert(static_cast<UInt32>(ResourceState::UnorderedAccess) == D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    static_assert(static_cast<UInt32>(ResourceState::DepthWrite) == D3D12_RESOURCE_STATE_DEPTH_WRITE);
+    static_assert(static_cast<UInt32>(ResourceState::DepthRead) == D3D12_RESOURCE_STATE_DEPTH_READ);
+    static_assert(static_cast<UInt32>(ResourceState::NonPixelShaderResource) ==
+        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    static_assert(static_cast<UInt32>(ResourceState::PixelShaderResource) ==
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    static_assert(static_cast<UInt32>(ResourceState::StreamOut) == D3D12_RESOURCE_STATE_STREAM_OUT);
+    static_assert(static_cast<UInt32>(ResourceState::IndirectArgument) == D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+    static_assert(static_cast<UInt32>(ResourceState::CopyDest) == D3D12_RESOURCE_STATE_COPY_DEST);
+    static_assert(static_cast<UInt32>(ResourceState::CopySource) == D3D12_RESOURCE_STATE_COPY_SOURCE);
+    static_assert(static_cast<UInt32>(ResourceState::ResolveDest) == D3D12_RESOURCE_STATE_RESOLVE_DEST);
+    static_assert(static_cast<UInt32>(ResourceState::ResolveSource) == D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
+    static_assert(static_cast<UInt32>(ResourceState::GenericRead) == D3D12_RESOURCE_STATE_GENERIC_READ);
+    static_assert(static_cast<UInt32>(ResourceState::Present) == D3D12_RESOURCE_STATE_PRESENT);
+    static_assert(AllSubresources == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    static_assert(static_cast<UInt32>(ResourceBarrierFlags::BeginOnly) == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+    static_assert(static_cast<UInt32>(ResourceBarrierFlags::EndOnly) == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+
+    UInt32 D3D12ResourceStateTable::Register(ID3D12Resource* pResource, const D3D12_RESOURCE_STATES initialState) {
+        const UInt32 resource = m_Table.Register(GetSubresourceCount(pResource),
+                                                 static_cast<ResourceState>(initialState));
+        if (resource >= m_Resources.size()) {
+            m_Resources.resize(static_cast<std::size_t>(resource) + 1, nullptr);
+        }
+
+        m_Resources[resource] = pResource;
+        return resource;
+    }
+
+    void D3D12ResourceStateTable::Unregister(const UInt32 resource) {
+        m_Table.Unregister(resource);
+        m_Resources[resource] = nullptr;
+    }
+
+    void D3D12ResourceStateTable::RecordBarriers(ID3D12GraphicsCommandList* pCommandList,
+                                                 const std::span<const ResourceBarrier> barriers) {
+        if (barriers.empty()) {
+            return;
+        }
+
+        TranslateBarriers(barriers, m_Barriers);
+        pCommandList->ResourceBarrier(static_cast<UINT>(m_Barriers.size()), m_Barriers.data());
+    }
+
+    void D3D12ResourceStateTable::TranslateBarriers(const std::span<const ResourceBarrier> barriers,
+                                                    std::vector<D3D12_RESOURCE_BARRIER>& d3d12Barriers) const {
+        d3d12Barriers.resize(barriers.size());
+
+        for (std::size_t i = 0; i < barriers.size(); ++i) {
+            const ResourceBarrier& barrier = barriers[i];
+            D3D12_RESOURCE_BARRIER& d3d12Barrier = d3d12Barriers[i];
+
+            d3d12Barrier.Flags = static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(barrier.Flags);
+            if (barrier.Type == ResourceBarrierType::UnorderedAccess) {
+                d3d12Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+                d3d12Barrier.UAV.pResource = m_Resources[barrier.Resource];
+            } else if (barrier.Type == ResourceBarrierType::Aliasing) {
+                d3d12Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+                d3d12Barrier.Aliasing.pResourceBefore = nullptr;
+                d3d12Barrier.Aliasing.pResourceAfter = m_Resources[barrier.Resource];
+            } else {
+                d3d12Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                d3d12Barrier.Transition.pResource = m_Resources[barrier.Resource];
+                d3d12Barrier.Transition.Subresource = barrier.Subresource;
+                d3d12Barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(barrier.StateBefore);
+                d3d12Barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(barrier.StateAfter);
+            }
+        }
+    }
+
+    UInt32 D3D12ResourceStateTable::GetSubresourceCount(ID3D12Resource* pResource) {
+        const D3D12_RESOURCE_DESC desc = pResource->GetDesc();
+        if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+            return 1;
+        }
+
+        ComPtr<ID3D12Device> device;
+        ThrowIfFailed(pResource->GetDevice(IID_PPV_ARGS(&device)));
+
+        // Planar formats (e.g. depth-stencil) have a set of subresources per plane.
+        const UInt32 arraySize = desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1 : desc.DepthOrArraySize;
+        return desc.MipLevels * arraySize * D3D12GetFormatPlaneCount(device.Get(), desc.Format);
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12ResourceStateTracker.hpp"
+
+#include "Framework/D3D12ResourceStateTable.hpp"
+
+namespace D3D12Tests {
+    D3D12ResourceStateTracker::D3D12ResourceStateTracker(D3D12ResourceStateTable& table,
+                                                         const bool enableSplitBarriers) :
+        m_Table(table),
+        m_Tracker(table.GetTable(), enableSplitBarriers) {
+    }
+
+    void D3D12ResourceStateTracker::FlushBarriers(ID3D12GraphicsCommandList* pCommandList) {
+        RecordBarriers(pCommandList, m_Tracker.Flush());
+    }
+
+    void D3D12ResourceStateTracker::Close(ID3D12GraphicsCommandList* pCommandList) {
+        RecordBarriers(pCommandList, m_Tracker.Close());
+    }
+
+    void D3D12ResourceStateTracker::RecordBarriers(ID3D12GraphicsCommandList* pCommandList,
+                                                   const std::span<const ResourceBarrier> barriers) {
+        if (barriers.empty()) {
+            return;
+        }
+
+        // Trackers can be used from several recording threads, so each has its own
+        // translation buffer rather than using the table's.
+        m_Table.TranslateBarriers(barriers, m_Barriers);
+        pCommandList->ResourceBarrier(static_cast<UINT>(m_Barriers.size()), m_Barriers.data());
+    }
+}
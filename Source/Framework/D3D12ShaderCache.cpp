@@ -0,0 +1,37 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12ShaderCache.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+
+#include <cstring>
+
+namespace D3D12Tests {
+    D3D12ShaderCache::D3D12ShaderCache(const std::filesystem::path& path) :
+        m_Cache(path),
+        m_CachedCompiler(m_Cache, m_Compiler) {
+    }
+
+    ComPtr<ID3DBlob> D3D12ShaderCache::Compile(const ShaderCompileDesc& desc) {
+        const std::span<const std::byte> bytecode = m_CachedCompiler.Compile(desc);
+
+        // The bytecode lives in the cache mapping, which moves when the cache grows.
+        ComPtr<ID3DBlob> blob;
+        ThrowIfFailed(D3DCreateBlob(bytecode.size(), &blob));
+        std::memcpy(blob->GetBufferPointer(), bytecode.data(), bytecode.size());
+
+        return blob;
+    }
+
+    D3D12ShaderCache& D3D12ShaderCache::GetDefault() {
+        static D3D12ShaderCache cache([] {
+            WCHAR executableDirectory[512];
+            GetAssetsPath(executableDirectory, _countof(executableDirectory));
+            return std::filesystem::path(executableDirectory) / L"ShaderCache.bin";
+        }());
+
+        return cache;
+    }
+}
@@ -0,0 +1,37 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12ShaderCompiler.hpp"
+
+#include "Framework/ApplicationHelper.hpp"
+#include "Framework/Hash.hpp"
+
+namespace D3D12Tests {
+    std::vector<std::byte> D3D12ShaderCompiler::Compile(const ShaderCompileDesc& desc) {
+        std::vector<D3D_SHADER_MACRO> macros;
+        macros.reserve(desc.Defines.size() + 1);
+        for (const ShaderDefine& define : desc.Defines) {
+            macros.push_back({define.Name.c_str(), define.Value.c_str()});
+        }
+        macros.push_back({nullptr, nullptr});
+
+        ComPtr<ID3DBlob> byteCode;
+        ComPtr<ID3DBlob> errors;
+        const HRESULT hr = D3DCompileFromFile(desc.SourcePath.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                                              desc.EntryPoint.c_str(), desc.Target.c_str(), desc.Flags, 0, &byteCode,
+                                              &errors);
+
+        if (errors != nullptr) {
+            OutputDebugStringA(static_cast<const char*>(errors->GetBufferPointer()));
+        }
+        ThrowIfFailed(hr);
+
+        const auto* pByteCode = static_cast<const std::byte*>(byteCode->GetBufferPointer());
+        return {pByteCode, pByteCode + byteCode->GetBufferSize()};
+    }
+
+    UInt64 D3D12ShaderCompiler::GetVersionHash() const {
+        return HashCombine(Hash64("D3DCompiler"), D3D_COMPILER_VERSION);
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/D3D12UploadRing.hpp"
+
+namespace D3D12Tests {
+    static_assert(Alignment::Buffer == D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT);
+    static_assert(Alignment::ConstantBuffer == D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    static_assert(Alignment::TexturePlacement == D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+    static_assert(Alignment::TextureRowPitch == D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+    static_assert(Alignment::ResourcePlacement == D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+    D3D12UploadRing::D3D12UploadRing(ID3D12Device* pDevice, GpuTimeline& timeline, const UInt64 capacity) :
+        m_Buffer(CreateBuffer(pDevice, capacity)),
+        m_Ring(timeline, MapBuffer(m_Buffer.Get()), m_Buffer->GetGPUVirtualAddress(), capacity) {
+    }
+
+    D3D12UploadRing::~D3D12UploadRing() {
+        m_Buffer->Unmap(0, nullptr);
+    }
+
+    ComPtr<ID3D12Resource> D3D12UploadRing::CreateBuffer(ID3D12Device* pDevice, const UInt64 capacity) {
+        ComPtr<ID3D12Resource> buffer;
+
+        auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+        auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(capacity);
+        ThrowIfFailed(pDevice->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &bufferDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&buffer)));
+        SetName(buffer.Get(), L"D3D12UploadRing");
+
+        return buffer;
+    }
+
+    std::byte* D3D12UploadRing::MapBuffer(ID3D12Resource* pBuffer) {
+        // Upload heaps can stay mapped while the GPU reads them, the buffer is only
+        // unmapped on destruction.
+        void* pData;
+        CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resources on the CPU.
+        ThrowIfFailed(pBuffer->Map(0, &readRange, &pData));
+
+        return static_cast<std::byte*>(pData);
+    }
+}
@@ -0,0 +1,366 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/DdsFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 MakeFourCC(const char a, const char b, const char c, const char d) {
+            return static_cast<UInt32>(static_cast<UInt8>(a)) | static_cast<UInt32>(static_cast<UInt8>(b)) << 8 |
+                static_cast<UInt32>(static_cast<UInt8>(c)) << 16 | static_cast<UInt32>(static_cast<UInt8>(d)) << 24;
+        }
+
+        constexpr UInt32 DdsMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+        // Pixel format flags.
+        constexpr UInt32 DdpfAlphaPixels = 0x1;
+        constexpr UInt32 DdpfAlpha = 0x2;
+        constexpr UInt32 DdpfFourCC = 0x4;
+        constexpr UInt32 DdpfRgb = 0x40;
+        constexpr UInt32 DdpfLuminance = 0x20000;
+        constexpr UInt32 DdpfBumpDuDv = 0x80000;
+
+        // Header flags and capabilities.
+        constexpr UInt32 DdsdDepth = 0x800000;
+        constexpr UInt32 DdsCaps2Cubemap = 0x200;
+        constexpr UInt32 DdsCaps2AllFaces = 0xfc00;
+        constexpr UInt32 DdsCaps2Volume = 0x200000;
+
+        // DX10 extension.
+        constexpr UInt32 Dx10DimensionTexture1D = 2;
+        constexpr UInt32 Dx10DimensionTexture2D = 3;
+        constexpr UInt32 Dx10DimensionTexture3D = 4;
+        constexpr UInt32 Dx10MiscTextureCube = 0x4;
+
+        // D3D12 limits, which also keep the size computations away from overflows.
+        constexpr UInt32 MaxTexture1DSize = 16384;
+        constexpr UInt32 MaxTexture2DSize = 16384;
+        constexpr UInt32 MaxTexture3DSize = 2048;
+        constexpr UInt32 MaxArraySize = 2048;
+
+        struct DdsPixelFormat {
+            UInt32 Size;
+            UInt32 Flags;
+            UInt32 FourCC;
+            UInt32 RgbBitCount;
+            UInt32 RBitMask;
+            UInt32 GBitMask;
+            UInt32 BBitMask;
+            UInt32 ABitMask;
+        };
+
+        struct DdsHeader {
+            UInt32 Size;
+            UInt32 Flags;
+            UInt32 Height;
+            UInt32 Width;
+            UInt32 PitchOrLinearSize;
+            UInt32 Depth;
+            UInt32 MipMapCount;
+            UInt32 Reserved1[11];
+            DdsPixelFormat PixelFormat;
+            UInt32 Caps;
+            UInt32 Caps2;
+            UInt32 Caps3;
+            UInt32 Caps4;
+            UInt32 Reserved2;
+        };
+
+        struct DdsHeaderDx10 {
+            UInt32 DxgiFormat;
+            UInt32 ResourceDimension;
+            UInt32 MiscFlag;
+            UInt32 ArraySize;
+            UInt32 MiscFlags2;
+        };
+
+        static_assert(sizeof(DdsPixelFormat) == 32);
+        static_assert(sizeof(DdsHeader) == 124);
+        static_assert(sizeof(DdsHeaderDx10) == 20);
+
+        bool HasMasks(const DdsPixelFormat& format, const UInt32 r, const UInt32 g, const UInt32 b, const UInt32 a) {
+            return format.RBitMask == r && format.GBitMask == g && format.BBitMask == b && format.ABitMask == a;
+        }
+
+        // Format of the files written without the DX10 extension, following the mappings
+        // of the D3DX and DirectXTex writers. Returns DxgiFormat::Unknown when there is none.
+        UInt32 GetLegacyFormat(const DdsPixelFormat& format) {
+            if ((format.Flags & DdpfFourCC) != 0) {
+                switch (format.FourCC) {
+                    case MakeFourCC('D', 'X', 'T', '1'):
+                        return DxgiFormat::BC1Unorm;
+                    case MakeFourCC('D', 'X', 'T', '2'):
+                    case MakeFourCC('D', 'X', 'T', '3'):
+                        return DxgiFormat::BC2Unorm;
+                    case MakeFourCC('D', 'X', 'T', '4'):
+                    case MakeFourCC('D', 'X', 'T', '5'):
+                        return DxgiFormat::BC3Unorm;
+                    case MakeFourCC('A', 'T', 'I', '1'):
+                    case MakeFourCC('B', 'C', '4', 'U'):
+                        return DxgiFormat::BC4Unorm;
+                    case MakeFourCC('B', 'C', '4', 'S'):
+                        return DxgiFormat::BC4Snorm;
+                    case MakeFourCC('A', 'T', 'I', '2'):
+                    case MakeFourCC('B', 'C', '5', 'U'):
+                        return DxgiFormat::BC5Unorm;
+                    case MakeFourCC('B', 'C', '5', 'S'):
+                        return DxgiFormat::BC5Snorm;
+                    case MakeFourCC('R', 'G', 'B', 'G'):
+                        return DxgiFormat::R8G8B8G8Unorm;
+                    case MakeFourCC('G', 'R', 'G', 'B'):
+                        return DxgiFormat::G8R8G8B8Unorm;
+                    case MakeFourCC('Y', 'U', 'Y', '2'):
+                        return DxgiFormat::YUY2;
+                    // D3DFORMAT values stored as FourCC.
+                    case 36:
+                        return DxgiFormat::R16G16B16A16Unorm;
+                    case 110:
+                        return DxgiFormat::R16G16B16A16Snorm;
+                    case 111:
+                        return DxgiFormat::R16Float;
+                    case 112:
+                        return DxgiFormat::R16G16Float;
+                    case 113:
+                        return DxgiFormat::R16G16B16A16Float;
+                    case 114:
+                        return DxgiFormat::R32Float;
+                    case 115:
+                        return DxgiFormat::R32G32Float;
+                    case 116:
+                        return DxgiFormat::R32G32B32A32Float;
+                    default:
+                        return DxgiFormat::Unknown;
+                }
+            }
+
+            if ((format.Flags & DdpfRgb) != 0) {
+                const bool hasAlpha = (format.Flags & DdpfAlphaPixels) != 0;
+                switch (format.RgbBitCount) {
+                    case 32:
+                        if (HasMasks(format, 0xff, 0xff00, 0xff0000, 0xff000000)) {
+                            return DxgiFormat::R8G8B8A8Unorm;
+                        }
+                        if (HasMasks(format, 0xff0000, 0xff00, 0xff, 0xff000000)) {
+                            return DxgiFormat::B8G8R8A8Unorm;
+                        }
+                        if (HasMasks(format, 0xff0000, 0xff00, 0xff, 0)) {
+                            return DxgiFormat::B8G8R8X8Unorm;
+                        }
+                        // D3DX writes the 10:10:10:2 masks swapped, both mean the same layout.
+                        if (HasMasks(format, 0x3ff, 0xffc00, 0x3ff00000, 0xc0000000) ||
+                            HasMasks(format, 0x3ff00000, 0xffc00, 0x3ff, 0xc0000000)) {
+                            return DxgiFormat::R10G10B10A2Unorm;
+                        }
+                        if (HasMasks(format, 0xffff, 0xffff0000, 0, 0)) {
+                            return DxgiFormat::R16G16Unorm;
+                        }
+                        if (HasMasks(format, 0xffffffff, 0, 0, 0)) {
+                            return DxgiFormat::R32Float;
+                        }
+                        break;
+                    case 16:
+                        if (HasMasks(format, 0x7c00, 0x3e0, 0x1f, hasAlpha ? 0x8000 : 0)) {
+                            return DxgiFormat::B5G5R5A1Unorm;
+                        }
+                        if (HasMasks(format, 0xf800, 0x7e0, 0x1f, 0)) {
+                            return DxgiFormat::B5G6R5Unorm;
+                        }
+                        if (HasMasks(format, 0xf00, 0xf0, 0xf, hasAlpha ? 0xf000 : 0)) {
+                            return DxgiFormat::B4G4R4A4Unorm;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+
+                return DxgiFormat::Unknown;
+            }
+
+            if ((format.Flags & DdpfLuminance) != 0) {
+                if (format.RgbBitCount == 8 && format.RBitMask == 0xff) {
+                    return DxgiFormat::R8Unorm;
+                }
+                if (format.RgbBitCount == 16 && HasMasks(format, 0xffff, 0, 0, 0)) {
+                    return DxgiFormat::R16Unorm;
+                }
+                if (format.RgbBitCount == 16 && HasMasks(format, 0xff, 0, 0, 0xff00)) {
+                    return DxgiFormat::R8G8Unorm;
+                }
+
+                return DxgiFormat::Unknown;
+            }
+
+            if ((format.Flags & DdpfAlpha) != 0) {
+                return format.RgbBitCount == 8 ? DxgiFormat::A8Unorm : DxgiFormat::Unknown;
+            }
+
+            if ((format.Flags & DdpfBumpDuDv) != 0) {
+                if (format.RgbBitCount == 16 && HasMasks(format, 0xff, 0xff00, 0, 0)) {
+                    return DxgiFormat::R8G8Snorm;
+                }
+                if (format.RgbBitCount == 32 && HasMasks(format, 0xff, 0xff00, 0xff0000, 0xff000000)) {
+                    return DxgiFormat::R8G8B8A8Snorm;
+                }
+                if (format.RgbBitCount == 32 && HasMasks(format, 0xffff, 0xffff0000, 0, 0)) {
+                    return DxgiFormat::R16G16Snorm;
+                }
+            }
+
+            return DxgiFormat::Unknown;
+        }
+
+        UInt32 GetMaxMipCount(const UInt32 width, const UInt32 height, const UInt32 depth) {
+            return static_cast<UInt32>(std::bit_width(std::max({width, height, depth})));
+        }
+    }
+
+    DdsFile::DdsFile(const std::filesystem::path& path) :
+        m_File(path, MappedFileMode::Read),
+        m_Format(DxgiFormat::Unknown),
+        m_Dimension(TextureDimension::Texture2D),
+        m_Width(0),
+        m_Height(0),
+        m_Depth(1),
+        m_ArraySize(1),
+        m_MipCount(1),
+        m_IsCubemap(false) {
+        ReadHeader();
+    }
+
+    void DdsFile::ReadHeader() {
+        const std::byte* pData = m_File.GetData();
+        const UInt64 fileSize = m_File.GetSize();
+
+        UInt32 magic;
+        DdsHeader header;
+        if (fileSize < sizeof(magic) + sizeof(header)) {
+            throw std::runtime_error("The DDS file is too small for its header.");
+        }
+
+        // The mapping is page-aligned but the headers are copied anyway, they are tiny.
+        std::memcpy(&magic, pData, sizeof(magic));
+        std::memcpy(&header, pData + sizeof(magic), sizeof(header));
+        if (magic != DdsMagic || header.Size != sizeof(DdsHeader) || header.PixelFormat.Size != sizeof(DdsPixelFormat)) {
+            throw std::runtime_error("The file is not a DDS file.");
+        }
+
+        UInt64 dataOffset = sizeof(magic) + sizeof(header);
+        m_Width = header.Width;
+        m_Height = header.Height;
+        m_MipCount = std::max(header.MipMapCount, 1u);
+
+        if ((header.PixelFormat.Flags & DdpfFourCC) != 0 && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0')) {
+            DdsHeaderDx10 dx10Header;
+            if (fileSize < dataOffset + sizeof(dx10Header)) {
+                throw std::runtime_error("The DDS file is too small for its DX10 header.");
+            }
+
+            std::memcpy(&dx10Header, pData + dataOffset, sizeof(dx10Header));
+            dataOffset += sizeof(dx10Header);
+
+            m_Format = dx10Header.DxgiFormat;
+            m_ArraySize = dx10Header.ArraySize;
+            if (m_ArraySize == 0) {
+                throw std::runtime_error("The DDS file has an empty array.");
+            }
+            // Checked before the cubes are counted in faces, which could wrap around.
+            if (m_ArraySize > MaxArraySize) {
+                throw std::runtime_error("The DDS file has invalid dimensions.");
+            }
+
+            switch (dx10Header.ResourceDimension) {
+                case Dx10DimensionTexture1D:
+                    m_Dimension = TextureDimension::Texture1D;
+                    m_Height = 1;
+                    break;
+                case Dx10DimensionTexture2D:
+                    m_Dimension = TextureDimension::Texture2D;
+                    if ((dx10Header.MiscFlag & Dx10MiscTextureCube) != 0) {
+                        // The array size counts whole cubes.
+                        m_IsCubemap = true;
+                        m_ArraySize *= 6;
+                    }
+                    break;
+                case Dx10DimensionTexture3D:
+                    m_Dimension = TextureDimension::Texture3D;
+                    m_Depth = header.Depth;
+                    if ((header.Flags & DdsdDepth) == 0 || m_ArraySize != 1) {
+                        throw std::runtime_error("The DDS volume texture is malformed.");
+                    }
+                    break;
+                default:
+                    throw std::runtime_error("The DDS file has an unknown resource dimension.");
+            }
+        } else {
+            m_Format = GetLegacyFormat(header.PixelFormat);
+
+            if ((header.Flags & DdsdDepth) != 0 || (header.Caps2 & DdsCaps2Volume) != 0) {
+                m_Dimension = TextureDimension::Texture3D;
+                m_Depth = header.Depth;
+            } else if ((header.Caps2 & DdsCaps2Cubemap) != 0) {
+                // D3D10 and later have no partial cubemaps.
+                if ((header.Caps2 & DdsCaps2AllFaces) != DdsCaps2AllFaces) {
+                    throw std::runtime_error("The DDS cubemap does not have all its faces.");
+                }
+
+                m_IsCubemap = true;
+                m_ArraySize = 6;
+            }
+        }
+
+        if (GetTextureFormatInfo(m_Format).BlockSize == 0) {
+            throw std::runtime_error("The format of the DDS file is not supported.");
+        }
+
+        const UInt32 maxSize = m_Dimension == TextureDimension::Texture3D ? MaxTexture3DSize
+                               : m_Dimension == TextureDimension::Texture1D ? MaxTexture1DSize
+                               : MaxTexture2DSize;
+        if (m_Width == 0 || m_Height == 0 || m_Depth == 0 || m_Width > maxSize || m_Height > maxSize ||
+            m_Depth > maxSize || m_ArraySize > MaxArraySize * (m_IsCubemap ? 6 : 1)) {
+            throw std::runtime_error("The DDS file has invalid dimensions.");
+        }
+
+        if (m_MipCount > GetMaxMipCount(m_Width, m_Height, m_Depth)) {
+            throw std::runtime_error("The DDS file has more mips than its size allows.");
+        }
+
+        BuildSubresources(dataOffset);
+    }
+
+    void DdsFile::BuildSubresources(UInt64 dataOffset) {
+        m_Subresources.clear();
+        m_Subresources.reserve(static_cast<std::size_t>(m_ArraySize) * m_MipCount);
+
+        // Slices follow each other with their whole mip chain; a mip of a volume holds all
+        // its depth slices.
+        for (UInt32 slice = 0; slice < m_ArraySize; ++slice) {
+            UInt32 width = m_Width;
+            UInt32 height = m_Height;
+            UInt32 depth = m_Depth;
+
+            for (UInt32 mip = 0; mip < m_MipCount; ++mip) {
+                const TextureLayout layout = ComputeTextureLayout(m_Format, width, height);
+                const UInt64 size = layout.SlicePitch * depth;
+                if (dataOffset + size > m_File.GetSize()) {
+                    throw std::runtime_error("The DDS file is truncated.");
+                }
+
+                m_Subresources.push_back({
+                    m_File.GetData() + dataOffset, width, height, depth, layout.RowPitch, layout.RowCount,
+                    layout.SlicePitch
+                });
+                dataOffset += size;
+
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+                depth = std::max(depth / 2, 1u);
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/DrawQueue.hpp"
+
+#include <array>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 RadixBits = 8;
+        constexpr UInt32 RadixSize = 1 << RadixBits;
+        constexpr UInt32 RadixPassCount = 64 / RadixBits;
+
+        // The bits of the state of a draw, all of the key but the depth.
+        constexpr UInt64 DrawKeyStateMask = ~(((UInt64(1) << DrawKeyDepthBits) - 1) << DrawKeyDepthShift);
+
+        template <class TDraw>
+        DrawStateChanges CountStateChanges(const std::span<const TDraw> draws) {
+            DrawStateChanges changes;
+            changes.DrawCount = draws.size();
+            for (size_t i = 0; i < draws.size(); ++i) {
+                const TDraw& draw = draws[i];
+                if (i == 0) {
+                    changes.PipelineChanges = changes.MaterialChanges = changes.GeometryChanges = 1;
+                    continue;
+                }
+
+                const TDraw& previous = draws[i - 1];
+                const bool pipelineChanged = GetDrawKeyPipeline(draw.Key) != GetDrawKeyPipeline(previous.Key);
+                changes.PipelineChanges += pipelineChanged;
+                changes.MaterialChanges += pipelineChanged || GetDrawKeyMaterial(draw.Key) != GetDrawKeyMaterial(previous.Key);
+                changes.GeometryChanges += draw.Geometry != previous.Geometry;
+            }
+
+            return changes;
+        }
+    }
+
+    DrawStateChanges CountDrawStateChanges(const std::span<const DrawPacket> packets) {
+        return CountStateChanges(packets);
+    }
+
+    DrawStateChanges CountDrawStateChanges(const std::span<const DrawBatch> batches) {
+        return CountStateChanges(batches);
+    }
+
+    void DrawQueue::Sort() {
+        m_Batches.clear();
+        m_Instances.clear();
+
+        const UInt32 packetCount = static_cast<UInt32>(m_Packets.size());
+        if (packetCount == 0) {
+            return;
+        }
+
+        // The histograms of all the passes are counted in a single read of the keys.
+        std::array<std::array<UInt32, RadixSize>, RadixPassCount> histograms{};
+        for (const DrawPacket& packet : m_Packets) {
+            for (UInt32 pass = 0; pass < RadixPassCount; ++pass) {
+                ++histograms[pass][packet.Key >> pass * RadixBits & (RadixSize - 1)];
+            }
+        }
+
+        m_SortedPackets.resize(packetCount);
+        DrawPacket* pSource = m_Packets.data();
+        DrawPacket* pDestination = m_SortedPackets.data();
+        for (UInt32 pass = 0; pass < RadixPassCount; ++pass) {
+            const UInt32 shift = pass * RadixBits;
+            std::array<UInt32, RadixSize>& histogram = histograms[pass];
+
+            // A byte shared by every key, e.g. the layer of a single layer, would not move any
+            // packet.
+            if (histogram[pSource->Key >> shift & (RadixSize - 1)] == packetCount) {
+                continue;
+            }
+
+            UInt32 offset = 0;
+            for (UInt32& bucket : histogram) {
+                const UInt32 bucketSize = bucket;
+                bucket = offset;
+                offset += bucketSize;
+            }
+
+            for (UInt32 i = 0; i < packetCount; ++i) {
+                const DrawPacket& packet = pSource[i];
+                pDestination[histogram[packet.Key >> shift & (RadixSize - 1)]++] = packet;
+            }
+            std::swap(pSource, pDestination);
+        }
+
+        if (pSource != m_Packets.data()) {
+            m_Packets.swap(m_SortedPackets);
+        }
+
+        m_Instances.resize(packetCount);
+        for (UInt32 i = 0; i < packetCount; ++i) {
+            const DrawPacket& packet = m_Packets[i];
+            m_Instances[i] = packet.Instance;
+
+            if (!m_Batches.empty()) {
+                DrawBatch& batch = m_Batches.back();
+                if (((batch.Key ^ packet.Key) & DrawKeyStateMask) == 0 && batch.Geometry == packet.Geometry) {
+                    ++batch.InstanceCount;
+                    continue;
+                }
+            }
+
+            m_Batches.push_back({packet.Key, packet.Geometry, i, 1});
+        }
+    }
+}
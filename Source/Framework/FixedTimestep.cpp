@@ -0,0 +1,40 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/FixedTimestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    FixedTimestep::FixedTimestep(const Float64 stepSeconds, const UInt32 maxUpdatesPerFrame) :
+        m_StepSeconds(stepSeconds),
+        m_MaxUpdatesPerFrame(maxUpdatesPerFrame),
+        m_Accumulator(0.0),
+        m_UpdateCount(0),
+        m_DroppedUpdateCount(0) {
+        if (!(stepSeconds > 0.0) || maxUpdatesPerFrame == 0) {
+            throw std::invalid_argument("The fixed timestep needs a positive step and at least one update per frame.");
+        }
+    }
+
+    UInt32 FixedTimestep::Advance(const Float64 deltaSeconds) {
+        m_Accumulator += deltaSeconds > 0.0 ? deltaSeconds : 0.0;
+
+        const Float64 stepCount = std::floor(m_Accumulator / m_StepSeconds);
+        // Rounding can leave the accumulator slightly negative.
+        m_Accumulator = std::max(m_Accumulator - stepCount * m_StepSeconds, 0.0);
+
+        UInt32 updateCount = m_MaxUpdatesPerFrame;
+        if (stepCount <= static_cast<Float64>(m_MaxUpdatesPerFrame)) {
+            updateCount = static_cast<UInt32>(stepCount);
+        } else {
+            m_DroppedUpdateCount += static_cast<UInt64>(stepCount) - m_MaxUpdatesPerFrame;
+        }
+
+        m_UpdateCount += updateCount;
+        return updateCount;
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/FrameLimiter.hpp"
+
+#include "Framework/Simd.hpp"
+
+#include <cmath>
+#include <thread>
+
+#ifdef D3D12TESTS_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        // Old samples fade out, so that the estimate follows changes of the timer
+        // resolution or of the system load.
+        constexpr UInt64 MaxSampleCount = 64;
+
+        class SystemFrameLimiterClock final : public FrameLimiterClock {
+        public:
+            Clock::time_point Now() override {
+                return Clock::now();
+            }
+
+            void Sleep(const Clock::duration duration) override {
+                std::this_thread::sleep_for(duration);
+            }
+
+            void Pause() override {
+#ifdef D3D12TESTS_ARCH_X86
+                _mm_pause();
+#else
+                std::this_thread::yield();
+#endif
+            }
+        };
+    }
+
+    FrameLimiterClock& FrameLimiterClock::GetSystemClock() {
+        static SystemFrameLimiterClock clock;
+        return clock;
+    }
+
+    FrameLimiter::FrameLimiter(const Clock::duration sleepSlice) :
+        FrameLimiter(FrameLimiterClock::GetSystemClock(), sleepSlice) {
+    }
+
+    FrameLimiter::FrameLimiter(FrameLimiterClock& clock, const Clock::duration sleepSlice) :
+        m_Clock(clock),
+        m_SleepSlice(sleepSlice),
+        m_SampleCount(0),
+        m_Mean(0.0),
+        m_SquaredDeviationSum(0.0),
+        m_Estimate(std::chrono::duration<Float64>(sleepSlice).count()),
+        m_TotalSpinTime(Clock::duration::zero()) {
+    }
+
+    void FrameLimiter::WaitUntil(const Clock::time_point deadline) {
+        Clock::time_point now = m_Clock.Now();
+        while (std::chrono::duration<Float64>(deadline - now).count() > m_Estimate) {
+            m_Clock.Sleep(m_SleepSlice);
+
+            const Clock::time_point end = m_Clock.Now();
+            AddSleepSample(std::chrono::duration<Float64>(end - now).count());
+            now = end;
+        }
+
+        const Clock::time_point spinStart = now;
+        while (now < deadline) {
+            m_Clock.Pause();
+            now = m_Clock.Now();
+        }
+
+        m_TotalSpinTime += now - spinStart;
+    }
+
+    void FrameLimiter::AddSleepSample(const Float64 seconds) {
+        if (m_SampleCount == MaxSampleCount) {
+            // Forget one average sample, keeping the mean and the variance.
+            m_SquaredDeviationSum *= static_cast<Float64>(m_SampleCount - 1) / static_cast<Float64>(m_SampleCount);
+            --m_SampleCount;
+        }
+
+        ++m_SampleCount;
+        const Float64 delta = seconds - m_Mean;
+        m_Mean += delta / static_cast<Float64>(m_SampleCount);
+        m_SquaredDeviationSum += delta * (seconds - m_Mean);
+
+        const Float64 variance = m_SampleCount > 1 ? m_SquaredDeviationSum / static_cast<Float64>(m_SampleCount - 1) : 0.0;
+        m_Estimate = m_Mean + 3.0 * std::sqrt(variance);
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/FrameLoop.hpp"
+
+#include "Framework/Profiler.hpp"
+
+namespace D3D12Tests {
+    FrameLoop::FrameLoop(ApplicationBase& application) :
+        m_Application(application) {
+    }
+
+    void FrameLoop::RunFrame() {
+        const FramePacingDesc& pacing = m_Application.GetFramePacing();
+        if (pacing != m_Pacing) {
+            if (pacing.UpdateStepSeconds > 0.0) {
+                m_Timestep = FixedTimestep(pacing.UpdateStepSeconds, pacing.MaxUpdatesPerFrame);
+            }
+            m_Pacing = pacing;
+            m_NextDeadline = Clock::time_point();
+        }
+
+        WaitForNextFrame(m_Pacing);
+
+        const Clock::time_point frameStart = Clock::now();
+        FrameTiming& timing = m_Application.m_FrameTiming;
+        if (timing.FrameNumber == 0) {
+            m_StartTime = frameStart;
+            m_FrameStartTime = frameStart;
+        }
+
+        timing.DeltaSeconds = std::chrono::duration<Float64>(frameStart - m_FrameStartTime).count();
+        timing.TotalSeconds = std::chrono::duration<Float64>(frameStart - m_StartTime).count();
+        m_FrameStartTime = frameStart;
+
+        if (m_Pacing.UpdateStepSeconds > 0.0) {
+            timing.UpdateCount = m_Timestep.Advance(timing.DeltaSeconds);
+            timing.UpdateStepSeconds = m_Timestep.GetStepSeconds();
+            timing.InterpolationAlpha = m_Timestep.GetAlpha();
+        } else {
+            timing.UpdateCount = 1;
+            timing.UpdateStepSeconds = timing.DeltaSeconds;
+            timing.InterpolationAlpha = 0.0;
+        }
+
+        D3D12TESTS_PROFILE_FRAME();
+        for (UInt32 i = 0; i < timing.UpdateCount; ++i) {
+            m_Application.OnUpdate();
+        }
+        m_Application.OnRender();
+
+        ++timing.FrameNumber;
+    }
+
+    void FrameLoop::WaitForNextFrame(const FramePacingDesc& pacing) {
+        D3D12TESTS_PROFILE_SCOPE("FrameLoop::WaitForNextFrame");
+
+        switch (pacing.Mode) {
+            case FramePacingMode::Uncapped:
+                break;
+
+            case FramePacingMode::FixedRate: {
+                if (!(pacing.TargetFrameRate > 0.0)) {
+                    break;
+                }
+
+                const auto period = std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<Float64>(1.0 / pacing.TargetFrameRate));
+
+                // Deadlines follow each other by exactly one period, so that the rate does not
+                // drift. A frame later than a whole period restarts the schedule instead of
+                // being followed by a burst of frames catching up.
+                const Clock::time_point now = Clock::now();
+                if (m_NextDeadline + period < now) {
+                    m_NextDeadline = now;
+                }
+
+                m_Limiter.WaitUntil(m_NextDeadline);
+                m_NextDeadline += period;
+                break;
+            }
+
+            case FramePacingMode::LowLatency:
+                if (m_Application.m_FrameLatencyWaiter) {
+                    m_Application.m_FrameLatencyWaiter();
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/FrameStatistics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace D3D12Tests {
+    namespace {
+        Float64 GetPercentile(const std::vector<Float64>& sortedValues, const UInt64 percent) {
+            const size_t rank = (sortedValues.size() * percent + 99) / 100;
+            return sortedValues[std::max<size_t>(rank, 1) - 1];
+        }
+    }
+
+    FrameStatistics ComputeFrameStatistics(const std::span<const Float64> frameMilliseconds) {
+        FrameStatistics statistics;
+        if (frameMilliseconds.empty()) {
+            return statistics;
+        }
+
+        std::vector<Float64> sorted(frameMilliseconds.begin(), frameMilliseconds.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        for (const Float64 milliseconds : sorted) {
+            statistics.TotalMilliseconds += milliseconds;
+        }
+
+        statistics.FrameCount = sorted.size();
+        statistics.MinMilliseconds = sorted.front();
+        statistics.AverageMilliseconds = statistics.TotalMilliseconds / static_cast<Float64>(sorted.size());
+        statistics.MedianMilliseconds = GetPercentile(sorted, 50);
+        statistics.P99Milliseconds = GetPercentile(sorted, 99);
+        statistics.MaxMilliseconds = sorted.back();
+
+        return statistics;
+    }
+
+    std::string FormatFrameStatistics(const FrameStatistics& statistics) {
+        char text[256];
+        std::snprintf(text, sizeof(text),
+                      "%llu frames, min %.3f ms, avg %.3f ms, median %.3f ms, p99 %.3f ms, max %.3f ms",
+                      static_cast<unsigned long long>(statistics.FrameCount), statistics.MinMilliseconds,
+                      statistics.AverageMilliseconds, statistics.MedianMilliseconds, statistics.P99Milliseconds,
+                      statistics.MaxMilliseconds);
+
+        return text;
+    }
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/GraphicsCommandList.hpp"
+
+namespace D3D12Tests {
+    const char* GetGraphicsCommandName(const GraphicsCommand command) {
+        switch (command) {
+            case GraphicsCommand::SetPipelineState:
+                return "SetPipelineState";
+            case GraphicsCommand::SetGraphicsRootSignature:
+                return "SetGraphicsRootSignature";
+            case GraphicsCommand::SetDescriptorHeaps:
+                return "SetDescriptorHeaps";
+            case GraphicsCommand::SetGraphicsRootDescriptorTable:
+                return "SetGraphicsRootDescriptorTable";
+            case GraphicsCommand::SetGraphicsRoot32BitConstants:
+                return "SetGraphicsRoot32BitConstants";
+            case GraphicsCommand::SetGraphicsRootConstantBufferView:
+                return "SetGraphicsRootConstantBufferView";
+            case GraphicsCommand::SetViewports:
+                return "SetViewports";
+            case GraphicsCommand::SetScissorRects:
+                return "SetScissorRects";
+            case GraphicsCommand::SetPrimitiveTopology:
+                return "SetPrimitiveTopology";
+            case GraphicsCommand::SetVertexBuffers:
+                return "SetVertexBuffers";
+            case GraphicsCommand::SetIndexBuffer:
+                return "SetIndexBuffer";
+            case GraphicsCommand::DrawInstanced:
+                return "DrawInstanced";
+            case GraphicsCommand::DrawIndexedInstanced:
+                return "DrawIndexedInstanced";
+            case GraphicsCommand::Count:
+                break;
+        }
+
+        return "Unknown";
+    }
+}
@@ -0,0 +1,270 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/GraphicsPipelineDesc.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <type_traits>
+
+namespace D3D12Tests {
+    namespace {
+        // Every value is written with its own size in little endian, which is the native
+        // order of every supported platform, so the binary form has no padding to hash.
+        class Writer {
+        public:
+            explicit Writer(std::vector<std::byte>& data) : m_Data(data) {
+            }
+
+            template <class T>
+            void Write(const T value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const auto* pBytes = reinterpret_cast<const std::byte*>(&value);
+                m_Data.insert(m_Data.end(), pBytes, pBytes + sizeof(T));
+            }
+
+            void Write(const std::string& string) {
+                Write(static_cast<UInt32>(string.size()));
+                const auto* pBytes = reinterpret_cast<const std::byte*>(string.data());
+                m_Data.insert(m_Data.end(), pBytes, pBytes + string.size());
+            }
+
+        private:
+            std::vector<std::byte>& m_Data;
+        };
+
+        class Reader {
+        public:
+            explicit Reader(std::span<const std::byte>& data) : m_Data(data), m_Failed(false) {
+            }
+
+            template <class T>
+            void Read(T& value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if (m_Failed || m_Data.size() < sizeof(T)) {
+                    m_Failed = true;
+                    return;
+                }
+
+                std::memcpy(&value, m_Data.data(), sizeof(T));
+                m_Data = m_Data.subspan(sizeof(T));
+            }
+
+            void Read(std::string& string) {
+                UInt32 size = 0;
+                Read(size);
+                if (m_Failed || m_Data.size() < size) {
+                    m_Failed = true;
+                    return;
+                }
+
+                string.assign(reinterpret_cast<const char*>(m_Data.data()), size);
+                m_Data = m_Data.subspan(size);
+            }
+
+            void Fail() {
+                m_Failed = true;
+            }
+
+            bool HasFailed() const {
+                return m_Failed;
+            }
+
+        private:
+            std::span<const std::byte>& m_Data;
+            bool m_Failed;
+        };
+
+        // Both directions go through the same field list, so they cannot get out of sync.
+        template <class TArchive, class TDesc>
+        void VisitFields(TArchive& archive, TDesc& desc, auto&& visitCount) {
+            const auto visit = [&archive](auto& value) {
+                if constexpr (std::is_same_v<TArchive, Writer>) {
+                    archive.Write(value);
+                } else {
+                    archive.Read(value);
+                }
+            };
+
+            visit(desc.RootSignature);
+            visit(desc.VS);
+            visit(desc.PS);
+            visit(desc.DS);
+            visit(desc.HS);
+            visit(desc.GS);
+
+            visitCount(desc.InputLayout);
+            for (auto& element : desc.InputLayout) {
+                visit(element.SemanticName);
+                visit(element.SemanticIndex);
+                visit(element.Format);
+                visit(element.InputSlot);
+                visit(element.AlignedByteOffset);
+                visit(element.InputSlotClass);
+                visit(element.InstanceDataStepRate);
+            }
+
+            visit(desc.BlendState.AlphaToCoverageEnable);
+            visit(desc.BlendState.IndependentBlendEnable);
+            for (auto& renderTarget : desc.BlendState.RenderTargets) {
+                visit(renderTarget.BlendEnable);
+                visit(renderTarget.LogicOpEnable);
+                visit(renderTarget.SrcBlend);
+                visit(renderTarget.DestBlend);
+                visit(renderTarget.BlendOp);
+                visit(renderTarget.SrcBlendAlpha);
+                visit(renderTarget.DestBlendAlpha);
+                visit(renderTarget.BlendOpAlpha);
+                visit(renderTarget.LogicOp);
+                visit(renderTarget.RenderTargetWriteMask);
+            }
+
+            visit(desc.SampleMask);
+
+            auto& rasterizer = desc.RasterizerState;
+            visit(rasterizer.FillMode);
+            visit(rasterizer.CullMode);
+            visit(rasterizer.FrontCounterClockwise);
+            visit(rasterizer.DepthBias);
+            visit(rasterizer.DepthBiasClamp);
+            visit(rasterizer.SlopeScaledDepthBias);
+            visit(rasterizer.DepthClipEnable);
+            visit(rasterizer.MultisampleEnable);
+            visit(rasterizer.AntialiasedLineEnable);
+            visit(rasterizer.ForcedSampleCount);
+            visit(rasterizer.ConservativeRaster);
+
+            auto& depthStencil = desc.DepthStencilState;
+            visit(depthStencil.DepthEnable);
+            visit(depthStencil.DepthWriteMask);
+            visit(depthStencil.DepthFunc);
+            visit(depthStencil.StencilEnable);
+            visit(depthStencil.StencilReadMask);
+            visit(depthStencil.StencilWriteMask);
+            for (auto* pFace : {&depthStencil.FrontFace, &depthStencil.BackFace}) {
+                visit(pFace->StencilFailOp);
+                visit(pFace->StencilDepthFailOp);
+                visit(pFace->StencilPassOp);
+                visit(pFace->StencilFunc);
+            }
+
+            visit(desc.IBStripCutValue);
+            visit(desc.PrimitiveTopologyType);
+            visit(desc.NumRenderTargets);
+            for (auto& format : desc.RTVFormats) {
+                visit(format);
+            }
+            visit(desc.DSVFormat);
+            visit(desc.SampleCount);
+            visit(desc.SampleQuality);
+            visit(desc.NodeMask);
+            visit(desc.Flags);
+        }
+
+        Float32 CanonicalizeFloat(const Float32 value) {
+            // -0.0 and 0.0 behave the same but have different bits.
+            return value == 0.0f ? 0.0f : value;
+        }
+    }
+
+    GraphicsPipelineDesc CanonicalizePipelineDesc(const GraphicsPipelineDesc& desc) {
+        GraphicsPipelineDesc canonical = desc;
+
+        // HLSL semantics are case-insensitive.
+        for (PipelineInputElement& element : canonical.InputLayout) {
+            std::ranges::transform(element.SemanticName, element.SemanticName.begin(), [](const char c) {
+                return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            });
+        }
+
+        const UInt32 renderTargetCount = std::min(canonical.NumRenderTargets, MaxRenderTargets);
+        for (UInt32 i = renderTargetCount; i < MaxRenderTargets; ++i) {
+            canonical.RTVFormats[i] = 0;
+        }
+
+        PipelineBlendState& blend = canonical.BlendState;
+        for (PipelineRenderTargetBlend& renderTarget : blend.RenderTargets) {
+            if (!renderTarget.BlendEnable) {
+                renderTarget.SrcBlend = 0;
+                renderTarget.DestBlend = 0;
+                renderTarget.BlendOp = 0;
+                renderTarget.SrcBlendAlpha = 0;
+                renderTarget.DestBlendAlpha = 0;
+                renderTarget.BlendOpAlpha = 0;
+            }
+            if (!renderTarget.LogicOpEnable) {
+                renderTarget.LogicOp = 0;
+            }
+        }
+
+        if (blend.IndependentBlendEnable) {
+            // Independent blending with the same state everywhere is the same as without it.
+            const auto first = blend.RenderTargets.begin();
+            blend.IndependentBlendEnable = !std::all_of(first, first + std::max(renderTargetCount, 1u),
+                                                        [&first](const PipelineRenderTargetBlend& renderTarget) {
+                                                            return renderTarget == *first;
+                                                        });
+        }
+
+        // Without independent blending only the first render target state is used, with it
+        // only the ones below the render target count are.
+        const UInt32 usedBlendStates = blend.IndependentBlendEnable ? renderTargetCount : 1;
+        for (UInt32 i = usedBlendStates; i < MaxRenderTargets; ++i) {
+            blend.RenderTargets[i] = {};
+        }
+
+        PipelineRasterizerState& rasterizer = canonical.RasterizerState;
+        rasterizer.DepthBiasClamp = CanonicalizeFloat(rasterizer.DepthBiasClamp);
+        rasterizer.SlopeScaledDepthBias = CanonicalizeFloat(rasterizer.SlopeScaledDepthBias);
+        if (rasterizer.DepthBias == 0 && rasterizer.SlopeScaledDepthBias == 0.0f) {
+            rasterizer.DepthBiasClamp = 0.0f;
+        }
+
+        PipelineDepthStencilState& depthStencil = canonical.DepthStencilState;
+        if (!depthStencil.DepthEnable) {
+            depthStencil.DepthWriteMask = 0;
+            depthStencil.DepthFunc = 0;
+        }
+        if (!depthStencil.StencilEnable) {
+            depthStencil.StencilReadMask = 0;
+            depthStencil.StencilWriteMask = 0;
+            depthStencil.FrontFace = {};
+            depthStencil.BackFace = {};
+        }
+
+        return canonical;
+    }
+
+    UInt64 HashPipelineDesc(const GraphicsPipelineDesc& desc) {
+        std::vector<std::byte> data;
+        SerializePipelineDesc(CanonicalizePipelineDesc(desc), data);
+
+        return Hash64(data.data(), data.size());
+    }
+
+    void SerializePipelineDesc(const GraphicsPipelineDesc& desc, std::vector<std::byte>& data) {
+        Writer writer(data);
+        VisitFields(writer, desc, [&writer](const auto& elements) {
+            writer.Write(static_cast<UInt32>(elements.size()));
+        });
+    }
+
+    bool DeserializePipelineDesc(std::span<const std::byte>& data, GraphicsPipelineDesc& desc) {
+        Reader reader(data);
+        VisitFields(reader, desc, [&reader, &data](auto& elements) {
+            UInt32 count = 0;
+            reader.Read(count);
+
+            // Every element takes at least 28 bytes, larger counts come from corrupted data.
+            if (reader.HasFailed() || count > data.size() / 28) {
+                reader.Fail();
+                count = 0;
+            }
+            elements.resize(count);
+        });
+
+        return !reader.HasFailed();
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/HeadlessApplicationBase.hpp"
+
+#include "Framework/FrameLoop.hpp"
+
+#include <vector>
+
+namespace D3D12Tests {
+    FrameStatistics HeadlessApplicationBase::Run(ApplicationBase* pApplication, const UInt64 frameCount) {
+        pApplication->OnInit();
+
+        std::vector<Float64> frameMilliseconds;
+        frameMilliseconds.reserve(frameCount);
+
+        FrameLoop frameLoop(*pApplication);
+        for (UInt64 frame = 0; frame < frameCount; ++frame) {
+            frameLoop.RunFrame();
+
+            // The delta of the first frame is zero, it has no previous frame to be measured from.
+            if (frame != 0) {
+                frameMilliseconds.push_back(pApplication->GetFrameTiming().DeltaSeconds * 1000.0);
+            }
+        }
+
+        pApplication->OnDestroy();
+
+        return ComputeFrameStatistics(frameMilliseconds);
+    }
+}
@@ -0,0 +1,293 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/JobSystem.hpp"
+
+#include "Framework/Profiler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace D3D12Tests {
+    struct JobCounter::Job {
+        std::function<void()> Function;
+        JobCounter* Signal;
+        // Dependencies that have not reached zero yet, plus one while scheduling.
+        std::atomic<UInt32> PendingCount;
+    };
+
+    namespace {
+        // Identifies the threads of a system, so that they can use their own deque.
+        thread_local const JobSystem* t_pJobSystem = nullptr;
+        thread_local UInt32 t_ThreadIndex = 0;
+
+        // Attempts to find a job before an idle worker goes to sleep.
+        constexpr UInt32 IdleSpinCount = 64;
+    }
+
+    JobCounter::JobCounter() :
+        m_Value(0) {
+    }
+
+    JobSystem::JobSystem(const UInt32 threadCount, const UInt64 queueCapacity) :
+        m_SharedJobCount(0),
+        m_WorkEpoch(0),
+        m_SleepingCount(0),
+        m_Stopping(false),
+        m_ExecutedCount(0),
+        m_StolenCount(0) {
+        const UInt32 count = threadCount != 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_Deques.reserve(count);
+        for (UInt32 i = 0; i < count; ++i) {
+            m_Deques.push_back(std::make_unique<WorkStealingDeque<Job>>(queueCapacity));
+        }
+
+        t_pJobSystem = this;
+        t_ThreadIndex = 0;
+
+        m_Workers.reserve(count - 1);
+        for (UInt32 i = 1; i < count; ++i) {
+            m_Workers.emplace_back(&JobSystem::WorkerMain, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        m_Stopping.store(true);
+        m_WorkEpoch.fetch_add(1);
+        m_WorkEpoch.notify_all();
+        m_Workers.clear();
+
+        if (t_pJobSystem == this) {
+            t_pJobSystem = nullptr;
+        }
+
+        for (const auto& deque : m_Deques) {
+            while (Job* pJob = deque->Steal()) {
+                delete pJob;
+            }
+        }
+        for (const Job* pJob : m_SharedJobs) {
+            delete pJob;
+        }
+    }
+
+    void JobSystem::Schedule(std::function<void()> function, JobCounter* pSignal,
+                             const std::span<JobCounter* const> dependencies) {
+        auto* pJob = new Job{std::move(function), pSignal, static_cast<UInt32>(dependencies.size()) + 1};
+        if (pSignal) {
+            pSignal->m_Value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        for (JobCounter* pDependency : dependencies) {
+            {
+                // Completions happen under the same lock, the counter cannot reach zero
+                // between the check and the registration.
+                std::lock_guard lock(pDependency->m_Mutex);
+                if (pDependency->m_Value.load(std::memory_order_acquire) != 0) {
+                    pDependency->m_Continuations.push_back(pJob);
+                    continue;
+                }
+            }
+
+            pJob->PendingCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        if (pJob->PendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Submit(pJob);
+        }
+    }
+
+    void JobSystem::Wait(JobCounter& counter) {
+        const UInt32 threadIndex = GetThreadIndex();
+        while (!counter.IsDone()) {
+            if (!TryRunJob(threadIndex)) {
+                std::this_thread::yield();
+            }
+        }
+
+        // The last job may still be releasing the lock, the counter must not be destroyed
+        // before it is done.
+        std::exception_ptr exception;
+        {
+            std::lock_guard lock(counter.m_Mutex);
+            exception = std::exchange(counter.m_Exception, nullptr);
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void JobSystem::ParallelFor(const UInt64 size, const UInt32 rangeCount, const std::function<void(UInt64, UInt64)>& function) {
+        if (rangeCount <= 1) {
+            function(0, size);
+            return;
+        }
+
+        const auto rangeBegin = [size, rangeCount](const UInt32 range) {
+            return size / rangeCount * range + std::min<UInt64>(size % rangeCount, range);
+        };
+
+        JobCounter counter;
+        for (UInt32 range = 1; range < rangeCount; ++range) {
+            Schedule([&function, begin = rangeBegin(range), end = rangeBegin(range + 1)] {
+                function(begin, end);
+            }, &counter);
+        }
+
+        try {
+            function(0, rangeBegin(1));
+        } catch (...) {
+            // The other ranges still reference the function.
+            try {
+                Wait(counter);
+            } catch (...) {
+            }
+            throw;
+        }
+
+        Wait(counter);
+    }
+
+    UInt32 JobSystem::GetThreadIndex() const {
+        return t_pJobSystem == this ? t_ThreadIndex : GetThreadCount();
+    }
+
+    void JobSystem::Submit(Job* pJob) {
+        const UInt32 threadIndex = GetThreadIndex();
+        if (threadIndex < GetThreadCount()) {
+            if (!m_Deques[threadIndex]->Push(pJob)) {
+                Run(pJob);
+                return;
+            }
+        } else {
+            std::lock_guard lock(m_SharedMutex);
+            m_SharedJobs.push_back(pJob);
+            m_SharedJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Sequentially consistent with the sleeping workers: either they see the new epoch,
+        // or they are counted and get notified.
+        m_WorkEpoch.fetch_add(1);
+        if (m_SleepingCount.load() != 0) {
+            m_WorkEpoch.notify_one();
+        }
+    }
+
+    void JobSystem::Run(Job* pJob) {
+        D3D12TESTS_PROFILE_SCOPE("Job");
+
+        std::exception_ptr exception;
+        try {
+            pJob->Function();
+        } catch (...) {
+            if (!pJob->Signal) {
+                std::terminate();
+            }
+            exception = std::current_exception();
+        }
+
+        JobCounter* pSignal = pJob->Signal;
+        delete pJob;
+        m_ExecutedCount.fetch_add(1, std::memory_order_relaxed);
+
+        if (pSignal) {
+            Finish(*pSignal, std::move(exception));
+        }
+    }
+
+    void JobSystem::Finish(JobCounter& counter, std::exception_ptr exception) {
+        std::vector<Job*> continuations;
+        {
+            std::lock_guard lock(counter.m_Mutex);
+            if (exception && !counter.m_Exception) {
+                counter.m_Exception = std::move(exception);
+            }
+            if (counter.m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                continuations.swap(counter.m_Continuations);
+            }
+        }
+
+        for (Job* pJob : continuations) {
+            if (pJob->PendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Submit(pJob);
+            }
+        }
+    }
+
+    bool JobSystem::TryRunJob(const UInt32 threadIndex) {
+        Job* pJob = FindJob(threadIndex);
+        if (!pJob) {
+            return false;
+        }
+
+        Run(pJob);
+        return true;
+    }
+
+    JobSystem::Job* JobSystem::FindJob(const UInt32 threadIndex) {
+        const UInt32 threadCount = GetThreadCount();
+        if (threadIndex < threadCount) {
+            if (Job* pJob = m_Deques[threadIndex]->Pop()) {
+                return pJob;
+            }
+        }
+
+        if (m_SharedJobCount.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard lock(m_SharedMutex);
+            if (!m_SharedJobs.empty()) {
+                Job* pJob = m_SharedJobs.front();
+                m_SharedJobs.pop_front();
+                m_SharedJobCount.fetch_sub(1, std::memory_order_relaxed);
+
+                return pJob;
+            }
+        }
+
+        // Start with the next thread, so that the thieves spread over the victims.
+        for (UInt32 i = 1; i <= threadCount; ++i) {
+            const UInt32 victim = (threadIndex + i) % threadCount;
+            if (victim == threadIndex) {
+                continue;
+            }
+
+            if (Job* pJob = m_Deques[victim]->Steal()) {
+                m_StolenCount.fetch_add(1, std::memory_order_relaxed);
+                return pJob;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void JobSystem::WorkerMain(const UInt32 threadIndex) {
+        t_pJobSystem = this;
+        t_ThreadIndex = threadIndex;
+        D3D12TESTS_PROFILE_THREAD("Job worker " + std::to_string(threadIndex));
+
+        while (!m_Stopping.load(std::memory_order_relaxed)) {
+            bool ranJob = false;
+            for (UInt32 i = 0; i < IdleSpinCount && !ranJob; ++i) {
+                ranJob = TryRunJob(threadIndex);
+            }
+            if (ranJob) {
+                continue;
+            }
+
+            m_SleepingCount.fetch_add(1);
+            const UInt32 epoch = m_WorkEpoch.load();
+            if (Job* pJob = FindJob(threadIndex)) {
+                m_SleepingCount.fetch_sub(1);
+                Run(pJob);
+                continue;
+            }
+
+            if (!m_Stopping.load()) {
+                m_WorkEpoch.wait(epoch);
+            }
+            m_SleepingCount.fetch_sub(1);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/LinearAllocator.hpp"
+
+namespace D3D12Tests {
+    LinearAllocator::LinearAllocator(const std::size_t capacity) :
+        m_Memory(capacity > 0 ? std::make_unique<std::byte[]>(capacity) : nullptr),
+        m_Capacity(capacity),
+        m_Offset(0) {
+    }
+
+    void* LinearAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+        // Align the actual address, the block itself is only max_align_t aligned.
+        const auto base = reinterpret_cast<std::uintptr_t>(m_Memory.get());
+        const std::uintptr_t alignedAddress = (base + m_Offset + (alignment - 1)) & ~(alignment - 1);
+        const std::size_t alignedOffset = alignedAddress - base;
+
+        if (alignedOffset + size > m_Capacity) {
+            return nullptr;
+        }
+
+        m_Offset = alignedOffset + size;
+        return m_Memory.get() + alignedOffset;
+    }
+}
@@ -0,0 +1,235 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MappedFile.hpp"
+
+#ifdef _WIN32
+#include "Framework/pch.hpp"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+#include <utility>
+
+namespace D3D12Tests {
+    MappedFile::MappedFile(const std::filesystem::path& path, const MappedFileMode mode) {
+        Open(path, mode);
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        m_Data(std::exchange(other.m_Data, nullptr)),
+        m_Size(std::exchange(other.m_Size, 0)),
+        m_Mode(other.m_Mode),
+#ifdef _WIN32
+        m_File(std::exchange(other.m_File, nullptr)),
+        m_Mapping(std::exchange(other.m_Mapping, nullptr)) {
+#else
+        m_File(std::exchange(other.m_File, -1)) {
+#endif
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            Close();
+
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Mode = other.m_Mode;
+#ifdef _WIN32
+            m_File = std::exchange(other.m_File, nullptr);
+            m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#else
+            m_File = std::exchange(other.m_File, -1);
+#endif
+        }
+
+        return *this;
+    }
+
+#ifdef _WIN32
+    void MappedFile::Open(const std::filesystem::path& path, const MappedFileMode mode) {
+        Close();
+
+        const bool write = mode == MappedFileMode::ReadWrite;
+        HANDLE file = CreateFileW(path.c_str(), write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, write ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open " + path.string() + ".");
+        }
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to query the size of " + path.string() + ".");
+        }
+
+        m_File = file;
+        m_Size = static_cast<UInt64>(size.QuadPart);
+        m_Mode = mode;
+        try {
+            Map();
+        } catch (...) {
+            // Nothing is left open when the constructor throws.
+            Close();
+            throw;
+        }
+    }
+
+    void MappedFile::Close() {
+        if (!IsOpen()) {
+            return;
+        }
+
+        Unmap();
+        CloseHandle(m_File);
+        m_File = nullptr;
+        m_Size = 0;
+    }
+
+    void MappedFile::Resize(const UInt64 size) {
+        if (m_Mode != MappedFileMode::ReadWrite) {
+            throw std::logic_error("Resizing a file mapped for reading.");
+        }
+
+        Unmap();
+
+        LARGE_INTEGER position = {};
+        position.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(m_File, position, nullptr, FILE_BEGIN) || !SetEndOfFile(m_File)) {
+            // The file keeps its size, mapped again so that the data stays valid.
+            Map();
+            throw std::runtime_error("Failed to resize a mapped file.");
+        }
+
+        m_Size = size;
+        Map();
+    }
+
+    void MappedFile::Flush() {
+        if (m_Data != nullptr && m_Mode == MappedFileMode::ReadWrite) {
+            FlushViewOfFile(m_Data, 0);
+        }
+    }
+
+    void MappedFile::Map() {
+        if (m_Size == 0) {
+            return;
+        }
+
+        const bool write = m_Mode == MappedFileMode::ReadWrite;
+        m_Mapping = CreateFileMappingW(m_File, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if (m_Mapping == nullptr) {
+            throw std::runtime_error("Failed to create a file mapping.");
+        }
+
+        m_Data = static_cast<std::byte*>(MapViewOfFile(m_Mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        if (m_Data == nullptr) {
+            CloseHandle(m_Mapping);
+            m_Mapping = nullptr;
+            throw std::runtime_error("Failed to map a file.");
+        }
+    }
+
+    void MappedFile::Unmap() {
+        if (m_Data != nullptr) {
+            UnmapViewOfFile(m_Data);
+            m_Data = nullptr;
+        }
+        if (m_Mapping != nullptr) {
+            CloseHandle(m_Mapping);
+            m_Mapping = nullptr;
+        }
+    }
+#else
+    void MappedFile::Open(const std::filesystem::path& path, const MappedFileMode mode) {
+        Close();
+
+        const bool write = mode == MappedFileMode::ReadWrite;
+        const int file = open(path.c_str(), write ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (file == -1) {
+            throw std::runtime_error("Failed to open " + path.string() + ".");
+        }
+
+        struct stat status = {};
+        if (fstat(file, &status) != 0) {
+            close(file);
+            throw std::runtime_error("Failed to query the size of " + path.string() + ".");
+        }
+
+        m_File = file;
+        m_Size = static_cast<UInt64>(status.st_size);
+        m_Mode = mode;
+        try {
+            Map();
+        } catch (...) {
+            // Nothing is left open when the constructor throws.
+            Close();
+            throw;
+        }
+    }
+
+    void MappedFile::Close() {
+        if (!IsOpen()) {
+            return;
+        }
+
+        Unmap();
+        close(m_File);
+        m_File = -1;
+        m_Size = 0;
+    }
+
+    void MappedFile::Resize(const UInt64 size) {
+        if (m_Mode != MappedFileMode::ReadWrite) {
+            throw std::logic_error("Resizing a file mapped for reading.");
+        }
+
+        Unmap();
+
+        if (ftruncate(m_File, static_cast<off_t>(size)) != 0) {
+            // The file keeps its size, mapped again so that the data stays valid.
+            Map();
+            throw std::runtime_error("Failed to resize a mapped file.");
+        }
+
+        m_Size = size;
+        Map();
+    }
+
+    void MappedFile::Flush() {
+        if (m_Data != nullptr && m_Mode == MappedFileMode::ReadWrite) {
+            msync(m_Data, m_Size, MS_ASYNC);
+        }
+    }
+
+    void MappedFile::Map() {
+        if (m_Size == 0) {
+            return;
+        }
+
+        const int protection = m_Mode == MappedFileMode::ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* pData = mmap(nullptr, m_Size, protection, MAP_SHARED, m_File, 0);
+        if (pData == MAP_FAILED) {
+            throw std::runtime_error("Failed to map a file.");
+        }
+
+        m_Data = static_cast<std::byte*>(pData);
+    }
+
+    void MappedFile::Unmap() {
+        if (m_Data != nullptr) {
+            munmap(m_Data, m_Size);
+            m_Data = nullptr;
+        }
+    }
+#endif
+}
@@ -0,0 +1,222 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MeshData.hpp"
+
+#include "Framework/Alignment.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    static_assert(std::endian::native == std::endian::little, "The mesh format is little-endian.");
+
+    namespace {
+        void ResetBounds(Float32 (&boundsMin)[3], Float32 (&boundsMax)[3]) {
+            for (UInt32 axis = 0; axis < 3; ++axis) {
+                boundsMin[axis] = std::numeric_limits<Float32>::max();
+                boundsMax[axis] = std::numeric_limits<Float32>::lowest();
+            }
+        }
+
+        void ExpandBounds(Float32 (&boundsMin)[3], Float32 (&boundsMax)[3], const Float32 (&position)[3]) {
+            for (UInt32 axis = 0; axis < 3; ++axis) {
+                boundsMin[axis] = std::min(boundsMin[axis], position[axis]);
+                boundsMax[axis] = std::max(boundsMax[axis], position[axis]);
+            }
+        }
+
+        // Empty bounds are written as zeros rather than inverted infinities.
+        void ClearEmptyBounds(Float32 (&boundsMin)[3], Float32 (&boundsMax)[3]) {
+            if (boundsMin[0] > boundsMax[0]) {
+                std::fill(std::begin(boundsMin), std::end(boundsMin), 0.0f);
+                std::fill(std::begin(boundsMax), std::end(boundsMax), 0.0f);
+            }
+        }
+
+        template<typename T>
+        void Append(std::vector<std::byte>& data, const T& value) {
+            const auto* pValue = reinterpret_cast<const std::byte*>(&value);
+            data.insert(data.end(), pValue, pValue + sizeof(T));
+        }
+    }
+
+    const char* GetMeshSemanticName(const MeshSemantic semantic) {
+        switch (semantic) {
+            case MeshSemantic::Position:
+                return "POSITION";
+            case MeshSemantic::Normal:
+                return "NORMAL";
+            case MeshSemantic::Tangent:
+                return "TANGENT";
+            case MeshSemantic::TexCoord:
+                return "TEXCOORD";
+            case MeshSemantic::Color:
+                return "COLOR";
+        }
+
+        return "UNKNOWN";
+    }
+
+    void ComputeMeshBounds(MeshData& mesh) {
+        ValidateMeshData(mesh);
+
+        const MeshStream* pPositions = mesh.FindStream(MeshSemantic::Position);
+        if (pPositions == nullptr || pPositions->Format != DxgiFormat::R32G32B32Float) {
+            throw std::invalid_argument("The mesh bounds need R32G32B32_FLOAT positions.");
+        }
+
+        ResetBounds(mesh.BoundsMin, mesh.BoundsMax);
+        for (MeshSubmesh& submesh : mesh.Submeshes) {
+            ResetBounds(submesh.BoundsMin, submesh.BoundsMax);
+            if (!submesh.Lods.empty()) {
+                const MeshLodDesc& lod = submesh.Lods.front();
+                for (UInt32 i = lod.FirstIndex; i < lod.FirstIndex + lod.IndexCount; ++i) {
+                    Float32 position[3];
+                    const UInt64 vertex = UInt64(lod.BaseVertex) + mesh.Indices[i];
+                    std::memcpy(position, pPositions->Data.data() + vertex * pPositions->Stride, sizeof(position));
+                    ExpandBounds(submesh.BoundsMin, submesh.BoundsMax, position);
+                }
+            }
+
+            ClearEmptyBounds(submesh.BoundsMin, submesh.BoundsMax);
+            if (!submesh.Lods.empty() && submesh.Lods.front().IndexCount != 0) {
+                ExpandBounds(mesh.BoundsMin, mesh.BoundsMax, submesh.BoundsMin);
+                ExpandBounds(mesh.BoundsMin, mesh.BoundsMax, submesh.BoundsMax);
+            }
+        }
+
+        ClearEmptyBounds(mesh.BoundsMin, mesh.BoundsMax);
+    }
+
+    void ValidateMeshData(const MeshData& mesh) {
+        for (const MeshStream& stream : mesh.Streams) {
+            const UInt32 formatSize = GetTextureFormatInfo(stream.Format).BlockSize;
+            if (formatSize == 0 || stream.Stride < formatSize) {
+                throw std::invalid_argument("A mesh stream has an unknown format or a stride smaller than it.");
+            }
+            if (stream.Data.size() != UInt64(stream.Stride) * mesh.VertexCount) {
+                throw std::invalid_argument("A mesh stream does not hold one element per vertex.");
+            }
+            if (mesh.FindStream(stream.Semantic, stream.SemanticIndex) != &stream) {
+                throw std::invalid_argument("Two mesh streams have the same semantic.");
+            }
+        }
+
+        for (const MeshSubmesh& submesh : mesh.Submeshes) {
+            for (const MeshLodDesc& lod : submesh.Lods) {
+                if (lod.IndexCount % 3 != 0 || UInt64(lod.FirstIndex) + lod.IndexCount > mesh.Indices.size() ||
+                    UInt64(lod.BaseVertex) + lod.VertexCount > mesh.VertexCount) {
+                    throw std::invalid_argument("A mesh level of detail is out of the index or vertex ranges.");
+                }
+
+                const auto first = mesh.Indices.begin() + lod.FirstIndex;
+                if (std::any_of(first, first + lod.IndexCount, [&](const UInt32 index) {
+                    return index >= lod.VertexCount;
+                })) {
+                    throw std::invalid_argument("A mesh index is out of its level's vertex range.");
+                }
+            }
+        }
+    }
+
+    void SaveMeshFile(const MeshData& mesh, const std::filesystem::path& path) {
+        ValidateMeshData(mesh);
+
+        const UInt32 maxIndex = mesh.Indices.empty() ? 0 : *std::max_element(mesh.Indices.begin(), mesh.Indices.end());
+        const bool useShortIndices = maxIndex <= std::numeric_limits<UInt16>::max();
+        const UInt64 indexStride = useShortIndices ? sizeof(UInt16) : sizeof(UInt32);
+
+        UInt32 lodCount = 0;
+        for (const MeshSubmesh& submesh : mesh.Submeshes) {
+            lodCount += static_cast<UInt32>(submesh.Lods.size());
+        }
+
+        MeshFileHeader header = {};
+        header.Magic = MeshFileMagic;
+        header.Version = MeshFileVersion;
+        header.StreamCount = static_cast<UInt32>(mesh.Streams.size());
+        header.SubmeshCount = static_cast<UInt32>(mesh.Submeshes.size());
+        header.LodCount = lodCount;
+        header.VertexCount = mesh.VertexCount;
+        header.IndexCount = static_cast<UInt32>(mesh.Indices.size());
+        header.IndexFormat = useShortIndices ? DxgiFormat::R16Uint : DxgiFormat::R32Uint;
+        std::copy(std::begin(mesh.BoundsMin), std::end(mesh.BoundsMin), header.BoundsMin);
+        std::copy(std::begin(mesh.BoundsMax), std::end(mesh.BoundsMax), header.BoundsMax);
+
+        // Lay the geometry out first, the tables point into it.
+        std::vector<MeshStreamDesc> streams;
+        UInt64 geometrySize = 0;
+        for (const MeshStream& stream : mesh.Streams) {
+            streams.push_back({stream.Semantic, stream.SemanticIndex, stream.Format, stream.Stride, geometrySize,
+                               stream.Data.size()});
+            geometrySize = AlignUp(geometrySize + stream.Data.size(), MeshDataAlignment);
+        }
+        header.IndexOffset = geometrySize;
+        header.GeometrySize = geometrySize + mesh.Indices.size() * indexStride;
+
+        const UInt64 tableSize = sizeof(MeshFileHeader) + streams.size() * sizeof(MeshStreamDesc) +
+            mesh.Submeshes.size() * sizeof(MeshSubmeshDesc) + lodCount * sizeof(MeshLodDesc);
+        header.GeometryOffset = AlignUp(tableSize, MeshDataAlignment);
+
+        std::vector<std::byte> data;
+        data.reserve(header.GeometryOffset + header.GeometrySize);
+        Append(data, header);
+        for (const MeshStreamDesc& stream : streams) {
+            Append(data, stream);
+        }
+
+        UInt32 firstLod = 0;
+        for (const MeshSubmesh& submesh : mesh.Submeshes) {
+            MeshSubmeshDesc desc = {};
+            submesh.Name.copy(desc.Name, MeshNameSize - 1);
+            desc.MaterialIndex = submesh.MaterialIndex;
+            desc.FirstLod = firstLod;
+            desc.LodCount = static_cast<UInt32>(submesh.Lods.size());
+            std::copy(std::begin(submesh.BoundsMin), std::end(submesh.BoundsMin), desc.BoundsMin);
+            std::copy(std::begin(submesh.BoundsMax), std::end(submesh.BoundsMax), desc.BoundsMax);
+            Append(data, desc);
+            firstLod += desc.LodCount;
+        }
+        for (const MeshSubmesh& submesh : mesh.Submeshes) {
+            for (const MeshLodDesc& lod : submesh.Lods) {
+                Append(data, lod);
+            }
+        }
+
+        data.resize(header.GeometryOffset);
+        for (UInt32 i = 0; i < streams.size(); ++i) {
+            data.resize(header.GeometryOffset + streams[i].Offset);
+            data.insert(data.end(), mesh.Streams[i].Data.begin(), mesh.Streams[i].Data.end());
+        }
+        data.resize(header.GeometryOffset + header.IndexOffset);
+        if (useShortIndices) {
+            for (const UInt32 index : mesh.Indices) {
+                Append(data, static_cast<UInt16>(index));
+            }
+        } else {
+            for (const UInt32 index : mesh.Indices) {
+                Append(data, index);
+            }
+        }
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                throw std::runtime_error("Failed to write " + path.string());
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path);
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MeshFile.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    static_assert(std::endian::native == std::endian::little, "The mesh format is little-endian.");
+
+    namespace {
+        template<typename T>
+        void ReadTable(const std::byte* pData, UInt64& offset, const UInt32 count, std::vector<T>& table) {
+            table.resize(count);
+            std::memcpy(table.data(), pData + offset, count * sizeof(T));
+            offset += count * sizeof(T);
+        }
+    }
+
+    MeshFile::MeshFile(const std::filesystem::path& path) :
+        m_File(path, MappedFileMode::Read),
+        m_Header() {
+        ReadHeader();
+        ReadTables();
+    }
+
+    const MeshStreamDesc* MeshFile::FindStream(const MeshSemantic semantic, const UInt32 semanticIndex) const {
+        for (const MeshStreamDesc& stream : m_Streams) {
+            if (stream.Semantic == semantic && stream.SemanticIndex == semanticIndex) {
+                return &stream;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void MeshFile::ReadHeader() {
+        const UInt64 fileSize = m_File.GetSize();
+        if (fileSize < sizeof(MeshFileHeader)) {
+            throw std::runtime_error("The mesh file is too small for its header.");
+        }
+
+        // The tables are a few hundred bytes, they are copied out of the mapping like the
+        // header; only the geometry stays in it.
+        std::memcpy(&m_Header, m_File.GetData(), sizeof(MeshFileHeader));
+        if (m_Header.Magic != MeshFileMagic) {
+            throw std::runtime_error("The file is not a mesh file.");
+        }
+        if (m_Header.Version != MeshFileVersion) {
+            throw std::runtime_error("The mesh file was written for another version of the format.");
+        }
+
+        const UInt64 tableSize = sizeof(MeshFileHeader) + UInt64(m_Header.StreamCount) * sizeof(MeshStreamDesc) +
+            UInt64(m_Header.SubmeshCount) * sizeof(MeshSubmeshDesc) + UInt64(m_Header.LodCount) * sizeof(MeshLodDesc);
+        if (m_Header.GeometryOffset < tableSize || m_Header.GeometryOffset % MeshDataAlignment != 0 ||
+            m_Header.GeometryOffset > fileSize || m_Header.GeometrySize > fileSize - m_Header.GeometryOffset) {
+            throw std::runtime_error("The mesh file is truncated.");
+        }
+
+        if (m_Header.IndexFormat != DxgiFormat::R16Uint && m_Header.IndexFormat != DxgiFormat::R32Uint) {
+            throw std::runtime_error("The mesh file has an unknown index format.");
+        }
+        if (m_Header.IndexOffset > m_Header.GeometrySize ||
+            UInt64(m_Header.IndexCount) * GetIndexStride() > m_Header.GeometrySize - m_Header.IndexOffset) {
+            throw std::runtime_error("The indices of the mesh file are out of its geometry.");
+        }
+        // An index buffer view starts at a multiple of the index size.
+        if (m_Header.IndexOffset % GetIndexStride() != 0) {
+            throw std::runtime_error("The indices of the mesh file are misaligned.");
+        }
+    }
+
+    void MeshFile::ReadTables() {
+        UInt64 offset = sizeof(MeshFileHeader);
+        ReadTable(m_File.GetData(), offset, m_Header.StreamCount, m_Streams);
+        ReadTable(m_File.GetData(), offset, m_Header.SubmeshCount, m_Submeshes);
+        ReadTable(m_File.GetData(), offset, m_Header.LodCount, m_Lods);
+
+        for (const MeshStreamDesc& stream : m_Streams) {
+            const UInt32 formatSize = GetTextureFormatInfo(stream.Format).BlockSize;
+            if (formatSize == 0 || stream.Stride < formatSize || stream.Size != UInt64(stream.Stride) * m_Header.VertexCount ||
+                stream.Offset % MeshDataAlignment != 0 || stream.Offset > m_Header.GeometrySize ||
+                stream.Size > m_Header.GeometrySize - stream.Offset) {
+                throw std::runtime_error("A stream of the mesh file is malformed.");
+            }
+        }
+
+        for (const MeshSubmeshDesc& submesh : m_Submeshes) {
+            if (UInt64(submesh.FirstLod) + submesh.LodCount > m_Header.LodCount) {
+                throw std::runtime_error("A submesh of the mesh file is out of its level of detail table.");
+            }
+        }
+
+        for (const MeshLodDesc& lod : m_Lods) {
+            if (lod.IndexCount % 3 != 0 || UInt64(lod.FirstIndex) + lod.IndexCount > m_Header.IndexCount ||
+                UInt64(lod.BaseVertex) + lod.VertexCount > m_Header.VertexCount) {
+                throw std::runtime_error("A level of detail of the mesh file is out of its geometry.");
+            }
+        }
+    }
+}
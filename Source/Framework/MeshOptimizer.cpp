@@ -0,0 +1,934 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MeshOptimizer.hpp"
+
+#include "Framework/Hash.hpp"
+#include "Framework/ParallelFor.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 InvalidVertex = std::numeric_limits<UInt32>::max();
+
+        // Vertex fetch cache: 64 lines of 64 bytes.
+        constexpr UInt32 FetchLineSize = 64;
+        constexpr UInt32 FetchCacheLineCount = 64;
+
+        // Forsyth's recommended scoring parameters.
+        constexpr UInt32 ForsythCacheSize = 32;
+        constexpr Float32 ForsythLastTriangleScore = 0.75f;
+        constexpr Float32 ForsythCacheDecayPower = 1.5f;
+        constexpr Float32 ForsythValenceBoostScale = 2.0f;
+        constexpr Float32 ForsythValenceBoostPower = 0.5f;
+
+        // Triangles around each vertex, in compressed rows.
+        struct VertexAdjacency {
+            std::vector<UInt32> Offsets;
+            std::vector<UInt32> Triangles;
+        };
+
+        void BuildAdjacency(const std::span<const UInt32> indices, const UInt32 vertexCount, VertexAdjacency& adjacency) {
+            adjacency.Offsets.assign(UInt64(vertexCount) + 1, 0);
+            for (const UInt32 index : indices) {
+                ++adjacency.Offsets[index + 1];
+            }
+            std::partial_sum(adjacency.Offsets.begin(), adjacency.Offsets.end(), adjacency.Offsets.begin());
+
+            std::vector<UInt32> cursors(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+            adjacency.Triangles.resize(indices.size());
+            for (UInt64 i = 0; i < indices.size(); ++i) {
+                adjacency.Triangles[cursors[indices[i]]++] = static_cast<UInt32>(i / 3);
+            }
+        }
+
+        void CheckTriangleList(const std::span<const UInt32> indices, const UInt32 vertexCount) {
+            if (indices.size() % 3 != 0) {
+                throw std::invalid_argument("The index buffer is not a triangle list.");
+            }
+            if (indices.size() / 3 > std::numeric_limits<UInt32>::max()) {
+                throw std::invalid_argument("The index buffer has too many triangles.");
+            }
+            for (const UInt32 index : indices) {
+                if (index >= vertexCount) {
+                    throw std::invalid_argument("An index is out of the vertices.");
+                }
+            }
+        }
+
+        // FIFO cache simulated with the time each vertex entered it: a vertex is cached while
+        // fewer than cacheSize vertices entered after it. Bumping the time by more than the
+        // cache size empties it.
+        class FifoCache {
+            public:
+                FifoCache(const UInt32 vertexCount, const UInt32 cacheSize) :
+                    m_EntryTimes(vertexCount, 0),
+                    m_CacheSize(cacheSize),
+                    m_Time(cacheSize + 1) {
+                }
+
+                // Returns whether the vertex missed.
+                bool Access(const UInt32 vertex) {
+                    if (m_Time - m_EntryTimes[vertex] > m_CacheSize) {
+                        m_EntryTimes[vertex] = m_Time++;
+                        return true;
+                    }
+
+                    return false;
+                }
+
+                void Clear() {
+                    m_Time += m_CacheSize + 1;
+                }
+
+                [[nodiscard]] UInt32 GetAge(const UInt32 vertex) const {
+                    return m_Time - m_EntryTimes[vertex];
+                }
+
+            private:
+                std::vector<UInt32> m_EntryTimes;
+                UInt32 m_CacheSize;
+                UInt32 m_Time;
+        };
+
+        struct FetchTotals {
+            UInt64 BytesFetched = 0;
+            UInt64 BytesReferenced = 0;
+        };
+
+        FetchTotals SimulateVertexFetch(const std::span<const UInt32> indices, const UInt32 vertexCount, const UInt32 vertexStride) {
+            const UInt64 lineCount = (UInt64(vertexCount) * vertexStride + FetchLineSize - 1) / FetchLineSize;
+            std::vector<UInt64> lineEntryTimes(lineCount, 0);
+            std::vector<bool> referenced(vertexCount, false);
+            UInt64 time = FetchCacheLineCount + 1;
+
+            FetchTotals totals;
+            for (const UInt32 index : indices) {
+                if (!referenced[index]) {
+                    referenced[index] = true;
+                    totals.BytesReferenced += vertexStride;
+                }
+
+                const UInt64 firstLine = UInt64(index) * vertexStride / FetchLineSize;
+                const UInt64 lastLine = (UInt64(index) * vertexStride + vertexStride - 1) / FetchLineSize;
+                for (UInt64 line = firstLine; line <= lastLine; ++line) {
+                    if (time - lineEntryTimes[line] > FetchCacheLineCount) {
+                        lineEntryTimes[line] = time++;
+                        totals.BytesFetched += FetchLineSize;
+                    }
+                }
+            }
+
+            return totals;
+        }
+
+        void FinishStatistics(VertexCacheStatistics& statistics) {
+            statistics.Acmr = statistics.TriangleCount != 0 ?
+                static_cast<Float64>(statistics.TransformCount) / static_cast<Float64>(statistics.TriangleCount) : 0.0;
+            statistics.Atvr = statistics.VertexCount != 0 ?
+                static_cast<Float64>(statistics.TransformCount) / static_cast<Float64>(statistics.VertexCount) : 0.0;
+        }
+
+        VertexFetchStatistics MakeFetchStatistics(const FetchTotals& totals) {
+            VertexFetchStatistics statistics;
+            statistics.BytesFetched = totals.BytesFetched;
+            statistics.Overfetch = totals.BytesReferenced != 0 ?
+                static_cast<Float64>(totals.BytesFetched) / static_cast<Float64>(totals.BytesReferenced) : 0.0;
+
+            return statistics;
+        }
+
+        // Tipsify walks the fan of triangles around a vertex, then moves to the vertex of the fan
+        // that keeps the most cache hits for its remaining triangles, backtracking through
+        // the recently emitted vertices at dead ends.
+        void TipsifyRange(const std::span<UInt32> indices, const UInt32 vertexCount, const UInt32 cacheSize) {
+            VertexAdjacency adjacency;
+            BuildAdjacency(indices, vertexCount, adjacency);
+
+            std::vector<UInt32> liveTriangles(vertexCount);
+            for (UInt32 vertex = 0; vertex < vertexCount; ++vertex) {
+                liveTriangles[vertex] = adjacency.Offsets[vertex + 1] - adjacency.Offsets[vertex];
+            }
+
+            std::vector<bool> emitted(indices.size() / 3, false);
+            std::vector<UInt32> output;
+            output.reserve(indices.size());
+            std::vector<UInt32> deadEnds;
+            deadEnds.reserve(indices.size());
+            std::vector<UInt32> candidates;
+            FifoCache cache(vertexCount, cacheSize);
+
+            UInt32 cursor = 0;
+            const auto skipDeadEnd = [&]() {
+                while (!deadEnds.empty()) {
+                    const UInt32 vertex = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[vertex] != 0) {
+                        return vertex;
+                    }
+                }
+
+                for (; cursor < vertexCount; ++cursor) {
+                    if (liveTriangles[cursor] != 0) {
+                        return cursor;
+                    }
+                }
+
+                return InvalidVertex;
+            };
+
+            UInt32 fanVertex = skipDeadEnd();
+            while (fanVertex != InvalidVertex) {
+                candidates.clear();
+                for (UInt32 i = adjacency.Offsets[fanVertex]; i < adjacency.Offsets[fanVertex + 1]; ++i) {
+                    const UInt32 triangle = adjacency.Triangles[i];
+                    if (emitted[triangle]) {
+                        continue;
+                    }
+
+                    for (UInt32 corner = 0; corner < 3; ++corner) {
+                        const UInt32 vertex = indices[triangle * 3 + corner];
+                        output.push_back(vertex);
+                        deadEnds.push_back(vertex);
+                        candidates.push_back(vertex);
+                        --liveTriangles[vertex];
+                        cache.Access(vertex);
+                    }
+                    emitted[triangle] = true;
+                }
+
+                // A candidate is only worth its age if its remaining triangles can be emitted
+                // before it leaves the cache.
+                UInt32 bestVertex = InvalidVertex;
+                Int64 bestPriority = -1;
+                for (const UInt32 vertex : candidates) {
+                    if (liveTriangles[vertex] == 0) {
+                        continue;
+                    }
+
+                    const UInt32 age = cache.GetAge(vertex);
+                    const Int64 priority = age + 2 * UInt64(liveTriangles[vertex]) <= cacheSize ? age : 0;
+                    if (priority > bestPriority) {
+                        bestVertex = vertex;
+                        bestPriority = priority;
+                    }
+                }
+
+                fanVertex = bestVertex != InvalidVertex ? bestVertex : skipDeadEnd();
+            }
+
+            std::ranges::copy(output, indices.begin());
+        }
+
+        // Tables of the two terms of the score, indexed by cache position and live triangle count.
+        struct ForsythScoreTables {
+            std::array<Float32, ForsythCacheSize> CachePosition;
+            std::array<Float32, 64> Valence;
+
+            ForsythScoreTables() {
+                for (UInt32 position = 0; position < ForsythCacheSize; ++position) {
+                    const Float32 scale = 1.0f / static_cast<Float32>(ForsythCacheSize - 3);
+                    CachePosition[position] = position < 3 ? ForsythLastTriangleScore :
+                        std::pow(1.0f - static_cast<Float32>(position - 3) * scale, ForsythCacheDecayPower);
+                }
+                for (UInt32 liveTriangles = 0; liveTriangles < Valence.size(); ++liveTriangles) {
+                    Valence[liveTriangles] = GetValenceScore(liveTriangles);
+                }
+            }
+
+            static Float32 GetValenceScore(const UInt32 liveTriangles) {
+                return ForsythValenceBoostScale * std::pow(static_cast<Float32>(liveTriangles), -ForsythValenceBoostPower);
+            }
+        };
+
+        Float32 GetForsythVertexScore(const ForsythScoreTables& tables, const UInt32 cachePosition, const UInt32 liveTriangles) {
+            if (liveTriangles == 0) {
+                return -1.0f;
+            }
+
+            const Float32 cacheScore = cachePosition < ForsythCacheSize ? tables.CachePosition[cachePosition] : 0.0f;
+            const Float32 valenceScore = liveTriangles < tables.Valence.size() ? tables.Valence[liveTriangles] :
+                ForsythScoreTables::GetValenceScore(liveTriangles);
+
+            return cacheScore + valenceScore;
+        }
+
+        // Forsyth emits the best scored triangle among those of the cached vertices, then
+        // rescores the vertices whose cache position changed.
+        void ForsythRange(const std::span<UInt32> indices, const UInt32 vertexCount) {
+            const UInt32 triangleCount = static_cast<UInt32>(indices.size() / 3);
+            VertexAdjacency adjacency;
+            BuildAdjacency(indices, vertexCount, adjacency);
+            static const ForsythScoreTables tables;
+
+            // The first liveTriangles entries of each adjacency row are the live triangles.
+            std::vector<UInt32> liveTriangles(vertexCount);
+            std::vector<UInt32> cachePositions(vertexCount, InvalidVertex);
+            std::vector<Float32> vertexScores(vertexCount);
+            for (UInt32 vertex = 0; vertex < vertexCount; ++vertex) {
+                liveTriangles[vertex] = adjacency.Offsets[vertex + 1] - adjacency.Offsets[vertex];
+                vertexScores[vertex] = GetForsythVertexScore(tables, InvalidVertex, liveTriangles[vertex]);
+            }
+
+            std::vector<Float32> triangleScores(triangleCount);
+            std::vector<bool> emitted(triangleCount, false);
+            UInt32 bestTriangle = InvalidVertex;
+            Float32 bestScore = -1.0f;
+            for (UInt32 triangle = 0; triangle < triangleCount; ++triangle) {
+                triangleScores[triangle] = vertexScores[indices[triangle * 3]] + vertexScores[indices[triangle * 3 + 1]] +
+                    vertexScores[indices[triangle * 3 + 2]];
+                if (triangleScores[triangle] > bestScore) {
+                    bestTriangle = triangle;
+                    bestScore = triangleScores[triangle];
+                }
+            }
+
+            std::vector<UInt32> output;
+            output.reserve(indices.size());
+            std::vector<UInt32> cache;
+            std::vector<UInt32> nextCache;
+            cache.reserve(ForsythCacheSize + 3);
+            nextCache.reserve(ForsythCacheSize + 3);
+            UInt32 cursor = 0;
+
+            for (UInt32 emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+                // With no live triangle around the cache, restart from the next one in the input.
+                if (bestTriangle == InvalidVertex) {
+                    while (emitted[cursor]) {
+                        ++cursor;
+                    }
+                    bestTriangle = cursor;
+                }
+
+                emitted[bestTriangle] = true;
+                nextCache.clear();
+                for (UInt32 corner = 0; corner < 3; ++corner) {
+                    const UInt32 vertex = indices[bestTriangle * 3 + corner];
+                    output.push_back(vertex);
+                    nextCache.push_back(vertex);
+
+                    UInt32* pRow = adjacency.Triangles.data() + adjacency.Offsets[vertex];
+                    std::swap(*std::find(pRow, pRow + liveTriangles[vertex], bestTriangle), pRow[liveTriangles[vertex] - 1]);
+                    --liveTriangles[vertex];
+                }
+
+                for (const UInt32 vertex : cache) {
+                    if (std::ranges::find(nextCache.begin(), nextCache.begin() + 3, vertex) == nextCache.begin() + 3) {
+                        nextCache.push_back(vertex);
+                    }
+                }
+
+                // The vertices pushed out of the cache are rescored too, as uncached.
+                for (UInt32 i = 0; i < nextCache.size(); ++i) {
+                    cachePositions[nextCache[i]] = i < ForsythCacheSize ? i : InvalidVertex;
+                }
+                for (const UInt32 vertex : nextCache) {
+                    const Float32 score = GetForsythVertexScore(tables, cachePositions[vertex], liveTriangles[vertex]);
+                    const Float32 delta = score - vertexScores[vertex];
+                    vertexScores[vertex] = score;
+                    for (UInt32 i = 0; i < liveTriangles[vertex]; ++i) {
+                        triangleScores[adjacency.Triangles[adjacency.Offsets[vertex] + i]] += delta;
+                    }
+                }
+
+                if (nextCache.size() > ForsythCacheSize) {
+                    nextCache.resize(ForsythCacheSize);
+                }
+                std::swap(cache, nextCache);
+
+                bestTriangle = InvalidVertex;
+                bestScore = -1.0f;
+                for (const UInt32 vertex : cache) {
+                    for (UInt32 i = 0; i < liveTriangles[vertex]; ++i) {
+                        const UInt32 triangle = adjacency.Triangles[adjacency.Offsets[vertex] + i];
+                        if (triangleScores[triangle] > bestScore) {
+                            bestTriangle = triangle;
+                            bestScore = triangleScores[triangle];
+                        }
+                    }
+                }
+            }
+
+            std::ranges::copy(output, indices.begin());
+        }
+
+        void OptimizeVertexCacheRange(const std::span<UInt32> indices, const UInt32 vertexCount, const MeshOptimizeOptions& options) {
+            switch (options.CacheAlgorithm) {
+                case VertexCacheAlgorithm::Tipsify:
+                    TipsifyRange(indices, vertexCount, std::max(options.CacheSize, 3u));
+                    break;
+                case VertexCacheAlgorithm::Forsyth:
+                    ForsythRange(indices, vertexCount);
+                    break;
+            }
+        }
+
+        struct Vector3 {
+            Float64 X = 0.0;
+            Float64 Y = 0.0;
+            Float64 Z = 0.0;
+        };
+
+        Vector3 LoadPosition(const std::span<const std::byte> positions, const UInt32 stride, const UInt32 vertex) {
+            Float32 position[3];
+            std::memcpy(position, positions.data() + UInt64(vertex) * stride, sizeof(position));
+
+            return {position[0], position[1], position[2]};
+        }
+
+        const MeshStream& GetWeldablePositions(const MeshData& mesh) {
+            const MeshStream* pPositions = mesh.FindStream(MeshSemantic::Position);
+            if (pPositions == nullptr || pPositions->Format != DxgiFormat::R32G32B32Float) {
+                throw std::invalid_argument("The mesh optimizer needs R32G32B32_FLOAT positions.");
+            }
+
+            return *pPositions;
+        }
+
+        // Adds each base vertex to the indices of its level, so that vertices can be moved
+        // across levels.
+        void MakeIndicesAbsolute(MeshData& mesh) {
+            std::vector<std::pair<UInt32, UInt32>> ranges;
+            for (const MeshSubmesh& submesh : mesh.Submeshes) {
+                for (const MeshLodDesc& lod : submesh.Lods) {
+                    if (lod.IndexCount != 0) {
+                        ranges.emplace_back(lod.FirstIndex, lod.FirstIndex + lod.IndexCount);
+                    }
+                }
+            }
+            std::ranges::sort(ranges);
+            for (UInt64 i = 1; i < ranges.size(); ++i) {
+                if (ranges[i].first < ranges[i - 1].second) {
+                    throw std::invalid_argument("The levels of detail of the mesh share indices.");
+                }
+            }
+
+            for (MeshSubmesh& submesh : mesh.Submeshes) {
+                for (MeshLodDesc& lod : submesh.Lods) {
+                    for (UInt32 i = lod.FirstIndex; i < lod.FirstIndex + lod.IndexCount; ++i) {
+                        mesh.Indices[i] += lod.BaseVertex;
+                    }
+                    lod.BaseVertex = 0;
+                    lod.VertexCount = mesh.VertexCount;
+                }
+            }
+        }
+
+        // Rebases each level on the lowest vertex it uses, which keeps the indices of the
+        // coarser levels small enough for 16 bits more often.
+        void RebaseIndices(MeshData& mesh) {
+            for (MeshSubmesh& submesh : mesh.Submeshes) {
+                for (MeshLodDesc& lod : submesh.Lods) {
+                    const auto first = mesh.Indices.begin() + lod.FirstIndex;
+                    const auto last = first + lod.IndexCount;
+                    if (first == last) {
+                        lod.BaseVertex = 0;
+                        lod.VertexCount = 0;
+                        continue;
+                    }
+
+                    const auto [minIndex, maxIndex] = std::minmax_element(first, last);
+                    lod.BaseVertex = *minIndex;
+                    lod.VertexCount = *maxIndex - *minIndex + 1;
+                    std::for_each(first, last, [base = lod.BaseVertex](UInt32& index) { index -= base; });
+                }
+            }
+        }
+
+        template<typename Function>
+        void ForEachLodRange(MeshData& mesh, Function&& function) {
+            for (MeshSubmesh& submesh : mesh.Submeshes) {
+                for (const MeshLodDesc& lod : submesh.Lods) {
+                    function(std::span<UInt32>(mesh.Indices).subspan(lod.FirstIndex, lod.IndexCount));
+                }
+            }
+        }
+
+        // Moves each vertex to its remapped position, InvalidVertex dropping it; the kept
+        // vertices must map to distinct positions. The indices must be absolute.
+        void RemapVertices(MeshData& mesh, const std::span<const UInt32> remap, const UInt32 newVertexCount) {
+            for (MeshStream& stream : mesh.Streams) {
+                std::vector<std::byte> data(UInt64(newVertexCount) * stream.Stride);
+                for (UInt32 vertex = 0; vertex < mesh.VertexCount; ++vertex) {
+                    if (remap[vertex] != InvalidVertex) {
+                        std::memcpy(data.data() + UInt64(remap[vertex]) * stream.Stride,
+                                    stream.Data.data() + UInt64(vertex) * stream.Stride, stream.Stride);
+                    }
+                }
+                stream.Data = std::move(data);
+            }
+
+            ForEachLodRange(mesh, [&remap](const std::span<UInt32> indices) {
+                for (UInt32& index : indices) {
+                    index = remap[index];
+                }
+            });
+
+            mesh.VertexCount = newVertexCount;
+            for (MeshSubmesh& submesh : mesh.Submeshes) {
+                for (MeshLodDesc& lod : submesh.Lods) {
+                    lod.VertexCount = newVertexCount;
+                }
+            }
+        }
+
+        void ReorderVerticesForFetch(MeshData& mesh) {
+            std::vector<UInt32> remap(mesh.VertexCount, InvalidVertex);
+            UInt32 vertexCount = 0;
+            ForEachLodRange(mesh, [&](const std::span<UInt32> indices) {
+                for (const UInt32 index : indices) {
+                    if (remap[index] == InvalidVertex) {
+                        remap[index] = vertexCount++;
+                    }
+                }
+            });
+
+            RemapVertices(mesh, remap, vertexCount);
+        }
+
+        UInt64 HashCell(const std::array<Int64, 3>& cell) {
+            return HashCombine(HashCombine(static_cast<UInt64>(cell[0]), static_cast<UInt64>(cell[1])), static_cast<UInt64>(cell[2]));
+        }
+
+        // Points the indices of the duplicate vertices to the first of them, leaving the
+        // duplicates unused. The vertices are bucketed in a hash grid of cells of the weld
+        // distance, so that the vertices within the distance of one are in the 27 cells
+        // around it; at a distance of zero, a cell is one exact position.
+        void WeldIndices(MeshData& mesh, const Float32 distance) {
+            const MeshStream& positions = GetWeldablePositions(mesh);
+            const Float64 squaredDistance = Float64(distance) * distance;
+            const Float64 cellScale = distance > 0.0f ? 1.0 / distance : 0.0;
+
+            const auto getCell = [&](const UInt32 vertex) {
+                const Vector3 position = LoadPosition(positions.Data, positions.Stride, vertex);
+                if (distance == 0.0f) {
+                    // Adding zero folds -0 onto 0, which compare equal.
+                    return std::array<Int64, 3>{std::bit_cast<UInt32>(Float32(position.X) + 0.0f),
+                                                std::bit_cast<UInt32>(Float32(position.Y) + 0.0f),
+                                                std::bit_cast<UInt32>(Float32(position.Z) + 0.0f)};
+                }
+
+                if (!std::isfinite(position.X) || !std::isfinite(position.Y) || !std::isfinite(position.Z)) {
+                    return std::array<Int64, 3>{};
+                }
+
+                return std::array<Int64, 3>{static_cast<Int64>(std::floor(position.X * cellScale)),
+                                            static_cast<Int64>(std::floor(position.Y * cellScale)),
+                                            static_cast<Int64>(std::floor(position.Z * cellScale))};
+            };
+
+            const auto matches = [&](const UInt32 kept, const UInt32 vertex) {
+                const Vector3 a = LoadPosition(positions.Data, positions.Stride, kept);
+                const Vector3 b = LoadPosition(positions.Data, positions.Stride, vertex);
+                const Float64 dx = a.X - b.X;
+                const Float64 dy = a.Y - b.Y;
+                const Float64 dz = a.Z - b.Z;
+                if (!(dx * dx + dy * dy + dz * dz <= squaredDistance)) {
+                    return false;
+                }
+
+                for (const MeshStream& stream : mesh.Streams) {
+                    if (&stream != &positions && std::memcmp(stream.Data.data() + UInt64(kept) * stream.Stride,
+                                                             stream.Data.data() + UInt64(vertex) * stream.Stride, stream.Stride) != 0) {
+                        return false;
+                    }
+                }
+
+                return true;
+            };
+
+            // Chains of the kept vertices, one per bucket of an open table twice the vertex count.
+            const UInt64 bucketCount = std::bit_ceil(std::max<UInt64>(UInt64(mesh.VertexCount) * 2, 16));
+            std::vector<UInt32> buckets(bucketCount, InvalidVertex);
+            std::vector<UInt32> next(mesh.VertexCount, InvalidVertex);
+            std::vector<UInt32> remap(mesh.VertexCount);
+            const Int64 reach = distance > 0.0f ? 1 : 0;
+
+            for (UInt32 vertex = 0; vertex < mesh.VertexCount; ++vertex) {
+                const std::array<Int64, 3> cell = getCell(vertex);
+                UInt32 match = InvalidVertex;
+                for (Int64 dz = -reach; dz <= reach && match == InvalidVertex; ++dz) {
+                    for (Int64 dy = -reach; dy <= reach && match == InvalidVertex; ++dy) {
+                        for (Int64 dx = -reach; dx <= reach && match == InvalidVertex; ++dx) {
+                            const UInt64 bucket = HashCell({cell[0] + dx, cell[1] + dy, cell[2] + dz}) & (bucketCount - 1);
+                            for (UInt32 kept = buckets[bucket]; kept != InvalidVertex; kept = next[kept]) {
+                                if (matches(kept, vertex)) {
+                                    match = kept;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                if (match != InvalidVertex) {
+                    remap[vertex] = match;
+                } else {
+                    const UInt64 bucket = HashCell(cell) & (bucketCount - 1);
+                    remap[vertex] = vertex;
+                    next[vertex] = buckets[bucket];
+                    buckets[bucket] = vertex;
+                }
+            }
+
+            ForEachLodRange(mesh, [&remap](const std::span<UInt32> indices) {
+                for (UInt32& index : indices) {
+                    index = remap[index];
+                }
+            });
+        }
+
+        UInt64 SpreadMortonBits(UInt64 value) {
+            value &= 0x1FFFFF;
+            value = (value | value << 32) & 0x1F00000000FFFF;
+            value = (value | value << 16) & 0x1F0000FF0000FF;
+            value = (value | value << 8) & 0x100F00F00F00F00F;
+            value = (value | value << 4) & 0x10C30C30C30C30C3;
+            value = (value | value << 2) & 0x1249249249249249;
+
+            return value;
+        }
+
+        // Sorts the triangles along a Morton curve of their centroids, so that the chunks
+        // optimized in parallel are compact patches rather than slices of an arbitrary order.
+        void SortTrianglesSpatially(const std::span<UInt32> indices, const MeshStream& positions) {
+            const UInt64 triangleCount = indices.size() / 3;
+            std::vector<Vector3> centroids(triangleCount);
+            Vector3 boundsMin{std::numeric_limits<Float64>::max(), std::numeric_limits<Float64>::max(), std::numeric_limits<Float64>::max()};
+            Vector3 boundsMax{std::numeric_limits<Float64>::lowest(), std::numeric_limits<Float64>::lowest(), std::numeric_limits<Float64>::lowest()};
+            for (UInt64 triangle = 0; triangle < triangleCount; ++triangle) {
+                Vector3& centroid = centroids[triangle];
+                for (UInt32 corner = 0; corner < 3; ++corner) {
+                    const Vector3 position = LoadPosition(positions.Data, positions.Stride, indices[triangle * 3 + corner]);
+                    centroid.X += position.X / 3.0;
+                    centroid.Y += position.Y / 3.0;
+                    centroid.Z += position.Z / 3.0;
+                }
+                boundsMin = {std::min(boundsMin.X, centroid.X), std::min(boundsMin.Y, centroid.Y), std::min(boundsMin.Z, centroid.Z)};
+                boundsMax = {std::max(boundsMax.X, centroid.X), std::max(boundsMax.Y, centroid.Y), std::max(boundsMax.Z, centroid.Z)};
+            }
+
+            const Float64 extent = std::max({boundsMax.X - boundsMin.X, boundsMax.Y - boundsMin.Y, boundsMax.Z - boundsMin.Z});
+            const Float64 scale = extent > 0.0 ? 2097151.0 / extent : 0.0;
+            const auto quantize = [scale](const Float64 value, const Float64 minValue) {
+                const Float64 cell = (value - minValue) * scale;
+                return cell >= 0.0 && cell <= 2097151.0 ? static_cast<UInt64>(cell) : 0;
+            };
+
+            std::vector<std::pair<UInt64, UInt32>> keys(triangleCount);
+            for (UInt64 triangle = 0; triangle < triangleCount; ++triangle) {
+                const Vector3& centroid = centroids[triangle];
+                keys[triangle] = {SpreadMortonBits(quantize(centroid.X, boundsMin.X)) |
+                                  SpreadMortonBits(quantize(centroid.Y, boundsMin.Y)) << 1 |
+                                  SpreadMortonBits(quantize(centroid.Z, boundsMin.Z)) << 2,
+                                  static_cast<UInt32>(triangle)};
+            }
+            std::ranges::sort(keys);
+
+            std::vector<UInt32> output(indices.size());
+            for (UInt64 i = 0; i < triangleCount; ++i) {
+                std::copy_n(indices.begin() + UInt64(keys[i].second) * 3, 3, output.begin() + i * 3);
+            }
+            std::ranges::copy(output, indices.begin());
+        }
+
+        void AnalyzeMesh(MeshData& mesh, const UInt32 cacheSize, VertexCacheStatistics& cacheStatistics,
+                         VertexFetchStatistics& fetchStatistics) {
+            const MeshStream& positions = GetWeldablePositions(mesh);
+            FetchTotals fetchTotals;
+            ForEachLodRange(mesh, [&](const std::span<UInt32> indices) {
+                const VertexCacheStatistics lod = AnalyzeVertexCache(indices, mesh.VertexCount, cacheSize);
+                cacheStatistics.TriangleCount += lod.TriangleCount;
+                cacheStatistics.VertexCount += lod.VertexCount;
+                cacheStatistics.TransformCount += lod.TransformCount;
+
+                const FetchTotals lodFetch = SimulateVertexFetch(indices, mesh.VertexCount, positions.Stride);
+                fetchTotals.BytesFetched += lodFetch.BytesFetched;
+                fetchTotals.BytesReferenced += lodFetch.BytesReferenced;
+            });
+
+            FinishStatistics(cacheStatistics);
+            fetchStatistics = MakeFetchStatistics(fetchTotals);
+        }
+    }
+
+    VertexCacheStatistics AnalyzeVertexCache(const std::span<const UInt32> indices, const UInt32 vertexCount, const UInt32 cacheSize) {
+        CheckTriangleList(indices, vertexCount);
+
+        VertexCacheStatistics statistics;
+        statistics.TriangleCount = indices.size() / 3;
+
+        std::vector<bool> referenced(vertexCount, false);
+        FifoCache cache(vertexCount, std::max(cacheSize, 1u));
+        for (const UInt32 index : indices) {
+            if (!referenced[index]) {
+                referenced[index] = true;
+                ++statistics.VertexCount;
+            }
+            if (cache.Access(index)) {
+                ++statistics.TransformCount;
+            }
+        }
+
+        FinishStatistics(statistics);
+
+        return statistics;
+    }
+
+    VertexFetchStatistics AnalyzeVertexFetch(const std::span<const UInt32> indices, const UInt32 vertexCount, const UInt32 vertexStride) {
+        CheckTriangleList(indices, vertexCount);
+        if (vertexStride == 0) {
+            throw std::invalid_argument("The vertex stride is zero.");
+        }
+
+        return MakeFetchStatistics(SimulateVertexFetch(indices, vertexCount, vertexStride));
+    }
+
+    void OptimizeVertexCache(const std::span<UInt32> indices, const UInt32 vertexCount, const MeshOptimizeOptions& options) {
+        CheckTriangleList(indices, vertexCount);
+
+        const UInt64 triangleCount = indices.size() / 3;
+        const UInt32 rangeCount = GetParallelRangeCount(triangleCount, options.ThreadCount, options.MinTrianglesPerThread);
+        if (rangeCount <= 1) {
+            OptimizeVertexCacheRange(indices, vertexCount, options);
+            return;
+        }
+
+        ParallelFor(triangleCount, rangeCount, [&](const UInt64 begin, const UInt64 end) {
+            const std::span<UInt32> range = indices.subspan(begin * 3, (end - begin) * 3);
+
+            // Renumbers the vertices of the range, so that its per-vertex state is sized for the
+            // vertices it uses rather than for the whole mesh.
+            std::vector<UInt32> vertices(range.begin(), range.end());
+            std::ranges::sort(vertices);
+            vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+            for (UInt32& index : range) {
+                index = static_cast<UInt32>(std::ranges::lower_bound(vertices, index) - vertices.begin());
+            }
+
+            OptimizeVertexCacheRange(range, static_cast<UInt32>(vertices.size()), options);
+
+            for (UInt32& index : range) {
+                index = vertices[index];
+            }
+        });
+    }
+
+    void OptimizeOverdraw(const std::span<UInt32> indices, const std::span<const std::byte> positions, const UInt32 positionStride,
+                          const MeshOptimizeOptions& options) {
+        if (positionStride < 3 * sizeof(Float32)) {
+            throw std::invalid_argument("The position stride is smaller than a position.");
+        }
+
+        const UInt32 vertexCount = static_cast<UInt32>(std::min<UInt64>(
+            positions.size() / positionStride, std::numeric_limits<UInt32>::max()));
+        CheckTriangleList(indices, vertexCount);
+
+        const UInt32 triangleCount = static_cast<UInt32>(indices.size() / 3);
+        if (triangleCount < 2) {
+            return;
+        }
+
+        const UInt32 cacheSize = std::max(options.CacheSize, 3u);
+        FifoCache cache(vertexCount, cacheSize);
+        const auto accessTriangle = [&](const UInt32 triangle) {
+            return UInt32(cache.Access(indices[triangle * 3])) + UInt32(cache.Access(indices[triangle * 3 + 1])) +
+                UInt32(cache.Access(indices[triangle * 3 + 2]));
+        };
+
+        // Hard boundaries are where the cache order restarted, at triangles missing on all their
+        // vertices; the orders on both sides are independent.
+        std::vector<UInt32> hardBoundaries;
+        for (UInt32 triangle = 0; triangle < triangleCount; ++triangle) {
+            if (accessTriangle(triangle) == 3 || triangle == 0) {
+                hardBoundaries.push_back(triangle);
+            }
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // Soft boundaries split each hard cluster as soon as the ACMR of the current piece falls
+        // within the threshold of the ACMR of the whole cluster; the last piece, usually small
+        // and poorly cached, is merged back into the previous one.
+        std::vector<UInt32> clusters;
+        for (UInt64 hard = 0; hard + 1 < hardBoundaries.size(); ++hard) {
+            const UInt32 begin = hardBoundaries[hard];
+            const UInt32 end = hardBoundaries[hard + 1];
+
+            cache.Clear();
+            UInt32 clusterMisses = 0;
+            for (UInt32 triangle = begin; triangle < end; ++triangle) {
+                clusterMisses += accessTriangle(triangle);
+            }
+            const Float64 targetAcmr = options.OverdrawThreshold * static_cast<Float64>(clusterMisses) / (end - begin);
+
+            const UInt64 firstCluster = clusters.size();
+            clusters.push_back(begin);
+            cache.Clear();
+            UInt32 misses = 0;
+            UInt32 triangles = 0;
+            for (UInt32 triangle = begin; triangle < end; ++triangle) {
+                misses += accessTriangle(triangle);
+                ++triangles;
+                if (static_cast<Float64>(misses) <= targetAcmr * triangles && triangle + 1 < end) {
+                    clusters.push_back(triangle + 1);
+                    cache.Clear();
+                    misses = 0;
+                    triangles = 0;
+                }
+            }
+
+            if (triangles != 0 && clusters.size() - firstCluster > 1) {
+                clusters.pop_back();
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // Clusters facing away from the center of the mesh are on its outside and drawn first.
+        const UInt64 clusterCount = clusters.size() - 1;
+        std::vector<Vector3> centroids(clusterCount);
+        std::vector<Vector3> normals(clusterCount);
+        Vector3 meshCentroid;
+        Float64 meshArea = 0.0;
+        for (UInt64 cluster = 0; cluster < clusterCount; ++cluster) {
+            Float64 clusterArea = 0.0;
+            for (UInt32 triangle = clusters[cluster]; triangle < clusters[cluster + 1]; ++triangle) {
+                const Vector3 a = LoadPosition(positions, positionStride, indices[triangle * 3]);
+                const Vector3 b = LoadPosition(positions, positionStride, indices[triangle * 3 + 1]);
+                const Vector3 c = LoadPosition(positions, positionStride, indices[triangle * 3 + 2]);
+                const Vector3 ab{b.X - a.X, b.Y - a.Y, b.Z - a.Z};
+                const Vector3 ac{c.X - a.X, c.Y - a.Y, c.Z - a.Z};
+                const Vector3 normal{ab.Y * ac.Z - ab.Z * ac.Y, ab.Z * ac.X - ab.X * ac.Z, ab.X * ac.Y - ab.Y * ac.X};
+                const Float64 area = std::sqrt(normal.X * normal.X + normal.Y * normal.Y + normal.Z * normal.Z);
+
+                centroids[cluster].X += (a.X + b.X + c.X) * area;
+                centroids[cluster].Y += (a.Y + b.Y + c.Y) * area;
+                centroids[cluster].Z += (a.Z + b.Z + c.Z) * area;
+                normals[cluster].X += normal.X;
+                normals[cluster].Y += normal.Y;
+                normals[cluster].Z += normal.Z;
+                clusterArea += area;
+            }
+
+            meshCentroid.X += centroids[cluster].X;
+            meshCentroid.Y += centroids[cluster].Y;
+            meshCentroid.Z += centroids[cluster].Z;
+            meshArea += clusterArea;
+            if (clusterArea > 0.0) {
+                const Float64 scale = 1.0 / (clusterArea * 3.0);
+                centroids[cluster] = {centroids[cluster].X * scale, centroids[cluster].Y * scale, centroids[cluster].Z * scale};
+            }
+        }
+        if (meshArea > 0.0) {
+            const Float64 scale = 1.0 / (meshArea * 3.0);
+            meshCentroid = {meshCentroid.X * scale, meshCentroid.Y * scale, meshCentroid.Z * scale};
+        }
+
+        std::vector<Float64> sortKeys(clusterCount);
+        for (UInt64 cluster = 0; cluster < clusterCount; ++cluster) {
+            const Vector3& normal = normals[cluster];
+            const Float64 length = std::sqrt(normal.X * normal.X + normal.Y * normal.Y + normal.Z * normal.Z);
+            if (length > 0.0) {
+                sortKeys[cluster] = ((centroids[cluster].X - meshCentroid.X) * normal.X +
+                    (centroids[cluster].Y - meshCentroid.Y) * normal.Y + (centroids[cluster].Z - meshCentroid.Z) * normal.Z) / length;
+            }
+        }
+
+        std::vector<UInt32> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::ranges::stable_sort(order, [&sortKeys](const UInt32 a, const UInt32 b) { return sortKeys[a] > sortKeys[b]; });
+
+        std::vector<UInt32> output;
+        output.reserve(indices.size());
+        for (const UInt32 cluster : order) {
+            output.insert(output.end(), indices.begin() + UInt64(clusters[cluster]) * 3, indices.begin() + UInt64(clusters[cluster + 1]) * 3);
+        }
+        std::ranges::copy(output, indices.begin());
+    }
+
+    void OptimizeVertexFetch(MeshData& mesh) {
+        ValidateMeshData(mesh);
+
+        MakeIndicesAbsolute(mesh);
+        ReorderVerticesForFetch(mesh);
+        RebaseIndices(mesh);
+    }
+
+    UInt32 WeldVertices(MeshData& mesh, const Float32 distance) {
+        ValidateMeshData(mesh);
+        GetWeldablePositions(mesh);
+        if (!(distance >= 0.0f) || std::isinf(distance)) {
+            throw std::invalid_argument("The weld distance is not a finite positive number.");
+        }
+
+        const UInt32 vertexCount = mesh.VertexCount;
+        MakeIndicesAbsolute(mesh);
+        WeldIndices(mesh, distance);
+
+        // Drops the unused vertices, keeping the order of the others.
+        std::vector<UInt32> remap(mesh.VertexCount, InvalidVertex);
+        ForEachLodRange(mesh, [&remap](const std::span<UInt32> indices) {
+            for (const UInt32 index : indices) {
+                remap[index] = 0;
+            }
+        });
+        UInt32 keptCount = 0;
+        for (UInt32& vertex : remap) {
+            if (vertex != InvalidVertex) {
+                vertex = keptCount++;
+            }
+        }
+
+        RemapVertices(mesh, remap, keptCount);
+        RebaseIndices(mesh);
+
+        return vertexCount - mesh.VertexCount;
+    }
+
+    MeshOptimizeReport OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options) {
+        ValidateMeshData(mesh);
+        GetWeldablePositions(mesh);
+        if (!(options.WeldDistance >= 0.0f) || std::isinf(options.WeldDistance)) {
+            throw std::invalid_argument("The weld distance is not a finite positive number.");
+        }
+
+        MeshOptimizeReport report;
+        report.VertexCountBefore = mesh.VertexCount;
+
+        MakeIndicesAbsolute(mesh);
+        AnalyzeMesh(mesh, options.CacheSize, report.CacheBefore, report.FetchBefore);
+
+        if (options.WeldVertices) {
+            WeldIndices(mesh, options.WeldDistance);
+        }
+
+        ForEachLodRange(mesh, [&](const std::span<UInt32> indices) {
+            if (GetParallelRangeCount(indices.size() / 3, options.ThreadCount, options.MinTrianglesPerThread) > 1) {
+                SortTrianglesSpatially(indices, GetWeldablePositions(mesh));
+            }
+            OptimizeVertexCache(indices, mesh.VertexCount, options);
+            if (options.OptimizeOverdraw) {
+                const MeshStream& positions = GetWeldablePositions(mesh);
+                OptimizeOverdraw(indices, positions.Data, positions.Stride, options);
+            }
+        });
+
+        // Also drops the vertices left unused by the weld.
+        ReorderVerticesForFetch(mesh);
+
+        AnalyzeMesh(mesh, options.CacheSize, report.CacheAfter, report.FetchAfter);
+        report.VertexCountAfter = mesh.VertexCount;
+        RebaseIndices(mesh);
+
+        return report;
+    }
+}
@@ -0,0 +1,474 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MeshletBuilder.hpp"
+
+#include "Framework/ParallelFor.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 InvalidIndex = std::numeric_limits<UInt32>::max();
+
+        // Normals closer than this to the plane of the axis make the cone too wide to cull.
+        constexpr Float32 MinConeDot = 0.1f;
+
+        struct Vector3 {
+            Float32 X = 0.0f;
+            Float32 Y = 0.0f;
+            Float32 Z = 0.0f;
+        };
+
+        Vector3 operator+(const Vector3& a, const Vector3& b) { return {a.X + b.X, a.Y + b.Y, a.Z + b.Z}; }
+        Vector3 operator-(const Vector3& a, const Vector3& b) { return {a.X - b.X, a.Y - b.Y, a.Z - b.Z}; }
+        Vector3 operator*(const Vector3& a, const Float32 scale) { return {a.X * scale, a.Y * scale, a.Z * scale}; }
+        Float32 Dot(const Vector3& a, const Vector3& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+        Vector3 Cross(const Vector3& a, const Vector3& b) {
+            return {a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X};
+        }
+
+        Vector3 LoadPosition(const std::span<const std::byte> positions, const UInt32 stride, const UInt32 vertex) {
+            Vector3 position;
+            std::memcpy(&position, positions.data() + UInt64(vertex) * stride, sizeof(position));
+
+            return position;
+        }
+
+        void CheckBuildOptions(const MeshletBuildOptions& options) {
+            if (options.MaxVertices < 3 || options.MaxVertices > MaxMeshletVertices) {
+                throw std::invalid_argument("The meshlet vertex limit is out of [3, 256].");
+            }
+            if (options.MaxPrimitives < 1 || options.MaxPrimitives > MaxMeshletPrimitives) {
+                throw std::invalid_argument("The meshlet primitive limit is out of [1, 256].");
+            }
+        }
+
+        void CheckInput(const std::span<const UInt32> indices, const std::span<const std::byte> positions,
+                        const UInt32 positionStride, const UInt32 vertexCount) {
+            if (indices.size() % 3 != 0) {
+                throw std::invalid_argument("The index buffer is not a triangle list.");
+            }
+            if (indices.size() / 3 > std::numeric_limits<UInt32>::max()) {
+                throw std::invalid_argument("The index buffer has too many triangles.");
+            }
+            for (const UInt32 index : indices) {
+                if (index >= vertexCount) {
+                    throw std::invalid_argument("An index is out of the vertices.");
+                }
+            }
+            if (vertexCount != 0) {
+                if (positionStride < sizeof(Vector3)) {
+                    throw std::invalid_argument("The position stride is smaller than a position.");
+                }
+                if (positions.size() < UInt64(vertexCount - 1) * positionStride + sizeof(Vector3)) {
+                    throw std::invalid_argument("The positions are fewer than the vertices.");
+                }
+            }
+        }
+
+        // Ritter's bounding sphere: starts from the most distant pair of the extreme points
+        // along the axes, then grows to each point left out.
+        void ComputeBoundingSphere(const std::span<const Vector3> points, MeshletBounds& bounds) {
+            UInt32 minPoints[3] = {};
+            UInt32 maxPoints[3] = {};
+            for (UInt32 i = 1; i < points.size(); ++i) {
+                const Vector3& point = points[i];
+                const Float32 coordinates[3] = {point.X, point.Y, point.Z};
+                for (UInt32 axis = 0; axis < 3; ++axis) {
+                    const Vector3& minPoint = points[minPoints[axis]];
+                    const Vector3& maxPoint = points[maxPoints[axis]];
+                    if (coordinates[axis] < (&minPoint.X)[axis]) {
+                        minPoints[axis] = i;
+                    }
+                    if (coordinates[axis] > (&maxPoint.X)[axis]) {
+                        maxPoints[axis] = i;
+                    }
+                }
+            }
+
+            UInt32 widestAxis = 0;
+            Float32 widestSpan = -1.0f;
+            for (UInt32 axis = 0; axis < 3; ++axis) {
+                const Vector3 span = points[maxPoints[axis]] - points[minPoints[axis]];
+                if (Dot(span, span) > widestSpan) {
+                    widestSpan = Dot(span, span);
+                    widestAxis = axis;
+                }
+            }
+
+            Vector3 center = (points[minPoints[widestAxis]] + points[maxPoints[widestAxis]]) * 0.5f;
+            Float32 radius = std::sqrt(widestSpan) * 0.5f;
+            for (const Vector3& point : points) {
+                const Vector3 offset = point - center;
+                const Float32 distance = std::sqrt(Dot(offset, offset));
+                if (distance > radius) {
+                    const Float32 grownRadius = (radius + distance) * 0.5f;
+                    center = center + offset * ((grownRadius - radius) / distance);
+                    radius = grownRadius;
+                }
+            }
+
+            bounds.Center[0] = center.X;
+            bounds.Center[1] = center.Y;
+            bounds.Center[2] = center.Z;
+            bounds.Radius = radius;
+        }
+
+        // The axis is the average of the normals, and the apex the point of the axis behind
+        // the planes of all the triangles, so that a camera in front of any triangle is out
+        // of the cone.
+        void ComputeNormalCone(const std::span<const Vector3> normals, const std::span<const Vector3> corners,
+                               MeshletBounds& bounds) {
+            const Vector3 center{bounds.Center[0], bounds.Center[1], bounds.Center[2]};
+            bounds.ConeApex[0] = center.X;
+            bounds.ConeApex[1] = center.Y;
+            bounds.ConeApex[2] = center.Z;
+
+            Vector3 axis;
+            for (const Vector3& normal : normals) {
+                axis = axis + normal;
+            }
+            const Float32 length = std::sqrt(Dot(axis, axis));
+            if (!(length > 0.0f)) {
+                return;
+            }
+            axis = axis * (1.0f / length);
+
+            Float32 minDot = 1.0f;
+            for (const Vector3& normal : normals) {
+                minDot = std::min(minDot, Dot(normal, axis));
+            }
+
+            bounds.ConeAxis[0] = axis.X;
+            bounds.ConeAxis[1] = axis.Y;
+            bounds.ConeAxis[2] = axis.Z;
+            if (minDot < MinConeDot) {
+                return;
+            }
+
+            Float32 maxDistance = 0.0f;
+            for (UInt64 i = 0; i < normals.size(); ++i) {
+                // Distance along the axis from the center back to the plane of the triangle.
+                const Float32 distance = Dot(center - corners[i], normals[i]) / Dot(axis, normals[i]);
+                maxDistance = std::max(maxDistance, distance);
+            }
+
+            const Vector3 apex = center - axis * maxDistance;
+            bounds.ConeApex[0] = apex.X;
+            bounds.ConeApex[1] = apex.Y;
+            bounds.ConeApex[2] = apex.Z;
+            bounds.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+
+        // Builds the meshlets of one triangle list, appending them to the output.
+        class MeshletBuilder {
+            public:
+                MeshletBuilder(const std::span<const UInt32> indices, const std::span<const std::byte> positions,
+                               const UInt32 positionStride, const UInt32 vertexCount, const MeshletBuildOptions& options,
+                               MeshletData& output) :
+                    m_Indices(indices),
+                    m_Options(options),
+                    m_Output(output),
+                    m_LocalVertices(vertexCount, InvalidIndex),
+                    m_Emitted(indices.size() / 3, false) {
+                    for (UInt32 vertex = 0; vertex < vertexCount; ++vertex) {
+                        m_Positions.push_back(LoadPosition(positions, positionStride, vertex));
+                    }
+
+                    // Triangles around each vertex. The first LiveCounts of each row are the
+                    // ones not in a meshlet yet.
+                    m_Offsets.assign(UInt64(vertexCount) + 1, 0);
+                    for (const UInt32 index : indices) {
+                        ++m_Offsets[index + 1];
+                    }
+                    std::partial_sum(m_Offsets.begin(), m_Offsets.end(), m_Offsets.begin());
+                    m_LiveCounts.assign(vertexCount, 0);
+                    m_Triangles.resize(indices.size());
+                    for (UInt64 i = 0; i < indices.size(); ++i) {
+                        const UInt32 vertex = indices[i];
+                        m_Triangles[m_Offsets[vertex] + m_LiveCounts[vertex]++] = static_cast<UInt32>(i / 3);
+                    }
+
+                    m_Centroids.resize(indices.size() / 3);
+                    for (UInt64 triangle = 0; triangle < m_Centroids.size(); ++triangle) {
+                        m_Centroids[triangle] = (m_Positions[indices[triangle * 3]] + m_Positions[indices[triangle * 3 + 1]] +
+                                                 m_Positions[indices[triangle * 3 + 2]]) * (1.0f / 3.0f);
+                    }
+                }
+
+                void Build() {
+                    const UInt32 triangleCount = static_cast<UInt32>(m_Emitted.size());
+                    for (UInt32 emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+                        UInt32 triangle = m_Primitives.empty() ? InvalidIndex : FindNeighbor();
+                        if (triangle == InvalidIndex) {
+                            FinishMeshlet();
+                            triangle = FindSeed();
+                            m_Vertices.clear();
+                            m_CentroidSum = {};
+                        }
+
+                        AddTriangle(triangle);
+                        if (m_Primitives.size() == m_Options.MaxPrimitives) {
+                            FinishMeshlet();
+                        }
+                    }
+                    FinishMeshlet();
+                }
+
+            private:
+                // The live triangle around the meshlet adding the fewest vertices, then the
+                // closest to its centroid, among those that fit.
+                UInt32 FindNeighbor() const {
+                    const Vector3 center = m_CentroidSum * (1.0f / static_cast<Float32>(m_Primitives.size()));
+                    UInt32 bestTriangle = InvalidIndex;
+                    UInt32 bestPriority = 6;
+                    Float32 bestDistance = std::numeric_limits<Float32>::max();
+                    for (const UInt32 vertex : m_Vertices) {
+                        const UInt32 offset = m_Offsets[vertex];
+                        for (UInt32 i = 0; i < m_LiveCounts[vertex]; ++i) {
+                            const UInt32 triangle = m_Triangles[offset + i];
+                            const UInt32 extra = CountNewVertices(triangle);
+                            if (m_Vertices.size() + extra > m_Options.MaxVertices) {
+                                continue;
+                            }
+                            // Triangles adding no vertex first, then those finishing a vertex,
+                            // which would otherwise be left for a scattered meshlet, then those
+                            // leaving another triangle to finish.
+                            const UInt32 priority = extra == 0 ? 0 : GetTopologyPriority(triangle, extra);
+                            if (priority > bestPriority) {
+                                continue;
+                            }
+
+                            const Vector3 offsetToCenter = m_Centroids[triangle] - center;
+                            const Float32 distance = Dot(offsetToCenter, offsetToCenter);
+                            if (priority < bestPriority || distance < bestDistance) {
+                                bestTriangle = triangle;
+                                bestPriority = priority;
+                                bestDistance = distance;
+                            }
+                        }
+                    }
+
+                    return bestTriangle;
+                }
+
+                // The live triangle around the last meshlet closest to its center, or the
+                // first one left in the input order when it is surrounded.
+                UInt32 FindSeed() {
+                    UInt32 bestTriangle = InvalidIndex;
+                    Float32 bestDistance = std::numeric_limits<Float32>::max();
+                    for (const UInt32 vertex : m_Vertices) {
+                        const UInt32 offset = m_Offsets[vertex];
+                        for (UInt32 i = 0; i < m_LiveCounts[vertex]; ++i) {
+                            const UInt32 triangle = m_Triangles[offset + i];
+                            const Vector3 offsetToCenter = m_Centroids[triangle] - m_LastCenter;
+                            const Float32 distance = Dot(offsetToCenter, offsetToCenter);
+                            if (distance < bestDistance) {
+                                bestTriangle = triangle;
+                                bestDistance = distance;
+                            }
+                        }
+                    }
+                    if (bestTriangle != InvalidIndex) {
+                        return bestTriangle;
+                    }
+
+                    while (m_Emitted[m_SeedCursor]) {
+                        ++m_SeedCursor;
+                    }
+                    return m_SeedCursor;
+                }
+
+                UInt32 CountNewVertices(const UInt32 triangle) const {
+                    const UInt32 a = m_Indices[UInt64(triangle) * 3];
+                    const UInt32 b = m_Indices[UInt64(triangle) * 3 + 1];
+                    const UInt32 c = m_Indices[UInt64(triangle) * 3 + 2];
+                    return UInt32(m_LocalVertices[a] == InvalidIndex) + UInt32(b != a && m_LocalVertices[b] == InvalidIndex) +
+                           UInt32(c != a && c != b && m_LocalVertices[c] == InvalidIndex);
+                }
+
+                UInt32 GetTopologyPriority(const UInt32 triangle, const UInt32 extra) const {
+                    const UInt32* pIndices = &m_Indices[UInt64(triangle) * 3];
+                    const UInt32 liveCounts[3] = {m_LiveCounts[pIndices[0]], m_LiveCounts[pIndices[1]], m_LiveCounts[pIndices[2]]};
+                    if (liveCounts[0] == 1 || liveCounts[1] == 1 || liveCounts[2] == 1) {
+                        return 1;
+                    }
+                    if (UInt32(liveCounts[0] == 2) + UInt32(liveCounts[1] == 2) + UInt32(liveCounts[2] == 2) >= 2) {
+                        return extra + 1;
+                    }
+                    return extra + 2;
+                }
+
+                void AddTriangle(const UInt32 triangle) {
+                    for (UInt32 corner = 0; corner < 3; ++corner) {
+                        const UInt32 vertex = m_Indices[UInt64(triangle) * 3 + corner];
+                        if (m_LocalVertices[vertex] == InvalidIndex) {
+                            m_LocalVertices[vertex] = static_cast<UInt32>(m_Vertices.size());
+                            m_Vertices.push_back(vertex);
+                        }
+
+                        // Removes the triangle from the live ones of the vertex, once per
+                        // corner since it appears once per corner.
+                        const UInt32 offset = m_Offsets[vertex];
+                        const UInt32 liveCount = --m_LiveCounts[vertex];
+                        UInt32 i = 0;
+                        while (m_Triangles[offset + i] != triangle) {
+                            ++i;
+                        }
+                        std::swap(m_Triangles[offset + i], m_Triangles[offset + liveCount]);
+                    }
+
+                    m_Emitted[triangle] = true;
+                    m_Primitives.push_back(triangle);
+                    m_CentroidSum = m_CentroidSum + m_Centroids[triangle];
+                }
+
+                // Writes the meshlet, keeping its vertices and center for FindSeed.
+                void FinishMeshlet() {
+                    if (m_Primitives.empty()) {
+                        return;
+                    }
+
+                    Meshlet& meshlet = m_Output.Meshlets.emplace_back();
+                    meshlet.VertexOffset = static_cast<UInt32>(m_Output.VertexIndices.size());
+                    meshlet.VertexCount = static_cast<UInt32>(m_Vertices.size());
+                    meshlet.PrimitiveOffset = static_cast<UInt32>(m_Output.PrimitiveIndices.size());
+                    meshlet.PrimitiveCount = static_cast<UInt32>(m_Primitives.size());
+
+                    m_Points.clear();
+                    for (const UInt32 vertex : m_Vertices) {
+                        m_Output.VertexIndices.push_back(vertex);
+                        m_Points.push_back(m_Positions[vertex]);
+                    }
+
+                    m_Normals.clear();
+                    m_Corners.clear();
+                    for (const UInt32 triangle : m_Primitives) {
+                        const UInt32* pIndices = &m_Indices[UInt64(triangle) * 3];
+                        m_Output.PrimitiveIndices.push_back(PackMeshletTriangle(m_LocalVertices[pIndices[0]], m_LocalVertices[pIndices[1]],
+                                                                                m_LocalVertices[pIndices[2]]));
+
+                        // Clockwise front faces in a left-handed space, like D3D12 by default.
+                        const Vector3& a = m_Positions[pIndices[0]];
+                        const Vector3 normal = Cross(m_Positions[pIndices[1]] - a, m_Positions[pIndices[2]] - a);
+                        const Float32 length = std::sqrt(Dot(normal, normal));
+                        if (length > 0.0f) {
+                            m_Normals.push_back(normal * (1.0f / length));
+                            m_Corners.push_back(a);
+                        }
+                    }
+
+                    MeshletBounds& bounds = m_Output.Bounds.emplace_back();
+                    ComputeBoundingSphere(m_Points, bounds);
+                    ComputeNormalCone(m_Normals, m_Corners, bounds);
+
+                    m_LastCenter = m_CentroidSum * (1.0f / static_cast<Float32>(m_Primitives.size()));
+                    m_Primitives.clear();
+                    for (const UInt32 vertex : m_Vertices) {
+                        m_LocalVertices[vertex] = InvalidIndex;
+                    }
+                }
+
+                std::span<const UInt32> m_Indices;
+                const MeshletBuildOptions& m_Options;
+                MeshletData& m_Output;
+                std::vector<Vector3> m_Positions;
+                std::vector<Vector3> m_Centroids;
+                std::vector<UInt32> m_Offsets;
+                std::vector<UInt32> m_LiveCounts;
+                std::vector<UInt32> m_Triangles;
+                // Index of each vertex in the current meshlet, InvalidIndex out of it.
+                std::vector<UInt32> m_LocalVertices;
+                std::vector<bool> m_Emitted;
+                std::vector<UInt32> m_Vertices;
+                std::vector<UInt32> m_Primitives;
+                Vector3 m_CentroidSum;
+                Vector3 m_LastCenter;
+                UInt32 m_SeedCursor = 0;
+                std::vector<Vector3> m_Points;
+                std::vector<Vector3> m_Normals;
+                std::vector<Vector3> m_Corners;
+        };
+    }
+
+    MeshletData BuildMeshlets(const std::span<const UInt32> indices, const std::span<const std::byte> positions,
+                              const UInt32 positionStride, const UInt32 vertexCount, const MeshletBuildOptions& options) {
+        CheckBuildOptions(options);
+        CheckInput(indices, positions, positionStride, vertexCount);
+
+        MeshletData output;
+        MeshletBuilder(indices, positions, positionStride, vertexCount, options, output).Build();
+
+        return output;
+    }
+
+    MeshletData BuildMeshlets(const MeshData& mesh, const MeshletBuildOptions& options) {
+        CheckBuildOptions(options);
+        ValidateMeshData(mesh);
+        const MeshStream* pPositions = mesh.FindStream(MeshSemantic::Position);
+        if (pPositions == nullptr || pPositions->Format != DxgiFormat::R32G32B32Float) {
+            throw std::invalid_argument("The meshlet builder needs R32G32B32_FLOAT positions.");
+        }
+
+        MeshletData output;
+        std::vector<UInt32> indices;
+        for (UInt32 submeshIndex = 0; submeshIndex < mesh.Submeshes.size(); ++submeshIndex) {
+            const MeshSubmesh& submesh = mesh.Submeshes[submeshIndex];
+            for (UInt32 lodIndex = 0; lodIndex < submesh.Lods.size(); ++lodIndex) {
+                const MeshLodDesc& lod = submesh.Lods[lodIndex];
+                indices.assign(mesh.Indices.begin() + lod.FirstIndex, mesh.Indices.begin() + lod.FirstIndex + lod.IndexCount);
+                for (UInt32& index : indices) {
+                    index += lod.BaseVertex;
+                }
+
+                MeshletRange& range = output.Ranges.emplace_back();
+                range.Submesh = submeshIndex;
+                range.Lod = lodIndex;
+                range.MeshletOffset = static_cast<UInt32>(output.Meshlets.size());
+                MeshletBuilder(indices, pPositions->Data, pPositions->Stride, mesh.VertexCount, options, output).Build();
+                range.MeshletCount = static_cast<UInt32>(output.Meshlets.size()) - range.MeshletOffset;
+            }
+        }
+
+        return output;
+    }
+
+    std::vector<MeshletData> BuildMeshlets(const std::span<const MeshData> meshes, const MeshletBuildOptions& options) {
+        CheckBuildOptions(options);
+
+        std::vector<MeshletData> outputs(meshes.size());
+        const UInt32 rangeCount = GetParallelRangeCount(meshes.size(), options.ThreadCount, 1);
+        ParallelFor(meshes.size(), rangeCount, [&](const UInt64 begin, const UInt64 end) {
+            for (UInt64 i = begin; i < end; ++i) {
+                outputs[i] = BuildMeshlets(meshes[i], options);
+            }
+        });
+
+        return outputs;
+    }
+
+    MeshletStatistics AnalyzeMeshlets(const MeshletData& meshlets, const MeshletBuildOptions& options) {
+        MeshletStatistics statistics;
+        statistics.MeshletCount = meshlets.Meshlets.size();
+        statistics.TriangleCount = meshlets.PrimitiveIndices.size();
+        if (statistics.MeshletCount == 0) {
+            return statistics;
+        }
+
+        const Float64 meshletCount = static_cast<Float64>(statistics.MeshletCount);
+        statistics.VertexFill = static_cast<Float64>(meshlets.VertexIndices.size()) / (meshletCount * options.MaxVertices);
+        statistics.PrimitiveFill = static_cast<Float64>(statistics.TriangleCount) / (meshletCount * options.MaxPrimitives);
+        statistics.VerticesPerTriangle = static_cast<Float64>(meshlets.VertexIndices.size()) /
+                                         static_cast<Float64>(std::max<UInt64>(statistics.TriangleCount, 1));
+
+        return statistics;
+    }
+}
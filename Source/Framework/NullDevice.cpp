@@ -0,0 +1,281 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/NullDevice.hpp"
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    const char* GetNullApiCallName(const NullApiCall call) {
+        switch (call) {
+            case NullApiCall::CreateCommandQueue:
+                return "CreateCommandQueue";
+            case NullApiCall::CreateCommandAllocator:
+                return "CreateCommandAllocator";
+            case NullApiCall::CreateCommandList:
+                return "CreateCommandList";
+            case NullApiCall::CreateSwapChain:
+                return "CreateSwapChain";
+            case NullApiCall::ResetCommandAllocator:
+                return "ResetCommandAllocator";
+            case NullApiCall::ResetCommandList:
+                return "ResetCommandList";
+            case NullApiCall::CloseCommandList:
+                return "CloseCommandList";
+            case NullApiCall::ResourceBarrier:
+                return "ResourceBarrier";
+            case NullApiCall::ClearRenderTargetView:
+                return "ClearRenderTargetView";
+            case NullApiCall::SetPipelineState:
+                return "SetPipelineState";
+            case NullApiCall::SetGraphicsRootSignature:
+                return "SetGraphicsRootSignature";
+            case NullApiCall::SetViewports:
+                return "SetViewports";
+            case NullApiCall::SetScissorRects:
+                return "SetScissorRects";
+            case NullApiCall::SetVertexBuffers:
+                return "SetVertexBuffers";
+            case NullApiCall::DrawInstanced:
+                return "DrawInstanced";
+            case NullApiCall::CopyBufferRegion:
+                return "CopyBufferRegion";
+            case NullApiCall::ExecuteCommandLists:
+                return "ExecuteCommandLists";
+            case NullApiCall::Signal:
+                return "Signal";
+            case NullApiCall::WaitForFence:
+                return "WaitForFence";
+            case NullApiCall::Present:
+                return "Present";
+            case NullApiCall::Count:
+                break;
+        }
+
+        return "Unknown";
+    }
+
+    NullGpuTimeline::NullGpuTimeline(NullDevice& device, const SimulatedGpuTimeline::Clock::duration submissionDuration) :
+        m_Device(device),
+        m_Timeline(submissionDuration) {
+    }
+
+    UInt64 NullGpuTimeline::Signal() {
+        m_Device.RecordCall(NullApiCall::Signal);
+
+        const UInt64 value = m_Timeline.Signal();
+        m_LastSignaledValue.store(value, std::memory_order_release);
+
+        return value;
+    }
+
+    UInt64 NullGpuTimeline::GetCompletedValue() {
+        return m_Timeline.GetCompletedValue();
+    }
+
+    void NullGpuTimeline::WaitForValue(const UInt64 value) {
+        if (m_Timeline.GetCompletedValue() >= value) {
+            return;
+        }
+
+        m_Device.RecordCall(NullApiCall::WaitForFence);
+        m_Timeline.WaitForValue(value);
+    }
+
+    NullCommandAllocator::NullCommandAllocator(NullDevice& device) :
+        m_Device(device),
+        m_IsRecording(false),
+        m_pTimeline(nullptr),
+        m_FenceValue(0),
+        m_ResetCount(0) {
+    }
+
+    void NullCommandAllocator::Reset() {
+        m_Device.RecordCall(NullApiCall::ResetCommandAllocator);
+
+        if (m_IsRecording) {
+            throw std::logic_error("A command list is still recording into the allocator.");
+        }
+        if (m_pTimeline && !m_pTimeline->IsComplete(m_FenceValue)) {
+            throw std::logic_error("The allocator is still in use by the GPU.");
+        }
+
+        ++m_ResetCount;
+    }
+
+    NullCommandList::NullCommandList(NullDevice& device, NullCommandAllocator& allocator) :
+        m_Device(device),
+        m_pAllocator(nullptr),
+        m_AllocatorResetCount(0),
+        m_IsClosed(true) {
+        Reset(allocator);
+    }
+
+    void NullCommandList::Reset(NullCommandAllocator& allocator) {
+        m_Device.RecordCall(NullApiCall::ResetCommandList);
+
+        if (!m_IsClosed) {
+            throw std::logic_error("The command list must be closed before it is reset.");
+        }
+        if (allocator.m_IsRecording) {
+            throw std::logic_error("Another command list is recording into the allocator.");
+        }
+
+        allocator.m_IsRecording = true;
+        m_pAllocator = &allocator;
+        m_AllocatorResetCount = allocator.m_ResetCount;
+        m_Commands.clear();
+        m_IsClosed = false;
+    }
+
+    void NullCommandList::Close() {
+        m_Device.RecordCall(NullApiCall::CloseCommandList);
+
+        if (m_IsClosed) {
+            throw std::logic_error("The command list is already closed.");
+        }
+
+        m_pAllocator->m_IsRecording = false;
+        m_IsClosed = true;
+    }
+
+    void NullCommandList::ResourceBarrier(const UInt32 /*barrierCount*/) {
+        Record(NullApiCall::ResourceBarrier);
+    }
+
+    void NullCommandList::ClearRenderTargetView() {
+        Record(NullApiCall::ClearRenderTargetView);
+    }
+
+    void NullCommandList::SetPipelineState() {
+        Record(NullApiCall::SetPipelineState);
+    }
+
+    void NullCommandList::SetGraphicsRootSignature() {
+        Record(NullApiCall::SetGraphicsRootSignature);
+    }
+
+    void NullCommandList::SetViewports(const UInt32 /*viewportCount*/) {
+        Record(NullApiCall::SetViewports);
+    }
+
+    void NullCommandList::SetScissorRects(const UInt32 /*rectCount*/) {
+        Record(NullApiCall::SetScissorRects);
+    }
+
+    void NullCommandList::SetVertexBuffers(const UInt32 /*viewCount*/) {
+        Record(NullApiCall::SetVertexBuffers);
+    }
+
+    void NullCommandList::DrawInstanced(const UInt32 /*vertexCount*/, const UInt32 /*instanceCount*/) {
+        Record(NullApiCall::DrawInstanced);
+    }
+
+    void NullCommandList::CopyBufferRegion(const UInt64 /*size*/) {
+        Record(NullApiCall::CopyBufferRegion);
+    }
+
+    void NullCommandList::Record(const NullApiCall call) {
+        if (m_IsClosed) {
+            throw std::logic_error("Recording into a closed command list.");
+        }
+
+        m_Device.RecordCall(call);
+        m_Commands.push_back(call);
+    }
+
+    NullCommandQueue::NullCommandQueue(NullDevice& device, const SimulatedGpuTimeline::Clock::duration submissionDuration) :
+        m_Device(device),
+        m_Timeline(device, submissionDuration),
+        m_ExecutedCommandCount(0) {
+    }
+
+    void NullCommandQueue::ExecuteCommandLists(const std::span<NullCommandList* const> commandLists) {
+        m_Device.RecordCall(NullApiCall::ExecuteCommandLists);
+
+        for (const NullCommandList* pCommandList : commandLists) {
+            if (!pCommandList->IsClosed()) {
+                throw std::logic_error("Executing a command list that is still open.");
+            }
+            if (pCommandList->m_AllocatorResetCount != pCommandList->m_pAllocator->m_ResetCount) {
+                throw std::logic_error("Executing a command list whose allocator was reset since it was recorded.");
+            }
+        }
+
+        // The work is done once the next signal on the queue completes.
+        const UInt64 fenceValue = m_Timeline.GetLastSignaledValue() + 1;
+        for (const NullCommandList* pCommandList : commandLists) {
+            pCommandList->m_pAllocator->m_pTimeline = &m_Timeline;
+            pCommandList->m_pAllocator->m_FenceValue = fenceValue;
+            m_ExecutedCommandCount += pCommandList->m_Commands.size();
+        }
+    }
+
+    NullSwapChain::NullSwapChain(NullDevice& device, const UInt32 bufferCount) :
+        m_Device(device),
+        m_BufferCount(bufferCount),
+        m_BackBufferIndex(0) {
+        if (bufferCount < 2) {
+            throw std::invalid_argument("A swap chain needs at least two buffers.");
+        }
+    }
+
+    void NullSwapChain::Present(const UInt32 /*syncInterval*/) {
+        m_Device.RecordCall(NullApiCall::Present);
+
+        m_BackBufferIndex = (m_BackBufferIndex + 1) % m_BufferCount;
+    }
+
+    NullDevice::NullDevice() :
+        m_CallCounts() {
+    }
+
+    std::unique_ptr<NullCommandQueue> NullDevice::CreateCommandQueue(const SimulatedGpuTimeline::Clock::duration submissionDuration) {
+        RecordCall(NullApiCall::CreateCommandQueue);
+        return std::make_unique<NullCommandQueue>(*this, submissionDuration);
+    }
+
+    std::unique_ptr<NullCommandAllocator> NullDevice::CreateCommandAllocator() {
+        RecordCall(NullApiCall::CreateCommandAllocator);
+        return std::make_unique<NullCommandAllocator>(*this);
+    }
+
+    std::unique_ptr<NullCommandList> NullDevice::CreateCommandList(NullCommandAllocator& allocator) {
+        RecordCall(NullApiCall::CreateCommandList);
+        return std::make_unique<NullCommandList>(*this, allocator);
+    }
+
+    std::unique_ptr<NullSwapChain> NullDevice::CreateSwapChain(const UInt32 bufferCount) {
+        RecordCall(NullApiCall::CreateSwapChain);
+        return std::make_unique<NullSwapChain>(*this, bufferCount);
+    }
+
+    UInt64 NullDevice::GetTotalCallCount() const {
+        UInt64 total = 0;
+        for (const std::atomic<UInt64>& count : m_CallCounts) {
+            total += count.load(std::memory_order_relaxed);
+        }
+
+        return total;
+    }
+
+    void NullDevice::ResetCallCounts() {
+        for (std::atomic<UInt64>& count : m_CallCounts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::string NullDevice::FormatCallCounts() const {
+        std::string text;
+        for (size_t i = 0; i < m_CallCounts.size(); ++i) {
+            const UInt64 count = m_CallCounts[i].load(std::memory_order_relaxed);
+            if (count != 0) {
+                text += GetNullApiCallName(static_cast<NullApiCall>(i));
+                text += ": " + std::to_string(count) + '\n';
+            }
+        }
+
+        return text;
+    }
+}
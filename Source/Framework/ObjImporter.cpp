@@ -0,0 +1,345 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ObjImporter.hpp"
+
+#include "Framework/Hash.hpp"
+#include "Framework/MappedFile.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace D3D12Tests {
+    namespace {
+        constexpr UInt32 NoIndex = std::numeric_limits<UInt32>::max();
+
+        // Indices of the position, texture coordinate and normal of a face corner.
+        struct ObjCorner {
+            UInt32 Position;
+            UInt32 TexCoord;
+            UInt32 Normal;
+
+            bool operator==(const ObjCorner&) const = default;
+        };
+
+        struct ObjCornerHash {
+            std::size_t operator()(const ObjCorner& corner) const {
+                return static_cast<std::size_t>(HashCombine(HashCombine(corner.Position, corner.TexCoord), corner.Normal));
+            }
+        };
+
+        class ObjParser {
+        public:
+            ObjParser(const std::string_view source, const ObjImportOptions& options) :
+                m_Source(source),
+                m_Options(options) {
+            }
+
+            MeshData Parse() {
+                while (NextLine()) {
+                    const std::string_view keyword = NextToken();
+                    if (keyword == "v") {
+                        ParsePosition();
+                    } else if (keyword == "vt") {
+                        std::array<Float32, 2> texCoord = {};
+                        ParseFloats(texCoord, 1);
+                        if (m_Options.FlipTexCoordV) {
+                            texCoord[1] = 1.0f - texCoord[1];
+                        }
+                        m_TexCoords.push_back(texCoord);
+                    } else if (keyword == "vn") {
+                        std::array<Float32, 3> normal = {};
+                        ParseFloats(normal, 3);
+                        m_Normals.push_back(normal);
+                    } else if (keyword == "f") {
+                        ParseFace();
+                    } else if (keyword == "o" || keyword == "g") {
+                        m_GroupName = std::string(NextToken());
+                        m_IsSubmeshOpen = false;
+                    } else if (keyword == "usemtl") {
+                        const auto [it, inserted] = m_Materials.try_emplace(std::string(NextToken()),
+                                                                            static_cast<UInt32>(m_Materials.size()));
+                        m_MaterialIndex = it->second;
+                        m_MaterialName = it->first;
+                        m_IsSubmeshOpen = false;
+                    }
+                    // Everything else (mtllib, smoothing groups, lines, points...) has no geometry
+                    // for triangle lists.
+                }
+
+                CloseSubmesh();
+                return BuildMesh();
+            }
+
+        private:
+            [[noreturn]] void Fail(const char* message) const {
+                throw std::runtime_error("OBJ line " + std::to_string(m_LineNumber) + ": " + message);
+            }
+
+            bool NextLine() {
+                while (!m_Source.empty()) {
+                    std::size_t end = m_Source.find('\n');
+                    if (end == std::string_view::npos) {
+                        end = m_Source.size();
+                    }
+
+                    m_Line = m_Source.substr(0, end);
+                    m_Source.remove_prefix(std::min(end + 1, m_Source.size()));
+                    ++m_LineNumber;
+
+                    if (const std::size_t comment = m_Line.find('#'); comment != std::string_view::npos) {
+                        m_Line = m_Line.substr(0, comment);
+                    }
+                    if (m_Line.find_first_not_of(" \t\r") != std::string_view::npos) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            std::string_view NextToken() {
+                const std::size_t begin = m_Line.find_first_not_of(" \t\r");
+                if (begin == std::string_view::npos) {
+                    m_Line = {};
+                    return {};
+                }
+
+                std::size_t end = m_Line.find_first_of(" \t\r", begin);
+                if (end == std::string_view::npos) {
+                    end = m_Line.size();
+                }
+
+                const std::string_view token = m_Line.substr(begin, end - begin);
+                m_Line.remove_prefix(end);
+                return token;
+            }
+
+            Float32 ParseFloat(std::string_view token) const {
+                // from_chars takes no leading plus sign.
+                if (!token.empty() && token.front() == '+') {
+                    token.remove_prefix(1);
+                }
+
+                Float32 value = 0.0f;
+                const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+                if (error != std::errc() || end != token.data() + token.size()) {
+                    Fail("malformed number.");
+                }
+
+                return value;
+            }
+
+            // Reads up to the size of the array, requires at least requiredCount values.
+            template<std::size_t N>
+            UInt32 ParseFloats(std::array<Float32, N>& values, const UInt32 requiredCount) {
+                UInt32 count = 0;
+                for (std::string_view token = NextToken(); !token.empty() && count < N; token = NextToken()) {
+                    values[count++] = ParseFloat(token);
+                }
+                if (count < requiredCount) {
+                    Fail("missing coordinates.");
+                }
+
+                return count;
+            }
+
+            void ParsePosition() {
+                // "v x y z", "v x y z w", or "v x y z r g b" with vertex colors.
+                std::array<Float32, 7> values = {};
+                const UInt32 count = ParseFloats(values, 3);
+                m_Positions.push_back({values[0], values[1], values[2]});
+
+                if (count >= 6) {
+                    if (!m_HasColors) {
+                        m_Colors.resize(m_Positions.size() - 1, {1.0f, 1.0f, 1.0f, 1.0f});
+                        m_HasColors = true;
+                    }
+                    m_Colors.push_back({values[3], values[4], values[5], count == 7 ? values[6] : 1.0f});
+                } else if (m_HasColors) {
+                    m_Colors.push_back({1.0f, 1.0f, 1.0f, 1.0f});
+                }
+            }
+
+            // One-based, or negative from the end of the list so far.
+            UInt32 ResolveIndex(const std::string_view token, const std::size_t count) const {
+                Int64 index = 0;
+                const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), index);
+                if (error != std::errc() || end != token.data() + token.size()) {
+                    Fail("malformed face index.");
+                }
+
+                const Int64 resolved = index < 0 ? static_cast<Int64>(count) + index : index - 1;
+                if (index == 0 || resolved < 0 || resolved >= static_cast<Int64>(count)) {
+                    Fail("face index out of range.");
+                }
+
+                return static_cast<UInt32>(resolved);
+            }
+
+            UInt32 ParseCorner(const std::string_view token) {
+                // "p", "p/t", "p//n" or "p/t/n".
+                ObjCorner corner = {NoIndex, NoIndex, NoIndex};
+                const std::size_t firstSlash = token.find('/');
+                corner.Position = ResolveIndex(token.substr(0, firstSlash), m_Positions.size());
+                if (firstSlash != std::string_view::npos) {
+                    const std::size_t secondSlash = token.find('/', firstSlash + 1);
+                    const std::string_view texCoord = token.substr(firstSlash + 1, secondSlash - firstSlash - 1);
+                    if (!texCoord.empty()) {
+                        corner.TexCoord = ResolveIndex(texCoord, m_TexCoords.size());
+                        m_HasTexCoords = true;
+                    }
+                    if (secondSlash != std::string_view::npos) {
+                        corner.Normal = ResolveIndex(token.substr(secondSlash + 1), m_Normals.size());
+                        m_HasNormals = true;
+                    }
+                }
+
+                const auto [it, inserted] = m_VertexIndices.try_emplace(corner, static_cast<UInt32>(m_Corners.size()));
+                if (inserted) {
+                    m_Corners.push_back(corner);
+                }
+
+                return it->second;
+            }
+
+            void ParseFace() {
+                m_FaceVertices.clear();
+                for (std::string_view token = NextToken(); !token.empty(); token = NextToken()) {
+                    m_FaceVertices.push_back(ParseCorner(token));
+                }
+                if (m_FaceVertices.size() < 3) {
+                    Fail("face with fewer than three vertices.");
+                }
+
+                if (!m_IsSubmeshOpen) {
+                    CloseSubmesh();
+                    m_IsSubmeshOpen = true;
+                }
+
+                for (std::size_t i = 2; i < m_FaceVertices.size(); ++i) {
+                    m_Indices.push_back(m_FaceVertices[0]);
+                    if (m_Options.ReverseWinding) {
+                        m_Indices.push_back(m_FaceVertices[i]);
+                        m_Indices.push_back(m_FaceVertices[i - 1]);
+                    } else {
+                        m_Indices.push_back(m_FaceVertices[i - 1]);
+                        m_Indices.push_back(m_FaceVertices[i]);
+                    }
+                }
+            }
+
+            // Turns the faces read since the previous submesh into one, empty ones are dropped.
+            void CloseSubmesh() {
+                const auto firstIndex = static_cast<UInt32>(m_SubmeshFirstIndex);
+                const auto indexCount = static_cast<UInt32>(m_Indices.size() - m_SubmeshFirstIndex);
+                if (indexCount != 0) {
+                    MeshSubmesh& submesh = m_Submeshes.emplace_back();
+                    submesh.Name = m_SubmeshName;
+                    submesh.MaterialIndex = m_SubmeshMaterialIndex;
+                    submesh.Lods.push_back({firstIndex, indexCount, 0, 0, 0.0f, 0});
+                }
+
+                m_SubmeshFirstIndex = m_Indices.size();
+                m_SubmeshName = m_GroupName.empty() ? m_MaterialName : m_GroupName;
+                m_SubmeshMaterialIndex = m_MaterialIndex;
+            }
+
+            template<typename T>
+            static MeshStream MakeStream(const MeshSemantic semantic, const UInt32 format, const std::vector<T>& values,
+                                         const std::vector<ObjCorner>& corners, UInt32 ObjCorner::*member) {
+                MeshStream stream;
+                stream.Semantic = semantic;
+                stream.Format = format;
+                stream.Stride = sizeof(T);
+                stream.Data.resize(corners.size() * sizeof(T));
+
+                std::byte* pData = stream.Data.data();
+                for (const ObjCorner& corner : corners) {
+                    // Corners without this attribute get zeros.
+                    if (corner.*member != NoIndex) {
+                        std::memcpy(pData, &values[corner.*member], sizeof(T));
+                    }
+                    pData += sizeof(T);
+                }
+
+                return stream;
+            }
+
+            MeshData BuildMesh() {
+                MeshData mesh;
+                mesh.VertexCount = static_cast<UInt32>(m_Corners.size());
+                mesh.Indices = std::move(m_Indices);
+                mesh.Submeshes = std::move(m_Submeshes);
+                for (MeshSubmesh& submesh : mesh.Submeshes) {
+                    submesh.Lods.front().VertexCount = mesh.VertexCount;
+                }
+
+                mesh.Streams.push_back(MakeStream(MeshSemantic::Position, DxgiFormat::R32G32B32Float, m_Positions,
+                                                  m_Corners, &ObjCorner::Position));
+                if (m_HasNormals) {
+                    mesh.Streams.push_back(MakeStream(MeshSemantic::Normal, DxgiFormat::R32G32B32Float, m_Normals,
+                                                      m_Corners, &ObjCorner::Normal));
+                }
+                if (m_HasTexCoords) {
+                    mesh.Streams.push_back(MakeStream(MeshSemantic::TexCoord, DxgiFormat::R32G32Float, m_TexCoords,
+                                                      m_Corners, &ObjCorner::TexCoord));
+                }
+                if (m_HasColors) {
+                    // Colors belong to the positions.
+                    mesh.Streams.push_back(MakeStream(MeshSemantic::Color, DxgiFormat::R32G32B32A32Float, m_Colors,
+                                                      m_Corners, &ObjCorner::Position));
+                }
+
+                ComputeMeshBounds(mesh);
+                return mesh;
+            }
+
+            std::string_view m_Source;
+            std::string_view m_Line;
+            const ObjImportOptions& m_Options;
+            UInt64 m_LineNumber = 0;
+
+            std::vector<std::array<Float32, 3>> m_Positions;
+            std::vector<std::array<Float32, 4>> m_Colors;
+            std::vector<std::array<Float32, 2>> m_TexCoords;
+            std::vector<std::array<Float32, 3>> m_Normals;
+            bool m_HasColors = false;
+            bool m_HasTexCoords = false;
+            bool m_HasNormals = false;
+
+            std::unordered_map<ObjCorner, UInt32, ObjCornerHash> m_VertexIndices;
+            std::vector<ObjCorner> m_Corners;
+            std::vector<UInt32> m_FaceVertices;
+            std::vector<UInt32> m_Indices;
+
+            std::unordered_map<std::string, UInt32> m_Materials;
+            std::string m_GroupName;
+            std::string m_MaterialName;
+            UInt32 m_MaterialIndex = 0;
+            std::vector<MeshSubmesh> m_Submeshes;
+            std::size_t m_SubmeshFirstIndex = 0;
+            std::string m_SubmeshName;
+            UInt32 m_SubmeshMaterialIndex = 0;
+            bool m_IsSubmeshOpen = false;
+        };
+    }
+
+    MeshData ImportObjMesh(const std::filesystem::path& path, const ObjImportOptions& options) {
+        const MappedFile file(path, MappedFileMode::Read);
+        const std::string_view source(reinterpret_cast<const char*>(file.GetData()), file.GetSize());
+
+        return ParseObjMesh(source, options);
+    }
+
+    MeshData ParseObjMesh(const std::string_view source, const ObjImportOptions& options) {
+        return ObjParser(source, options).Parse();
+    }
+}
@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ParallelFor.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace D3D12Tests {
+    UInt32 GetParallelRangeCount(const UInt64 size, const UInt32 threadCount, const UInt64 minSizePerRange) {
+        const UInt64 maxThreadCount = threadCount != 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u);
+        const UInt64 maxRangeCount = size / std::max<UInt64>(minSizePerRange, 1);
+
+        return static_cast<UInt32>(std::max<UInt64>(std::min({maxThreadCount, maxRangeCount, size}), 1));
+    }
+
+    void ParallelFor(const UInt64 size, const UInt32 rangeCount, const std::function<void(UInt64, UInt64)>& function) {
+        if (rangeCount <= 1) {
+            function(0, size);
+            return;
+        }
+
+        const auto rangeBegin = [size, rangeCount](const UInt32 range) {
+            return size / rangeCount * range + std::min<UInt64>(size % rangeCount, range);
+        };
+
+        // Joined when leaving the scope, exceptions included.
+        std::vector<std::jthread> threads;
+        threads.reserve(rangeCount - 1);
+        for (UInt32 range = 1; range < rangeCount; ++range) {
+            threads.emplace_back(function, rangeBegin(range), rangeBegin(range + 1));
+        }
+
+        function(0, rangeBegin(1));
+    }
+}
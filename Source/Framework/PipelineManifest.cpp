@@ -0,0 +1,118 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/PipelineManifest.hpp"
+
+#include "Framework/MappedFile.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    bool PipelineManifest::Add(const GraphicsPipelineDesc& desc, const UInt64 hash) {
+        if (Contains(desc, hash)) {
+            return false;
+        }
+
+        m_Indices.emplace(hash, m_Descs.size());
+        m_Descs.push_back(desc);
+        m_Hashes.push_back(hash);
+
+        return true;
+    }
+
+    void PipelineManifest::Clear() {
+        m_Descs.clear();
+        m_Hashes.clear();
+        m_Indices.clear();
+    }
+
+    bool PipelineManifest::Load(const std::filesystem::path& path) {
+        Clear();
+
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            return false;
+        }
+
+        const MappedFile file(path, MappedFileMode::Read);
+        std::span<const std::byte> data(file.GetData(), file.GetSize());
+
+        Header header;
+        if (data.size() < sizeof(Header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(Header));
+        data = data.subspan(sizeof(Header));
+
+        if (header.Magic != Magic || header.Version != Version) {
+            return false;
+        }
+
+        for (UInt32 i = 0; i < header.EntryCount; ++i) {
+            UInt64 hash;
+            UInt32 size;
+            if (data.size() < sizeof(hash) + sizeof(size)) {
+                Clear();
+                return false;
+            }
+            std::memcpy(&hash, data.data(), sizeof(hash));
+            std::memcpy(&size, data.data() + sizeof(hash), sizeof(size));
+            data = data.subspan(sizeof(hash) + sizeof(size));
+
+            if (data.size() < size) {
+                Clear();
+                return false;
+            }
+
+            // The description must span its whole entry and still hash the same, which also
+            // drops the entries written by a build with other canonicalization rules.
+            std::span<const std::byte> entry = data.first(size);
+            GraphicsPipelineDesc desc;
+            if (!DeserializePipelineDesc(entry, desc) || !entry.empty() || HashPipelineDesc(desc) != hash) {
+                Clear();
+                return false;
+            }
+            data = data.subspan(size);
+
+            Add(desc, hash);
+        }
+
+        return true;
+    }
+
+    void PipelineManifest::Save(const std::filesystem::path& path) const {
+        std::vector<std::byte> data(sizeof(Header));
+        const Header header{Magic, Version, static_cast<UInt32>(m_Descs.size()), 0};
+        std::memcpy(data.data(), &header, sizeof(Header));
+
+        std::vector<std::byte> entry;
+        for (size_t i = 0; i < m_Descs.size(); ++i) {
+            entry.clear();
+            SerializePipelineDesc(m_Descs[i], entry);
+
+            const UInt64 hash = m_Hashes[i];
+            const auto size = static_cast<UInt32>(entry.size());
+            const auto* pHash = reinterpret_cast<const std::byte*>(&hash);
+            const auto* pSize = reinterpret_cast<const std::byte*>(&size);
+            data.insert(data.end(), pHash, pHash + sizeof(hash));
+            data.insert(data.end(), pSize, pSize + sizeof(size));
+            data.insert(data.end(), entry.begin(), entry.end());
+        }
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp";
+
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file) {
+                throw std::runtime_error("Failed to write the pipeline manifest.");
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path);
+    }
+}
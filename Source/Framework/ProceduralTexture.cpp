@@ -0,0 +1,181 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ProceduralTexture.hpp"
+
+#include "Framework/ParallelFor.hpp"
+
+#include "ProceduralTextureKernels.inl"
+
+#include <stdexcept>
+
+#ifdef D3D12TESTS_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        using namespace ProceduralTextureDetail;
+
+#ifdef D3D12TESTS_ARCH_X86
+        // SSE2 is part of x86-64, but lacks a few operations emulated here.
+        struct Sse2Ops {
+            static constexpr UInt32 Width = 4;
+
+            using Float = __m128;
+            using Int = __m128i;
+            using Mask = __m128;
+
+            static Float Set(const Float32 value) { return _mm_set1_ps(value); }
+            static Int SetInt(const UInt32 value) { return _mm_set1_epi32(static_cast<int>(value)); }
+            static Float Ramp(const Float32 start) {
+                return _mm_add_ps(_mm_set1_ps(start), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+            }
+
+            static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+            static Float Min(const Float a, const Float b) { return _mm_min_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm_max_ps(a, b); }
+            static Float Floor(const Float value) {
+                // Truncation rounds the negative values up, take one back from them.
+                const Float truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+                return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+            }
+
+            static Int ToInt(const Float value) { return _mm_cvttps_epi32(value); }
+            static Float ToFloat(const Int value) { return _mm_cvtepi32_ps(value); }
+
+            static Int IntAdd(const Int a, const Int b) { return _mm_add_epi32(a, b); }
+            static Int IntMul(const Int a, const Int b) {
+                // Multiplies the even and odd lanes separately, then interleaves the low halves.
+                const Int even = _mm_mul_epu32(a, b);
+                const Int odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            }
+            static Int IntXor(const Int a, const Int b) { return _mm_xor_si128(a, b); }
+            static Int IntAnd(const Int a, const Int b) { return _mm_and_si128(a, b); }
+            static Int IntOr(const Int a, const Int b) { return _mm_or_si128(a, b); }
+            template <int Shift> static Int ShiftLeft(const Int value) { return _mm_slli_epi32(value, Shift); }
+            template <int Shift> static Int ShiftRight(const Int value) { return _mm_srli_epi32(value, Shift); }
+
+            static Float AsFloat(const Int value) { return _mm_castsi128_ps(value); }
+            static Int AsInt(const Float value) { return _mm_castps_si128(value); }
+
+            static Mask Greater(const Float a, const Float b) { return _mm_cmpgt_ps(a, b); }
+            static Mask IsZero(const Int value) {
+                return _mm_castsi128_ps(_mm_cmpeq_epi32(value, _mm_setzero_si128()));
+            }
+            static Float Select(const Mask mask, const Float a, const Float b) {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            static void Store(std::byte* pDestination, const Int value) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination), value);
+            }
+        };
+#endif
+
+        template <class TDesc>
+        using RowsFunction = void(*)(const TextureRegion&, UInt32, UInt32, const TDesc&);
+
+        template <class TDesc>
+        struct RowsFunctions {
+            RowsFunction<TDesc> Scalar;
+            RowsFunction<TDesc> Sse2;
+            RowsFunction<TDesc> Avx2;
+        };
+
+        void ValidateRegion(const TextureRegion& region) {
+            if (region.Width == 0 || region.Height == 0) {
+                return;
+            }
+
+            if (region.Data == nullptr) {
+                throw std::invalid_argument("The texture region has no memory.");
+            }
+            if (region.RowPitch < static_cast<UInt64>(region.Width) * 4) {
+                throw std::invalid_argument("The row pitch of the texture region is smaller than a row.");
+            }
+        }
+
+        template <class TDesc>
+        void Generate(const TextureRegion& region, const TDesc& desc, const ProceduralTextureOptions& options,
+                      const RowsFunctions<TDesc>& functions) {
+            ValidateRegion(region);
+            if (region.Width == 0 || region.Height == 0) {
+                return;
+            }
+
+            RowsFunction<TDesc> function = functions.Scalar;
+            switch (std::min(options.MaxSimdLevel, GetSimdLevel())) {
+                case SimdLevel::Scalar:
+                    break;
+                case SimdLevel::SSE2:
+                    function = functions.Sse2;
+                    break;
+                case SimdLevel::AVX2:
+                    function = functions.Avx2;
+                    break;
+            }
+
+            // Split by rows, each range needing enough pixels to be worth a thread.
+            const UInt64 minRowsPerRange = (options.MinPixelsPerThread + region.Width - 1) / region.Width;
+            const UInt32 rangeCount = GetParallelRangeCount(region.Height, options.ThreadCount, minRowsPerRange);
+            ParallelFor(region.Height, rangeCount, [&](const UInt64 rowBegin, const UInt64 rowEnd) {
+                function(region, static_cast<UInt32>(rowBegin), static_cast<UInt32>(rowEnd), desc);
+            });
+        }
+    }
+
+    void GenerateCheckerboard(const TextureRegion& region, const CheckerboardDesc& desc,
+                              const ProceduralTextureOptions& options) {
+        if (desc.CellWidth == 0 || desc.CellHeight == 0) {
+            throw std::invalid_argument("The cells of a checkerboard cannot be empty.");
+        }
+
+        RowsFunctions<CheckerboardDesc> functions;
+        functions.Scalar = CheckerboardRows<ScalarOps>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = CheckerboardRows<Sse2Ops>;
+        functions.Avx2 = GenerateCheckerboardRowsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Generate(region, desc, options, functions);
+    }
+
+    void GenerateGradient(const TextureRegion& region, const GradientDesc& desc,
+                          const ProceduralTextureOptions& options) {
+        RowsFunctions<GradientDesc> functions;
+        functions.Scalar = GradientRows<ScalarOps>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = GradientRows<Sse2Ops>;
+        functions.Avx2 = GenerateGradientRowsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Generate(region, desc, options, functions);
+    }
+
+    void GenerateNoise(const TextureRegion& region, const NoiseDesc& desc, const ProceduralTextureOptions& options) {
+        if (desc.Octaves == 0 || desc.Octaves > 16) {
+            throw std::invalid_argument("Noise needs between 1 and 16 octaves.");
+        }
+
+        RowsFunctions<NoiseDesc> functions;
+        functions.Scalar = NoiseRows<ScalarOps>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = NoiseRows<Sse2Ops>;
+        functions.Avx2 = GenerateNoiseRowsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Generate(region, desc, options, functions);
+    }
+}
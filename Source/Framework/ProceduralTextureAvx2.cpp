@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ProceduralTexture.hpp"
+
+#ifdef D3D12TESTS_ARCH_X86
+
+// The standard headers are included before the AVX2 region, so that their inline functions
+// are not compiled for it and then picked by the linker for the other files.
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <immintrin.h>
+
+// Only the kernels of this file are compiled for AVX2; they are only called once the CPU
+// support has been checked. MSVC does not need a flag to use the intrinsics.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "ProceduralTextureKernels.inl"
+
+namespace D3D12Tests::ProceduralTextureDetail {
+    namespace {
+        struct Avx2Ops {
+            static constexpr UInt32 Width = 8;
+
+            using Float = __m256;
+            using Int = __m256i;
+            using Mask = __m256;
+
+            static Float Set(const Float32 value) { return _mm256_set1_ps(value); }
+            static Int SetInt(const UInt32 value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+            static Float Ramp(const Float32 start) {
+                return _mm256_add_ps(_mm256_set1_ps(start),
+                                     _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+            }
+
+            static Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+            static Float Min(const Float a, const Float b) { return _mm256_min_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm256_max_ps(a, b); }
+            static Float Floor(const Float value) { return _mm256_floor_ps(value); }
+
+            static Int ToInt(const Float value) { return _mm256_cvttps_epi32(value); }
+            static Float ToFloat(const Int value) { return _mm256_cvtepi32_ps(value); }
+
+            static Int IntAdd(const Int a, const Int b) { return _mm256_add_epi32(a, b); }
+            static Int IntMul(const Int a, const Int b) { return _mm256_mullo_epi32(a, b); }
+            static Int IntXor(const Int a, const Int b) { return _mm256_xor_si256(a, b); }
+            static Int IntAnd(const Int a, const Int b) { return _mm256_and_si256(a, b); }
+            static Int IntOr(const Int a, const Int b) { return _mm256_or_si256(a, b); }
+            template <int Shift> static Int ShiftLeft(const Int value) { return _mm256_slli_epi32(value, Shift); }
+            template <int Shift> static Int ShiftRight(const Int value) { return _mm256_srli_epi32(value, Shift); }
+
+            static Float AsFloat(const Int value) { return _mm256_castsi256_ps(value); }
+            static Int AsInt(const Float value) { return _mm256_castps_si256(value); }
+
+            static Mask Greater(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static Mask IsZero(const Int value) {
+                return _mm256_castsi256_ps(_mm256_cmpeq_epi32(value, _mm256_setzero_si256()));
+            }
+            static Float Select(const Mask mask, const Float a, const Float b) { return _mm256_blendv_ps(b, a, mask); }
+
+            static void Store(std::byte* pDestination, const Int value) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination), value);
+            }
+        };
+    }
+
+    void GenerateCheckerboardRowsAvx2(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd,
+                                      const CheckerboardDesc& desc) {
+        CheckerboardRows<Avx2Ops>(region, rowBegin, rowEnd, desc);
+    }
+
+    void GenerateGradientRowsAvx2(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd,
+                                  const GradientDesc& desc) {
+        GradientRows<Avx2Ops>(region, rowBegin, rowEnd, desc);
+    }
+
+    void GenerateNoiseRowsAvx2(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd,
+                               const NoiseDesc& desc) {
+        NoiseRows<Avx2Ops>(region, rowBegin, rowEnd, desc);
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,394 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+// Kernels of the procedural textures, written once against a set of vector operations
+// (ScalarOps here, Sse2Ops and Avx2Ops in the files including it). Each including file
+// compiles them for its own instruction set, so everything but the entry points of the
+// AVX2 file has internal linkage.
+
+#include "Framework/ProceduralTexture.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace D3D12Tests::ProceduralTextureDetail {
+#ifdef D3D12TESTS_ARCH_X86
+    // Defined in ProceduralTextureAvx2.cpp.
+    void GenerateCheckerboardRowsAvx2(const TextureRegion& region, UInt32 rowBegin, UInt32 rowEnd,
+                                      const CheckerboardDesc& desc);
+    void GenerateGradientRowsAvx2(const TextureRegion& region, UInt32 rowBegin, UInt32 rowEnd,
+                                  const GradientDesc& desc);
+    void GenerateNoiseRowsAvx2(const TextureRegion& region, UInt32 rowBegin, UInt32 rowEnd, const NoiseDesc& desc);
+#endif
+
+    namespace {
+        struct ScalarOps {
+            static constexpr UInt32 Width = 1;
+
+            using Float = Float32;
+            using Int = UInt32;
+            using Mask = bool;
+
+            static Float Set(const Float32 value) { return value; }
+            static Int SetInt(const UInt32 value) { return value; }
+            // Consecutive values starting at the given one, one per lane.
+            static Float Ramp(const Float32 start) { return start; }
+
+            static Float Add(const Float a, const Float b) { return a + b; }
+            static Float Sub(const Float a, const Float b) { return a - b; }
+            static Float Mul(const Float a, const Float b) { return a * b; }
+            static Float Min(const Float a, const Float b) { return a < b ? a : b; }
+            static Float Max(const Float a, const Float b) { return a > b ? a : b; }
+            static Float Floor(const Float value) { return std::floor(value); }
+
+            // Truncates toward zero, the values are always in the range of Int32.
+            static Int ToInt(const Float value) { return static_cast<UInt32>(static_cast<Int32>(value)); }
+            static Float ToFloat(const Int value) { return static_cast<Float32>(static_cast<Int32>(value)); }
+
+            static Int IntAdd(const Int a, const Int b) { return a + b; }
+            static Int IntMul(const Int a, const Int b) { return a * b; }
+            static Int IntXor(const Int a, const Int b) { return a ^ b; }
+            static Int IntAnd(const Int a, const Int b) { return a & b; }
+            static Int IntOr(const Int a, const Int b) { return a | b; }
+            template <int Shift> static Int ShiftLeft(const Int value) { return value << Shift; }
+            template <int Shift> static Int ShiftRight(const Int value) { return value >> Shift; }
+
+            static Float AsFloat(const Int value) { return std::bit_cast<Float32>(value); }
+            static Int AsInt(const Float value) { return std::bit_cast<UInt32>(value); }
+
+            static Mask Greater(const Float a, const Float b) { return a > b; }
+            static Mask IsZero(const Int value) { return value == 0; }
+            static Float Select(const Mask mask, const Float a, const Float b) { return mask ? a : b; }
+
+            static void Store(std::byte* pDestination, const Int value) {
+                std::memcpy(pDestination, &value, sizeof(value));
+            }
+        };
+
+        template <class TOps>
+        void StorePixels(std::byte* pDestination, const typename TOps::Int pixels, const UInt32 count) {
+            if (count == TOps::Width) {
+                TOps::Store(pDestination, pixels);
+                return;
+            }
+
+            alignas(32) std::byte lanes[TOps::Width * 4];
+            TOps::Store(lanes, pixels);
+            std::memcpy(pDestination, lanes, static_cast<std::size_t>(count) * 4);
+        }
+
+        template <class TOps>
+        void FillPixels(std::byte* pDestination, const UInt32 count, const UInt32 color) {
+            const typename TOps::Int pixels = TOps::SetInt(color);
+
+            UInt32 x = 0;
+            for (; x + TOps::Width <= count; x += TOps::Width) {
+                TOps::Store(pDestination + static_cast<std::size_t>(x) * 4, pixels);
+            }
+            for (; x < count; ++x) {
+                ScalarOps::Store(pDestination + static_cast<std::size_t>(x) * 4, color);
+            }
+        }
+
+        // Calls the shader with the coordinates of the pixel centers, a vector at a time, and
+        // stores the pixels it returns.
+        template <class TOps, class TShader>
+        void ShadeRows(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd, const TShader& shader) {
+            for (UInt32 y = rowBegin; y < rowEnd; ++y) {
+                std::byte* pRow = region.Data + y * region.RowPitch;
+                const typename TOps::Float pixelY = TOps::Set(static_cast<Float32>(y) + 0.5f);
+
+                for (UInt32 x = 0; x < region.Width; x += TOps::Width) {
+                    const typename TOps::Float pixelX = TOps::Ramp(static_cast<Float32>(x) + 0.5f);
+                    StorePixels<TOps>(pRow + static_cast<std::size_t>(x) * 4, shader(pixelX, pixelY),
+                                      std::min(TOps::Width, region.Width - x));
+                }
+            }
+        }
+
+        // Maps [0, 1] to a blend of two colors, values outside are clamped.
+        template <class TOps>
+        class ColorRamp {
+        public:
+            ColorRamp(const UInt32 startColor, const UInt32 endColor) {
+                for (UInt32 channel = 0; channel < 4; ++channel) {
+                    const auto start = static_cast<Float32>((startColor >> (channel * 8)) & 0xff);
+                    const auto end = static_cast<Float32>((endColor >> (channel * 8)) & 0xff);
+
+                    // The half rounds to nearest when converting.
+                    m_Start[channel] = TOps::Set(start + 0.5f);
+                    m_Delta[channel] = TOps::Set(end - start);
+                }
+            }
+
+            typename TOps::Int Evaluate(typename TOps::Float t) const {
+                t = TOps::Min(TOps::Max(t, TOps::Set(0.0f)), TOps::Set(1.0f));
+
+                const auto channel = [this, &t](const UInt32 index) {
+                    return TOps::ToInt(TOps::Add(m_Start[index], TOps::Mul(m_Delta[index], t)));
+                };
+
+                return TOps::IntOr(TOps::IntOr(channel(0), TOps::template ShiftLeft<8>(channel(1))),
+                                   TOps::IntOr(TOps::template ShiftLeft<16>(channel(2)),
+                                               TOps::template ShiftLeft<24>(channel(3))));
+            }
+
+        private:
+            typename TOps::Float m_Start[4];
+            typename TOps::Float m_Delta[4];
+        };
+
+        template <class TOps>
+        typename TOps::Int HashLattice(const typename TOps::Int x, const typename TOps::Int y,
+                                       const typename TOps::Int seed) {
+            typename TOps::Int hash = TOps::IntXor(TOps::IntXor(TOps::IntMul(x, TOps::SetInt(0x27d4eb2d)),
+                                                                TOps::IntMul(y, TOps::SetInt(0x165667b1))), seed);
+            hash = TOps::IntXor(hash, TOps::template ShiftRight<15>(hash));
+            hash = TOps::IntMul(hash, TOps::SetInt(0x2c1b3c6d));
+            hash = TOps::IntXor(hash, TOps::template ShiftRight<12>(hash));
+            hash = TOps::IntMul(hash, TOps::SetInt(0x297a2d39));
+            return TOps::IntXor(hash, TOps::template ShiftRight<15>(hash));
+        }
+
+        template <class TOps>
+        typename TOps::Float Lerp(const typename TOps::Float a, const typename TOps::Float b,
+                                  const typename TOps::Float t) {
+            return TOps::Add(a, TOps::Mul(TOps::Sub(b, a), t));
+        }
+
+        // Returns values in [-1, 1].
+        template <class TOps>
+        typename TOps::Float ValueNoise(const typename TOps::Float x, const typename TOps::Float y,
+                                        const typename TOps::Int seed) {
+            using Float = typename TOps::Float;
+            using Int = typename TOps::Int;
+
+            const Float floorX = TOps::Floor(x);
+            const Float floorY = TOps::Floor(y);
+            const Int x0 = TOps::ToInt(floorX);
+            const Int y0 = TOps::ToInt(floorY);
+            const Int x1 = TOps::IntAdd(x0, TOps::SetInt(1));
+            const Int y1 = TOps::IntAdd(y0, TOps::SetInt(1));
+
+            // Smoothstep of the position in the cell.
+            const Float fractionX = TOps::Sub(x, floorX);
+            const Float fractionY = TOps::Sub(y, floorY);
+            const Float tx = TOps::Mul(TOps::Mul(fractionX, fractionX),
+                                       TOps::Sub(TOps::Set(3.0f), TOps::Add(fractionX, fractionX)));
+            const Float ty = TOps::Mul(TOps::Mul(fractionY, fractionY),
+                                       TOps::Sub(TOps::Set(3.0f), TOps::Add(fractionY, fractionY)));
+
+            // 24 bits of the hash, as a value in [0, 2].
+            const auto corner = [&seed](const Int cornerX, const Int cornerY) {
+                const Int hash = HashLattice<TOps>(cornerX, cornerY, seed);
+                return TOps::Mul(TOps::ToFloat(TOps::template ShiftRight<8>(hash)), TOps::Set(2.0f / 16777216.0f));
+            };
+
+            const Float top = Lerp<TOps>(corner(x0, y0), corner(x1, y0), tx);
+            const Float bottom = Lerp<TOps>(corner(x0, y1), corner(x1, y1), tx);
+            return TOps::Sub(Lerp<TOps>(top, bottom, ty), TOps::Set(1.0f));
+        }
+
+        template <class TOps>
+        typename TOps::Float SimplexCorner(const typename TOps::Float x, const typename TOps::Float y,
+                                           const typename TOps::Int hash) {
+            using Float = typename TOps::Float;
+            using Int = typename TOps::Int;
+
+            // One of the eight gradients (+-1, +-2) and (+-2, +-1): the hash picks the axis
+            // of the larger component, and the signs.
+            const typename TOps::Mask alongX = TOps::IsZero(TOps::IntAnd(hash, TOps::SetInt(4)));
+            const Float u = TOps::Select(alongX, x, y);
+            const Float v = TOps::Select(alongX, y, x);
+            const Int signU = TOps::template ShiftLeft<31>(hash);
+            const Int signV = TOps::template ShiftLeft<30>(TOps::IntAnd(hash, TOps::SetInt(2)));
+            const Float signedU = TOps::AsFloat(TOps::IntXor(TOps::AsInt(u), signU));
+            const Float signedV = TOps::AsFloat(TOps::IntXor(TOps::AsInt(v), signV));
+            const Float gradient = TOps::Add(TOps::Add(signedU, signedU), signedV);
+
+            // The falloff reaches zero before the neighbouring simplices.
+            Float falloff = TOps::Sub(TOps::Set(0.5f), TOps::Add(TOps::Mul(x, x), TOps::Mul(y, y)));
+            falloff = TOps::Max(falloff, TOps::Set(0.0f));
+            falloff = TOps::Mul(falloff, falloff);
+
+            return TOps::Mul(TOps::Mul(falloff, falloff), gradient);
+        }
+
+        // Returns values in [-1, 1].
+        template <class TOps>
+        typename TOps::Float SimplexNoise(const typename TOps::Float x, const typename TOps::Float y,
+                                          const typename TOps::Int seed) {
+            using Float = typename TOps::Float;
+            using Int = typename TOps::Int;
+
+            constexpr Float32 skew = 0.366025403784f; // (sqrt(3) - 1) / 2
+            constexpr Float32 unskew = 0.211324865405f; // (3 - sqrt(3)) / 6
+            // Brings the extrema of the sum of the corners to about +-1.
+            constexpr Float32 scale = 45.23f;
+
+            // Cell of the skewed lattice, and the position in it.
+            const Float skewOffset = TOps::Mul(TOps::Add(x, y), TOps::Set(skew));
+            const Float cellX = TOps::Floor(TOps::Add(x, skewOffset));
+            const Float cellY = TOps::Floor(TOps::Add(y, skewOffset));
+            const Float unskewOffset = TOps::Mul(TOps::Add(cellX, cellY), TOps::Set(unskew));
+            const Float x0 = TOps::Sub(x, TOps::Sub(cellX, unskewOffset));
+            const Float y0 = TOps::Sub(y, TOps::Sub(cellY, unskewOffset));
+
+            // The second corner depends on which triangle of the cell holds the position.
+            const typename TOps::Mask lower = TOps::Greater(x0, y0);
+            const Float stepX = TOps::Select(lower, TOps::Set(1.0f), TOps::Set(0.0f));
+            const Float stepY = TOps::Select(lower, TOps::Set(0.0f), TOps::Set(1.0f));
+            const Float x1 = TOps::Add(TOps::Sub(x0, stepX), TOps::Set(unskew));
+            const Float y1 = TOps::Add(TOps::Sub(y0, stepY), TOps::Set(unskew));
+            const Float x2 = TOps::Add(x0, TOps::Set(2.0f * unskew - 1.0f));
+            const Float y2 = TOps::Add(y0, TOps::Set(2.0f * unskew - 1.0f));
+
+            const Int i = TOps::ToInt(cellX);
+            const Int j = TOps::ToInt(cellY);
+            const Int one = TOps::SetInt(1);
+            const Int hash0 = HashLattice<TOps>(i, j, seed);
+            const Int hash1 = HashLattice<TOps>(TOps::IntAdd(i, TOps::ToInt(stepX)), TOps::IntAdd(j, TOps::ToInt(stepY)),
+                                                seed);
+            const Int hash2 = HashLattice<TOps>(TOps::IntAdd(i, one), TOps::IntAdd(j, one), seed);
+
+            const Float sum = TOps::Add(TOps::Add(SimplexCorner<TOps>(x0, y0, hash0), SimplexCorner<TOps>(x1, y1, hash1)),
+                                        SimplexCorner<TOps>(x2, y2, hash2));
+            return TOps::Mul(sum, TOps::Set(scale));
+        }
+
+        struct NoiseOctave {
+            Float32 Frequency;
+            Float32 Amplitude;
+            UInt32 Seed;
+        };
+
+        template <class TOps, NoiseType Type>
+        class NoiseShader {
+        public:
+            NoiseShader(const NoiseDesc& desc, const std::vector<NoiseOctave>& octaves) :
+                m_Octaves(octaves),
+                m_Ramp(desc.LowColor, desc.HighColor) {
+            }
+
+            typename TOps::Int operator()(const typename TOps::Float x, const typename TOps::Float y) const {
+                typename TOps::Float sum = TOps::Set(0.0f);
+                for (const NoiseOctave& octave : m_Octaves) {
+                    const typename TOps::Float frequency = TOps::Set(octave.Frequency);
+                    const typename TOps::Float octaveX = TOps::Mul(x, frequency);
+                    const typename TOps::Float octaveY = TOps::Mul(y, frequency);
+                    const typename TOps::Int seed = TOps::SetInt(octave.Seed);
+
+                    typename TOps::Float noise;
+                    if constexpr (Type == NoiseType::Value) {
+                        noise = ValueNoise<TOps>(octaveX, octaveY, seed);
+                    } else {
+                        noise = SimplexNoise<TOps>(octaveX, octaveY, seed);
+                    }
+                    sum = TOps::Add(sum, TOps::Mul(noise, TOps::Set(octave.Amplitude)));
+                }
+
+                // The amplitudes are normalized, the sum is in [-1, 1].
+                return m_Ramp.Evaluate(TOps::Add(TOps::Mul(sum, TOps::Set(0.5f)), TOps::Set(0.5f)));
+            }
+
+        private:
+            const std::vector<NoiseOctave>& m_Octaves;
+            ColorRamp<TOps> m_Ramp;
+        };
+
+        template <class TOps>
+        class GradientShader {
+        public:
+            explicit GradientShader(const GradientDesc& desc) :
+                m_Ramp(desc.StartColor, desc.EndColor) {
+                // t is the projection on the gradient's axis, 0 at the start and 1 at the end.
+                const Float32 axisX = desc.EndX - desc.StartX;
+                const Float32 axisY = desc.EndY - desc.StartY;
+                const Float32 lengthSquared = axisX * axisX + axisY * axisY;
+                const Float32 scale = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+
+                m_DirectionX = TOps::Set(axisX * scale);
+                m_DirectionY = TOps::Set(axisY * scale);
+                m_Offset = TOps::Set(-(desc.StartX * axisX + desc.StartY * axisY) * scale);
+            }
+
+            typename TOps::Int operator()(const typename TOps::Float x, const typename TOps::Float y) const {
+                const typename TOps::Float t = TOps::Add(TOps::Add(TOps::Mul(x, m_DirectionX),
+                                                                   TOps::Mul(y, m_DirectionY)), m_Offset);
+                return m_Ramp.Evaluate(t);
+            }
+
+        private:
+            typename TOps::Float m_DirectionX;
+            typename TOps::Float m_DirectionY;
+            typename TOps::Float m_Offset;
+            ColorRamp<TOps> m_Ramp;
+        };
+
+        std::vector<NoiseOctave> GetNoiseOctaves(const NoiseDesc& desc) {
+            std::vector<NoiseOctave> octaves(desc.Octaves);
+
+            Float32 frequency = desc.Frequency;
+            Float32 amplitude = 1.0f;
+            Float32 amplitudeSum = 0.0f;
+            for (UInt32 i = 0; i < desc.Octaves; ++i) {
+                // Each octave gets its own lattice, so that they do not line up at the origin.
+                octaves[i] = {frequency, amplitude, desc.Seed + i * 0x9e3779b9u};
+                amplitudeSum += amplitude;
+                frequency *= desc.Lacunarity;
+                amplitude *= desc.Gain;
+            }
+
+            for (NoiseOctave& octave : octaves) {
+                octave.Amplitude /= amplitudeSum;
+            }
+
+            return octaves;
+        }
+
+        template <class TOps>
+        void CheckerboardRows(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd,
+                              const CheckerboardDesc& desc) {
+            const std::size_t rowSize = static_cast<std::size_t>(region.Width) * 4;
+
+            for (UInt32 y = rowBegin; y < rowEnd; ++y) {
+                std::byte* pRow = region.Data + y * region.RowPitch;
+
+                // The rows of a band of cells are all the same.
+                if (y != rowBegin && y % desc.CellHeight != 0) {
+                    std::memcpy(pRow, pRow - region.RowPitch, rowSize);
+                    continue;
+                }
+
+                UInt32 cell = (y / desc.CellHeight) & 1;
+                for (UInt32 x = 0; x < region.Width; x += desc.CellWidth, ++cell) {
+                    FillPixels<TOps>(pRow + static_cast<std::size_t>(x) * 4, std::min(desc.CellWidth, region.Width - x),
+                                     (cell & 1) == 0 ? desc.Color0 : desc.Color1);
+                }
+            }
+        }
+
+        template <class TOps>
+        void GradientRows(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd,
+                          const GradientDesc& desc) {
+            ShadeRows<TOps>(region, rowBegin, rowEnd, GradientShader<TOps>(desc));
+        }
+
+        template <class TOps>
+        void NoiseRows(const TextureRegion& region, const UInt32 rowBegin, const UInt32 rowEnd, const NoiseDesc& desc) {
+            const std::vector<NoiseOctave> octaves = GetNoiseOctaves(desc);
+
+            if (desc.Type == NoiseType::Value) {
+                ShadeRows<TOps>(region, rowBegin, rowEnd, NoiseShader<TOps, NoiseType::Value>(desc, octaves));
+            } else {
+                ShadeRows<TOps>(region, rowBegin, rowEnd, NoiseShader<TOps, NoiseType::Simplex>(desc, octaves));
+            }
+        }
+    }
+}
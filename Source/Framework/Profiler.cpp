@@ -0,0 +1,338 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace D3D12Tests {
+    namespace {
+        // Per thread, 1.5 MiB each.
+        constexpr UInt64 EventCapacity = 64 * 1024;
+        constexpr UInt64 EventMask = EventCapacity - 1;
+
+        // Shortest interval to measure the timestamp frequency on.
+        constexpr std::chrono::milliseconds MinCalibrationTime(10);
+
+        // Frame marks are recorded as events without a name.
+        struct RawEvent {
+            const char* Name;
+            UInt64 Begin;
+            UInt64 End;
+        };
+
+        // Written by its thread only. Captures read it concurrently and discard the events
+        // that may have been overwritten while they were copied.
+        struct ThreadEvents {
+            std::unique_ptr<RawEvent[]> Events = std::make_unique<RawEvent[]>(EventCapacity);
+            std::atomic<UInt64> WriteCount = 0;
+            UInt32 Id = 0;
+            std::string Name;
+        };
+
+        struct ProfilerState {
+            // Guards the list of threads and their names.
+            std::mutex Mutex;
+            // Kept after their thread exits, so that their events can still be captured.
+            std::vector<std::unique_ptr<ThreadEvents>> Threads;
+
+            UInt64 OriginTimestamp = ReadProfileTimestamp();
+            std::chrono::steady_clock::time_point OriginTime = std::chrono::steady_clock::now();
+        };
+
+        ProfilerState& GetState() {
+            static ProfilerState state;
+            return state;
+        }
+
+        // Starts the clock at static initialization, before any scope can end.
+        [[maybe_unused]] const ProfilerState& g_InitialState = GetState();
+
+        thread_local ThreadEvents* t_pThreadEvents = nullptr;
+
+        ThreadEvents& RegisterThread() {
+            ProfilerState& state = GetState();
+
+            std::lock_guard lock(state.Mutex);
+            auto& events = state.Threads.emplace_back(std::make_unique<ThreadEvents>());
+            events->Id = static_cast<UInt32>(state.Threads.size() - 1);
+            events->Name = "Thread " + std::to_string(events->Id);
+            t_pThreadEvents = events.get();
+
+            return *events;
+        }
+
+        ThreadEvents& GetThreadEvents() {
+            return t_pThreadEvents ? *t_pThreadEvents : RegisterThread();
+        }
+
+        // Two-point calibration against the steady clock, over the lifetime of the profiler.
+        Float64 GetNanosecondsPerTick(const ProfilerState& state) {
+#ifdef D3D12TESTS_ARCH_X86
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - state.OriginTime;
+            if (elapsed < MinCalibrationTime) {
+                std::this_thread::sleep_for(MinCalibrationTime - elapsed);
+            }
+
+            const UInt64 timestamp = ReadProfileTimestamp();
+            elapsed = std::chrono::steady_clock::now() - state.OriginTime;
+
+            const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            return static_cast<Float64>(nanoseconds) / static_cast<Float64>(timestamp - state.OriginTimestamp);
+#else
+            static_cast<void>(state);
+            return 1.0;
+#endif
+        }
+
+        void AppendJsonString(std::string& json, const std::string_view value) {
+            json += '"';
+            for (const char c : value) {
+                switch (c) {
+                    case '"':
+                        json += "\\\"";
+                        break;
+                    case '\\':
+                        json += "\\\\";
+                        break;
+                    case '\n':
+                        json += "\\n";
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                            json += escaped;
+                        } else {
+                            json += c;
+                        }
+                        break;
+                }
+            }
+            json += '"';
+        }
+
+        // Chrome traces are in microseconds.
+        void AppendMicroseconds(std::string& json, const UInt64 nanoseconds) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000),
+                          static_cast<unsigned long long>(nanoseconds % 1000));
+            json += buffer;
+        }
+
+        ProfileScopeSummary Summarize(std::string name, std::vector<UInt64>& frameTimes, const UInt64 callCount) {
+            std::sort(frameTimes.begin(), frameTimes.end());
+
+            UInt64 total = 0;
+            for (const UInt64 time : frameTimes) {
+                total += time;
+            }
+
+            // Nearest rank.
+            const size_t p99Index = (frameTimes.size() * 99 + 99) / 100 - 1;
+
+            ProfileScopeSummary summary;
+            summary.Name = std::move(name);
+            summary.CallCount = callCount;
+            summary.FrameCount = static_cast<UInt32>(frameTimes.size());
+            summary.MinMilliseconds = static_cast<Float64>(frameTimes.front()) * 1e-6;
+            summary.AverageMilliseconds = static_cast<Float64>(total) / static_cast<Float64>(frameTimes.size()) * 1e-6;
+            summary.P99Milliseconds = static_cast<Float64>(frameTimes[p99Index]) * 1e-6;
+
+            return summary;
+        }
+    }
+
+    void RecordProfileEvent(const char* name, const UInt64 beginTimestamp, const UInt64 endTimestamp) {
+        ThreadEvents& events = GetThreadEvents();
+
+        const UInt64 index = events.WriteCount.load(std::memory_order_relaxed);
+        events.Events[index & EventMask] = {name, beginTimestamp, endTimestamp};
+        events.WriteCount.store(index + 1, std::memory_order_release);
+    }
+
+    void MarkProfileFrame() {
+        const UInt64 timestamp = ReadProfileTimestamp();
+        RecordProfileEvent(nullptr, timestamp, timestamp);
+    }
+
+    void SetProfileThreadName(const std::string_view name) {
+        ThreadEvents& events = GetThreadEvents();
+
+        std::lock_guard lock(GetState().Mutex);
+        events.Name = name;
+    }
+
+    ProfileCapture CaptureProfile() {
+        ProfilerState& state = GetState();
+        const Float64 nanosecondsPerTick = GetNanosecondsPerTick(state);
+        const auto toNanoseconds = [&state, nanosecondsPerTick](const UInt64 timestamp) {
+            // Scopes may have started before the profiler.
+            const UInt64 ticks = timestamp > state.OriginTimestamp ? timestamp - state.OriginTimestamp : 0;
+            return static_cast<UInt64>(static_cast<Float64>(ticks) * nanosecondsPerTick);
+        };
+
+        ProfileCapture capture;
+
+        std::lock_guard lock(state.Mutex);
+        std::vector<RawEvent> rawEvents;
+        for (const auto& threadEvents : state.Threads) {
+            const UInt64 end = threadEvents->WriteCount.load(std::memory_order_acquire);
+            const UInt64 begin = end > EventCapacity ? end - EventCapacity : 0;
+
+            rawEvents.clear();
+            for (UInt64 i = begin; i < end; ++i) {
+                rawEvents.push_back(threadEvents->Events[i & EventMask]);
+            }
+
+            // The thread may have wrapped around over the first events while they were copied.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const UInt64 writeCount = threadEvents->WriteCount.load(std::memory_order_relaxed);
+            const UInt64 firstValid = std::max(begin, writeCount > EventCapacity ? writeCount - EventCapacity : 0);
+            const UInt64 skippedCount = std::min(firstValid, end) - begin;
+
+            ProfileThread& thread = capture.Threads.emplace_back();
+            thread.Id = threadEvents->Id;
+            thread.Name = threadEvents->Name;
+            thread.DroppedCount = begin + skippedCount;
+            for (UInt64 i = skippedCount; i < rawEvents.size(); ++i) {
+                const RawEvent& event = rawEvents[i];
+                if (event.Name) {
+                    thread.Events.push_back({event.Name, toNanoseconds(event.Begin), toNanoseconds(event.End)});
+                } else {
+                    capture.FrameBegins.push_back(toNanoseconds(event.Begin));
+                }
+            }
+        }
+
+        std::sort(capture.FrameBegins.begin(), capture.FrameBegins.end());
+
+        return capture;
+    }
+
+    std::string ExportChromeTrace(const ProfileCapture& capture) {
+        std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        const auto beginEvent = [&json, &first]() {
+            json += first ? "\n{" : ",\n{";
+            first = false;
+        };
+
+        for (const ProfileThread& thread : capture.Threads) {
+            beginEvent();
+            json += "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(thread.Id) + ",\"args\":{\"name\":";
+            AppendJsonString(json, thread.Name);
+            json += "}}";
+
+            for (const ProfileEvent& event : thread.Events) {
+                beginEvent();
+                json += "\"name\":";
+                AppendJsonString(json, event.Name);
+                json += ",\"ph\":\"X\",\"pid\":0,\"tid\":" + std::to_string(thread.Id) + ",\"ts\":";
+                AppendMicroseconds(json, event.Begin);
+                json += ",\"dur\":";
+                AppendMicroseconds(json, event.End - event.Begin);
+                json += '}';
+            }
+        }
+
+        for (const UInt64 frameBegin : capture.FrameBegins) {
+            beginEvent();
+            json += "\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":";
+            AppendMicroseconds(json, frameBegin);
+            json += '}';
+        }
+
+        json += "\n]}\n";
+        return json;
+    }
+
+    void SaveChromeTrace(const ProfileCapture& capture, const std::filesystem::path& path) {
+        const std::string json = ExportChromeTrace(capture);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write the Chrome trace.");
+        }
+    }
+
+    std::vector<ProfileScopeSummary> SummarizeProfileFrames(const ProfileCapture& capture) {
+        const std::vector<UInt64>& frameBegins = capture.FrameBegins;
+        if (frameBegins.size() < 2) {
+            return {};
+        }
+
+        struct ScopeTimes {
+            // Per frame, zero for the frames the scope does not appear in.
+            std::vector<UInt64> FrameTimes;
+            UInt64 CallCount = 0;
+        };
+
+        const size_t frameCount = frameBegins.size() - 1;
+        std::map<std::string_view, ScopeTimes> scopes;
+        for (const ProfileThread& thread : capture.Threads) {
+            for (const ProfileEvent& event : thread.Events) {
+                // Scopes belong to the frame they start in.
+                const auto next = std::upper_bound(frameBegins.begin(), frameBegins.end(), event.Begin);
+                if (next == frameBegins.begin() || next == frameBegins.end()) {
+                    continue;
+                }
+
+                ScopeTimes& times = scopes[event.Name];
+                times.FrameTimes.resize(frameCount);
+                times.FrameTimes[static_cast<size_t>(next - frameBegins.begin()) - 1] += event.End - event.Begin;
+                ++times.CallCount;
+            }
+        }
+
+        std::vector<UInt64> frameTimes(frameCount);
+        for (size_t i = 0; i < frameCount; ++i) {
+            frameTimes[i] = frameBegins[i + 1] - frameBegins[i];
+        }
+
+        std::vector<ProfileScopeSummary> summaries;
+        summaries.push_back(Summarize("Frame", frameTimes, frameCount));
+
+        for (auto& [name, times] : scopes) {
+            std::erase(times.FrameTimes, 0);
+            if (!times.FrameTimes.empty()) {
+                summaries.push_back(Summarize(std::string(name), times.FrameTimes, times.CallCount));
+            }
+        }
+
+        std::sort(summaries.begin() + 1, summaries.end(), [](const ProfileScopeSummary& a, const ProfileScopeSummary& b) {
+            return a.AverageMilliseconds > b.AverageMilliseconds;
+        });
+
+        return summaries;
+    }
+
+    std::string FormatProfileSummary(const std::span<const ProfileScopeSummary> summaries) {
+        std::string text;
+        char line[256];
+
+        std::snprintf(line, sizeof(line), "%-32s %8s %8s %10s %10s %10s\n", "Scope", "Frames", "Calls", "Min (ms)",
+                      "Avg (ms)", "P99 (ms)");
+        text += line;
+
+        for (const ProfileScopeSummary& summary : summaries) {
+            std::snprintf(line, sizeof(line), "%-32.32s %8u %8llu %10.3f %10.3f %10.3f\n", summary.Name.c_str(),
+                          summary.FrameCount, static_cast<unsigned long long>(summary.CallCount),
+                          summary.MinMilliseconds, summary.AverageMilliseconds, summary.P99Milliseconds);
+            text += line;
+        }
+
+        return text;
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/RangeAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    RangeAllocator::RangeAllocator(const UInt32 capacity) :
+        m_RangeSizeAtStart(capacity),
+        m_RangeStartAtEnd(capacity),
+        m_Next(capacity),
+        m_Previous(capacity),
+        m_AllocatedSizeAtStart(capacity),
+        m_BinHeads(),
+        m_NonEmptyBins(0),
+        m_Capacity(capacity),
+        m_FreeCount(0) {
+        if (capacity == 0 || capacity == InvalidIndex) {
+            throw std::invalid_argument("Invalid range allocator capacity.");
+        }
+
+        Reset();
+    }
+
+    UInt32 RangeAllocator::Allocate(const UInt32 count) {
+        if (count == 0 || count > m_FreeCount) {
+            return InvalidIndex;
+        }
+
+        // Every range in a bin above the one of the rounded up count is large enough,
+        // so the first of them can be taken without looking at its size.
+        const UInt32 minBin = GetBin(count) + (std::has_single_bit(count) ? 0 : 1);
+        const UInt32 candidateBins = minBin < BinCount ? m_NonEmptyBins & ~((1u << minBin) - 1) : 0;
+
+        UInt32 start = InvalidIndex;
+        if (candidateBins != 0) {
+            start = m_BinHeads[std::countr_zero(candidateBins)];
+        } else {
+            // Ranges in the bin of the count itself may still fit, they have to be checked.
+            for (UInt32 i = m_BinHeads[GetBin(count)]; i != InvalidIndex; i = m_Next[i]) {
+                if (m_RangeSizeAtStart[i] >= count) {
+                    start = i;
+                    break;
+                }
+            }
+
+            if (start == InvalidIndex) {
+                return InvalidIndex;
+            }
+        }
+
+        const UInt32 rangeSize = m_RangeSizeAtStart[start];
+        RemoveFreeRange(start, rangeSize);
+        if (rangeSize > count) {
+            InsertFreeRange(start + count, rangeSize - count);
+        }
+
+        m_AllocatedSizeAtStart[start] = count;
+        m_FreeCount -= count;
+        return start;
+    }
+
+    void RangeAllocator::Free(UInt32 start, UInt32 count) {
+        if (count == 0 || start >= m_Capacity || count > m_Capacity - start) {
+            throw std::out_of_range("Freeing a range outside of the allocator.");
+        }
+
+        if (m_AllocatedSizeAtStart[start] != count) {
+            throw std::invalid_argument("Freeing a range that is not allocated, or with another count.");
+        }
+
+        m_AllocatedSizeAtStart[start] = 0;
+
+        m_FreeCount += count;
+
+        // Merge with the free ranges right before and right after this one.
+        if (start > 0 && m_RangeStartAtEnd[start - 1] != InvalidIndex) {
+            const UInt32 previousStart = m_RangeStartAtEnd[start - 1];
+            const UInt32 previousCount = start - previousStart;
+            RemoveFreeRange(previousStart, previousCount);
+
+            start = previousStart;
+            count += previousCount;
+        }
+
+        const UInt32 end = start + count;
+        if (end < m_Capacity && m_RangeSizeAtStart[end] != 0) {
+            const UInt32 nextCount = m_RangeSizeAtStart[end];
+            RemoveFreeRange(end, nextCount);
+
+            count += nextCount;
+        }
+
+        InsertFreeRange(start, count);
+    }
+
+    void RangeAllocator::Reset() {
+        std::fill(m_RangeSizeAtStart.begin(), m_RangeSizeAtStart.end(), 0);
+        std::fill(m_RangeStartAtEnd.begin(), m_RangeStartAtEnd.end(), InvalidIndex);
+        std::fill(m_AllocatedSizeAtStart.begin(), m_AllocatedSizeAtStart.end(), 0);
+        m_BinHeads.fill(InvalidIndex);
+        m_NonEmptyBins = 0;
+
+        InsertFreeRange(0, m_Capacity);
+        m_FreeCount = m_Capacity;
+    }
+
+    void RangeAllocator::InsertFreeRange(const UInt32 start, const UInt32 count) {
+        const UInt32 bin = GetBin(count);
+
+        m_RangeSizeAtStart[start] = count;
+        m_RangeStartAtEnd[start + count - 1] = start;
+
+        m_Previous[start] = InvalidIndex;
+        m_Next[start] = m_BinHeads[bin];
+        if (m_BinHeads[bin] != InvalidIndex) {
+            m_Previous[m_BinHeads[bin]] = start;
+        }
+
+        m_BinHeads[bin] = start;
+        m_NonEmptyBins |= 1u << bin;
+    }
+
+    void RangeAllocator::RemoveFreeRange(const UInt32 start, const UInt32 count) {
+        const UInt32 bin = GetBin(count);
+
+        m_RangeSizeAtStart[start] = 0;
+        m_RangeStartAtEnd[start + count - 1] = InvalidIndex;
+
+        if (m_Previous[start] != InvalidIndex) {
+            m_Next[m_Previous[start]] = m_Next[start];
+        } else {
+            m_BinHeads[bin] = m_Next[start];
+        }
+
+        if (m_Next[start] != InvalidIndex) {
+            m_Previous[m_Next[start]] = m_Previous[start];
+        }
+
+        if (m_BinHeads[bin] == InvalidIndex) {
+            m_NonEmptyBins &= ~(1u << bin);
+        }
+    }
+}
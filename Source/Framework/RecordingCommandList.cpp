@@ -0,0 +1,75 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/RecordingCommandList.hpp"
+
+namespace D3D12Tests {
+    void RecordingCommandList::SetPipelineState(ID3D12PipelineState* /*pPipelineState*/) {
+        Record(GraphicsCommand::SetPipelineState);
+    }
+
+    void RecordingCommandList::SetGraphicsRootSignature(ID3D12RootSignature* /*pRootSignature*/) {
+        Record(GraphicsCommand::SetGraphicsRootSignature);
+    }
+
+    void RecordingCommandList::SetDescriptorHeaps(const std::span<ID3D12DescriptorHeap* const> /*heaps*/) {
+        Record(GraphicsCommand::SetDescriptorHeaps);
+    }
+
+    void RecordingCommandList::SetGraphicsRootDescriptorTable(const UInt32 /*rootParameter*/, const UInt64 /*baseDescriptor*/) {
+        Record(GraphicsCommand::SetGraphicsRootDescriptorTable);
+    }
+
+    void RecordingCommandList::SetGraphicsRoot32BitConstants(const UInt32 /*rootParameter*/, const std::span<const UInt32> /*values*/,
+                                                             const UInt32 /*destOffset*/) {
+        Record(GraphicsCommand::SetGraphicsRoot32BitConstants);
+    }
+
+    void RecordingCommandList::SetGraphicsRootConstantBufferView(const UInt32 /*rootParameter*/, const UInt64 /*bufferLocation*/) {
+        Record(GraphicsCommand::SetGraphicsRootConstantBufferView);
+    }
+
+    void RecordingCommandList::RSSetViewports(const std::span<const Viewport> /*viewports*/) {
+        Record(GraphicsCommand::SetViewports);
+    }
+
+    void RecordingCommandList::RSSetScissorRects(const std::span<const ScissorRect> /*rects*/) {
+        Record(GraphicsCommand::SetScissorRects);
+    }
+
+    void RecordingCommandList::IASetPrimitiveTopology(const PrimitiveTopology /*topology*/) {
+        Record(GraphicsCommand::SetPrimitiveTopology);
+    }
+
+    void RecordingCommandList::IASetVertexBuffers(const UInt32 /*startSlot*/, const std::span<const VertexBufferView> /*views*/) {
+        Record(GraphicsCommand::SetVertexBuffers);
+    }
+
+    void RecordingCommandList::IASetIndexBuffer(const IndexBufferView* /*pView*/) {
+        Record(GraphicsCommand::SetIndexBuffer);
+    }
+
+    void RecordingCommandList::DrawInstanced(const UInt32 /*vertexCountPerInstance*/, const UInt32 /*instanceCount*/,
+                                             const UInt32 /*startVertexLocation*/, const UInt32 /*startInstanceLocation*/) {
+        Record(GraphicsCommand::DrawInstanced);
+    }
+
+    void RecordingCommandList::DrawIndexedInstanced(const UInt32 /*indexCountPerInstance*/, const UInt32 /*instanceCount*/,
+                                                    const UInt32 /*startIndexLocation*/, const Int32 /*baseVertexLocation*/,
+                                                    const UInt32 /*startInstanceLocation*/) {
+        Record(GraphicsCommand::DrawIndexedInstanced);
+    }
+
+    std::string RecordingCommandList::FormatCallCounts() const {
+        std::string text;
+        for (size_t i = 0; i < m_CallCounts.size(); ++i) {
+            if (m_CallCounts[i] != 0) {
+                text += GetGraphicsCommandName(static_cast<GraphicsCommand>(i));
+                text += ": " + std::to_string(m_CallCounts[i]) + '\n';
+            }
+        }
+
+        return text;
+    }
+}
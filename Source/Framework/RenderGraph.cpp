@@ -0,0 +1,455 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/RenderGraph.hpp"
+
+#include <algorithm>
+
+namespace D3D12Tests {
+    namespace {
+        ResourceBarrier MakeBarrier(const UInt32 resource, const ResourceBarrierType type,
+                                    const ResourceState before = ResourceState::Common,
+                                    const ResourceState after = ResourceState::Common) {
+            return {resource, AllSubresources, before, after, type, ResourceBarrierFlags::None};
+        }
+    }
+
+    UInt32 RenderGraph::CreateTransient(const TransientResourceDesc& desc) {
+        if (desc.Size == 0 || !IsPowerOfTwo(desc.Alignment)) {
+            throw std::invalid_argument("A transient resource needs a size and a power of two alignment.");
+        }
+
+        m_Resources.push_back({desc, ResourceState::Common, ResourceState::Common, false});
+        return static_cast<UInt32>(m_Resources.size() - 1);
+    }
+
+    UInt32 RenderGraph::Import(const ResourceState initialState, const ResourceState finalState) {
+        if (initialState == ResourceState::Unknown || finalState == ResourceState::Unknown) {
+            throw std::invalid_argument("An imported resource needs known states.");
+        }
+
+        m_Resources.push_back({{}, initialState, finalState, true});
+        return static_cast<UInt32>(m_Resources.size() - 1);
+    }
+
+    UInt32 RenderGraph::AddPass(const bool hasSideEffects) {
+        m_Passes.push_back({static_cast<UInt32>(m_Accesses.size()), 0, hasSideEffects});
+        return static_cast<UInt32>(m_Passes.size() - 1);
+    }
+
+    void RenderGraph::Read(const UInt32 resource, const ResourceState state) {
+        Pass& pass = GetLastPass();
+        if (resource >= m_Resources.size() || state == ResourceState::Unknown) {
+            throw std::invalid_argument("A pass reads an unknown resource or in an unknown state.");
+        }
+
+        m_Accesses.push_back({resource, state, false});
+        ++pass.AccessCount;
+    }
+
+    void RenderGraph::Write(const UInt32 resource, const ResourceState state) {
+        Pass& pass = GetLastPass();
+        if (resource >= m_Resources.size() || state == ResourceState::Common || state == ResourceState::Unknown ||
+            IsReadOnlyState(state)) {
+            throw std::invalid_argument("A pass writes an unknown resource or in a state that cannot be written.");
+        }
+
+        m_Accesses.push_back({resource, state, true});
+        ++pass.AccessCount;
+    }
+
+    void RenderGraph::Compile() {
+        m_Statistics = {};
+        m_Statistics.PassCount = GetPassCount();
+
+        BuildUses();
+        CullPasses();
+        PlaceTransients();
+        BuildBarriers();
+    }
+
+    void RenderGraph::Clear() {
+        m_Resources.clear();
+        m_Passes.clear();
+        m_Accesses.clear();
+
+        m_PassOrder.clear();
+        m_Barriers.clear();
+        m_BarrierOffsets.clear();
+        m_FinalBarriers.clear();
+        m_Placements.clear();
+        m_HeapSizes.clear();
+        m_Statistics = {};
+    }
+
+    void RenderGraph::BuildUses() {
+        const UInt32 passCount = GetPassCount();
+        const UInt32 resourceCount = GetResourceCount();
+
+        // The use of each resource in the current pass, older indices belonging to the
+        // previous passes.
+        m_Uses.clear();
+        m_PassFirstUse.resize(static_cast<std::size_t>(passCount) + 1);
+        m_ResourceScratch.assign(resourceCount, InvalidIndex);
+        for (UInt32 passIndex = 0; passIndex < passCount; ++passIndex) {
+            const Pass& pass = m_Passes[passIndex];
+            const UInt32 firstUse = static_cast<UInt32>(m_Uses.size());
+            m_PassFirstUse[passIndex] = firstUse;
+
+            for (UInt32 i = pass.FirstAccess; i < pass.FirstAccess + pass.AccessCount; ++i) {
+                const Access& access = m_Accesses[i];
+                UInt32& useIndex = m_ResourceScratch[access.Resource];
+                if (useIndex == InvalidIndex || useIndex < firstUse) {
+                    useIndex = static_cast<UInt32>(m_Uses.size());
+                    m_Uses.push_back({passIndex, access.Resource, ResourceState::Common, false, false, InvalidIndex});
+                }
+
+                Use& use = m_Uses[useIndex];
+                if (access.Write) {
+                    if (use.Write && use.State != access.State) {
+                        throw std::invalid_argument("A pass writes a resource in two states.");
+                    }
+
+                    use.State = access.State;
+                    use.Write = true;
+                } else {
+                    use.Read = true;
+                    if (!use.Write) {
+                        use.State |= access.State;
+                    }
+                }
+            }
+        }
+        m_PassFirstUse[passCount] = static_cast<UInt32>(m_Uses.size());
+
+        // What each pass reads was written by the last pass writing the resource before it.
+        m_ResourceScratch.assign(resourceCount, InvalidIndex);
+        for (Use& use : m_Uses) {
+            if (!use.Write && !IsReadOnlyState(use.State)) {
+                throw std::invalid_argument("A pass only reads a resource, in a state that is not read-only.");
+            }
+
+            UInt32& lastWriter = m_ResourceScratch[use.Resource];
+            if (use.Read) {
+                if (lastWriter == InvalidIndex && !m_Resources[use.Resource].Imported) {
+                    throw std::invalid_argument("A pass reads a transient resource before it is written.");
+                }
+
+                use.Producer = lastWriter;
+            }
+
+            if (use.Write) {
+                lastWriter = use.Pass;
+            }
+        }
+    }
+
+    void RenderGraph::CullPasses() {
+        const UInt32 passCount = GetPassCount();
+
+        // Walking the passes backwards, a pass is kept once a pass kept reads what it writes,
+        // which only happens after it.
+        m_CompiledPasses.assign(passCount, 0);
+        for (UInt32 passIndex = passCount; passIndex-- > 0;) {
+            UInt32& kept = m_CompiledPasses[passIndex];
+            for (UInt32 i = m_PassFirstUse[passIndex]; i < m_PassFirstUse[passIndex + 1] && kept == 0; ++i) {
+                kept = m_Uses[i].Write && m_Resources[m_Uses[i].Resource].Imported;
+            }
+
+            if (kept == 0 && !m_Passes[passIndex].HasSideEffects) {
+                continue;
+            }
+
+            kept = 1;
+            for (UInt32 i = m_PassFirstUse[passIndex]; i < m_PassFirstUse[passIndex + 1]; ++i) {
+                if (m_Uses[i].Producer != InvalidIndex) {
+                    m_CompiledPasses[m_Uses[i].Producer] = 1;
+                }
+            }
+        }
+
+        m_PassOrder.clear();
+        for (UInt32 passIndex = 0; passIndex < passCount; ++passIndex) {
+            UInt32& compiledPass = m_CompiledPasses[passIndex];
+            if (compiledPass == 0) {
+                compiledPass = InvalidIndex;
+                continue;
+            }
+
+            compiledPass = static_cast<UInt32>(m_PassOrder.size());
+            m_PassOrder.push_back(passIndex);
+        }
+        m_Statistics.CulledPassCount = passCount - static_cast<UInt32>(m_PassOrder.size());
+
+        // The uses of the passes kept, grouped by resource in pass order.
+        const UInt32 resourceCount = GetResourceCount();
+        m_ResourceFirstUse.assign(static_cast<std::size_t>(resourceCount) + 1, 0);
+        for (const Use& use : m_Uses) {
+            if (m_CompiledPasses[use.Pass] != InvalidIndex) {
+                ++m_ResourceFirstUse[use.Resource + 1];
+            }
+        }
+
+        for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+            m_ResourceFirstUse[resource + 1] += m_ResourceFirstUse[resource];
+        }
+
+        m_ResourceUses.resize(m_ResourceFirstUse[resourceCount]);
+        m_ResourceScratch.assign(m_ResourceFirstUse.begin(), m_ResourceFirstUse.end() - 1);
+        for (UInt32 i = 0; i < m_Uses.size(); ++i) {
+            const Use& use = m_Uses[i];
+            if (m_CompiledPasses[use.Pass] != InvalidIndex) {
+                m_ResourceUses[m_ResourceScratch[use.Resource]++] = i;
+            }
+        }
+        m_Statistics.UseCount = static_cast<UInt32>(m_ResourceUses.size());
+    }
+
+    void RenderGraph::PlaceTransients() {
+        const UInt32 resourceCount = GetResourceCount();
+
+        m_Placements.assign(resourceCount, {});
+        m_PlacementOrder.clear();
+        m_HeapSizes.clear();
+        for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+            const Resource& desc = m_Resources[resource];
+            const UInt32 firstUse = m_ResourceFirstUse[resource];
+            const UInt32 useCount = m_ResourceFirstUse[resource + 1] - firstUse;
+            if (desc.Imported || useCount == 0) {
+                continue;
+            }
+
+            TransientPlacement& placement = m_Placements[resource];
+            placement.Heap = desc.Desc.Heap;
+            placement.Size = AlignUp(desc.Desc.Size, desc.Desc.Alignment);
+            placement.FirstPass = m_CompiledPasses[m_Uses[m_ResourceUses[firstUse]].Pass];
+            placement.LastPass = m_CompiledPasses[m_Uses[m_ResourceUses[firstUse + useCount - 1]].Pass];
+            m_PlacementOrder.push_back(resource);
+
+            if (placement.Heap >= m_HeapSizes.size()) {
+                m_HeapSizes.resize(static_cast<std::size_t>(placement.Heap) + 1, 0);
+            }
+            ++m_Statistics.TransientCount;
+            m_Statistics.TransientSize += placement.Size;
+        }
+
+        // The transients alive during each pass kept.
+        const UInt32 compiledPassCount = static_cast<UInt32>(m_PassOrder.size());
+        m_LiveOffsets.assign(static_cast<std::size_t>(compiledPassCount) + 1, 0);
+        for (const UInt32 resource : m_PlacementOrder) {
+            const TransientPlacement& placement = m_Placements[resource];
+            for (UInt32 compiledPass = placement.FirstPass; compiledPass <= placement.LastPass; ++compiledPass) {
+                ++m_LiveOffsets[compiledPass + 1];
+            }
+        }
+
+        for (UInt32 compiledPass = 0; compiledPass < compiledPassCount; ++compiledPass) {
+            m_LiveOffsets[compiledPass + 1] += m_LiveOffsets[compiledPass];
+        }
+
+        m_LiveResources.resize(m_LiveOffsets[compiledPassCount]);
+        m_ResourceScratch.assign(m_LiveOffsets.begin(), m_LiveOffsets.end() - 1);
+        for (const UInt32 resource : m_PlacementOrder) {
+            const TransientPlacement& placement = m_Placements[resource];
+            for (UInt32 compiledPass = placement.FirstPass; compiledPass <= placement.LastPass; ++compiledPass) {
+                m_LiveResources[m_ResourceScratch[compiledPass]++] = resource;
+            }
+        }
+
+        // Largest first, each resource goes to the lowest offset free during its whole
+        // lifetime, among the resources of its heap already placed.
+        std::sort(m_PlacementOrder.begin(), m_PlacementOrder.end(), [this](const UInt32 lhs, const UInt32 rhs) {
+            const TransientPlacement& left = m_Placements[lhs];
+            const TransientPlacement& right = m_Placements[rhs];
+            if (left.Heap != right.Heap) {
+                return left.Heap < right.Heap;
+            }
+            if (left.Size != right.Size) {
+                return left.Size > right.Size;
+            }
+            if (left.FirstPass != right.FirstPass) {
+                return left.FirstPass < right.FirstPass;
+            }
+
+            return lhs < rhs;
+        });
+
+        m_PlacementRanks.resize(resourceCount);
+        for (UInt32 rank = 0; rank < m_PlacementOrder.size(); ++rank) {
+            m_PlacementRanks[m_PlacementOrder[rank]] = rank;
+        }
+
+        // The resources placed before are only visited through the passes of the lifetime,
+        // once each thanks to the rank of the resource being placed.
+        m_ResourceScratch.assign(resourceCount, InvalidIndex);
+        for (UInt32 rank = 0; rank < m_PlacementOrder.size(); ++rank) {
+            const UInt32 resource = m_PlacementOrder[rank];
+            TransientPlacement& placement = m_Placements[resource];
+
+            m_Intervals.clear();
+            for (UInt32 i = m_LiveOffsets[placement.FirstPass]; i < m_LiveOffsets[placement.LastPass + 1]; ++i) {
+                const UInt32 other = m_LiveResources[i];
+                if (m_PlacementRanks[other] < rank && m_ResourceScratch[other] != rank &&
+                    m_Placements[other].Heap == placement.Heap) {
+                    m_ResourceScratch[other] = rank;
+                    m_Intervals.push_back({m_Placements[other].Offset, m_Placements[other].Offset + m_Placements[other].Size});
+                }
+            }
+
+            std::sort(m_Intervals.begin(), m_Intervals.end(), [](const Interval& lhs, const Interval& rhs) {
+                return lhs.Begin < rhs.Begin;
+            });
+
+            const UInt64 alignment = m_Resources[resource].Desc.Alignment;
+            UInt64 offset = 0;
+            for (const Interval& interval : m_Intervals) {
+                if (AlignUp(offset, alignment) + placement.Size <= interval.Begin) {
+                    break;
+                }
+
+                offset = std::max(offset, interval.End);
+            }
+            placement.Offset = AlignUp(offset, alignment);
+
+            UInt64& heapSize = m_HeapSizes[placement.Heap];
+            heapSize = std::max(heapSize, placement.Offset + placement.Size);
+        }
+
+        // Resources sharing memory, necessarily used at different times: by offset, a resource
+        // overlaps one before it when it starts before the end of one of them, and one after it
+        // when the next one starts before its end.
+        std::sort(m_PlacementOrder.begin(), m_PlacementOrder.end(), [this](const UInt32 lhs, const UInt32 rhs) {
+            const TransientPlacement& left = m_Placements[lhs];
+            const TransientPlacement& right = m_Placements[rhs];
+            if (left.Heap != right.Heap) {
+                return left.Heap < right.Heap;
+            }
+
+            return left.Offset < right.Offset;
+        });
+
+        UInt64 end = 0;
+        for (UInt32 i = 0; i < m_PlacementOrder.size(); ++i) {
+            TransientPlacement& placement = m_Placements[m_PlacementOrder[i]];
+            if (i == 0 || placement.Heap != m_Placements[m_PlacementOrder[i - 1]].Heap) {
+                end = 0;
+            }
+
+            placement.Aliased = placement.Offset < end;
+            if (i + 1 < m_PlacementOrder.size()) {
+                const TransientPlacement& next = m_Placements[m_PlacementOrder[i + 1]];
+                placement.Aliased |= next.Heap == placement.Heap && next.Offset < placement.Offset + placement.Size;
+            }
+
+            end = std::max(end, placement.Offset + placement.Size);
+        }
+
+        for (UInt64& heapSize : m_HeapSizes) {
+            heapSize = AlignUp(heapSize, Alignment::ResourcePlacement);
+            m_Statistics.HeapSize += heapSize;
+        }
+    }
+
+    void RenderGraph::BuildBarriers() {
+        const UInt32 resourceCount = GetResourceCount();
+        const UInt32 compiledPassCount = static_cast<UInt32>(m_PassOrder.size());
+
+        m_PassBarriers.clear();
+        m_FinalBarriers.clear();
+        for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+            const UInt32 firstUse = m_ResourceFirstUse[resource];
+            const UInt32 useCount = m_ResourceFirstUse[resource + 1] - firstUse;
+            if (useCount != 0) {
+                AddBarriers(resource, std::span(m_ResourceUses).subspan(firstUse, useCount));
+            }
+        }
+
+        // Grouped by pass, in the order they were added for each pass.
+        m_BarrierOffsets.assign(static_cast<std::size_t>(compiledPassCount) + 1, 0);
+        for (const PassBarrier& passBarrier : m_PassBarriers) {
+            ++m_BarrierOffsets[passBarrier.Pass + 1];
+        }
+
+        for (UInt32 compiledPass = 0; compiledPass < compiledPassCount; ++compiledPass) {
+            m_BarrierOffsets[compiledPass + 1] += m_BarrierOffsets[compiledPass];
+        }
+
+        m_Barriers.resize(m_PassBarriers.size());
+        m_ResourceScratch.assign(m_BarrierOffsets.begin(), m_BarrierOffsets.end() - 1);
+        for (const PassBarrier& passBarrier : m_PassBarriers) {
+            m_Barriers[m_ResourceScratch[passBarrier.Pass]++] = passBarrier.Barrier;
+        }
+    }
+
+    void RenderGraph::AddBarriers(const UInt32 resource, const std::span<const UInt32> uses) {
+        const Resource& desc = m_Resources[resource];
+
+        ResourceState current = desc.InitialState;
+        if (!desc.Imported) {
+            // A transient is written first, and left after its last write or in the
+            // combination of the states of the reads following it.
+            ResourceState lastReads = ResourceState::Common;
+            for (std::size_t i = uses.size(); i-- > 0;) {
+                const Use& use = m_Uses[uses[i]];
+                if (use.Write) {
+                    current = lastReads == ResourceState::Common ? use.State : lastReads;
+                    break;
+                }
+
+                lastReads |= use.State;
+            }
+
+            TransientPlacement& placement = m_Placements[resource];
+            placement.InitialState = current;
+            if (placement.Aliased) {
+                m_PassBarriers.push_back({placement.FirstPass, MakeBarrier(resource, ResourceBarrierType::Aliasing)});
+                ++m_Statistics.AliasingBarrierCount;
+            }
+        }
+
+        bool previousWrite = false;
+        for (std::size_t i = 0; i < uses.size();) {
+            const Use& use = m_Uses[uses[i]];
+            const UInt32 compiledPass = m_CompiledPasses[use.Pass];
+
+            if (use.Write) {
+                if (current != use.State) {
+                    m_PassBarriers.push_back({
+                        compiledPass, MakeBarrier(resource, ResourceBarrierType::Transition, current, use.State)
+                    });
+                    ++m_Statistics.TransitionCount;
+                    current = use.State;
+                } else if (previousWrite && current == ResourceState::UnorderedAccess) {
+                    m_PassBarriers.push_back({compiledPass, MakeBarrier(resource, ResourceBarrierType::UnorderedAccess)});
+                    ++m_Statistics.UavBarrierCount;
+                }
+
+                previousWrite = true;
+                ++i;
+                continue;
+            }
+
+            // The reads up to the next write share a single transition.
+            ResourceState state = use.State;
+            for (++i; i < uses.size() && !m_Uses[uses[i]].Write; ++i) {
+                state |= m_Uses[uses[i]].State;
+            }
+
+            if (!IsStateCompatible(current, state)) {
+                m_PassBarriers.push_back({
+                    compiledPass, MakeBarrier(resource, ResourceBarrierType::Transition, current, state)
+                });
+                ++m_Statistics.TransitionCount;
+                current = state;
+            }
+
+            previousWrite = false;
+        }
+
+        if (desc.Imported && current != desc.FinalState) {
+            m_FinalBarriers.push_back(MakeBarrier(resource, ResourceBarrierType::Transition, current, desc.FinalState));
+            ++m_Statistics.TransitionCount;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ResourceStateTable.hpp"
+
+#include "Framework/ResourceStateTracker.hpp"
+
+#include <algorithm>
+
+namespace D3D12Tests {
+    UInt32 ResourceStateTable::Register(const UInt32 subresourceCount, const ResourceState initialState) {
+        if (subresourceCount == 0 || subresourceCount == AllSubresources || initialState == ResourceState::Unknown) {
+            throw std::invalid_argument("Invalid resource registration.");
+        }
+
+        UInt32 resource;
+        if (!m_FreeResources.empty()) {
+            resource = m_FreeResources.back();
+            m_FreeResources.pop_back();
+        } else {
+            resource = static_cast<UInt32>(m_Resources.size());
+            m_Resources.emplace_back();
+        }
+
+        Entry& entry = m_Resources[resource];
+        entry.State = initialState;
+        entry.SubresourceStates.clear();
+        entry.SubresourceCount = subresourceCount;
+
+        return resource;
+    }
+
+    void ResourceStateTable::Unregister(const UInt32 resource) {
+        if (!IsRegistered(resource)) {
+            throw std::out_of_range("The resource is not registered in the state table.");
+        }
+
+        m_Resources[resource].SubresourceCount = 0;
+        m_FreeResources.push_back(resource);
+    }
+
+    std::span<const ResourceBarrier> ResourceStateTable::Resolve(const ResourceStateTracker& tracker) {
+        if (&tracker.m_Table != this) {
+            throw std::invalid_argument("The tracker records states of another table.");
+        }
+        if (!tracker.IsClosed()) {
+            throw std::logic_error("Resolving the states of a command list that is still recording.");
+        }
+
+        m_ResolvedBarriers.clear();
+
+        for (const ResourceStateTracker::TrackedResource& tracked : tracker.m_TrackedResources) {
+            // The resource may have been unregistered and its identifier reused since the
+            // list was recorded, which is a lifetime bug in the caller.
+            Entry& entry = m_Resources[tracked.Resource];
+            if (entry.SubresourceCount != tracked.SubresourceCount) {
+                throw std::logic_error("A resource used by the command list is no longer registered.");
+            }
+
+            for (UInt32 i = 0; i < tracked.SubresourceCount; ++i) {
+                const ResourceStateTracker::SubresourceState& state =
+                    tracker.m_SubresourceStates[tracked.FirstSubresource + i];
+                if (state.Pending == ResourceState::Unknown) {
+                    continue;
+                }
+
+                // The barriers recorded in the list expect the exact pending state, so a
+                // compatible state is not enough here.
+                const ResourceState before = entry.SubresourceStates.empty()
+                                                 ? entry.State
+                                                 : entry.SubresourceStates[i];
+                if (before != state.Pending) {
+                    m_ResolvedBarriers.push_back({
+                        tracked.Resource, i, before, state.Pending, ResourceBarrierType::Transition,
+                        ResourceBarrierFlags::None
+                    });
+                }
+
+                SetState(entry, i, state.Current);
+            }
+
+            // Go back to a single state once the subresources agree again.
+            if (!entry.SubresourceStates.empty() &&
+                std::ranges::all_of(entry.SubresourceStates, [&entry](const ResourceState state) {
+                    return state == entry.SubresourceStates.front();
+                })) {
+                entry.State = entry.SubresourceStates.front();
+                entry.SubresourceStates.clear();
+            }
+        }
+
+        MergeBarriers(m_ResolvedBarriers);
+        return m_ResolvedBarriers;
+    }
+
+    void ResourceStateTable::MergeBarriers(std::vector<ResourceBarrier>& barriers) const {
+        const auto isNoOp = [](const ResourceBarrier& barrier) {
+            return barrier.Type == ResourceBarrierType::Transition && barrier.StateBefore == barrier.StateAfter;
+        };
+        std::erase_if(barriers, isNoOp);
+
+        std::size_t write = 0;
+        for (std::size_t read = 0; read < barriers.size(); ++write) {
+            const ResourceBarrier& first = barriers[read];
+            barriers[write] = first;
+
+            UInt32 run = 1;
+            if (first.Type == ResourceBarrierType::Transition && first.Subresource == 0) {
+                const UInt32 subresourceCount = m_Resources[first.Resource].SubresourceCount;
+                while (run < subresourceCount && read + run < barriers.size()) {
+                    const ResourceBarrier& next = barriers[read + run];
+                    if (next.Type != first.Type || next.Resource != first.Resource || next.Subresource != run ||
+                        next.StateBefore != first.StateBefore || next.StateAfter != first.StateAfter ||
+                        next.Flags != first.Flags) {
+                        break;
+                    }
+
+                    ++run;
+                }
+
+                if (run == subresourceCount) {
+                    barriers[write].Subresource = AllSubresources;
+                } else {
+                    run = 1;
+                }
+            }
+
+            read += run;
+        }
+
+        barriers.resize(write);
+    }
+
+    void ResourceStateTable::SetState(Entry& entry, const UInt32 subresource, const ResourceState state) {
+        if (entry.SubresourceStates.empty()) {
+            if (entry.State == state) {
+                return;
+            }
+            if (entry.SubresourceCount == 1) {
+                entry.State = state;
+                return;
+            }
+
+            entry.SubresourceStates.assign(entry.SubresourceCount, entry.State);
+        }
+
+        entry.SubresourceStates[subresource] = state;
+    }
+}
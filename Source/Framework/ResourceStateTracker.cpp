@@ -0,0 +1,253 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ResourceStateTracker.hpp"
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    ResourceStateTracker::ResourceStateTracker(const ResourceStateTable& table, const bool enableSplitBarriers) :
+        m_Table(table),
+        m_SplitBarriersEnabled(enableSplitBarriers),
+        m_Closed(false) {
+    }
+
+    void ResourceStateTracker::Transition(const UInt32 resource, const ResourceState state,
+                                          const UInt32 subresource) {
+        if (state == ResourceState::Unknown) {
+            throw std::invalid_argument("Invalid resource state.");
+        }
+
+        const TrackedResource& tracked = Track(resource);
+        if (subresource == AllSubresources) {
+            for (UInt32 i = 0; i < tracked.SubresourceCount; ++i) {
+                TransitionSubresource(tracked, i, state);
+            }
+        } else {
+            if (subresource >= tracked.SubresourceCount) {
+                throw std::out_of_range("Subresource index out of range.");
+            }
+
+            TransitionSubresource(tracked, subresource, state);
+        }
+    }
+
+    void ResourceStateTracker::BeginTransition(const UInt32 resource, const ResourceState state,
+                                               const UInt32 subresource) {
+        if (state == ResourceState::Unknown) {
+            throw std::invalid_argument("Invalid resource state.");
+        }
+
+        const TrackedResource& tracked = Track(resource);
+
+        // Without split barriers, the whole transition happens when the state is needed.
+        if (!m_SplitBarriersEnabled) {
+            return;
+        }
+
+        if (subresource == AllSubresources) {
+            for (UInt32 i = 0; i < tracked.SubresourceCount; ++i) {
+                BeginSubresourceTransition(tracked, i, state);
+            }
+        } else {
+            if (subresource >= tracked.SubresourceCount) {
+                throw std::out_of_range("Subresource index out of range.");
+            }
+
+            BeginSubresourceTransition(tracked, subresource, state);
+        }
+    }
+
+    void ResourceStateTracker::UavBarrier(const UInt32 resource) {
+        TrackedResource& tracked = Track(resource);
+
+        // One UAV barrier per resource and batch is enough.
+        if (tracked.UavBarrierIndex != InvalidIndex) {
+            return;
+        }
+
+        tracked.UavBarrierIndex = static_cast<UInt32>(m_Batch.size());
+        AddBarrier({
+                       resource, AllSubresources, ResourceState::UnorderedAccess, ResourceState::UnorderedAccess,
+                       ResourceBarrierType::UnorderedAccess, ResourceBarrierFlags::None
+                   },
+                   UavBarrierOwner | m_ResourceSlots[resource]);
+    }
+
+    std::span<const ResourceBarrier> ResourceStateTracker::Flush() {
+        for (const UInt32 owner : m_BatchOwners) {
+            if (owner == InvalidIndex) {
+                continue;
+            }
+
+            if (owner & UavBarrierOwner) {
+                m_TrackedResources[owner & ~UavBarrierOwner].UavBarrierIndex = InvalidIndex;
+            } else {
+                m_SubresourceStates[owner].BarrierIndex = InvalidIndex;
+            }
+        }
+
+        m_FlushedBarriers.swap(m_Batch);
+        m_Batch.clear();
+        m_BatchOwners.clear();
+
+        m_Table.MergeBarriers(m_FlushedBarriers);
+        return m_FlushedBarriers;
+    }
+
+    std::span<const ResourceBarrier> ResourceStateTracker::Close() {
+        if (m_Closed) {
+            throw std::logic_error("The command list is already closed.");
+        }
+
+        for (const TrackedResource& tracked : m_TrackedResources) {
+            for (UInt32 i = 0; i < tracked.SubresourceCount; ++i) {
+                if (m_SubresourceStates[tracked.FirstSubresource + i].SplitBefore != ResourceState::Unknown) {
+                    EndSplitTransition(tracked, i);
+                }
+            }
+        }
+
+        m_Closed = true;
+        return Flush();
+    }
+
+    void ResourceStateTracker::Reset() {
+        // The resource slots are validated against the tracked resources, they do not
+        // need to be cleared.
+        m_TrackedResources.clear();
+        m_SubresourceStates.clear();
+        m_Batch.clear();
+        m_BatchOwners.clear();
+        m_FlushedBarriers.clear();
+        m_Closed = false;
+    }
+
+    ResourceStateTracker::TrackedResource& ResourceStateTracker::Track(const UInt32 resource) {
+        if (m_Closed) {
+            throw std::logic_error("Recording barriers in a closed command list.");
+        }
+
+        if (resource < m_ResourceSlots.size()) {
+            const UInt32 slot = m_ResourceSlots[resource];
+            if (slot < m_TrackedResources.size() && m_TrackedResources[slot].Resource == resource) {
+                return m_TrackedResources[slot];
+            }
+        } else {
+            m_ResourceSlots.resize(static_cast<std::size_t>(resource) + 1, InvalidIndex);
+        }
+
+        const UInt32 subresourceCount = m_Table.GetSubresourceCount(resource);
+
+        m_ResourceSlots[resource] = static_cast<UInt32>(m_TrackedResources.size());
+        m_TrackedResources.push_back({
+            resource, static_cast<UInt32>(m_SubresourceStates.size()), subresourceCount, InvalidIndex
+        });
+        m_SubresourceStates.resize(m_SubresourceStates.size() + subresourceCount);
+
+        return m_TrackedResources.back();
+    }
+
+    void ResourceStateTracker::TransitionSubresource(const TrackedResource& tracked, const UInt32 subresource,
+                                                     const ResourceState state) {
+        const UInt32 stateIndex = tracked.FirstSubresource + subresource;
+        SubresourceState& current = m_SubresourceStates[stateIndex];
+
+        if (current.SplitBefore != ResourceState::Unknown) {
+            EndSplitTransition(tracked, subresource);
+        }
+
+        // First use in this list, the transition is resolved at submission.
+        if (current.Current == ResourceState::Unknown) {
+            current.Pending = state;
+            current.Current = state;
+            return;
+        }
+
+        if (IsStateCompatible(current.Current, state)) {
+            return;
+        }
+
+        // Nothing used the subresource since its last barrier, so both transitions can be
+        // merged into one, or dropped if it gets back to a compatible state.
+        if (current.BarrierIndex != InvalidIndex) {
+            ResourceBarrier& barrier = m_Batch[current.BarrierIndex];
+            if (IsStateCompatible(barrier.StateBefore, state)) {
+                barrier.StateAfter = barrier.StateBefore;
+                current.Current = barrier.StateBefore;
+                current.BarrierIndex = InvalidIndex;
+            } else {
+                barrier.StateAfter = state;
+                current.Current = state;
+            }
+
+            return;
+        }
+
+        current.BarrierIndex = static_cast<UInt32>(m_Batch.size());
+        AddBarrier({
+                       tracked.Resource, subresource, current.Current, state, ResourceBarrierType::Transition,
+                       ResourceBarrierFlags::None
+                   },
+                   stateIndex);
+        current.Current = state;
+    }
+
+    void ResourceStateTracker::BeginSubresourceTransition(const TrackedResource& tracked, const UInt32 subresource,
+                                                          const ResourceState state) {
+        const UInt32 stateIndex = tracked.FirstSubresource + subresource;
+        SubresourceState& current = m_SubresourceStates[stateIndex];
+
+        if (current.SplitBefore != ResourceState::Unknown) {
+            if (current.Current == state) {
+                return;
+            }
+
+            EndSplitTransition(tracked, subresource);
+        }
+
+        // Unknown states are resolved at submission, and a barrier still in the batch
+        // is better merged with the transition than split.
+        if (current.Current == ResourceState::Unknown || current.BarrierIndex != InvalidIndex ||
+            IsStateCompatible(current.Current, state)) {
+            if (current.BarrierIndex != InvalidIndex) {
+                TransitionSubresource(tracked, subresource, state);
+            }
+
+            return;
+        }
+
+        current.BarrierIndex = static_cast<UInt32>(m_Batch.size());
+        AddBarrier({
+                       tracked.Resource, subresource, current.Current, state, ResourceBarrierType::Transition,
+                       ResourceBarrierFlags::BeginOnly
+                   },
+                   stateIndex);
+        current.SplitBefore = current.Current;
+        current.Current = state;
+    }
+
+    void ResourceStateTracker::EndSplitTransition(const TrackedResource& tracked, const UInt32 subresource) {
+        SubresourceState& current = m_SubresourceStates[tracked.FirstSubresource + subresource];
+
+        if (current.BarrierIndex != InvalidIndex) {
+            // The transition has not been flushed yet, nothing happened in between so it
+            // does not need to be split.
+            m_Batch[current.BarrierIndex].Flags = ResourceBarrierFlags::None;
+        } else {
+            AddBarrier({
+                           tracked.Resource, subresource, current.SplitBefore, current.Current,
+                           ResourceBarrierType::Transition, ResourceBarrierFlags::EndOnly
+                       },
+                       InvalidIndex);
+        }
+
+        current.SplitBefore = ResourceState::Unknown;
+    }
+
+    void ResourceStateTracker::AddBarrier(const ResourceBarrier& barrier, const UInt32 owner) {
+        m_Batch.push_back(barrier);
+        m_BatchOwners.push_back(owner);
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/RingAllocator.hpp"
+
+#include "Framework/Alignment.hpp"
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    RingAllocator::RingAllocator(const UInt64 capacity) :
+        m_Capacity(capacity),
+        m_Head(0),
+        m_Tail(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("A ring allocator needs a non-zero capacity.");
+        }
+    }
+
+    UInt64 RingAllocator::Allocate(const UInt64 size, const UInt64 alignment, const UInt64 fenceValue) {
+        if (size == 0 || size > m_Capacity) {
+            return InvalidOffset;
+        }
+
+        const UInt64 offset = m_Head % m_Capacity;
+        UInt64 alignedOffset = AlignUp(offset, alignment);
+
+        // Allocations are contiguous: if it does not fit before the end of the range,
+        // skip what is left and start over from the beginning.
+        if (alignedOffset + size > m_Capacity) {
+            alignedOffset = m_Capacity;
+        }
+
+        const UInt64 padding = alignedOffset - offset;
+        if (GetUsedSize() + padding + size > m_Capacity) {
+            return InvalidOffset;
+        }
+
+        m_Head += padding + size;
+
+        if (!m_Regions.empty() && m_Regions.back().FenceValue == fenceValue) {
+            m_Regions.back().End = m_Head;
+        } else {
+            m_Regions.push_back({fenceValue, m_Head});
+        }
+
+        return alignedOffset % m_Capacity;
+    }
+
+    void RingAllocator::Release(const UInt64 completedFenceValue) {
+        while (!m_Regions.empty() && m_Regions.front().FenceValue <= completedFenceValue) {
+            m_Tail = m_Regions.front().End;
+            m_Regions.pop_front();
+        }
+
+        // Once everything is released, restart from the beginning of the range to keep
+        // large allocations from wrapping needlessly.
+        if (m_Regions.empty()) {
+            m_Head = 0;
+            m_Tail = 0;
+        }
+    }
+}
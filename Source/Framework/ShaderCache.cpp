@@ -0,0 +1,167 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/ShaderCache.hpp"
+
+#include "Framework/Alignment.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace D3D12Tests {
+    ShaderCache::ShaderCache(const std::filesystem::path& path, const UInt32 initialBucketCount) :
+        m_File(path, MappedFileMode::ReadWrite),
+        m_InitialBucketCount(initialBucketCount) {
+        if (!IsPowerOfTwo(initialBucketCount) || initialBucketCount < 2) {
+            throw std::invalid_argument("The bucket count of a shader cache must be a power of two.");
+        }
+
+        if (!IsValid()) {
+            Clear();
+        }
+    }
+
+    std::span<const std::byte> ShaderCache::Find(const UInt64 key) const {
+        const Bucket& bucket = Probe(GetStoredKey(key));
+        if (bucket.Key == EmptyKey) {
+            return {};
+        }
+
+        return {GetDataRegion() + bucket.Offset, bucket.Size};
+    }
+
+    std::span<const std::byte> ShaderCache::Insert(const UInt64 key, const std::span<const std::byte> bytecode) {
+        const UInt64 storedKey = GetStoredKey(key);
+
+        // Linear probing stays short as long as the table is at most half full.
+        if ((static_cast<UInt64>(GetHeader().EntryCount) + 1) * 2 > GetHeader().BucketCount) {
+            Rehash(GetHeader().BucketCount * 2);
+        }
+
+        const UInt64 offset = AlignUp(GetHeader().DataSize, BlobAlignment);
+        ReserveData(offset + bytecode.size());
+
+        // The blob is written before the bucket that references it. A replaced blob stays
+        // in the file until the cache is cleared.
+        std::byte* pBlob = GetDataRegion() + offset;
+        if (!bytecode.empty()) {
+            std::memcpy(pBlob, bytecode.data(), bytecode.size());
+        }
+
+        Header& header = GetHeader();
+        header.DataSize = offset + bytecode.size();
+
+        Bucket& bucket = Probe(storedKey);
+        if (bucket.Key == EmptyKey) {
+            ++header.EntryCount;
+        }
+        bucket = {storedKey, offset, bytecode.size()};
+
+        return {pBlob, bytecode.size()};
+    }
+
+    void ShaderCache::Clear() {
+        Initialize(m_InitialBucketCount, 0);
+    }
+
+    bool ShaderCache::IsValid() const {
+        if (m_File.GetSize() < sizeof(Header)) {
+            return false;
+        }
+
+        const Header& header = GetHeader();
+        if (header.Magic != Magic || header.Version != Version || !IsPowerOfTwo(header.BucketCount) ||
+            header.DataSize > header.DataCapacity) {
+            return false;
+        }
+
+        // Probing relies on the empty buckets Insert() keeps, a table over half full could
+        // have none left and make a lookup of a missing key loop forever.
+        if (static_cast<UInt64>(header.EntryCount) * 2 > header.BucketCount) {
+            return false;
+        }
+
+        const UInt64 dataOffset = GetDataOffset(header.BucketCount);
+        if (m_File.GetSize() < dataOffset || m_File.GetSize() - dataOffset < header.DataCapacity) {
+            return false;
+        }
+
+        // A file interrupted in the middle of a write may reference data it does not hold.
+        const Bucket* pBuckets = GetBuckets();
+        UInt32 entryCount = 0;
+        for (UInt32 i = 0; i < header.BucketCount; ++i) {
+            if (pBuckets[i].Key == EmptyKey) {
+                continue;
+            }
+            if (pBuckets[i].Offset > header.DataSize || pBuckets[i].Size > header.DataSize - pBuckets[i].Offset) {
+                return false;
+            }
+
+            ++entryCount;
+        }
+
+        return entryCount == header.EntryCount;
+    }
+
+    void ShaderCache::Initialize(const UInt32 bucketCount, const UInt64 dataCapacity) {
+        m_File.Resize(GetDataOffset(bucketCount) + dataCapacity);
+
+        Header& header = GetHeader();
+        header.Magic = Magic;
+        header.Version = Version;
+        header.BucketCount = bucketCount;
+        header.EntryCount = 0;
+        header.DataSize = 0;
+        header.DataCapacity = dataCapacity;
+
+        std::fill_n(GetBuckets(), bucketCount, Bucket{EmptyKey, 0, 0});
+    }
+
+    ShaderCache::Bucket& ShaderCache::Probe(const UInt64 storedKey) const {
+        Bucket* pBuckets = GetBuckets();
+        const UInt32 mask = GetHeader().BucketCount - 1;
+
+        // The table is never full, so the probe always ends on the key or an empty bucket.
+        for (UInt32 i = static_cast<UInt32>(storedKey) & mask;; i = (i + 1) & mask) {
+            if (pBuckets[i].Key == storedKey || pBuckets[i].Key == EmptyKey) {
+                return pBuckets[i];
+            }
+        }
+    }
+
+    void ShaderCache::Rehash(const UInt32 bucketCount) {
+        const Header oldHeader = GetHeader();
+        const std::vector<Bucket> oldBuckets(GetBuckets(), GetBuckets() + oldHeader.BucketCount);
+
+        // Blob offsets are relative to the data region, which only has to be moved after
+        // the larger table.
+        const UInt64 oldDataOffset = GetDataOffset(oldHeader.BucketCount);
+        const UInt64 newDataOffset = GetDataOffset(bucketCount);
+        m_File.Resize(newDataOffset + oldHeader.DataCapacity);
+        std::memmove(m_File.GetData() + newDataOffset, m_File.GetData() + oldDataOffset, oldHeader.DataSize);
+
+        Header& header = GetHeader();
+        header.BucketCount = bucketCount;
+        std::fill_n(GetBuckets(), bucketCount, Bucket{EmptyKey, 0, 0});
+
+        for (const Bucket& bucket : oldBuckets) {
+            if (bucket.Key != EmptyKey) {
+                Probe(bucket.Key) = bucket;
+            }
+        }
+    }
+
+    void ShaderCache::ReserveData(const UInt64 size) {
+        const UInt64 capacity = GetHeader().DataCapacity;
+        if (size <= capacity) {
+            return;
+        }
+
+        const UInt64 newCapacity = std::max({size, capacity * 2, UInt64(64 * 1024)});
+        m_File.Resize(GetDataOffset(GetHeader().BucketCount) + newCapacity);
+        GetHeader().DataCapacity = newCapacity;
+    }
+}
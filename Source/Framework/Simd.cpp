@@ -0,0 +1,68 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/Simd.hpp"
+
+#if defined(D3D12TESTS_ARCH_X86) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        SimdLevel DetectSimdLevel() {
+#if defined(D3D12TESTS_ARCH_X86) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            if (!sse2) {
+                return SimdLevel::Scalar;
+            }
+
+            // AVX2 also needs the OS to save the YMM registers on context switches.
+            if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+                __cpuidex(info, 7, 0);
+                if ((info[1] & (1 << 5)) != 0) {
+                    return SimdLevel::AVX2;
+                }
+            }
+
+            return SimdLevel::SSE2;
+#elif defined(D3D12TESTS_ARCH_X86)
+            // Also checks the OS support of the AVX registers.
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return SimdLevel::AVX2;
+            }
+
+            return __builtin_cpu_supports("sse2") ? SimdLevel::SSE2 : SimdLevel::Scalar;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+    }
+
+    SimdLevel GetSimdLevel() {
+        static const SimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    const char* GetSimdLevelName(const SimdLevel level) {
+        switch (level) {
+            case SimdLevel::Scalar:
+                return "Scalar";
+            case SimdLevel::SSE2:
+                return "SSE2";
+            case SimdLevel::AVX2:
+                return "AVX2";
+        }
+
+        return "Unknown";
+    }
+}
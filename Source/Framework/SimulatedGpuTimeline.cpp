@@ -0,0 +1,90 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/SimulatedGpuTimeline.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+namespace D3D12Tests {
+    SimulatedGpuTimeline::SimulatedGpuTimeline(const Clock::duration workDuration) :
+        m_WorkDuration(workDuration),
+        m_LastCompletionTime(Clock::now()),
+        m_CompletedValue(0),
+        m_WaitCount(0),
+        m_TotalWaitTime(Clock::duration::zero()) {
+    }
+
+    UInt64 SimulatedGpuTimeline::Signal() {
+        std::lock_guard lock(m_Mutex);
+
+        // The simulated queue executes one submission at a time: work starts either
+        // now or when the previous submission is done, whichever comes last.
+        const Clock::time_point now = Clock::now();
+        const Clock::time_point start = now > m_LastCompletionTime ? now : m_LastCompletionTime;
+        m_LastCompletionTime = start + m_WorkDuration;
+
+        const UInt64 value = m_LastSignaledValue.load(std::memory_order_relaxed) + 1;
+        m_Pending.push_back({value, m_LastCompletionTime});
+        m_LastSignaledValue.store(value, std::memory_order_release);
+
+        return value;
+    }
+
+    UInt64 SimulatedGpuTimeline::GetCompletedValue() {
+        std::lock_guard lock(m_Mutex);
+        RetireCompleted(Clock::now());
+        return m_CompletedValue;
+    }
+
+    void SimulatedGpuTimeline::WaitForValue(const UInt64 value) {
+        std::unique_lock lock(m_Mutex);
+
+        if (value > m_LastSignaledValue.load(std::memory_order_relaxed)) {
+            // Nothing will ever signal this value, a real fence would hang forever.
+            throw std::logic_error("Waiting on a fence value that was never signaled.");
+        }
+
+        const Clock::time_point now = Clock::now();
+        RetireCompleted(now);
+        if (value <= m_CompletedValue) {
+            return;
+        }
+
+        // Pending signals are sorted by value, so the one we wait for is at a known offset.
+        const Clock::time_point completionTime = m_Pending[value - m_Pending.front().Value].CompletionTime;
+        ++m_WaitCount;
+        m_TotalWaitTime += completionTime - now;
+
+        lock.unlock();
+        std::this_thread::sleep_until(completionTime);
+        lock.lock();
+
+        RetireCompleted(completionTime > Clock::now() ? completionTime : Clock::now());
+    }
+
+    void SimulatedGpuTimeline::CompleteUpTo(const UInt64 value) {
+        std::lock_guard lock(m_Mutex);
+
+        while (!m_Pending.empty() && m_Pending.front().Value <= value) {
+            m_CompletedValue = m_Pending.front().Value;
+            m_Pending.pop_front();
+        }
+
+        // Whatever is still in flight now starts executing from this point.
+        Clock::time_point start = Clock::now();
+        for (PendingSignal& pending : m_Pending) {
+            start += m_WorkDuration;
+            pending.CompletionTime = start;
+        }
+        m_LastCompletionTime = start;
+    }
+
+    void SimulatedGpuTimeline::RetireCompleted(const Clock::time_point now) {
+        while (!m_Pending.empty() && m_Pending.front().CompletionTime <= now) {
+            m_CompletedValue = m_Pending.front().Value;
+            m_Pending.pop_front();
+        }
+    }
+}
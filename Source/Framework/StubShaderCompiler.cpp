@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/StubShaderCompiler.hpp"
+
+#include "Framework/Hash.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace D3D12Tests {
+    StubShaderCompiler::StubShaderCompiler(const std::chrono::nanoseconds compileTime,
+                                           const std::size_t bytecodeSize) :
+        m_CompileTime(compileTime),
+        m_BytecodeSize(bytecodeSize),
+        m_CompileCount(0) {
+    }
+
+    std::vector<std::byte> StubShaderCompiler::Compile(const ShaderCompileDesc& desc) {
+        std::ifstream file(desc.SourcePath, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open " + desc.SourcePath.string() + ".");
+        }
+        const std::string source{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+        // Spin rather than sleep, a compiler keeps its thread busy.
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < m_CompileTime) {
+        }
+
+        UInt64 state = HashCombine(Hash64(source), Hash64(desc.EntryPoint));
+        state = HashCombine(state, Hash64(desc.Target));
+        state = HashCombine(state, desc.Flags);
+        for (const ShaderDefine& define : desc.Defines) {
+            state = HashCombine(state, HashCombine(Hash64(define.Name), Hash64(define.Value)));
+        }
+
+        std::vector<std::byte> bytecode(m_BytecodeSize);
+        for (std::size_t i = 0; i < bytecode.size(); ++i) {
+            if (i % sizeof(UInt64) == 0) {
+                state = HashCombine(state, i);
+            }
+            bytecode[i] = static_cast<std::byte>(state >> (i % sizeof(UInt64) * 8));
+        }
+
+        ++m_CompileCount;
+        return bytecode;
+    }
+
+    UInt64 StubShaderCompiler::GetVersionHash() const {
+        return Hash64("StubShaderCompiler");
+    }
+}
@@ -0,0 +1,193 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/SubresourceCopy.hpp"
+
+#include "Framework/Alignment.hpp"
+#include "Framework/ParallelFor.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifdef D3D12TESTS_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        UInt32 GetMipSize(const UInt64 size, const UInt32 mip) {
+            return static_cast<UInt32>(std::max<UInt64>(size >> mip, 1));
+        }
+
+        // Below this size, the setup of the streaming loop costs more than it saves.
+        constexpr UInt64 MinStreamSize = 256;
+
+#ifdef D3D12TESTS_ARCH_X86
+        // Non-temporal stores fill whole write-combining buffers instead of reading the lines
+        // into the cache first. SSE2 is enough to saturate the memory bus, wider stores do not
+        // make the copy faster.
+        void StreamCopySse2(std::byte* pDestination, const std::byte* pSource, UInt64 size) {
+            if (size < MinStreamSize) {
+                std::memcpy(pDestination, pSource, size);
+                return;
+            }
+
+            const UInt64 head = (16 - (reinterpret_cast<std::uintptr_t>(pDestination) & 15)) & 15;
+            std::memcpy(pDestination, pSource, head);
+            pDestination += head;
+            pSource += head;
+            size -= head;
+
+            const UInt64 blockCount = size / 64;
+            for (UInt64 i = 0; i < blockCount; ++i) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + 16));
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + 32));
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i*>(pDestination), a);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(pDestination + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(pDestination + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i*>(pDestination + 48), d);
+                pDestination += 64;
+                pSource += 64;
+            }
+
+            std::memcpy(pDestination, pSource, size - blockCount * 64);
+        }
+#endif
+
+        using CopyFunction = void (*)(std::byte*, const std::byte*, UInt64);
+
+        void CopyScalar(std::byte* pDestination, const std::byte* pSource, const UInt64 size) {
+            std::memcpy(pDestination, pSource, size);
+        }
+
+        CopyFunction GetCopyFunction(const SimdLevel maxSimdLevel) {
+#ifdef D3D12TESTS_ARCH_X86
+            if (std::min(maxSimdLevel, GetSimdLevel()) >= SimdLevel::SSE2) {
+                return StreamCopySse2;
+            }
+#endif
+            return CopyScalar;
+        }
+
+        // Makes the non-temporal stores visible to other threads, and to the GPU once submitted.
+        void FenceStreamStores([[maybe_unused]] const CopyFunction function) {
+#ifdef D3D12TESTS_ARCH_X86
+            if (function == StreamCopySse2) {
+                _mm_sfence();
+            }
+#endif
+        }
+    }
+
+    UInt64 ComputeCopyableFootprints(const TextureCopyDesc& desc, const UInt32 firstSubresource, const UInt64 baseOffset,
+                                     const std::span<SubresourceFootprint> footprints) {
+        const TextureFormatInfo info = GetTextureFormatInfo(desc.Format);
+        if (info.BlockSize == 0) {
+            throw std::invalid_argument("The texture format has no single-plane layout.");
+        }
+        if (desc.Width == 0 || desc.Height == 0 || desc.DepthOrArraySize == 0 || desc.MipLevels == 0) {
+            throw std::invalid_argument("The texture has no texels.");
+        }
+        if (desc.Width > std::numeric_limits<UInt32>::max()) {
+            throw std::invalid_argument("The texture is too wide for a copyable footprint.");
+        }
+        if (firstSubresource > GetSubresourceCount(desc) || footprints.size() > GetSubresourceCount(desc) - firstSubresource) {
+            throw std::invalid_argument("The subresources are out of the range of the texture.");
+        }
+        if (baseOffset % Alignment::TexturePlacement != 0) {
+            throw std::invalid_argument("The base offset is not aligned to Alignment::TexturePlacement.");
+        }
+
+        const bool is3D = desc.Dimension == TextureDimension::Texture3D;
+        const bool is1D = desc.Dimension == TextureDimension::Texture1D;
+
+        UInt64 offset = baseOffset;
+        UInt64 end = baseOffset;
+        for (UInt32 i = 0; i < footprints.size(); ++i) {
+            const UInt32 mip = (firstSubresource + i) % desc.MipLevels;
+            const UInt32 width = GetMipSize(desc.Width, mip);
+            const UInt32 height = is1D ? 1 : GetMipSize(desc.Height, mip);
+            const UInt32 depth = is3D ? GetMipSize(desc.DepthOrArraySize, mip) : 1;
+
+            const TextureLayout layout = ComputeTextureLayout(desc.Format, width, height);
+            const UInt64 rowPitch = AlignUp(layout.RowPitch, Alignment::TextureRowPitch);
+            if (rowPitch > std::numeric_limits<UInt32>::max()) {
+                throw std::invalid_argument("The texture is too wide for a copyable footprint.");
+            }
+
+            offset = AlignUp(offset, Alignment::TexturePlacement);
+
+            SubresourceFootprint& footprint = footprints[i];
+            footprint.Offset = offset;
+            footprint.Format = desc.Format;
+            footprint.Width = static_cast<UInt32>(AlignUp(width, info.BlockWidth));
+            footprint.Height = static_cast<UInt32>(layout.RowCount) * info.BlockHeight;
+            footprint.Depth = depth;
+            footprint.RowPitch = static_cast<UInt32>(rowPitch);
+            footprint.RowCount = layout.RowCount;
+            footprint.RowSize = layout.RowPitch;
+
+            // The last row of the last slice is not padded to the row pitch.
+            end = offset + rowPitch * (static_cast<UInt64>(layout.RowCount) * depth - 1) + layout.RowPitch;
+            offset += rowPitch * layout.RowCount * depth;
+        }
+
+        return end - baseOffset;
+    }
+
+    void CopySubresource(std::byte* pDestination, const SubresourceFootprint& footprint, const SubresourceData& source,
+                         const SubresourceCopyOptions& options) {
+        if (footprint.RowSize > footprint.RowPitch || footprint.RowSize > source.RowPitch) {
+            throw std::invalid_argument("The rows of the subresource are larger than their pitch.");
+        }
+
+        const UInt64 rowCount = static_cast<UInt64>(footprint.RowCount) * footprint.Depth;
+        if (rowCount == 0 || footprint.RowSize == 0) {
+            return;
+        }
+
+        const CopyFunction function = GetCopyFunction(options.MaxSimdLevel);
+        std::byte* pBase = pDestination + footprint.Offset;
+
+        const UInt64 minRowsPerRange = (options.MinBytesPerThread + footprint.RowSize - 1) / footprint.RowSize;
+        const UInt32 rangeCount = GetParallelRangeCount(rowCount, options.ThreadCount, minRowsPerRange);
+        ParallelFor(rowCount, rangeCount, [&](const UInt64 rowBegin, const UInt64 rowEnd) {
+            for (UInt64 row = rowBegin; row < rowEnd; ++row) {
+                const UInt64 slice = row / footprint.RowCount;
+                const UInt64 sliceRow = row % footprint.RowCount;
+                const std::byte* pSourceRow = source.Data + slice * source.SlicePitch + sliceRow * source.RowPitch;
+
+                function(pBase + row * footprint.RowPitch, pSourceRow, footprint.RowSize);
+            }
+
+            FenceStreamStores(function);
+        });
+    }
+
+    void StreamCopy(void* pDestination, const void* pSource, const UInt64 size, const SubresourceCopyOptions& options) {
+        if (size == 0) {
+            return;
+        }
+
+        const CopyFunction function = GetCopyFunction(options.MaxSimdLevel);
+        auto* pDestinationBytes = static_cast<std::byte*>(pDestination);
+        const auto* pSourceBytes = static_cast<const std::byte*>(pSource);
+
+        // Ranges are whole cache lines, so that threads share no line of an aligned destination.
+        const UInt64 lineCount = (size + 63) / 64;
+        const UInt32 rangeCount = GetParallelRangeCount(lineCount, options.ThreadCount, (options.MinBytesPerThread + 63) / 64);
+        ParallelFor(lineCount, rangeCount, [&](const UInt64 lineBegin, const UInt64 lineEnd) {
+            const UInt64 begin = lineBegin * 64;
+            const UInt64 end = std::min(lineEnd * 64, size);
+            function(pDestinationBytes + begin, pSourceBytes + begin, end - begin);
+
+            FenceStreamStores(function);
+        });
+    }
+}
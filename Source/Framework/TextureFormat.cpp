@@ -0,0 +1,49 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/TextureFormat.hpp"
+
+namespace D3D12Tests {
+    TextureFormatInfo GetTextureFormatInfo(const UInt32 dxgiFormat) {
+        // Ranges of consecutive DXGI_FORMAT values sharing a layout.
+        struct FormatRange {
+            UInt32 First;
+            UInt32 Last;
+            TextureFormatInfo Info;
+        };
+
+        static constexpr FormatRange ranges[] = {
+            {1, 4, {1, 1, 16}}, // R32G32B32A32
+            {5, 8, {1, 1, 12}}, // R32G32B32
+            {9, 22, {1, 1, 8}}, // R16G16B16A16, R32G32, R32G8X24
+            {23, 47, {1, 1, 4}}, // R10G10B10A2 to X24_TYPELESS_G8_UINT
+            {48, 59, {1, 1, 2}}, // R8G8, R16
+            {60, 65, {1, 1, 1}}, // R8, A8
+            {66, 66, {8, 1, 1}}, // R1
+            {67, 67, {1, 1, 4}}, // R9G9B9E5_SHAREDEXP
+            {68, 69, {2, 1, 4}}, // R8G8_B8G8, G8R8_G8B8
+            {70, 72, {4, 4, 8}}, // BC1
+            {73, 78, {4, 4, 16}}, // BC2, BC3
+            {79, 81, {4, 4, 8}}, // BC4
+            {82, 84, {4, 4, 16}}, // BC5
+            {85, 86, {1, 1, 2}}, // B5G6R5, B5G5R5A1
+            {87, 93, {1, 1, 4}}, // B8G8R8A8, B8G8R8X8, R10G10B10_XR_BIAS_A2
+            {94, 99, {4, 4, 16}}, // BC6H, BC7
+            {100, 101, {1, 1, 4}}, // AYUV, Y410
+            {102, 102, {1, 1, 8}}, // Y416
+            {107, 107, {2, 1, 4}}, // YUY2
+            {108, 109, {2, 1, 8}}, // Y210, Y216
+            {111, 113, {1, 1, 1}}, // AI44, IA44, P8
+            {114, 115, {1, 1, 2}}, // A8P8, B4G4R4A4
+        };
+
+        for (const FormatRange& range : ranges) {
+            if (dxgiFormat >= range.First && dxgiFormat <= range.Last) {
+                return range.Info;
+            }
+        }
+
+        return {1, 1, 0};
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/TimelineRingAllocator.hpp"
+
+#include <stdexcept>
+
+namespace D3D12Tests {
+    TimelineRingAllocator::TimelineRingAllocator(GpuTimeline& timeline, const UInt64 capacity) :
+        m_Timeline(timeline),
+        m_Allocator(capacity),
+        m_WaitCount(0) {
+    }
+
+    UInt64 TimelineRingAllocator::Allocate(const UInt64 size, const UInt64 alignment) {
+        // Whatever is allocated now is consumed by work submitted before the next signal.
+        const UInt64 fenceValue = m_Timeline.GetLastSignaledValue() + 1;
+
+        UInt64 offset = m_Allocator.Allocate(size, alignment, fenceValue);
+        if (offset == RingAllocator::InvalidOffset) {
+            // Only query the fence when we run out of space, it is not free on real hardware.
+            m_Allocator.Release(m_Timeline.GetCompletedValue());
+            offset = m_Allocator.Allocate(size, alignment, fenceValue);
+        }
+
+        while (offset == RingAllocator::InvalidOffset) {
+            // Allocations made since the last signal cannot be waited for: the work using
+            // them has not been submitted yet.
+            if (m_Allocator.IsEmpty() || m_Allocator.GetOldestFenceValue() >= fenceValue) {
+                throw std::length_error("The ring is too small for the requested allocation.");
+            }
+
+            const UInt64 oldestFenceValue = m_Allocator.GetOldestFenceValue();
+            ++m_WaitCount;
+            m_Timeline.WaitForValue(oldestFenceValue);
+            m_Allocator.Release(oldestFenceValue);
+
+            offset = m_Allocator.Allocate(size, alignment, fenceValue);
+        }
+
+        return offset;
+    }
+}
@@ -0,0 +1,28 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/UploadRing.hpp"
+
+#include "Framework/SubresourceCopy.hpp"
+
+namespace D3D12Tests {
+    UploadRing::UploadRing(GpuTimeline& timeline, std::byte* cpuBase, const UInt64 gpuBase, const UInt64 capacity) :
+        m_Allocator(timeline, capacity),
+        m_CpuBase(cpuBase),
+        m_GpuBase(gpuBase) {
+    }
+
+    UploadAllocation UploadRing::Allocate(const UInt64 size, const UInt64 alignment) {
+        const UInt64 offset = m_Allocator.Allocate(size, alignment);
+        return {m_CpuBase + offset, m_GpuBase + offset, offset, size};
+    }
+
+    UploadAllocation UploadRing::Upload(const void* pData, const UInt64 size, const UInt64 alignment) {
+        const UploadAllocation allocation = Allocate(size, alignment);
+        // Upload heaps are write-combined, streaming stores avoid the partial line writes.
+        StreamCopy(allocation.CpuAddress, pData, size);
+
+        return allocation;
+    }
+}
@@ -0,0 +1,458 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/VertexCompression.hpp"
+
+#include "Framework/ParallelFor.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include "VertexCompressionKernels.inl"
+
+#include <limits>
+#include <stdexcept>
+
+#ifdef D3D12TESTS_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace D3D12Tests {
+    namespace {
+        using namespace VertexCompressionDetail;
+
+#ifdef D3D12TESTS_ARCH_X86
+        struct Sse2Ops {
+            static constexpr UInt32 Width = 4;
+
+            using Float = __m128;
+            using Int = __m128i;
+            using Mask = __m128;
+
+            static Float Set(const Float32 value) { return _mm_set1_ps(value); }
+            static Int SetInt(const UInt32 value) { return _mm_set1_epi32(static_cast<int>(value)); }
+
+            static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+            static Float Div(const Float a, const Float b) { return _mm_div_ps(a, b); }
+            static Float Min(const Float a, const Float b) { return _mm_min_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm_max_ps(a, b); }
+            static Float Abs(const Float value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+            static Float SignNotZero(const Float value) {
+                return _mm_or_ps(_mm_set1_ps(1.0f), _mm_and_ps(_mm_set1_ps(-0.0f), value));
+            }
+
+            static Int RoundToInt(const Float value) { return _mm_cvtps_epi32(value); }
+
+            static Int IntAnd(const Int a, const Int b) { return _mm_and_si128(a, b); }
+            static Int IntOr(const Int a, const Int b) { return _mm_or_si128(a, b); }
+            template <int Shift> static Int ShiftLeft(const Int value) { return _mm_slli_epi32(value, Shift); }
+
+            static Mask Less(const Float a, const Float b) { return _mm_cmplt_ps(a, b); }
+            static Mask Greater(const Float a, const Float b) { return _mm_cmpgt_ps(a, b); }
+            static Float Select(const Mask mask, const Float a, const Float b) {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            // The integer version of ScalarOps::FloatToHalf.
+            static Int FloatToHalf(const Float value) {
+                const __m128 sign = _mm_and_ps(_mm_set1_ps(-0.0f), value);
+                const __m128 magnitude = _mm_xor_ps(value, sign);
+                const __m128i magnitudeBits = _mm_castps_si128(magnitude);
+
+                const __m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(magnitude, magnitude));
+                const __m128i isRegular = _mm_cmpgt_epi32(_mm_set1_epi32(HalfOverflowBits), magnitudeBits);
+                const __m128i special = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+                const __m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32(HalfMinNormalBits), magnitudeBits);
+
+                const __m128i magic = _mm_set1_epi32(HalfSubnormalMagicBits);
+                const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(magnitude, _mm_castsi128_ps(magic))), magic);
+
+                const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(magnitudeBits, 13), _mm_set1_epi32(1));
+                const __m128i normal = _mm_srli_epi32(
+                    _mm_add_epi32(_mm_add_epi32(magnitudeBits, _mm_set1_epi32(HalfNormalBias)), mantissaOdd), 13);
+
+                const __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+                const __m128i half = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+                return _mm_or_si128(half, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+            }
+
+            // Built from scalar loads: storing the lanes and reloading them as a vector would
+            // stall on the store forwarding.
+            static Float Load(const std::byte* pSource, const UInt64 stride) {
+                return _mm_setr_ps(LoadLane(pSource), LoadLane(pSource + stride), LoadLane(pSource + 2 * stride),
+                                   LoadLane(pSource + 3 * stride));
+            }
+
+            static void Store16x2(std::byte* pDestination, const Int x, const Int y) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination), Pack16(x, y));
+            }
+            static void Store16x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                const __m128i xy = Pack16(x, y);
+                const __m128i zw = Pack16(z, w);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination), _mm_unpacklo_epi32(xy, zw));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + 16), _mm_unpackhi_epi32(xy, zw));
+            }
+            static void Store8x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                const __m128i mask = _mm_set1_epi32(0xFF);
+                const __m128i packed = _mm_or_si128(
+                    _mm_or_si128(_mm_and_si128(x, mask), _mm_slli_epi32(_mm_and_si128(y, mask), 8)),
+                    _mm_or_si128(_mm_slli_epi32(_mm_and_si128(z, mask), 16), _mm_slli_epi32(w, 24)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination), packed);
+            }
+
+        private:
+            static Float32 LoadLane(const std::byte* pSource) {
+                Float32 value;
+                std::memcpy(&value, pSource, sizeof(value));
+                return value;
+            }
+
+            static Int Pack16(const Int low, const Int high) {
+                return _mm_or_si128(_mm_and_si128(low, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(high, 16));
+            }
+        };
+#endif
+
+        struct EncodeFunctions {
+            EncodeFunction Scalar;
+            EncodeFunction Sse2;
+            EncodeFunction Avx2;
+        };
+
+        void Encode(const std::span<std::byte> destination, const std::span<const std::byte> source, const UInt32 sourceStride,
+                    const UInt32 sourceSize, const UInt32 encodedSize, const UInt32 vertexCount, EncodeStreamDesc desc,
+                    const VertexCompressionOptions& options, const EncodeFunctions& functions) {
+            if (vertexCount == 0) {
+                return;
+            }
+            if (sourceStride < sourceSize) {
+                throw std::invalid_argument("The source stride is smaller than a source vertex.");
+            }
+            if (sourceStride > MaxSourceStride) {
+                throw std::invalid_argument("The source stride is larger than the input assembler allows.");
+            }
+            if (source.size() < UInt64(vertexCount - 1) * sourceStride + sourceSize) {
+                throw std::invalid_argument("The source is smaller than the vertices.");
+            }
+            if (destination.size() < UInt64(vertexCount) * encodedSize) {
+                throw std::invalid_argument("The destination is smaller than the encoded vertices.");
+            }
+
+            EncodeFunction function = functions.Scalar;
+            switch (std::min(options.MaxSimdLevel, GetSimdLevel())) {
+                case SimdLevel::Scalar:
+                    break;
+                case SimdLevel::SSE2:
+                    function = functions.Sse2;
+                    break;
+                case SimdLevel::AVX2:
+                    function = functions.Avx2;
+                    break;
+            }
+
+            desc.Source = source.data();
+            desc.SourceStride = sourceStride;
+            desc.Destination = destination.data();
+            const UInt32 rangeCount = GetParallelRangeCount(vertexCount, options.ThreadCount, options.MinVerticesPerThread);
+            ParallelFor(vertexCount, rangeCount, [&](const UInt64 begin, const UInt64 end) {
+                function(desc, begin, end);
+            });
+        }
+
+        // Stream formats the decoder knows, as the HLSL types of the input and of the
+        // decoded attribute, and the expression decoding the input.
+        struct StreamDecoding {
+            const char* InputType;
+            const char* DecodedType;
+            const char* Expression;
+        };
+
+        StreamDecoding GetStreamDecoding(const MeshSemantic semantic, const UInt32 format) {
+            switch (semantic) {
+                case MeshSemantic::Position:
+                    if (format == DxgiFormat::R32G32B32Float) {
+                        return {"float3", "float3", "{0}"};
+                    }
+                    if (format == DxgiFormat::R16G16B16A16Unorm) {
+                        return {"float4", "float3", "DecodeQuantizedPosition({0}, positionOffset, positionExtent)"};
+                    }
+                    break;
+                case MeshSemantic::Normal:
+                    if (format == DxgiFormat::R32G32B32Float) {
+                        return {"float3", "float3", "{0}"};
+                    }
+                    if (format == DxgiFormat::R16G16Snorm) {
+                        return {"float2", "float3", "DecodeOctahedral({0})"};
+                    }
+                    break;
+                case MeshSemantic::Tangent:
+                    if (format == DxgiFormat::R32G32B32A32Float) {
+                        return {"float4", "float4", "{0}"};
+                    }
+                    if (format == DxgiFormat::R8G8B8A8Snorm) {
+                        return {"float4", "float4", "float4(DecodeOctahedral({0}.xy), {0}.w)"};
+                    }
+                    break;
+                case MeshSemantic::TexCoord:
+                    if (format == DxgiFormat::R32G32Float || format == DxgiFormat::R16G16Float) {
+                        return {"float2", "float2", "{0}"};
+                    }
+                    break;
+                case MeshSemantic::Color:
+                    if (format == DxgiFormat::R32G32B32A32Float || format == DxgiFormat::R8G8B8A8Unorm) {
+                        return {"float4", "float4", "{0}"};
+                    }
+                    break;
+            }
+
+            throw std::invalid_argument("A stream has a format the vertex decoder does not know.");
+        }
+
+        // HLSL names of the attributes, e.g. TexCoord1.
+        std::string GetAttributeName(const MeshStreamDesc& stream) {
+            std::string name;
+            switch (stream.Semantic) {
+                case MeshSemantic::Position:
+                    name = "Position";
+                    break;
+                case MeshSemantic::Normal:
+                    name = "Normal";
+                    break;
+                case MeshSemantic::Tangent:
+                    name = "Tangent";
+                    break;
+                case MeshSemantic::TexCoord:
+                    name = "TexCoord";
+                    break;
+                case MeshSemantic::Color:
+                    name = "Color";
+                    break;
+            }
+
+            return name + std::to_string(stream.SemanticIndex);
+        }
+
+        std::vector<MeshStreamDesc> GetStreamDescs(const MeshData& mesh) {
+            std::vector<MeshStreamDesc> streams;
+            streams.reserve(mesh.Streams.size());
+            for (const MeshStream& stream : mesh.Streams) {
+                MeshStreamDesc desc = {};
+                desc.Semantic = stream.Semantic;
+                desc.SemanticIndex = stream.SemanticIndex;
+                desc.Format = stream.Format;
+                desc.Stride = stream.Stride;
+                streams.push_back(desc);
+            }
+
+            return streams;
+        }
+
+        constexpr const char* DecodeFunctionsHlsl =
+            "float3 DecodeQuantizedPosition(float4 encoded, float3 offset, float3 extent) {\n"
+            "    return offset + encoded.xyz * extent;\n"
+            "}\n"
+            "\n"
+            "// Unfolds the lower half of the octahedron over the diagonals.\n"
+            "float3 DecodeOctahedral(float2 encoded) {\n"
+            "    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));\n"
+            "    if (direction.z < 0.0f) {\n"
+            "        const float2 signs = float2(encoded.x >= 0.0f ? 1.0f : -1.0f, encoded.y >= 0.0f ? 1.0f : -1.0f);\n"
+            "        direction.xy = (1.0f - abs(encoded.yx)) * signs;\n"
+            "    }\n"
+            "    return normalize(direction);\n"
+            "}\n";
+    }
+
+    void EncodeQuantizedPositions(const std::span<std::byte> destination, const std::span<const std::byte> source,
+                                  const UInt32 sourceStride, const UInt32 vertexCount, const PositionQuantization& quantization,
+                                  const VertexCompressionOptions& options) {
+        EncodeStreamDesc desc;
+        for (UInt32 axis = 0; axis < 3; ++axis) {
+            desc.Offset[axis] = quantization.Offset[axis];
+            desc.InverseStep[axis] = quantization.Extent[axis] > 0.0f ? 65535.0f / quantization.Extent[axis] : 0.0f;
+        }
+
+        EncodeFunctions functions;
+        functions.Scalar = EncodeVertices<ScalarOps, QuantizedPositionKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = EncodeVertices<Sse2Ops, QuantizedPositionKernel>;
+        functions.Avx2 = EncodeQuantizedPositionsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Encode(destination, source, sourceStride, 3 * sizeof(Float32), QuantizedPositionSize, vertexCount, desc, options,
+               functions);
+    }
+
+    void EncodeOctahedralNormals(const std::span<std::byte> destination, const std::span<const std::byte> source,
+                                 const UInt32 sourceStride, const UInt32 vertexCount, const VertexCompressionOptions& options) {
+        EncodeFunctions functions;
+        functions.Scalar = EncodeVertices<ScalarOps, OctahedralNormalKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = EncodeVertices<Sse2Ops, OctahedralNormalKernel>;
+        functions.Avx2 = EncodeOctahedralNormalsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Encode(destination, source, sourceStride, 3 * sizeof(Float32), OctahedralNormalSize, vertexCount, {}, options,
+               functions);
+    }
+
+    void EncodeOctahedralTangents(const std::span<std::byte> destination, const std::span<const std::byte> source,
+                                  const UInt32 sourceStride, const UInt32 vertexCount, const VertexCompressionOptions& options) {
+        EncodeFunctions functions;
+        functions.Scalar = EncodeVertices<ScalarOps, OctahedralTangentKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = EncodeVertices<Sse2Ops, OctahedralTangentKernel>;
+        functions.Avx2 = EncodeOctahedralTangentsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Encode(destination, source, sourceStride, 4 * sizeof(Float32), OctahedralTangentSize, vertexCount, {}, options,
+               functions);
+    }
+
+    void EncodeHalfTexCoords(const std::span<std::byte> destination, const std::span<const std::byte> source,
+                             const UInt32 sourceStride, const UInt32 vertexCount, const VertexCompressionOptions& options) {
+        EncodeFunctions functions;
+        functions.Scalar = EncodeVertices<ScalarOps, HalfTexCoordKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = EncodeVertices<Sse2Ops, HalfTexCoordKernel>;
+        functions.Avx2 = EncodeHalfTexCoordsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Encode(destination, source, sourceStride, 2 * sizeof(Float32), HalfTexCoordSize, vertexCount, {}, options,
+               functions);
+    }
+
+    void EncodeUnormColors(const std::span<std::byte> destination, const std::span<const std::byte> source,
+                           const UInt32 sourceStride, const UInt32 vertexCount, const VertexCompressionOptions& options) {
+        EncodeFunctions functions;
+        functions.Scalar = EncodeVertices<ScalarOps, UnormColorKernel>;
+#ifdef D3D12TESTS_ARCH_X86
+        functions.Sse2 = EncodeVertices<Sse2Ops, UnormColorKernel>;
+        functions.Avx2 = EncodeUnormColorsAvx2;
+#else
+        functions.Sse2 = functions.Avx2 = functions.Scalar;
+#endif
+
+        Encode(destination, source, sourceStride, 4 * sizeof(Float32), UnormColorSize, vertexCount, {}, options,
+               functions);
+    }
+
+    PositionQuantization CompressMeshVertices(MeshData& mesh, const VertexCompressionOptions& options) {
+        ValidateMeshData(mesh);
+
+        const MeshStream* pPositions = mesh.FindStream(MeshSemantic::Position);
+        if (pPositions == nullptr || pPositions->Format != DxgiFormat::R32G32B32Float) {
+            throw std::invalid_argument("The vertex compression needs R32G32B32_FLOAT positions.");
+        }
+
+        // The box covers every vertex rather than the most detailed levels like the bounds.
+        std::fill(std::begin(mesh.BoundsMin), std::end(mesh.BoundsMin), mesh.VertexCount != 0 ? std::numeric_limits<Float32>::max() : 0.0f);
+        std::fill(std::begin(mesh.BoundsMax), std::end(mesh.BoundsMax), mesh.VertexCount != 0 ? std::numeric_limits<Float32>::lowest() : 0.0f);
+        for (UInt32 vertex = 0; vertex < mesh.VertexCount; ++vertex) {
+            Float32 position[3];
+            std::memcpy(position, pPositions->Data.data() + UInt64(vertex) * pPositions->Stride, sizeof(position));
+            for (UInt32 axis = 0; axis < 3; ++axis) {
+                mesh.BoundsMin[axis] = std::min(mesh.BoundsMin[axis], position[axis]);
+                mesh.BoundsMax[axis] = std::max(mesh.BoundsMax[axis], position[axis]);
+            }
+        }
+        const PositionQuantization quantization = GetPositionQuantization(mesh.BoundsMin, mesh.BoundsMax);
+
+        for (MeshStream& stream : mesh.Streams) {
+            UInt32 format = DxgiFormat::Unknown;
+            if (stream.Semantic == MeshSemantic::Position && stream.Format == DxgiFormat::R32G32B32Float) {
+                format = DxgiFormat::R16G16B16A16Unorm;
+            } else if (stream.Semantic == MeshSemantic::Normal && stream.Format == DxgiFormat::R32G32B32Float) {
+                format = DxgiFormat::R16G16Snorm;
+            } else if (stream.Semantic == MeshSemantic::Tangent && stream.Format == DxgiFormat::R32G32B32A32Float) {
+                format = DxgiFormat::R8G8B8A8Snorm;
+            } else if (stream.Semantic == MeshSemantic::TexCoord && stream.Format == DxgiFormat::R32G32Float) {
+                format = DxgiFormat::R16G16Float;
+            } else if (stream.Semantic == MeshSemantic::Color && stream.Format == DxgiFormat::R32G32B32A32Float) {
+                format = DxgiFormat::R8G8B8A8Unorm;
+            } else {
+                continue;
+            }
+
+            const UInt32 stride = GetTextureFormatInfo(format).BlockSize;
+            std::vector<std::byte> data(UInt64(mesh.VertexCount) * stride);
+            switch (stream.Semantic) {
+                case MeshSemantic::Position:
+                    EncodeQuantizedPositions(data, stream.Data, stream.Stride, mesh.VertexCount, quantization, options);
+                    break;
+                case MeshSemantic::Normal:
+                    EncodeOctahedralNormals(data, stream.Data, stream.Stride, mesh.VertexCount, options);
+                    break;
+                case MeshSemantic::Tangent:
+                    EncodeOctahedralTangents(data, stream.Data, stream.Stride, mesh.VertexCount, options);
+                    break;
+                case MeshSemantic::TexCoord:
+                    EncodeHalfTexCoords(data, stream.Data, stream.Stride, mesh.VertexCount, options);
+                    break;
+                case MeshSemantic::Color:
+                    EncodeUnormColors(data, stream.Data, stream.Stride, mesh.VertexCount, options);
+                    break;
+            }
+
+            stream.Format = format;
+            stream.Stride = stride;
+            stream.Data = std::move(data);
+        }
+
+        return quantization;
+    }
+
+    std::vector<PipelineInputElement> GetMeshInputLayout(const std::span<const MeshStreamDesc> streams) {
+        std::vector<PipelineInputElement> layout;
+        layout.reserve(streams.size());
+        for (UInt32 slot = 0; slot < streams.size(); ++slot) {
+            PipelineInputElement& element = layout.emplace_back();
+            element.SemanticName = GetMeshSemanticName(streams[slot].Semantic);
+            element.SemanticIndex = streams[slot].SemanticIndex;
+            element.Format = streams[slot].Format;
+            element.InputSlot = slot;
+        }
+
+        return layout;
+    }
+
+    std::vector<PipelineInputElement> GetMeshInputLayout(const MeshData& mesh) {
+        return GetMeshInputLayout(GetStreamDescs(mesh));
+    }
+
+    std::string GenerateVertexDecodeHlsl(const std::span<const MeshStreamDesc> streams) {
+        std::string input = "struct MeshVertexInput {\n";
+        std::string vertex = "struct MeshVertex {\n";
+        std::string decode = "MeshVertex DecodeMeshVertex(MeshVertexInput input, float3 positionOffset, float3 positionExtent) {\n"
+                             "    MeshVertex vertex;\n";
+        for (const MeshStreamDesc& stream : streams) {
+            const StreamDecoding decoding = GetStreamDecoding(stream.Semantic, stream.Format);
+            const std::string name = GetAttributeName(stream);
+            input += std::string("    ") + decoding.InputType + ' ' + name + " : " + GetMeshSemanticName(stream.Semantic) +
+                std::to_string(stream.SemanticIndex) + ";\n";
+            vertex += std::string("    ") + decoding.DecodedType + ' ' + name + ";\n";
+
+            std::string expression = decoding.Expression;
+            for (std::size_t position = expression.find("{0}"); position != std::string::npos; position = expression.find("{0}")) {
+                expression.replace(position, 3, "input." + name);
+            }
+            decode += "    vertex." + name + " = " + expression + ";\n";
+        }
+
+        return "// Decoding of the mesh streams, matching the input layout of GetMeshInputLayout.\n" + input + "};\n\n" +
+            vertex + "};\n\n" + DecodeFunctionsHlsl + '\n' + decode + "    return vertex;\n}\n";
+    }
+
+    std::string GenerateVertexDecodeHlsl(const MeshData& mesh) {
+        return GenerateVertexDecodeHlsl(GetStreamDescs(mesh));
+    }
+}
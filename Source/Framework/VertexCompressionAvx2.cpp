@@ -0,0 +1,156 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/VertexCompression.hpp"
+
+#ifdef D3D12TESTS_ARCH_X86
+
+// The standard headers are included before the AVX2 region, so that their inline functions
+// are not compiled for it and then picked by the linker for the other files.
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include <immintrin.h>
+
+// Only the kernels of this file are compiled for AVX2; they are only called once the CPU
+// support has been checked. MSVC does not need a flag to use the intrinsics.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "VertexCompressionKernels.inl"
+
+namespace D3D12Tests::VertexCompressionDetail {
+    namespace {
+        struct Avx2Ops {
+            static constexpr UInt32 Width = 8;
+
+            using Float = __m256;
+            using Int = __m256i;
+            using Mask = __m256;
+
+            static Float Set(const Float32 value) { return _mm256_set1_ps(value); }
+            static Int SetInt(const UInt32 value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+
+            static Float Add(const Float a, const Float b) { return _mm256_add_ps(a, b); }
+            static Float Sub(const Float a, const Float b) { return _mm256_sub_ps(a, b); }
+            static Float Mul(const Float a, const Float b) { return _mm256_mul_ps(a, b); }
+            static Float Div(const Float a, const Float b) { return _mm256_div_ps(a, b); }
+            static Float Min(const Float a, const Float b) { return _mm256_min_ps(a, b); }
+            static Float Max(const Float a, const Float b) { return _mm256_max_ps(a, b); }
+            static Float Abs(const Float value) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value); }
+            static Float SignNotZero(const Float value) {
+                return _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(_mm256_set1_ps(-0.0f), value));
+            }
+
+            static Int RoundToInt(const Float value) { return _mm256_cvtps_epi32(value); }
+
+            static Int IntAnd(const Int a, const Int b) { return _mm256_and_si256(a, b); }
+            static Int IntOr(const Int a, const Int b) { return _mm256_or_si256(a, b); }
+            template <int Shift> static Int ShiftLeft(const Int value) { return _mm256_slli_epi32(value, Shift); }
+
+            static Mask Less(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static Mask Greater(const Float a, const Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static Float Select(const Mask mask, const Float a, const Float b) { return _mm256_blendv_ps(b, a, mask); }
+
+            // The integer version of ScalarOps::FloatToHalf, which F16C would not match for NaN
+            // and which does not need the F16C check.
+            static Int FloatToHalf(const Float value) {
+                const __m256 signMask = _mm256_set1_ps(-0.0f);
+                const __m256 sign = _mm256_and_ps(signMask, value);
+                const __m256 magnitude = _mm256_xor_ps(value, sign);
+                const __m256i magnitudeBits = _mm256_castps_si256(magnitude);
+
+                const __m256i isNan = _mm256_castps_si256(_mm256_cmp_ps(magnitude, magnitude, _CMP_UNORD_Q));
+                const __m256i isRegular = _mm256_cmpgt_epi32(_mm256_set1_epi32(HalfOverflowBits), magnitudeBits);
+                const __m256i special = _mm256_or_si256(_mm256_and_si256(isNan, _mm256_set1_epi32(0x200)), _mm256_set1_epi32(0x7C00));
+                const __m256i isSubnormal = _mm256_cmpgt_epi32(_mm256_set1_epi32(HalfMinNormalBits), magnitudeBits);
+
+                const __m256i magic = _mm256_set1_epi32(HalfSubnormalMagicBits);
+                const __m256i subnormal = _mm256_sub_epi32(
+                    _mm256_castps_si256(_mm256_add_ps(magnitude, _mm256_castsi256_ps(magic))), magic);
+
+                const __m256i mantissaOdd = _mm256_and_si256(_mm256_srli_epi32(magnitudeBits, 13), _mm256_set1_epi32(1));
+                const __m256i normal = _mm256_srli_epi32(
+                    _mm256_add_epi32(_mm256_add_epi32(magnitudeBits, _mm256_set1_epi32(HalfNormalBias)), mantissaOdd), 13);
+
+                const __m256i finite = _mm256_blendv_epi8(normal, subnormal, isSubnormal);
+                const __m256i half = _mm256_blendv_epi8(special, finite, isRegular);
+                return _mm256_or_si256(half, _mm256_srli_epi32(_mm256_castps_si256(sign), 16));
+            }
+
+            // Built from scalar loads like Sse2Ops::Load, which is faster than a gather here.
+            static Float Load(const std::byte* pSource, const UInt64 stride) {
+                return _mm256_setr_ps(LoadLane(pSource), LoadLane(pSource + stride), LoadLane(pSource + 2 * stride),
+                                      LoadLane(pSource + 3 * stride), LoadLane(pSource + 4 * stride),
+                                      LoadLane(pSource + 5 * stride), LoadLane(pSource + 6 * stride),
+                                      LoadLane(pSource + 7 * stride));
+            }
+
+            static void Store16x2(std::byte* pDestination, const Int x, const Int y) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination), Pack16(x, y));
+            }
+            static void Store16x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                // The unpacks work within the 128-bit halves: vertices 0, 1, 4, 5 and 2, 3, 6, 7.
+                const __m256i xy = Pack16(x, y);
+                const __m256i zw = Pack16(z, w);
+                const __m256i low = _mm256_unpacklo_epi32(xy, zw);
+                const __m256i high = _mm256_unpackhi_epi32(xy, zw);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination), _mm256_permute2x128_si256(low, high, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + 32), _mm256_permute2x128_si256(low, high, 0x31));
+            }
+            static void Store8x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                const __m256i mask = _mm256_set1_epi32(0xFF);
+                const __m256i packed = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_and_si256(x, mask), _mm256_slli_epi32(_mm256_and_si256(y, mask), 8)),
+                    _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(z, mask), 16), _mm256_slli_epi32(w, 24)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination), packed);
+            }
+
+        private:
+            static Float32 LoadLane(const std::byte* pSource) {
+                Float32 value;
+                std::memcpy(&value, pSource, sizeof(value));
+                return value;
+            }
+
+            static Int Pack16(const Int low, const Int high) {
+                return _mm256_or_si256(_mm256_and_si256(low, _mm256_set1_epi32(0xFFFF)), _mm256_slli_epi32(high, 16));
+            }
+        };
+    }
+
+    void EncodeQuantizedPositionsAvx2(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+        EncodeVertices<Avx2Ops, QuantizedPositionKernel>(desc, begin, end);
+    }
+
+    void EncodeOctahedralNormalsAvx2(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+        EncodeVertices<Avx2Ops, OctahedralNormalKernel>(desc, begin, end);
+    }
+
+    void EncodeOctahedralTangentsAvx2(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+        EncodeVertices<Avx2Ops, OctahedralTangentKernel>(desc, begin, end);
+    }
+
+    void EncodeHalfTexCoordsAvx2(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+        EncodeVertices<Avx2Ops, HalfTexCoordKernel>(desc, begin, end);
+    }
+
+    void EncodeUnormColorsAvx2(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+        EncodeVertices<Avx2Ops, UnormColorKernel>(desc, begin, end);
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+// Encoders of the compact vertex formats, written once against a set of vector operations
+// like the procedural texture kernels (ScalarOps here, Sse2Ops and Avx2Ops in the files
+// including it). The vector operations round like the scalar ones, so that every level
+// writes the same bits.
+
+#include "Framework/VertexCompression.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace D3D12Tests::VertexCompressionDetail {
+    struct EncodeStreamDesc {
+        const std::byte* Source = nullptr;
+        UInt64 SourceStride = 0;
+        std::byte* Destination = nullptr;
+        // Positions only: encoded = (position - Offset) * InverseStep, zero for flat axes.
+        Float32 Offset[3] = {};
+        Float32 InverseStep[3] = {};
+    };
+
+    using EncodeFunction = void(*)(const EncodeStreamDesc&, UInt64, UInt64);
+
+#ifdef D3D12TESTS_ARCH_X86
+    // Defined in VertexCompressionAvx2.cpp.
+    void EncodeQuantizedPositionsAvx2(const EncodeStreamDesc& desc, UInt64 begin, UInt64 end);
+    void EncodeOctahedralNormalsAvx2(const EncodeStreamDesc& desc, UInt64 begin, UInt64 end);
+    void EncodeOctahedralTangentsAvx2(const EncodeStreamDesc& desc, UInt64 begin, UInt64 end);
+    void EncodeHalfTexCoordsAvx2(const EncodeStreamDesc& desc, UInt64 begin, UInt64 end);
+    void EncodeUnormColorsAvx2(const EncodeStreamDesc& desc, UInt64 begin, UInt64 end);
+#endif
+
+    namespace {
+        // Float to half constants, shared by the scalar and the vector conversions.
+        constexpr UInt32 HalfOverflowBits = (127 + 16) << 23;
+        constexpr UInt32 HalfMinNormalBits = (127 - 14) << 23;
+        constexpr UInt32 HalfSubnormalMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+        constexpr UInt32 HalfNormalBias = 0xFFF - ((127 - 15) << 23);
+
+        struct ScalarOps {
+            static constexpr UInt32 Width = 1;
+
+            using Float = Float32;
+            using Int = UInt32;
+            using Mask = bool;
+
+            static Float Set(const Float32 value) { return value; }
+            static Int SetInt(const UInt32 value) { return value; }
+
+            static Float Add(const Float a, const Float b) { return a + b; }
+            static Float Sub(const Float a, const Float b) { return a - b; }
+            static Float Mul(const Float a, const Float b) { return a * b; }
+            static Float Div(const Float a, const Float b) { return a / b; }
+            // The second value wins over NaN, like the SSE instructions.
+            static Float Min(const Float a, const Float b) { return a < b ? a : b; }
+            static Float Max(const Float a, const Float b) { return a > b ? a : b; }
+            static Float Abs(const Float value) { return std::abs(value); }
+            // 1 or -1 from the sign bit, so -1 for -0.
+            static Float SignNotZero(const Float value) { return std::signbit(value) ? -1.0f : 1.0f; }
+
+            // Rounds to nearest even, the default rounding mode of the vector conversions.
+            static Int RoundToInt(const Float value) {
+                return static_cast<UInt32>(static_cast<Int32>(std::nearbyint(value)));
+            }
+
+            static Int IntAnd(const Int a, const Int b) { return a & b; }
+            static Int IntOr(const Int a, const Int b) { return a | b; }
+            template <int Shift> static Int ShiftLeft(const Int value) { return value << Shift; }
+
+            static Mask Less(const Float a, const Float b) { return a < b; }
+            static Mask Greater(const Float a, const Float b) { return a > b; }
+            static Float Select(const Mask mask, const Float a, const Float b) { return mask ? a : b; }
+
+            // Rounds to nearest even, with NaN kept quiet and overflows going to infinity.
+            static Int FloatToHalf(const Float value) {
+                const UInt32 bits = std::bit_cast<UInt32>(value);
+                const UInt32 sign = bits & 0x80000000u;
+                const UInt32 magnitude = bits ^ sign;
+
+                UInt32 half;
+                if (magnitude >= HalfOverflowBits) {
+                    half = magnitude > 0x7F800000u ? 0x7E00 : 0x7C00;
+                } else if (magnitude < HalfMinNormalBits) {
+                    // Adding the magic value rounds the mantissa at the half subnormal precision.
+                    const Float32 rounded = std::bit_cast<Float32>(magnitude) + std::bit_cast<Float32>(HalfSubnormalMagicBits);
+                    half = std::bit_cast<UInt32>(rounded) - HalfSubnormalMagicBits;
+                } else {
+                    const UInt32 mantissaOdd = (magnitude >> 13) & 1;
+                    half = (magnitude + HalfNormalBias + mantissaOdd) >> 13;
+                }
+
+                return half | sign >> 16;
+            }
+
+            // Loads a float of Width vertices, stride bytes apart.
+            static Float Load(const std::byte* pSource, [[maybe_unused]] const UInt64 stride) {
+                Float32 value;
+                std::memcpy(&value, pSource, sizeof(value));
+                return value;
+            }
+
+            // Stores the low bits of each value, interleaved per vertex.
+            static void Store16x2(std::byte* pDestination, const Int x, const Int y) {
+                const UInt32 packed = (x & 0xFFFF) | y << 16;
+                std::memcpy(pDestination, &packed, sizeof(packed));
+            }
+            static void Store16x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                Store16x2(pDestination, x, y);
+                Store16x2(pDestination + 4, z, w);
+            }
+            static void Store8x4(std::byte* pDestination, const Int x, const Int y, const Int z, const Int w) {
+                const UInt32 packed = (x & 0xFF) | (y & 0xFF) << 8 | (z & 0xFF) << 16 | w << 24;
+                std::memcpy(pDestination, &packed, sizeof(packed));
+            }
+        };
+
+        template <class TOps>
+        typename TOps::Int EncodeNormalized(const typename TOps::Float value, const Float32 minValue, const Float32 maxValue,
+                                            const Float32 scale) {
+            const typename TOps::Float clamped = TOps::Min(TOps::Max(value, TOps::Set(minValue)), TOps::Set(maxValue));
+            return TOps::RoundToInt(TOps::Mul(clamped, TOps::Set(scale)));
+        }
+
+        // Projects the direction on the octahedron |x| + |y| + |z| = 1, then folds its lower
+        // half over the diagonals of the upper one.
+        template <class TOps>
+        void EncodeOctahedral(const std::byte* pSource, const UInt64 stride, const Float32 scale,
+                              typename TOps::Int& encodedX, typename TOps::Int& encodedY) {
+            using Float = typename TOps::Float;
+
+            const Float x = TOps::Load(pSource, stride);
+            const Float y = TOps::Load(pSource + sizeof(Float32), stride);
+            const Float z = TOps::Load(pSource + 2 * sizeof(Float32), stride);
+
+            // Zero vectors end up at the center, which decodes to +Z.
+            const Float length = TOps::Add(TOps::Add(TOps::Abs(x), TOps::Abs(y)), TOps::Abs(z));
+            const Float inverseLength = TOps::Select(TOps::Greater(length, TOps::Set(0.0f)),
+                                                     TOps::Div(TOps::Set(1.0f), length), TOps::Set(0.0f));
+            const Float octX = TOps::Mul(x, inverseLength);
+            const Float octY = TOps::Mul(y, inverseLength);
+
+            const Float foldedX = TOps::Mul(TOps::Sub(TOps::Set(1.0f), TOps::Abs(octY)), TOps::SignNotZero(octX));
+            const Float foldedY = TOps::Mul(TOps::Sub(TOps::Set(1.0f), TOps::Abs(octX)), TOps::SignNotZero(octY));
+            const auto lower = TOps::Less(z, TOps::Set(0.0f));
+
+            encodedX = EncodeNormalized<TOps>(TOps::Select(lower, foldedX, octX), -1.0f, 1.0f, scale);
+            encodedY = EncodeNormalized<TOps>(TOps::Select(lower, foldedY, octY), -1.0f, 1.0f, scale);
+        }
+
+        struct QuantizedPositionKernel {
+            static constexpr UInt32 EncodedSize = QuantizedPositionSize;
+
+            template <class TOps>
+            static void Encode(const EncodeStreamDesc& desc, const std::byte* pSource, std::byte* pDestination) {
+                typename TOps::Int encoded[3];
+                for (UInt32 axis = 0; axis < 3; ++axis) {
+                    const typename TOps::Float value = TOps::Load(pSource + axis * sizeof(Float32), desc.SourceStride);
+                    const typename TOps::Float steps = TOps::Mul(TOps::Sub(value, TOps::Set(desc.Offset[axis])),
+                                                                 TOps::Set(desc.InverseStep[axis]));
+                    encoded[axis] = EncodeNormalized<TOps>(steps, 0.0f, 65535.0f, 1.0f);
+                }
+
+                TOps::Store16x4(pDestination, encoded[0], encoded[1], encoded[2], TOps::SetInt(0));
+            }
+        };
+
+        struct OctahedralNormalKernel {
+            static constexpr UInt32 EncodedSize = OctahedralNormalSize;
+
+            template <class TOps>
+            static void Encode(const EncodeStreamDesc& desc, const std::byte* pSource, std::byte* pDestination) {
+                typename TOps::Int x, y;
+                EncodeOctahedral<TOps>(pSource, desc.SourceStride, 32767.0f, x, y);
+                TOps::Store16x2(pDestination, x, y);
+            }
+        };
+
+        struct OctahedralTangentKernel {
+            static constexpr UInt32 EncodedSize = OctahedralTangentSize;
+
+            template <class TOps>
+            static void Encode(const EncodeStreamDesc& desc, const std::byte* pSource, std::byte* pDestination) {
+                typename TOps::Int x, y;
+                EncodeOctahedral<TOps>(pSource, desc.SourceStride, 127.0f, x, y);
+
+                const typename TOps::Float handedness = TOps::Load(pSource + 3 * sizeof(Float32), desc.SourceStride);
+                const typename TOps::Float sign = TOps::Select(TOps::Less(handedness, TOps::Set(0.0f)), TOps::Set(-127.0f),
+                                                               TOps::Set(127.0f));
+                TOps::Store8x4(pDestination, x, y, TOps::SetInt(0), TOps::RoundToInt(sign));
+            }
+        };
+
+        struct HalfTexCoordKernel {
+            static constexpr UInt32 EncodedSize = HalfTexCoordSize;
+
+            template <class TOps>
+            static void Encode(const EncodeStreamDesc& desc, const std::byte* pSource, std::byte* pDestination) {
+                TOps::Store16x2(pDestination, TOps::FloatToHalf(TOps::Load(pSource, desc.SourceStride)),
+                                TOps::FloatToHalf(TOps::Load(pSource + sizeof(Float32), desc.SourceStride)));
+            }
+        };
+
+        struct UnormColorKernel {
+            static constexpr UInt32 EncodedSize = UnormColorSize;
+
+            template <class TOps>
+            static void Encode(const EncodeStreamDesc& desc, const std::byte* pSource, std::byte* pDestination) {
+                typename TOps::Int encoded[4];
+                for (UInt32 channel = 0; channel < 4; ++channel) {
+                    encoded[channel] = EncodeNormalized<TOps>(TOps::Load(pSource + channel * sizeof(Float32), desc.SourceStride),
+                                                              0.0f, 1.0f, 255.0f);
+                }
+
+                TOps::Store8x4(pDestination, encoded[0], encoded[1], encoded[2], encoded[3]);
+            }
+        };
+
+        // Whole vectors of vertices, then the remaining ones one at a time.
+        template <class TOps, class TKernel>
+        void EncodeVertices(const EncodeStreamDesc& desc, const UInt64 begin, const UInt64 end) {
+            UInt64 vertex = begin;
+            for (; vertex + TOps::Width <= end; vertex += TOps::Width) {
+                TKernel::template Encode<TOps>(desc, desc.Source + vertex * desc.SourceStride,
+                                               desc.Destination + vertex * TKernel::EncodedSize);
+            }
+            for (; vertex < end; ++vertex) {
+                TKernel::template Encode<ScalarOps>(desc, desc.Source + vertex * desc.SourceStride,
+                                                    desc.Destination + vertex * TKernel::EncodedSize);
+            }
+        }
+    }
+}
@@ -4,6 +4,10 @@
 
 #include "Framework/Win32ApplicationBase.hpp"
 
+#include "Framework/FrameLoop.hpp"
+
+#include <timeapi.h>
+
 namespace D3D12Tests {
 	HWND Win32ApplicationBase::m_HWnd = nullptr;
 
@@ -47,18 +51,40 @@ namespace D3D12Tests {
 
 		ShowWindow(m_HWnd, nCmdShow);
 
-		// Main application loop.
+		// Sleeps of the frame limiter need a 1 ms timer resolution instead of the default 15.6 ms.
+		timeBeginPeriod(1);
+
+		// Main application loop: drain the message queue, then run a frame paced by the
+		// frame loop. Nothing is rendered while minimized, the thread sleeps until a message
+		// arrives instead.
+		FrameLoop frameLoop(*pApplication);
 		MSG msg = {};
 		while (msg.message != WM_QUIT) {
-			// Process any messages in the queue.
 			if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
 				TranslateMessage(&msg);
 				DispatchMessage(&msg);
+				continue;
 			}
+
+			if (IsIconic(m_HWnd)) {
+				WaitMessage();
+				continue;
+			}
+
+			frameLoop.RunFrame();
 		}
 
+		timeEndPeriod(1);
+
 		pApplication->OnDestroy();
 
+#ifdef D3D12TESTS_PROFILING
+		// Dump what the markers recorded, the trace can be opened in chrome://tracing.
+		const ProfileCapture capture = CaptureProfile();
+		SaveChromeTrace(capture, "ProfileTrace.json");
+		OutputDebugStringA(FormatProfileSummary(SummarizeProfileFrames(capture)).c_str());
+#endif
+
 		// Return this part of the WM_QUIT message to windows.
 		return static_cast<char>(msg.wParam);
 	}
@@ -87,13 +113,6 @@ namespace D3D12Tests {
 			}
 			return 0;
 
-		case WM_PAINT:
-			if (application) {
-				application->OnUpdate();
-				application->OnRender();
-			}
-			return 0;
-
 		case WM_DESTROY:
 			PostQuitMessage(0);
 			return 0;
@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKTESTS_MANUALGPUTIMELINE_HPP
+#define D3D12TESTS_FRAMEWORKTESTS_MANUALGPUTIMELINE_HPP
+
+#include "Framework/SimulatedGpuTimeline.hpp"
+
+#include <span>
+#include <vector>
+
+namespace FrameworkTests {
+    // A SimulatedGpuTimeline whose submissions never complete on their own: the GPU only
+    // progresses when the test completes values, or when the CPU waits on one, which then
+    // completes at once. The values waited on are recorded, so that tests see exactly what
+    // the scheduling code blocks on. Single-threaded.
+    class ManualGpuTimeline final : public D3D12Tests::GpuTimeline {
+    public:
+        ManualGpuTimeline();
+        ~ManualGpuTimeline() override = default;
+
+        ManualGpuTimeline(const ManualGpuTimeline&) = delete;
+        ManualGpuTimeline(ManualGpuTimeline&&) = delete;
+
+        ManualGpuTimeline& operator=(const ManualGpuTimeline&) = delete;
+        ManualGpuTimeline& operator=(ManualGpuTimeline&&) = delete;
+
+        D3D12Tests::UInt64 Signal() override;
+        D3D12Tests::UInt64 GetCompletedValue() override;
+        // Throws std::logic_error for a value never signaled, which would hang a real fence.
+        void WaitForValue(D3D12Tests::UInt64 value) override;
+
+        inline void CompleteUpTo(D3D12Tests::UInt64 value);
+
+        inline std::span<const D3D12Tests::UInt64> GetWaits() const;
+        inline D3D12Tests::UInt64 GetCompletedQueryCount() const;
+
+    private:
+        D3D12Tests::SimulatedGpuTimeline m_Simulated;
+        std::vector<D3D12Tests::UInt64> m_Waits;
+        D3D12Tests::UInt64 m_CompletedQueryCount;
+    };
+}
+
+#include "FrameworkTests/ManualGpuTimeline.inl"
+
+#endif // D3D12TESTS_FRAMEWORKTESTS_MANUALGPUTIMELINE_HPP
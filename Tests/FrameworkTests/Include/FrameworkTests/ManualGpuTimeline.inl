@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace FrameworkTests {
+    inline void ManualGpuTimeline::CompleteUpTo(const D3D12Tests::UInt64 value) {
+        m_Simulated.CompleteUpTo(value);
+    }
+
+    inline std::span<const D3D12Tests::UInt64> ManualGpuTimeline::GetWaits() const {
+        return m_Waits;
+    }
+
+    inline D3D12Tests::UInt64 ManualGpuTimeline::GetCompletedQueryCount() const {
+        return m_CompletedQueryCount;
+    }
+}
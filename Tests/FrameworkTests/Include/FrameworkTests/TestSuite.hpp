@@ -0,0 +1,76 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKTESTS_TESTSUITE_HPP
+#define D3D12TESTS_FRAMEWORKTESTS_TESTSUITE_HPP
+
+#include "Framework/Types.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FrameworkTests {
+    struct TestOptions {
+        // Prefixes of the names of the tests to run, all of them when empty.
+        std::vector<std::string> Filters;
+    };
+
+    // Thrown by a failed check, ending the test.
+    class TestFailure : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    using TestBody = std::function<void()>;
+
+    class TestSuite {
+    public:
+        explicit TestSuite(TestOptions options);
+        ~TestSuite() = default;
+
+        TestSuite(const TestSuite&) = delete;
+        TestSuite(TestSuite&&) = delete;
+
+        TestSuite& operator=(const TestSuite&) = delete;
+        TestSuite& operator=(TestSuite&&) = delete;
+
+        // Whether the filters select the test, or some of the tests whose names start with
+        // the given group name.
+        bool IsEnabled(std::string_view name) const;
+
+        // Runs the body if the filters select it. The test fails on the first check failing
+        // or on any exception escaping the body, and the next one runs.
+        void Run(std::string name, const TestBody& body);
+
+        inline D3D12Tests::UInt32 GetRunCount() const;
+        inline D3D12Tests::UInt32 GetFailureCount() const;
+
+    private:
+        TestOptions m_Options;
+        D3D12Tests::UInt32 m_RunCount;
+        D3D12Tests::UInt32 m_FailureCount;
+    };
+
+    // Throws a TestFailure locating the caller when the condition does not hold.
+    void Check(bool condition, std::string_view description,
+               std::source_location location = std::source_location::current());
+    // Fails unless calling the function throws a TException.
+    template <class TException, class TFunction>
+    void CheckThrows(TFunction&& function, std::string_view description,
+                     std::source_location location = std::source_location::current());
+
+    // Directory for the files written by the tests, in the temporary directory.
+    std::filesystem::path GetScratchDirectory();
+}
+
+#include "FrameworkTests/TestSuite.inl"
+
+#endif // D3D12TESTS_FRAMEWORKTESTS_TESTSUITE_HPP
@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace FrameworkTests {
+    inline D3D12Tests::UInt32 TestSuite::GetRunCount() const {
+        return m_RunCount;
+    }
+
+    inline D3D12Tests::UInt32 TestSuite::GetFailureCount() const {
+        return m_FailureCount;
+    }
+
+    template <class TException, class TFunction>
+    void CheckThrows(TFunction&& function, const std::string_view description, const std::source_location location) {
+        bool thrown = false;
+        try {
+            function();
+        } catch (const TException&) {
+            thrown = true;
+        }
+
+        Check(thrown, description, location);
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_FRAMEWORKTESTS_TESTS_HPP
+#define D3D12TESTS_FRAMEWORKTESTS_TESTS_HPP
+
+#include "FrameworkTests/TestSuite.hpp"
+
+namespace FrameworkTests {
+    // Test groups, named after their prefix.
+
+    // FrameRing.
+    void RunFrameRingTests(TestSuite& suite);
+    // RingAllocator, TimelineRingAllocator, UploadRing.
+    void RunRingAllocatorTests(TestSuite& suite);
+    // RangeAllocator.
+    void RunRangeAllocatorTests(TestSuite& suite);
+    // The allocation policy of D3D12DescriptorRing, over a simulated heap.
+    void RunDescriptorRingTests(TestSuite& suite);
+    // CommandContextPool.
+    void RunCommandContextPoolTests(TestSuite& suite);
+    // ResourceState, ResourceStateTable, ResourceStateTracker.
+    void RunResourceStateTests(TestSuite& suite);
+    // ShaderCache.
+    void RunShaderCacheTests(TestSuite& suite);
+    // MappedFile.
+    void RunMappedFileTests(TestSuite& suite);
+    // GraphicsPipelineDesc hashing, PipelineRegistry, PipelineManifest.
+    void RunPipelineRegistryTests(TestSuite& suite);
+    // ProceduralTexture.
+    void RunProceduralTextureTests(TestSuite& suite);
+    // DdsFile.
+    void RunDdsFileTests(TestSuite& suite);
+    // SubresourceCopy.
+    void RunSubresourceCopyTests(TestSuite& suite);
+    // WorkStealingDeque, JobSystem.
+    void RunJobSystemTests(TestSuite& suite);
+    // Profiler.
+    void RunProfilerTests(TestSuite& suite);
+    // NullDevice.
+    void RunNullDeviceTests(TestSuite& suite);
+    // FrameLimiter, FixedTimestep.
+    void RunFramePacingTests(TestSuite& suite);
+    // MeshFile, SaveMeshFile, ParseObjMesh.
+    void RunMeshFileTests(TestSuite& suite);
+    // MeshOptimizer.
+    void RunMeshOptimizerTests(TestSuite& suite);
+    // VertexCompression encoders and decoders.
+    void RunVertexCompressionTests(TestSuite& suite);
+    // MeshletBuilder.
+    void RunMeshletBuilderTests(TestSuite& suite);
+    // Culling.
+    void RunCullingTests(TestSuite& suite);
+    // DrawQueue.
+    void RunDrawQueueTests(TestSuite& suite);
+    // CommandRecorder.
+    void RunCommandRecorderTests(TestSuite& suite);
+    // ConstantBufferAllocator, ConstantBufferContext.
+    void RunConstantBufferAllocatorTests(TestSuite& suite);
+    // BindlessRegistry.
+    void RunBindlessRegistryTests(TestSuite& suite);
+    // RenderGraph.
+    void RunRenderGraphTests(TestSuite& suite);
+}
+
+#endif // D3D12TESTS_FRAMEWORKTESTS_TESTS_HPP
@@ -0,0 +1,199 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/BindlessRegistry.hpp"
+
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    void RunBindlessRegistryTests(TestSuite& suite) {
+        suite.Run("BindlessRegistry/Handles", [] {
+            const BindlessHandle handle = MakeBindlessHandle(MaxBindlessSlots - 1, MaxBindlessGeneration);
+            Check(GetBindlessIndex(handle) == MaxBindlessSlots - 1 && GetBindlessGeneration(handle) == MaxBindlessGeneration,
+                  "the index and the generation are packed in 32 bits");
+
+            ManualGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 4);
+            Check(!registry.IsValid(InvalidBindlessHandle), "the zero handle is never valid");
+            for (UInt32 i = 0; i < 4; ++i) {
+                const BindlessHandle allocated = registry.Allocate();
+                Check(registry.Resolve(allocated) == i && GetBindlessGeneration(allocated) == 1,
+                      "slots are handed out in order, at generation 1");
+            }
+            Check(registry.GetLiveCount() == 4 && registry.GetHighWaterMark() == 4, "the counts follow");
+            CheckThrows<std::length_error>([&] { registry.Allocate(); }, "a full registry without pending slots throws");
+            Check(!registry.IsValid(MakeBindlessHandle(7, 1)), "a handle past the capacity is invalid");
+
+            CheckThrows<std::invalid_argument>([&] { BindlessRegistry invalid(timeline, 0); }, "an empty registry is rejected");
+            CheckThrows<std::invalid_argument>([&] { BindlessRegistry invalid(timeline, MaxBindlessSlots + 1); },
+                                               "a capacity past the index bits is rejected");
+        });
+
+        suite.Run("BindlessRegistry/StaleHandles", [] {
+            ManualGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 2);
+            const BindlessHandle first = registry.Allocate();
+            const BindlessHandle second = registry.Allocate();
+
+            registry.Free(first);
+            Check(!registry.IsValid(first) && registry.IsValid(second), "a freed handle is stale at once");
+            CheckThrows<std::invalid_argument>([&] { registry.Resolve(first); }, "a stale handle does not resolve");
+            CheckThrows<std::invalid_argument>([&] { registry.Free(first); }, "a stale handle cannot be freed twice");
+
+            // The range is full and the slot was freed after the last signal: waiting would hang.
+            CheckThrows<std::length_error>([&] { registry.Allocate(); }, "a slot freed since the last signal is not waited for");
+            Check(timeline.GetWaits().empty(), "nothing was waited for");
+
+            timeline.Signal();
+            const BindlessHandle reused = registry.Allocate();
+            Check(GetBindlessIndex(reused) == GetBindlessIndex(first) && GetBindlessGeneration(reused) == 2,
+                  "the slot comes back with the next generation");
+            Check(timeline.GetWaits().size() == 1 && timeline.GetWaits()[0] == 1, "after waiting for its fence");
+            Check(!registry.IsValid(first) && registry.IsValid(reused), "the old handle stays stale");
+            Check(GetBindlessGeneration(first) != GetBindlessGeneration(reused) && first != reused,
+                  "the handles of the slot differ");
+        });
+
+        suite.Run("BindlessRegistry/RecyclesAfterFence", [] {
+            // Recycling does not wait: a slot still in flight is not reused while the range has
+            // room, the range grows instead.
+            ManualGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 8);
+            const BindlessHandle freed = registry.Allocate();
+            registry.Free(freed);
+            timeline.Signal();
+
+            const BindlessHandle other = registry.Allocate();
+            Check(GetBindlessIndex(other) == 1 && registry.GetPendingCount() == 1,
+                  "a slot whose fence is pending is not reused");
+
+            timeline.CompleteUpTo(1);
+            timeline.Signal();
+            const BindlessHandle recycled = registry.Allocate();
+            Check(GetBindlessIndex(recycled) == GetBindlessIndex(freed) && registry.GetPendingCount() == 0,
+                  "it is reused once its fence completed");
+            Check(registry.GetHighWaterMark() == 2 && timeline.GetWaits().empty(), "the range stays small, without waits");
+        });
+
+        suite.Run("BindlessRegistry/QueriesOncePerSignal", [] {
+            // Querying the fence is not free on real hardware: with slots pending, the
+            // completed value is read once per signal, however many allocations there are.
+            ManualGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 16);
+            registry.Allocate();
+            Check(timeline.GetCompletedQueryCount() == 0, "nothing pending, nothing to query");
+
+            registry.Free(MakeBindlessHandle(0, 1));
+            for (UInt32 i = 0; i < 3; ++i) {
+                registry.Allocate();
+            }
+            Check(timeline.GetCompletedQueryCount() == 0, "a slot freed after the last signal is not queried for");
+
+            timeline.Signal();
+            for (UInt32 i = 0; i < 3; ++i) {
+                registry.Allocate();
+            }
+            Check(timeline.GetCompletedQueryCount() == 1, "the fence is queried once after a signal");
+
+            timeline.CompleteUpTo(1);
+            const BindlessHandle late = registry.Allocate();
+            Check(GetBindlessIndex(late) != 0 && timeline.GetCompletedQueryCount() == 1,
+                  "a completion seen after the query waits for the next signal");
+
+            timeline.Signal();
+            const BindlessHandle recycled = registry.Allocate();
+            Check(GetBindlessIndex(recycled) == 0 && timeline.GetCompletedQueryCount() == 2,
+                  "the next signal queries again and recycles");
+        });
+
+        suite.Run("BindlessRegistry/GenerationRetirement", [] {
+            // A slot cycles through every generation, each handle distinct, then retires so
+            // that no stale handle can become valid again.
+            ManualGpuTimeline timeline;
+            BindlessRegistry registry(timeline, 1);
+            std::set<UInt32> handles;
+            std::vector<BindlessHandle> stale;
+            for (UInt32 generation = 1; generation <= MaxBindlessGeneration; ++generation) {
+                const BindlessHandle handle = registry.Allocate();
+                Check(GetBindlessGeneration(handle) == generation && handles.insert(handle.Value).second,
+                      "each allocation gets a new handle");
+                registry.Free(handle);
+                stale.push_back(handle);
+                timeline.Signal();
+            }
+
+            Check(registry.GetRetiredCount() == 1 && registry.GetPendingCount() == 0 && registry.GetLiveCount() == 0,
+                  "the exhausted slot is retired, not pending");
+            CheckThrows<std::length_error>([&] { registry.Allocate(); }, "a retired slot is never handed out again");
+            bool anyValid = false;
+            for (const BindlessHandle handle : stale) {
+                anyValid |= registry.IsValid(handle);
+            }
+            Check(!anyValid, "every handle of the slot stays stale");
+        });
+
+        suite.Run("BindlessRegistry/RandomModel", [] {
+            // Random allocations, frees, signals and completions against a model: live handles
+            // stay valid, freed ones stale, and no slot is reused before its fence completed.
+            for (UInt32 seed = 0; seed < 50; ++seed) {
+                std::mt19937 random(seed);
+                ManualGpuTimeline timeline;
+                const UInt32 capacity = 1 + random() % 300;
+                BindlessRegistry registry(timeline, capacity);
+                std::vector<BindlessHandle> live;
+                std::vector<BindlessHandle> freed;
+                std::map<UInt32, UInt64> guardingFences;
+                UInt32 violationCount = 0;
+
+                for (UInt32 operation = 0; operation < 3000; ++operation) {
+                    const UInt32 kind = random() % 10;
+                    if (kind < 4) {
+                        BindlessHandle handle;
+                        try {
+                            handle = registry.Allocate();
+                        } catch (const std::length_error&) {
+                            continue;
+                        }
+                        const auto it = guardingFences.find(GetBindlessIndex(handle));
+                        if (it != guardingFences.end()) {
+                            violationCount += !timeline.IsComplete(it->second);
+                            guardingFences.erase(it);
+                        }
+                        live.push_back(handle);
+                    } else if (kind < 7 && !live.empty()) {
+                        const UInt64 i = random() % live.size();
+                        const BindlessHandle handle = live[i];
+                        live[i] = live.back();
+                        live.pop_back();
+                        registry.Free(handle);
+                        guardingFences[GetBindlessIndex(handle)] = timeline.GetLastSignaledValue() + 1;
+                        freed.push_back(handle);
+                    } else if (kind < 8) {
+                        timeline.Signal();
+                    } else if (kind < 9) {
+                        timeline.CompleteUpTo(timeline.GetLastSignaledValue());
+                    }
+
+                    for (const BindlessHandle handle : live) {
+                        violationCount += !registry.IsValid(handle);
+                    }
+                    if (!freed.empty()) {
+                        violationCount += registry.IsValid(freed[random() % freed.size()]);
+                    }
+                    violationCount += registry.GetLiveCount() != live.size();
+                }
+                Check(violationCount == 0, "the registry matches the model");
+            }
+        });
+    }
+}
@@ -0,0 +1,130 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/CommandContextPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        struct TestContext {
+            UInt32 Id = 0;
+            UInt64 LastFenceValue = 0;
+            std::atomic<bool> InUse = false;
+        };
+
+        using TestContextPtr = std::shared_ptr<TestContext>;
+    }
+
+    void RunCommandContextPoolTests(TestSuite& suite) {
+        suite.Run("CommandContextPool/ReuseAfterFence", [] {
+            ManualGpuTimeline timeline;
+            UInt32 nextId = 0;
+            CommandContextPool<UInt32> pool(timeline, [&nextId] { return nextId++; });
+
+            const UInt32 first = pool.Acquire();
+            pool.Release(first, timeline.Signal());
+            Check(pool.GetPendingCount() == 1, "a released context waits for its fence");
+
+            const UInt32 second = pool.Acquire();
+            Check(second != first && pool.GetCreatedCount() == 2, "a context in flight is not handed out");
+            pool.Release(second, timeline.Signal());
+
+            timeline.CompleteUpTo(1);
+            Check(pool.Acquire() == first, "a context is handed out once its fence completed");
+            Check(pool.GetPendingCount() == 1 && pool.GetCreatedCount() == 2, "the other one is still in flight");
+            Check(timeline.GetWaits().empty(), "the pool never waits for the GPU");
+        });
+
+        suite.Run("CommandContextPool/OutOfOrderRelease", [] {
+            // Contexts recorded on several threads are released in any order, they are
+            // recycled in fence order.
+            ManualGpuTimeline timeline;
+            UInt32 nextId = 0;
+            CommandContextPool<UInt32> pool(timeline, [&nextId] { return nextId++; });
+
+            const UInt32 a = pool.Acquire();
+            const UInt32 b = pool.Acquire();
+            const UInt32 c = pool.Acquire();
+            const UInt64 first = timeline.Signal();
+            const UInt64 second = timeline.Signal();
+            const UInt64 third = timeline.Signal();
+            pool.Release(c, third);
+            pool.Release(a, first);
+            pool.Release(b, second);
+
+            timeline.CompleteUpTo(second);
+            const UInt32 x = pool.Acquire();
+            const UInt32 y = pool.Acquire();
+            Check((x == a && y == b) || (x == b && y == a), "only the completed contexts are recycled");
+            Check(pool.Acquire() == 3, "the context of the pending fence is not handed out");
+            Check(pool.GetPendingCount() == 1 && pool.GetAvailableCount() == 0, "the counts follow");
+        });
+
+        suite.Run("CommandContextPool/QueriesTheFenceLazily", [] {
+            ManualGpuTimeline timeline;
+            CommandContextPool<UInt32> pool(timeline, [] { return 0u; });
+
+            pool.Acquire();
+            Check(timeline.GetCompletedQueryCount() == 0, "nothing pending, nothing to query");
+
+            pool.Release(0, timeline.Signal());
+            timeline.CompleteUpTo(1);
+            pool.Acquire();
+            pool.Release(0, 1);
+            pool.Acquire();
+            Check(timeline.GetCompletedQueryCount() == 1, "a fence known to be complete is not queried again");
+        });
+
+        suite.Run("CommandContextPool/ConcurrentThreads", [] {
+            // Threads record on contexts and submit them to a slow simulated GPU. A context
+            // handed out must be idle, and its last submission complete.
+            constexpr UInt32 ThreadCount = 4;
+            constexpr UInt32 SubmissionsPerThread = 2000;
+
+            SimulatedGpuTimeline timeline(std::chrono::microseconds(2));
+            std::atomic<UInt32> nextId = 0;
+            CommandContextPool<TestContextPtr> pool(timeline, [&nextId] {
+                auto context = std::make_shared<TestContext>();
+                context->Id = nextId++;
+                return context;
+            });
+
+            std::atomic<UInt32> violationCount = 0;
+            std::vector<std::thread> threads;
+            for (UInt32 i = 0; i < ThreadCount; ++i) {
+                threads.emplace_back([&] {
+                    for (UInt32 j = 0; j < SubmissionsPerThread; ++j) {
+                        TestContextPtr context = pool.Acquire();
+                        if (context->InUse.exchange(true) || !timeline.IsComplete(context->LastFenceValue)) {
+                            ++violationCount;
+                        }
+
+                        const UInt64 fenceValue = timeline.Signal();
+                        context->LastFenceValue = fenceValue;
+                        context->InUse = false;
+                        pool.Release(std::move(context), fenceValue);
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            Check(violationCount == 0, "contexts are only handed out idle and completed");
+            Check(pool.GetCreatedCount() == nextId, "the created count matches the factory calls");
+            Check(pool.GetAvailableCount() + pool.GetPendingCount() == nextId, "every context came back");
+            Check(nextId < ThreadCount * SubmissionsPerThread, "contexts are recycled");
+        });
+    }
+}
@@ -0,0 +1,399 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/CommandRecorder.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // The state a draw sees, unset until a call sets it. Structures are compared by their
+        // bits, like the recorder does.
+        struct BoundState {
+            std::optional<ID3D12PipelineState*> PipelineState;
+            std::optional<ID3D12RootSignature*> RootSignature;
+            std::optional<std::vector<ID3D12DescriptorHeap*>> DescriptorHeaps;
+            std::map<UInt32, UInt64> Tables;
+            std::map<UInt32, UInt64> ConstantBuffers;
+            // By parameter * MaxRootConstants + offset.
+            std::map<UInt32, UInt32> Constants;
+            std::optional<std::vector<UInt32>> Viewports;
+            std::optional<std::vector<UInt32>> ScissorRects;
+            std::optional<PrimitiveTopology> Topology;
+            std::map<UInt32, std::vector<UInt32>> VertexBuffers;
+            // Empty when unbound.
+            std::optional<std::vector<UInt32>> IndexBuffer;
+
+            bool operator==(const BoundState&) const = default;
+        };
+
+        struct DrawCall {
+            bool Indexed = false;
+            std::array<Int64, 5> Arguments = {};
+            BoundState State;
+
+            bool operator==(const DrawCall&) const = default;
+        };
+
+        template <class T>
+        std::vector<UInt32> ToWords(const std::span<const T> values) {
+            static_assert(sizeof(T) % sizeof(UInt32) == 0);
+            std::vector<UInt32> words(values.size_bytes() / sizeof(UInt32));
+            if (!words.empty()) {
+                std::memcpy(words.data(), values.data(), values.size_bytes());
+            }
+
+            return words;
+        }
+
+        // Applies every call it receives to the state, with the rules of the recorder: a new root
+        // signature unsets the root arguments, new heaps unset the descriptor tables.
+        class StateTrackingList final : public GraphicsCommandList {
+        public:
+            void SetPipelineState(ID3D12PipelineState* pPipelineState) override {
+                ++m_CallCount;
+                m_State.PipelineState = pPipelineState;
+            }
+
+            void SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature) override {
+                ++m_CallCount;
+                if (m_State.RootSignature != pRootSignature) {
+                    m_State.Tables.clear();
+                    m_State.ConstantBuffers.clear();
+                    m_State.Constants.clear();
+                }
+                m_State.RootSignature = pRootSignature;
+            }
+
+            void SetDescriptorHeaps(const std::span<ID3D12DescriptorHeap* const> heaps) override {
+                ++m_CallCount;
+                const std::vector<ID3D12DescriptorHeap*> descriptorHeaps(heaps.begin(), heaps.end());
+                if (m_State.DescriptorHeaps != descriptorHeaps) {
+                    m_State.Tables.clear();
+                }
+                m_State.DescriptorHeaps = descriptorHeaps;
+            }
+
+            void SetGraphicsRootDescriptorTable(const UInt32 rootParameter, const UInt64 baseDescriptor) override {
+                ++m_CallCount;
+                m_State.Tables[rootParameter] = baseDescriptor;
+            }
+
+            void SetGraphicsRoot32BitConstants(const UInt32 rootParameter, const std::span<const UInt32> values,
+                                               const UInt32 destOffset) override {
+                ++m_CallCount;
+                for (UInt32 i = 0; i < values.size(); ++i) {
+                    m_State.Constants[rootParameter * MaxRootConstants + destOffset + i] = values[i];
+                }
+            }
+
+            void SetGraphicsRootConstantBufferView(const UInt32 rootParameter, const UInt64 bufferLocation) override {
+                ++m_CallCount;
+                m_State.ConstantBuffers[rootParameter] = bufferLocation;
+            }
+
+            void RSSetViewports(const std::span<const Viewport> viewports) override {
+                ++m_CallCount;
+                m_State.Viewports = ToWords(viewports);
+            }
+
+            void RSSetScissorRects(const std::span<const ScissorRect> rects) override {
+                ++m_CallCount;
+                m_State.ScissorRects = ToWords(rects);
+            }
+
+            void IASetPrimitiveTopology(const PrimitiveTopology topology) override {
+                ++m_CallCount;
+                m_State.Topology = topology;
+            }
+
+            void IASetVertexBuffers(const UInt32 startSlot, const std::span<const VertexBufferView> views) override {
+                ++m_CallCount;
+                for (UInt32 i = 0; i < views.size(); ++i) {
+                    m_State.VertexBuffers[startSlot + i] = ToWords(views.subspan(i, 1));
+                }
+            }
+
+            void IASetIndexBuffer(const IndexBufferView* pView) override {
+                ++m_CallCount;
+                m_State.IndexBuffer = pView != nullptr ? ToWords(std::span(pView, 1)) : std::vector<UInt32>();
+            }
+
+            void DrawInstanced(const UInt32 vertexCountPerInstance, const UInt32 instanceCount,
+                               const UInt32 startVertexLocation, const UInt32 startInstanceLocation) override {
+                ++m_CallCount;
+                m_Draws.push_back({false, {vertexCountPerInstance, instanceCount, startVertexLocation, startInstanceLocation, 0},
+                                   m_State});
+            }
+
+            void DrawIndexedInstanced(const UInt32 indexCountPerInstance, const UInt32 instanceCount,
+                                      const UInt32 startIndexLocation, const Int32 baseVertexLocation,
+                                      const UInt32 startInstanceLocation) override {
+                ++m_CallCount;
+                m_Draws.push_back({true, {indexCountPerInstance, instanceCount, startIndexLocation, baseVertexLocation,
+                                          startInstanceLocation}, m_State});
+            }
+
+            // A reset command list, the draws recorded so far are kept.
+            void Reset() {
+                m_State = {};
+            }
+
+            const BoundState& GetState() const {
+                return m_State;
+            }
+
+            const std::vector<DrawCall>& GetDraws() const {
+                return m_Draws;
+            }
+
+            UInt64 GetCallCount() const {
+                return m_CallCount;
+            }
+
+        private:
+            BoundState m_State;
+            std::vector<DrawCall> m_Draws;
+            UInt64 m_CallCount = 0;
+        };
+
+        template <class T>
+        T* MakePointer(const UInt32 index) {
+            return reinterpret_cast<T*>(std::uintptr_t(0x1000) * (index + 1));
+        }
+
+        enum class StreamAction {
+            Set,
+            Draw,
+            Flush,
+            Reset
+        };
+
+        // Makes one random call on the recorder or the list, from small pools of values so that
+        // many calls set the bound state again. Flushes and resets are left to the caller. The
+        // root parameters keep one type: tables in 0-3, constant buffers in 4-5, constants in 6-7.
+        template <class TTarget>
+        StreamAction MakeRandomCall(std::mt19937& random, TTarget& target) {
+            const auto pick = [&](const UInt32 count) { return static_cast<UInt32>(random() % count); };
+            switch (pick(16)) {
+                case 0:
+                    target.SetPipelineState(MakePointer<ID3D12PipelineState>(pick(3)));
+                    return StreamAction::Set;
+                case 1:
+                    target.SetGraphicsRootSignature(MakePointer<ID3D12RootSignature>(pick(2)));
+                    return StreamAction::Set;
+                case 2: {
+                    const UInt32 combination = pick(4);
+                    ID3D12DescriptorHeap* heaps[] = {MakePointer<ID3D12DescriptorHeap>(combination == 3),
+                                                     MakePointer<ID3D12DescriptorHeap>(combination != 3)};
+                    target.SetDescriptorHeaps(std::span(heaps, std::min(combination, 2u)));
+                    return StreamAction::Set;
+                }
+                case 3:
+                case 4: {
+                    const UInt32 rootParameter = pick(4);
+                    target.SetGraphicsRootDescriptorTable(rootParameter, 0x100 + pick(3) * 0x40);
+                    return StreamAction::Set;
+                }
+                case 5: {
+                    const UInt32 rootParameter = 4 + pick(2);
+                    target.SetGraphicsRootConstantBufferView(rootParameter, 0x10000 + pick(3) * 0x100);
+                    return StreamAction::Set;
+                }
+                case 6:
+                case 7: {
+                    const UInt32 rootParameter = 6 + pick(2);
+                    const UInt32 destOffset = pick(16);
+                    std::vector<UInt32> values(1 + pick(4));
+                    for (UInt32& value : values) {
+                        value = pick(3);
+                    }
+                    target.SetGraphicsRoot32BitConstants(rootParameter, values, destOffset);
+                    return StreamAction::Set;
+                }
+                case 8: {
+                    // -0 differs from 0 by its bits.
+                    const Viewport pool[] = {{0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 64.0f, 64.0f, -0.0f, 1.0f},
+                                             {32.0f, 0.0f, 32.0f, 64.0f, 0.0f, 1.0f}};
+                    std::vector<Viewport> viewports(1 + pick(2));
+                    for (Viewport& viewport : viewports) {
+                        viewport = pool[pick(3)];
+                    }
+                    target.RSSetViewports(viewports);
+                    return StreamAction::Set;
+                }
+                case 9: {
+                    const ScissorRect pool[] = {{0, 0, 64, 64}, {0, 0, 32, 64}, {32, 0, 64, 64}};
+                    std::vector<ScissorRect> rects(1 + pick(2));
+                    for (ScissorRect& rect : rects) {
+                        rect = pool[pick(3)];
+                    }
+                    target.RSSetScissorRects(rects);
+                    return StreamAction::Set;
+                }
+                case 10:
+                    target.IASetPrimitiveTopology(static_cast<PrimitiveTopology>(1 + pick(3)));
+                    return StreamAction::Set;
+                case 11: {
+                    const VertexBufferView pool[] = {{0x20000, 1024, 12}, {0x20400, 1024, 12}, {0x20000, 1024, 16}};
+                    const UInt32 startSlot = pick(4);
+                    std::vector<VertexBufferView> views(1 + pick(3));
+                    for (VertexBufferView& view : views) {
+                        view = pool[pick(3)];
+                    }
+                    target.IASetVertexBuffers(startSlot, views);
+                    return StreamAction::Set;
+                }
+                case 12: {
+                    const IndexBufferView pool[] = {{0x30000, 600, 42}, {0x30000, 600, 57}};
+                    const UInt32 choice = pick(3);
+                    target.IASetIndexBuffer(choice == 2 ? nullptr : &pool[choice]);
+                    return StreamAction::Set;
+                }
+                case 13: {
+                    const UInt32 vertexCount = pick(100);
+                    const UInt32 instanceCount = 1 + pick(3);
+                    target.DrawInstanced(vertexCount, instanceCount, pick(10), pick(10));
+                    return StreamAction::Draw;
+                }
+                case 14: {
+                    const UInt32 indexCount = pick(100);
+                    const UInt32 instanceCount = 1 + pick(3);
+                    const UInt32 startIndex = pick(10);
+                    const Int32 baseVertex = static_cast<Int32>(pick(10)) - 5;
+                    target.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, pick(10));
+                    return StreamAction::Draw;
+                }
+                default:
+                    return pick(8) == 0 ? StreamAction::Reset : StreamAction::Flush;
+            }
+        }
+    }
+
+    void RunCommandRecorderTests(TestSuite& suite) {
+        suite.Run("CommandRecorder/RandomStreams", [] {
+            // The same stream through the recorder and straight into a list: every draw sees
+            // the same state, and a call is filtered exactly when it leaves the state as is.
+            CommandRecorderStatistics totals;
+            for (UInt32 seed = 0; seed < 50; ++seed) {
+                StateTrackingList reference;
+                StateTrackingList recorded;
+                CommandRecorder recorder(recorded);
+                std::mt19937 random(seed);
+                UInt64 recordedCalls = 0;
+                UInt64 unchangingCalls = 0;
+                for (UInt32 step = 0; step < 3000; ++step) {
+                    std::mt19937 referenceRandom = random;
+                    const BoundState before = reference.GetState();
+                    const StreamAction action = MakeRandomCall(random, recorder);
+                    MakeRandomCall(referenceRandom, reference);
+
+                    switch (action) {
+                        case StreamAction::Set:
+                            ++recordedCalls;
+                            unchangingCalls += reference.GetState() == before;
+                            break;
+                        case StreamAction::Draw:
+                            ++recordedCalls;
+                            break;
+                        case StreamAction::Flush:
+                            recorder.FlushRootArguments();
+                            break;
+                        case StreamAction::Reset:
+                            recorder.Reset();
+                            recorded.Reset();
+                            reference.Reset();
+                            break;
+                    }
+                }
+                recorder.FlushRootArguments();
+
+                Check(!reference.GetDraws().empty() && recorded.GetDraws() == reference.GetDraws(),
+                      "every draw sees the state of the unfiltered stream");
+
+                const CommandRecorderStatistics& statistics = recorder.GetStatistics();
+                Check(statistics.RecordedCalls == recordedCalls, "every call is recorded");
+                Check(statistics.ForwardedCalls == recorded.GetCallCount(), "the forwarded calls reach the list");
+                Check(statistics.FilteredCalls == unchangingCalls, "the calls setting the bound state are filtered");
+                Check(statistics.RecordedCalls ==
+                      statistics.ForwardedCalls + statistics.FilteredCalls + statistics.CoalescedCalls,
+                      "the recorded calls are forwarded, filtered or coalesced");
+
+                totals.RecordedCalls += statistics.RecordedCalls;
+                totals.ForwardedCalls += statistics.ForwardedCalls;
+                totals.FilteredCalls += statistics.FilteredCalls;
+                totals.CoalescedCalls += statistics.CoalescedCalls;
+            }
+            Check(totals.FilteredCalls > totals.RecordedCalls / 10 && totals.CoalescedCalls > totals.RecordedCalls / 20,
+                  "the streams exercise filtering and coalescing");
+        });
+
+        suite.Run("CommandRecorder/Statistics", [] {
+            // Pending root arguments are counted when flushed or dropped.
+            StateTrackingList list;
+            CommandRecorder recorder(list);
+            recorder.SetGraphicsRootSignature(MakePointer<ID3D12RootSignature>(0));
+            recorder.SetGraphicsRootDescriptorTable(0, 0x100);
+            recorder.SetGraphicsRootDescriptorTable(0, 0x140);
+            recorder.SetGraphicsRoot32BitConstant(6, 1, 0);
+            recorder.SetGraphicsRoot32BitConstant(6, 2, 1);
+            recorder.SetGraphicsRoot32BitConstant(6, 2, 1);
+            Check(recorder.GetStatistics().RecordedCalls == 6 && recorder.GetStatistics().FilteredCalls == 1 &&
+                  recorder.GetStatistics().ForwardedCalls == 1 && list.GetCallCount() == 1,
+                  "root arguments wait for a draw");
+
+            recorder.DrawInstanced(3, 1, 0, 0);
+            const CommandRecorderStatistics& statistics = recorder.GetStatistics();
+            Check(statistics.RecordedCalls == 7 && statistics.ForwardedCalls == 4 && statistics.FilteredCalls == 1 &&
+                  statistics.CoalescedCalls == 2 && list.GetCallCount() == 4,
+                  "a table set twice and adjacent constants are forwarded once");
+
+            recorder.SetGraphicsRootDescriptorTable(1, 0x100);
+            recorder.ResetStatistics();
+            recorder.SetGraphicsRootSignature(MakePointer<ID3D12RootSignature>(1));
+            Check(recorder.GetStatistics().RecordedCalls == 2 && recorder.GetStatistics().CoalescedCalls == 1 &&
+                  recorder.GetStatistics().ForwardedCalls == 1,
+                  "a pending argument dropped by a new signature is counted after ResetStatistics");
+        });
+
+        suite.Run("CommandRecorder/InvalidArguments", [] {
+            StateTrackingList list;
+            CommandRecorder recorder(list);
+            const UInt32 values[2] = {};
+            const Viewport viewports[MaxViewports + 1] = {};
+            const ScissorRect rects[MaxViewports + 1] = {};
+            const VertexBufferView views[2] = {};
+            ID3D12DescriptorHeap* heaps[MaxDescriptorHeaps + 1] = {};
+            CheckThrows<std::invalid_argument>([&] { recorder.SetGraphicsRootDescriptorTable(MaxRootParameters, 0); },
+                                               "a table past the root parameters is rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.SetGraphicsRootConstantBufferView(MaxRootParameters, 0); },
+                                               "a constant buffer past the root parameters is rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.SetGraphicsRoot32BitConstants(0, values, MaxRootConstants - 1); },
+                                               "constants past the last one are rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.SetGraphicsRoot32BitConstants(0, values, MaxRootConstants + 1); },
+                                               "an offset past the last constant is rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.RSSetViewports(viewports); },
+                                               "too many viewports are rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.RSSetScissorRects(rects); },
+                                               "too many scissor rectangles are rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.IASetVertexBuffers(MaxVertexBuffers - 1, views); },
+                                               "vertex buffers past the last slot are rejected");
+            CheckThrows<std::invalid_argument>([&] { recorder.SetDescriptorHeaps(heaps); },
+                                               "too many descriptor heaps are rejected");
+            Check(recorder.GetStatistics().RecordedCalls == 0 && list.GetCallCount() == 0,
+                  "rejected calls are neither recorded nor forwarded");
+        });
+    }
+}
@@ -0,0 +1,232 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/ConstantBufferAllocator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr UInt64 GpuBase = 0x10000;
+    }
+
+    void RunConstantBufferAllocatorTests(TestSuite& suite) {
+        suite.Run("ConstantBufferAllocator/Slices", [] {
+            ManualGpuTimeline timeline;
+            std::vector<std::byte> memory(4 * 1024);
+            ConstantBufferAllocator allocator(timeline, memory.data(), GpuBase, memory.size(), 1024);
+            Check(allocator.GetPageCount() == 4 && allocator.GetFreePageCount() == 4, "the capacity is split in pages");
+
+            ConstantBufferContext context(allocator);
+            Check(allocator.GetFreePageCount() == 4, "a context takes no page before its first allocation");
+            const ConstantAllocation first = context.Allocate(1);
+            const ConstantAllocation second = context.Allocate(300);
+            Check(first.Size == 256 && second.Size == 512, "sizes are rounded up for the views");
+            Check(first.GpuAddress % 256 == 0 && second.GpuAddress == first.GpuAddress + 256,
+                  "slices are bump-allocated in the page");
+            Check(first.CpuAddress - memory.data() == static_cast<std::ptrdiff_t>(first.GpuAddress - GpuBase),
+                  "the CPU and GPU addresses match");
+            Check(allocator.GetFreePageCount() == 3 && allocator.GetRetiredPageCount() == 0, "one page is in use");
+
+            const ConstantAllocation third = context.Allocate(512);
+            Check((third.GpuAddress - GpuBase) % 1024 == 0 && allocator.GetRetiredPageCount() == 1,
+                  "a slice that does not fit retires the page and starts a new one");
+            CheckThrows<std::length_error>([&] { context.Allocate(1025); }, "a slice larger than a page is rejected");
+
+            context.Retire();
+            context.Retire();
+            Check(allocator.GetFreePageCount() == 2 && allocator.GetRetiredPageCount() == 2,
+                  "retiring an idle context does nothing");
+
+            CheckThrows<std::invalid_argument>([&] {
+                ConstantBufferAllocator invalid(timeline, memory.data(), GpuBase, memory.size(), 1000);
+            }, "a page size that is not a multiple of 256 is rejected");
+            CheckThrows<std::invalid_argument>([&] {
+                ConstantBufferAllocator invalid(timeline, memory.data(), GpuBase + 16, memory.size(), 1024);
+            }, "a misaligned GPU base is rejected");
+            CheckThrows<std::invalid_argument>([&] {
+                ConstantBufferAllocator invalid(timeline, memory.data(), GpuBase, 512, 1024);
+            }, "a capacity without a page is rejected");
+        });
+
+        suite.Run("ConstantBufferAllocator/RecyclesAfterFence", [] {
+            ManualGpuTimeline timeline;
+            std::vector<std::byte> memory(4 * 1024);
+            ConstantBufferAllocator allocator(timeline, memory.data(), GpuBase, memory.size(), 1024);
+
+            // Two frames of two pages each.
+            std::vector<UInt32> frames[2];
+            for (std::vector<UInt32>& frame : frames) {
+                for (UInt32 i = 0; i < 2; ++i) {
+                    frame.push_back(allocator.AcquirePage());
+                }
+                for (const UInt32 page : frame) {
+                    allocator.RetirePage(page);
+                }
+                timeline.Signal();
+            }
+            Check(allocator.GetFreePageCount() == 0 && allocator.GetRetiredPageCount() == 4, "every page is retired");
+
+            timeline.CompleteUpTo(1);
+            const UInt32 recycled = allocator.AcquirePage();
+            Check(recycled == frames[0][0] || recycled == frames[0][1], "a page of the completed frame is recycled");
+            Check(allocator.GetFreePageCount() == 1 && allocator.GetRetiredPageCount() == 2,
+                  "the other completed page is freed, the pending ones stay retired");
+            Check(timeline.GetWaits().empty() && allocator.GetWaitCount() == 0, "no wait while a page is completed");
+
+            const UInt32 other = allocator.AcquirePage();
+            Check(other != recycled && (other == frames[0][0] || other == frames[0][1]), "the free page is taken next");
+
+            // Out of completed pages: the oldest retired fence is waited for.
+            const UInt32 waited = allocator.AcquirePage();
+            Check(waited == frames[1][0] || waited == frames[1][1], "the page of the pending frame is recycled");
+            Check(timeline.GetWaits().size() == 1 && timeline.GetWaits()[0] == 2 && allocator.GetWaitCount() == 1,
+                  "only once its fence was waited for");
+        });
+
+        suite.Run("ConstantBufferAllocator/ExhaustionKeepsRetiredPages", [] {
+            // Pages retired since the last signal belong to unsubmitted work, waiting for them
+            // would hang. The allocator throws and must leave them retired.
+            ManualGpuTimeline timeline;
+            std::vector<std::byte> memory(3 * 1024);
+            ConstantBufferAllocator allocator(timeline, memory.data(), GpuBase, memory.size(), 1024);
+
+            const UInt32 held = allocator.AcquirePage();
+            allocator.RetirePage(allocator.AcquirePage());
+            allocator.RetirePage(allocator.AcquirePage());
+            CheckThrows<std::length_error>([&] { allocator.AcquirePage(); }, "an exhausted pool throws");
+            Check(allocator.GetFreePageCount() == 0 && allocator.GetRetiredPageCount() == 2,
+                  "the retired pages are still counted");
+            Check(timeline.GetWaits().empty(), "no unsubmitted value is waited for");
+
+            // Once submitted, the same pages are recycled: the list was restored.
+            timeline.Signal();
+            const UInt32 first = allocator.AcquirePage();
+            const UInt32 second = allocator.AcquirePage();
+            Check(first != held && second != held && first != second, "both retired pages come back");
+            Check(allocator.GetFreePageCount() == 0 && allocator.GetRetiredPageCount() == 0, "the counts follow");
+
+            allocator.RetirePage(held);
+            allocator.RetirePage(first);
+            allocator.RetirePage(second);
+            Check(allocator.GetRetiredPageCount() == 3, "every page is retired again");
+        });
+
+        suite.Run("ConstantBufferAllocator/NoReuseBeforeFence", [] {
+            // A slow GPU and a small pool: every slice handed out must not belong to a frame
+            // still in flight.
+            SimulatedGpuTimeline timeline(std::chrono::microseconds(200));
+            std::vector<std::byte> memory(16 * 1024);
+            ConstantBufferAllocator allocator(timeline, memory.data(), GpuBase, memory.size(), 1024);
+            std::map<UInt64, UInt64> fenceValues;
+            UInt32 reuseCount = 0;
+            UInt32 earlyReuseCount = 0;
+
+            ConstantBufferContext context(allocator);
+            for (UInt32 frame = 0; frame < 300; ++frame) {
+                const UInt64 fenceValue = timeline.GetLastSignaledValue() + 1;
+                for (UInt32 i = 0; i < 20; ++i) {
+                    const ConstantAllocation allocation = context.Allocate(256 * (1 + (frame + i) % 3));
+                    for (UInt64 address = allocation.GpuAddress; address < allocation.GpuAddress + allocation.Size;
+                         address += 256) {
+                        const auto [it, inserted] = fenceValues.try_emplace(address, fenceValue);
+                        if (!inserted && it->second != fenceValue) {
+                            ++reuseCount;
+                            earlyReuseCount += !timeline.IsComplete(it->second);
+                            it->second = fenceValue;
+                        }
+                    }
+                }
+                if (frame % 2 == 1) {
+                    context.Retire();
+                }
+                timeline.Signal();
+            }
+
+            Check(reuseCount > 0 && allocator.GetWaitCount() > 0, "the pool is recycled and waits for the GPU");
+            Check(earlyReuseCount == 0, "no slice is reused before its fence completed");
+        });
+
+        suite.Run("ConstantBufferAllocator/ConcurrentContexts", [] {
+            // Threads fill a page of tagged slices, retire it and signal, like recording and
+            // submitting small command lists. A pool holding every page used gives exact
+            // counts; a smaller one forces recycling under contention. At most one page per
+            // thread is in use and one retired but not signaled, so the small pool never runs
+            // out.
+            constexpr UInt32 ThreadCount = 16;
+            constexpr UInt64 PageSize = 4096;
+            constexpr UInt32 SlicesPerPage = PageSize / 512;
+
+            for (const bool recycles : {false, true}) {
+                const UInt32 pagesPerThread = recycles ? 32 : 8;
+                const UInt64 poolPageCount = recycles ? ThreadCount * 2 + 8 : ThreadCount * pagesPerThread + 5;
+                SimulatedGpuTimeline timeline(std::chrono::microseconds(20));
+                std::vector<std::byte> memory(poolPageCount * PageSize);
+                ConstantBufferAllocator allocator(timeline, memory.data(), GpuBase, memory.size(), PageSize);
+
+                std::atomic<UInt32> start = 0;
+                std::atomic<UInt32> corruptCount = 0;
+                std::atomic<UInt32> exhaustedCount = 0;
+                std::vector<std::thread> threads;
+                for (UInt32 t = 0; t < ThreadCount; ++t) {
+                    threads.emplace_back([&, t] {
+                        ++start;
+                        while (start != ThreadCount) {
+                        }
+
+                        ConstantBufferContext context(allocator);
+                        ConstantAllocation allocations[SlicesPerPage];
+                        try {
+                            for (UInt32 page = 0; page < pagesPerThread; ++page) {
+                                for (UInt32 i = 0; i < SlicesPerPage; ++i) {
+                                    const UInt32 tag[2] = {t, page * SlicesPerPage + i};
+                                    allocations[i] = context.Allocate(512);
+                                    std::memcpy(allocations[i].CpuAddress, tag, sizeof(tag));
+                                    std::memcpy(allocations[i].CpuAddress + 504, tag, sizeof(tag));
+                                }
+                                // A slice handed to two threads at once has been overwritten.
+                                for (UInt32 i = 0; i < SlicesPerPage; ++i) {
+                                    const UInt32 tag[2] = {t, page * SlicesPerPage + i};
+                                    if (std::memcmp(allocations[i].CpuAddress, tag, sizeof(tag)) != 0 ||
+                                        std::memcmp(allocations[i].CpuAddress + 504, tag, sizeof(tag)) != 0) {
+                                        ++corruptCount;
+                                    }
+                                }
+                                context.Retire();
+                                timeline.Signal();
+                            }
+                        } catch (const std::length_error&) {
+                            ++exhaustedCount;
+                        }
+                    });
+                }
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+
+                Check(corruptCount == 0 && exhaustedCount == 0, "no slice is shared between threads");
+                Check(allocator.GetFreePageCount() + allocator.GetRetiredPageCount() == allocator.GetPageCount(),
+                      "every page is free or retired once the contexts are gone");
+                if (recycles) {
+                    Check(allocator.GetRetiredPageCount() > 0, "the pages are recycled");
+                } else {
+                    Check(allocator.GetRetiredPageCount() == ThreadCount * pagesPerThread &&
+                          allocator.GetFreePageCount() == 5 && allocator.GetWaitCount() == 0,
+                          "each page used is retired exactly once");
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,361 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/Culling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr UInt32 Sentinel = 0xdeadbeef;
+        // Objects closer than this to a plane or a distance limit may go either way through
+        // rounding, the reference does not judge them.
+        constexpr Float64 TouchingMargin = 1e-3;
+
+        // A camera at Eye looking down +Z, 60 degrees of vertical field of view, in the
+        // DirectXMath convention: clip = position * ViewProjection.
+        struct Camera {
+            Float32 Eye[3] = {3.0f, -2.0f, 5.0f};
+            Float32 ViewProjection[4][4] = {};
+
+            Camera() {
+                constexpr Float32 NearZ = 0.5f;
+                constexpr Float32 FarZ = 200.0f;
+                const Float32 yScale = 1.0f / std::tan(0.5f * 1.0471976f);
+                const Float32 xScale = yScale / (16.0f / 9.0f);
+                const Float32 zScale = FarZ / (FarZ - NearZ);
+
+                ViewProjection[0][0] = xScale;
+                ViewProjection[1][1] = yScale;
+                ViewProjection[2][2] = zScale;
+                ViewProjection[2][3] = 1.0f;
+                ViewProjection[3][0] = -Eye[0] * xScale;
+                ViewProjection[3][1] = -Eye[1] * yScale;
+                ViewProjection[3][2] = -Eye[2] * zScale - NearZ * zScale;
+                ViewProjection[3][3] = -Eye[2];
+            }
+        };
+
+        // Objects scattered around the eye, most outside of the frustum or the distance range.
+        struct Scene {
+            BoundingSphereSet Spheres;
+            BoundingBoxSet Boxes;
+
+            Scene(const UInt32 count, const UInt32 seed) {
+                std::mt19937 random(seed);
+                std::uniform_real_distribution<Float32> positions(-150.0f, 150.0f);
+                std::uniform_real_distribution<Float32> sizes(0.1f, 5.0f);
+                for (UInt32 i = 0; i < count; ++i) {
+                    const Float32 center[3] = {positions(random), positions(random), positions(random)};
+                    Spheres.Add(center, sizes(random));
+                    Boxes.Add(center, {sizes(random), sizes(random), sizes(random)});
+                }
+            }
+        };
+
+        // The distances of a sphere to the planes and limits, positive inside, in double.
+        Float64 GetSphereSlack(const BoundingSphereSet& spheres, const UInt32 i, const CullingFrustum& frustum) {
+            const Float64 center[3] = {spheres.GetCenterX()[i], spheres.GetCenterY()[i], spheres.GetCenterZ()[i]};
+            const Float64 radius = spheres.GetRadii()[i];
+
+            Float64 slack = std::numeric_limits<Float64>::infinity();
+            for (const Float32 (&plane)[4] : frustum.Planes) {
+                slack = std::min(slack, center[0] * plane[0] + center[1] * plane[1] + center[2] * plane[2] + plane[3] + radius);
+            }
+
+            const Float64 distance = std::hypot(center[0] - frustum.Origin[0], center[1] - frustum.Origin[1],
+                                                center[2] - frustum.Origin[2]);
+            slack = std::min(slack, Float64(frustum.MaxDistance) + radius - distance);
+            return std::min(slack, distance + radius - frustum.MinDistance);
+        }
+
+        Float64 GetBoxSlack(const BoundingBoxSet& boxes, const UInt32 i, const CullingFrustum& frustum) {
+            const Float64 center[3] = {boxes.GetCenterX()[i], boxes.GetCenterY()[i], boxes.GetCenterZ()[i]};
+            const Float64 extent[3] = {boxes.GetExtentX()[i], boxes.GetExtentY()[i], boxes.GetExtentZ()[i]};
+
+            Float64 slack = std::numeric_limits<Float64>::infinity();
+            Float64 nearSquared = 0.0;
+            Float64 farSquared = 0.0;
+            for (UInt32 axis = 0; axis < 3; ++axis) {
+                const Float64 offset = std::abs(center[axis] - frustum.Origin[axis]);
+                nearSquared += std::pow(std::max(offset - extent[axis], 0.0), 2.0);
+                farSquared += std::pow(offset + extent[axis], 2.0);
+            }
+            for (const Float32 (&plane)[4] : frustum.Planes) {
+                Float64 distance = plane[3];
+                for (UInt32 axis = 0; axis < 3; ++axis) {
+                    distance += center[axis] * plane[axis] + extent[axis] * std::abs(plane[axis]);
+                }
+                slack = std::min(slack, distance);
+            }
+
+            slack = std::min(slack, Float64(frustum.MaxDistance) - std::sqrt(nearSquared));
+            return std::min(slack, std::sqrt(farSquared) - frustum.MinDistance);
+        }
+
+        // Culls through a span followed by sentinels, which must stay untouched.
+        template <class TSet, class TCull>
+        std::vector<UInt32> Cull(const TSet& set, const CullingFrustum& frustum, const CullingOptions& options,
+                                 TCull cull) {
+            std::vector<UInt32> visible(set.GetCount() + 16, Sentinel);
+            const UInt32 count = cull(set, frustum, std::span(visible).first(set.GetCount()), options);
+            Check(std::all_of(visible.begin() + set.GetCount(), visible.end(),
+                              [](const UInt32 index) { return index == Sentinel; }),
+                  "nothing is written past the visible span");
+            visible.resize(count);
+            Check(std::ranges::is_sorted(visible) && std::ranges::adjacent_find(visible) == visible.end(),
+                  "the visible indices are increasing");
+
+            return visible;
+        }
+
+        std::vector<UInt32> CullSpheres(const BoundingSphereSet& spheres, const CullingFrustum& frustum,
+                                        const CullingOptions& options) {
+            return Cull(spheres, frustum, options, [](const auto&... arguments) { return D3D12Tests::CullSpheres(arguments...); });
+        }
+
+        std::vector<UInt32> CullBoxes(const BoundingBoxSet& boxes, const CullingFrustum& frustum,
+                                      const CullingOptions& options) {
+            return Cull(boxes, frustum, options, [](const auto&... arguments) { return D3D12Tests::CullBoxes(arguments...); });
+        }
+
+        // Whether the culled set agrees with the slack of every object not touching a limit.
+        template <class TSet, class TSlack>
+        bool MatchesReference(const TSet& set, const std::vector<UInt32>& visible, const CullingFrustum& frustum,
+                              TSlack getSlack) {
+            std::vector<bool> isVisible(set.GetCount(), false);
+            for (const UInt32 index : visible) {
+                isVisible[index] = true;
+            }
+
+            for (UInt32 i = 0; i < set.GetCount(); ++i) {
+                const Float64 slack = getSlack(set, i, frustum);
+                if (std::abs(slack) >= TouchingMargin && isVisible[i] != (slack > 0.0)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // An axis-aligned box frustum around the origin.
+        CullingFrustum MakeBoxFrustum(const Float32 halfSize, const Float32 minDistance, const Float32 maxDistance) {
+            CullingFrustum frustum;
+            const Float32 planes[6][4] = {{1.0f, 0.0f, 0.0f, halfSize}, {-1.0f, 0.0f, 0.0f, halfSize},
+                                          {0.0f, 1.0f, 0.0f, halfSize}, {0.0f, -1.0f, 0.0f, halfSize},
+                                          {0.0f, 0.0f, 1.0f, halfSize}, {0.0f, 0.0f, -1.0f, halfSize}};
+            std::copy_n(&planes[0][0], 24, &frustum.Planes[0][0]);
+            frustum.MinDistance = minDistance;
+            frustum.MaxDistance = maxDistance;
+
+            return frustum;
+        }
+    }
+
+    void RunCullingTests(TestSuite& suite) {
+        suite.Run("Culling/Frustum", [] {
+            // Points checked in clip space against the planes extracted from the matrix.
+            const Camera camera;
+            const CullingFrustum frustum = MakeCullingFrustum(camera.ViewProjection, camera.Eye);
+            std::mt19937 random(5);
+            std::uniform_real_distribution<Float32> positions(-250.0f, 250.0f);
+            BoundingSphereSet points;
+            for (UInt32 i = 0; i < 4099; ++i) {
+                points.Add({positions(random), positions(random), positions(random)}, 0.0f);
+            }
+            const std::vector<UInt32> visible = CullSpheres(points, frustum, {SimdLevel::Scalar, 1});
+
+            std::vector<bool> isVisible(points.GetCount(), false);
+            for (const UInt32 index : visible) {
+                isVisible[index] = true;
+            }
+            UInt32 mismatchCount = 0;
+            UInt32 insideCount = 0;
+            for (UInt32 i = 0; i < points.GetCount(); ++i) {
+                const Float64 position[4] = {points.GetCenterX()[i], points.GetCenterY()[i], points.GetCenterZ()[i], 1.0};
+                Float64 clip[4] = {};
+                for (UInt32 column = 0; column < 4; ++column) {
+                    for (UInt32 row = 0; row < 4; ++row) {
+                        clip[column] += position[row] * camera.ViewProjection[row][column];
+                    }
+                }
+                const Float64 slack = std::min({clip[3] - std::abs(clip[0]), clip[3] - std::abs(clip[1]), clip[2],
+                                                clip[3] - clip[2]});
+                if (std::abs(slack) >= TouchingMargin) {
+                    mismatchCount += isVisible[i] != (slack > 0.0);
+                    insideCount += slack > 0.0;
+                }
+            }
+            Check(insideCount > 20 && mismatchCount == 0, "the planes bound the clip volume of the matrix");
+        });
+
+        suite.Run("Culling/SimdLevelsMatch", [] {
+            // Counts around the vector widths and not multiples of 8, so that the tails run,
+            // split between threads or not. Every variant gives the indices of the scalar
+            // single-threaded cull, which agrees with the reference in double.
+            const Camera camera;
+            const CullingFrustum frustum = MakeCullingFrustum(camera.ViewProjection, camera.Eye, 120.0f, 5.0f);
+            for (const UInt32 count : {1u, 3u, 7u, 9u, 15u, 17u, 1003u, 20011u}) {
+                const Scene scene(count, count);
+                const std::vector<UInt32> spheres = CullSpheres(scene.Spheres, frustum, {SimdLevel::Scalar, 1});
+                const std::vector<UInt32> boxes = CullBoxes(scene.Boxes, frustum, {SimdLevel::Scalar, 1});
+                Check(MatchesReference(scene.Spheres, spheres, frustum, GetSphereSlack),
+                      "the scalar sphere cull matches the reference");
+                Check(MatchesReference(scene.Boxes, boxes, frustum, GetBoxSlack),
+                      "the scalar box cull matches the reference");
+                if (count > 1000) {
+                    Check(!spheres.empty() && spheres.size() < count / 4 && !boxes.empty() && boxes.size() < count / 4,
+                          "the scene is partly visible");
+                }
+
+                for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                    for (const UInt32 threadCount : {1u, 3u, 8u}) {
+                        const CullingOptions options{level, threadCount, 1};
+                        const std::string variant = std::string(GetSimdLevelName(level)) + " on " +
+                            std::to_string(threadCount) + " thread(s), " + std::to_string(count) + " objects";
+                        Check(CullSpheres(scene.Spheres, frustum, options) == spheres, variant + " culls the scalar spheres");
+                        Check(CullBoxes(scene.Boxes, frustum, options) == boxes, variant + " culls the scalar boxes");
+                    }
+                }
+            }
+        });
+
+        suite.Run("Culling/RangeMerging", [] {
+            // Ranges are whole vectors apart: with many threads and few objects the last ones
+            // are empty, and every range's indices must come back in order.
+            const CullingFrustum everything = MakeBoxFrustum(200.0f, 0.0f, std::numeric_limits<Float32>::infinity());
+            const CullingFrustum nothing = MakeBoxFrustum(200.0f, 1000.0f, 2000.0f);
+            for (const UInt32 count : {17u, 33u, 100u, 4099u}) {
+                BoundingSphereSet spheres;
+                for (UInt32 i = 0; i < count; ++i) {
+                    spheres.Add({static_cast<Float32>(i % 50), 1.0f, -2.0f}, i % 3 == 0 ? 0.5f : 1.0f);
+                }
+
+                std::vector<UInt32> all(count);
+                for (UInt32 i = 0; i < count; ++i) {
+                    all[i] = i;
+                }
+                for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                    for (const UInt32 threadCount : {2u, 5u, 16u}) {
+                        const CullingOptions options{level, threadCount, 1};
+                        Check(CullSpheres(spheres, everything, options) == all, "every range's objects are merged in order");
+                        Check(CullSpheres(spheres, nothing, options).empty(), "empty ranges merge to nothing");
+                    }
+                }
+
+                // Only the objects up to x = 25 visible, so that the visible runs start and end
+                // inside ranges.
+                CullingFrustum some = everything;
+                some.Planes[1][3] = 24.5f;
+                std::vector<UInt32> expected;
+                for (UInt32 i = 0; i < count; ++i) {
+                    if (i % 50 <= 25) {
+                        expected.push_back(i);
+                    }
+                }
+                for (const UInt32 threadCount : {1u, 2u, 5u, 16u}) {
+                    Check(CullSpheres(spheres, some, {SimdLevel::AVX2, threadCount, 1}) == expected,
+                          "partly visible ranges are merged in order");
+                }
+            }
+        });
+
+        suite.Run("Culling/Edges", [] {
+            // Objects exactly touching a plane or a distance limit are kept, the ones just past
+            // it culled, at every level, in the vector lanes and in the tails. The planes and the
+            // distances are checked apart so that only one limit is reached at a time.
+            struct Sphere {
+                Float32 Center[3];
+                Float32 Radius;
+                bool Visible;
+            };
+            struct Box {
+                Float32 Center[3];
+                Float32 Extent[3];
+                bool Visible;
+            };
+            struct Case {
+                const char* Limit;
+                CullingFrustum Frustum;
+                std::vector<Sphere> Spheres;
+                std::vector<Box> Boxes;
+            };
+            const Case cases[] = {
+                {"a plane", MakeBoxFrustum(200.0f, 0.0f, std::numeric_limits<Float32>::infinity()),
+                 {{{-201.0f, 0.0f, 50.0f}, 1.0f, true}, {{-201.0f, 0.0f, 50.0f}, 0.5f, false},
+                  {{0.0f, 202.0f, 50.0f}, 2.0f, true}, {{0.0f, 202.0f, 50.0f}, 1.5f, false},
+                  {{0.0f, 0.0f, -203.0f}, 3.0f, true}, {{0.0f, 0.0f, -203.0f}, 2.5f, false},
+                  {{0.0f, 0.0f, 0.0f}, 0.0f, true}},
+                 {{{-201.0f, 0.0f, 50.0f}, {1.0f, 1.0f, 1.0f}, true}, {{-201.0f, 0.0f, 50.0f}, {0.5f, 9.0f, 9.0f}, false},
+                  {{0.0f, 0.0f, 203.0f}, {1.0f, 1.0f, 3.0f}, true}, {{0.0f, 0.0f, 203.0f}, {1.0f, 1.0f, 2.5f}, false},
+                  {{0.0f, -150.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, true}}},
+                {"a distance", MakeBoxFrustum(1000.0f, 10.0f, 100.0f),
+                 {{{0.0f, 0.0f, 101.0f}, 1.0f, true}, {{0.0f, 0.0f, 101.0f}, 0.5f, false},
+                  {{0.0f, 0.0f, 8.0f}, 2.0f, true}, {{0.0f, 0.0f, 7.5f}, 2.0f, false},
+                  {{0.0f, 0.0f, 0.0f}, 10.0f, true}, {{0.0f, 0.0f, 0.0f}, 9.0f, false},
+                  {{0.0f, 0.0f, 1.0f}, 15.0f, true}, {{0.0f, 60.0f, 80.0f}, 0.0f, true}},
+                 {{{0.0f, 0.0f, 102.0f}, {1.0f, 1.0f, 2.0f}, true}, {{0.0f, 0.0f, 102.0f}, {1.0f, 1.0f, 1.5f}, false},
+                  {{0.0f, 0.0f, 8.0f}, {0.0f, 0.0f, 2.0f}, true}, {{0.0f, 0.0f, 8.0f}, {0.0f, 0.0f, 1.5f}, false},
+                  {{0.0f, 0.0f, 3.0f}, {2.0f, 2.0f, 2.0f}, false}, {{0.0f, 60.0f, 80.0f}, {0.0f, 0.0f, 0.0f}, true}}}
+            };
+
+            for (const Case& edge : cases) {
+                for (UInt32 shift = 0; shift < 9; ++shift) {
+                    // Culled padding first, so that each object lands in every lane.
+                    BoundingSphereSet spheres;
+                    BoundingBoxSet boxes;
+                    std::vector<UInt32> expectedSpheres;
+                    std::vector<UInt32> expectedBoxes;
+                    for (UInt32 i = 0; i < shift; ++i) {
+                        spheres.Add({5000.0f, 0.0f, 0.0f}, 1.0f);
+                        boxes.Add({5000.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f});
+                    }
+                    for (const Sphere& sphere : edge.Spheres) {
+                        if (sphere.Visible) {
+                            expectedSpheres.push_back(spheres.GetCount());
+                        }
+                        spheres.Add(sphere.Center, sphere.Radius);
+                    }
+                    for (const Box& box : edge.Boxes) {
+                        if (box.Visible) {
+                            expectedBoxes.push_back(boxes.GetCount());
+                        }
+                        boxes.Add(box.Center, box.Extent);
+                    }
+
+                    for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                        const std::string name = GetSimdLevelName(level);
+                        Check(CullSpheres(spheres, edge.Frustum, {level, 1}) == expectedSpheres,
+                              name + " keeps the spheres touching " + edge.Limit + " and culls the ones past it");
+                        Check(CullBoxes(boxes, edge.Frustum, {level, 1}) == expectedBoxes,
+                              name + " keeps the boxes touching " + edge.Limit + " and culls the ones past it");
+                    }
+                }
+            }
+        });
+
+        suite.Run("Culling/InvalidArguments", [] {
+            const Scene scene(9, 1);
+            const CullingFrustum frustum = MakeBoxFrustum(200.0f, 0.0f, 100.0f);
+            std::vector<UInt32> visible(8);
+            CheckThrows<std::invalid_argument>([&] { D3D12Tests::CullSpheres(scene.Spheres, frustum, visible); },
+                                               "a visible span smaller than the spheres is rejected");
+            CheckThrows<std::invalid_argument>([&] { D3D12Tests::CullBoxes(scene.Boxes, frustum, visible); },
+                                               "a visible span smaller than the boxes is rejected");
+            Check(D3D12Tests::CullSpheres(BoundingSphereSet(), frustum, {}) == 0 &&
+                  D3D12Tests::CullBoxes(BoundingBoxSet(), frustum, {}) == 0,
+                  "empty sets need no visible span");
+        });
+    }
+}
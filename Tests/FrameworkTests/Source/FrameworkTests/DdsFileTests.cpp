@@ -0,0 +1,230 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/DdsFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // Magic number and legacy header, then the DX10 extension, in 32-bit words.
+        constexpr UInt32 LegacyHeaderWords = 32;
+        constexpr UInt32 Dx10HeaderWords = 37;
+
+        struct DdsDesc {
+            UInt32 Format = DxgiFormat::R8G8B8A8Unorm;
+            // The D3D10_RESOURCE_DIMENSION of the DX10 extension.
+            UInt32 Dimension = 3;
+            UInt32 Width = 1;
+            UInt32 Height = 1;
+            UInt32 Depth = 1;
+            UInt32 MipCount = 1;
+            UInt32 ArraySize = 1;
+            bool IsCubemap = false;
+        };
+
+        std::vector<UInt32> MakeHeader(const DdsDesc& desc) {
+            std::vector<UInt32> header(Dx10HeaderWords, 0);
+            header[0] = 0x20534444;                        // "DDS "
+            header[1] = 124;                               // Header size
+            header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000; // Caps, height, width, pixel format, mip count
+            header[3] = desc.Height;
+            header[4] = desc.Width;
+            header[6] = desc.Depth;
+            header[7] = desc.MipCount;
+            header[19] = 32;                               // Pixel format size
+            header[20] = 0x4;                              // FourCC
+            header[21] = 0x30315844;                       // "DX10"
+            header[27] = 0x1000;                           // Texture
+            header[32] = desc.Format;
+            header[33] = desc.Dimension;
+            header[34] = desc.IsCubemap ? 0x4 : 0;
+            header[35] = desc.ArraySize;
+            if (desc.Dimension == 4) {
+                header[2] |= 0x800000;                     // Depth
+            }
+
+            return header;
+        }
+
+        // The sizes of the subresources in the D3D12 order, for RGBA8 and BC1 only, computed
+        // apart from the layouts of the library.
+        std::vector<UInt64> GetSubresourceSizes(const DdsDesc& desc) {
+            std::vector<UInt64> sizes;
+            const UInt32 sliceCount = desc.ArraySize * (desc.IsCubemap ? 6 : 1);
+            for (UInt32 slice = 0; slice < sliceCount; ++slice) {
+                for (UInt32 mip = 0; mip < desc.MipCount; ++mip) {
+                    const UInt64 width = std::max(desc.Width >> mip, 1u);
+                    const UInt64 height = std::max(desc.Height >> mip, 1u);
+                    const UInt64 depth = std::max(desc.Depth >> mip, 1u);
+                    sizes.push_back(desc.Format == DxgiFormat::BC1Unorm ? (width + 3) / 4 * ((height + 3) / 4) * 8 * depth
+                                                                        : width * height * depth * 4);
+                }
+            }
+
+            return sizes;
+        }
+
+        // The header followed by pixels numbering their bytes, cut or padded to the size.
+        std::filesystem::path WriteDds(const char* name, const std::vector<UInt32>& header, const UInt64 dataSize,
+                                       const UInt64 fileSize) {
+            std::vector<unsigned char> contents(header.size() * 4 + dataSize);
+            std::memcpy(contents.data(), header.data(), header.size() * 4);
+            for (UInt64 i = 0; i < dataSize; ++i) {
+                contents[header.size() * 4 + i] = static_cast<unsigned char>(i * 7 + (i >> 8));
+            }
+            contents.resize(fileSize);
+
+            const std::filesystem::path path = GetScratchDirectory() / name;
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+            if (!file) {
+                throw std::runtime_error("Failed to write " + path.string());
+            }
+
+            return path;
+        }
+
+        UInt64 GetTotalSize(const std::vector<UInt64>& sizes) {
+            UInt64 total = 0;
+            for (const UInt64 size : sizes) {
+                total += size;
+            }
+
+            return total;
+        }
+
+        // Opens a file holding exactly the pixels of the description and checks where each
+        // subresource points, then the same file missing its last byte.
+        void CheckLayout(const char* name, const DdsDesc& desc, const std::vector<UInt32>& header) {
+            const std::vector<UInt64> sizes = GetSubresourceSizes(desc);
+            const UInt64 dataSize = GetTotalSize(sizes);
+            const UInt64 headerSize = header.size() * 4;
+            const DdsFile dds(WriteDds(name, header, dataSize, headerSize + dataSize));
+
+            const UInt32 sliceCount = desc.ArraySize * (desc.IsCubemap ? 6 : 1);
+            Check(dds.GetFormat() == desc.Format && dds.GetWidth() == desc.Width && dds.GetHeight() == desc.Height &&
+                  dds.GetDepth() == desc.Depth && dds.GetMipCount() == desc.MipCount &&
+                  dds.GetArraySize() == sliceCount && dds.IsCubemap() == desc.IsCubemap,
+                  std::string(name) + " has the dimensions of its header");
+            Check(dds.GetSubresources().size() == sizes.size(), std::string(name) + " has a subresource per mip and slice");
+
+            UInt64 offset = headerSize;
+            for (UInt32 slice = 0; slice < sliceCount; ++slice) {
+                for (UInt32 mip = 0; mip < desc.MipCount; ++mip) {
+                    const DdsSubresource& subresource = dds.GetSubresource(mip, slice);
+                    const UInt64 size = sizes[slice * desc.MipCount + mip];
+                    const UInt64 byte = offset - headerSize;
+                    Check(&subresource == &dds.GetSubresources()[slice * desc.MipCount + mip] &&
+                          subresource.Width == std::max(desc.Width >> mip, 1u) &&
+                          subresource.Depth == std::max(desc.Depth >> mip, 1u) &&
+                          subresource.SlicePitch * subresource.Depth == size,
+                          std::string(name) + " sizes each subresource");
+                    Check(subresource.Data == dds.GetSubresources()[0].Data + byte &&
+                          static_cast<unsigned char>(subresource.Data[0]) == static_cast<unsigned char>(byte * 7 + (byte >> 8)),
+                          std::string(name) + " points each subresource at its pixels");
+                    offset += size;
+                }
+            }
+
+            CheckThrows<std::runtime_error>([&] { DdsFile(WriteDds(name, header, dataSize, headerSize + dataSize - 1)); },
+                                            std::string(name) + " missing its last byte is rejected");
+        }
+
+        void CheckRejected(const char* name, const DdsDesc& desc, const std::string& description) {
+            const std::vector<UInt32> header = MakeHeader(desc);
+            const UInt64 dataSize = 1 << 16;
+            const std::filesystem::path path = WriteDds(name, header, dataSize, header.size() * 4 + dataSize);
+            CheckThrows<std::runtime_error>([&] { DdsFile{path}; }, description + " is rejected");
+        }
+    }
+
+    void RunDdsFileTests(TestSuite& suite) {
+        suite.Run("DdsFile/Layouts", [] {
+            // Subresources follow each other slice by slice, each with its mip chain.
+            const DdsDesc array{DxgiFormat::R8G8B8A8Unorm, 3, 16, 8, 1, 5, 3, false};
+            CheckLayout("Array.dds", array, MakeHeader(array));
+
+            const DdsDesc cubes{DxgiFormat::BC1Unorm, 3, 8, 8, 1, 4, 2, true};
+            CheckLayout("Cubes.dds", cubes, MakeHeader(cubes));
+
+            const DdsDesc volume{DxgiFormat::R8G8B8A8Unorm, 4, 8, 4, 4, 4, 1, false};
+            CheckLayout("Volume.dds", volume, MakeHeader(volume));
+
+            // Without the DX10 extension, from the DXT1 FourCC.
+            const DdsDesc legacy{DxgiFormat::BC1Unorm, 3, 20, 12, 1, 5, 1, false};
+            std::vector<UInt32> header = MakeHeader(legacy);
+            header.resize(LegacyHeaderWords);
+            header[21] = 0x31545844; // "DXT1"
+            CheckLayout("Legacy.dds", legacy, header);
+        });
+
+        suite.Run("DdsFile/TruncatedHeaders", [] {
+            const DdsDesc desc{DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 1, 1, false};
+            const std::vector<UInt32> header = MakeHeader(desc);
+            for (const UInt64 size : {0u, 3u, 4u, 127u, 128u, 147u}) {
+                CheckThrows<std::runtime_error>([&] { DdsFile(WriteDds("Truncated.dds", header, 64, size)); },
+                                                "a file cut at " + std::to_string(size) + " bytes is rejected");
+            }
+
+            std::vector<UInt32> legacy = header;
+            legacy.resize(LegacyHeaderWords);
+            legacy[20] = 0x40;       // RGB
+            legacy[22] = 32;
+            legacy[23] = 0xff;
+            legacy[24] = 0xff00;
+            legacy[25] = 0xff0000;
+            legacy[26] = 0xff000000;
+            CheckThrows<std::runtime_error>([&] { DdsFile(WriteDds("Truncated.dds", legacy, 0, 128)); },
+                                            "a legacy header without pixels is rejected");
+
+            std::vector<UInt32> wrongMagic = header;
+            wrongMagic[0] = 0x20534443;
+            CheckThrows<std::runtime_error>([&] { DdsFile(WriteDds("Truncated.dds", wrongMagic, 64, 212)); },
+                                            "a file without the DDS magic number is rejected");
+            std::vector<UInt32> wrongSize = header;
+            wrongSize[1] = 128;
+            CheckThrows<std::runtime_error>([&] { DdsFile(WriteDds("Truncated.dds", wrongSize, 64, 212)); },
+                                            "a header of the wrong size is rejected");
+        });
+
+        suite.Run("DdsFile/InvalidCounts", [] {
+            // 0x2aaaaaab cubes hold 2 faces once counted in 32 bits.
+            const DdsDesc wrappingCubes{DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 1, 0x2aaaaaab, true};
+            CheckRejected("Invalid.dds", wrappingCubes, "an array of cubes wrapping around");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 1, 2049, true},
+                          "an array of more than 2048 cubes");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 1, 2049, false},
+                          "an array of more than 2048 slices");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 1, 0, false}, "an empty array");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 4, 4, 4, 4, 1, 2, false}, "an array of volumes");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 16, 16, 1, 6, 1, false},
+                          "a mip chain longer than the size allows");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 0, 16, 1, 1, 1, false}, "a zero width");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 3, 16385, 1, 1, 1, 1, false},
+                          "a width past the D3D12 limit");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 4, 4, 4, 2049, 1, 1, false},
+                          "a depth past the D3D12 limit");
+            CheckRejected("Invalid.dds", {DxgiFormat::R8G8B8A8Unorm, 5, 4, 4, 1, 1, 1, false}, "an unknown dimension");
+            CheckRejected("Invalid.dds", {DxgiFormat::Unknown, 3, 4, 4, 1, 1, 1, false}, "an unknown format");
+
+            // The largest counts are fine, and a mip count of zero means one mip.
+            const DdsDesc longest{DxgiFormat::R8G8B8A8Unorm, 3, 16, 16, 1, 5, 1, false};
+            CheckLayout("Longest.dds", longest, MakeHeader(longest));
+            DdsDesc noMips{DxgiFormat::R8G8B8A8Unorm, 3, 4, 4, 1, 0, 1, false};
+            const std::vector<UInt32> header = MakeHeader(noMips);
+            noMips.MipCount = 1;
+            CheckLayout("NoMips.dds", noMips, header);
+        });
+    }
+}
@@ -0,0 +1,146 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/TimelineRingAllocator.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // D3D12DescriptorRing only adds the handle arithmetic to a TimelineRingAllocator
+        // counting descriptors, allocating with an alignment of one. The tests drive the same
+        // allocator over a simulated heap, each descriptor holding the frame that wrote it.
+        class SimulatedDescriptorRing {
+        public:
+            SimulatedDescriptorRing(GpuTimeline& timeline, const UInt32 capacity) :
+                m_Allocator(timeline, capacity),
+                m_Heap(capacity, 0) {
+            }
+
+            UInt32 Allocate(const UInt32 count) {
+                const auto index = static_cast<UInt32>(m_Allocator.Allocate(count, 1));
+                Check(index + count <= m_Heap.size(), "a table never wraps around the end of the heap");
+
+                return index;
+            }
+
+            void Write(const UInt32 index, const UInt32 count, const UInt64 frame) {
+                std::fill_n(m_Heap.begin() + index, count, frame);
+            }
+
+            UInt32 CopyTable(const UInt32 count, const UInt64 frame) {
+                const UInt32 index = Allocate(count);
+                Write(index, count, frame);
+
+                return index;
+            }
+
+            bool Holds(const UInt32 index, const UInt32 count, const UInt64 frame) const {
+                return std::all_of(m_Heap.begin() + index, m_Heap.begin() + index + count,
+                                   [frame](const UInt64 value) { return value == frame; });
+            }
+
+            inline UInt64 GetWaitCount() const {
+                return m_Allocator.GetWaitCount();
+            }
+
+        private:
+            TimelineRingAllocator m_Allocator;
+            std::vector<UInt64> m_Heap;
+        };
+
+        struct BoundTable {
+            UInt32 Index;
+            UInt32 Count;
+            UInt64 Frame;
+            UInt64 FenceValue;
+        };
+    }
+
+    void RunDescriptorRingTests(TestSuite& suite) {
+        suite.Run("DescriptorRing/TablesWrapAsAWhole", [] {
+            ManualGpuTimeline timeline;
+            SimulatedDescriptorRing ring(timeline, 16);
+
+            Check(ring.CopyTable(6, 1) == 0 && ring.CopyTable(6, 1) == 6, "tables are packed");
+            timeline.CompleteUpTo(timeline.Signal());
+
+            // 4 descriptors are left at the end: the table starts over at the beginning.
+            Check(ring.CopyTable(5, 2) == 0, "a table not fitting before the end starts over");
+            Check(ring.Holds(0, 5, 2), "the table is written in one piece");
+            Check(timeline.GetWaits().empty(), "the completed frame is not waited for");
+        });
+
+        suite.Run("DescriptorRing/WaitsForTheFrameOverwritten", [] {
+            ManualGpuTimeline timeline;
+            SimulatedDescriptorRing ring(timeline, 16);
+
+            for (UInt64 frame = 1; frame <= 3; ++frame) {
+                ring.CopyTable(5, frame);
+                timeline.Signal();
+            }
+
+            // The fourth frame laps the first one, and only that one.
+            ring.CopyTable(5, 4);
+            Check(timeline.GetWaits().size() == 1 && timeline.GetWaits()[0] == 1, "the first frame is waited for");
+            Check(ring.Holds(5, 5, 2) && ring.Holds(10, 5, 3), "the frames in flight are untouched");
+        });
+
+        suite.Run("DescriptorRing/FramesInFlight", [] {
+            // Frames bind random tables while the GPU lags one to three frames behind. When a
+            // frame completes, which may happen while the ring waits for it, every table it
+            // bound must still hold its descriptors.
+            std::mt19937 random(4);
+            ManualGpuTimeline timeline;
+            SimulatedDescriptorRing ring(timeline, 256);
+            std::deque<BoundTable> tablesInFlight;
+
+            const auto checkCompletedTables = [&] {
+                const UInt64 completedValue = timeline.GetCompletedValue();
+                while (!tablesInFlight.empty() && tablesInFlight.front().FenceValue <= completedValue) {
+                    const BoundTable& table = tablesInFlight.front();
+                    Check(ring.Holds(table.Index, table.Count, table.Frame),
+                          "a table is not overwritten before its frame completes");
+                    tablesInFlight.pop_front();
+                }
+            };
+
+            for (UInt64 frame = 1; frame <= 5000; ++frame) {
+                const UInt32 tableCount = 1 + random() % 12;
+                for (UInt32 i = 0; i < tableCount; ++i) {
+                    const UInt32 count = 1 + random() % 16;
+                    const UInt32 index = ring.Allocate(count);
+                    checkCompletedTables();
+
+                    ring.Write(index, count, frame);
+                    tablesInFlight.push_back({index, count, frame, timeline.GetLastSignaledValue() + 1});
+                }
+                timeline.Signal();
+
+                const UInt64 lag = 1 + random() % 3;
+                if (frame > lag) {
+                    timeline.CompleteUpTo(frame - lag);
+                }
+                checkCompletedTables();
+            }
+
+            Check(ring.GetWaitCount() != 0, "the ring laps the GPU");
+            Check(ring.GetWaitCount() == timeline.GetWaits().size(), "every wait goes through the timeline");
+        });
+
+        suite.Run("DescriptorRing/TableLargerThanHeap", [] {
+            ManualGpuTimeline timeline;
+            SimulatedDescriptorRing ring(timeline, 16);
+            CheckThrows<std::length_error>([&ring] { ring.CopyTable(17, 1); }, "a table larger than the heap throws");
+        });
+    }
+}
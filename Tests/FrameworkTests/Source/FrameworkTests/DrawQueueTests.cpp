@@ -0,0 +1,194 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/DrawQueue.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        bool IsSamePacket(const DrawPacket& a, const DrawPacket& b) {
+            return a.Key == b.Key && a.Geometry == b.Geometry && a.Instance == b.Instance;
+        }
+
+        bool IsSameBatch(const DrawBatch& a, const DrawBatch& b) {
+            return a.Key == b.Key && a.Geometry == b.Geometry && a.FirstInstance == b.FirstInstance &&
+                a.InstanceCount == b.InstanceCount;
+        }
+
+        // The state of a draw, its key without the depth.
+        UInt64 GetState(const UInt64 key) {
+            return key >> DrawKeyDepthBits;
+        }
+
+        // Pushes the packets, sorts them and checks the queue against std::stable_sort and
+        // batches merged one packet at a time.
+        void SortAndCheck(DrawQueue& queue, const std::vector<DrawPacket>& packets) {
+            queue.Clear();
+            for (const DrawPacket& packet : packets) {
+                queue.Push(packet);
+            }
+            queue.Sort();
+
+            std::vector<DrawPacket> sorted = packets;
+            std::ranges::stable_sort(sorted, {}, &DrawPacket::Key);
+            Check(std::ranges::equal(queue.GetPackets(), sorted, IsSamePacket), "the packets are sorted stably by key");
+
+            std::vector<DrawBatch> batches;
+            for (UInt32 i = 0; i < sorted.size(); ++i) {
+                if (i == 0 || GetState(sorted[i].Key) != GetState(sorted[i - 1].Key) ||
+                    sorted[i].Geometry != sorted[i - 1].Geometry) {
+                    batches.push_back({sorted[i].Key, sorted[i].Geometry, i, 0});
+                }
+                ++batches.back().InstanceCount;
+            }
+            Check(std::ranges::equal(queue.GetBatches(), batches, IsSameBatch), "the batches merge the runs of one state and geometry");
+
+            const std::span<const UInt32> instances = queue.GetInstances();
+            Check(instances.size() == sorted.size(), "every packet has an instance");
+            for (const DrawBatch& batch : queue.GetBatches()) {
+                for (UInt32 i = batch.FirstInstance; i < batch.FirstInstance + batch.InstanceCount; ++i) {
+                    Check(instances[i] == sorted[i].Instance && sorted[i].Geometry == batch.Geometry &&
+                          GetState(sorted[i].Key) == GetState(batch.Key),
+                          "the instance range of a batch holds the instances of its packets");
+                }
+            }
+        }
+
+        // Keys equal but for the bits of the mask, random there, and instances in push order.
+        std::vector<DrawPacket> MakePackets(const UInt32 count, const UInt64 mask, const UInt32 geometryCount,
+                                            const UInt32 seed) {
+            std::mt19937_64 random(seed);
+            const UInt64 base = random();
+            std::vector<DrawPacket> packets;
+            for (UInt32 i = 0; i < count; ++i) {
+                packets.push_back({base ^ (random() & mask), static_cast<UInt32>(random() % geometryCount), i});
+            }
+
+            return packets;
+        }
+    }
+
+    void RunDrawQueueTests(TestSuite& suite) {
+        suite.Run("DrawQueue/EmptyAndSingle", [] {
+            DrawQueue queue;
+            queue.Sort();
+            Check(queue.GetPackets().empty() && queue.GetBatches().empty() && queue.GetInstances().empty(),
+                  "an empty queue sorts to nothing");
+
+            const UInt64 key = MakeDrawKey(2, 5, 7, 11);
+            queue.Push(key, 3, 42);
+            queue.Sort();
+            Check(queue.GetPacketCount() == 1 && IsSamePacket(queue.GetPackets()[0], {key, 3, 42}),
+                  "a single packet stays as is");
+            Check(queue.GetBatches().size() == 1 && IsSameBatch(queue.GetBatches()[0], {key, 3, 0, 1}) &&
+                  queue.GetInstances().size() == 1 && queue.GetInstances()[0] == 42,
+                  "a single packet makes a batch of one instance");
+
+            queue.Clear();
+            queue.Sort();
+            Check(queue.GetPackets().empty() && queue.GetBatches().empty() && queue.GetInstances().empty(),
+                  "a cleared queue sorts to nothing");
+        });
+
+        suite.Run("DrawQueue/StableOnEqualKeys", [] {
+            // Every byte equal, so every pass is skipped and the push order stays.
+            DrawQueue queue;
+            SortAndCheck(queue, MakePackets(1000, 0, 1, 1));
+            Check(queue.GetBatches().size() == 1, "equal keys and geometries make one batch");
+
+            // Few keys, so that long runs of equal keys are moved by every pass.
+            std::vector<DrawPacket> packets = MakePackets(3001, 0x0101'0000'0000'0101, 4, 2);
+            SortAndCheck(queue, packets);
+            for (UInt32 i = 1; i < queue.GetPacketCount(); ++i) {
+                const DrawPacket& previous = queue.GetPackets()[i - 1];
+                const DrawPacket& packet = queue.GetPackets()[i];
+                Check(previous.Key != packet.Key || previous.Instance < packet.Instance,
+                      "packets of equal keys keep their push order");
+            }
+        });
+
+        suite.Run("DrawQueue/ConstantBytes", [] {
+            // Keys differing only in their high bytes, only in their low bytes or in both, so
+            // that odd and even numbers of passes run and the others are skipped.
+            const UInt64 masks[] = {
+                0xff00'0000'0000'0000, 0xffff'0000'0000'0000, 0x0000'0000'0000'00ff, 0x0000'0000'0000'ffff,
+                0x0000'00ff'ff00'0000, 0xff00'0000'0000'00ff, 0x8000'0000'0000'0001, ~UInt64(0)
+            };
+            DrawQueue queue;
+            UInt32 seed = 0;
+            for (const UInt64 mask : masks) {
+                for (const UInt32 count : {2u, 3u, 255u, 256u, 257u, 5000u}) {
+                    SortAndCheck(queue, MakePackets(count, mask, 3, ++seed));
+                }
+            }
+        });
+
+        suite.Run("DrawQueue/Batches", [] {
+            // Depths merge, any other field or the geometry splits, and each batch points at
+            // the instances of its packets.
+            DrawQueue queue;
+            std::vector<DrawPacket> packets = {
+                {MakeDrawKey(0, 1, 1, 30), 7, 100}, {MakeDrawKey(0, 1, 1, 10), 7, 101},
+                {MakeDrawKey(0, 1, 1, 20), 7, 102}, {MakeDrawKey(0, 1, 1, 25), 8, 103},
+                {MakeDrawKey(0, 1, 2, 5), 7, 104}, {MakeDrawKey(0, 2, 1, 5), 7, 105},
+                {MakeDrawKey(1, 1, 1, 5), 7, 106}, {MakeDrawKey(0, 1, 1, 10), 7, 107}
+            };
+            SortAndCheck(queue, packets);
+
+            const DrawBatch expected[] = {
+                {MakeDrawKey(0, 1, 1, 10), 7, 0, 3}, {MakeDrawKey(0, 1, 1, 25), 8, 3, 1},
+                {MakeDrawKey(0, 1, 1, 30), 7, 4, 1}, {MakeDrawKey(0, 1, 2, 5), 7, 5, 1},
+                {MakeDrawKey(0, 2, 1, 5), 7, 6, 1}, {MakeDrawKey(1, 1, 1, 5), 7, 7, 1}
+            };
+            Check(std::ranges::equal(queue.GetBatches(), expected, IsSameBatch), "the batches split on state and geometry");
+            const UInt32 instances[] = {101, 107, 102, 103, 100, 104, 105, 106};
+            Check(std::ranges::equal(queue.GetInstances(), instances), "the instances follow the sorted packets");
+
+            const DrawStateChanges packetChanges = CountDrawStateChanges(queue.GetPackets());
+            const DrawStateChanges batchChanges = CountDrawStateChanges(queue.GetBatches());
+            Check(packetChanges.DrawCount == 8 && batchChanges.DrawCount == 6, "batches draw fewer times");
+            Check(batchChanges.PipelineChanges == packetChanges.PipelineChanges &&
+                  batchChanges.MaterialChanges == packetChanges.MaterialChanges &&
+                  batchChanges.GeometryChanges == packetChanges.GeometryChanges,
+                  "batching changes no state");
+        });
+
+        suite.Run("DrawQueue/Reuse", [] {
+            // Sorting again or after Clear starts over from the pushed packets.
+            DrawQueue queue;
+            queue.Reserve(100);
+            SortAndCheck(queue, MakePackets(777, 0xff00'0000'00ff'0000, 5, 3));
+            const std::vector<DrawPacket> sorted(queue.GetPackets().begin(), queue.GetPackets().end());
+            const std::vector<DrawBatch> batches(queue.GetBatches().begin(), queue.GetBatches().end());
+            queue.Sort();
+            Check(std::ranges::equal(queue.GetPackets(), sorted, IsSamePacket) && std::ranges::equal(queue.GetBatches(), batches, IsSameBatch),
+                  "sorting twice changes nothing");
+
+            SortAndCheck(queue, MakePackets(100, ~UInt64(0), 2, 4));
+            SortAndCheck(queue, MakePackets(1, ~UInt64(0), 2, 5));
+        });
+
+        suite.Run("DrawQueue/Keys", [] {
+            const UInt64 key = MakeDrawKey(255, 4095, (1u << 20) - 1, 12345);
+            Check(GetDrawKeyLayer(key) == 255 && GetDrawKeyPipeline(key) == 4095 &&
+                  GetDrawKeyMaterial(key) == (1u << 20) - 1 && GetDrawKeyDepth(key) == 12345,
+                  "the fields round trip");
+            Check(MakeDrawKey(1, 0, 0, 0) > MakeDrawKey(0, 4095, (1u << 20) - 1, (1u << 24) - 1),
+                  "the layer sorts first");
+            CheckThrows<std::invalid_argument>([] { MakeDrawKey(256, 0, 0, 0); }, "a layer too large is rejected");
+            CheckThrows<std::invalid_argument>([] { MakeDrawKey(0, 0, 0, 1u << 24); }, "a depth too large is rejected");
+            Check(QuantizeDrawDepth(0.0f, 10.0f) == 0 && QuantizeDrawDepth(20.0f, 10.0f) == (1u << 24) - 1 &&
+                  QuantizeDrawDepth(0.0f, 10.0f, true) == (1u << 24) - 1, "depths are clamped and reversed");
+        });
+    }
+}
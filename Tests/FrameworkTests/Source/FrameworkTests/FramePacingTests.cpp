@@ -0,0 +1,159 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/FixedTimestep.hpp"
+#include "Framework/FrameLimiter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+    using namespace std::chrono_literals;
+
+    namespace {
+        using Clock = FrameLimiterClock::Clock;
+
+        // Simulated time: reading the clock and pausing cost a few tens of nanoseconds, and a
+        // sleep takes what the timer model decides.
+        class SimulatedClock final : public FrameLimiterClock {
+        public:
+            using SleepModel = std::function<Clock::duration(Clock::duration)>;
+
+            explicit SimulatedClock(SleepModel sleepModel) : m_SleepModel(std::move(sleepModel)) {
+            }
+
+            Clock::time_point Now() override {
+                m_Now += 30ns;
+                return m_Now;
+            }
+
+            void Sleep(const Clock::duration duration) override {
+                m_Now += m_SleepModel(duration);
+            }
+
+            void Pause() override {
+                m_Now += 40ns;
+            }
+
+            void Advance(const Clock::duration duration) {
+                m_Now += duration;
+            }
+
+            Clock::time_point GetTime() const {
+                return m_Now;
+            }
+
+        private:
+            SleepModel m_SleepModel;
+            Clock::time_point m_Now;
+        };
+
+        struct PacingResult {
+            Clock::duration MaxLateness;
+            Clock::duration MaxDeviation;
+            Clock::duration SpinTimePerFrame;
+        };
+
+        // Paces frames at 144 Hz like FrameLoop, with the frame's work taking 0.5 to 5 ms.
+        // The first frames teach the limiter the sleep cost and are not measured.
+        PacingResult Pace(SimulatedClock& clock, FrameLimiter& limiter, const UInt32 frameCount) {
+            constexpr UInt32 WarmupFrameCount = 16;
+            const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<Float64>(1.0 / 144.0));
+
+            std::mt19937 random(7);
+            std::uniform_int_distribution<Int64> workTime(500000, 5000000);
+            PacingResult result = {};
+            Clock::time_point deadline = clock.GetTime() + period;
+            Clock::time_point previousStart;
+            Clock::duration spinTimeBefore = Clock::duration::zero();
+
+            for (UInt32 frame = 0; frame < WarmupFrameCount + frameCount; ++frame) {
+                limiter.WaitUntil(deadline);
+                const Clock::time_point start = clock.GetTime();
+
+                if (frame == WarmupFrameCount) {
+                    spinTimeBefore = limiter.GetTotalSpinTime();
+                } else if (frame > WarmupFrameCount) {
+                    const Clock::duration deviation = start - previousStart - period;
+                    result.MaxLateness = std::max(result.MaxLateness, start - deadline);
+                    result.MaxDeviation = std::max(result.MaxDeviation, deviation < 0ns ? -deviation : deviation);
+                }
+
+                previousStart = start;
+                deadline += period;
+                clock.Advance(std::chrono::nanoseconds(workTime(random)));
+            }
+            result.SpinTimePerFrame = (limiter.GetTotalSpinTime() - spinTimeBefore) / frameCount;
+
+            return result;
+        }
+    }
+
+    void RunFramePacingTests(TestSuite& suite) {
+        suite.Run("FrameLimiter/JitterAt144Hz", [] {
+            // A Linux-like timer under load: a 1 ms sleep takes 1.05 to 1.5 ms.
+            std::mt19937 random(8);
+            SimulatedClock clock([&random](const Clock::duration duration) {
+                return duration + 50us + std::chrono::microseconds(random() % 450);
+            });
+            FrameLimiter limiter(clock);
+
+            const PacingResult result = Pace(clock, limiter, 2000);
+            Check(result.MaxLateness < 200us, "every frame starts less than 0.2 ms after its deadline");
+            Check(result.MaxDeviation < 200us, "frame times stay within 0.2 ms of the period");
+            Check(result.SpinTimePerFrame < 2ms, "the limiter sleeps most of the wait");
+        });
+
+        suite.Run("FrameLimiter/CoarseTimer", [] {
+            // A 15.6 ms timer, like Windows without timeBeginPeriod: every sleep takes a whole
+            // tick. The limiter learns it and spins instead of oversleeping.
+            SimulatedClock clock([](const Clock::duration duration) {
+                return std::max<Clock::duration>(duration, 15600us);
+            });
+            FrameLimiter limiter(clock);
+
+            const PacingResult result = Pace(clock, limiter, 500);
+            Check(limiter.GetSleepEstimate() >= 15600us, "the estimate covers a tick");
+            Check(result.MaxLateness < 200us && result.MaxDeviation < 200us,
+                  "frames stay within 0.2 ms once the tick is learned");
+        });
+
+        suite.Run("FrameLimiter/SystemClock", [] {
+            // The real clock, on a machine that may be loaded: only the median is bounded, a
+            // thread preempted while spinning misses its deadline whatever the limiter does.
+            FrameLimiter limiter;
+            std::vector<Clock::duration> latenesses;
+            Clock::time_point deadline = Clock::now();
+            for (UInt32 i = 0; i < 60; ++i) {
+                deadline += 3ms;
+                limiter.WaitUntil(deadline);
+                latenesses.push_back(Clock::now() - deadline);
+            }
+
+            std::ranges::nth_element(latenesses, latenesses.begin() + latenesses.size() / 2);
+            Check(latenesses[latenesses.size() / 2] < 200us, "the median lateness is below 0.2 ms");
+        });
+
+        suite.Run("FixedTimestep/Accumulates", [] {
+            FixedTimestep timestep(0.01, 4);
+            Check(timestep.Advance(0.025) == 2 && std::abs(timestep.GetAlpha() - 0.5) < 1e-9,
+                  "whole steps are run and the rest interpolates");
+            Check(timestep.Advance(0.005) == 1 && timestep.GetAlpha() < 1e-9, "the rest carries over");
+            Check(timestep.Advance(-1.0) == 0, "negative deltas are ignored");
+
+            Check(timestep.Advance(0.1) == 4 && timestep.GetDroppedUpdateCount() == 6,
+                  "updates past the maximum are dropped");
+            Check(timestep.GetUpdateCount() == 7, "the updates run are counted");
+
+            CheckThrows<std::invalid_argument>([] { FixedTimestep invalid(0.0); }, "a zero step is rejected");
+        });
+    }
+}
@@ -0,0 +1,141 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/FrameRing.hpp"
+
+#include <chrono>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        struct TestFrame {
+            UInt32 UseCount = 0;
+        };
+
+        // Runs frames with a GPU lagging the given number of frames behind the CPU, and
+        // checks every wait of the ring against the context it reuses.
+        void CheckLaggingGpu(const UInt32 frameCount, const UInt32 lag) {
+            constexpr UInt32 FramesRun = 20;
+
+            ManualGpuTimeline timeline;
+            FrameRing<TestFrame> ring(timeline, frameCount);
+
+            UInt64 expectedWaitCount = 0;
+            for (UInt32 frame = 0; frame < FramesRun; ++frame) {
+                TestFrame& resources = ring.BeginFrame();
+                Check(&resources == &ring.GetFrame(frame % frameCount), "contexts are reused in ring order");
+                Check(ring.GetFrameIndex() == frame % frameCount, "the frame index follows the ring order");
+
+                // The context was last used by frame - frameCount, which signaled that frame's
+                // number plus one. Its reuse waits for it unless the GPU has finished it.
+                if (frame >= frameCount && lag >= frameCount) {
+                    ++expectedWaitCount;
+                    Check(timeline.GetWaits().size() == expectedWaitCount &&
+                              timeline.GetWaits().back() == frame - frameCount + 1,
+                          "the ring waits for the last frame of the context it reuses");
+                }
+                Check(timeline.GetWaits().size() == expectedWaitCount, "the ring only waits when it laps the GPU");
+
+                ++resources.UseCount;
+                Check(ring.EndFrame() == frame + 1, "each frame signals the next timeline value");
+                if (frame + 1 > lag) {
+                    timeline.CompleteUpTo(frame + 1 - lag);
+                }
+            }
+
+            Check(ring.GetWaitCount() == expectedWaitCount, "the wait count matches the waits");
+            Check(ring.GetFrameNumber() == FramesRun, "every frame is counted");
+            for (UInt32 i = 0; i < frameCount; ++i) {
+                Check(ring.GetFrame(i).UseCount == (FramesRun + frameCount - 1 - i) / frameCount,
+                      "every context is used in turn");
+            }
+        }
+    }
+
+    void RunFrameRingTests(TestSuite& suite) {
+        suite.Run("FrameRing/RejectsEmptyRing", [] {
+            ManualGpuTimeline timeline;
+            CheckThrows<std::invalid_argument>([&timeline] { FrameRing<TestFrame> ring(timeline, 0); },
+                                               "a ring without frames is rejected");
+        });
+
+        suite.Run("FrameRing/WaitsWhenLappingGpu", [] {
+            for (UInt32 frameCount = 1; frameCount <= 4; ++frameCount) {
+                for (UInt32 lag = 0; lag <= 5; ++lag) {
+                    CheckLaggingGpu(frameCount, lag);
+                }
+            }
+        });
+
+        suite.Run("FrameRing/StalledGpu", [] {
+            // Nothing completes unless waited on: the first frameCount frames run ahead, then
+            // each frame waits for the one frameCount before it, in order.
+            ManualGpuTimeline timeline;
+            FrameRing<TestFrame> ring(timeline, 3);
+            for (UInt32 frame = 0; frame < 9; ++frame) {
+                ring.BeginFrame();
+                ring.EndFrame();
+            }
+
+            const std::span<const UInt64> waits = timeline.GetWaits();
+            Check(waits.size() == 6, "every frame past the third waits");
+            for (UInt32 i = 0; i < waits.size(); ++i) {
+                Check(waits[i] == i + 1, "frames are waited for in submission order");
+            }
+        });
+
+        suite.Run("FrameRing/ResetsTransientMemory", [] {
+            ManualGpuTimeline timeline;
+            FrameRing<TestFrame> ring(timeline, 2, 1024);
+
+            ring.BeginFrame();
+            LinearAllocator& first = ring.GetTransientAllocator();
+            first.Allocate(256);
+            ring.EndFrame();
+
+            ring.BeginFrame();
+            Check(&ring.GetTransientAllocator() != &first, "each context has its own transient memory");
+            ring.GetTransientAllocator().Allocate(128);
+            Check(first.GetUsedSize() >= 256, "the memory of a frame in flight is kept");
+            ring.EndFrame();
+
+            ring.BeginFrame();
+            Check(&ring.GetTransientAllocator() == &first && first.GetUsedSize() == 0,
+                  "the memory of a context is reset when it is reused");
+            Check(timeline.IsComplete(1), "the frame that used it has completed");
+        });
+
+        suite.Run("FrameRing/Flush", [] {
+            ManualGpuTimeline timeline;
+            FrameRing<TestFrame> ring(timeline, 3);
+            for (UInt32 frame = 0; frame < 2; ++frame) {
+                ring.BeginFrame();
+                ring.EndFrame();
+            }
+
+            ring.Flush();
+            Check(timeline.GetCompletedValue() == timeline.GetLastSignaledValue(), "a flush completes every frame");
+            Check(ring.GetWaitCount() == 0, "a flush is not a wait to reuse a context");
+        });
+
+        suite.Run("FrameRing/SimulatedGpu", [] {
+            // With a GPU slower than the CPU, the ring must always hand out contexts whose
+            // last frame has completed, whatever the timing.
+            SimulatedGpuTimeline timeline(std::chrono::microseconds(200));
+            FrameRing<UInt64> ring(timeline, 2);
+            for (UInt32 frame = 0; frame < 50; ++frame) {
+                UInt64& lastFenceValue = ring.BeginFrame();
+                Check(timeline.IsComplete(lastFenceValue), "a context is only reused once its frame completed");
+                lastFenceValue = ring.EndFrame();
+            }
+
+            Check(ring.GetWaitCount() != 0, "the CPU ends up waiting for a slower GPU");
+            ring.Flush();
+        });
+    }
+}
@@ -0,0 +1,239 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // One counter per job, so that a job run twice or never is caught.
+        class RunCounts {
+        public:
+            explicit RunCounts(const size_t count) : m_Counts(std::make_unique<std::atomic<UInt32>[]>(count)),
+                                                     m_Size(count) {
+            }
+
+            void Increment(const size_t index) {
+                m_Counts[index].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            bool AreAllOne() const {
+                for (size_t i = 0; i < m_Size; ++i) {
+                    if (m_Counts[i] != 1) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+        private:
+            std::unique_ptr<std::atomic<UInt32>[]> m_Counts;
+            size_t m_Size;
+        };
+    }
+
+    void RunJobSystemTests(TestSuite& suite) {
+        suite.Run("WorkStealingDeque/Order", [] {
+            WorkStealingDeque<UInt32> deque(3);
+            UInt32 items[4] = {0, 1, 2, 3};
+            Check(deque.GetCapacity() == 4, "the capacity is rounded up to a power of two");
+            for (UInt32& item : items) {
+                Check(deque.Push(&item), "the deque takes up to its capacity");
+            }
+            Check(!deque.Push(&items[0]), "a full deque rejects the push");
+
+            Check(deque.Pop() == &items[3] && deque.Steal() == &items[0], "the owner pops the newest, thieves the oldest");
+            Check(deque.Pop() == &items[2] && deque.Pop() == &items[1], "the owner pops in reverse order");
+            Check(deque.Pop() == nullptr && deque.Steal() == nullptr, "an empty deque returns nothing");
+        });
+
+        suite.Run("WorkStealingDeque/ConcurrentSteals", [] {
+            // The owner pushes and pops while thieves steal: every item must be taken once.
+            constexpr UInt32 ItemCount = 200000;
+            constexpr UInt32 ThiefCount = 3;
+
+            std::vector<UInt32> items(ItemCount);
+            for (UInt32 i = 0; i < ItemCount; ++i) {
+                items[i] = i;
+            }
+
+            WorkStealingDeque<UInt32> deque(256);
+            RunCounts takenCounts(ItemCount);
+            std::atomic<bool> done = false;
+
+            std::vector<std::thread> thieves;
+            for (UInt32 i = 0; i < ThiefCount; ++i) {
+                thieves.emplace_back([&] {
+                    while (!done.load(std::memory_order_acquire) || deque.GetSize() != 0) {
+                        if (const UInt32* pItem = deque.Steal()) {
+                            takenCounts.Increment(*pItem);
+                        }
+                    }
+                });
+            }
+
+            std::mt19937 random(5);
+            for (UInt32 i = 0; i < ItemCount; ++i) {
+                while (!deque.Push(&items[i])) {
+                    if (const UInt32* pItem = deque.Pop()) {
+                        takenCounts.Increment(*pItem);
+                    }
+                }
+                if (random() % 3 == 0) {
+                    if (const UInt32* pItem = deque.Pop()) {
+                        takenCounts.Increment(*pItem);
+                    }
+                }
+            }
+            while (const UInt32* pItem = deque.Pop()) {
+                takenCounts.Increment(*pItem);
+            }
+            done.store(true, std::memory_order_release);
+            for (std::thread& thief : thieves) {
+                thief.join();
+            }
+
+            Check(takenCounts.AreAllOne(), "every item is taken exactly once");
+        });
+
+        suite.Run("JobSystem/RunsEveryJobOnce", [] {
+            // Jobs schedule more jobs, and a small deque sends some of them down the inline path
+            // taken when it is full. Another thread schedules through the shared queue.
+            constexpr UInt32 JobCount = 20000;
+            constexpr UInt32 ExternalJobCount = 5000;
+
+            JobSystem jobSystem(8, 64);
+            RunCounts runCounts(JobCount * 2 + ExternalJobCount);
+            JobCounter counter;
+
+            std::jthread externalThread([&] {
+                JobCounter externalCounter;
+                for (UInt32 i = 0; i < ExternalJobCount; ++i) {
+                    jobSystem.Schedule([&runCounts, i] { runCounts.Increment(JobCount * 2 + i); }, &externalCounter);
+                }
+                jobSystem.Wait(externalCounter);
+            });
+
+            for (UInt32 i = 0; i < JobCount; ++i) {
+                jobSystem.Schedule([&, i] {
+                    runCounts.Increment(i);
+                    jobSystem.Schedule([&runCounts, i] { runCounts.Increment(JobCount + i); }, &counter);
+                }, &counter);
+            }
+            jobSystem.Wait(counter);
+            externalThread.join();
+
+            Check(counter.IsDone() && counter.GetValue() == 0, "the counter reaches zero");
+            Check(runCounts.AreAllOne(), "every job runs exactly once");
+            Check(jobSystem.GetExecutedCount() <= JobCount * 2 + ExternalJobCount, "no job is counted twice");
+        });
+
+        suite.Run("JobSystem/DependenciesOrderJobs", [] {
+            // Random layers of jobs, each depending on random earlier layers. A job must start
+            // after every job of its dependencies finished.
+            constexpr UInt32 LayerCount = 40;
+            constexpr UInt32 JobsPerLayer = 50;
+
+            std::mt19937 random(6);
+            JobSystem jobSystem(8);
+            for (UInt32 round = 0; round < 10; ++round) {
+                std::vector<std::unique_ptr<JobCounter>> counters;
+                std::vector<std::unique_ptr<std::atomic<UInt32>>> finishedCounts;
+                std::atomic<UInt32> violationCount = 0;
+                // The jobs index the vectors while later layers are added.
+                counters.reserve(LayerCount);
+                finishedCounts.reserve(LayerCount);
+
+                for (UInt32 layer = 0; layer < LayerCount; ++layer) {
+                    std::vector<JobCounter*> dependencies;
+                    std::vector<UInt32> dependencyLayers;
+                    for (UInt32 previous = 0; previous < layer; ++previous) {
+                        if (previous + 1 == layer || random() % 6 == 0) {
+                            dependencies.push_back(counters[previous].get());
+                            dependencyLayers.push_back(previous);
+                        }
+                    }
+
+                    counters.push_back(std::make_unique<JobCounter>());
+                    finishedCounts.push_back(std::make_unique<std::atomic<UInt32>>(0));
+                    for (UInt32 i = 0; i < JobsPerLayer; ++i) {
+                        jobSystem.Schedule([&, layer, dependencyLayers] {
+                            for (const UInt32 previous : dependencyLayers) {
+                                if (*finishedCounts[previous] != JobsPerLayer) {
+                                    ++violationCount;
+                                }
+                            }
+                            ++*finishedCounts[layer];
+                        }, counters.back().get(), dependencies);
+                    }
+                }
+
+                jobSystem.Wait(*counters.back());
+                for (const std::unique_ptr<JobCounter>& counter : counters) {
+                    jobSystem.Wait(*counter);
+                }
+                Check(violationCount == 0, "a job only starts once its dependencies are done");
+                for (const std::unique_ptr<std::atomic<UInt32>>& finishedCount : finishedCounts) {
+                    Check(*finishedCount == JobsPerLayer, "every job ran");
+                }
+            }
+        });
+
+        suite.Run("JobSystem/WaitRethrows", [] {
+            JobSystem jobSystem(4);
+            JobCounter counter;
+            std::atomic<UInt32> runCount = 0;
+            for (UInt32 i = 0; i < 100; ++i) {
+                jobSystem.Schedule([&runCount, i] {
+                    ++runCount;
+                    if (i % 10 == 3) {
+                        throw std::runtime_error("Job failed.");
+                    }
+                }, &counter);
+            }
+
+            CheckThrows<std::runtime_error>([&] { jobSystem.Wait(counter); }, "Wait rethrows a job's exception");
+            Check(runCount == 100 && counter.IsDone(), "the other jobs still run");
+
+            // The exception is consumed, the counter can be reused.
+            jobSystem.Schedule([&runCount] { ++runCount; }, &counter);
+            jobSystem.Wait(counter);
+            Check(runCount == 101, "a waited counter is reused");
+
+            // Jobs depending on a failed counter still run.
+            JobCounter failed;
+            JobCounter dependent;
+            jobSystem.Schedule([] { throw std::logic_error("Job failed."); }, &failed);
+            JobCounter* const dependencies[] = {&failed};
+            jobSystem.Schedule([&runCount] { ++runCount; }, &dependent, dependencies);
+            jobSystem.Wait(dependent);
+            CheckThrows<std::logic_error>([&] { jobSystem.Wait(failed); }, "the exception stays with its counter");
+            Check(runCount == 102, "the dependent job ran");
+        });
+
+        suite.Run("JobSystem/ParallelFor", [] {
+            JobSystem jobSystem(6);
+            std::vector<UInt32> values(100003, 0);
+            jobSystem.ParallelFor(values.size(), 37, [&values](const UInt64 begin, const UInt64 end) {
+                for (UInt64 i = begin; i < end; ++i) {
+                    ++values[i];
+                }
+            });
+            Check(std::ranges::all_of(values, [](const UInt32 value) { return value == 1; }),
+                  "every index is visited once");
+        });
+    }
+}
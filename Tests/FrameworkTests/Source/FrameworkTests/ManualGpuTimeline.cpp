@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    // Long enough for no submission to complete during a test.
+    ManualGpuTimeline::ManualGpuTimeline() :
+        m_Simulated(std::chrono::hours(24)),
+        m_CompletedQueryCount(0) {
+    }
+
+    UInt64 ManualGpuTimeline::Signal() {
+        const UInt64 value = m_Simulated.Signal();
+        m_LastSignaledValue.store(value, std::memory_order_release);
+        return value;
+    }
+
+    UInt64 ManualGpuTimeline::GetCompletedValue() {
+        ++m_CompletedQueryCount;
+        return m_Simulated.GetCompletedValue();
+    }
+
+    void ManualGpuTimeline::WaitForValue(const UInt64 value) {
+        if (value > GetLastSignaledValue()) {
+            throw std::logic_error("Waiting on a fence value that was never signaled.");
+        }
+
+        m_Waits.push_back(value);
+        m_Simulated.CompleteUpTo(value);
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/MappedFile.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        std::filesystem::path GetFilePath(const char* name) {
+            std::filesystem::path path = GetScratchDirectory() / name;
+            std::filesystem::remove(path);
+
+            return path;
+        }
+
+        // The open file descriptors of the process where /proc lists them, 0 elsewhere.
+        UInt64 CountOpenFiles() {
+            const std::filesystem::path directory = "/proc/self/fd";
+            std::error_code error;
+            UInt64 count = 0;
+            for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+                ++count;
+            }
+
+            return count;
+        }
+    }
+
+    void RunMappedFileTests(TestSuite& suite) {
+        suite.Run("MappedFile/ReadWrite", [] {
+            const std::filesystem::path path = GetFilePath("Mapped.bin");
+            MappedFile file(path, MappedFileMode::ReadWrite);
+            Check(file.IsOpen() && file.GetSize() == 0 && file.GetData() == nullptr, "a new file is open but not mapped");
+
+            file.Resize(10000);
+            Check(file.GetSize() == 10000 && file.GetData() != nullptr, "a resized file is mapped");
+            for (UInt32 i = 0; i < 10000; ++i) {
+                file.GetData()[i] = static_cast<std::byte>(i * 13);
+            }
+            file.Resize(5000);
+            file.Flush();
+
+            MappedFile moved = std::move(file);
+            Check(!file.IsOpen() && moved.GetSize() == 5000, "moving takes the mapping");
+            moved.Close();
+            Check(!moved.IsOpen() && moved.GetData() == nullptr, "a closed file is unmapped");
+
+            const MappedFile read(path, MappedFileMode::Read);
+            bool same = read.GetSize() == 5000;
+            for (UInt32 i = 0; same && i < 5000; ++i) {
+                same = read.GetData()[i] == static_cast<std::byte>(i * 13);
+            }
+            Check(same, "the written bytes are read back");
+            CheckThrows<std::logic_error>([&] { MappedFile(path, MappedFileMode::Read).Resize(1); },
+                                          "a file mapped for reading cannot be resized");
+            CheckThrows<std::runtime_error>([] { MappedFile(GetFilePath("Missing.bin"), MappedFileMode::Read); },
+                                            "a missing file is not created for reading");
+        });
+
+        suite.Run("MappedFile/FailedOpenClosesFile", [] {
+            // A directory opens but cannot be mapped, where it opens at all: each failure must
+            // close what it opened.
+            const std::filesystem::path directory = GetScratchDirectory() / "MappedDirectory";
+            std::filesystem::create_directories(directory);
+
+            const UInt64 openFileCount = CountOpenFiles();
+            MappedFile file;
+            for (UInt32 i = 0; i < 100; ++i) {
+                CheckThrows<std::runtime_error>([&] { MappedFile{directory, MappedFileMode::Read}; },
+                                                "a directory is not mapped");
+                CheckThrows<std::runtime_error>([&] { file.Open(directory, MappedFileMode::Read); },
+                                                "a directory is not mapped");
+                Check(!file.IsOpen(), "a failed open leaves the file closed");
+            }
+            Check(CountOpenFiles() == openFileCount, "failed opens leave no file open");
+        });
+
+        suite.Run("MappedFile/FailedResizeKeepsMapping", [] {
+            MappedFile file(GetFilePath("Resized.bin"), MappedFileMode::ReadWrite);
+            file.Resize(4096);
+            std::memset(file.GetData(), 0x5a, 4096);
+
+            CheckThrows<std::runtime_error>([&] { file.Resize(std::numeric_limits<UInt64>::max()); },
+                                            "a size past the file system limits is rejected");
+            Check(file.IsOpen() && file.GetSize() == 4096 && file.GetData() != nullptr,
+                  "the file keeps its size and stays mapped");
+            bool same = true;
+            for (UInt32 i = 0; same && i < 4096; ++i) {
+                same = file.GetData()[i] == std::byte{0x5a};
+            }
+            Check(same, "the mapping still holds the data");
+
+            file.Resize(8192);
+            Check(file.GetSize() == 8192 && file.GetData()[4095] == std::byte{0x5a}, "the file can still be resized");
+        });
+    }
+}
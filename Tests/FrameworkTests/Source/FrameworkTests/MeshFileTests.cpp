@@ -0,0 +1,430 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/MeshData.hpp"
+#include "Framework/MeshFile.hpp"
+#include "Framework/ObjImporter.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // A quad and a triangle in two groups and two materials, with every attribute.
+        constexpr const char* ObjSource = R"(# Test scene
+mtllib scene.mtl
+v 0 0 0 1 0 0
+v 1 0 0 0 1 0
+v 1 1 0 0 0 1
+v 0 1 0
+vt 0 0
+vt 1 0
+vt 1 1
+vt 0 1
+vn 0 0 1
+o Quad
+usemtl Red
+f 1/1/1 2/2/1 3/3/1 4/4/1
+v 0 0 2
+g Tail
+usemtl Blue
+f 5/1/1 1/2/1 2/3/1
+usemtl Red
+f 5/4/1 2/3/1 3/2/1
+)";
+
+        // The indices of ObjSource, counted from the end of the lists so far.
+        constexpr const char* RelativeObjSource = R"(# Test scene
+mtllib scene.mtl
+v 0 0 0 1 0 0
+v 1 0 0 0 1 0
+v 1 1 0 0 0 1
+v 0 1 0
+vt 0 0
+vt 1 0
+vt 1 1
+vt 0 1
+vn 0 0 1
+o Quad
+usemtl Red
+f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1
+v 0 0 2
+g Tail
+usemtl Blue
+f -1/-4/-1 -5/-3/-1 -4/-2/-1
+usemtl Red
+f 5/-1/1 -4/-2/-1 3/2/-1
+)";
+
+        std::filesystem::path WriteFile(const char* name, const std::vector<std::byte>& bytes) {
+            const std::filesystem::path path = GetScratchDirectory() / name;
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            file.close();
+            Check(!file.fail(), "the test file is written");
+
+            return path;
+        }
+
+        std::vector<std::byte> ReadFile(const std::filesystem::path& path) {
+            std::ifstream file(path, std::ios::binary);
+            std::vector<std::byte> bytes(std::filesystem::file_size(path));
+            file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+            return bytes;
+        }
+
+        std::vector<std::byte> SaveMesh(const MeshData& mesh) {
+            const std::filesystem::path path = GetScratchDirectory() / "Saved.mesh";
+            SaveMeshFile(mesh, path);
+
+            return ReadFile(path);
+        }
+
+        // Rewrites the table entry of type T at the given offset of the file.
+        template <class T>
+        void Patch(std::vector<std::byte>& bytes, const UInt64 offset, const std::function<void(T&)>& change) {
+            T value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            change(value);
+            std::memcpy(bytes.data() + offset, &value, sizeof(T));
+        }
+
+        MeshFileHeader GetHeader(const std::vector<std::byte>& bytes) {
+            MeshFileHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+
+            return header;
+        }
+
+        bool IsSameBounds(const Float32 (&a)[3], const Float32 (&b)[3]) {
+            return std::equal(std::begin(a), std::end(a), std::begin(b));
+        }
+
+        bool IsSameLod(const MeshLodDesc& a, const MeshLodDesc& b) {
+            return a.FirstIndex == b.FirstIndex && a.IndexCount == b.IndexCount && a.BaseVertex == b.BaseVertex &&
+                a.VertexCount == b.VertexCount && a.Error == b.Error;
+        }
+
+        bool IsSameMesh(const MeshData& a, const MeshData& b) {
+            if (a.VertexCount != b.VertexCount || a.Indices != b.Indices || a.Streams.size() != b.Streams.size() ||
+                a.Submeshes.size() != b.Submeshes.size() || !IsSameBounds(a.BoundsMin, b.BoundsMin) ||
+                !IsSameBounds(a.BoundsMax, b.BoundsMax)) {
+                return false;
+            }
+            for (std::size_t i = 0; i < a.Streams.size(); ++i) {
+                const MeshStream& streamA = a.Streams[i];
+                const MeshStream& streamB = b.Streams[i];
+                if (streamA.Semantic != streamB.Semantic || streamA.SemanticIndex != streamB.SemanticIndex ||
+                    streamA.Format != streamB.Format || streamA.Stride != streamB.Stride || streamA.Data != streamB.Data) {
+                    return false;
+                }
+            }
+            for (std::size_t i = 0; i < a.Submeshes.size(); ++i) {
+                const MeshSubmesh& submeshA = a.Submeshes[i];
+                const MeshSubmesh& submeshB = b.Submeshes[i];
+                if (submeshA.Name != submeshB.Name || submeshA.MaterialIndex != submeshB.MaterialIndex ||
+                    !std::ranges::equal(submeshA.Lods, submeshB.Lods, IsSameLod)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Everything the file holds, read back through MeshFile.
+        void CheckLoaded(const MeshData& mesh, const std::filesystem::path& path, const UInt32 indexFormat) {
+            const MeshFile file(path);
+            Check(file.GetVertexCount() == mesh.VertexCount && file.GetIndexFormat() == indexFormat,
+                  "the counts and the index format are read back");
+            Check(IsSameBounds(file.GetHeader().BoundsMin, mesh.BoundsMin) &&
+                  IsSameBounds(file.GetHeader().BoundsMax, mesh.BoundsMax), "the bounds are read back");
+
+            Check(file.GetStreams().size() == mesh.Streams.size(), "every stream is written");
+            for (const MeshStream& stream : mesh.Streams) {
+                const MeshStreamDesc* pDesc = file.FindStream(stream.Semantic, stream.SemanticIndex);
+                Check(pDesc != nullptr && pDesc->Format == stream.Format && pDesc->Stride == stream.Stride,
+                      std::string(GetMeshSemanticName(stream.Semantic)) + " is described");
+                const std::span<const std::byte> data = file.GetStreamData(*pDesc);
+                Check(std::ranges::equal(data, stream.Data), std::string(GetMeshSemanticName(stream.Semantic)) + " is read back");
+                Check((file.GetHeader().GeometryOffset + pDesc->Offset) % MeshDataAlignment == 0, "the streams are aligned");
+            }
+
+            const std::span<const std::byte> indexData = file.GetIndexData();
+            std::vector<UInt32> indices(file.GetIndexCount());
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                if (file.GetIndexStride() == 2) {
+                    UInt16 index;
+                    std::memcpy(&index, indexData.data() + i * 2, sizeof(index));
+                    indices[i] = index;
+                } else {
+                    std::memcpy(&indices[i], indexData.data() + i * 4, sizeof(UInt32));
+                }
+            }
+            Check(indices == mesh.Indices, "the indices are read back");
+
+            Check(file.GetSubmeshes().size() == mesh.Submeshes.size(), "every submesh is written");
+            for (std::size_t i = 0; i < mesh.Submeshes.size(); ++i) {
+                const MeshSubmesh& submesh = mesh.Submeshes[i];
+                const MeshSubmeshDesc& desc = file.GetSubmeshes()[i];
+                Check(file.GetName(desc) == submesh.Name && desc.MaterialIndex == submesh.MaterialIndex,
+                      "the submesh " + submesh.Name + " is read back");
+                Check(IsSameBounds(desc.BoundsMin, submesh.BoundsMin) && IsSameBounds(desc.BoundsMax, submesh.BoundsMax),
+                      "the bounds of " + submesh.Name + " are read back");
+                Check(std::ranges::equal(file.GetLods(desc), submesh.Lods, IsSameLod),
+                      "the levels of detail of " + submesh.Name + " are read back");
+            }
+        }
+
+        // More vertices than 16-bit indices reach, in two submeshes with several levels and
+        // base vertices.
+        MeshData MakeLargeMesh() {
+            MeshData mesh;
+            mesh.VertexCount = 70000;
+
+            MeshStream& positions = mesh.Streams.emplace_back();
+            positions.Format = DxgiFormat::R32G32B32Float;
+            positions.Stride = 12;
+            positions.Data.resize(UInt64(mesh.VertexCount) * positions.Stride);
+            for (UInt32 i = 0; i < mesh.VertexCount; ++i) {
+                const Float32 position[3] = {static_cast<Float32>(i % 300), static_cast<Float32>(i / 300), -1.0f};
+                std::memcpy(positions.Data.data() + UInt64(i) * positions.Stride, position, sizeof(position));
+            }
+
+            MeshStream& colors = mesh.Streams.emplace_back();
+            colors.Semantic = MeshSemantic::Color;
+            colors.Format = DxgiFormat::R8G8B8A8Unorm;
+            colors.Stride = 4;
+            colors.Data.resize(UInt64(mesh.VertexCount) * colors.Stride);
+            for (std::size_t i = 0; i < colors.Data.size(); ++i) {
+                colors.Data[i] = static_cast<std::byte>(i * 7);
+            }
+
+            mesh.Indices = {0, 1, 69999, 69999, 1, 2, 0, 1, 2, 3, 4, 5};
+            MeshSubmesh& first = mesh.Submeshes.emplace_back();
+            first.Name = "A name longer than the thirty-one characters kept";
+            first.Lods = {{0, 6, 0, 70000, 0.0f, 0}, {6, 3, 100, 3, 0.25f, 0}};
+            MeshSubmesh& second = mesh.Submeshes.emplace_back();
+            second.Name = "Second";
+            second.MaterialIndex = 4;
+            second.Lods = {{9, 3, 69990, 10, 0.0f, 0}};
+            ComputeMeshBounds(mesh);
+
+            return mesh;
+        }
+    }
+
+    void RunMeshFileTests(TestSuite& suite) {
+        suite.Run("MeshFile/RoundTrip", [] {
+            const MeshData mesh = ParseObjMesh(ObjSource);
+            Check(mesh.VertexCount == 9 && mesh.Indices.size() == 12 && mesh.Submeshes.size() == 3 && mesh.Streams.size() == 4,
+                  "the OBJ geometry is imported");
+            Check(mesh.Submeshes[0].Name == "Quad" && mesh.Submeshes[1].Name == "Tail" &&
+                  mesh.Submeshes[1].MaterialIndex == 1 && mesh.Submeshes[2].MaterialIndex == 0, "the OBJ groups are imported");
+            const std::filesystem::path path = GetScratchDirectory() / "RoundTrip.mesh";
+            SaveMeshFile(mesh, path);
+            CheckLoaded(mesh, path, DxgiFormat::R16Uint);
+
+            MeshData large = MakeLargeMesh();
+            SaveMeshFile(large, path);
+            large.Submeshes[0].Name.resize(MeshNameSize - 1);
+            CheckLoaded(large, path, DxgiFormat::R32Uint);
+
+            MeshFile file(path);
+            const MeshFile moved = std::move(file);
+            Check(moved.GetIndexCount() == 12 && moved.GetStreams().size() == 2, "a moved file keeps its tables");
+        });
+
+        suite.Run("MeshFile/Truncated", [] {
+            const std::vector<std::byte> bytes = SaveMesh(ParseObjMesh(ObjSource));
+            const MeshFileHeader header = GetHeader(bytes);
+            for (const UInt64 size : {UInt64(0), UInt64(1), sizeof(MeshFileHeader) - 1, sizeof(MeshFileHeader),
+                                      sizeof(MeshFileHeader) + sizeof(MeshStreamDesc), header.GeometryOffset - 1,
+                                      header.GeometryOffset, header.GeometryOffset + header.IndexOffset, bytes.size() - 1}) {
+                const std::filesystem::path path = WriteFile("Truncated.mesh", {bytes.begin(), bytes.begin() + size});
+                CheckThrows<std::runtime_error>([&] { MeshFile{path}; },
+                                                "a file cut at " + std::to_string(size) + " bytes is rejected");
+            }
+        });
+
+        suite.Run("MeshFile/BadOffsets", [] {
+            const std::vector<std::byte> bytes = SaveMesh(ParseObjMesh(ObjSource));
+            const MeshFileHeader header = GetHeader(bytes);
+            const UInt64 streamOffset = sizeof(MeshFileHeader);
+            const UInt64 submeshOffset = streamOffset + header.StreamCount * sizeof(MeshStreamDesc);
+            const UInt64 lodOffset = submeshOffset + header.SubmeshCount * sizeof(MeshSubmeshDesc);
+            const UInt64 tableSize = lodOffset + header.LodCount * sizeof(MeshLodDesc);
+            Check(header.IndexFormat == DxgiFormat::R16Uint && header.GeometryOffset > tableSize,
+                  "the file has 16-bit indices and room after its tables");
+
+            using HeaderChange = std::function<void(MeshFileHeader&)>;
+            using StreamChange = std::function<void(MeshStreamDesc&)>;
+            using SubmeshChange = std::function<void(MeshSubmeshDesc&)>;
+            using LodChange = std::function<void(MeshLodDesc&)>;
+            const std::pair<const char*, std::function<void(std::vector<std::byte>&)>> changes[] = {
+                {"a wrong magic", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.Magic ^= 1; }));
+                }},
+                {"another version", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { ++h.Version; }));
+                }},
+                {"geometry over the tables", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.GeometryOffset = 0; }));
+                }},
+                {"misaligned geometry", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { --h.GeometryOffset; }));
+                }},
+                {"geometry past the end", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) {
+                        h.GeometryOffset = std::numeric_limits<UInt64>::max() - 63;
+                    }));
+                }},
+                {"geometry larger than the file", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { ++h.GeometrySize; }));
+                }},
+                {"geometry of the largest size", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) {
+                        h.GeometrySize = std::numeric_limits<UInt64>::max();
+                    }));
+                }},
+                {"more tables than fit before the geometry", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.StreamCount += 100; }));
+                }},
+                {"the largest table", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) {
+                        h.LodCount = std::numeric_limits<UInt32>::max();
+                    }));
+                }},
+                {"an unknown index format", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.IndexFormat = 42; }));
+                }},
+                {"indices past the geometry", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.IndexOffset = h.GeometrySize + 2; }));
+                }},
+                {"indices running past the geometry", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.IndexOffset += 2; }));
+                }},
+                {"more indices than stored", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { ++h.IndexCount; }));
+                }},
+                {"32-bit indices in the space of 16-bit ones", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { h.IndexFormat = DxgiFormat::R32Uint; }));
+                }},
+                {"misaligned indices", [](std::vector<std::byte>& file) {
+                    Patch<MeshFileHeader>(file, 0, HeaderChange([](MeshFileHeader& h) { --h.IndexOffset; }));
+                }},
+                {"a stream past the geometry", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([](MeshStreamDesc& s) {
+                        s.Offset = std::numeric_limits<UInt64>::max() - 63;
+                    }));
+                }},
+                {"a stream running past the geometry", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([&](MeshStreamDesc& s) {
+                        s.Offset = header.GeometrySize / MeshDataAlignment * MeshDataAlignment;
+                    }));
+                }},
+                {"a misaligned stream", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([](MeshStreamDesc& s) { ++s.Offset; }));
+                }},
+                {"a stream without one element per vertex", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([](MeshStreamDesc& s) { s.Size -= s.Stride; }));
+                }},
+                {"a stride smaller than the format", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([&](MeshStreamDesc& s) {
+                        s.Stride = 4;
+                        s.Size = UInt64(4) * header.VertexCount;
+                    }));
+                }},
+                {"an unknown stream format", [=](std::vector<std::byte>& file) {
+                    Patch<MeshStreamDesc>(file, streamOffset, StreamChange([](MeshStreamDesc& s) { s.Format = DxgiFormat::Unknown; }));
+                }},
+                {"a submesh past the levels of detail", [=](std::vector<std::byte>& file) {
+                    Patch<MeshSubmeshDesc>(file, submeshOffset, SubmeshChange([&](MeshSubmeshDesc& s) {
+                        s.FirstLod = header.LodCount;
+                    }));
+                }},
+                {"a submesh running past the levels of detail", [=](std::vector<std::byte>& file) {
+                    Patch<MeshSubmeshDesc>(file, submeshOffset + (header.SubmeshCount - 1) * sizeof(MeshSubmeshDesc),
+                                           SubmeshChange([](MeshSubmeshDesc& s) { ++s.LodCount; }));
+                }},
+                {"a submesh at the largest level of detail", [=](std::vector<std::byte>& file) {
+                    Patch<MeshSubmeshDesc>(file, submeshOffset, SubmeshChange([](MeshSubmeshDesc& s) {
+                        s.FirstLod = std::numeric_limits<UInt32>::max();
+                    }));
+                }},
+                {"a level of detail past the indices", [=](std::vector<std::byte>& file) {
+                    Patch<MeshLodDesc>(file, lodOffset, LodChange([&](MeshLodDesc& l) { l.FirstIndex = header.IndexCount; }));
+                }},
+                {"a level of detail at the largest index", [=](std::vector<std::byte>& file) {
+                    Patch<MeshLodDesc>(file, lodOffset, LodChange([](MeshLodDesc& l) {
+                        l.FirstIndex = std::numeric_limits<UInt32>::max();
+                    }));
+                }},
+                {"a level of detail with a partial triangle", [=](std::vector<std::byte>& file) {
+                    Patch<MeshLodDesc>(file, lodOffset, LodChange([](MeshLodDesc& l) { --l.IndexCount; }));
+                }},
+                {"a level of detail past the vertices", [=](std::vector<std::byte>& file) {
+                    Patch<MeshLodDesc>(file, lodOffset, LodChange([](MeshLodDesc& l) { ++l.VertexCount; }));
+                }},
+                {"a level of detail at the largest base vertex", [=](std::vector<std::byte>& file) {
+                    Patch<MeshLodDesc>(file, lodOffset, LodChange([](MeshLodDesc& l) {
+                        l.BaseVertex = std::numeric_limits<UInt32>::max();
+                    }));
+                }}
+            };
+
+            MeshFile{WriteFile("Valid.mesh", bytes)};
+            for (const auto& [name, change] : changes) {
+                std::vector<std::byte> file = bytes;
+                change(file);
+                const std::filesystem::path path = WriteFile("BadOffsets.mesh", file);
+                CheckThrows<std::runtime_error>([&] { MeshFile{path}; }, std::string("a file with ") + name + " is rejected");
+            }
+        });
+
+        suite.Run("MeshFile/ObjIndices", [] {
+            // Negative indices count back from the last element defined so far.
+            Check(IsSameMesh(ParseObjMesh(RelativeObjSource), ParseObjMesh(ObjSource)),
+                  "relative indices give the mesh of absolute ones");
+
+            constexpr const char* vertices = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n";
+            const std::pair<const char*, const char*> faces[] = {
+                {"a zero index", "f 0 1 2\n"},
+                {"a position past the last", "f 1 2 4\n"},
+                {"a position before the first", "f -4 -2 -1\n"},
+                {"a texture coordinate past the last", "f 1/1 2/2 3/1\n"},
+                {"a texture coordinate before the first", "f 1/-2 2/1 3/1\n"},
+                {"a normal past the last", "f 1//1 2//2 3//1\n"},
+                {"a normal before the first", "f 1//1 2//-2 3//1\n"},
+                {"an index past 64 bits", "f 1 2 18446744073709551617\n"},
+                {"the lowest 64-bit index", "f -9223372036854775808 1 2\n"},
+                {"a malformed index", "f 1 2 3x\n"},
+                {"an empty normal index", "f 1/1/ 2/1/ 3/1/\n"},
+                {"too few vertices", "f 1 2\n"}
+            };
+            for (const auto& [name, face] : faces) {
+                CheckThrows<std::runtime_error>([&] { ParseObjMesh(std::string(vertices) + face); },
+                                                std::string("a face with ") + name + " is rejected");
+            }
+            CheckThrows<std::runtime_error>([] { ParseObjMesh("f -1 -2 -3\nv 0 0 0\nv 1 0 0\nv 0 1 0\n"); },
+                                            "relative indices before any vertex are rejected");
+
+            const MeshData mesh = ParseObjMesh(std::string(vertices) + "f -3/-1/-1 2/1/1 -1/1/1\nf 3 -3 2\n");
+            Check(mesh.VertexCount == 6 && mesh.Indices == std::vector<UInt32>{0, 1, 2, 3, 4, 5},
+                  "the first and last elements are in range");
+        });
+    }
+}
@@ -0,0 +1,164 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/MeshOptimizer.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        using Triangle = std::array<UInt32, 3>;
+
+        // Indexed grid of verticesPerSide^2 positions in the XY plane, its triangles shuffled:
+        // the worst case for the vertex cache.
+        MeshData BuildShuffledGrid(const UInt32 verticesPerSide) {
+            std::vector<Float32> positions;
+            for (UInt32 y = 0; y < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x < verticesPerSide; ++x) {
+                    positions.insert(positions.end(), {static_cast<Float32>(x), static_cast<Float32>(y), 0.0f});
+                }
+            }
+
+            MeshData mesh;
+            mesh.VertexCount = verticesPerSide * verticesPerSide;
+            MeshStream& stream = mesh.Streams.emplace_back();
+            stream.Format = DxgiFormat::R32G32B32Float;
+            stream.Stride = 3 * sizeof(Float32);
+            stream.Data.resize(positions.size() * sizeof(Float32));
+            std::memcpy(stream.Data.data(), positions.data(), stream.Data.size());
+
+            for (UInt32 y = 0; y + 1 < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x + 1 < verticesPerSide; ++x) {
+                    const UInt32 corner = y * verticesPerSide + x;
+                    mesh.Indices.insert(mesh.Indices.end(), {corner, corner + verticesPerSide, corner + 1,
+                                                             corner + 1, corner + verticesPerSide,
+                                                             corner + verticesPerSide + 1});
+                }
+            }
+
+            std::mt19937 random(17);
+            const UInt64 triangleCount = mesh.Indices.size() / 3;
+            for (UInt64 i = triangleCount - 1; i > 0; --i) {
+                const UInt64 j = std::uniform_int_distribution<UInt64>(0, i)(random);
+                std::swap_ranges(mesh.Indices.begin() + i * 3, mesh.Indices.begin() + i * 3 + 3,
+                                 mesh.Indices.begin() + j * 3);
+            }
+
+            MeshSubmesh& submesh = mesh.Submeshes.emplace_back();
+            submesh.Lods.push_back({0, static_cast<UInt32>(mesh.Indices.size()), 0, mesh.VertexCount, 0.0f, 0});
+            ComputeMeshBounds(mesh);
+
+            return mesh;
+        }
+
+        // The triangles as a sorted list, each rotated to start at its lowest vertex so that
+        // the winding is kept. The vertices are named by their grid position, which survives
+        // the vertex reordering.
+        std::vector<Triangle> GetTriangleSet(const MeshData& mesh, const UInt32 verticesPerSide) {
+            const std::byte* pPositions = mesh.Streams.front().Data.data();
+            const auto gridVertex = [&](const UInt32 index) {
+                Float32 position[2];
+                std::memcpy(position, pPositions + UInt64(index) * 3 * sizeof(Float32), sizeof(position));
+                return static_cast<UInt32>(position[1]) * verticesPerSide + static_cast<UInt32>(position[0]);
+            };
+
+            std::vector<Triangle> triangles(mesh.Indices.size() / 3);
+            for (UInt64 i = 0; i < triangles.size(); ++i) {
+                Triangle& triangle = triangles[i];
+                for (UInt32 corner = 0; corner < 3; ++corner) {
+                    triangle[corner] = gridVertex(mesh.Indices[i * 3 + corner]);
+                }
+                std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            }
+            std::ranges::sort(triangles);
+
+            return triangles;
+        }
+    }
+
+    void RunMeshOptimizerTests(TestSuite& suite) {
+        suite.Run("MeshOptimizer/MillionTriangleGrid", [] {
+            // 709^2 vertices, 1,002,528 triangles. Four threads over chunks of 128K triangles or
+            // more take the Morton-sorted parallel path even on a single-core machine.
+            constexpr UInt32 VerticesPerSide = 709;
+            MeshData mesh = BuildShuffledGrid(VerticesPerSide);
+            const std::vector<Triangle> before = GetTriangleSet(mesh, VerticesPerSide);
+
+            MeshOptimizeOptions options;
+            options.ThreadCount = 4;
+            options.MinTrianglesPerThread = 128 * 1024;
+            const MeshOptimizeReport report = OptimizeMesh(mesh, options);
+
+            Check(mesh.Indices.size() == before.size() * 3 && mesh.VertexCount == VerticesPerSide * VerticesPerSide,
+                  "no triangle or vertex is added or removed");
+            Check(GetTriangleSet(mesh, VerticesPerSide) == before, "the triangles and their winding are kept");
+            Check(report.CacheBefore.Acmr > 2.5 && report.CacheAfter.Acmr < 0.8,
+                  "the ACMR drops from a shuffled order to close to the regular mesh optimum");
+            Check(report.FetchAfter.Overfetch < report.FetchBefore.Overfetch, "the overfetch drops");
+        });
+
+        suite.Run("MeshOptimizer/ParallelVertexCache", [] {
+            // OptimizeVertexCache alone splits the buffer as it is: each chunk must keep its
+            // triangles and come back with the original vertex indices.
+            constexpr UInt32 VerticesPerSide = 301;
+            MeshData mesh = BuildShuffledGrid(VerticesPerSide);
+            std::vector<UInt32> indices = mesh.Indices;
+
+            MeshOptimizeOptions options;
+            options.ThreadCount = 3;
+            options.MinTrianglesPerThread = 1000;
+            OptimizeVertexCache(indices, mesh.VertexCount, options);
+            const VertexCacheStatistics after = AnalyzeVertexCache(indices, mesh.VertexCount);
+
+            const std::vector<Triangle> before = GetTriangleSet(mesh, VerticesPerSide);
+            const VertexCacheStatistics shuffled = AnalyzeVertexCache(mesh.Indices, mesh.VertexCount);
+            mesh.Indices = indices;
+            Check(GetTriangleSet(mesh, VerticesPerSide) == before, "the chunks keep their triangles");
+            // A third of a shuffled grid is sparse, which is why OptimizeMesh sorts the
+            // triangles spatially first: the chunks improve, but not to the regular optimum.
+            Check(after.Acmr < shuffled.Acmr / 1.8, "the chunks are optimized");
+        });
+
+        suite.Run("MeshOptimizer/Algorithms", [] {
+            // Single-threaded, both algorithms, on a grid small enough to fit the defaults.
+            constexpr UInt32 VerticesPerSide = 65;
+            for (const VertexCacheAlgorithm algorithm : {VertexCacheAlgorithm::Tipsify, VertexCacheAlgorithm::Forsyth}) {
+                MeshData mesh = BuildShuffledGrid(VerticesPerSide);
+                const std::vector<Triangle> before = GetTriangleSet(mesh, VerticesPerSide);
+
+                MeshOptimizeOptions options;
+                options.CacheAlgorithm = algorithm;
+                const MeshOptimizeReport report = OptimizeMesh(mesh, options);
+                Check(GetTriangleSet(mesh, VerticesPerSide) == before, "the triangles and their winding are kept");
+                Check(report.CacheAfter.Acmr < 0.9 && report.CacheAfter.Acmr < report.CacheBefore.Acmr / 2.0,
+                      "the ACMR drops");
+                Check(report.CacheAfter.Atvr < 1.6, "vertices are rarely transformed twice");
+            }
+        });
+
+        suite.Run("MeshOptimizer/InvalidInput", [] {
+            std::vector<UInt32> indices = {0, 1, 2, 2, 1};
+            CheckThrows<std::invalid_argument>([&] { OptimizeVertexCache(indices, 3); },
+                                               "a partial triangle is rejected");
+            indices = {0, 1, 3};
+            CheckThrows<std::invalid_argument>([&] { OptimizeVertexCache(indices, 3); },
+                                               "an index past the vertices is rejected");
+
+            MeshData mesh = BuildShuffledGrid(3);
+            MeshOptimizeOptions options;
+            options.WeldDistance = -1.0f;
+            CheckThrows<std::invalid_argument>([&] { OptimizeMesh(mesh, options); }, "a negative weld distance is rejected");
+        });
+    }
+}
@@ -0,0 +1,272 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/MeshletBuilder.hpp"
+#include "Framework/TextureFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        struct Float3 {
+            Float32 X, Y, Z;
+        };
+
+        MeshData MakeMesh(const std::vector<Float3>& positions, std::vector<UInt32> indices) {
+            MeshData mesh;
+            mesh.VertexCount = static_cast<UInt32>(positions.size());
+            MeshStream& stream = mesh.Streams.emplace_back();
+            stream.Format = DxgiFormat::R32G32B32Float;
+            stream.Stride = sizeof(Float3);
+            stream.Data.resize(positions.size() * sizeof(Float3));
+            std::memcpy(stream.Data.data(), positions.data(), stream.Data.size());
+
+            mesh.Indices = std::move(indices);
+            MeshSubmesh& submesh = mesh.Submeshes.emplace_back();
+            submesh.Lods.push_back({0, static_cast<UInt32>(mesh.Indices.size()), 0, mesh.VertexCount, 0.0f, 0});
+
+            return mesh;
+        }
+
+        // A flat grid, its triangles shuffled or not.
+        MeshData BuildGrid(const UInt32 verticesPerSide, const bool shuffle) {
+            std::vector<Float3> positions;
+            for (UInt32 y = 0; y < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x < verticesPerSide; ++x) {
+                    positions.push_back({static_cast<Float32>(x), static_cast<Float32>(y), 0.0f});
+                }
+            }
+
+            std::vector<UInt32> indices;
+            for (UInt32 y = 0; y + 1 < verticesPerSide; ++y) {
+                for (UInt32 x = 0; x + 1 < verticesPerSide; ++x) {
+                    const UInt32 corner = y * verticesPerSide + x;
+                    indices.insert(indices.end(), {corner, corner + verticesPerSide, corner + 1,
+                                                   corner + 1, corner + verticesPerSide, corner + verticesPerSide + 1});
+                }
+            }
+
+            if (shuffle) {
+                std::mt19937 random(1);
+                for (UInt64 i = indices.size() / 3 - 1; i > 0; --i) {
+                    const UInt64 j = std::uniform_int_distribution<UInt64>(0, i)(random);
+                    std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+                }
+            }
+
+            return MakeMesh(positions, std::move(indices));
+        }
+
+        // A unit UV sphere: the curvature gives the meshlets narrow normal cones. Seen from the
+        // inside, the triangles are in front of the center of their meshlet and the apex of
+        // the cone moves back.
+        MeshData BuildSphere(const UInt32 rings, const bool inward = false) {
+            std::vector<Float3> positions;
+            const UInt32 columns = rings * 2 + 1;
+            for (UInt32 ring = 0; ring <= rings; ++ring) {
+                for (UInt32 column = 0; column < columns; ++column) {
+                    const Float32 theta = std::numbers::pi_v<Float32> * static_cast<Float32>(ring) / static_cast<Float32>(rings);
+                    const Float32 phi = std::numbers::pi_v<Float32> * static_cast<Float32>(column) / static_cast<Float32>(rings);
+                    positions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+                }
+            }
+
+            std::vector<UInt32> indices;
+            for (UInt32 ring = 0; ring < rings; ++ring) {
+                for (UInt32 column = 0; column + 1 < columns; ++column) {
+                    const UInt32 corner = ring * columns + column;
+                    if (inward) {
+                        indices.insert(indices.end(), {corner, corner + columns, corner + 1,
+                                                       corner + 1, corner + columns, corner + columns + 1});
+                    } else {
+                        indices.insert(indices.end(), {corner, corner + 1, corner + columns,
+                                                       corner + 1, corner + columns + 1, corner + columns});
+                    }
+                }
+            }
+
+            return MakeMesh(positions, std::move(indices));
+        }
+
+        const Float3& GetPosition(const MeshData& mesh, const UInt32 index) {
+            return reinterpret_cast<const Float3*>(mesh.Streams.front().Data.data())[index];
+        }
+
+        // Checks the meshlets of a single-level mesh against the limits, its triangles, and
+        // the culling bounds. Returns the number of meshlets culled from random cameras, so
+        // that the cone check is known not to be vacuous.
+        UInt32 CheckMeshlets(const MeshData& mesh, const MeshletData& meshlets, const MeshletBuildOptions& options) {
+            Check(meshlets.Bounds.size() == meshlets.Meshlets.size(), "each meshlet has bounds");
+
+            std::vector<std::array<UInt32, 3>> expected(mesh.Indices.size() / 3);
+            for (UInt64 i = 0; i < expected.size(); ++i) {
+                expected[i] = {mesh.Indices[i * 3], mesh.Indices[i * 3 + 1], mesh.Indices[i * 3 + 2]};
+            }
+
+            std::mt19937 random(5);
+            std::uniform_real_distribution<Float32> cameraCoordinate(-300.0f, 300.0f);
+            std::vector<std::array<UInt32, 3>> built;
+            UInt32 limitViolationCount = 0;
+            UInt32 outsideVertexCount = 0;
+            UInt32 wronglyCulledCount = 0;
+            UInt32 culledCount = 0;
+            for (UInt64 m = 0; m < meshlets.Meshlets.size(); ++m) {
+                const Meshlet& meshlet = meshlets.Meshlets[m];
+                const MeshletBounds& bounds = meshlets.Bounds[m];
+                if (meshlet.VertexCount > options.MaxVertices || meshlet.PrimitiveCount > options.MaxPrimitives ||
+                    meshlet.PrimitiveCount == 0) {
+                    ++limitViolationCount;
+                }
+
+                for (UInt32 v = 0; v < meshlet.VertexCount; ++v) {
+                    const Float3& position = GetPosition(mesh, meshlets.VertexIndices[meshlet.VertexOffset + v]);
+                    const Float32 distance = std::hypot(position.X - bounds.Center[0], position.Y - bounds.Center[1],
+                                                        position.Z - bounds.Center[2]);
+                    outsideVertexCount += distance > bounds.Radius * 1.0001f + 1e-5f;
+                }
+
+                // The first corner, centroid and unit normal of each triangle.
+                std::vector<std::array<Float3, 3>> triangles;
+                for (UInt32 p = 0; p < meshlet.PrimitiveCount; ++p) {
+                    UInt32 vertices[3];
+                    UnpackMeshletTriangle(meshlets.PrimitiveIndices[meshlet.PrimitiveOffset + p], vertices);
+                    std::array<UInt32, 3>& triangle = built.emplace_back();
+                    for (UInt32 corner = 0; corner < 3; ++corner) {
+                        if (vertices[corner] >= meshlet.VertexCount) {
+                            ++limitViolationCount;
+                            vertices[corner] = 0;
+                        }
+                        triangle[corner] = meshlets.VertexIndices[meshlet.VertexOffset + vertices[corner]];
+                    }
+
+                    const Float3& a = GetPosition(mesh, triangle[0]);
+                    const Float3& b = GetPosition(mesh, triangle[1]);
+                    const Float3& c = GetPosition(mesh, triangle[2]);
+                    const Float3 e1 = {b.X - a.X, b.Y - a.Y, b.Z - a.Z};
+                    const Float3 e2 = {c.X - a.X, c.Y - a.Y, c.Z - a.Z};
+                    const Float3 normal = {e1.Y * e2.Z - e1.Z * e2.Y, e1.Z * e2.X - e1.X * e2.Z, e1.X * e2.Y - e1.Y * e2.X};
+                    const Float32 length = std::hypot(normal.X, normal.Y, normal.Z);
+                    if (length > 0.0f) {
+                        triangles.push_back({a, {(a.X + b.X + c.X) / 3.0f, (a.Y + b.Y + c.Y) / 3.0f, (a.Z + b.Z + c.Z) / 3.0f},
+                                             {normal.X / length, normal.Y / length, normal.Z / length}});
+                    }
+                }
+
+                // A culled meshlet must have no triangle facing the camera, from random cameras
+                // far away or within a few radii, and from just in front of each triangle.
+                const auto isFacing = [](const std::array<Float3, 3>& triangle, const Float32 (&camera)[3]) {
+                    const auto& [a, centroid, normal] = triangle;
+                    return (a.X - camera[0]) * normal.X + (a.Y - camera[1]) * normal.Y + (a.Z - camera[2]) * normal.Z < -1e-5f;
+                };
+                for (UInt32 i = 0; i < 40; ++i) {
+                    const Float32 scale = i % 2 == 0 ? 1.0f : bounds.Radius / 100.0f;
+                    const Float32 camera[3] = {bounds.Center[0] + cameraCoordinate(random) * scale,
+                                               bounds.Center[1] + cameraCoordinate(random) * scale,
+                                               bounds.Center[2] + cameraCoordinate(random) * scale};
+                    if (IsMeshletBackfacing(bounds, camera)) {
+                        ++culledCount;
+                        wronglyCulledCount += std::ranges::count_if(triangles, [&](const auto& triangle) {
+                            return isFacing(triangle, camera);
+                        });
+                    }
+                }
+                for (const auto& [a, centroid, normal] : triangles) {
+                    const Float32 offset = bounds.Radius * 0.01f;
+                    const Float32 camera[3] = {centroid.X + normal.X * offset, centroid.Y + normal.Y * offset,
+                                               centroid.Z + normal.Z * offset};
+                    wronglyCulledCount += IsMeshletBackfacing(bounds, camera);
+                }
+            }
+
+            std::ranges::sort(expected);
+            std::ranges::sort(built);
+            Check(limitViolationCount == 0, "the meshlets respect the limits and index their own vertices");
+            Check(built == expected, "the meshlets hold the triangles of the mesh, with their winding");
+            Check(outsideVertexCount == 0, "the bounding spheres contain their vertices");
+            Check(wronglyCulledCount == 0, "no triangle facing the camera is culled by its cone");
+
+            return culledCount;
+        }
+    }
+
+    void RunMeshletBuilderTests(TestSuite& suite) {
+        suite.Run("MeshletBuilder/Grid", [] {
+            // 130,050 triangles. With 64 vertices and 124 primitives a regular grid fills about
+            // 0.94 of the vertices and 0.72 of the primitives.
+            const MeshletBuildOptions options;
+            for (const bool shuffle : {false, true}) {
+                const MeshData mesh = BuildGrid(256, shuffle);
+                const MeshletData meshlets = BuildMeshlets(mesh, options);
+                CheckMeshlets(mesh, meshlets, options);
+
+                const MeshletStatistics statistics = AnalyzeMeshlets(meshlets, options);
+                Check(statistics.TriangleCount == mesh.Indices.size() / 3, "every triangle is counted");
+                Check(statistics.VertexFill > 0.925 && statistics.PrimitiveFill > 0.71, "the meshlets are filled");
+                Check(statistics.VerticesPerTriangle < 0.68, "few vertices are shared between meshlets");
+            }
+        });
+
+        suite.Run("MeshletBuilder/SphereCones", [] {
+            const MeshletBuildOptions options;
+            for (const bool inward : {false, true}) {
+                const MeshData mesh = BuildSphere(128, inward);
+                const MeshletData meshlets = BuildMeshlets(mesh, options);
+                Check(CheckMeshlets(mesh, meshlets, options) > meshlets.Meshlets.size() * 5, "the cones cull meshlets");
+                const UInt64 coneCount = std::ranges::count_if(meshlets.Bounds, [](const MeshletBounds& bounds) {
+                    return bounds.ConeCutoff < 1.0f;
+                });
+                // The patches at the poles hold degenerate triangles and may not get one.
+                Check(coneCount * 10 > meshlets.Bounds.size() * 9, "most patches of the sphere get a cone");
+            }
+        });
+
+        suite.Run("MeshletBuilder/Limits", [] {
+            // The D3D12 maximum of primitives, and the smallest meshlets allowed.
+            for (const MeshletBuildOptions options : {MeshletBuildOptions{128, 256}, MeshletBuildOptions{3, 1}}) {
+                const MeshData mesh = BuildGrid(64, false);
+                CheckMeshlets(mesh, BuildMeshlets(mesh, options), options);
+            }
+
+            MeshletBuildOptions options;
+            options.MaxVertices = MaxMeshletVertices + 1;
+            CheckThrows<std::invalid_argument>([&] { BuildMeshlets(BuildGrid(4, false), options); },
+                                               "a vertex limit past D3D12's is rejected");
+            options = {};
+            options.MaxPrimitives = 0;
+            CheckThrows<std::invalid_argument>([&] { BuildMeshlets(BuildGrid(4, false), options); },
+                                               "a zero primitive limit is rejected");
+
+            const MeshData mesh = BuildGrid(4, false);
+            const std::vector<UInt32> indices = {0, 1, 16};
+            CheckThrows<std::invalid_argument>([&] { BuildMeshlets(indices, mesh.Streams.front().Data, 12, 16); },
+                                               "an index out of the vertices is rejected");
+            Check(BuildMeshlets(std::span<const UInt32>(), {}, 12, 0).Meshlets.empty(), "no triangle gives no meshlet");
+        });
+
+        suite.Run("MeshletBuilder/ParallelMeshes", [] {
+            const std::vector<MeshData> meshes = {BuildGrid(64, false), BuildSphere(32), BuildGrid(100, true)};
+            MeshletBuildOptions options;
+            options.ThreadCount = 3;
+            const std::vector<MeshletData> parallel = BuildMeshlets(meshes, options);
+
+            Check(parallel.size() == meshes.size(), "each mesh gets its meshlets");
+            for (UInt64 i = 0; i < meshes.size(); ++i) {
+                const MeshletData serial = BuildMeshlets(meshes[i]);
+                Check(parallel[i].VertexIndices == serial.VertexIndices && parallel[i].PrimitiveIndices == serial.PrimitiveIndices &&
+                      parallel[i].Ranges.size() == 1, "meshes built in parallel match the serial build");
+            }
+        });
+    }
+}
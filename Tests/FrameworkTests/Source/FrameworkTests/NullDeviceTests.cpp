@@ -0,0 +1,175 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/NullDevice.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // A queue whose submissions take an hour, so that only CompleteUpTo finishes them.
+        struct Context {
+            NullDevice Device;
+            std::unique_ptr<NullCommandQueue> Queue = Device.CreateCommandQueue(std::chrono::hours(1));
+            std::unique_ptr<NullCommandAllocator> Allocator = Device.CreateCommandAllocator();
+            std::unique_ptr<NullCommandList> CommandList = Device.CreateCommandList(*Allocator);
+
+            void Execute(NullCommandList& commandList) {
+                NullCommandList* const pCommandList = &commandList;
+                Queue->ExecuteCommandLists({&pCommandList, 1});
+            }
+
+            void CompleteAll() {
+                Queue->GetTimeline().GetSimulatedTimeline().CompleteUpTo(Queue->GetTimeline().GetLastSignaledValue());
+            }
+        };
+    }
+
+    void RunNullDeviceTests(TestSuite& suite) {
+        suite.Run("NullDevice/ValidFrames", [] {
+            Context context;
+            const std::unique_ptr<NullSwapChain> swapChain = context.Device.CreateSwapChain(3);
+            for (UInt32 frame = 0; frame < 4; ++frame) {
+                if (frame != 0) {
+                    context.Allocator->Reset();
+                    context.CommandList->Reset(*context.Allocator);
+                }
+                context.CommandList->ResourceBarrier(1);
+                context.CommandList->ClearRenderTargetView();
+                context.CommandList->ResourceBarrier(1);
+                context.CommandList->Close();
+                context.Execute(*context.CommandList);
+                swapChain->Present(1);
+                // Each frame ends on a signal, completed here so that the allocator can be reset.
+                context.Queue->GetTimeline().Signal();
+                context.CompleteAll();
+            }
+
+            Check(context.CommandList->GetCommands().size() == 3 && context.Queue->GetExecutedCommandCount() == 12,
+                  "each frame executes its three commands");
+            Check(swapChain->GetCurrentBackBufferIndex() == 1, "presenting cycles the back buffers");
+            Check(context.Device.GetCallCount(NullApiCall::ResetCommandAllocator) == 3 &&
+                  context.Device.GetCallCount(NullApiCall::ResetCommandList) == 4 &&
+                  context.Device.GetCallCount(NullApiCall::ResourceBarrier) == 8 &&
+                  context.Device.GetCallCount(NullApiCall::Signal) == 4, "the calls are counted");
+            Check(context.Device.FormatCallCounts().find("ClearRenderTargetView: 4\n") != std::string::npos,
+                  "the counts are formatted by name");
+        });
+
+        suite.Run("NullDevice/InvalidSequences", [] {
+            // Each sequence breaks one rule of the debug layer, which the call must reject
+            // without changing the state it checks.
+            const std::pair<const char*, std::function<void(NullCommandList&)>> commands[] = {
+                {"ResourceBarrier", [](NullCommandList& commandList) { commandList.ResourceBarrier(1); }},
+                {"ClearRenderTargetView", [](NullCommandList& commandList) { commandList.ClearRenderTargetView(); }},
+                {"SetPipelineState", [](NullCommandList& commandList) { commandList.SetPipelineState(); }},
+                {"SetGraphicsRootSignature", [](NullCommandList& commandList) { commandList.SetGraphicsRootSignature(); }},
+                {"SetViewports", [](NullCommandList& commandList) { commandList.SetViewports(1); }},
+                {"SetScissorRects", [](NullCommandList& commandList) { commandList.SetScissorRects(1); }},
+                {"SetVertexBuffers", [](NullCommandList& commandList) { commandList.SetVertexBuffers(1); }},
+                {"DrawInstanced", [](NullCommandList& commandList) { commandList.DrawInstanced(3, 1); }},
+                {"CopyBufferRegion", [](NullCommandList& commandList) { commandList.CopyBufferRegion(16); }}
+            };
+            for (const auto& [name, command] : commands) {
+                Context context;
+                command(*context.CommandList);
+                context.CommandList->Close();
+                CheckThrows<std::logic_error>([&] { command(*context.CommandList); },
+                                              std::string(name) + " into a closed list is rejected");
+                Check(context.CommandList->GetCommands().size() == 1, std::string(name) + " was not recorded");
+            }
+
+            {
+                Context context;
+                context.CommandList->Close();
+                CheckThrows<std::logic_error>([&] { context.CommandList->Close(); }, "closing a closed list is rejected");
+            }
+            {
+                Context context;
+                // Onto an idle allocator, so that only the open list is wrong.
+                const std::unique_ptr<NullCommandAllocator> allocator = context.Device.CreateCommandAllocator();
+                context.CommandList->ClearRenderTargetView();
+                CheckThrows<std::logic_error>([&] { context.CommandList->Reset(*allocator); },
+                                              "resetting an open list is rejected");
+                Check(context.CommandList->GetCommands().size() == 1, "the open list keeps its commands");
+            }
+            {
+                Context context;
+                const std::unique_ptr<NullCommandAllocator> allocator = context.Device.CreateCommandAllocator();
+                const std::unique_ptr<NullCommandList> other = context.Device.CreateCommandList(*allocator);
+                other->Close();
+                CheckThrows<std::logic_error>([&] { other->Reset(*context.Allocator); },
+                                              "resetting a list onto an allocator another list records into is rejected");
+                CheckThrows<std::logic_error>([&] { context.Device.CreateCommandList(*context.Allocator); },
+                                              "creating a list on an allocator another list records into is rejected");
+                Check(other->IsClosed(), "the rejected list stays closed");
+            }
+            {
+                Context context;
+                CheckThrows<std::logic_error>([&] { context.Allocator->Reset(); },
+                                              "resetting an allocator a list records into is rejected");
+                context.CommandList->Close();
+                context.Allocator->Reset();
+            }
+            {
+                Context context;
+                context.CommandList->Close();
+                context.Execute(*context.CommandList);
+                CheckThrows<std::logic_error>([&] { context.Allocator->Reset(); },
+                                              "resetting an allocator whose submission was never signaled is rejected");
+                context.Queue->GetTimeline().Signal();
+                CheckThrows<std::logic_error>([&] { context.Allocator->Reset(); },
+                                              "resetting an allocator the GPU still executes is rejected");
+                context.CompleteAll();
+                context.Allocator->Reset();
+            }
+            {
+                Context context;
+                const std::unique_ptr<NullCommandAllocator> allocator = context.Device.CreateCommandAllocator();
+                const std::unique_ptr<NullCommandList> closed = context.Device.CreateCommandList(*allocator);
+                closed->ClearRenderTargetView();
+                closed->Close();
+                context.CommandList->ClearRenderTargetView();
+                NullCommandList* const ppCommandLists[] = {closed.get(), context.CommandList.get()};
+                CheckThrows<std::logic_error>([&] { context.Queue->ExecuteCommandLists(ppCommandLists); },
+                                              "executing an open list is rejected");
+                Check(context.Queue->GetExecutedCommandCount() == 0, "nothing of a rejected submission executes");
+                allocator->Reset();
+            }
+            {
+                Context context;
+                context.CommandList->ClearRenderTargetView();
+                context.CommandList->Close();
+                context.Allocator->Reset();
+                CheckThrows<std::logic_error>([&] { context.Execute(*context.CommandList); },
+                                              "executing a list whose allocator was reset is rejected");
+                context.CommandList->Reset(*context.Allocator);
+                context.CommandList->SetPipelineState();
+                context.CommandList->Close();
+                context.Execute(*context.CommandList);
+                Check(context.Queue->GetExecutedCommandCount() == 1, "a list recorded again executes");
+            }
+            {
+                Context context;
+                NullGpuTimeline& timeline = context.Queue->GetTimeline();
+                const UInt64 value = timeline.Signal();
+                CheckThrows<std::logic_error>([&] { timeline.WaitForValue(value + 1); },
+                                              "waiting on a value never signaled is rejected");
+                context.CompleteAll();
+                timeline.WaitForValue(value);
+            }
+
+            NullDevice device;
+            CheckThrows<std::invalid_argument>([&] { device.CreateSwapChain(1); }, "a single buffer swap chain is rejected");
+        });
+    }
+}
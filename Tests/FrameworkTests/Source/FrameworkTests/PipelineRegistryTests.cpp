@@ -0,0 +1,193 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/Hash.hpp"
+#include "Framework/PipelineRegistry.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        GraphicsPipelineDesc MakeDesc(const UInt64 vertexShader = 1) {
+            GraphicsPipelineDesc desc;
+            desc.VS = vertexShader;
+            desc.PS = 2;
+            desc.InputLayout.push_back({"POSITION", 0, 6, 0, 0, 0, 0});
+            desc.SampleMask = ~0u;
+            desc.PrimitiveTopologyType = 3;
+            desc.NumRenderTargets = 1;
+            desc.RTVFormats[0] = 28;
+            desc.SampleCount = 1;
+
+            return desc;
+        }
+
+        std::filesystem::path GetManifestPath(const char* name) {
+            std::filesystem::path path = GetScratchDirectory() / name;
+            std::filesystem::remove(path);
+
+            return path;
+        }
+    }
+
+    void RunPipelineRegistryTests(TestSuite& suite) {
+        suite.Run("PipelineRegistry/StableHashes", [] {
+            // Manifests and shader caches written by another run are addressed by these hashes,
+            // a change to their values invalidates every saved file.
+            Check(Hash64("") == 0xEF46DB3751D8E999ull && Hash64("abc") == 0x44BC2CF5AD770999ull,
+                  "Hash64 matches the XXH64 reference values");
+            Check(HashPipelineDesc(MakeDesc()) == 0xE4682E1C1EB0A4A2ull, "the hash of a description is stable");
+            Check(HashPipelineDesc(GraphicsPipelineDesc{}) == 0x22904E2A0EB013A8ull,
+                  "the hash of the default description is stable");
+        });
+
+        suite.Run("PipelineRegistry/Canonicalization", [] {
+            // The same pipeline spelled differently: semantic case, blend factors without blending,
+            // formats past the render target count, a negative zero.
+            GraphicsPipelineDesc desc = MakeDesc();
+            desc.InputLayout[0].SemanticName = "position";
+            desc.BlendState.RenderTargets[0].SrcBlend = 5;
+            desc.RTVFormats[3] = 2;
+            desc.RasterizerState.DepthBiasClamp = -0.0f;
+            Check(HashPipelineDesc(desc) == HashPipelineDesc(MakeDesc()), "equivalent descriptions hash equal");
+
+            desc.BlendState.RenderTargets[0].BlendEnable = true;
+            Check(HashPipelineDesc(desc) != HashPipelineDesc(MakeDesc()), "a state the pipeline uses changes the hash");
+
+            UInt32 creationCount = 0;
+            PipelineRegistry<UInt32> registry([&creationCount](const GraphicsPipelineDesc&) {
+                return creationCount++;
+            });
+            GraphicsPipelineDesc lowerCase = MakeDesc();
+            lowerCase.InputLayout[0].SemanticName = "Position";
+            Check(registry.GetOrCreate(MakeDesc()) == registry.GetOrCreate(lowerCase),
+                  "equivalent descriptions share a pipeline");
+            Check(creationCount == 1 && registry.GetHitCount() == 1, "the pipeline is created once");
+        });
+
+        suite.Run("PipelineRegistry/ConcurrentRequests", [] {
+            // Threads request the same few pipelines at once from a slow factory: each one must
+            // be created once, and every thread must get it.
+            constexpr UInt32 ThreadCount = 8;
+            constexpr UInt32 PipelineCount = 16;
+            constexpr UInt32 RequestsPerThread = 200;
+
+            std::atomic<UInt32> creationCount = 0;
+            std::atomic<UInt32> creationsPerShader[PipelineCount] = {};
+            PipelineRegistry<UInt64> registry([&](const GraphicsPipelineDesc& desc) {
+                ++creationCount;
+                ++creationsPerShader[desc.VS];
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                return desc.VS * 1000;
+            });
+
+            std::atomic<UInt32> start = 0;
+            std::atomic<UInt32> mismatchCount = 0;
+            std::vector<std::thread> threads;
+            for (UInt32 i = 0; i < ThreadCount; ++i) {
+                threads.emplace_back([&, i] {
+                    ++start;
+                    while (start != ThreadCount) {
+                    }
+
+                    for (UInt32 j = 0; j < RequestsPerThread; ++j) {
+                        const UInt64 shader = (i + j) % PipelineCount;
+                        if (registry.GetOrCreate(MakeDesc(shader)) != shader * 1000) {
+                            ++mismatchCount;
+                        }
+                    }
+                });
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            Check(mismatchCount == 0, "every request gets its pipeline");
+            Check(creationCount == PipelineCount && registry.GetPipelineCount() == PipelineCount,
+                  "each pipeline is created once");
+            for (const std::atomic<UInt32>& count : creationsPerShader) {
+                Check(count == 1, "no pipeline is created twice");
+            }
+            Check(registry.GetHitCount() == ThreadCount * RequestsPerThread - PipelineCount,
+                  "the other requests are hits");
+        });
+
+        suite.Run("PipelineRegistry/FailedCreation", [] {
+            bool fail = true;
+            PipelineRegistry<UInt32> registry([&fail](const GraphicsPipelineDesc&) {
+                if (fail) {
+                    throw std::runtime_error("Compilation failed.");
+                }
+                return 7u;
+            });
+
+            CheckThrows<std::runtime_error>([&registry] { registry.GetOrCreate(MakeDesc()); },
+                                            "the factory's exception is rethrown");
+            fail = false;
+            Check(registry.GetOrCreate(MakeDesc()) == 7, "a failed creation is attempted again");
+            Check(registry.GetPipelineCount() == 1 && registry.GetManifestCount() == 1,
+                  "only the successful creation is counted");
+        });
+
+        suite.Run("PipelineRegistry/ManifestRoundTrip", [] {
+            const std::filesystem::path path = GetManifestPath("ManifestRoundTrip.bin");
+            {
+                PipelineRegistry<UInt64> registry([](const GraphicsPipelineDesc& desc) { return desc.VS; });
+                for (UInt64 shader = 1; shader <= 10; ++shader) {
+                    registry.GetOrCreate(MakeDesc(shader));
+                }
+                registry.SaveManifest(path);
+            }
+
+            std::vector<UInt64> created;
+            PipelineRegistry<UInt64> registry([&created](const GraphicsPipelineDesc& desc) {
+                created.push_back(desc.VS);
+                return desc.VS;
+            });
+            Check(registry.LoadManifest(path) && registry.GetManifestCount() == 10, "the manifest is read back");
+
+            const std::size_t prewarmedCount = registry.Prewarm([](const GraphicsPipelineDesc& desc) {
+                return desc.VS % 2 == 0;
+            });
+            Check(prewarmedCount == 5 && created == std::vector<UInt64>{2, 4, 6, 8, 10},
+                  "the pipelines accepted by the filter are created in manifest order");
+            Check(registry.GetOrCreate(MakeDesc(4)) == 4 && registry.GetHitCount() == 1,
+                  "a prewarmed pipeline is a hit");
+            Check(registry.Prewarm() == 5 && registry.GetPipelineCount() == 10, "prewarming again creates the rest");
+        });
+
+        suite.Run("PipelineRegistry/RejectsCorruptedManifest", [] {
+            const std::filesystem::path path = GetManifestPath("RejectsCorruptedManifest.bin");
+            PipelineManifest manifest;
+            for (UInt64 shader = 1; shader <= 3; ++shader) {
+                manifest.Add(MakeDesc(shader), HashPipelineDesc(MakeDesc(shader)));
+            }
+            manifest.Save(path);
+
+            PipelineManifest loaded;
+            Check(loaded.Load(path) && loaded.GetDescs() == manifest.GetDescs(), "a saved manifest loads");
+
+            // Flip a byte of the last description: its hash no longer matches.
+            {
+                std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+                file.seekp(-4, std::ios::end);
+                file.put('\x7F');
+            }
+            Check(!loaded.Load(path) && loaded.GetCount() == 0, "a modified manifest is rejected");
+
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+            Check(!loaded.Load(path) && loaded.GetCount() == 0, "a truncated manifest is rejected");
+            Check(!loaded.Load(GetManifestPath("Missing.bin")), "a missing manifest is not read");
+        });
+    }
+}
@@ -0,0 +1,182 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/ProceduralTexture.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr std::byte Padding{0xcd};
+
+        using Generator = std::function<void(const TextureRegion&, const ProceduralTextureOptions&)>;
+
+        // Rows padded past their pixels, so that writes past the width show up.
+        struct Image {
+            UInt32 Width;
+            UInt32 Height;
+            UInt64 RowPitch;
+            std::vector<std::byte> Bytes;
+
+            Image(const UInt32 width, const UInt32 height) :
+                Width(width),
+                Height(height),
+                RowPitch(UInt64(width) * 4 + 20),
+                Bytes(RowPitch * height, Padding) {
+            }
+
+            TextureRegion GetRegion() {
+                return {Bytes.data(), Width, Height, RowPitch};
+            }
+
+            UInt32 GetPixel(const UInt32 x, const UInt32 y) const {
+                UInt32 pixel;
+                std::memcpy(&pixel, Bytes.data() + y * RowPitch + x * 4, sizeof(pixel));
+                return pixel;
+            }
+
+            bool IsPaddingIntact() const {
+                for (UInt32 y = 0; y < Height; ++y) {
+                    for (UInt64 i = UInt64(Width) * 4; i < RowPitch; ++i) {
+                        if (Bytes[y * RowPitch + i] != Padding) {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        Image Generate(const Generator& generator, const UInt32 width, const UInt32 height,
+                       const ProceduralTextureOptions& options) {
+            Image image(width, height);
+            generator(image.GetRegion(), options);
+            Check(image.IsPaddingIntact(), "nothing is written past the rows");
+
+            return image;
+        }
+
+        UInt32 GetChannel(const UInt32 color, const UInt32 channel) {
+            return color >> channel * 8 & 0xff;
+        }
+    }
+
+    void RunProceduralTextureTests(TestSuite& suite) {
+        suite.Run("ProceduralTexture/SimdLevelsMatch", [] {
+            // Every level lowered to what the CPU supports, threaded or not, gives the bytes of
+            // the scalar generator, on widths leaving partial vectors.
+            const std::pair<const char*, Generator> generators[] = {
+                {"Checkerboard", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateCheckerboard(region, {3, 5, 0xff102030, 0x80a0b0c0}, options);
+                }},
+                {"Checkerboard of wide cells", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateCheckerboard(region, {13, 1, 0xff0000ff, 0xff00ff00}, options);
+                }},
+                {"Gradient", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateGradient(region, {-3.0f, 2.0f, 47.5f, 31.0f, 0x00ff8000, 0xff0080ff}, options);
+                }},
+                {"Point gradient", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateGradient(region, {4.0f, 4.0f, 4.0f, 4.0f, 0xff000000, 0xffffffff}, options);
+                }},
+                {"Value noise", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateNoise(region, {NoiseType::Value, 1.0f / 7.0f, 5, 2.0f, 0.5f, 17, 0xff203040, 0xffe0d0c0},
+                                  options);
+                }},
+                {"Simplex noise", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateNoise(region, {NoiseType::Simplex, 1.0f / 9.0f, 4, 2.1f, 0.6f, 3, 0x00000000, 0xffffffff},
+                                  options);
+                }},
+                // A negative frequency maps the pixels to negative lattice coordinates, which the
+                // floors must round down.
+                {"Mirrored value noise", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateNoise(region, {NoiseType::Value, -1.0f / 5.0f, 2, 2.0f, 0.5f, 8, 0xff000000, 0xffffffff}, options);
+                }},
+                {"Mirrored simplex noise", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateNoise(region, {NoiseType::Simplex, -1.0f / 6.0f, 3, 2.0f, 0.5f, 8, 0xff000000, 0xffffffff},
+                                  options);
+                }},
+                {"Fine simplex noise", [](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateNoise(region, {NoiseType::Simplex, 1.3f, 1, 2.0f, 0.5f, 99, 0xff000000, 0xff00ffff}, options);
+                }}
+            };
+
+            for (const auto& [name, generator] : generators) {
+                for (const UInt32 width : {1u, 3u, 7u, 9u, 45u}) {
+                    const UInt32 height = width == 45 ? 37 : 5;
+                    const Image scalar = Generate(generator, width, height, {SimdLevel::Scalar, 1});
+                    for (const SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+                        for (const UInt32 threadCount : {1u, 3u}) {
+                            const Image image = Generate(generator, width, height, {level, threadCount, 1});
+                            Check(image.Bytes == scalar.Bytes, std::string(GetSimdLevelName(level)) + " on " +
+                                  std::to_string(threadCount) + " thread(s) generates the scalar " + name + " at width " +
+                                  std::to_string(width));
+                        }
+                    }
+                }
+            }
+        });
+
+        suite.Run("ProceduralTexture/Reference", [] {
+            // Checkerboard cells by division, and a horizontal gradient within rounding of the
+            // color at each pixel center.
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                const std::string name = GetSimdLevelName(level);
+                const CheckerboardDesc checkerboard{5, 3, 0xff112233, 0xff445566};
+                const Image cells = Generate([&](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateCheckerboard(region, checkerboard, options);
+                }, 23, 11, {level, 1});
+                bool matches = true;
+                for (UInt32 y = 0; y < cells.Height; ++y) {
+                    for (UInt32 x = 0; x < cells.Width; ++x) {
+                        const bool odd = (x / checkerboard.CellWidth + y / checkerboard.CellHeight) % 2 != 0;
+                        matches = matches && cells.GetPixel(x, y) == (odd ? checkerboard.Color1 : checkerboard.Color0);
+                    }
+                }
+                Check(matches, name + " alternates the cells");
+
+                const GradientDesc gradient{0.0f, 0.0f, 19.0f, 0.0f, 0x00ff0010, 0xff00ffa0};
+                const Image ramp = Generate([&](const TextureRegion& region, const ProceduralTextureOptions& options) {
+                    GenerateGradient(region, gradient, options);
+                }, 19, 2, {level, 1});
+                for (UInt32 x = 0; x < ramp.Width; ++x) {
+                    const Float64 t = (x + 0.5) / 19.0;
+                    for (UInt32 channel = 0; channel < 4; ++channel) {
+                        const Float64 start = GetChannel(gradient.StartColor, channel);
+                        const Float64 expected = start + (GetChannel(gradient.EndColor, channel) - start) * t;
+                        Check(std::abs(GetChannel(ramp.GetPixel(x, 1), channel) - expected) <= 0.5 + 1e-3,
+                              name + " blends the gradient colors");
+                    }
+                }
+            }
+        });
+
+        suite.Run("ProceduralTexture/InvalidArguments", [] {
+            std::vector<std::byte> bytes(64);
+            CheckThrows<std::invalid_argument>([] { GenerateCheckerboard({nullptr, 2, 2, 8}, {}); },
+                                               "a region without memory is rejected");
+            CheckThrows<std::invalid_argument>([&] { GenerateGradient({bytes.data(), 4, 2, 12}, {}); },
+                                               "a row pitch smaller than a row is rejected");
+            CheckThrows<std::invalid_argument>([&] { GenerateCheckerboard({bytes.data(), 4, 2, 16}, {0, 4}); },
+                                               "empty cells are rejected");
+            NoiseDesc noise;
+            noise.Octaves = 0;
+            CheckThrows<std::invalid_argument>([&] { GenerateNoise({bytes.data(), 4, 2, 16}, noise); },
+                                               "noise without octaves is rejected");
+            noise.Octaves = 17;
+            CheckThrows<std::invalid_argument>([&] { GenerateNoise({bytes.data(), 4, 2, 16}, noise); },
+                                               "noise with too many octaves is rejected");
+            GenerateNoise({nullptr, 0, 0, 0}, {});
+        });
+    }
+}
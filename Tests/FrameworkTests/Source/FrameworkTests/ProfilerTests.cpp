@@ -0,0 +1,126 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/Profiler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // Each test records on a thread of its own, so that it owns a fresh ring buffer.
+        template <class TFunction>
+        void RunOnNewThread(TFunction&& function) {
+            std::thread thread(std::forward<TFunction>(function));
+            thread.join();
+        }
+
+        const ProfileThread* FindThread(const ProfileCapture& capture, const std::string_view name) {
+            for (const ProfileThread& thread : capture.Threads) {
+                if (thread.Name == name) {
+                    return &thread;
+                }
+            }
+
+            return nullptr;
+        }
+
+        bool IsNear(const Float64 value, const Float64 expected) {
+            return std::abs(value - expected) < 1e-9;
+        }
+    }
+
+    void RunProfilerTests(TestSuite& suite) {
+        suite.Run("Profiler/RecordsScopes", [] {
+            RunOnNewThread([] {
+                SetProfileThreadName("Profiler/RecordsScopes");
+                const ProfileScope outer("Outer");
+                {
+                    const ProfileScope inner("Inner");
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            });
+
+            const ProfileCapture capture = CaptureProfile();
+            const ProfileThread* pThread = FindThread(capture, "Profiler/RecordsScopes");
+            Check(pThread && pThread->Events.size() == 2 && pThread->DroppedCount == 0, "both scopes are captured");
+
+            const ProfileEvent& inner = pThread->Events[0];
+            const ProfileEvent& outer = pThread->Events[1];
+            Check(std::strcmp(inner.Name, "Inner") == 0 && std::strcmp(outer.Name, "Outer") == 0,
+                  "events are recorded in the order the scopes end");
+            Check(outer.Begin <= inner.Begin && inner.End <= outer.End, "the inner scope is nested in the outer one");
+            Check(inner.End - inner.Begin >= 150000, "durations are converted to nanoseconds");
+        });
+
+        suite.Run("Profiler/RingOverwrite", [] {
+            // The ring of a thread holds 64K events, the oldest ones are dropped.
+            constexpr UInt64 EventCapacity = 64 * 1024;
+
+            RunOnNewThread([] {
+                SetProfileThreadName("Profiler/RingOverwrite");
+                for (UInt64 i = 0; i < EventCapacity + 100; ++i) {
+                    RecordProfileEvent("Event", i, i);
+                }
+            });
+
+            const ProfileCapture capture = CaptureProfile();
+            const ProfileThread* pThread = FindThread(capture, "Profiler/RingOverwrite");
+            Check(pThread && pThread->Events.size() == EventCapacity, "a full ring keeps its capacity");
+            Check(pThread->DroppedCount == 100, "the overwritten events are counted");
+        });
+
+        suite.Run("Profiler/ChromeTrace", [] {
+            ProfileCapture capture;
+            ProfileThread& thread = capture.Threads.emplace_back();
+            thread.Id = 3;
+            thread.Name = "Worker \"1\"";
+            thread.Events.push_back({"Load\\Assets\n", 1000, 2500});
+            capture.FrameBegins.push_back(500);
+
+            const std::string json = ExportChromeTrace(capture);
+            Check(json.find("\"args\":{\"name\":\"Worker \\\"1\\\"\"}") != std::string::npos, "thread names are escaped");
+            Check(json.find("\"name\":\"Load\\\\Assets\\n\",\"ph\":\"X\",\"pid\":0,\"tid\":3,\"ts\":1.000,\"dur\":1.500")
+                      != std::string::npos, "scopes are complete events in microseconds");
+            Check(json.find("\"name\":\"Frame\",\"ph\":\"i\"") != std::string::npos, "frames are instant events");
+        });
+
+        suite.Run("Profiler/FrameSummary", [] {
+            // Three frames of 1, 2 and 1 ms. The scope runs twice in the first frame, once in
+            // the third, and the events outside complete frames are ignored.
+            ProfileCapture capture;
+            capture.FrameBegins = {1000000, 2000000, 4000000, 5000000};
+            ProfileThread& thread = capture.Threads.emplace_back();
+            thread.Events = {
+                {"Scope", 0, 500000},
+                {"Scope", 1000000, 1100000},
+                {"Scope", 1200000, 1400000},
+                {"Scope", 4000000, 4600000},
+                {"Other", 2000000, 2050000},
+                {"Scope", 5000000, 5900000},
+            };
+
+            const std::vector<ProfileScopeSummary> summaries = SummarizeProfileFrames(capture);
+            Check(summaries.size() == 3 && summaries[0].Name == "Frame", "the frame comes first");
+            Check(summaries[0].FrameCount == 3 && IsNear(summaries[0].MinMilliseconds, 1.0) &&
+                  IsNear(summaries[0].AverageMilliseconds, 4.0 / 3.0) && IsNear(summaries[0].P99Milliseconds, 2.0),
+                  "the frame times are summarized");
+
+            const ProfileScopeSummary& scope = summaries[1];
+            Check(scope.Name == "Scope" && scope.CallCount == 3 && scope.FrameCount == 2,
+                  "a scope is summarized over the frames it appears in");
+            Check(IsNear(scope.MinMilliseconds, 0.3) && IsNear(scope.AverageMilliseconds, 0.45) &&
+                  IsNear(scope.P99Milliseconds, 0.6), "the calls of a frame are summed");
+            Check(summaries[2].Name == "Other", "scopes are sorted by average time");
+        });
+    }
+}
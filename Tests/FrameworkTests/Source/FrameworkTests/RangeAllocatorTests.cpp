@@ -0,0 +1,125 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/RangeAllocator.hpp"
+
+#include <random>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    void RunRangeAllocatorTests(TestSuite& suite) {
+        suite.Run("RangeAllocator/SplitAndMerge", [] {
+            RangeAllocator allocator(64);
+            const UInt32 a = allocator.Allocate(10);
+            const UInt32 b = allocator.Allocate(20);
+            const UInt32 c = allocator.Allocate(34);
+            Check(a == 0 && b == 10 && c == 30, "allocations split the free range in order");
+            Check(allocator.GetFreeCount() == 0 && allocator.Allocate(1) == RangeAllocator::InvalidIndex,
+                  "a full allocator fails");
+
+            allocator.Free(b, 20);
+            Check(allocator.Allocate(21) == RangeAllocator::InvalidIndex, "a freed range does not grow alone");
+            allocator.Free(a, 10);
+            Check(allocator.Allocate(30) == 0, "a range merges with the free range before it");
+            allocator.Free(0, 30);
+            allocator.Free(c, 34);
+            Check(allocator.GetFreeCount() == 64 && allocator.Allocate(64) == 0,
+                  "a range merges with the free ranges on both sides");
+        });
+
+        suite.Run("RangeAllocator/Fragmentation", [] {
+            RangeAllocator allocator(16);
+            UInt32 starts[8];
+            for (UInt32& start : starts) {
+                start = allocator.Allocate(2);
+            }
+
+            for (UInt32 i = 0; i < 8; i += 2) {
+                allocator.Free(starts[i], 2);
+            }
+            Check(allocator.GetFreeCount() == 8, "the freed ranges are counted");
+            Check(allocator.Allocate(3) == RangeAllocator::InvalidIndex,
+                  "free ranges that are not contiguous do not add up");
+            Check(allocator.Allocate(2) != RangeAllocator::InvalidIndex, "a range that fits is found");
+        });
+
+        suite.Run("RangeAllocator/InvalidFrees", [] {
+            CheckThrows<std::invalid_argument>([] { RangeAllocator allocator(0); }, "an empty allocator is rejected");
+
+            RangeAllocator allocator(64);
+            const UInt32 start = allocator.Allocate(8);
+            allocator.Allocate(8);
+
+            CheckThrows<std::out_of_range>([&allocator] { allocator.Free(60, 8); }, "a range past the end is rejected");
+            CheckThrows<std::invalid_argument>([&allocator] { allocator.Free(32, 8); }, "a free range is rejected");
+            CheckThrows<std::invalid_argument>([&] { allocator.Free(start, 4); }, "a part of a range is rejected");
+            CheckThrows<std::invalid_argument>([&] { allocator.Free(start + 4, 4); }, "the end of a range is rejected");
+            CheckThrows<std::invalid_argument>([&] { allocator.Free(start, 16); }, "two ranges at once are rejected");
+
+            allocator.Free(start, 8);
+            CheckThrows<std::invalid_argument>([&] { allocator.Free(start, 8); }, "a double free is rejected");
+            Check(allocator.GetFreeCount() == 56, "rejected frees leave the allocator unchanged");
+
+            allocator.Reset();
+            CheckThrows<std::invalid_argument>([&] { allocator.Free(8, 8); }, "a reset frees every range");
+            Check(allocator.Allocate(64) == 0, "a reset allocator is whole");
+        });
+
+        suite.Run("RangeAllocator/RandomAgainstBitmap", [] {
+            constexpr UInt32 Capacity = 1000;
+
+            struct Range {
+                UInt32 Start;
+                UInt32 Count;
+            };
+
+            std::mt19937 random(3);
+            RangeAllocator allocator(Capacity);
+            std::vector<bool> used(Capacity);
+            std::vector<Range> ranges;
+
+            for (UInt32 i = 0; i < 50000; ++i) {
+                if (ranges.empty() || random() % 2 == 0) {
+                    const UInt32 count = 1 + random() % (random() % 8 == 0 ? 200 : 16);
+                    const UInt32 start = allocator.Allocate(count);
+                    if (start == RangeAllocator::InvalidIndex) {
+                        continue;
+                    }
+
+                    Check(start + count <= Capacity, "ranges are in the allocator");
+                    for (UInt32 j = start; j < start + count; ++j) {
+                        Check(!used[j], "ranges never overlap");
+                        used[j] = true;
+                    }
+                    ranges.push_back({start, count});
+                } else {
+                    const std::size_t index = random() % ranges.size();
+                    const Range range = ranges[index];
+                    ranges[index] = ranges.back();
+                    ranges.pop_back();
+
+                    allocator.Free(range.Start, range.Count);
+                    for (UInt32 j = range.Start; j < range.Start + range.Count; ++j) {
+                        used[j] = false;
+                    }
+                }
+
+                UInt32 usedCount = 0;
+                for (const bool value : used) {
+                    usedCount += value ? 1 : 0;
+                }
+                Check(allocator.GetFreeCount() == Capacity - usedCount, "the free count matches the ranges");
+            }
+
+            for (const Range& range : ranges) {
+                allocator.Free(range.Start, range.Count);
+            }
+            Check(allocator.Allocate(Capacity) == 0, "freeing everything merges back the whole allocator");
+        });
+    }
+}
@@ -0,0 +1,627 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/RenderGraph.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        constexpr UInt64 MiB = 1024 * 1024;
+        constexpr UInt32 InvalidIndex = RenderGraph::InvalidIndex;
+
+        bool IsTransition(const ResourceBarrier& barrier, const UInt32 resource, const ResourceState before,
+                          const ResourceState after) {
+            return barrier.Type == ResourceBarrierType::Transition && barrier.Resource == resource &&
+                barrier.Subresource == AllSubresources && barrier.StateBefore == before && barrier.StateAfter == after;
+        }
+
+        bool IsBarrier(const ResourceBarrier& barrier, const UInt32 resource, const ResourceBarrierType type) {
+            return barrier.Type == type && barrier.Resource == resource;
+        }
+
+        // The accesses of a pass to a resource, merged the way the graph documents them.
+        struct ExpectedUse {
+            ResourceState State = ResourceState::Common;
+            bool Read = false;
+            bool Write = false;
+        };
+
+        // A graph and what was given to it, from which the tests derive what the compiled
+        // graph must be without looking at how it is compiled.
+        class RecordedGraph {
+        public:
+            UInt32 CreateTransient(const TransientResourceDesc& desc) {
+                m_Resources.push_back({desc, false, ResourceState::Common, ResourceState::Common});
+                return Graph.CreateTransient(desc);
+            }
+
+            UInt32 Import(const ResourceState initialState, const ResourceState finalState) {
+                m_Resources.push_back({{}, true, initialState, finalState});
+                return Graph.Import(initialState, finalState);
+            }
+
+            void AddPass(const bool hasSideEffects = false) {
+                m_Passes.push_back({{}, hasSideEffects});
+                Graph.AddPass(hasSideEffects);
+            }
+
+            void Read(const UInt32 resource, const ResourceState state) {
+                ExpectedUse& use = m_Passes.back().Uses[resource];
+                use.Read = true;
+                if (!use.Write) {
+                    use.State |= state;
+                }
+                Graph.Read(resource, state);
+            }
+
+            void Write(const UInt32 resource, const ResourceState state) {
+                ExpectedUse& use = m_Passes.back().Uses[resource];
+                use.State = state;
+                use.Write = true;
+                Graph.Write(resource, state);
+            }
+
+            // Compiles the graph and checks it against the accesses recorded.
+            void CompileAndCheck();
+
+            RenderGraph Graph;
+
+        private:
+            struct RecordedResource {
+                TransientResourceDesc Desc;
+                bool Imported;
+                ResourceState InitialState;
+                ResourceState FinalState;
+            };
+
+            struct RecordedPass {
+                std::map<UInt32, ExpectedUse> Uses;
+                bool HasSideEffects;
+            };
+
+            std::vector<RecordedResource> m_Resources;
+            std::vector<RecordedPass> m_Passes;
+        };
+
+        void RecordedGraph::CompileAndCheck() {
+            Graph.Compile();
+            const UInt32 passCount = static_cast<UInt32>(m_Passes.size());
+            const UInt32 resourceCount = static_cast<UInt32>(m_Resources.size());
+
+            // Culling: a pass is kept when it writes an imported resource, has side effects, or
+            // wrote last what a pass kept reads.
+            std::vector<std::map<UInt32, UInt32>> producers(passCount);
+            std::vector<UInt32> lastWriters(resourceCount, InvalidIndex);
+            for (UInt32 pass = 0; pass < passCount; ++pass) {
+                for (const auto& [resource, use] : m_Passes[pass].Uses) {
+                    if (use.Read && lastWriters[resource] != InvalidIndex) {
+                        producers[pass][resource] = lastWriters[resource];
+                    }
+                }
+                for (const auto& [resource, use] : m_Passes[pass].Uses) {
+                    if (use.Write) {
+                        lastWriters[resource] = pass;
+                    }
+                }
+            }
+
+            std::vector<bool> kept(passCount, false);
+            for (UInt32 pass = passCount; pass-- > 0;) {
+                kept[pass] = kept[pass] || m_Passes[pass].HasSideEffects;
+                for (const auto& [resource, use] : m_Passes[pass].Uses) {
+                    kept[pass] = kept[pass] || (use.Write && m_Resources[resource].Imported);
+                }
+                if (kept[pass]) {
+                    for (const auto& [resource, producer] : producers[pass]) {
+                        kept[producer] = true;
+                    }
+                }
+            }
+
+            std::vector<UInt32> expectedOrder;
+            for (UInt32 pass = 0; pass < passCount; ++pass) {
+                if (kept[pass]) {
+                    expectedOrder.push_back(pass);
+                }
+            }
+            const std::span<const UInt32> passOrder = Graph.GetPassOrder();
+            Check(std::ranges::equal(passOrder, expectedOrder), "exactly the passes contributing to the frame are kept");
+
+            const RenderGraphStatistics& statistics = Graph.GetStatistics();
+            Check(statistics.PassCount == passCount && statistics.CulledPassCount == passCount - expectedOrder.size(),
+                  "the culled passes are counted");
+
+            // Lifetimes: between the first and the last pass kept using the transient.
+            std::vector<UInt32> firstPasses(resourceCount, InvalidIndex);
+            std::vector<UInt32> lastPasses(resourceCount, InvalidIndex);
+            UInt32 useCount = 0;
+            for (UInt32 compiledPass = 0; compiledPass < expectedOrder.size(); ++compiledPass) {
+                for (const auto& [resource, use] : m_Passes[expectedOrder[compiledPass]].Uses) {
+                    if (firstPasses[resource] == InvalidIndex) {
+                        firstPasses[resource] = compiledPass;
+                    }
+                    lastPasses[resource] = compiledPass;
+                    ++useCount;
+                }
+            }
+            Check(statistics.UseCount == useCount, "the uses of the passes kept are counted");
+
+            const std::span<const UInt64> heapSizes = Graph.GetHeapSizes();
+            UInt32 transientCount = 0;
+            UInt64 transientSize = 0;
+            UInt32 aliasedCount = 0;
+            for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                const RecordedResource& recorded = m_Resources[resource];
+                const TransientPlacement& placement = Graph.GetPlacement(resource);
+                if (recorded.Imported) {
+                    continue;
+                }
+                if (firstPasses[resource] == InvalidIndex) {
+                    Check(placement.FirstPass == InvalidIndex, "a transient unused by the passes kept is not placed");
+                    continue;
+                }
+
+                Check(placement.FirstPass == firstPasses[resource] && placement.LastPass == lastPasses[resource],
+                      "a transient lives from the first to the last pass kept using it");
+                Check(placement.Heap == recorded.Desc.Heap &&
+                      placement.Size == AlignUp(recorded.Desc.Size, recorded.Desc.Alignment),
+                      "a transient is placed in its heap, its size aligned");
+                Check(placement.Offset % recorded.Desc.Alignment == 0 && placement.Heap < heapSizes.size() &&
+                      placement.Offset + placement.Size <= heapSizes[placement.Heap],
+                      "a transient is aligned and inside its heap");
+
+                // Memory shared between two transients must be used at different times.
+                bool aliased = false;
+                for (UInt32 other = 0; other < resourceCount; ++other) {
+                    const TransientPlacement& otherPlacement = Graph.GetPlacement(other);
+                    if (other == resource || m_Resources[other].Imported || otherPlacement.FirstPass == InvalidIndex ||
+                        otherPlacement.Heap != placement.Heap || otherPlacement.Offset >= placement.Offset + placement.Size ||
+                        placement.Offset >= otherPlacement.Offset + otherPlacement.Size) {
+                        continue;
+                    }
+
+                    Check(otherPlacement.LastPass < placement.FirstPass || placement.LastPass < otherPlacement.FirstPass,
+                          "aliased transients never live at the same time");
+                    aliased = true;
+                }
+                Check(placement.Aliased == aliased, "a transient is flagged as aliased when it shares memory");
+
+                ++transientCount;
+                transientSize += placement.Size;
+                aliasedCount += aliased;
+            }
+
+            // The heaps cannot be smaller than the transients alive during a pass.
+            std::vector<UInt64> peakSizes(heapSizes.size(), 0);
+            for (UInt32 compiledPass = 0; compiledPass < expectedOrder.size(); ++compiledPass) {
+                std::vector<UInt64> liveSizes(heapSizes.size(), 0);
+                for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                    const TransientPlacement& placement = Graph.GetPlacement(resource);
+                    if (!m_Resources[resource].Imported && placement.FirstPass <= compiledPass &&
+                        compiledPass <= placement.LastPass && placement.FirstPass != InvalidIndex) {
+                        liveSizes[placement.Heap] += placement.Size;
+                    }
+                }
+                for (std::size_t heap = 0; heap < heapSizes.size(); ++heap) {
+                    peakSizes[heap] = std::max(peakSizes[heap], liveSizes[heap]);
+                }
+            }
+
+            UInt64 heapSize = 0;
+            for (std::size_t heap = 0; heap < heapSizes.size(); ++heap) {
+                Check(heapSizes[heap] % Alignment::ResourcePlacement == 0 && heapSizes[heap] >= peakSizes[heap],
+                      "a heap is aligned and holds the transients alive at once");
+                heapSize += heapSizes[heap];
+            }
+            Check(statistics.TransientCount == transientCount && statistics.TransientSize == transientSize &&
+                  statistics.HeapSize == heapSize, "the memory is counted");
+            Check(heapSize <= transientSize || transientCount == 0, "aliasing never takes more memory");
+
+            // Barriers: replaying them, every use finds its resource in a usable state, and a
+            // transition is only recorded when the state in place does not fit the uses up to
+            // the next write, which then share it.
+            std::vector<ResourceState> states(resourceCount);
+            std::vector<bool> previousWrites(resourceCount, false);
+            UInt32 expectedTransitionCount = 0;
+            UInt32 expectedUavBarrierCount = 0;
+            UInt32 transitionCount = 0;
+            UInt32 uavBarrierCount = 0;
+            UInt32 aliasingBarrierCount = 0;
+            for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                states[resource] = m_Resources[resource].Imported ? m_Resources[resource].InitialState
+                                                                  : Graph.GetPlacement(resource).InitialState;
+            }
+
+            for (UInt32 compiledPass = 0; compiledPass < expectedOrder.size(); ++compiledPass) {
+                const std::map<UInt32, ExpectedUse>& uses = m_Passes[expectedOrder[compiledPass]].Uses;
+
+                std::map<UInt32, ResourceState> neededStates;
+                std::map<UInt32, bool> uavBarriersNeeded;
+                for (const auto& [resource, use] : uses) {
+                    ResourceState needed = use.State;
+                    if (!use.Write) {
+                        // The reads up to the next write of the passes kept.
+                        for (UInt32 next = compiledPass + 1; next < expectedOrder.size(); ++next) {
+                            const auto it = m_Passes[expectedOrder[next]].Uses.find(resource);
+                            if (it != m_Passes[expectedOrder[next]].Uses.end()) {
+                                if (it->second.Write) {
+                                    break;
+                                }
+                                needed |= it->second.State;
+                            }
+                        }
+                    }
+
+                    const bool transition = use.Write ? states[resource] != use.State
+                                                      : !IsStateCompatible(states[resource], needed);
+                    if (transition) {
+                        neededStates[resource] = needed;
+                        ++expectedTransitionCount;
+                    }
+                    uavBarriersNeeded[resource] = !transition && use.Write && previousWrites[resource] &&
+                        use.State == ResourceState::UnorderedAccess;
+                    expectedUavBarrierCount += uavBarriersNeeded[resource];
+                }
+
+                for (const ResourceBarrier& barrier : Graph.GetBarriers(compiledPass)) {
+                    const UInt32 resource = barrier.Resource;
+                    Check(uses.contains(resource), "a barrier is recorded for a resource the pass uses");
+                    switch (barrier.Type) {
+                        case ResourceBarrierType::Transition:
+                            Check(neededStates.contains(resource) && barrier.StateBefore == states[resource] &&
+                                  barrier.StateAfter == neededStates[resource],
+                                  "a needed transition goes from the current state to the one of the uses");
+                            neededStates.erase(resource);
+                            states[resource] = barrier.StateAfter;
+                            ++transitionCount;
+                            break;
+                        case ResourceBarrierType::UnorderedAccess:
+                            Check(uavBarriersNeeded[resource], "a UAV barrier separates two UAV writes");
+                            uavBarriersNeeded[resource] = false;
+                            ++uavBarrierCount;
+                            break;
+                        case ResourceBarrierType::Aliasing:
+                            Check(!m_Resources[resource].Imported && Graph.GetPlacement(resource).Aliased &&
+                                  Graph.GetPlacement(resource).FirstPass == compiledPass,
+                                  "an aliasing barrier starts the lifetime of an aliased transient");
+                            ++aliasingBarrierCount;
+                            break;
+                    }
+                }
+                Check(neededStates.empty(), "every needed transition is recorded");
+
+                for (const auto& [resource, use] : uses) {
+                    Check(use.Write ? states[resource] == use.State : IsStateCompatible(states[resource], use.State),
+                          "every use finds its resource in a usable state");
+                    Check(!uavBarriersNeeded[resource], "every needed UAV barrier is recorded");
+                    Check(m_Resources[resource].Imported || !Graph.GetPlacement(resource).Aliased ||
+                          Graph.GetPlacement(resource).FirstPass != compiledPass || use.Write,
+                          "an aliased transient is written first");
+                    previousWrites[resource] = use.Write;
+                }
+            }
+
+            // Imported resources unused by the passes kept are left as they are.
+            for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                expectedTransitionCount += m_Resources[resource].Imported && firstPasses[resource] != InvalidIndex &&
+                    states[resource] != m_Resources[resource].FinalState;
+            }
+            for (const ResourceBarrier& barrier : Graph.GetFinalBarriers()) {
+                Check(barrier.Type == ResourceBarrierType::Transition && m_Resources[barrier.Resource].Imported &&
+                      barrier.StateBefore == states[barrier.Resource] && barrier.StateBefore != barrier.StateAfter,
+                      "the final barriers return imported resources");
+                states[barrier.Resource] = barrier.StateAfter;
+                ++transitionCount;
+            }
+            for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                if (firstPasses[resource] == InvalidIndex) {
+                    continue;
+                }
+                Check(states[resource] == (m_Resources[resource].Imported ? m_Resources[resource].FinalState
+                                                                          : Graph.GetPlacement(resource).InitialState),
+                      "a resource ends the frame in its final state, or the one the next frame starts in");
+            }
+
+            Check(transitionCount == expectedTransitionCount && statistics.TransitionCount == transitionCount,
+                  "no other transition is recorded");
+            Check(uavBarrierCount == expectedUavBarrierCount && statistics.UavBarrierCount == uavBarrierCount,
+                  "no other UAV barrier is recorded");
+            Check(aliasingBarrierCount == aliasedCount && statistics.AliasingBarrierCount == aliasedCount,
+                  "each aliased transient gets one aliasing barrier");
+        }
+
+        // Passes reading one or two of the resources not read yet and maybe one of the last
+        // written, in varied read states, and writing one or two new ones in three heaps, some
+        // with the 4 MiB alignment of MSAA targets and sizes that are not aligned. Buffers are
+        // sometimes updated in place, a history buffer is read early and written late, some
+        // passes only have side effects, and debug outputs nothing reads get culled.
+        void BuildSyntheticGraph(RecordedGraph& graph, const UInt32 passCount, const UInt32 seed) {
+            constexpr ResourceState ReadStates[] = {
+                ResourceState::PixelShaderResource, ResourceState::NonPixelShaderResource,
+                ResourceState::CopySource, ResourceState::IndirectArgument
+            };
+
+            std::mt19937 random(seed);
+            std::vector<UInt32> written;
+            std::vector<UInt32> unread;
+            std::vector<UInt32> buffers;
+
+            const UInt32 backBuffer = graph.Import(ResourceState::Present, ResourceState::Present);
+            const UInt32 history = graph.Import(ResourceState::PixelShaderResource, ResourceState::PixelShaderResource);
+            const UInt32 depth = graph.CreateTransient({32 * MiB, Alignment::ResourcePlacement, 0});
+            graph.AddPass();
+            graph.Write(depth, ResourceState::DepthWrite);
+
+            const auto readRandomly = [&](const UInt32 resource) {
+                graph.Read(resource, ReadStates[random() % 4]);
+                if (random() % 4 == 0) {
+                    graph.Read(resource, ReadStates[random() % 4]);
+                }
+            };
+
+            for (UInt32 pass = 1; pass + 1 < passCount; ++pass) {
+                const bool hasSideEffects = random() % 32 == 0;
+                graph.AddPass(hasSideEffects);
+
+                const UInt32 unreadCount = std::min<UInt32>(1 + random() % 2, static_cast<UInt32>(unread.size()));
+                for (UInt32 i = 0; i < unreadCount; ++i) {
+                    const std::size_t index = random() % unread.size();
+                    readRandomly(unread[index]);
+                    unread[index] = unread.back();
+                    unread.pop_back();
+                }
+
+                if (!written.empty() && random() % 2 == 0) {
+                    readRandomly(written[written.size() - 1 - random() % std::min<std::size_t>(written.size(), 16)]);
+                }
+                if (random() % 8 == 0) {
+                    graph.Read(depth, ResourceState::DepthRead);
+                }
+                if (pass == passCount / 4) {
+                    graph.Read(history, ResourceState::PixelShaderResource);
+                }
+                if (!buffers.empty() && random() % 6 == 0) {
+                    const UInt32 buffer = buffers[buffers.size() - 1 - random() % std::min<std::size_t>(buffers.size(), 4)];
+                    graph.Read(buffer, ResourceState::UnorderedAccess);
+                    graph.Write(buffer, ResourceState::UnorderedAccess);
+                }
+                if (hasSideEffects) {
+                    continue;
+                }
+
+                const bool debugOutput = random() % 16 == 0;
+                const UInt32 writeCount = random() % 4 == 0 ? 2 : 1;
+                for (UInt32 i = 0; i < writeCount; ++i) {
+                    UInt32 resource;
+                    switch (random() % 3) {
+                        case 0:
+                            resource = graph.CreateTransient({(1 + random() % 16) * 4 * MiB, 4 * MiB, 0});
+                            graph.Write(resource, ResourceState::RenderTarget);
+                            break;
+                        case 1:
+                            resource = graph.CreateTransient({(1 + random() % 16) * MiB + random() % MiB,
+                                                              Alignment::ResourcePlacement, 1});
+                            graph.Write(resource, random() % 2 ? ResourceState::RenderTarget : ResourceState::CopyDest);
+                            break;
+                        default:
+                            resource = graph.CreateTransient({1 + random() % (8 * MiB), Alignment::ResourcePlacement, 2});
+                            graph.Write(resource, ResourceState::UnorderedAccess);
+                            if (!debugOutput) {
+                                buffers.push_back(resource);
+                            }
+                            break;
+                    }
+
+                    if (!debugOutput) {
+                        written.push_back(resource);
+                        unread.push_back(resource);
+                    }
+                }
+            }
+
+            graph.AddPass();
+            for (const UInt32 resource : unread) {
+                graph.Read(resource, ResourceState::PixelShaderResource);
+            }
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+            graph.Write(history, ResourceState::RenderTarget);
+        }
+    }
+
+    void RunRenderGraphTests(TestSuite& suite) {
+        suite.Run("RenderGraph/Culling", [] {
+            RecordedGraph graph;
+            const UInt32 backBuffer = graph.Import(ResourceState::Present, ResourceState::Present);
+            const UInt32 history = graph.Import(ResourceState::PixelShaderResource, ResourceState::PixelShaderResource);
+            UInt32 transients[5];
+            for (UInt32& transient : transients) {
+                transient = graph.CreateTransient({4 * MiB});
+            }
+
+            graph.AddPass();
+            graph.Write(transients[0], ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Read(transients[0], ResourceState::PixelShaderResource);
+            graph.Write(transients[1], ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Write(transients[2], ResourceState::RenderTarget);
+            graph.AddPass(true);
+            graph.Write(transients[3], ResourceState::UnorderedAccess);
+            graph.AddPass();
+            graph.Read(transients[2], ResourceState::PixelShaderResource);
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+            // Overwritten before being read.
+            graph.AddPass();
+            graph.Write(transients[4], ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Write(transients[4], ResourceState::UnorderedAccess);
+            graph.AddPass();
+            graph.Read(transients[4], ResourceState::PixelShaderResource);
+            graph.Write(history, ResourceState::RenderTarget);
+            // Reads only.
+            graph.AddPass();
+            graph.Read(history, ResourceState::PixelShaderResource);
+            graph.CompileAndCheck();
+
+            const std::vector<UInt32> expectedOrder = {2, 3, 4, 6, 7};
+            Check(std::ranges::equal(graph.Graph.GetPassOrder(), expectedOrder),
+                  "the passes whose writes are never read are culled");
+            Check(graph.Graph.GetPlacement(transients[0]).FirstPass == InvalidIndex &&
+                  graph.Graph.GetPlacement(transients[1]).FirstPass == InvalidIndex,
+                  "the transients of the culled passes are not placed");
+            Check(graph.Graph.GetPlacement(transients[4]).FirstPass == 3, "an overwritten transient lives from the last write");
+            Check(graph.Graph.GetStatistics().CulledPassCount == 4 && graph.Graph.GetStatistics().TransientCount == 3,
+                  "the counts follow");
+        });
+
+        suite.Run("RenderGraph/Barriers", [] {
+            RecordedGraph graph;
+            const UInt32 backBuffer = graph.Import(ResourceState::Present, ResourceState::Present);
+            const UInt32 color = graph.CreateTransient({8 * MiB, Alignment::ResourcePlacement, 0});
+            const UInt32 buffer = graph.CreateTransient({MiB, Alignment::ResourcePlacement, 1});
+
+            graph.AddPass();
+            graph.Write(color, ResourceState::RenderTarget);
+            graph.Write(buffer, ResourceState::UnorderedAccess);
+            graph.AddPass();
+            graph.Read(buffer, ResourceState::UnorderedAccess);
+            graph.Write(buffer, ResourceState::UnorderedAccess);
+            graph.AddPass();
+            graph.Read(color, ResourceState::PixelShaderResource);
+            graph.Read(buffer, ResourceState::NonPixelShaderResource);
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+            // An overlay drawn on top.
+            graph.AddPass();
+            graph.Read(color, ResourceState::NonPixelShaderResource);
+            graph.Read(buffer, ResourceState::IndirectArgument);
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+            graph.CompileAndCheck();
+
+            const RenderGraph& compiled = graph.Graph;
+            constexpr ResourceState ShaderResource = ResourceState::PixelShaderResource |
+                ResourceState::NonPixelShaderResource;
+            constexpr ResourceState Arguments = ResourceState::NonPixelShaderResource | ResourceState::IndirectArgument;
+            Check(compiled.GetPlacement(color).InitialState == ShaderResource &&
+                  compiled.GetPlacement(buffer).InitialState == Arguments,
+                  "the transients start in the state the frame leaves them in");
+
+            const std::span<const ResourceBarrier> first = compiled.GetBarriers(0);
+            Check(first.size() == 2 && IsTransition(first[0], color, ShaderResource, ResourceState::RenderTarget) &&
+                  IsTransition(first[1], buffer, Arguments, ResourceState::UnorderedAccess),
+                  "the first writes transition from the previous frame");
+            const std::span<const ResourceBarrier> second = compiled.GetBarriers(1);
+            Check(second.size() == 1 && IsBarrier(second[0], buffer, ResourceBarrierType::UnorderedAccess),
+                  "a UAV written twice only needs a UAV barrier");
+            const std::span<const ResourceBarrier> third = compiled.GetBarriers(2);
+            Check(third.size() == 3 &&
+                  IsTransition(third[0], backBuffer, ResourceState::Present, ResourceState::RenderTarget) &&
+                  IsTransition(third[1], color, ResourceState::RenderTarget, ShaderResource) &&
+                  IsTransition(third[2], buffer, ResourceState::UnorderedAccess, Arguments),
+                  "consecutive reads share one transition to the combination of their states");
+            Check(compiled.GetBarriers(3).empty(), "the later reads and render target writes need no barrier");
+            const std::span<const ResourceBarrier> final = compiled.GetFinalBarriers();
+            Check(final.size() == 1 && IsTransition(final[0], backBuffer, ResourceState::RenderTarget, ResourceState::Present),
+                  "the imported resource returns to its final state");
+            Check(compiled.GetStatistics().TransitionCount == 6 && compiled.GetStatistics().UavBarrierCount == 1 &&
+                  compiled.GetStatistics().AliasingBarrierCount == 0, "the barriers are counted");
+        });
+
+        suite.Run("RenderGraph/Aliasing", [] {
+            // a lives during passes 0-1, c during 1-2 and b during 2-3: a and b share memory.
+            RecordedGraph graph;
+            const UInt32 backBuffer = graph.Import(ResourceState::Present, ResourceState::Present);
+            const UInt32 a = graph.CreateTransient({4 * MiB});
+            const UInt32 b = graph.CreateTransient({4 * MiB});
+            const UInt32 c = graph.CreateTransient({4 * MiB});
+
+            graph.AddPass();
+            graph.Write(a, ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Read(a, ResourceState::PixelShaderResource);
+            graph.Write(c, ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Read(c, ResourceState::PixelShaderResource);
+            graph.Write(b, ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Read(b, ResourceState::PixelShaderResource);
+            graph.Write(backBuffer, ResourceState::RenderTarget);
+            graph.CompileAndCheck();
+
+            const RenderGraph& compiled = graph.Graph;
+            Check(compiled.GetPlacement(a).Offset == compiled.GetPlacement(b).Offset &&
+                  compiled.GetPlacement(a).Aliased && compiled.GetPlacement(b).Aliased && !compiled.GetPlacement(c).Aliased,
+                  "the transients used at different times share memory");
+            Check(compiled.GetStatistics().HeapSize == 8 * MiB && compiled.GetStatistics().TransientSize == 12 * MiB,
+                  "the heap is smaller than the transients");
+            Check(IsBarrier(compiled.GetBarriers(2)[0], b, ResourceBarrierType::Aliasing),
+                  "an aliasing barrier comes first in the pass starting the lifetime");
+        });
+
+        suite.Run("RenderGraph/SyntheticGraphs", [] {
+            // Up to 1000 passes, compiled twice to check that the compilation state is reset.
+            for (UInt32 seed = 0; seed < 40; ++seed) {
+                const UInt32 passCount = seed == 0 ? 1000 : 2 + seed * 7;
+                RecordedGraph graph;
+                BuildSyntheticGraph(graph, passCount, seed);
+                graph.CompileAndCheck();
+                graph.CompileAndCheck();
+
+                const RenderGraphStatistics& statistics = graph.Graph.GetStatistics();
+                if (passCount >= 100) {
+                    Check(statistics.CulledPassCount > 0 && statistics.AliasingBarrierCount > 0 &&
+                          statistics.HeapSize < statistics.TransientSize / 2,
+                          "large graphs cull passes and alias most of their memory");
+                }
+            }
+
+            // The graph is reused for the next frame.
+            RecordedGraph graph;
+            BuildSyntheticGraph(graph, 50, 1);
+            graph.Graph.Clear();
+            Check(graph.Graph.GetPassCount() == 0 && graph.Graph.GetResourceCount() == 0, "clearing empties the graph");
+        });
+
+        suite.Run("RenderGraph/InvalidInput", [] {
+            RenderGraph graph;
+            CheckThrows<std::invalid_argument>([&] { graph.CreateTransient({0}); }, "an empty transient is rejected");
+            CheckThrows<std::invalid_argument>([&] { graph.CreateTransient({MiB, 3}); },
+                                               "an alignment that is not a power of two is rejected");
+            const UInt32 transient = graph.CreateTransient({MiB});
+            CheckThrows<std::logic_error>([&] { graph.Read(transient, ResourceState::PixelShaderResource); },
+                                          "an access without a pass is rejected");
+
+            graph.AddPass();
+            CheckThrows<std::invalid_argument>([&] { graph.Write(transient, ResourceState::PixelShaderResource); },
+                                               "a write in a read-only state is rejected");
+            CheckThrows<std::invalid_argument>([&] { graph.Read(transient + 1, ResourceState::PixelShaderResource); },
+                                               "an unknown resource is rejected");
+            graph.Read(transient, ResourceState::PixelShaderResource);
+            CheckThrows<std::invalid_argument>([&] { graph.Compile(); }, "a transient read before written is rejected");
+
+            graph.Clear();
+            const UInt32 other = graph.CreateTransient({MiB});
+            graph.AddPass();
+            graph.Write(other, ResourceState::RenderTarget);
+            graph.Write(other, ResourceState::UnorderedAccess);
+            CheckThrows<std::invalid_argument>([&] { graph.Compile(); }, "two write states in a pass are rejected");
+
+            graph.Clear();
+            const UInt32 third = graph.CreateTransient({MiB});
+            graph.AddPass();
+            graph.Write(third, ResourceState::RenderTarget);
+            graph.AddPass();
+            graph.Read(third, ResourceState::RenderTarget);
+            CheckThrows<std::invalid_argument>([&] { graph.Compile(); }, "a read in a write state alone is rejected");
+        });
+    }
+}
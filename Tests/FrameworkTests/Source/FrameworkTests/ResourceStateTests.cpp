@@ -0,0 +1,365 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/ResourceStateTracker.hpp"
+
+#include <array>
+#include <random>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        bool IsTransition(const ResourceBarrier& barrier, const UInt32 resource, const UInt32 subresource,
+                          const ResourceState before, const ResourceState after,
+                          const ResourceBarrierFlags flags = ResourceBarrierFlags::None) {
+            return barrier.Type == ResourceBarrierType::Transition && barrier.Resource == resource &&
+                barrier.Subresource == subresource && barrier.StateBefore == before && barrier.StateAfter == after &&
+                barrier.Flags == flags;
+        }
+
+        // The states of the subresources as the GPU sees them, updated by executing barriers.
+        // The state of a subresource in a split transition is the one it goes to, flagged.
+        class GpuStates {
+        public:
+            GpuStates(const ResourceStateTable& table, const UInt32 resourceCount) {
+                for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                    std::vector<Subresource>& subresources = m_Resources.emplace_back();
+                    for (UInt32 i = 0; i < table.GetSubresourceCount(resource); ++i) {
+                        subresources.push_back({table.GetState(resource, i), false});
+                    }
+                }
+            }
+
+            void Execute(std::span<const ResourceBarrier> barriers) {
+                for (const ResourceBarrier& barrier : barriers) {
+                    if (barrier.Type != ResourceBarrierType::Transition) {
+                        continue;
+                    }
+
+                    std::vector<Subresource>& subresources = m_Resources[barrier.Resource];
+                    const UInt32 first = barrier.Subresource == AllSubresources ? 0 : barrier.Subresource;
+                    const UInt32 last = barrier.Subresource == AllSubresources
+                                            ? static_cast<UInt32>(subresources.size())
+                                            : barrier.Subresource + 1;
+                    for (UInt32 i = first; i < last; ++i) {
+                        Execute(barrier, subresources[i]);
+                    }
+                }
+            }
+
+            // Whether the subresource can be used in the state.
+            bool IsUsable(const UInt32 resource, const UInt32 subresource, const ResourceState state) const {
+                const Subresource& current = m_Resources[resource][subresource];
+                return !current.Splitting && IsStateCompatible(current.State, state);
+            }
+
+            ResourceState GetState(const UInt32 resource, const UInt32 subresource) const {
+                return m_Resources[resource][subresource].State;
+            }
+
+        private:
+            struct Subresource {
+                ResourceState State;
+                bool Splitting;
+            };
+
+            static void Execute(const ResourceBarrier& barrier, Subresource& subresource) {
+                // The debug layer requires the exact state before, a compatible one is not enough.
+                if (barrier.Flags == ResourceBarrierFlags::EndOnly) {
+                    Check(subresource.Splitting && subresource.State == barrier.StateAfter,
+                          "a split transition ends as it began");
+                    subresource.Splitting = false;
+                    return;
+                }
+
+                Check(!subresource.Splitting && subresource.State == barrier.StateBefore,
+                      "a transition starts from the state of the subresource");
+                subresource.State = barrier.StateAfter;
+                subresource.Splitting = barrier.Flags == ResourceBarrierFlags::BeginOnly;
+            }
+
+            std::vector<std::vector<Subresource>> m_Resources;
+        };
+
+        struct Use {
+            UInt32 Resource;
+            UInt32 Subresource;
+            ResourceState State;
+        };
+
+        // Records random lists on random resources, resolves them in order, and executes the
+        // barriers on the simulated GPU, checking every use.
+        void CheckRandomLists(const bool enableSplitBarriers, const UInt32 seed) {
+            constexpr std::array States = {
+                ResourceState::RenderTarget, ResourceState::UnorderedAccess, ResourceState::PixelShaderResource,
+                ResourceState::NonPixelShaderResource,
+                ResourceState::PixelShaderResource | ResourceState::NonPixelShaderResource,
+                ResourceState::CopySource, ResourceState::CopyDest, ResourceState::Common
+            };
+
+            std::mt19937 random(seed);
+            ResourceStateTable table;
+            const UInt32 resourceCount = 6;
+            for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                table.Register(1 + resource % 3, States[random() % States.size()]);
+            }
+
+            ResourceStateTracker tracker(table, enableSplitBarriers);
+            for (UInt32 list = 0; list < 300; ++list) {
+                // A list is a sequence of batches, each one flushed before the uses it prepares.
+                std::vector<std::vector<ResourceBarrier>> batches;
+                std::vector<std::vector<Use>> batchUses;
+
+                const UInt32 batchCount = 1 + random() % 6;
+                for (UInt32 batch = 0; batch < batchCount; ++batch) {
+                    std::vector<Use>& uses = batchUses.emplace_back();
+                    const UInt32 requestCount = 1 + random() % 5;
+                    for (UInt32 request = 0; request < requestCount; ++request) {
+                        const UInt32 resource = random() % resourceCount;
+                        const UInt32 subresourceCount = table.GetSubresourceCount(resource);
+                        const ResourceState state = States[random() % States.size()];
+                        const UInt32 subresource = random() % 2 == 0 ? AllSubresources : random() % subresourceCount;
+
+                        // The last request on a subresource within a batch is the one the flush
+                        // prepares for; beginning a transition only prepares a later use.
+                        const bool begin = random() % 4 == 0;
+                        if (begin) {
+                            tracker.BeginTransition(resource, state, subresource);
+                        } else {
+                            tracker.Transition(resource, state, subresource);
+                        }
+
+                        for (UInt32 i = 0; i < subresourceCount; ++i) {
+                            if (subresource == AllSubresources || subresource == i) {
+                                std::erase_if(uses, [resource, i](const Use& use) {
+                                    return use.Resource == resource && use.Subresource == i;
+                                });
+                                if (!begin) {
+                                    uses.push_back({resource, i, state});
+                                }
+                            }
+                        }
+                    }
+
+                    const std::span<const ResourceBarrier> barriers =
+                        batch + 1 == batchCount ? tracker.Close() : tracker.Flush();
+                    batches.emplace_back(barriers.begin(), barriers.end());
+                }
+
+                GpuStates gpu(table, resourceCount);
+                gpu.Execute(table.Resolve(tracker));
+                for (UInt32 batch = 0; batch < batchCount; ++batch) {
+                    gpu.Execute(batches[batch]);
+                    for (const Use& use : batchUses[batch]) {
+                        Check(gpu.IsUsable(use.Resource, use.Subresource, use.State),
+                              "every use finds its subresource in a compatible state");
+                    }
+                }
+
+                for (UInt32 resource = 0; resource < resourceCount; ++resource) {
+                    for (UInt32 i = 0; i < table.GetSubresourceCount(resource); ++i) {
+                        Check(gpu.IsUsable(resource, i, gpu.GetState(resource, i)) &&
+                                  table.GetState(resource, i) == gpu.GetState(resource, i),
+                              "the table holds the states the list leaves its resources in");
+                    }
+                }
+
+                tracker.Reset();
+            }
+        }
+    }
+
+    void RunResourceStateTests(TestSuite& suite) {
+        suite.Run("ResourceState/Compatibility", [] {
+            constexpr ResourceState shaderResource =
+                ResourceState::PixelShaderResource | ResourceState::NonPixelShaderResource;
+            Check(IsStateCompatible(shaderResource, ResourceState::PixelShaderResource),
+                  "a combination of read states covers each of them");
+            Check(!IsStateCompatible(ResourceState::PixelShaderResource, shaderResource),
+                  "a read state does not cover a wider combination");
+            Check(!IsStateCompatible(ResourceState::RenderTarget, ResourceState::PixelShaderResource),
+                  "a write state covers nothing else");
+            Check(!IsReadOnlyState(ResourceState::Common) && IsReadOnlyState(ResourceState::GenericRead),
+                  "common is not a read state");
+        });
+
+        suite.Run("ResourceStateTable/ResolvesFirstUses", [] {
+            ResourceStateTable table;
+            const UInt32 texture = table.Register(1, ResourceState::Common);
+            const UInt32 buffer = table.Register(1, ResourceState::CopyDest);
+
+            ResourceStateTracker tracker(table);
+            tracker.Transition(texture, ResourceState::RenderTarget);
+            tracker.Transition(buffer, ResourceState::CopyDest);
+            Check(tracker.Flush().empty(), "first uses record no barrier in the list");
+            tracker.Transition(texture, ResourceState::PixelShaderResource);
+            const std::span<const ResourceBarrier> recorded = tracker.Close();
+            Check(recorded.size() == 1 && IsTransition(recorded[0], texture, AllSubresources,
+                                                       ResourceState::RenderTarget,
+                                                       ResourceState::PixelShaderResource),
+                  "later uses transition from the state the list put the resource in");
+
+            const std::span<const ResourceBarrier> resolved = table.Resolve(tracker);
+            Check(resolved.size() == 1 && IsTransition(resolved[0], texture, AllSubresources, ResourceState::Common,
+                                                       ResourceState::RenderTarget),
+                  "resolving transitions the resources whose state differs from the first use");
+            Check(table.GetState(texture, 0) == ResourceState::PixelShaderResource &&
+                      table.GetState(buffer, 0) == ResourceState::CopyDest,
+                  "the table takes the states the list leaves");
+        });
+
+        suite.Run("ResourceStateTracker/DropsAndMergesTransitions", [] {
+            ResourceStateTable table;
+            const UInt32 texture = table.Register(1, ResourceState::Common);
+
+            ResourceStateTracker tracker(table);
+            tracker.Transition(texture, ResourceState::PixelShaderResource | ResourceState::NonPixelShaderResource);
+            tracker.Transition(texture, ResourceState::PixelShaderResource);
+            Check(tracker.Flush().empty(), "a use covered by the current state needs no barrier");
+
+            tracker.Transition(texture, ResourceState::RenderTarget);
+            tracker.Transition(texture, ResourceState::CopySource);
+            std::span<const ResourceBarrier> barriers = tracker.Flush();
+            Check(barriers.size() == 1 &&
+                      IsTransition(barriers[0], texture, AllSubresources,
+                                   ResourceState::PixelShaderResource | ResourceState::NonPixelShaderResource,
+                                   ResourceState::CopySource),
+                  "consecutive transitions in a batch are merged");
+
+            tracker.Transition(texture, ResourceState::CopyDest);
+            tracker.Transition(texture, ResourceState::CopySource);
+            Check(tracker.Flush().empty(), "a transition back to the state before is dropped");
+        });
+
+        suite.Run("ResourceStateTable/MergesSubresources", [] {
+            ResourceStateTable table;
+            const UInt32 texture = table.Register(4, ResourceState::CopyDest);
+
+            ResourceStateTracker tracker(table);
+            tracker.Transition(texture, ResourceState::CopyDest);
+            tracker.Transition(texture, ResourceState::PixelShaderResource);
+            std::span<const ResourceBarrier> barriers = tracker.Flush();
+            Check(barriers.size() == 1 && IsTransition(barriers[0], texture, AllSubresources, ResourceState::CopyDest,
+                                                       ResourceState::PixelShaderResource),
+                  "the transitions of every subresource are merged into one");
+
+            tracker.Transition(texture, ResourceState::RenderTarget, 2);
+            barriers = tracker.Close();
+            Check(barriers.size() == 1 && IsTransition(barriers[0], texture, 2, ResourceState::PixelShaderResource,
+                                                       ResourceState::RenderTarget),
+                  "a single subresource keeps its own barrier");
+
+            table.Resolve(tracker);
+            Check(table.GetState(texture, 1) == ResourceState::PixelShaderResource &&
+                      table.GetState(texture, 2) == ResourceState::RenderTarget,
+                  "the table tracks the subresources apart");
+
+            // Subresources in different states resolve one by one, and agree again afterwards.
+            tracker.Reset();
+            tracker.Transition(texture, ResourceState::CopySource);
+            tracker.Close();
+            const std::span<const ResourceBarrier> resolved = table.Resolve(tracker);
+            Check(resolved.size() == 4 && IsTransition(resolved[2], texture, 2, ResourceState::RenderTarget,
+                                                       ResourceState::CopySource),
+                  "subresources in different states are transitioned one by one");
+            Check(table.GetState(texture, 3) == ResourceState::CopySource, "the subresources agree again");
+
+            std::vector<ResourceBarrier> noOps = {
+                {texture, 0, ResourceState::CopySource, ResourceState::CopySource, ResourceBarrierType::Transition,
+                 ResourceBarrierFlags::None}
+            };
+            table.MergeBarriers(noOps);
+            Check(noOps.empty(), "transitions that do not change the state are dropped");
+        });
+
+        suite.Run("ResourceStateTracker/UavBarriers", [] {
+            ResourceStateTable table;
+            const UInt32 buffer = table.Register(1, ResourceState::UnorderedAccess);
+
+            ResourceStateTracker tracker(table);
+            tracker.Transition(buffer, ResourceState::UnorderedAccess);
+            tracker.UavBarrier(buffer);
+            tracker.UavBarrier(buffer);
+            std::span<const ResourceBarrier> barriers = tracker.Flush();
+            Check(barriers.size() == 1 && barriers[0].Type == ResourceBarrierType::UnorderedAccess &&
+                      barriers[0].Resource == buffer,
+                  "one UAV barrier per resource and batch");
+
+            tracker.UavBarrier(buffer);
+            Check(tracker.Flush().size() == 1, "the next batch has its own UAV barrier");
+        });
+
+        suite.Run("ResourceStateTracker/SplitBarriers", [] {
+            ResourceStateTable table;
+            const UInt32 texture = table.Register(1, ResourceState::RenderTarget);
+
+            ResourceStateTracker tracker(table, true);
+            tracker.Transition(texture, ResourceState::RenderTarget);
+            tracker.BeginTransition(texture, ResourceState::PixelShaderResource);
+            std::span<const ResourceBarrier> barriers = tracker.Flush();
+            Check(barriers.size() == 1 && IsTransition(barriers[0], texture, AllSubresources,
+                                                       ResourceState::RenderTarget, ResourceState::PixelShaderResource,
+                                                       ResourceBarrierFlags::BeginOnly),
+                  "a transition begins early");
+
+            tracker.Transition(texture, ResourceState::PixelShaderResource);
+            barriers = tracker.Flush();
+            Check(barriers.size() == 1 && IsTransition(barriers[0], texture, AllSubresources,
+                                                       ResourceState::RenderTarget, ResourceState::PixelShaderResource,
+                                                       ResourceBarrierFlags::EndOnly),
+                  "the use ends the split transition");
+
+            tracker.BeginTransition(texture, ResourceState::CopyDest);
+            tracker.Transition(texture, ResourceState::CopyDest);
+            barriers = tracker.Flush();
+            Check(barriers.size() == 1 && barriers[0].Flags == ResourceBarrierFlags::None,
+                  "a transition used within its batch is not split");
+
+            tracker.BeginTransition(texture, ResourceState::RenderTarget);
+            tracker.Flush();
+            barriers = tracker.Close();
+            Check(barriers.size() == 1 && barriers[0].Flags == ResourceBarrierFlags::EndOnly,
+                  "closing the list ends the split transitions in flight");
+
+            ResourceStateTracker unsplit(table);
+            unsplit.Transition(texture, ResourceState::RenderTarget);
+            unsplit.BeginTransition(texture, ResourceState::PixelShaderResource);
+            Check(unsplit.Flush().empty(), "without split barriers, beginning a transition records nothing");
+        });
+
+        suite.Run("ResourceStateTable/InvalidUses", [] {
+            ResourceStateTable table;
+            ResourceStateTable otherTable;
+            const UInt32 texture = table.Register(2, ResourceState::Common);
+
+            ResourceStateTracker tracker(table);
+            CheckThrows<std::out_of_range>([&] { tracker.Transition(texture, ResourceState::CopyDest, 2); },
+                                           "a subresource out of range is rejected");
+            tracker.Transition(texture, ResourceState::CopyDest);
+            CheckThrows<std::logic_error>([&] { table.Resolve(tracker); }, "a list still recording is not resolved");
+            tracker.Close();
+            CheckThrows<std::invalid_argument>([&] { otherTable.Resolve(tracker); },
+                                               "a list of another table is rejected");
+            CheckThrows<std::logic_error>([&] { tracker.Transition(texture, ResourceState::Common); },
+                                          "a closed list records nothing");
+
+            table.Unregister(texture);
+            table.Register(1, ResourceState::Common);
+            CheckThrows<std::logic_error>([&] { table.Resolve(tracker); },
+                                          "a list using an unregistered resource is rejected");
+        });
+
+        suite.Run("ResourceStateTracker/RandomLists", [] {
+            CheckRandomLists(false, 5);
+        });
+
+        suite.Run("ResourceStateTracker/RandomListsWithSplitBarriers", [] {
+            CheckRandomLists(true, 6);
+        });
+    }
+}
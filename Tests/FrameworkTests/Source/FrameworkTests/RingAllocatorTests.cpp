@@ -0,0 +1,201 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/ManualGpuTimeline.hpp"
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/RingAllocator.hpp"
+#include "Framework/TimelineRingAllocator.hpp"
+#include "Framework/UploadRing.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        struct LiveAllocation {
+            UInt64 Offset;
+            UInt64 Size;
+            UInt64 FenceValue;
+        };
+
+        bool Overlaps(const LiveAllocation& a, const UInt64 offset, const UInt64 size) {
+            return a.Offset < offset + size && offset < a.Offset + a.Size;
+        }
+    }
+
+    void RunRingAllocatorTests(TestSuite& suite) {
+        suite.Run("RingAllocator/Wraparound", [] {
+            RingAllocator ring(100);
+            Check(ring.Allocate(40, 1, 1) == 0 && ring.Allocate(40, 1, 2) == 40, "allocations are contiguous");
+            Check(ring.Allocate(30, 1, 3) == RingAllocator::InvalidOffset,
+                  "an allocation does not overwrite live ones");
+
+            ring.Release(1);
+            Check(ring.GetUsedSize() == 40 && ring.GetOldestFenceValue() == 2, "releasing frees the oldest region");
+
+            // 20 bytes are left before the end, too few: the allocation wraps and they are lost.
+            Check(ring.Allocate(30, 1, 3) == 0, "an allocation not fitting before the end wraps");
+            Check(ring.GetUsedSize() == 90, "the space skipped at the end is used until released");
+            Check(ring.Allocate(11, 1, 3) == RingAllocator::InvalidOffset, "the ring cannot exceed its capacity");
+
+            ring.Release(2);
+            Check(ring.GetUsedSize() == 50, "the skipped space is released with the allocation that wrapped");
+            ring.Release(3);
+            Check(ring.IsEmpty() && ring.GetUsedSize() == 0, "everything is released");
+            Check(ring.Allocate(100, 1, 4) == 0, "an empty ring restarts from the beginning");
+        });
+
+        suite.Run("RingAllocator/Alignment", [] {
+            RingAllocator ring(1024);
+            Check(ring.Allocate(1, 1, 1) == 0, "the first allocation starts the ring");
+            Check(ring.Allocate(16, 256, 1) == 256, "allocations are aligned");
+            Check(ring.GetUsedSize() == 272, "the padding counts as used");
+            Check(ring.Allocate(513, 512, 2) == RingAllocator::InvalidOffset, "the alignment padding needs room too");
+            Check(ring.Allocate(512, 512, 2) == 512, "an aligned allocation may end the ring");
+        });
+
+        suite.Run("RingAllocator/InvalidSizes", [] {
+            CheckThrows<std::invalid_argument>([] { RingAllocator ring(0); }, "an empty ring is rejected");
+
+            RingAllocator ring(64);
+            Check(ring.Allocate(0, 1, 1) == RingAllocator::InvalidOffset, "empty allocations fail");
+            Check(ring.Allocate(65, 1, 1) == RingAllocator::InvalidOffset, "allocations larger than the ring fail");
+        });
+
+        suite.Run("RingAllocator/RandomNoOverlap", [] {
+            constexpr UInt64 Capacity = 4096;
+
+            std::mt19937 random(1);
+            RingAllocator ring(Capacity);
+            std::vector<LiveAllocation> live;
+            UInt64 fenceValue = 1;
+            UInt64 completedValue = 0;
+
+            for (UInt32 i = 0; i < 20000; ++i) {
+                const UInt64 size = 1 + random() % 700;
+                const UInt64 alignment = 1ull << (random() % 8);
+                const UInt64 offset = ring.Allocate(size, alignment, fenceValue);
+                if (offset != RingAllocator::InvalidOffset) {
+                    Check(offset % alignment == 0 && offset + size <= Capacity, "allocations are aligned and in range");
+                    for (const LiveAllocation& allocation : live) {
+                        Check(!Overlaps(allocation, offset, size), "live allocations never overlap");
+                    }
+                    live.push_back({offset, size, fenceValue});
+                }
+
+                if (random() % 3 == 0) {
+                    ++fenceValue;
+                }
+                if (offset == RingAllocator::InvalidOffset || random() % 5 == 0) {
+                    completedValue = std::min<UInt64>(fenceValue - 1, completedValue + 1 + random() % 3);
+                    ring.Release(completedValue);
+                    std::erase_if(live, [completedValue](const LiveAllocation& allocation) {
+                        return allocation.FenceValue <= completedValue;
+                    });
+                }
+
+                UInt64 liveSize = 0;
+                for (const LiveAllocation& allocation : live) {
+                    liveSize += allocation.Size;
+                }
+                Check(liveSize <= ring.GetUsedSize() && ring.GetUsedSize() <= Capacity,
+                      "the used size covers the live allocations");
+            }
+        });
+
+        suite.Run("TimelineRingAllocator/WaitsForOldestFence", [] {
+            ManualGpuTimeline timeline;
+            TimelineRingAllocator allocator(timeline, 256);
+
+            Check(allocator.Allocate(100, 1) == 0, "the first frame allocates from the start");
+            timeline.Signal();
+            Check(allocator.Allocate(100, 1) == 100, "the second frame allocates after it");
+            timeline.Signal();
+
+            // 56 bytes are left: the allocation wraps over the first frame, which must be waited for.
+            Check(allocator.Allocate(100, 1) == 0, "the space of the oldest frame is reused");
+            Check(timeline.GetWaits().size() == 1 && timeline.GetWaits()[0] == 1,
+                  "only the frame being overwritten is waited for");
+            Check(allocator.GetWaitCount() == 1, "the wait is counted");
+        });
+
+        suite.Run("TimelineRingAllocator/NoWaitOnceCompleted", [] {
+            ManualGpuTimeline timeline;
+            TimelineRingAllocator allocator(timeline, 256);
+
+            allocator.Allocate(200, 1);
+            timeline.CompleteUpTo(timeline.Signal());
+            Check(allocator.Allocate(200, 1) == 0, "the space of a completed frame is reused");
+            Check(timeline.GetWaits().empty() && allocator.GetWaitCount() == 0, "a completed frame is not waited for");
+        });
+
+        suite.Run("TimelineRingAllocator/UnsubmittedWorkIsNotWaitedFor", [] {
+            ManualGpuTimeline timeline;
+            TimelineRingAllocator allocator(timeline, 256);
+
+            allocator.Allocate(200, 1);
+            CheckThrows<std::length_error>([&allocator] { allocator.Allocate(100, 1); },
+                                           "allocations since the last signal cannot be reclaimed");
+            CheckThrows<std::length_error>([&allocator] { allocator.Allocate(257, 1); },
+                                           "an allocation larger than the ring never fits");
+            Check(timeline.GetWaits().empty(), "nothing was waited for");
+        });
+
+        suite.Run("TimelineRingAllocator/FenceGatedReuse", [] {
+            // The GPU completes frames at random, and every allocation is checked against the
+            // memory of the frames not completed yet.
+            constexpr UInt64 Capacity = 8192;
+
+            std::mt19937 random(2);
+            ManualGpuTimeline timeline;
+            TimelineRingAllocator allocator(timeline, Capacity);
+            std::vector<LiveAllocation> live;
+
+            for (UInt32 frame = 0; frame < 2000; ++frame) {
+                const UInt32 allocationCount = 1 + random() % 6;
+                for (UInt32 i = 0; i < allocationCount; ++i) {
+                    const UInt64 size = 16 + random() % 400;
+                    const UInt64 offset = allocator.Allocate(size, 16);
+
+                    const UInt64 completedValue = timeline.GetCompletedValue();
+                    std::erase_if(live, [completedValue](const LiveAllocation& allocation) {
+                        return allocation.FenceValue <= completedValue;
+                    });
+                    for (const LiveAllocation& allocation : live) {
+                        Check(!Overlaps(allocation, offset, size), "memory is only reused once its frame completed");
+                    }
+                    live.push_back({offset, size, timeline.GetLastSignaledValue() + 1});
+                }
+
+                const UInt64 value = timeline.Signal();
+                if (random() % 4 != 0 && value > 2) {
+                    timeline.CompleteUpTo(value - 1 - random() % 2);
+                }
+            }
+
+            Check(allocator.GetWaitCount() == timeline.GetWaits().size(), "every wait goes through the timeline");
+            Check(allocator.GetWaitCount() != 0, "a lagging GPU makes the ring wait");
+        });
+
+        suite.Run("UploadRing/Addresses", [] {
+            std::vector<std::byte> memory(1024);
+            ManualGpuTimeline timeline;
+            UploadRing ring(timeline, memory.data(), 0x10000, memory.size());
+
+            const UInt32 data[4] = {1, 2, 3, 4};
+            ring.Allocate(3, 1);
+            const UploadAllocation allocation = ring.Upload(data, sizeof(data), 64);
+            Check(allocation.Offset == 64 && allocation.Size == sizeof(data), "uploads are aligned");
+            Check(allocation.CpuAddress == memory.data() + 64 && allocation.GpuAddress == 0x10000 + 64,
+                  "the addresses follow the offset");
+            Check(std::memcmp(allocation.CpuAddress, data, sizeof(data)) == 0, "the data is copied");
+            Check(ring.AllocateConstants(1).Offset % Alignment::ConstantBuffer == 0,
+                  "constants are aligned for constant buffer views");
+        });
+    }
+}
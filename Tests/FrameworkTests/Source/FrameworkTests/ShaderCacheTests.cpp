@@ -0,0 +1,130 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/ShaderCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // Layout of the version 1 files, written by hand to corrupt them.
+        struct FileHeader {
+            UInt32 Magic;
+            UInt32 Version;
+            UInt32 BucketCount;
+            UInt32 EntryCount;
+            UInt64 DataSize;
+            UInt64 DataCapacity;
+        };
+
+        struct FileBucket {
+            UInt64 Key;
+            UInt64 Offset;
+            UInt64 Size;
+        };
+
+        std::filesystem::path GetCachePath(const char* name) {
+            std::filesystem::path path = GetScratchDirectory() / name;
+            std::filesystem::remove(path);
+
+            return path;
+        }
+
+        std::vector<std::byte> MakeBytecode(const UInt32 seed, const size_t size) {
+            std::vector<std::byte> bytecode(size);
+            for (size_t i = 0; i < size; ++i) {
+                bytecode[i] = static_cast<std::byte>(seed * 31 + i);
+            }
+
+            return bytecode;
+        }
+
+        bool Holds(const ShaderCache& cache, const UInt64 key, const std::vector<std::byte>& bytecode) {
+            const std::span<const std::byte> found = cache.Find(key);
+            return std::ranges::equal(found, bytecode);
+        }
+
+        void WriteFile(const std::filesystem::path& path, const std::vector<std::byte>& contents) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+        }
+    }
+
+    void RunShaderCacheTests(TestSuite& suite) {
+        suite.Run("ShaderCache/PersistsAcrossReopen", [] {
+            const std::filesystem::path path = GetCachePath("PersistsAcrossReopen.bin");
+            const std::vector<std::byte> vertexShader = MakeBytecode(1, 100);
+            const std::vector<std::byte> pixelShader = MakeBytecode(2, 37);
+
+            {
+                ShaderCache cache(path, 4);
+                cache.Insert(0, vertexShader);
+                cache.Insert(42, pixelShader);
+                Check(cache.GetEntryCount() == 2, "both blobs are stored");
+                Check(cache.Find(7).empty(), "a missing key is not found");
+            }
+
+            ShaderCache cache(path, 4);
+            Check(cache.GetEntryCount() == 2, "the entries survive a reopen");
+            Check(Holds(cache, 0, vertexShader) && Holds(cache, 42, pixelShader), "the blobs survive a reopen");
+
+            cache.Insert(42, vertexShader);
+            Check(cache.GetEntryCount() == 2 && Holds(cache, 42, vertexShader), "an insertion replaces the blob");
+        });
+
+        suite.Run("ShaderCache/Rehash", [] {
+            ShaderCache cache(GetCachePath("Rehash.bin"), 4);
+            std::vector<std::vector<std::byte>> blobs;
+            for (UInt32 i = 0; i < 200; ++i) {
+                blobs.push_back(MakeBytecode(i, 1 + i % 50));
+                cache.Insert(0x9E3779B97F4A7C15ull * i, blobs.back());
+                Check(cache.GetEntryCount() * 2 <= cache.GetBucketCount(), "the table stays at most half full");
+            }
+
+            for (UInt32 i = 0; i < 200; ++i) {
+                Check(Holds(cache, 0x9E3779B97F4A7C15ull * i, blobs[i]), "every blob is found after the rehashes");
+            }
+            Check(cache.Find(1).empty(), "a missing key is not found");
+        });
+
+        suite.Run("ShaderCache/RejectsFullTable", [] {
+            // A file whose buckets are all occupied is consistent, but a lookup of a missing
+            // key would never meet an empty bucket: the file must be discarded.
+            constexpr UInt32 BucketCount = 8;
+
+            const std::filesystem::path path = GetCachePath("RejectsFullTable.bin");
+            std::vector<std::byte> contents(sizeof(FileHeader) + BucketCount * sizeof(FileBucket));
+            const FileHeader header = {0x48535444, 1, BucketCount, BucketCount, 0, 0};
+            std::memcpy(contents.data(), &header, sizeof(header));
+            for (UInt32 i = 0; i < BucketCount; ++i) {
+                const FileBucket bucket = {i + 1, 0, 0};
+                std::memcpy(contents.data() + sizeof(FileHeader) + i * sizeof(FileBucket), &bucket, sizeof(bucket));
+            }
+            WriteFile(path, contents);
+
+            ShaderCache cache(path, 4);
+            Check(cache.GetEntryCount() == 0 && cache.GetBucketCount() == 4, "the file is rebuilt");
+            Check(cache.Find(100).empty(), "a lookup of a missing key ends");
+        });
+
+        suite.Run("ShaderCache/RejectsTruncatedFile", [] {
+            const std::filesystem::path path = GetCachePath("RejectsTruncatedFile.bin");
+            {
+                ShaderCache cache(path, 4);
+                cache.Insert(1, MakeBytecode(1, 1000));
+            }
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 500);
+
+            ShaderCache cache(path, 4);
+            Check(cache.GetEntryCount() == 0 && cache.Find(1).empty(), "a truncated file is discarded");
+        });
+    }
+}
@@ -0,0 +1,165 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/SubresourceCopy.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        struct ExpectedFootprint {
+            UInt64 Offset;
+            UInt32 Width;
+            UInt32 Height;
+            UInt32 Depth;
+            UInt32 RowPitch;
+            UInt32 RowCount;
+            UInt64 RowSize;
+        };
+
+        struct FootprintCase {
+            const char* Name;
+            TextureCopyDesc Desc;
+            UInt32 FirstSubresource;
+            UInt64 BaseOffset;
+            std::vector<ExpectedFootprint> Footprints;
+            UInt64 TotalSize;
+        };
+
+        // What ID3D12Device::GetCopyableFootprints returns: rows padded to 256 bytes,
+        // subresources placed on 512 bytes, sizes rounded up to whole blocks, and no padding
+        // counted after the last row.
+        const std::vector<FootprintCase>& GetReferenceFootprints() {
+            static const std::vector<FootprintCase> cases = {
+                {"RGBA8 256x256", {DxgiFormat::R8G8B8A8Unorm, TextureDimension::Texture2D, 256, 256, 1, 1}, 0, 0,
+                 {{0, 256, 256, 1, 1024, 256, 1024}}, 262144},
+                {"RGBA8 100x100", {DxgiFormat::R8G8B8A8Unorm, TextureDimension::Texture2D, 100, 100, 1, 1}, 0, 0,
+                 {{0, 100, 100, 1, 512, 100, 400}}, 51088},
+                {"RGB32F 3x2", {DxgiFormat::R32G32B32Float, TextureDimension::Texture2D, 3, 2, 1, 1}, 0, 0,
+                 {{0, 3, 2, 1, 256, 2, 36}}, 292},
+                {"BC1 8x8 mips, placed", {DxgiFormat::BC1Unorm, TextureDimension::Texture2D, 8, 8, 1, 4}, 0, 512,
+                 {{512, 8, 8, 1, 256, 2, 16},
+                  {1024, 4, 4, 1, 256, 1, 8},
+                  {1536, 4, 4, 1, 256, 1, 8},
+                  {2048, 4, 4, 1, 256, 1, 8}},
+                 1544},
+                {"BC7 5x3", {DxgiFormat::BC7Unorm, TextureDimension::Texture2D, 5, 3, 1, 1}, 0, 0,
+                 {{0, 8, 4, 1, 256, 1, 32}}, 32},
+                {"YUY2 7x3", {DxgiFormat::YUY2, TextureDimension::Texture2D, 7, 3, 1, 1}, 0, 0,
+                 {{0, 8, 3, 1, 256, 3, 16}}, 528},
+                {"RGBA8 4x4x4 mips", {DxgiFormat::R8G8B8A8Unorm, TextureDimension::Texture3D, 4, 4, 4, 2}, 0, 0,
+                 {{0, 4, 4, 4, 256, 4, 16}, {4096, 2, 2, 2, 256, 2, 8}}, 4872},
+                {"R32F array, second slice", {DxgiFormat::R32Float, TextureDimension::Texture2D, 64, 2, 2, 2}, 2, 0,
+                 {{0, 64, 2, 1, 256, 2, 256}, {512, 32, 1, 1, 256, 1, 128}}, 640},
+                {"R16F 1D array", {DxgiFormat::R16Float, TextureDimension::Texture1D, 300, 1, 3, 1}, 0, 0,
+                 {{0, 300, 1, 1, 768, 1, 600}, {1024, 300, 1, 1, 768, 1, 600}, {2048, 300, 1, 1, 768, 1, 600}},
+                 2648},
+            };
+
+            return cases;
+        }
+
+        std::vector<std::byte> MakeSource(const size_t size) {
+            std::vector<std::byte> data(size);
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = static_cast<std::byte>(i * 7 + 3);
+            }
+
+            return data;
+        }
+    }
+
+    void RunSubresourceCopyTests(TestSuite& suite) {
+        suite.Run("SubresourceCopy/ReferenceFootprints", [] {
+            for (const FootprintCase& reference : GetReferenceFootprints()) {
+                std::vector<SubresourceFootprint> footprints(reference.Footprints.size());
+                const UInt64 totalSize =
+                    ComputeCopyableFootprints(reference.Desc, reference.FirstSubresource, reference.BaseOffset,
+                                              footprints);
+
+                const std::string name = reference.Name;
+                Check(totalSize == reference.TotalSize, name + ": total size");
+                for (size_t i = 0; i < footprints.size(); ++i) {
+                    const SubresourceFootprint& footprint = footprints[i];
+                    const ExpectedFootprint& expected = reference.Footprints[i];
+                    Check(footprint.Offset == expected.Offset && footprint.Format == reference.Desc.Format,
+                          name + ": offset");
+                    Check(footprint.Width == expected.Width && footprint.Height == expected.Height &&
+                          footprint.Depth == expected.Depth, name + ": size");
+                    Check(footprint.RowPitch == expected.RowPitch && footprint.RowCount == expected.RowCount &&
+                          footprint.RowSize == expected.RowSize, name + ": rows");
+                }
+            }
+        });
+
+        suite.Run("SubresourceCopy/InvalidFootprints", [] {
+            SubresourceFootprint footprint;
+            const TextureCopyDesc desc = {DxgiFormat::R8G8B8A8Unorm, TextureDimension::Texture2D, 16, 16, 1, 2};
+            CheckThrows<std::invalid_argument>([&] { ComputeCopyableFootprints(desc, 2, 0, {&footprint, 1}); },
+                                               "subresources out of range are rejected");
+            CheckThrows<std::invalid_argument>([&] { ComputeCopyableFootprints(desc, 0, 256, {&footprint, 1}); },
+                                               "a misplaced base offset is rejected");
+
+            TextureCopyDesc unknown = desc;
+            unknown.Format = DxgiFormat::Unknown;
+            CheckThrows<std::invalid_argument>([&] { ComputeCopyableFootprints(unknown, 0, 0, {&footprint, 1}); },
+                                               "formats without a layout are rejected");
+        });
+
+        suite.Run("SubresourceCopy/PitchedCopy", [] {
+            // A loosely packed 3D source, copied at every SIMD level, with and without threads.
+            constexpr UInt32 Width = 37;
+            constexpr UInt32 Height = 19;
+            constexpr UInt32 Depth = 5;
+            constexpr UInt64 SourceRowPitch = Width * 4 + 3;
+            constexpr UInt64 SourceSlicePitch = SourceRowPitch * Height + 5;
+
+            const TextureCopyDesc desc = {DxgiFormat::R8G8B8A8Unorm, TextureDimension::Texture3D, Width, Height,
+                                          Depth, 1};
+            SubresourceFootprint footprint;
+            const UInt64 totalSize = ComputeCopyableFootprints(desc, 0, 512, {&footprint, 1});
+            const std::vector<std::byte> source = MakeSource(SourceSlicePitch * Depth + 1);
+
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                for (const UInt32 threadCount : {1u, 3u}) {
+                    std::vector<std::byte> destination(512 + totalSize + 64, std::byte{0xCD});
+                    CopySubresource(destination.data(), footprint, {source.data() + 1, SourceRowPitch, SourceSlicePitch},
+                                    {level, threadCount, 1});
+
+                    for (UInt32 z = 0; z < Depth; ++z) {
+                        for (UInt32 y = 0; y < Height; ++y) {
+                            const std::byte* pRow = destination.data() + footprint.Offset +
+                                                    (z * footprint.RowCount + y) * UInt64(footprint.RowPitch);
+                            const std::byte* pSourceRow = source.data() + 1 + z * SourceSlicePitch + y * SourceRowPitch;
+                            Check(std::memcmp(pRow, pSourceRow, footprint.RowSize) == 0, "every row is copied");
+                        }
+                    }
+                    Check(destination[511] == std::byte{0xCD} && destination[512 + totalSize] == std::byte{0xCD},
+                          "nothing is written outside the footprint");
+                }
+            }
+        });
+
+        suite.Run("SubresourceCopy/StreamCopy", [] {
+            // Odd sizes and a misaligned destination exercise the unaligned head and tail.
+            const std::vector<std::byte> source = MakeSource(100003);
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                for (const UInt32 threadCount : {1u, 4u}) {
+                    std::vector<std::byte> destination(source.size() + 6);
+                    StreamCopy(destination.data() + 5, source.data(), source.size(), {level, threadCount, 1000});
+                    Check(std::memcmp(destination.data() + 5, source.data(), source.size()) == 0, "the bytes are copied");
+                    Check(destination[4] == std::byte{0} && destination.back() == std::byte{0},
+                          "nothing is written outside the destination");
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/TestSuite.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    TestSuite::TestSuite(TestOptions options) :
+        m_Options(std::move(options)),
+        m_RunCount(0),
+        m_FailureCount(0) {
+    }
+
+    bool TestSuite::IsEnabled(const std::string_view name) const {
+        if (m_Options.Filters.empty()) {
+            return true;
+        }
+
+        return std::any_of(m_Options.Filters.begin(), m_Options.Filters.end(), [name](const std::string& filter) {
+            return name.starts_with(filter) || std::string_view(filter).starts_with(name);
+        });
+    }
+
+    void TestSuite::Run(std::string name, const TestBody& body) {
+        const bool selected = m_Options.Filters.empty() ||
+            std::any_of(m_Options.Filters.begin(), m_Options.Filters.end(), [&name](const std::string& filter) {
+                return name.starts_with(filter);
+            });
+        if (!selected) {
+            return;
+        }
+
+        ++m_RunCount;
+
+        std::string failure;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            body();
+        } catch (const TestFailure& e) {
+            failure = e.what();
+        } catch (const std::exception& e) {
+            failure = std::string("unexpected exception: ") + e.what();
+        } catch (...) {
+            failure = "unexpected exception";
+        }
+        const Float64 milliseconds =
+            std::chrono::duration<Float64, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        char text[32];
+        std::snprintf(text, sizeof(text), " (%.1f ms)", milliseconds);
+        if (failure.empty()) {
+            std::cout << "[  OK  ] " << name << text << std::endl;
+        } else {
+            ++m_FailureCount;
+            std::cout << "[ FAIL ] " << name << text << "\n         " << failure << std::endl;
+        }
+    }
+
+    void Check(const bool condition, const std::string_view description, const std::source_location location) {
+        if (condition) {
+            return;
+        }
+
+        std::string message = location.file_name();
+        message += ':';
+        message += std::to_string(location.line());
+        message += ": ";
+        message += description;
+        throw TestFailure(message);
+    }
+
+    std::filesystem::path GetScratchDirectory() {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "FrameworkTests";
+        std::filesystem::create_directories(directory);
+
+        return directory;
+    }
+}
@@ -0,0 +1,221 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include "Framework/VertexCompression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace FrameworkTests {
+    using namespace D3D12Tests;
+
+    namespace {
+        // An odd count, so that every SIMD level runs its tail.
+        constexpr UInt32 VertexCount = 100003;
+
+        std::vector<Float32> MakeValues(const UInt64 count, const Float32 scale, const Float32 bias, const UInt32 seed) {
+            std::mt19937 random(seed);
+            std::uniform_real_distribution<Float32> distribution(-1.0f, 1.0f);
+            std::vector<Float32> values(count);
+            for (Float32& value : values) {
+                value = distribution(random) * scale + bias;
+            }
+
+            return values;
+        }
+
+        std::span<const std::byte> AsBytes(const std::vector<Float32>& values) {
+            return std::as_bytes(std::span(values));
+        }
+
+        // In double, and through atan2 rather than acos, which loses precision near zero.
+        Float64 GetAngleDegrees(const Float32* pA, const Float32* pB) {
+            const Float64 cross[3] = {Float64(pA[1]) * pB[2] - Float64(pA[2]) * pB[1],
+                                      Float64(pA[2]) * pB[0] - Float64(pA[0]) * pB[2],
+                                      Float64(pA[0]) * pB[1] - Float64(pA[1]) * pB[0]};
+            const Float64 dot = Float64(pA[0]) * pB[0] + Float64(pA[1]) * pB[1] + Float64(pA[2]) * pB[2];
+
+            return std::atan2(std::hypot(cross[0], cross[1], cross[2]), dot) * 180.0 / std::numbers::pi;
+        }
+
+        // Half the distance between the two halves around the value.
+        Float64 GetHalfUlp(const Float32 value) {
+            return std::ldexp(1.0, std::max(std::ilogb(value), -14) - 11);
+        }
+
+        // The five encodings of the same vertices, at one SIMD level.
+        struct EncodedStreams {
+            std::vector<std::byte> Positions;
+            std::vector<std::byte> Normals;
+            std::vector<std::byte> Tangents;
+            std::vector<std::byte> TexCoords;
+            std::vector<std::byte> Colors;
+
+            bool operator==(const EncodedStreams&) const = default;
+        };
+
+        struct SourceStreams {
+            std::vector<Float32> Positions = MakeValues(VertexCount * 3, 100.0f, 3.0f, 1);
+            std::vector<Float32> Normals = MakeValues(VertexCount * 3, 1.0f, 0.0f, 2);
+            std::vector<Float32> Tangents = MakeValues(VertexCount * 4, 1.0f, 0.0f, 3);
+            std::vector<Float32> TexCoords = MakeValues(VertexCount * 2, 4.0f, 0.0f, 4);
+            std::vector<Float32> Colors = MakeValues(VertexCount * 4, 0.6f, 0.5f, 5);
+            PositionQuantization Quantization;
+
+            SourceStreams() {
+                Float32 boundsMin[3] = {std::numeric_limits<Float32>::max(), std::numeric_limits<Float32>::max(),
+                                        std::numeric_limits<Float32>::max()};
+                Float32 boundsMax[3] = {std::numeric_limits<Float32>::lowest(), std::numeric_limits<Float32>::lowest(),
+                                        std::numeric_limits<Float32>::lowest()};
+                for (UInt32 i = 0; i < VertexCount * 3; ++i) {
+                    boundsMin[i % 3] = std::min(boundsMin[i % 3], Positions[i]);
+                    boundsMax[i % 3] = std::max(boundsMax[i % 3], Positions[i]);
+                }
+                Quantization = GetPositionQuantization(boundsMin, boundsMax);
+            }
+
+            EncodedStreams Encode(const VertexCompressionOptions& options) const {
+                EncodedStreams encoded;
+                encoded.Positions.resize(VertexCount * QuantizedPositionSize);
+                encoded.Normals.resize(VertexCount * OctahedralNormalSize);
+                encoded.Tangents.resize(VertexCount * OctahedralTangentSize);
+                encoded.TexCoords.resize(VertexCount * HalfTexCoordSize);
+                encoded.Colors.resize(VertexCount * UnormColorSize);
+                EncodeQuantizedPositions(encoded.Positions, AsBytes(Positions), 12, VertexCount, Quantization, options);
+                EncodeOctahedralNormals(encoded.Normals, AsBytes(Normals), 12, VertexCount, options);
+                EncodeOctahedralTangents(encoded.Tangents, AsBytes(Tangents), 16, VertexCount, options);
+                EncodeHalfTexCoords(encoded.TexCoords, AsBytes(TexCoords), 8, VertexCount, options);
+                EncodeUnormColors(encoded.Colors, AsBytes(Colors), 16, VertexCount, options);
+
+                return encoded;
+            }
+        };
+    }
+
+    void RunVertexCompressionTests(TestSuite& suite) {
+        suite.Run("VertexCompression/ErrorBounds", [] {
+            const SourceStreams source;
+            const EncodedStreams encoded = source.Encode({SimdLevel::Scalar, 1});
+
+            // Half a step of the box, plus the float rounding of the encoder and of
+            // Offset + encoded * Extent, a few ulps of the box corners.
+            Float64 maxPositionExcess = 0.0;
+            for (UInt32 i = 0; i < VertexCount; ++i) {
+                Float32 position[3];
+                DecodeQuantizedPosition(encoded.Positions.data() + i * QuantizedPositionSize, source.Quantization, position);
+                for (UInt32 axis = 0; axis < 3; ++axis) {
+                    const Float64 error = std::abs(Float64(position[axis]) - source.Positions[i * 3 + axis]);
+                    const Float64 bound = source.Quantization.Extent[axis] / 131070.0 + 4.0 * std::numeric_limits<Float32>::epsilon() *
+                        (std::abs(source.Quantization.Offset[axis]) + source.Quantization.Extent[axis]);
+                    maxPositionExcess = std::max(maxPositionExcess, error - bound);
+                }
+            }
+            Check(maxPositionExcess <= 0.0, "positions are within half a step");
+
+            Float64 maxNormalAngle = 0.0;
+            Float64 maxTangentAngle = 0.0;
+            UInt32 handednessMismatchCount = 0;
+            Float64 maxTexCoordExcess = 0.0;
+            Float64 maxColorError = 0.0;
+            for (UInt32 i = 0; i < VertexCount; ++i) {
+                Float32 normal[3];
+                DecodeOctahedralNormal(encoded.Normals.data() + i * OctahedralNormalSize, normal);
+                maxNormalAngle = std::max(maxNormalAngle, GetAngleDegrees(normal, &source.Normals[i * 3]));
+
+                Float32 tangent[4];
+                DecodeOctahedralTangent(encoded.Tangents.data() + i * OctahedralTangentSize, tangent);
+                maxTangentAngle = std::max(maxTangentAngle, GetAngleDegrees(tangent, &source.Tangents[i * 4]));
+                handednessMismatchCount += (tangent[3] < 0.0f) != (source.Tangents[i * 4 + 3] < 0.0f);
+
+                Float32 texCoord[2];
+                DecodeHalfTexCoord(encoded.TexCoords.data() + i * HalfTexCoordSize, texCoord);
+                for (UInt32 component = 0; component < 2; ++component) {
+                    const Float32 value = source.TexCoords[i * 2 + component];
+                    maxTexCoordExcess = std::max(maxTexCoordExcess,
+                                                 std::abs(Float64(texCoord[component]) - value) - GetHalfUlp(value));
+                }
+
+                Float32 color[4];
+                DecodeUnormColor(encoded.Colors.data() + i * UnormColorSize, color);
+                for (UInt32 channel = 0; channel < 4; ++channel) {
+                    const Float32 expected = std::clamp(source.Colors[i * 4 + channel], 0.0f, 1.0f);
+                    maxColorError = std::max(maxColorError, std::abs(Float64(color[channel]) - expected));
+                }
+            }
+            Check(maxNormalAngle < 0.04, "normals are within 0.04 degrees");
+            Check(maxTangentAngle < 1.0 && handednessMismatchCount == 0,
+                  "tangents are within 1 degree and keep their handedness");
+            Check(maxTexCoordExcess <= 0.0, "texture coordinates are within half an ulp of a half");
+            Check(maxColorError <= 1.0 / 510.0 + 1e-7, "colors are within half a step");
+        });
+
+        suite.Run("VertexCompression/SimdLevelsMatch", [] {
+            // Every level lowered to what the CPU supports, threaded or not, gives the bits of
+            // the scalar encoder.
+            const SourceStreams source;
+            const EncodedStreams scalar = source.Encode({SimdLevel::Scalar, 1});
+            for (const SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+                for (const UInt32 threadCount : {1u, 3u}) {
+                    Check(source.Encode({level, threadCount, 1000}) == scalar,
+                          std::string(GetSimdLevelName(level)) + " encodes the scalar bits");
+                }
+            }
+        });
+
+        suite.Run("VertexCompression/SpecialValues", [] {
+            // Zero and -Z normals, then NaN, overflowing, subnormal and infinite coordinates.
+            const std::vector<Float32> normals = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, -0.0f, 0.0f, -1.0f};
+            const std::vector<Float32> texCoords = {std::numeric_limits<Float32>::quiet_NaN(), 1e6f, 1e-6f, -3e-8f,
+                                                    65504.0f, 65520.0f, -std::numeric_limits<Float32>::infinity(), 0.5f};
+            for (const SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+                std::vector<std::byte> encodedNormals(3 * OctahedralNormalSize);
+                EncodeOctahedralNormals(encodedNormals, AsBytes(normals), 12, 3, {level, 1});
+                Float32 normal[3];
+                DecodeOctahedralNormal(encodedNormals.data(), normal);
+                Check(normal[0] == 0.0f && normal[1] == 0.0f && normal[2] == 1.0f, "a zero normal is encoded as +Z");
+                for (UInt32 i = 1; i < 3; ++i) {
+                    DecodeOctahedralNormal(encodedNormals.data() + i * OctahedralNormalSize, normal);
+                    Check(std::abs(normal[2] + 1.0f) < 1e-6f, "-Z survives the fold");
+                }
+
+                std::vector<std::byte> encodedTexCoords(4 * HalfTexCoordSize);
+                EncodeHalfTexCoords(encodedTexCoords, AsBytes(texCoords), 8, 4, {level, 1});
+                Float32 decoded[4][2];
+                for (UInt32 i = 0; i < 4; ++i) {
+                    DecodeHalfTexCoord(encodedTexCoords.data() + i * HalfTexCoordSize, decoded[i]);
+                }
+                Check(std::isnan(decoded[0][0]) && std::isinf(decoded[0][1]) && decoded[0][1] > 0.0f,
+                      "NaN stays NaN and large values overflow to infinity");
+                Check(std::abs(decoded[1][0] - 1e-6f) <= std::ldexp(1.0f, -25) && decoded[1][1] == -std::ldexp(1.0f, -24),
+                      "small values round to the nearest subnormal");
+                Check(decoded[2][0] == 65504.0f && std::isinf(decoded[2][1]), "the largest half is kept, the next one overflows");
+                Check(decoded[3][0] == -std::numeric_limits<Float32>::infinity() && decoded[3][1] == 0.5f,
+                      "infinities and exact values are kept");
+            }
+        });
+
+        suite.Run("VertexCompression/InvalidArguments", [] {
+            const std::vector<Float32> texCoords(20, 0.5f);
+            std::vector<std::byte> destination(10 * HalfTexCoordSize);
+            CheckThrows<std::invalid_argument>([&] { EncodeHalfTexCoords({destination.data(), 9 * HalfTexCoordSize},
+                                                                         AsBytes(texCoords), 8, 10); },
+                                               "a small destination is rejected");
+            CheckThrows<std::invalid_argument>([&] { EncodeHalfTexCoords(destination, AsBytes(texCoords), 8, 11); },
+                                               "a small source is rejected");
+            CheckThrows<std::invalid_argument>([&] { EncodeHalfTexCoords(destination, AsBytes(texCoords), 4, 5); },
+                                               "a stride smaller than a vertex is rejected");
+            CheckThrows<std::invalid_argument>([&] {
+                EncodeHalfTexCoords(destination, AsBytes(texCoords), MaxSourceStride + 4, 1);
+            }, "a stride past the D3D12 limit is rejected");
+        });
+    }
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "FrameworkTests/Tests.hpp"
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+    constexpr const char* Usage =
+        "Usage: FrameworkTests [options]\n"
+        "  --filter <prefix>  Only run the tests whose name starts with the prefix, can be repeated.\n";
+}
+
+int main(int argc, char* argv[]) {
+    FrameworkTests::TestOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* argument = argv[i];
+        if (std::strcmp(argument, "--help") == 0 || std::strcmp(argument, "-h") == 0) {
+            std::cout << Usage;
+            return 0;
+        }
+
+        if (std::strcmp(argument, "--filter") == 0 && i + 1 < argc) {
+            options.Filters.emplace_back(argv[++i]);
+        } else {
+            std::cerr << "Unknown option or missing value: " << argument << '\n' << Usage;
+            return 2;
+        }
+    }
+
+    FrameworkTests::TestSuite suite(options);
+    FrameworkTests::RunFrameRingTests(suite);
+    FrameworkTests::RunRingAllocatorTests(suite);
+    FrameworkTests::RunRangeAllocatorTests(suite);
+    FrameworkTests::RunDescriptorRingTests(suite);
+    FrameworkTests::RunCommandContextPoolTests(suite);
+    FrameworkTests::RunResourceStateTests(suite);
+    FrameworkTests::RunShaderCacheTests(suite);
+    FrameworkTests::RunMappedFileTests(suite);
+    FrameworkTests::RunPipelineRegistryTests(suite);
+    FrameworkTests::RunProceduralTextureTests(suite);
+    FrameworkTests::RunDdsFileTests(suite);
+    FrameworkTests::RunSubresourceCopyTests(suite);
+    FrameworkTests::RunJobSystemTests(suite);
+    FrameworkTests::RunProfilerTests(suite);
+    FrameworkTests::RunNullDeviceTests(suite);
+    FrameworkTests::RunFramePacingTests(suite);
+    FrameworkTests::RunMeshFileTests(suite);
+    FrameworkTests::RunMeshOptimizerTests(suite);
+    FrameworkTests::RunVertexCompressionTests(suite);
+    FrameworkTests::RunMeshletBuilderTests(suite);
+    FrameworkTests::RunCullingTests(suite);
+    FrameworkTests::RunDrawQueueTests(suite);
+    FrameworkTests::RunCommandRecorderTests(suite);
+    FrameworkTests::RunConstantBufferAllocatorTests(suite);
+    FrameworkTests::RunBindlessRegistryTests(suite);
+    FrameworkTests::RunRenderGraphTests(suite);
+
+    std::cout << '\n' << suite.GetRunCount() - suite.GetFailureCount() << " of " << suite.GetRunCount()
+        << " test(s) passed.\n";
+
+    return suite.GetFailureCount() == 0 ? 0 : 1;
+}
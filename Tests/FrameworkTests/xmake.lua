@@ -0,0 +1,15 @@
+target("FrameworkTests")
+  set_kind("binary")
+  
+  add_files("Source/**.cpp")
+  
+  for _, ext in ipairs({".hpp", ".inl"}) do
+    add_headerfiles("Include/**" .. ext)
+  end
+
+  add_includedirs("Include")
+  
+  add_deps("Framework")
+
+  -- Run with `xmake test`, or `xmake run FrameworkTests --filter <prefix>` for some of them.
+  add_tests("default")
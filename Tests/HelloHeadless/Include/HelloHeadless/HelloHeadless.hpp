@@ -0,0 +1,62 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+#ifndef D3D12TESTS_HELLOHEADLESS_HELLOHEADLESS_HPP
+#define D3D12TESTS_HELLOHEADLESS_HELLOHEADLESS_HPP
+
+#include "Framework/ApplicationBase.hpp"
+#include "Framework/FrameRing.hpp"
+#include "Framework/NullDevice.hpp"
+
+namespace HelloHeadless {
+    // HelloWindow's frame loop on the null device: clears the back buffer every frame,
+    // while the simulated GPU takes the given time per frame.
+    class HelloHeadless : public D3D12Tests::ApplicationBase {
+    public:
+        explicit HelloHeadless(D3D12Tests::SimulatedGpuTimeline::Clock::duration gpuFrameTime);
+        ~HelloHeadless() override = default;
+
+        HelloHeadless(const HelloHeadless&) = delete;
+        HelloHeadless(HelloHeadless&&) = delete;
+
+        HelloHeadless& operator=(const HelloHeadless&) = delete;
+        HelloHeadless& operator=(HelloHeadless&&) = delete;
+
+        void OnInit() override;
+        void OnUpdate() override;
+        void OnRender() override;
+        void OnDestroy() override;
+
+        inline const D3D12Tests::NullDevice& GetDevice() const;
+        inline D3D12Tests::UInt64 GetFrameWaitCount() const;
+
+    private:
+        static constexpr D3D12Tests::UInt32 FrameCount = 2;
+
+        // Resources that can only be reused once the GPU is done with the frame that used them.
+        struct FrameResources {
+            std::unique_ptr<D3D12Tests::NullCommandAllocator> CommandAllocator;
+        };
+
+        D3D12Tests::SimulatedGpuTimeline::Clock::duration m_GpuFrameTime;
+
+        // Pipeline objects.
+        D3D12Tests::NullDevice m_Device;
+        std::unique_ptr<D3D12Tests::NullCommandQueue> m_CommandQueue;
+        std::unique_ptr<D3D12Tests::NullSwapChain> m_SwapChain;
+        std::unique_ptr<D3D12Tests::NullCommandList> m_CommandList;
+
+        // Synchronization objects.
+        D3D12Tests::UInt32 m_FrameIndex;
+        std::unique_ptr<D3D12Tests::FrameRing<FrameResources>> m_FrameRing;
+
+        void PopulateCommandList(const FrameResources& frame);
+    };
+}
+
+#include "HelloHeadless/HelloHeadless.inl"
+
+#endif // D3D12TESTS_HELLOHEADLESS_HELLOHEADLESS_HPP
@@ -0,0 +1,15 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#pragma once
+
+namespace HelloHeadless {
+    inline const D3D12Tests::NullDevice& HelloHeadless::GetDevice() const {
+        return m_Device;
+    }
+
+    inline D3D12Tests::UInt64 HelloHeadless::GetFrameWaitCount() const {
+        return m_FrameRing->GetWaitCount();
+    }
+}
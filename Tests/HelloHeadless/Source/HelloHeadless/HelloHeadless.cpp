@@ -0,0 +1,76 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "HelloHeadless/HelloHeadless.hpp"
+
+#include "Framework/Profiler.hpp"
+
+namespace HelloHeadless {
+    HelloHeadless::HelloHeadless(const D3D12Tests::SimulatedGpuTimeline::Clock::duration gpuFrameTime) :
+        m_GpuFrameTime(gpuFrameTime),
+        m_FrameIndex(0) {
+    }
+
+    void HelloHeadless::OnInit() {
+        D3D12TESTS_PROFILE_SCOPE("HelloHeadless::OnInit");
+
+        m_CommandQueue = m_Device.CreateCommandQueue(m_GpuFrameTime);
+        m_SwapChain = m_Device.CreateSwapChain(FrameCount);
+        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
+
+        // Create the frame ring, with a command allocator for each frame that can be in flight.
+        m_FrameRing = std::make_unique<D3D12Tests::FrameRing<FrameResources>>(m_CommandQueue->GetTimeline(), FrameCount);
+        for (D3D12Tests::UInt32 n = 0; n < FrameCount; n++) {
+            m_FrameRing->GetFrame(n).CommandAllocator = m_Device.CreateCommandAllocator();
+        }
+
+        // Command lists are created in the recording state, but there is nothing
+        // to record yet. The main loop expects it to be closed, so close it now.
+        m_CommandList = m_Device.CreateCommandList(*m_FrameRing->GetCurrentFrame().CommandAllocator);
+        m_CommandList->Close();
+    }
+
+    void HelloHeadless::OnUpdate() {
+    }
+
+    void HelloHeadless::OnRender() {
+        // Only blocks if the GPU is still using the frame context we are about to reuse.
+        const FrameResources& frame = m_FrameRing->BeginFrame();
+
+        // Record all the commands we need to render the scene into the command list.
+        PopulateCommandList(frame);
+
+        // Execute the command list.
+        D3D12Tests::NullCommandList* ppCommandLists[] = {m_CommandList.get()};
+        m_CommandQueue->ExecuteCommandLists(ppCommandLists);
+
+        // Present the frame.
+        m_SwapChain->Present(1);
+
+        // Signal the end of the frame and move on without waiting for the GPU.
+        m_FrameRing->EndFrame();
+        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
+    }
+
+    void HelloHeadless::OnDestroy() {
+        // Ensure that the GPU is no longer referencing resources that are about to be
+        // cleaned up by the destructor.
+        m_FrameRing->Flush();
+    }
+
+    void HelloHeadless::PopulateCommandList(const FrameResources& frame) {
+        D3D12TESTS_PROFILE_SCOPE("HelloHeadless::PopulateCommandList");
+
+        // The null allocator throws if the GPU may still be using it, like the debug layer.
+        frame.CommandAllocator->Reset();
+        m_CommandList->Reset(*frame.CommandAllocator);
+
+        // Back buffer to render target, clear, and back to present.
+        m_CommandList->ResourceBarrier(1);
+        m_CommandList->ClearRenderTargetView();
+        m_CommandList->ResourceBarrier(1);
+
+        m_CommandList->Close();
+    }
+}
@@ -0,0 +1,33 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "HelloHeadless/HelloHeadless.hpp"
+
+#include "Framework/HeadlessApplicationBase.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Usage: HelloHeadless [frame count] [simulated GPU time per frame, in microseconds] [frame rate]
+// Without a frame rate, frames are uncapped.
+int main(int argc, char* argv[]) {
+    const D3D12Tests::UInt64 frameCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+    const std::chrono::microseconds gpuFrameTime(argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 1000);
+
+    HelloHeadless::HelloHeadless test(gpuFrameTime);
+    if (argc > 3) {
+        D3D12Tests::FramePacingDesc pacing;
+        pacing.Mode = D3D12Tests::FramePacingMode::FixedRate;
+        pacing.TargetFrameRate = std::strtod(argv[3], nullptr);
+        test.SetFramePacing(pacing);
+    }
+    const D3D12Tests::FrameStatistics statistics = D3D12Tests::HeadlessApplicationBase::Run(&test, frameCount);
+
+    std::cout << D3D12Tests::FormatFrameStatistics(statistics) << '\n';
+    std::cout << "Frames waited for the GPU: " << test.GetFrameWaitCount() << '\n';
+    std::cout << test.GetDevice().FormatCallCounts();
+
+    return 0;
+}
@@ -8,6 +8,18 @@
 #define D3D12TESTS_HELLOTEXTURE_HELLOTEXTURE_HPP
 
 #include "Framework/Application.hpp"
+#include "Framework/D3D12BindlessHeap.hpp"
+#include "Framework/D3D12CommandContextPool.hpp"
+#include "Framework/D3D12DescriptorHeap.hpp"
+#include "Framework/D3D12GpuTimeline.hpp"
+#include "Framework/D3D12PipelineRegistry.hpp"
+#include "Framework/D3D12ResourceStateTable.hpp"
+#include "Framework/D3D12ResourceStateTracker.hpp"
+#include "Framework/D3D12SubresourceCopy.hpp"
+#include "Framework/D3D12UploadRing.hpp"
+#include "Framework/FrameRing.hpp"
+#include "Framework/JobSystem.hpp"
+#include "Framework/ProceduralTexture.hpp"
 
 #include "Framework/pch.hpp"
 
@@ -37,9 +49,17 @@ namespace HelloTexture {
 
     private:
         static constexpr UINT FrameCount = 2;
+        static constexpr UINT64 UploadRingSize = 4 * 1024 * 1024;
+        static constexpr UINT RtvHeapCapacity = 16;
+        static constexpr UINT SrvHeapCapacity = 256;
+        static constexpr UINT BindlessHeapCapacity = 4096;
         static constexpr UINT TextureWidth = 256;
         static constexpr UINT TextureHeight = 256;
-        static constexpr UINT TexturePixelSize = 4; // The number of bytes used to represent a pixel in the texture.
+
+        // Resources that can only be reused once the GPU is done with the frame that used them.
+        struct FrameResources {
+            ComPtr<ID3D12CommandAllocator> CommandAllocator;
+        };
 
         struct Vertex {
             DirectX::XMFLOAT3 Position;
@@ -52,31 +72,43 @@ namespace HelloTexture {
         ComPtr<IDXGISwapChain3> m_SwapChain;
         ComPtr<ID3D12Device> m_Device;
         ComPtr<ID3D12Resource> m_RenderTargets[FrameCount];
-        ComPtr<ID3D12CommandAllocator> m_CommandAllocator;
         ComPtr<ID3D12CommandQueue> m_CommandQueue;
         ComPtr<ID3D12RootSignature> m_RootSignature;
-        ComPtr<ID3D12DescriptorHeap> m_RtvHeap;
-        ComPtr<ID3D12DescriptorHeap> m_SrvHeap;
+        std::unique_ptr<D3D12Tests::D3D12DescriptorHeap> m_RtvHeap;
+        D3D12Tests::D3D12DescriptorRange m_RtvDescriptors;
+        std::unique_ptr<D3D12Tests::D3D12DescriptorHeap> m_SrvHeap;
+        std::unique_ptr<D3D12Tests::D3D12PipelineRegistry> m_PipelineRegistry;
         ComPtr<ID3D12PipelineState> m_PipelineState;
         ComPtr<ID3D12GraphicsCommandList> m_CommandList;
-        UINT m_RtvDescriptorSize;
 
         // App resources
         ComPtr<ID3D12Resource> m_VertexBuffer;
         D3D12_VERTEX_BUFFER_VIEW m_VertexBufferView;
         ComPtr<ID3D12Resource> m_Texture;
+        D3D12Tests::D3D12DescriptorRange m_TextureSrv;
+        D3D12Tests::BindlessHandle m_TextureHandle;
+
+        // Resource states, and the tracker of the main command list.
+        D3D12Tests::D3D12ResourceStateTable m_ResourceStates;
+        D3D12Tests::D3D12ResourceStateTracker m_StateTracker;
+        D3D12Tests::UInt32 m_RenderTargetIds[FrameCount];
+        D3D12Tests::UInt32 m_VertexBufferId;
+        D3D12Tests::UInt32 m_TextureId;
 
         // Synchronization objects.
         UINT m_FrameIndex;
-        HANDLE m_FenceEvent;
-        ComPtr<ID3D12Fence> m_Fence;
-        UINT64 m_FenceValue;
+        std::unique_ptr<D3D12Tests::D3D12GpuTimeline> m_Timeline;
+        std::unique_ptr<D3D12Tests::FrameRing<FrameResources>> m_FrameRing;
+        std::unique_ptr<D3D12Tests::D3D12CommandContextPool> m_CommandContextPool;
+        std::unique_ptr<D3D12Tests::D3D12UploadRing> m_UploadRing;
+        std::unique_ptr<D3D12Tests::D3D12BindlessHeap> m_BindlessHeap;
+        std::unique_ptr<D3D12Tests::JobSystem> m_JobSystem;
 
         void LoadPipeline();
         void LoadAssets();
-        static std::vector<UINT8> GenerateTextureData();
-        void PopulateCommandList();
-        void WaitForPreviousFrame();
+        static void GenerateTextureData(const D3D12Tests::TextureRegion& region);
+        void PopulateCommandList(const FrameResources& frame);
+        void ExecuteCommandList(ID3D12CommandList* pCommandList, const D3D12Tests::D3D12ResourceStateTracker& tracker);
     };
 }
 
@@ -4,9 +4,15 @@ struct PSInput
     float2 uv : TEXCOORD;
 };
 
-Texture2D g_texture : register(t0);
+// The textures of the bindless heap, indexed by the draw constants.
+Texture2D g_textures[] : register(t0, space1);
 SamplerState g_sampler : register(s0);
 
+cbuffer DrawConstants : register(b0)
+{
+    uint g_textureIndex;
+};
+
 PSInput VSMain(float4 position : POSITION, float4 uv : TEXCOORD)
 {
     PSInput result;
@@ -19,5 +25,5 @@ PSInput VSMain(float4 position : POSITION, float4 uv : TEXCOORD)
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return g_texture.Sample(g_sampler, input.uv);
+    return g_textures[g_textureIndex].Sample(g_sampler, input.uv);
 }
\ No newline at end of file
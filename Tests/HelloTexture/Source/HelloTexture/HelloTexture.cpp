@@ -9,7 +9,7 @@ namespace HelloTexture {
         D3D12Tests::Application(width, height, name),
         m_Viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
         m_ScissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)),
-        m_RtvDescriptorSize(0),
+        m_StateTracker(m_ResourceStates),
         m_FrameIndex(0) {
     }
 
@@ -22,26 +22,35 @@ namespace HelloTexture {
     }
 
     void HelloTexture::OnRender() {
+        // Only blocks if the GPU is still using the frame context we are about to reuse.
+        const FrameResources& frame = m_FrameRing->BeginFrame();
+
         // Record all the commands we need to render the scene into the command list.
-        PopulateCommandList();
+        PopulateCommandList(frame);
 
         // Execute the command list.
-        ID3D12CommandList* ppCommandLists[] = {m_CommandList.Get()};
-        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+        ExecuteCommandList(m_CommandList.Get(), m_StateTracker);
 
         // Present the frame.
         D3D12Tests::ThrowIfFailed(m_SwapChain->Present(1, 0));
 
-        WaitForPreviousFrame();
+        // Signal the end of the frame and move on without waiting for the GPU.
+        m_FrameRing->EndFrame();
+        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
     }
 
     void HelloTexture::OnDestroy() {
-        WaitForPreviousFrame();
+        // Ensure that the GPU is no longer referencing resources that are about to be
+        // cleaned up by the destructor.
+        m_FrameRing->Flush();
 
-        CloseHandle(m_FenceEvent);
+        // Keep the pipelines created during this run for the next one.
+        m_PipelineRegistry->SaveManifest(GetAssetFullPath(L"HelloTexture/PipelineManifest.bin"));
     }
 
     void HelloTexture::LoadPipeline() {
+        D3D12TESTS_PROFILE_SCOPE("HelloTexture::LoadPipeline");
+
         UINT dxgiFactoryFlags = 0;
 
 #ifdef D3D12TESTS_DEBUG
@@ -116,41 +125,48 @@ namespace HelloTexture {
 
         // Create descriptor heaps
         {
-            // Describe and create a render target view (RTV) descriptor heap.
-            D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-            rtvHeapDesc.NumDescriptors = FrameCount;
-            rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-            rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_RtvHeap)));
-
-            // Describe and create a shader resource view (SRV) heap for the texture.
-            D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-            srvHeapDesc.NumDescriptors = 1;
-            srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-            srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_SrvHeap)));
-
-            m_RtvDescriptorSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+            // Views are created in CPU-only heaps. Shader resource views (SRV) are copied to
+            // the bindless heap, where the shaders find them by index.
+            m_RtvHeap = std::make_unique<D3D12Tests::D3D12DescriptorHeap>(
+                m_Device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, RtvHeapCapacity);
+            m_SrvHeap = std::make_unique<D3D12Tests::D3D12DescriptorHeap>(
+                m_Device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, SrvHeapCapacity);
         }
 
         // Create frame resources
         {
-            CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart());
-
             // Create an RTV for each frame.
+            m_RtvDescriptors = m_RtvHeap->Allocate(FrameCount);
             for (UINT n = 0; n < FrameCount; n++) {
                 D3D12Tests::ThrowIfFailed(m_SwapChain->GetBuffer(n, IID_PPV_ARGS(&m_RenderTargets[n])));
-                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr, rtvHandle);
-                rtvHandle.Offset(1, m_RtvDescriptorSize);
+                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr,
+                                                 m_RtvHeap->GetCpuHandle(m_RtvDescriptors, n));
+                m_RenderTargetIds[n] = m_ResourceStates.Register(m_RenderTargets[n].Get(),
+                                                                 D3D12_RESOURCE_STATE_PRESENT);
             }
         }
 
-        D3D12Tests::ThrowIfFailed(
-            m_Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_CommandAllocator)));
+        m_JobSystem = std::make_unique<D3D12Tests::JobSystem>();
+
+        // Create the frame ring, with a command allocator for each frame that can be in flight.
+        m_Timeline = std::make_unique<D3D12Tests::D3D12GpuTimeline>(m_Device.Get(), m_CommandQueue.Get());
+        m_FrameRing = std::make_unique<D3D12Tests::FrameRing<FrameResources>>(*m_Timeline, FrameCount);
+        m_CommandContextPool = std::make_unique<D3D12Tests::D3D12CommandContextPool>(
+            m_Device.Get(), *m_Timeline, D3D12_COMMAND_LIST_TYPE_DIRECT);
+        m_UploadRing = std::make_unique<D3D12Tests::D3D12UploadRing>(m_Device.Get(), *m_Timeline, UploadRingSize);
+        m_BindlessHeap = std::make_unique<D3D12Tests::D3D12BindlessHeap>(m_Device.Get(), *m_Timeline,
+                                                                         BindlessHeapCapacity);
+
+        for (UINT n = 0; n < FrameCount; n++) {
+            D3D12Tests::ThrowIfFailed(m_Device->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_FrameRing->GetFrame(n).CommandAllocator)));
+        }
     }
 
     // Load the test's assets.
     void HelloTexture::LoadAssets() {
+        D3D12TESTS_PROFILE_SCOPE("HelloTexture::LoadAssets");
+
         // Create the root signature.
         {
             D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
@@ -163,11 +179,14 @@ namespace HelloTexture {
                 featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
             }
 
-            CD3DX12_DESCRIPTOR_RANGE1 ranges[1];
-            ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
+            // The whole bindless heap is a single table, the texture to sample is given by its
+            // index in a root constant.
+            CD3DX12_DESCRIPTOR_RANGE1 ranges[D3D12Tests::D3D12BindlessHeap::DescriptorRangeCount];
+            D3D12Tests::D3D12BindlessHeap::InitDescriptorRanges(ranges);
 
-            CD3DX12_ROOT_PARAMETER1 rootParameters[1];
-            rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
+            CD3DX12_ROOT_PARAMETER1 rootParameters[2];
+            rootParameters[0].InitAsDescriptorTable(_countof(ranges), ranges, D3D12_SHADER_VISIBILITY_PIXEL);
+            rootParameters[1].InitAsConstants(1, 0, 0, D3D12_SHADER_VISIBILITY_PIXEL);
 
             D3D12_STATIC_SAMPLER_DESC sampler = {};
             sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
@@ -196,25 +215,23 @@ namespace HelloTexture {
             D3D12Tests::ThrowIfFailed(m_Device->CreateRootSignature(0, signature->GetBufferPointer(),
                                                                     signature->GetBufferSize(),
                                                                     IID_PPV_ARGS(&m_RootSignature)));
+
+            // Pipelines refer to the root signature by the hash of its serialized blob.
+            m_PipelineRegistry = std::make_unique<D3D12Tests::D3D12PipelineRegistry>(m_Device.Get());
+            m_PipelineRegistry->LoadManifest(GetAssetFullPath(L"HelloTexture/PipelineManifest.bin"));
+            m_PipelineRegistry->RegisterRootSignature(m_RootSignature.Get(), signature->GetBufferPointer(),
+                                                      signature->GetBufferSize());
         }
 
         // Create the pipeline state, which includes compiling and loading shaders.
         {
-            ComPtr<ID3DBlob> vertexShader;
-            ComPtr<ID3DBlob> pixelShader;
-
-            UINT compilerFlags = 0;
-#ifdef D3D12TESTS_DEBUG
-            // Enable better shader debugging with the graphics debugging tools.
-            compilerFlags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-
-            D3D12Tests::ThrowIfFailed(D3DCompileFromFile(
-                GetAssetFullPath(L"HelloTexture/Resources/Shaders/shader.hlsl").c_str(), nullptr, nullptr, "VSMain",
-                "vs_5_0", compilerFlags, 0, &vertexShader, nullptr));
-            D3D12Tests::ThrowIfFailed(D3DCompileFromFile(
-                GetAssetFullPath(L"HelloTexture/Resources/Shaders/shader.hlsl").c_str(), nullptr, nullptr, "PSMain",
-                "ps_5_0", compilerFlags, 0, &pixelShader, nullptr));
+            // Compiled shaders are kept in a cache file, only the first launch (or one following
+            // a change of the shader sources) runs the compiler. The debug flags are part of the
+            // cache key.
+            const std::wstring shaderPath = GetAssetFullPath(L"HelloTexture/Resources/Shaders/shader.hlsl");
+            // Unbounded resource arrays need shader model 5.1.
+            const ComPtr<ID3DBlob> vertexShader = D3D12Tests::CompileShader(shaderPath, nullptr, "VSMain", "vs_5_1");
+            const ComPtr<ID3DBlob> pixelShader = D3D12Tests::CompileShader(shaderPath, nullptr, "PSMain", "ps_5_1");
 
             // Define the vertex input layout
             D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
@@ -237,14 +254,35 @@ namespace HelloTexture {
             psoDesc.NumRenderTargets = 1;
             psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
             psoDesc.SampleDesc.Count = 1;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_PipelineState)));
+
+            // Create the pipelines seen in the previous runs with these shaders up front; the
+            // registry then returns the existing pipeline for this description.
+            m_PipelineRegistry->RegisterShader(psoDesc.VS);
+            m_PipelineRegistry->RegisterShader(psoDesc.PS);
+            m_PipelineRegistry->Prewarm();
+            m_PipelineState = m_PipelineRegistry->GetOrCreate(psoDesc);
         }
 
         // Create the command list
         D3D12Tests::ThrowIfFailed(m_Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                                              m_CommandAllocator.Get(), nullptr,
+                                                              m_FrameRing->GetCurrentFrame().CommandAllocator.Get(),
+                                                              nullptr,
                                                               IID_PPV_ARGS(&m_CommandList)));
 
+        // Command lists are created in the recording state, but there is nothing
+        // to record yet. The main loop expects it to be closed, so close it now.
+        D3D12Tests::ThrowIfFailed(m_CommandList->Close());
+
+        // The initial uploads are recorded on a pooled context, the main command list is
+        // only used for rendering.
+        D3D12Tests::D3D12CommandContext uploadContext = m_CommandContextPool->Acquire();
+        ID3D12GraphicsCommandList* pUploadCommandList = uploadContext.CommandList.Get();
+        D3D12Tests::D3D12ResourceStateTracker uploadStates(m_ResourceStates);
+
+        // Asset preparation runs on the job system while the copies are being recorded, and
+        // must be done before the copies are executed.
+        D3D12Tests::JobCounter assetJobs;
+
         // Create the vertex buffer.
         {
             // Define the geometry for a triangle.
@@ -256,26 +294,27 @@ namespace HelloTexture {
 
             constexpr UINT vertexBufferSize = sizeof(triangleVertices);
 
-            // Note: using upload heaps to transfer static data like vert buffers is not 
-            // recommended. Every time the GPU needs it, the upload heap will be marshalled 
-            // over. Please read up on Default Heap usage. An upload heap is used here for 
-            // code simplicity and because there are very few verts to actually transfer.
-            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+            // The vertex buffer lives in a default heap, the data is staged through the
+            // upload ring and copied on the GPU.
+            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
             auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize);
             D3D12Tests::ThrowIfFailed(m_Device->CreateCommittedResource(
                 &heapProperties,
                 D3D12_HEAP_FLAG_NONE,
                 &bufferDesc,
-                D3D12_RESOURCE_STATE_GENERIC_READ,
+                D3D12_RESOURCE_STATE_COMMON,
                 nullptr,
                 IID_PPV_ARGS(&m_VertexBuffer)));
+            m_VertexBufferId = m_ResourceStates.Register(m_VertexBuffer.Get(), D3D12_RESOURCE_STATE_COMMON);
 
             // Copy the triangle data to the vertex buffer.
-            UINT8* pVertexDataBegin;
-            CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resources on the CPU.
-            D3D12Tests::ThrowIfFailed(m_VertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-            memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
-            m_VertexBuffer->Unmap(0, nullptr);
+            uploadStates.Transition(m_VertexBufferId, D3D12_RESOURCE_STATE_COPY_DEST);
+            uploadStates.FlushBarriers(pUploadCommandList);
+            const D3D12Tests::UploadAllocation upload = m_UploadRing->Upload(triangleVertices, vertexBufferSize);
+            pUploadCommandList->CopyBufferRegion(m_VertexBuffer.Get(), 0, m_UploadRing->GetResource(),
+                                                 upload.Offset, vertexBufferSize);
+
+            uploadStates.Transition(m_VertexBufferId, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
 
             // Initialize the vertex buffer view.
             m_VertexBufferView.BufferLocation = m_VertexBuffer->GetGPUVirtualAddress();
@@ -283,12 +322,6 @@ namespace HelloTexture {
             m_VertexBufferView.SizeInBytes = vertexBufferSize;
         }
 
-        // Note: ComPtr's are CPU objects but this resource needs to stay in scope until
-        // the command list that references it has finished executing on the GPU.
-        // We will flush the GPU at the end of this method to ensure the resource is not
-        // prematurely destroyed.
-        ComPtr<ID3D12Resource> textureUploadHeap;
-
         // Create the texture
         {
             // Describe and create a texture2D
@@ -312,34 +345,34 @@ namespace HelloTexture {
                 D3D12_RESOURCE_STATE_COPY_DEST,
                 nullptr,
                 IID_PPV_ARGS(&m_Texture)));
-
-            const UINT64 uploadBufferSize = GetRequiredIntermediateSize(m_Texture.Get(), 0, 1);
-
-            auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
-
-            heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-            // Create the GPU upload buffer.
-            D3D12Tests::ThrowIfFailed(m_Device->CreateCommittedResource(
-                &heapProperties,
-                D3D12_HEAP_FLAG_NONE,
-                &bufferDesc,
-                D3D12_RESOURCE_STATE_GENERIC_READ,
-                nullptr,
-                IID_PPV_ARGS(&textureUploadHeap)));
-
-            // Copy data to the intermediate upload heap and then schedule a copy
-            // from the upload heap to the Texture2D.
-            std::vector<UINT8> texture = GenerateTextureData();
-
-            D3D12_SUBRESOURCE_DATA textureData = {};
-            textureData.pData = &texture[0];
-            textureData.RowPitch = TextureWidth * TexturePixelSize;
-            textureData.SlicePitch = textureData.RowPitch * TextureHeight;
-
-            UpdateSubresources(m_CommandList.Get(), m_Texture.Get(), textureUploadHeap.Get(), 0, 0, 1, &textureData);
-            auto transition = CD3DX12_RESOURCE_BARRIER::Transition(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST,
-                                                                   D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-            m_CommandList->ResourceBarrier(1, &transition);
+            m_TextureId = m_ResourceStates.Register(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST);
+
+            // Staging memory comes from the upload ring, which stays alive (and mapped)
+            // until the copy has been executed. The footprint is computed without the device,
+            // placed at the offset of the allocation in the ring's buffer.
+            const D3D12Tests::TextureCopyDesc copyDesc = D3D12Tests::ToTextureCopyDesc(textureDesc);
+            D3D12Tests::SubresourceFootprint footprint;
+            const UINT64 uploadBufferSize = D3D12Tests::ComputeCopyableFootprints(copyDesc, 0, 0, {&footprint, 1});
+            const D3D12Tests::UploadAllocation upload = m_UploadRing->AllocateTexture(uploadBufferSize);
+            footprint.Offset = upload.Offset;
+
+            // Generate the texture straight into the intermediate upload heap, with the
+            // row pitch the copy expects, and meanwhile schedule a copy from the upload heap
+            // to the Texture2D.
+            D3D12Tests::TextureRegion region;
+            region.Data = upload.CpuAddress;
+            region.Width = TextureWidth;
+            region.Height = TextureHeight;
+            region.RowPitch = footprint.RowPitch;
+            m_JobSystem->Schedule([region] { GenerateTextureData(region); }, &assetJobs);
+
+            const CD3DX12_TEXTURE_COPY_LOCATION destination(m_Texture.Get(), 0);
+            const CD3DX12_TEXTURE_COPY_LOCATION source(m_UploadRing->GetResource(), D3D12Tests::ToD3D12Footprint(footprint));
+
+            uploadStates.Transition(m_TextureId, D3D12_RESOURCE_STATE_COPY_DEST);
+            uploadStates.FlushBarriers(pUploadCommandList);
+            pUploadCommandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+            uploadStates.Transition(m_TextureId, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
             // Describe and create an SRV for the texture.
             D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -347,93 +380,66 @@ namespace HelloTexture {
             srvDesc.Format = textureDesc.Format;
             srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
             srvDesc.Texture2D.MipLevels = 1;
-            m_Device->CreateShaderResourceView(m_Texture.Get(), &srvDesc,
-                                               m_SrvHeap->GetCPUDescriptorHandleForHeapStart());
+            m_TextureSrv = m_SrvHeap->Allocate();
+            m_Device->CreateShaderResourceView(m_Texture.Get(), &srvDesc, m_TextureSrv.CpuHandle);
+            m_TextureHandle = m_BindlessHeap->Register(m_TextureSrv.CpuHandle);
         }
 
         // Close the command list and execute it to begin the initial GPU setup.
-        D3D12Tests::ThrowIfFailed(m_CommandList->Close());
-        ID3D12CommandList* ppCommandLists[] = {m_CommandList.Get()};
-        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-        // Create synchronization objects and wait until assets have been uploaded to the GPU.
-        {
-            D3D12Tests::ThrowIfFailed(m_Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
-            m_FenceValue = 1;
-
-            // Create an event handler to use for frame synchronization.
-            m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-            if (m_FenceEvent == nullptr) {
-                D3D12Tests::ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
-            }
-
-            // Wait for the command list to execute; we are reusing the same command
-            // list in our main loop but for now, we just want to wait for setup to
-            // complete before continuing.
-            WaitForPreviousFrame();
-        }
+        uploadStates.Close(pUploadCommandList);
+        D3D12Tests::ThrowIfFailed(pUploadCommandList->Close());
+        m_JobSystem->Wait(assetJobs);
+        ExecuteCommandList(pUploadCommandList, uploadStates);
+
+        // Give the context back to the pool, it will be recycled once the uploads are done.
+        // For now, we just want to wait for setup to complete before continuing.
+        const UINT64 uploadFenceValue = m_Timeline->Signal();
+        m_CommandContextPool->Release(std::move(uploadContext), uploadFenceValue);
+        m_Timeline->WaitForValue(uploadFenceValue);
     }
 
-    std::vector<UINT8> HelloTexture::GenerateTextureData() {
-        constexpr UINT rowPitch = TextureWidth * TexturePixelSize;
-        constexpr UINT cellPitch = rowPitch >> 3; // The width of a cell in the checkerboard texture.
-        constexpr UINT cellHeight = TextureWidth >> 3; // The height of a cell in the checkerboard texture.
-        constexpr UINT textureSize = rowPitch * TextureHeight;
-
-        std::vector<UINT8> data(textureSize);
-        UINT8* pData = &data[0];
-
-        for (UINT n = 0; n < textureSize; n += TexturePixelSize) {
-            UINT x = n % rowPitch;
-            UINT y = n / rowPitch;
-            UINT i = x / cellPitch;
-            UINT j = y / cellHeight;
-
-            if (i % 2 == j % 2) {
-                pData[n] = 0x00; // R
-                pData[n + 1] = 0x00; // G
-                pData[n + 2] = 0x00; // B
-                pData[n + 3] = 0xff; // A
-            } else {
-                pData[n] = 0xff; // R
-                pData[n + 1] = 0xff; // G
-                pData[n + 2] = 0xff; // B
-                pData[n + 3] = 0xff; // A
-            }
-        }
+    void HelloTexture::GenerateTextureData(const D3D12Tests::TextureRegion& region) {
+        // An 8x8 checkerboard, starting with a black cell.
+        D3D12Tests::CheckerboardDesc checkerboard;
+        checkerboard.CellWidth = TextureWidth >> 3;
+        checkerboard.CellHeight = TextureHeight >> 3;
+        checkerboard.Color0 = 0xff000000;
+        checkerboard.Color1 = 0xffffffff;
 
-        return data;
+        D3D12Tests::GenerateCheckerboard(region, checkerboard);
     }
 
-    void HelloTexture::PopulateCommandList() {
+    void HelloTexture::PopulateCommandList(const FrameResources& frame) {
+        D3D12TESTS_PROFILE_SCOPE("HelloTexture::PopulateCommandList");
+
         // Command list allocators can only be reset when the associated
         // command lists have finished executing on the GPU; apps should use
         // fences to determine GPU execution progress.
-        D3D12Tests::ThrowIfFailed(m_CommandAllocator->Reset());
+        D3D12Tests::ThrowIfFailed(frame.CommandAllocator->Reset());
 
         // However, when ExecuteCommandList() is called on a particular command
         // list, the command list can then be reset at any time and must be before
         // re-recording.
-        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(m_CommandAllocator.Get(), m_PipelineState.Get()));
+        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(frame.CommandAllocator.Get(), m_PipelineState.Get()));
+        m_StateTracker.Reset();
 
         // Set necessary states.
         m_CommandList->SetGraphicsRootSignature(m_RootSignature.Get());
 
-        ID3D12DescriptorHeap* ppHeaps[] = {m_SrvHeap.Get()};
+        ID3D12DescriptorHeap* ppHeaps[] = {m_BindlessHeap->GetHeap()};
         m_CommandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
 
-        m_CommandList->SetGraphicsRootDescriptorTable(0, m_SrvHeap->GetGPUDescriptorHandleForHeapStart());
+        // The bindless table stays the same, only the index of the texture is set per draw.
+        m_CommandList->SetGraphicsRootDescriptorTable(0, m_BindlessHeap->GetGpuStart());
+        m_CommandList->SetGraphicsRoot32BitConstant(1, m_BindlessHeap->Resolve(m_TextureHandle), 0);
         m_CommandList->RSSetViewports(1, &m_Viewport);
         m_CommandList->RSSetScissorRects(1, &m_ScissorRect);
 
         // Indicate that the back buffer will be used as a render target.
-        auto transition = CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargets[m_FrameIndex].Get(),
-                                                               D3D12_RESOURCE_STATE_PRESENT,
-                                                               D3D12_RESOURCE_STATE_RENDER_TARGET);
-        m_CommandList->ResourceBarrier(1, &transition);
+        m_StateTracker.Transition(m_RenderTargetIds[m_FrameIndex], D3D12_RESOURCE_STATE_RENDER_TARGET);
+        m_StateTracker.FlushBarriers(m_CommandList.Get());
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart(), m_FrameIndex,
-                                                m_RtvDescriptorSize);
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_RtvHeap->GetCpuHandle(m_RtvDescriptors, m_FrameIndex);
         m_CommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
 
         // Record commands
@@ -444,31 +450,31 @@ namespace HelloTexture {
         m_CommandList->DrawInstanced(3, 1, 0, 0);
 
         // Indicate that the back buffer will now be used to present.
-        transition = CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargets[m_FrameIndex].Get(),
-                                                          D3D12_RESOURCE_STATE_RENDER_TARGET,
-                                                          D3D12_RESOURCE_STATE_PRESENT);
-        m_CommandList->ResourceBarrier(1, &transition);
+        m_StateTracker.Transition(m_RenderTargetIds[m_FrameIndex], D3D12_RESOURCE_STATE_PRESENT);
+        m_StateTracker.Close(m_CommandList.Get());
 
         D3D12Tests::ThrowIfFailed(m_CommandList->Close());
     }
 
-    void HelloTexture::WaitForPreviousFrame() {
-        // WAITING FOR THE FRAME TO BE COMPLETE BEFORE CONTINUING IS NOT THE BEST PRACTICE.
-        // This is code implemented as such for simplicity. The HelloFrameBuffering
-        // test illustrates how to use fences for efficient resource usage and to
-        // maximize GPU utilization.
-
-        // Signal and increment the fence value.
-        const UINT64 fence = m_FenceValue;
-        D3D12Tests::ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), fence));
-        m_FenceValue++;
-
-        // Wait until the previous fence is finished.
-        if (m_Fence->GetCompletedValue() < fence) {
-            D3D12Tests::ThrowIfFailed(m_Fence->SetEventOnCompletion(fence, m_FenceEvent));
-            WaitForSingleObject(m_FenceEvent, INFINITE);
+    void HelloTexture::ExecuteCommandList(ID3D12CommandList* pCommandList,
+                                          const D3D12Tests::D3D12ResourceStateTracker& tracker) {
+        // The barriers bringing the resources to the states the list starts with are
+        // recorded in a separate list, executed right before it.
+        const std::span<const D3D12Tests::ResourceBarrier> barriers = m_ResourceStates.Resolve(tracker);
+        if (barriers.empty()) {
+            ID3D12CommandList* ppCommandLists[] = {pCommandList};
+            m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+            return;
         }
 
-        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
+        D3D12Tests::D3D12CommandContext context = m_CommandContextPool->Acquire();
+        m_ResourceStates.RecordBarriers(context.CommandList.Get(), barriers);
+        D3D12Tests::ThrowIfFailed(context.CommandList->Close());
+
+        ID3D12CommandList* ppCommandLists[] = {context.CommandList.Get(), pCommandList};
+        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+        // The context is recycled once the next value signaled on the timeline has completed.
+        m_CommandContextPool->Release(std::move(context), m_Timeline->GetLastSignaledValue() + 1);
     }
 }
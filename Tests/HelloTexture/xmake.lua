@@ -1,5 +1,6 @@
 target("HelloTexture")
   set_kind("binary")
+  set_enabled(is_plat("windows"))
   
   add_rules("cp_tests_resources")
 
@@ -8,6 +8,15 @@
 #define D3D12TESTS_HELLOTRIANGLE_HELLOTRIANGLE_HPP
 
 #include "Framework/Application.hpp"
+#include "Framework/D3D12CommandContextPool.hpp"
+#include "Framework/D3D12DescriptorHeap.hpp"
+#include "Framework/D3D12GpuTimeline.hpp"
+#include "Framework/D3D12PipelineRegistry.hpp"
+#include "Framework/D3D12ResourceStateTable.hpp"
+#include "Framework/D3D12ResourceStateTracker.hpp"
+#include "Framework/D3D12UploadRing.hpp"
+#include "Framework/FrameRing.hpp"
+#include "Framework/MeshFile.hpp"
 
 #include "Framework/pch.hpp"
 
@@ -37,10 +46,14 @@ namespace HelloTriangle {
 
     private:
         static const UINT FrameCount = 2;
-
-        struct Vertex {
-            DirectX::XMFLOAT3 Position;
-            DirectX::XMFLOAT4 Color;
+        static constexpr UINT64 UploadRingSize = 4 * 1024 * 1024;
+        static constexpr UINT RtvHeapCapacity = 16;
+        // Position and color, one vertex buffer each.
+        static constexpr UINT VertexStreamCount = 2;
+
+        // Resources that can only be reused once the GPU is done with the frame that used them.
+        struct FrameResources {
+            ComPtr<ID3D12CommandAllocator> CommandAllocator;
         };
 
         // Pipeline objects.
@@ -49,28 +62,38 @@ namespace HelloTriangle {
         ComPtr<IDXGISwapChain3> m_SwapChain;
         ComPtr<ID3D12Device> m_Device;
         ComPtr<ID3D12Resource> m_RenderTargets[FrameCount];
-        ComPtr<ID3D12CommandAllocator> m_CommandAllocator;
         ComPtr<ID3D12CommandQueue> m_CommandQueue;
         ComPtr<ID3D12RootSignature> m_RootSignature;
-        ComPtr<ID3D12DescriptorHeap> m_RtvHeap;
+        std::unique_ptr<D3D12Tests::D3D12DescriptorHeap> m_RtvHeap;
+        D3D12Tests::D3D12DescriptorRange m_RtvDescriptors;
+        std::unique_ptr<D3D12Tests::D3D12PipelineRegistry> m_PipelineRegistry;
         ComPtr<ID3D12PipelineState> m_PipelineState;
         ComPtr<ID3D12GraphicsCommandList> m_CommandList;
-        UINT m_RtvDescriptorSize;
 
         // App resources
-        ComPtr<ID3D12Resource> m_VertexBuffer;
-        D3D12_VERTEX_BUFFER_VIEW m_VertexBufferView;
+        // The vertex streams and the indices of the mesh share one buffer.
+        ComPtr<ID3D12Resource> m_GeometryBuffer;
+        D3D12_VERTEX_BUFFER_VIEW m_VertexBufferViews[VertexStreamCount];
+        D3D12_INDEX_BUFFER_VIEW m_IndexBufferView;
+        std::vector<D3D12Tests::MeshLodDesc> m_Draws;
+
+        // Resource states, and the tracker of the main command list.
+        D3D12Tests::D3D12ResourceStateTable m_ResourceStates;
+        D3D12Tests::D3D12ResourceStateTracker m_StateTracker;
+        D3D12Tests::UInt32 m_RenderTargetIds[FrameCount];
+        D3D12Tests::UInt32 m_GeometryBufferId;
 
         // Synchronization objects.
         UINT m_FrameIndex;
-        HANDLE m_FenceEvent;
-        ComPtr<ID3D12Fence> m_Fence;
-        UINT64 m_FenceValue;
+        std::unique_ptr<D3D12Tests::D3D12GpuTimeline> m_Timeline;
+        std::unique_ptr<D3D12Tests::FrameRing<FrameResources>> m_FrameRing;
+        std::unique_ptr<D3D12Tests::D3D12CommandContextPool> m_CommandContextPool;
+        std::unique_ptr<D3D12Tests::D3D12UploadRing> m_UploadRing;
 
         void LoadPipeline();
         void LoadAssets();
-        void PopulateCommandList();
-        void WaitForPreviousFrame();
+        void PopulateCommandList(const FrameResources& frame);
+        void ExecuteCommandList(ID3D12CommandList* pCommandList, const D3D12Tests::D3D12ResourceStateTracker& tracker);
     };
 }
 
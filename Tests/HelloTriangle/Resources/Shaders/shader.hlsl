@@ -1,3 +1,8 @@
+cbuffer RootConstants : register(b0)
+{
+    float AspectRatio;
+};
+
 struct PSInput
 {
     float4 position : SV_POSITION;
@@ -8,7 +13,7 @@ PSInput VSMain(float4 position : POSITION, float4 color : COLOR)
 {
     PSInput result;
     
-    result.position = position;
+    result.position = float4(position.x, position.y * AspectRatio, position.z, position.w);
     result.color = color;
     
     return result;
@@ -9,7 +9,7 @@ namespace HelloTriangle {
         D3D12Tests::Application(width, height, name),
         m_Viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
         m_ScissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)),
-        m_RtvDescriptorSize(0),
+        m_StateTracker(m_ResourceStates),
         m_FrameIndex(0) {
     }
 
@@ -22,26 +22,35 @@ namespace HelloTriangle {
     }
 
     void HelloTriangle::OnRender() {
+        // Only blocks if the GPU is still using the frame context we are about to reuse.
+        const FrameResources& frame = m_FrameRing->BeginFrame();
+
         // Record all the commands we need to render the scene into the command list.
-        PopulateCommandList();
+        PopulateCommandList(frame);
 
         // Execute the command list.
-        ID3D12CommandList* ppCommandLists[] = {m_CommandList.Get()};
-        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+        ExecuteCommandList(m_CommandList.Get(), m_StateTracker);
 
         // Present the frame.
         D3D12Tests::ThrowIfFailed(m_SwapChain->Present(1, 0));
 
-        WaitForPreviousFrame();
+        // Signal the end of the frame and move on without waiting for the GPU.
+        m_FrameRing->EndFrame();
+        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
     }
 
     void HelloTriangle::OnDestroy() {
-        WaitForPreviousFrame();
+        // Ensure that the GPU is no longer referencing resources that are about to be
+        // cleaned up by the destructor.
+        m_FrameRing->Flush();
 
-        CloseHandle(m_FenceEvent);
+        // Keep the pipelines created during this run for the next one.
+        m_PipelineRegistry->SaveManifest(GetAssetFullPath(L"HelloTriangle/PipelineManifest.bin"));
     }
 
     void HelloTriangle::LoadPipeline() {
+        D3D12TESTS_PROFILE_SCOPE("HelloTriangle::LoadPipeline");
+
         UINT dxgiFactoryFlags = 0;
 
 #ifdef D3D12TESTS_DEBUG
@@ -116,38 +125,48 @@ namespace HelloTriangle {
 
         // Create descriptor heaps
         {
-            // Describe and create a render target view (RTV) descriptor heap.
-            D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-            rtvHeapDesc.NumDescriptors = FrameCount;
-            rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-            rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_RtvHeap)));
-
-            m_RtvDescriptorSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+            // Create a render target view (RTV) descriptor heap.
+            m_RtvHeap = std::make_unique<D3D12Tests::D3D12DescriptorHeap>(
+                m_Device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, RtvHeapCapacity);
         }
 
         // Create frame resources
         {
-            CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart());
-
             // Create an RTV for each frame.
+            m_RtvDescriptors = m_RtvHeap->Allocate(FrameCount);
             for (UINT n = 0; n < FrameCount; n++) {
                 D3D12Tests::ThrowIfFailed(m_SwapChain->GetBuffer(n, IID_PPV_ARGS(&m_RenderTargets[n])));
-                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr, rtvHandle);
-                rtvHandle.Offset(1, m_RtvDescriptorSize);
+                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr,
+                                                 m_RtvHeap->GetCpuHandle(m_RtvDescriptors, n));
+                m_RenderTargetIds[n] = m_ResourceStates.Register(m_RenderTargets[n].Get(),
+                                                                 D3D12_RESOURCE_STATE_PRESENT);
             }
         }
 
-        D3D12Tests::ThrowIfFailed(
-            m_Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_CommandAllocator)));
+        // Create the frame ring, with a command allocator for each frame that can be in flight.
+        m_Timeline = std::make_unique<D3D12Tests::D3D12GpuTimeline>(m_Device.Get(), m_CommandQueue.Get());
+        m_FrameRing = std::make_unique<D3D12Tests::FrameRing<FrameResources>>(*m_Timeline, FrameCount);
+        m_CommandContextPool = std::make_unique<D3D12Tests::D3D12CommandContextPool>(
+            m_Device.Get(), *m_Timeline, D3D12_COMMAND_LIST_TYPE_DIRECT);
+        m_UploadRing = std::make_unique<D3D12Tests::D3D12UploadRing>(m_Device.Get(), *m_Timeline, UploadRingSize);
+
+        for (UINT n = 0; n < FrameCount; n++) {
+            D3D12Tests::ThrowIfFailed(m_Device->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_FrameRing->GetFrame(n).CommandAllocator)));
+        }
     }
 
     // Load the test's assets.
     void HelloTriangle::LoadAssets() {
-        // Create an empty root signature.
+        D3D12TESTS_PROFILE_SCOPE("HelloTriangle::LoadAssets");
+
+        // Create a root signature with the aspect ratio as a root constant of the vertex shader.
         {
+            CD3DX12_ROOT_PARAMETER rootParameters[1];
+            rootParameters[0].InitAsConstants(1, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
             CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
-            rootSignatureDesc.Init(0, nullptr, 0, nullptr,
+            rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 0, nullptr,
                                    D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
             ComPtr<ID3DBlob> signature;
@@ -157,30 +176,27 @@ namespace HelloTriangle {
             D3D12Tests::ThrowIfFailed(m_Device->CreateRootSignature(0, signature->GetBufferPointer(),
                                                                     signature->GetBufferSize(),
                                                                     IID_PPV_ARGS(&m_RootSignature)));
+
+            // Pipelines refer to the root signature by the hash of its serialized blob.
+            m_PipelineRegistry = std::make_unique<D3D12Tests::D3D12PipelineRegistry>(m_Device.Get());
+            m_PipelineRegistry->LoadManifest(GetAssetFullPath(L"HelloTriangle/PipelineManifest.bin"));
+            m_PipelineRegistry->RegisterRootSignature(m_RootSignature.Get(), signature->GetBufferPointer(),
+                                                      signature->GetBufferSize());
         }
 
         // Create the pipeline state, which includes compiling and loading shaders.
         {
-            ComPtr<ID3DBlob> vertexShader;
-            ComPtr<ID3DBlob> pixelShader;
-
-            UINT compilerFlags = 0;
-#ifdef D3D12TESTS_DEBUG
-            // Enable better shader debugging with the graphics debugging tools.
-            compilerFlags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-
-            D3D12Tests::ThrowIfFailed(D3DCompileFromFile(
-                GetAssetFullPath(L"HelloTriangle/Resources/Shaders/shader.hlsl").c_str(), nullptr, nullptr, "VSMain",
-                "vs_5_0", compilerFlags, 0, &vertexShader, nullptr));
-            D3D12Tests::ThrowIfFailed(D3DCompileFromFile(
-                GetAssetFullPath(L"HelloTriangle/Resources/Shaders/shader.hlsl").c_str(), nullptr, nullptr, "PSMain",
-                "ps_5_0", compilerFlags, 0, &pixelShader, nullptr));
-
-            // Define the vertex input layout
+            // Compiled shaders are kept in a cache file, only the first launch (or one following
+            // a change of the shader sources) runs the compiler. The debug flags are part of the
+            // cache key.
+            const std::wstring shaderPath = GetAssetFullPath(L"HelloTriangle/Resources/Shaders/shader.hlsl");
+            const ComPtr<ID3DBlob> vertexShader = D3D12Tests::CompileShader(shaderPath, nullptr, "VSMain", "vs_5_0");
+            const ComPtr<ID3DBlob> pixelShader = D3D12Tests::CompileShader(shaderPath, nullptr, "PSMain", "ps_5_0");
+
+            // Define the vertex input layout, one slot per stream of the mesh.
             D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
                 {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-                {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+                {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
             };
 
             // Describe and create the graphics pipeline state object (PSO).
@@ -198,84 +214,123 @@ namespace HelloTriangle {
             psoDesc.NumRenderTargets = 1;
             psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
             psoDesc.SampleDesc.Count = 1;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_PipelineState)));
+
+            // Create the pipelines seen in the previous runs with these shaders up front; the
+            // registry then returns the existing pipeline for this description.
+            m_PipelineRegistry->RegisterShader(psoDesc.VS);
+            m_PipelineRegistry->RegisterShader(psoDesc.PS);
+            m_PipelineRegistry->Prewarm();
+            m_PipelineState = m_PipelineRegistry->GetOrCreate(psoDesc);
         }
 
         // Create the command list
         D3D12Tests::ThrowIfFailed(m_Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                                              m_CommandAllocator.Get(), nullptr,
+                                                              m_FrameRing->GetCurrentFrame().CommandAllocator.Get(),
+                                                              nullptr,
                                                               IID_PPV_ARGS(&m_CommandList)));
 
         // Command lists are created in the recording state, but there is nothing
         // to record yet. The main loop expects it to be closed, so close it now.
         D3D12Tests::ThrowIfFailed(m_CommandList->Close());
 
-        // Create the vertex buffer.
-        {
-            // Define the geometry for a triangle.
-            Vertex triangleVertices[] = {
-                {{0.0f, 0.25f * m_AspectRatio, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
-                {{0.25f, -0.25f * m_AspectRatio, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
-                {{-0.25f, -0.25f * m_AspectRatio, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}},
-            };
-
-            const UINT vertexBufferSize = sizeof(triangleVertices);
+        // The initial uploads are recorded on a pooled context, the main command list is
+        // only used for rendering.
+        D3D12Tests::D3D12CommandContext uploadContext = m_CommandContextPool->Acquire();
+        ID3D12GraphicsCommandList* pUploadCommandList = uploadContext.CommandList.Get();
+        D3D12Tests::D3D12ResourceStateTracker uploadStates(m_ResourceStates);
 
-            // Note: using upload heaps to transfer static data like vert buffers is not 
-            // recommended. Every time the GPU needs it, the upload heap will be marshalled 
-            // over. Please read up on Default Heap usage. An upload heap is used here for 
-            // code simplicity and because there are very few verts to actually transfer.
-            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-            auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize);
+        // Create the geometry buffer.
+        {
+            // The mesh file is mapped and its geometry copied to the upload ring as it is: the
+            // vertices are laid out the way the input assembler reads them.
+            const D3D12Tests::MeshFile mesh(GetAssetFullPath(L"HelloTriangle/Resources/Meshes/Triangle.mesh"));
+            const std::span<const std::byte> geometry = mesh.GetGeometryData();
+            const UINT64 geometrySize = geometry.size();
+
+            // The geometry buffer lives in a default heap, the data is staged through the
+            // upload ring and copied on the GPU.
+            auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+            auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(geometrySize);
             D3D12Tests::ThrowIfFailed(m_Device->CreateCommittedResource(
                 &heapProperties,
                 D3D12_HEAP_FLAG_NONE,
                 &bufferDesc,
-                D3D12_RESOURCE_STATE_GENERIC_READ,
+                D3D12_RESOURCE_STATE_COMMON,
                 nullptr,
-                IID_PPV_ARGS(&m_VertexBuffer)));
-
-            // Copy the triangle data to the vertex buffer.
-            UINT8* pVertexDataBegin;
-            CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resources on the CPU.
-            D3D12Tests::ThrowIfFailed(m_VertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-            memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
-            m_VertexBuffer->Unmap(0, nullptr);
-
-            // Initialize the vertex buffer view.
-            m_VertexBufferView.BufferLocation = m_VertexBuffer->GetGPUVirtualAddress();
-            m_VertexBufferView.StrideInBytes = sizeof(Vertex);
-            m_VertexBufferView.SizeInBytes = vertexBufferSize;
-        }
+                IID_PPV_ARGS(&m_GeometryBuffer)));
+            m_GeometryBufferId = m_ResourceStates.Register(m_GeometryBuffer.Get(), D3D12_RESOURCE_STATE_COMMON);
+
+            // Copy the mesh to the geometry buffer.
+            uploadStates.Transition(m_GeometryBufferId, D3D12_RESOURCE_STATE_COPY_DEST);
+            uploadStates.FlushBarriers(pUploadCommandList);
+            const D3D12Tests::UploadAllocation upload = m_UploadRing->Upload(geometry.data(), geometrySize);
+            pUploadCommandList->CopyBufferRegion(m_GeometryBuffer.Get(), 0, m_UploadRing->GetResource(),
+                                                 upload.Offset, geometrySize);
+
+            uploadStates.Transition(m_GeometryBufferId, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER |
+                                    D3D12_RESOURCE_STATE_INDEX_BUFFER);
+
+            // Initialize the buffer views at the offsets of the mesh tables, in the slots of
+            // the input layout.
+            struct VertexSlot {
+                D3D12Tests::MeshSemantic Semantic;
+                DXGI_FORMAT Format;
+            };
 
-        // Create synchronization objects and wait until assets have been uploaded to the GPU.
-        {
-            D3D12Tests::ThrowIfFailed(m_Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
-            m_FenceValue = 1;
+            constexpr VertexSlot vertexSlots[VertexStreamCount] = {
+                {D3D12Tests::MeshSemantic::Position, DXGI_FORMAT_R32G32B32_FLOAT},
+                {D3D12Tests::MeshSemantic::Color, DXGI_FORMAT_R32G32B32A32_FLOAT}
+            };
 
-            // Create an event handler to use for frame synchronization.
-            m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-            if (m_FenceEvent == nullptr) {
-                D3D12Tests::ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+            const D3D12_GPU_VIRTUAL_ADDRESS geometryAddress = m_GeometryBuffer->GetGPUVirtualAddress();
+            for (UINT slot = 0; slot < VertexStreamCount; ++slot) {
+                const D3D12Tests::MeshStreamDesc* pStream = mesh.FindStream(vertexSlots[slot].Semantic);
+                if (pStream == nullptr || pStream->Format != static_cast<D3D12Tests::UInt32>(vertexSlots[slot].Format)) {
+                    throw std::runtime_error("The triangle mesh does not match the input layout.");
+                }
+
+                m_VertexBufferViews[slot].BufferLocation = geometryAddress + pStream->Offset;
+                m_VertexBufferViews[slot].StrideInBytes = pStream->Stride;
+                m_VertexBufferViews[slot].SizeInBytes = static_cast<UINT>(pStream->Size);
             }
 
-            // Wait for the command list to execute; we are reusing the same command
-            // list in our main loop but for now, we just want to wait for setup to
-            // complete before continuing.
-            WaitForPreviousFrame();
+            m_IndexBufferView.BufferLocation = geometryAddress + mesh.GetHeader().IndexOffset;
+            m_IndexBufferView.SizeInBytes = static_cast<UINT>(mesh.GetIndexData().size());
+            m_IndexBufferView.Format = static_cast<DXGI_FORMAT>(mesh.GetIndexFormat());
+
+            // One draw per submesh, at its most detailed level.
+            for (const D3D12Tests::MeshSubmeshDesc& submesh : mesh.GetSubmeshes()) {
+                if (submesh.LodCount != 0) {
+                    m_Draws.push_back(mesh.GetLods(submesh).front());
+                }
+            }
         }
+
+        // Close the command list and execute it to begin the initial GPU setup.
+        uploadStates.Close(pUploadCommandList);
+        D3D12Tests::ThrowIfFailed(pUploadCommandList->Close());
+        ExecuteCommandList(pUploadCommandList, uploadStates);
+
+        // Give the context back to the pool, it will be recycled once the uploads are done.
+        // For now, we just want to wait for setup to complete before continuing.
+        const UINT64 uploadFenceValue = m_Timeline->Signal();
+        m_CommandContextPool->Release(std::move(uploadContext), uploadFenceValue);
+        m_Timeline->WaitForValue(uploadFenceValue);
     }
 
-    void HelloTriangle::PopulateCommandList() {
+    void HelloTriangle::PopulateCommandList(const FrameResources& frame) {
+        D3D12TESTS_PROFILE_SCOPE("HelloTriangle::PopulateCommandList");
+
         // Command list allocators can only be reset when the associated
         // command lists have finished executing on the GPU; apps should use
         // fences to determine GPU execution progress.
-        D3D12Tests::ThrowIfFailed(m_CommandAllocator->Reset());
+        D3D12Tests::ThrowIfFailed(frame.CommandAllocator->Reset());
 
         // However, when ExecuteCommandList() is called on a particular command
         // list, the command list can then be reset at any time and must be before
         // re-recording.
-        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(m_CommandAllocator.Get(), m_PipelineState.Get()));
+        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(frame.CommandAllocator.Get(), m_PipelineState.Get()));
+        m_StateTracker.Reset();
 
         // Set necessary states.
         m_CommandList->SetGraphicsRootSignature(m_RootSignature.Get());
@@ -283,48 +338,49 @@ namespace HelloTriangle {
         m_CommandList->RSSetScissorRects(1, &m_ScissorRect);
 
         // Indicate that the back buffer will be used as a render target.
-        auto transition = CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargets[m_FrameIndex].Get(),
-                                                               D3D12_RESOURCE_STATE_PRESENT,
-                                                               D3D12_RESOURCE_STATE_RENDER_TARGET);
-        m_CommandList->ResourceBarrier(1, &transition);
+        m_StateTracker.Transition(m_RenderTargetIds[m_FrameIndex], D3D12_RESOURCE_STATE_RENDER_TARGET);
+        m_StateTracker.FlushBarriers(m_CommandList.Get());
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart(), m_FrameIndex,
-                                                m_RtvDescriptorSize);
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_RtvHeap->GetCpuHandle(m_RtvDescriptors, m_FrameIndex);
         m_CommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
 
         // Record commands
         constexpr D3D12Tests::Float32 clearColor[] = {0.0f, 0.2f, 0.4f, 1.0f};
         m_CommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+        m_CommandList->SetGraphicsRoot32BitConstants(0, 1, &m_AspectRatio, 0);
         m_CommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        m_CommandList->IASetVertexBuffers(0, 1, &m_VertexBufferView);
-        m_CommandList->DrawInstanced(3, 1, 0, 0);
+        m_CommandList->IASetVertexBuffers(0, VertexStreamCount, m_VertexBufferViews);
+        m_CommandList->IASetIndexBuffer(&m_IndexBufferView);
+        for (const D3D12Tests::MeshLodDesc& draw : m_Draws) {
+            m_CommandList->DrawIndexedInstanced(draw.IndexCount, 1, draw.FirstIndex, static_cast<INT>(draw.BaseVertex), 0);
+        }
 
         // Indicate that the back buffer will now be used to present.
-        transition = CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargets[m_FrameIndex].Get(),
-                                                          D3D12_RESOURCE_STATE_RENDER_TARGET,
-                                                          D3D12_RESOURCE_STATE_PRESENT);
-        m_CommandList->ResourceBarrier(1, &transition);
+        m_StateTracker.Transition(m_RenderTargetIds[m_FrameIndex], D3D12_RESOURCE_STATE_PRESENT);
+        m_StateTracker.Close(m_CommandList.Get());
 
         D3D12Tests::ThrowIfFailed(m_CommandList->Close());
     }
 
-    void HelloTriangle::WaitForPreviousFrame() {
-        // WAITING FOR THE FRAME TO BE COMPLETE BEFORE CONTINUING IS NOT THE BEST PRACTICE.
-        // This is code implemented as such for simplicity. The HelloFrameBuffering
-        // test illustrates how to use fences for efficient resource usage and to
-        // maximize GPU utilization.
-
-        // Signal and increment the fence value.
-        const UINT64 fence = m_FenceValue;
-        D3D12Tests::ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), fence));
-        m_FenceValue++;
-
-        // Wait until the previous fence is finished.
-        if (m_Fence->GetCompletedValue() < fence) {
-            D3D12Tests::ThrowIfFailed(m_Fence->SetEventOnCompletion(fence, m_FenceEvent));
-            WaitForSingleObject(m_FenceEvent, INFINITE);
+    void HelloTriangle::ExecuteCommandList(ID3D12CommandList* pCommandList,
+                                           const D3D12Tests::D3D12ResourceStateTracker& tracker) {
+        // The barriers bringing the resources to the states the list starts with are
+        // recorded in a separate list, executed right before it.
+        const std::span<const D3D12Tests::ResourceBarrier> barriers = m_ResourceStates.Resolve(tracker);
+        if (barriers.empty()) {
+            ID3D12CommandList* ppCommandLists[] = {pCommandList};
+            m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+            return;
         }
 
-        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
+        D3D12Tests::D3D12CommandContext context = m_CommandContextPool->Acquire();
+        m_ResourceStates.RecordBarriers(context.CommandList.Get(), barriers);
+        D3D12Tests::ThrowIfFailed(context.CommandList->Close());
+
+        ID3D12CommandList* ppCommandLists[] = {context.CommandList.Get(), pCommandList};
+        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+        // The context is recycled once the next value signaled on the timeline has completed.
+        m_CommandContextPool->Release(std::move(context), m_Timeline->GetLastSignaledValue() + 1);
     }
 }
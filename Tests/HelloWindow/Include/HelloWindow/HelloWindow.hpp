@@ -8,6 +8,9 @@
 #define D3D12TESTS_HELLOWINDOW_HELLOWINDOW_HPP
 
 #include "Framework/Application.hpp"
+#include "Framework/D3D12DescriptorHeap.hpp"
+#include "Framework/D3D12GpuTimeline.hpp"
+#include "Framework/FrameRing.hpp"
 
 #include "Framework/pch.hpp"
 
@@ -37,28 +40,32 @@ namespace HelloWindow {
 
     private:
         static const UINT FrameCount = 2;
+        static constexpr UINT RtvHeapCapacity = 16;
+
+        // Resources that can only be reused once the GPU is done with the frame that used them.
+        struct FrameResources {
+            ComPtr<ID3D12CommandAllocator> CommandAllocator;
+        };
 
         // Pipeline objects.
         ComPtr<IDXGISwapChain3> m_SwapChain;
         ComPtr<ID3D12Device> m_Device;
         ComPtr<ID3D12Resource> m_RenderTargets[FrameCount];
-        ComPtr<ID3D12CommandAllocator> m_CommandAllocator;
         ComPtr<ID3D12CommandQueue> m_CommandQueue;
-        ComPtr<ID3D12DescriptorHeap> m_RtvHeap;
+        std::unique_ptr<D3D12Tests::D3D12DescriptorHeap> m_RtvHeap;
+        D3D12Tests::D3D12DescriptorRange m_RtvDescriptors;
         ComPtr<ID3D12PipelineState> m_PipelineState;
         ComPtr<ID3D12GraphicsCommandList> m_CommandList;
-        UINT m_RtvDescriptorSize;
 
         // Synchronization objects.
         UINT m_FrameIndex;
-        HANDLE m_FenceEvent;
-        ComPtr<ID3D12Fence> m_Fence;
-        UINT64 m_FenceValue;
+        HANDLE m_FrameLatencyWaitableObject;
+        std::unique_ptr<D3D12Tests::D3D12GpuTimeline> m_Timeline;
+        std::unique_ptr<D3D12Tests::FrameRing<FrameResources>> m_FrameRing;
 
         void LoadPipeline();
         void LoadAssets();
-        void PopulateCommandList();
-        void WaitForPreviousFrame();
+        void PopulateCommandList(const FrameResources& frame);
     };
 }
 
@@ -7,8 +7,8 @@
 namespace HelloWindow {
     HelloWindow::HelloWindow(const UINT width, const UINT height, const std::wstring& name) :
         D3D12Tests::Application(width, height, name),
-        m_RtvDescriptorSize(0),
-        m_FrameIndex(0) {
+        m_FrameIndex(0),
+        m_FrameLatencyWaitableObject(nullptr) {
     }
 
     void HelloWindow::OnInit() {
@@ -20,8 +20,11 @@ namespace HelloWindow {
     }
 
     void HelloWindow::OnRender() {
+        // Only blocks if the GPU is still using the frame context we are about to reuse.
+        const FrameResources& frame = m_FrameRing->BeginFrame();
+
         // Record all the commands we need to render the scene into the command list.
-        PopulateCommandList();
+        PopulateCommandList(frame);
 
         // Execute the command list.
         ID3D12CommandList* ppCommandLists[] = {m_CommandList.Get()};
@@ -30,16 +33,22 @@ namespace HelloWindow {
         // Present the frame.
         D3D12Tests::ThrowIfFailed(m_SwapChain->Present(1, 0));
 
-        WaitForPreviousFrame();
+        // Signal the end of the frame and move on without waiting for the GPU.
+        m_FrameRing->EndFrame();
+        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
     }
 
     void HelloWindow::OnDestroy() {
-        WaitForPreviousFrame();
+        // Ensure that the GPU is no longer referencing resources that are about to be
+        // cleaned up by the destructor.
+        m_FrameRing->Flush();
 
-        CloseHandle(m_FenceEvent);
+        CloseHandle(m_FrameLatencyWaitableObject);
     }
 
     void HelloWindow::LoadPipeline() {
+        D3D12TESTS_PROFILE_SCOPE("HelloWindow::LoadPipeline");
+
         UINT dxgiFactoryFlags = 0;
 
 #ifdef D3D12TESTS_DEBUG
@@ -95,6 +104,8 @@ namespace HelloWindow {
         swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
         swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
         swapChainDesc.SampleDesc.Count = 1;
+        // Lets the low-latency frame pacing wait until the swap chain can take a new frame.
+        swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
         ComPtr<IDXGISwapChain1> swapChain;
         D3D12Tests::ThrowIfFailed(factory->CreateSwapChainForHwnd(
@@ -112,68 +123,67 @@ namespace HelloWindow {
         D3D12Tests::ThrowIfFailed(swapChain.As(&m_SwapChain));
         m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
 
+        D3D12Tests::ThrowIfFailed(m_SwapChain->SetMaximumFrameLatency(1));
+        m_FrameLatencyWaitableObject = m_SwapChain->GetFrameLatencyWaitableObject();
+        SetFrameLatencyWaiter([this]() {
+            WaitForSingleObjectEx(m_FrameLatencyWaitableObject, 1000, TRUE);
+        });
+
         // Create descriptor heaps
         {
-            // Describe and create a render target view (RTV) descriptor heap.
-            D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-            rtvHeapDesc.NumDescriptors = FrameCount;
-            rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-            rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-            D3D12Tests::ThrowIfFailed(m_Device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_RtvHeap)));
-
-            m_RtvDescriptorSize = m_Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+            // Create a render target view (RTV) descriptor heap.
+            m_RtvHeap = std::make_unique<D3D12Tests::D3D12DescriptorHeap>(
+                m_Device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, RtvHeapCapacity);
         }
 
         // Create frame resources
         {
-            CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart());
-
             // Create an RTV for each frame.
+            m_RtvDescriptors = m_RtvHeap->Allocate(FrameCount);
             for (UINT n = 0; n < FrameCount; n++) {
                 D3D12Tests::ThrowIfFailed(m_SwapChain->GetBuffer(n, IID_PPV_ARGS(&m_RenderTargets[n])));
-                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr, rtvHandle);
-                rtvHandle.Offset(1, m_RtvDescriptorSize);
+                m_Device->CreateRenderTargetView(m_RenderTargets[n].Get(), nullptr,
+                                                 m_RtvHeap->GetCpuHandle(m_RtvDescriptors, n));
             }
         }
 
-        D3D12Tests::ThrowIfFailed(
-            m_Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_CommandAllocator)));
+        // Create the frame ring, with a command allocator for each frame that can be in flight.
+        m_Timeline = std::make_unique<D3D12Tests::D3D12GpuTimeline>(m_Device.Get(), m_CommandQueue.Get());
+        m_FrameRing = std::make_unique<D3D12Tests::FrameRing<FrameResources>>(*m_Timeline, FrameCount);
+
+        for (UINT n = 0; n < FrameCount; n++) {
+            D3D12Tests::ThrowIfFailed(m_Device->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_FrameRing->GetFrame(n).CommandAllocator)));
+        }
     }
 
     // Load the test's assets.
     void HelloWindow::LoadAssets() {
+        D3D12TESTS_PROFILE_SCOPE("HelloWindow::LoadAssets");
+
         // Create the command list
         D3D12Tests::ThrowIfFailed(m_Device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                                              m_CommandAllocator.Get(), nullptr,
+                                                              m_FrameRing->GetCurrentFrame().CommandAllocator.Get(),
+                                                              nullptr,
                                                               IID_PPV_ARGS(&m_CommandList)));
 
         // Command lists are created in the recording state, but there is nothing
         // to record yet. The main loop expects it to be closed, so close it now.
         D3D12Tests::ThrowIfFailed(m_CommandList->Close());
-
-        // Create synchronization objects.
-        {
-            D3D12Tests::ThrowIfFailed(m_Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
-            m_FenceValue = 1;
-
-            // Create an event handler to use for frame synchronization.
-            m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-            if (m_FenceEvent == nullptr) {
-                D3D12Tests::ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
-            }
-        }
     }
 
-    void HelloWindow::PopulateCommandList() {
+    void HelloWindow::PopulateCommandList(const FrameResources& frame) {
+        D3D12TESTS_PROFILE_SCOPE("HelloWindow::PopulateCommandList");
+
         // Command list allocators can only be reset when the associated
         // command lists have finished executing on the GPU; apps should use
         // fences to determine GPU execution progress.
-        D3D12Tests::ThrowIfFailed(m_CommandAllocator->Reset());
+        D3D12Tests::ThrowIfFailed(frame.CommandAllocator->Reset());
 
         // However, when ExecuteCommandList() is called on a particular command
         // list, the command list can then be reset at any time and must be before
         // re-recording.
-        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(m_CommandAllocator.Get(), m_PipelineState.Get()));
+        D3D12Tests::ThrowIfFailed(m_CommandList->Reset(frame.CommandAllocator.Get(), m_PipelineState.Get()));
 
         // ReSharper disable CppMsExtAddressOfClassRValue
 
@@ -183,8 +193,7 @@ namespace HelloWindow {
                                                                D3D12_RESOURCE_STATE_RENDER_TARGET);
         m_CommandList->ResourceBarrier(1, &transition);
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_RtvHeap->GetCPUDescriptorHandleForHeapStart(), m_FrameIndex,
-                                                m_RtvDescriptorSize);
+        const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_RtvHeap->GetCpuHandle(m_RtvDescriptors, m_FrameIndex);
 
         // Record commands
         constexpr D3D12Tests::Float32 clearColor[] = {0.0f, 0.2f, 0.4f, 1.0f};
@@ -198,24 +207,4 @@ namespace HelloWindow {
 
         D3D12Tests::ThrowIfFailed(m_CommandList->Close());
     }
-
-    void HelloWindow::WaitForPreviousFrame() {
-        // WAITING FOR THE FRAME TO BE COMPLETE BEFORE CONTINUING IS NOT THE BEST PRACTICE.
-        // This is code implemented as such for simplicity. The HelloFrameBuffering
-        // test illustrates how to use fences for efficient resource usage and to
-        // maximize GPU utilization.
-
-        // Signal and increment the fence value.
-        const UINT64 fence = m_FenceValue;
-        D3D12Tests::ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), fence));
-        m_FenceValue++;
-
-        // Wait until the previous fence is finished.
-        if (m_Fence->GetCompletedValue() < fence) {
-            D3D12Tests::ThrowIfFailed(m_Fence->SetEventOnCompletion(fence, m_FenceEvent));
-            WaitForSingleObject(m_FenceEvent, INFINITE);
-        }
-
-        m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
-    }
 }
@@ -1,5 +1,6 @@
 target("HelloWindow")
   set_kind("binary")
+  set_enabled(is_plat("windows"))
   
   add_files("Source/**.cpp")
   
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Jean "Pixfri" Letessier 
+// This file is part of D3D12 Tests.
+// For conditions of distribution and use, see copyright notice in LICENSE.
+
+#include "Framework/MeshOptimizer.hpp"
+#include "Framework/ObjImporter.hpp"
+#include "Framework/VertexCompression.hpp"
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr const char* Usage =
+        "Usage: MeshConverter [options] <input.obj> <output.mesh>\n"
+        "  --reverse-winding  Reverses the vertex order of the faces.\n"
+        "  --keep-v           Keeps the OBJ texture coordinates bottom-up instead of flipping them.\n"
+        "  --optimize         Welds the vertices and reorders the triangles and vertices for the GPU caches.\n"
+        "  --forsyth          Optimizes for the vertex cache with Forsyth's algorithm instead of Tipsify.\n"
+        "  --compress         Encodes the vertex streams in compact formats, after the optimization.\n"
+        "  --hlsl <path>      Writes the HLSL input and decoding of the vertex streams.\n";
+
+    void PrintOptimizeReport(const D3D12Tests::MeshOptimizeReport& report) {
+        std::cout << std::fixed << std::setprecision(3)
+            << "  optimized: " << report.VertexCountBefore << " -> " << report.VertexCountAfter << " vertices"
+            << ", ACMR " << report.CacheBefore.Acmr << " -> " << report.CacheAfter.Acmr
+            << ", ATVR " << report.CacheBefore.Atvr << " -> " << report.CacheAfter.Atvr
+            << ", position overfetch " << report.FetchBefore.Overfetch << " -> " << report.FetchAfter.Overfetch << '\n'
+            << std::defaultfloat;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    D3D12Tests::ObjImportOptions options;
+    D3D12Tests::MeshOptimizeOptions optimizeOptions;
+    bool optimize = false;
+    bool compress = false;
+    const char* hlslPath = nullptr;
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* argument = argv[i];
+        if (std::strcmp(argument, "--help") == 0 || std::strcmp(argument, "-h") == 0) {
+            std::cout << Usage;
+            return 0;
+        }
+
+        if (std::strcmp(argument, "--reverse-winding") == 0) {
+            options.ReverseWinding = true;
+        } else if (std::strcmp(argument, "--keep-v") == 0) {
+            options.FlipTexCoordV = false;
+        } else if (std::strcmp(argument, "--optimize") == 0) {
+            optimize = true;
+        } else if (std::strcmp(argument, "--forsyth") == 0) {
+            optimizeOptions.CacheAlgorithm = D3D12Tests::VertexCacheAlgorithm::Forsyth;
+        } else if (std::strcmp(argument, "--compress") == 0) {
+            compress = true;
+        } else if (std::strcmp(argument, "--hlsl") == 0 && i + 1 < argc) {
+            hlslPath = argv[++i];
+        } else if (argument[0] == '-') {
+            std::cerr << "Unknown option: " << argument << '\n' << Usage;
+            return 2;
+        } else if (inputPath == nullptr) {
+            inputPath = argument;
+        } else if (outputPath == nullptr) {
+            outputPath = argument;
+        } else {
+            std::cerr << "Too many arguments.\n" << Usage;
+            return 2;
+        }
+    }
+
+    if (inputPath == nullptr || outputPath == nullptr) {
+        std::cerr << Usage;
+        return 2;
+    }
+
+    try {
+        D3D12Tests::MeshData mesh = D3D12Tests::ImportObjMesh(inputPath, options);
+        D3D12Tests::MeshOptimizeReport report;
+        if (optimize) {
+            report = D3D12Tests::OptimizeMesh(mesh, optimizeOptions);
+        }
+        if (compress) {
+            D3D12Tests::CompressMeshVertices(mesh);
+        }
+        D3D12Tests::SaveMeshFile(mesh, outputPath);
+        if (hlslPath != nullptr) {
+            std::ofstream hlsl(hlslPath, std::ios::binary);
+            hlsl << D3D12Tests::GenerateVertexDecodeHlsl(mesh);
+            if (!hlsl) {
+                throw std::runtime_error(std::string("Could not write ") + hlslPath + '.');
+            }
+        }
+
+        std::cout << outputPath << ": " << mesh.VertexCount << " vertices, " << mesh.Indices.size() / 3
+            << " triangles\n";
+        if (optimize) {
+            PrintOptimizeReport(report);
+        }
+        for (const D3D12Tests::MeshStream& stream : mesh.Streams) {
+            std::cout << "  stream " << D3D12Tests::GetMeshSemanticName(stream.Semantic) << stream.SemanticIndex << ", format "
+                << stream.Format << ", stride " << stream.Stride << '\n';
+        }
+        for (const D3D12Tests::MeshSubmesh& submesh : mesh.Submeshes) {
+            std::cout << "  submesh \"" << submesh.Name << "\", material " << submesh.MaterialIndex << ", "
+                << submesh.Lods.front().IndexCount / 3 << " triangles\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,6 @@
+target("MeshConverter")
+  set_kind("binary")
+  
+  add_files("Source/**.cpp")
+  
+  add_deps("Framework")
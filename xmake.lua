@@ -4,10 +4,11 @@ set_project("D3D12Tests")
 
 add_rules("mode.debug", "mode.release")
 set_languages("cxx20")
-set_allowedplats("windows")
+set_allowedplats("windows", "linux")
 
 option("override_runtime", {description = "Override VS runtime to MD in release and MDd in debug.", default = true})
 option("usepch", {description = "Use the precompiled header to speedup compilation speeds.", default = true})
+option("profiling", {description = "Keep the CPU profiling markers in release builds.", default = false})
 
 add_rules("plugin.vsxmake.autoupdate")
 add_rules("plugin.compile_commands.autoupdate")
@@ -20,6 +21,10 @@ else
   add_defines("D3D12TESTS_DEBUG")
 end
 
+if is_mode("debug") or has_config("profiling") then
+  add_defines("D3D12TESTS_PROFILING")
+end
+
 set_encodings("utf-8")
 set_exceptions("cxx")
 set_languages("cxx20")
@@ -34,17 +39,25 @@ if is_plat("windows") then
 
   add_defines("UNICODE", "_UNICODE")
 
-  add_syslinks("User32", "dxgi", "d3d12", "d3dcompiler", "shell32")
+  add_syslinks("User32", "dxgi", "d3d12", "d3dcompiler", "shell32", "winmm")
 end
 
 add_cxflags("-Wno-missing-field-initializers -Werror=vla", {tools = {"clang", "gcc"}})
 
-add_requires("directx-headers", "directxtk12", "directxshadercompiler", "directxmath")
+if is_plat("windows") then
+  add_requires("directx-headers", "directxtk12", "directxshadercompiler", "directxmath")
+end
 
 target("Framework")
   set_kind("static")
   
   add_files("Source/**.cpp")
+
+  -- Only the platform-neutral part of the framework is built outside of Windows.
+  if not is_plat("windows") then
+    remove_files("Source/Framework/Application.cpp", "Source/Framework/Win32*.cpp", "Source/Framework/D3D12*.cpp")
+    add_syslinks("pthread", {public = true})
+  end
   
   add_includedirs("Include", {public = true})
   for _, ext in ipairs({".hpp", ".inl"}) do
@@ -57,7 +70,9 @@ target("Framework")
   
   add_rpathdirs("$ORIGIN")
 
-  add_packages("directx-headers", "directxtk12", "directxshadercompiler", "directxmath", {public = true})
+  if is_plat("windows") then
+    add_packages("directx-headers", "directxtk12", "directxshadercompiler", "directxmath", {public = true})
+  end
 
 rule("cp_tests_resources")
   after_build(function (target)
@@ -65,5 +80,7 @@ rule("cp_tests_resources")
   end)
 
 includes("Tests/**/xmake.lua")
+includes("Benchmarks/**/xmake.lua")
+includes("Tools/**/xmake.lua")
 
 includes("xmake/**.lua")
\ No newline at end of file